@@ -0,0 +1,356 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/DataMgr.h>
+#include <vapor/DataMgrUtils.h>
+#include <vapor/FlowParams.h>
+#include <vapor/Advection.h>
+#include <vapor/AdvectionIO.h>
+#include <vapor/RakeSeeds.h>
+#include <vapor/VaporField.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct opt_t {
+    string                  ftype;
+    int                     memsize;
+    int                     nthreads;
+    int                     athreads;
+    int                     gridcache;
+    vector<string>          vars;
+    vector<string>          props;
+    OptionParser::Boolean_T unsteady;
+    int                     ts;
+    int                     steps;
+    double                  multiplier;
+    string                  method;
+    double                  tol;
+    string                  seeds;
+    OptionParser::Boolean_T seedtimes;
+    vector<float>           rake;
+    vector<int>             nrake;
+    int                     random;
+    int                     batch;
+    vector<int>             periodic;
+    int                     level;
+    int                     lod;
+    OptionParser::Boolean_T quiet;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"ftype", 1, "vdc", "Data set type (vdc|wrf|cf|mpas|bov|dcp|ugrid)"},
+                                         {"memsize", 1, "2000", "Cache size in MBs of the data manager"},
+                                         {"nthreads", 1, "0", "Number of threads reading data (0=># processors)"},
+                                         {"athreads", 1, "0", "Number of threads advecting particles (0=># processors)"},
+                                         {"gridcache", 1, "9",
+                                          "Maximum number of velocity grids kept in memory. "
+                                          "An unsteady advection needs 2 time steps of each component"},
+                                         {"vars", 1, "", "Colon delimited list of 2 or 3 velocity variable names"},
+                                         {"props", 1, "",
+                                          "Colon delimited list of variable names to sample along "
+                                          "the trajectories and write out"},
+                                         {"unsteady", 0, "", "Advect pathlines through the time steps, instead of streamlines"},
+                                         {"ts", 1, "-1",
+                                          "Time step of the streamlines, or last time step of the "
+                                          "pathlines. Default (-1) is the first time step for streamlines "
+                                          "and the last one for pathlines"},
+                                         {"steps", 1, "100", "Number of steps of the streamlines"},
+                                         {"multiplier", 1, "1.0", "Velocity multiplier"},
+                                         {"method", 1, "rk4", "Integration method (rk4|rk45)"},
+                                         {"tol", 1, "1e-5", "Error tolerance of the rk45 method, relative to the size of the box"},
+                                         {"seeds", 1, "",
+                                          "CSV file of seed locations. The seeds start at the first "
+                                          "time step, unless -seedtimes is given. Default is to place seeds in the rake"},
+                                         {"seedtimes", 0, "",
+                                          "Read the time each seed starts at from the 4th value of "
+                                          "each line of the -seeds file. Only for -unsteady"},
+                                         {"rake", 1, "",
+                                          "Colon delimited rake extents "
+                                          "(xmin:xmax:ymin:ymax[:zmin:zmax]). Default is the domain"},
+                                         {"nrake", 1, "5:5:1", "Colon delimited number of seeds along each axis of the rake"},
+                                         {"random", 1, "0",
+                                          "Number of seeds placed at random in the rake. "
+                                          "Default (0) is a grid of seeds, see -nrake"},
+                                         {"batch", 1, "100000",
+                                          "Number of seeds advected at once. Each batch is written "
+                                          "out before the next one starts, bounding the memory used"},
+                                         {"periodic", 1, "0:0:0", "Colon delimited periodicity (0 or 1) of each axis"},
+                                         {"level", 1, "0", "Multiresolution refinement level. Zero implies coarsest resolution"},
+                                         {"lod", 1, "0", "Compression level of detail. Zero implies coarsest approximation"},
+                                         {"quiet", 0, "", "Operate quietly"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"ftype", Wasp::CvtToCPPStr, &opt.ftype, sizeof(opt.ftype)},
+                                        {"memsize", Wasp::CvtToInt, &opt.memsize, sizeof(opt.memsize)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"athreads", Wasp::CvtToInt, &opt.athreads, sizeof(opt.athreads)},
+                                        {"gridcache", Wasp::CvtToInt, &opt.gridcache, sizeof(opt.gridcache)},
+                                        {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},
+                                        {"props", Wasp::CvtToStrVec, &opt.props, sizeof(opt.props)},
+                                        {"unsteady", Wasp::CvtToBoolean, &opt.unsteady, sizeof(opt.unsteady)},
+                                        {"ts", Wasp::CvtToInt, &opt.ts, sizeof(opt.ts)},
+                                        {"steps", Wasp::CvtToInt, &opt.steps, sizeof(opt.steps)},
+                                        {"multiplier", Wasp::CvtToDouble, &opt.multiplier, sizeof(opt.multiplier)},
+                                        {"method", Wasp::CvtToCPPStr, &opt.method, sizeof(opt.method)},
+                                        {"tol", Wasp::CvtToDouble, &opt.tol, sizeof(opt.tol)},
+                                        {"seeds", Wasp::CvtToCPPStr, &opt.seeds, sizeof(opt.seeds)},
+                                        {"seedtimes", Wasp::CvtToBoolean, &opt.seedtimes, sizeof(opt.seedtimes)},
+                                        {"rake", Wasp::CvtToFloatVec, &opt.rake, sizeof(opt.rake)},
+                                        {"nrake", Wasp::CvtToIntVec, &opt.nrake, sizeof(opt.nrake)},
+                                        {"random", Wasp::CvtToInt, &opt.random, sizeof(opt.random)},
+                                        {"batch", Wasp::CvtToInt, &opt.batch, sizeof(opt.batch)},
+                                        {"periodic", Wasp::CvtToIntVec, &opt.periodic, sizeof(opt.periodic)},
+                                        {"level", Wasp::CvtToInt, &opt.level, sizeof(opt.level)},
+                                        {"lod", Wasp::CvtToInt, &opt.lod, sizeof(opt.lod)},
+                                        {"quiet", Wasp::CvtToBoolean, &opt.quiet, sizeof(opt.quiet)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+void usage(OptionParser &op, int status)
+{
+    cerr << "Usage: " << ProgName << " [options] outfile datafiles..." << endl;
+    op.PrintOptionHelp(stderr);
+    exit(status);
+}
+
+// Place seeds in the rake, either on a grid or at random, as the flow
+// renderer does. 2D rakes are placed at the default Z of the data.
+//
+vector<flow::Particle> rake_seeds(const vector<float> &rake, double time, float defaultZ)
+{
+    if (opt.random > 0) return (flow::RakeSeedsRandom(rake, opt.random, 32, time, defaultZ));
+
+    vector<long> n(3, 1);
+    for (int i = 0; i < 3 && i < opt.nrake.size(); i++) n[i] = std::max(opt.nrake[i], 1);
+    return (flow::RakeSeedsUniform(rake, n, time, defaultZ));
+}
+
+int set_periodicity(const flow::VaporField &field, size_t ts, flow::Advection &advection)
+{
+    glm::vec3 minxyz, maxxyz;
+    int       rc = field.GetVelocityIntersection(ts, minxyz, maxxyz);
+    if (rc != 0) return (rc);
+
+    vector<bool> periodic(3, false);
+    for (int i = 0; i < 3 && i < opt.periodic.size(); i++) periodic[i] = opt.periodic[i] != 0;
+
+    advection.SetXPeriodicity(periodic[0], minxyz.x, maxxyz.x);
+    advection.SetYPeriodicity(periodic[1], minxyz.y, maxxyz.y);
+    advection.SetZPeriodicity(periodic[2], minxyz.z, maxxyz.z);
+    return (0);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    if (op.AppendOptions(set_opts) < 0) {
+        cerr << ProgName << " : " << op.GetErrMsg();
+        exit(1);
+    }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) {
+        cerr << ProgName << " : " << op.GetErrMsg();
+        exit(1);
+    }
+
+    if (opt.help) usage(op, 0);
+
+    if (argc < 3) usage(op, 1);
+
+    if (opt.vars.size() < 2 || opt.vars.size() > 3) {
+        MyBase::SetErrMsg("Expected 2 or 3 velocity variables");
+        exit(1);
+    }
+
+    flow::Advection::ADVECTION_METHOD method;
+    if (opt.method == "rk4") {
+        method = flow::Advection::ADVECTION_METHOD::RK4;
+    } else if (opt.method == "rk45") {
+        method = flow::Advection::ADVECTION_METHOD::RK45;
+    } else {
+        MyBase::SetErrMsg("Invalid integration method : %s", opt.method.c_str());
+        exit(1);
+    }
+
+    string         outfile = argv[1];
+    vector<string> files;
+    for (int i = 2; i < argc; i++) files.push_back(argv[i]);
+
+    double t0 = Wasp::GetTime();
+
+    DataMgr dataMgr(opt.ftype, opt.memsize, opt.nthreads);
+    int     rc = dataMgr.Initialize(files, vector<string>());
+    if (rc < 0) exit(1);
+
+    const vector<double> &timestamps = dataMgr.GetTimeCoordinates();
+    if (timestamps.empty()) {
+        MyBase::SetErrMsg("Data set has no time steps");
+        exit(1);
+    }
+
+    size_t ts = opt.ts >= 0 ? opt.ts : (opt.unsteady ? timestamps.size() - 1 : 0);
+    if (ts >= timestamps.size()) {
+        MyBase::SetErrMsg("Invalid time step : %d", opt.ts);
+        exit(1);
+    }
+
+    // The velocity field reads its settings from a FlowParams, as in the
+    // flow renderer
+    //
+    ParamsBase::StateSave ssave;
+    FlowParams            params(&dataMgr, &ssave);
+    if (params.Initialize() < 0) exit(1);
+
+    vector<string> velocityNames = opt.vars;
+    velocityNames.resize(3, "");
+    params.SetFieldVariableNames(velocityNames);
+    params.SetIsSteady(!opt.unsteady);
+    params.SetCurrentTimestep(ts);
+    params.SetRefinementLevel(opt.level);
+    params.SetCompressionLevel(opt.lod);
+    params.SetVelocityMultiplier(opt.multiplier);
+    params.SetSteadyNumOfSteps(opt.steps);
+
+    float defaultZ = DataMgrUtils::Get2DRendererDefaultZ(&dataMgr, ts, opt.level, opt.lod);
+
+    flow::VaporField velocityField(opt.gridcache);
+    velocityField.AssignDataManager(&dataMgr);
+    velocityField.UpdateParamAndVarNames(&params);
+    velocityField.DefaultZ = defaultZ;
+
+    double deltaT;
+    rc = velocityField.CalcDeltaTFromCurrentTimeStep(deltaT);
+    if (rc == flow::FIELD_ALL_ZERO) {
+        MyBase::SetErrMsg("The velocity field seems to contain only invalid values!");
+        exit(1);
+    } else if (rc != 0) {
+        MyBase::SetErrMsg("Failed to compute the integration step size");
+        exit(1);
+    }
+
+    // Seeds, starting at the first time step unless the seeds file gives
+    // their times
+    //
+    if (opt.seedtimes && (opt.seeds.empty() || !opt.unsteady)) {
+        MyBase::SetErrMsg("-seedtimes requires -seeds and -unsteady");
+        exit(1);
+    }
+    vector<flow::Particle> seeds;
+    if (!opt.seeds.empty()) {
+        seeds = flow::InputSeedsCSV(opt.seeds, opt.seedtimes);
+        for (auto &s : seeds) {
+            if (!opt.seedtimes) {
+                s.time = timestamps[0];
+            } else if (!(s.time >= timestamps[0] && s.time <= timestamps[ts])) {
+                MyBase::SetErrMsg("Seed time %g is outside of the advected times (%g, %g)", s.time, timestamps[0], timestamps[ts]);
+                exit(1);
+            }
+        }
+    } else {
+        vector<float> rake = opt.rake;
+        if (rake.empty()) rake = params.GetRake();
+        if (rake.size() != 4 && rake.size() != 6) {
+            MyBase::SetErrMsg("Rake must have 4 or 6 values");
+            exit(1);
+        }
+        seeds = rake_seeds(rake, timestamps[0], defaultZ);
+    }
+    if (seeds.empty()) {
+        MyBase::SetErrMsg("No seeds to advect");
+        exit(1);
+    }
+
+    vector<double> minExt, maxExt;
+    params.GetBox()->GetExtents(minExt, maxExt);
+
+    double setupTime = Wasp::GetTime() - t0;
+    double advectTime = 0.0, sampleTime = 0.0, writeTime = 0.0;
+    size_t nsamples = 0;
+
+    // Advect the seeds one batch at a time, appending the trajectories of
+    // each batch to the output file
+    //
+    size_t batch = opt.batch > 0 ? opt.batch : seeds.size();
+    for (size_t first = 0; first < seeds.size(); first += batch) {
+        size_t last = std::min(first + batch, seeds.size());
+
+        flow::Advection advection;
+        advection.SetNumberOfThreads(opt.athreads);
+        advection.UseSeedParticles(vector<flow::Particle>(seeds.begin() + first, seeds.begin() + last));
+        if (set_periodicity(velocityField, ts, advection) != 0) {
+            MyBase::SetErrMsg("Failed to set the periodicity");
+            exit(1);
+        }
+        advection.SetBoxTolerance(opt.tol, minExt, maxExt);
+
+        t0 = Wasp::GetTime();
+        if (!opt.unsteady) {
+            rc = advection.AdvectSteps(&velocityField, deltaT, opt.steps, method);
+        } else {
+            for (size_t i = 1; i <= ts && rc >= 0; i++) rc = advection.AdvectTillTime(&velocityField, timestamps[i - 1], deltaT, timestamps[i], method);
+        }
+        if (rc < 0) {
+            MyBase::SetErrMsg("Advection failed");
+            exit(1);
+        }
+        advectTime += Wasp::GetTime() - t0;
+
+        t0 = Wasp::GetTime();
+        for (const auto &v : opt.props) {
+            flow::VaporField varField(2);
+            varField.AssignDataManager(&dataMgr);
+            varField.UpdateParams(&params);
+            varField.DefaultZ = defaultZ;
+            varField.ScalarName = v;
+            if (advection.CalculateParticleProperties(&varField) != 0) {
+                MyBase::SetErrMsg("Failed to sample variable : %s", v.c_str());
+                exit(1);
+            }
+        }
+        sampleTime += Wasp::GetTime() - t0;
+
+        t0 = Wasp::GetTime();
+        bool append = first > 0;
+        if (!opt.unsteady) {
+            rc = flow::OutputFlowlinesNumSteps(&advection, outfile.c_str(), opt.steps, dataMgr.GetMapProjection(), append, first);
+        } else {
+            rc = flow::OutputFlowlinesMaxTime(&advection, outfile.c_str(), timestamps[ts], dataMgr.GetMapProjection(), append, first);
+        }
+        if (rc != 0) {
+            MyBase::SetErrMsg("Failed to write file : %s", outfile.c_str());
+            exit(1);
+        }
+        writeTime += Wasp::GetTime() - t0;
+
+        nsamples += advection.GetTrajectories().GetNumberOfSamples();
+
+        if (!opt.quiet) cout << "Advected seeds " << first << " to " << last - 1 << " of " << seeds.size() << endl;
+    }
+
+    if (!opt.quiet) {
+        size_t nbatches = (seeds.size() + batch - 1) / batch;
+        printf("Seeds            : %lu in %lu batches\n", seeds.size(), nbatches);
+        printf("Samples          : %lu\n", nsamples);
+        printf("Setup time       : %.3f sec\n", setupTime);
+        printf("Advection time   : %.3f sec (%.0f samples/sec)\n", advectTime, advectTime > 0.0 ? nsamples / advectTime : 0.0);
+        if (!opt.props.empty()) printf("Sampling time    : %.3f sec\n", sampleTime);
+        printf("Write time       : %.3f sec\n", writeTime);
+        printf("Total time       : %.3f sec\n", setupTime + advectTime + sampleTime + writeTime);
+    }
+
+    exit(0);
+}
@@ -36,6 +36,10 @@ FlowEventRouter::FlowEventRouter(QWidget *parent, ControlExec *ce) : RenderEvent
                 _pathlineInjectionSlider = new PIntegerSliderEdit(FP::_seedInjInterval, "Injection Interval"),
             }),
             new PDoubleInput(FP::_velocityMultiplierTag, "Vector Field Multiplier"),
+            new PEnumDropdown(FP::_integrationMethodTag, {"Runge-Kutta 4", "Adaptive (RK45)"}, {(int)FlowIntegrator::RK4, (int)FlowIntegrator::RK45}, "Integration Method"),
+            (new PShowIf(FP::_integrationMethodTag))->Equals((int)FlowIntegrator::RK45)->Then({
+                new PDoubleInput(FP::_integrationToleranceTag, "Error Tolerance"),
+            }),
             new PCheckbox(FP::_xPeriodicTag, "X axis periodicity"),
             new PCheckbox(FP::_yPeriodicTag, "Y axis periodicity"),
             new PCheckbox(FP::_zPeriodicTag, "Z axis periodicity"),
@@ -298,13 +298,19 @@ void Histo::populateIteratingHistogram(const Grid *grid, const int stride)
 {
     VAssert(grid);
 
-    float               missingValue = grid->GetMissingValue();
-    Grid::ConstIterator enditr = grid->cend();
-
-    for (auto itr = grid->cbegin(); itr != enditr; itr += stride) {
-        float v = *itr;
-        if (v != missingValue) addToBin(v);
-    }
+    float  missingValue = grid->GetMissingValue();
+    size_t skip = 0;
+
+    // Every stride'th value, counting across spans
+    //
+    grid->ForEachBlock([&](const Grid::Span &span) {
+        size_t i = skip;
+        for (; i < span.n; i += stride) {
+            float v = span.data[i];
+            if (v != missingValue) addToBin(v);
+        }
+        skip = i - span.n;
+    });
 }
 
 #define X 0
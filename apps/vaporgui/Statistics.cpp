@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <vapor/MyBase.h>
 #include <vapor/DataStatus.h>
+#include <vapor/DataStatistics.h>
 #include "PWidgets.h"
 #include "VPushButton.h"
 
@@ -440,24 +441,19 @@ void Statistics::_updateButtonClicked()
         std::string varname = _validStats.GetVariableName(i);
         long        count = 0;
         _validStats.GetCount(varname, &count);
-        if (count == -1) {
-            _calc3M(varname);
-            _updateStatsTable();
-        }
         float m3[3]{0.0f, 0.0f, 0.0f}, median = 0.0f, stddev = 0.0f;
         _validStats.Get3MStats(varname, m3);
         _validStats.GetMedian(varname, &median);
         _validStats.GetStddev(varname, &stddev);
-        if ((statsParams->GetMinEnabled() || statsParams->GetMaxEnabled() || statsParams->GetMeanEnabled()) && std::isnan(m3[2])) {
-            _calc3M(varname);
-            _updateStatsTable();
-        }
-        if (statsParams->GetMedianEnabled() && std::isnan(median)) {
-            _calcMedian(varname);
-            _updateStatsTable();
-        }
-        if (statsParams->GetStdDevEnabled() && std::isnan(stddev)) {
-            _calcStddev(varname);
+
+        // Everything but the median comes out of the same pass, so only
+        // ask for the median if it is wanted
+        //
+        bool needMedian = statsParams->GetMedianEnabled() && std::isnan(median);
+        bool needOthers = (statsParams->GetMinEnabled() || statsParams->GetMaxEnabled() || statsParams->GetMeanEnabled()) && std::isnan(m3[2]);
+        needOthers = needOthers || (statsParams->GetStdDevEnabled() && std::isnan(stddev));
+        if (count == -1 || needMedian || needOthers) {
+            _calcStats(varname, needMedian);
             _updateStatsTable();
         }
     }
@@ -629,7 +625,7 @@ void Statistics::_removeVarChanged(int index)
     _validStats.RemoveVariable(varName);
 }
 
-bool Statistics::_calc3M(std::string varname)
+bool Statistics::_calcStats(std::string varname, bool median)
 {
     // Initialize pointers
     GUIStateParams *  guiParams = dynamic_cast<GUIStateParams *>(_controlExec->GetParamsMgr()->GetParams(GUIStateParams::GetClassType()));
@@ -639,141 +635,25 @@ bool Statistics::_calc3M(std::string varname)
 
     int minTS = statsParams->GetCurrentTimestep();
     int maxTS = statsParams->GetCurrentMaxTS();
-    if (!currentDmgr->IsTimeVarying(varname)) maxTS = minTS;
     std::vector<double> minExtent, maxExtent;
     statsParams->GetBox()->GetExtents(minExtent, maxExtent);
 
-    float c = 0.0;
-    float sum = 0.0;
-    float min = std::numeric_limits<float>::max();
-    float max = -min;
-    long  count = 0;
-
-    for (int ts = minTS; ts <= maxTS; ts++) {
-        VAPoR::Grid *grid = currentDmgr->GetVariable(ts, varname, statsParams->GetRefinementLevel(), statsParams->GetCompressionLevel(), minExtent, maxExtent);
-        if (grid) {
-            Grid::ConstIterator endItr = grid->cend();
-            float               missingVal = grid->GetMissingValue();
-
-            for (Grid::ConstIterator it = grid->cbegin(minExtent, maxExtent); it != endItr; ++it) {
-                if (*it != missingVal) {
-                    float val = *it;
-                    min = min < val ? min : val;
-                    max = max > val ? max : val;
-                    float y = val - c;
-                    float t = sum + y;
-                    c = t - sum - y;
-                    sum = t;
-                    count++;
-                }
-            }
-
-            delete grid;    // delete the grid after using it!
-        }
+    VAPoR::DataStatistics        engine;
+    VAPoR::DataStatistics::Stats stats;
+    int rc = engine.Compute(currentDmgr, varname, minTS, maxTS, statsParams->GetRefinementLevel(), statsParams->GetCompressionLevel(), minExtent, maxExtent, median, stats);
+    if (rc < 0) {
+        _validStats.AddCount(varname, 0);
+        return false;
     }
 
-    if (count > 0) {
-        float m3[3] = {min, max, sum / (float)count};
+    if (stats.count > 0) {
+        float m3[3] = {(float)stats.min, (float)stats.max, (float)stats.mean};
         _validStats.Add3MStats(varname, m3);
-    } else    // count == 0
-    {
-        // std::cerr << "Error: Zero value got selected!!" << std::endl;
-    }
-
-    _validStats.AddCount(varname, count);
-
-    return true;
-}
-
-bool Statistics::_calcMedian(std::string varname)
-{
-    // Initialize pointers
-    GUIStateParams *  guiParams = dynamic_cast<GUIStateParams *>(_controlExec->GetParamsMgr()->GetParams(GUIStateParams::GetClassType()));
-    std::string       dsName = guiParams->GetStatsDatasetName();
-    StatisticsParams *statsParams = dynamic_cast<StatisticsParams *>(_controlExec->GetParamsMgr()->GetAppRenderParams(dsName, StatisticsParams::GetClassType()));
-    VAPoR::DataMgr *  currentDmgr = _controlExec->GetDataStatus()->GetDataMgr(dsName);
-
-    int minTS = statsParams->GetCurrentTimestep();
-    int maxTS = statsParams->GetCurrentMaxTS();
-    if (!currentDmgr->IsTimeVarying(varname)) maxTS = minTS;
-    std::vector<double> minExtent, maxExtent;
-    statsParams->GetBox()->GetExtents(minExtent, maxExtent);
-
-    std::vector<float> buffer;
-    for (int ts = minTS; ts <= maxTS; ts++) {
-        VAPoR::Grid *grid = currentDmgr->GetVariable(ts, varname, statsParams->GetRefinementLevel(), statsParams->GetCompressionLevel(), minExtent, maxExtent);
-        if (grid) {
-            Grid::ConstIterator endItr = grid->cend();
-            float               missingVal = grid->GetMissingValue();
-
-            for (Grid::ConstIterator it = grid->cbegin(minExtent, maxExtent); it != endItr; ++it) {
-                if (*it != missingVal) buffer.push_back(*it);
-            }
-        }
-    }
-
-    if (buffer.size() > 0) {
-        std::sort(buffer.begin(), buffer.end());
-        float median = buffer.at(buffer.size() / 2);
-        _validStats.AddMedian(varname, median);
-    } else {
-        // std::cerr << "Error: Zero value got selected!!" << std::endl;
-    }
-
-    _validStats.AddCount(varname, buffer.size());
-
-    return true;
-}
-
-bool Statistics::_calcStddev(std::string varname)
-{
-    // Initialize pointers
-    GUIStateParams *  guiParams = dynamic_cast<GUIStateParams *>(_controlExec->GetParamsMgr()->GetParams(GUIStateParams::GetClassType()));
-    std::string       dsName = guiParams->GetStatsDatasetName();
-    StatisticsParams *statsParams = dynamic_cast<StatisticsParams *>(_controlExec->GetParamsMgr()->GetAppRenderParams(dsName, StatisticsParams::GetClassType()));
-    VAPoR::DataMgr *  currentDmgr = _controlExec->GetDataStatus()->GetDataMgr(dsName);
-
-    int minTS = statsParams->GetCurrentTimestep();
-    int maxTS = statsParams->GetCurrentMaxTS();
-    if (!currentDmgr->IsTimeVarying(varname)) maxTS = minTS;
-    std::vector<double> minExtent, maxExtent;
-    statsParams->GetBox()->GetExtents(minExtent, maxExtent);
-
-    float c = 0.0;
-    float sum = 0.0;
-    long  count = 0;
-    float m3[3];
-    _validStats.Get3MStats(varname, m3);
-    if (std::isnan(m3[2])) {
-        this->_calc3M(varname);
-        _validStats.Get3MStats(varname, m3);
-    }
-
-    for (int ts = minTS; ts <= maxTS; ts++) {
-        VAPoR::Grid *grid = currentDmgr->GetVariable(ts, varname, statsParams->GetRefinementLevel(), statsParams->GetCompressionLevel(), minExtent, maxExtent);
-        if (grid) {
-            Grid::ConstIterator endItr = grid->cend();
-            float               missingVal = grid->GetMissingValue();
-            for (Grid::ConstIterator it = grid->cbegin(minExtent, maxExtent); it != endItr; ++it) {
-                if (*it != missingVal) {
-                    float val = *it;
-                    float y = (val - m3[2]) * (val - m3[2]) - c;
-                    float t = sum + y;
-                    c = t - sum - y;
-                    sum = t;
-                    count++;
-                }
-            }
-        }
-    }
-
-    if (count > 0) {
-        _validStats.AddStddev(varname, std::sqrt(sum / (float)count));
-    } else {
-        // std::cerr << "Error: Zero value got selected!!" << std::endl;
+        _validStats.AddStddev(varname, (float)stats.stddev);
+        if (median) _validStats.AddMedian(varname, (float)stats.median);
     }
 
-    _validStats.AddCount(varname, count);
+    _validStats.AddCount(varname, stats.count);
 
     return true;
 }
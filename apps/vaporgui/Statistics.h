@@ -128,8 +128,6 @@ private:
     void _updateStatsTable();
 
     // calculations should put results in _validStats directly.
-    bool _calc3M(std::string);    // min, max, mean
-    bool _calcMedian(std::string);
-    bool _calcStddev(std::string);
+    bool _calcStats(std::string, bool median);    // min, max, mean, stddev, and optionally median
 };
 #endif
@@ -7,6 +7,7 @@
 #include <vapor/OptionParser.h>
 #include <vapor/CFuncs.h>
 #include <vapor/VDCNetCDF.h>
+#include <vapor/VDCConverter.h>
 #include <vapor/DCWRF.h>
 #include <vapor/FileUtils.h>
 
@@ -15,15 +16,31 @@ using namespace VAPoR;
 
 struct opt_t {
     int                     nthreads;
+    int                     nworkers;
     int                     numts;
+    int                     maxmem;
+    string                  checkpoint;
     std::vector<string>     vars;
     std::vector<string>     xvars;
+    OptionParser::Boolean_T restart;
     OptionParser::Boolean_T help;
 } opt;
 
 OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                           "Specify number of execution threads "
-                                          "0 => use number of cores"},
+                                          "per worker process. 0 => divide the cores "
+                                          "among the workers"},
+                                         {"nworkers", 1, "0",
+                                          "Number of worker processes copying "
+                                          "variables concurrently. 0 => use number of cores"},
+                                         {"maxmem", 1, "0",
+                                          "Approximate bound, in MBs, on the memory "
+                                          "used by all workers. 0 => no bound"},
+                                         {"checkpoint", 1, "",
+                                          "Checkpoint file recording the copied "
+                                          "variables, used to resume an interrupted "
+                                          "conversion. Default is master.vdc.ckpt"},
+                                         {"restart", 0, "", "Ignore an existing checkpoint file and copy all variables"},
                                          {"numts", 1, "-1", "Number of timesteps to be included in the VDC. Default (-1) includes all timesteps."},
                                          {"vars", 1, "",
                                           "Colon delimited list of variable names "
@@ -34,9 +51,16 @@ OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                          {"help", 0, "", "Print this message and exit"},
                                          {NULL}};
 
-OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)}, {"numts", Wasp::CvtToInt, &opt.numts, sizeof(opt.numts)},
-                                        {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},          {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},
-                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},         {NULL}};
+OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"nworkers", Wasp::CvtToInt, &opt.nworkers, sizeof(opt.nworkers)},
+                                        {"numts", Wasp::CvtToInt, &opt.numts, sizeof(opt.numts)},
+                                        {"maxmem", Wasp::CvtToInt, &opt.maxmem, sizeof(opt.maxmem)},
+                                        {"checkpoint", Wasp::CvtToCPPStr, &opt.checkpoint, sizeof(opt.checkpoint)},
+                                        {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},
+                                        {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},
+                                        {"restart", Wasp::CvtToBoolean, &opt.restart, sizeof(opt.restart)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
 
 // Return a new vector containing elements of v1 with any elements from
 // v2 removed
@@ -84,35 +108,13 @@ int main(int argc, char **argv)
     for (int i = 0; i < argc - 1; i++) wrffiles.push_back(argv[i]);
     string master = argv[argc - 1];
 
-    VDCNetCDF vdc(opt.nthreads);
-
-    size_t         chunksize = 1024 * 1024 * 4;
-    vector<size_t> bs;
-    int            rc = vdc.Initialize(master, vector<string>(), VDC::A, bs, chunksize);
-    if (rc < 0) return (1);
-
     DCWRF dcwrf;
-    rc = dcwrf.Initialize(wrffiles, vector<string>());
+    int rc = dcwrf.Initialize(wrffiles, vector<string>());
     if (rc < 0) { return (1); }
 
-    vector<string> varnames = dcwrf.GetCoordVarNames();
-    for (int i = 0; i < varnames.size(); i++) {
-        int nts = dcwrf.GetNumTimeSteps(varnames[i]);
-        nts = opt.numts != -1 && nts > opt.numts ? opt.numts : nts;
-        VAssert(nts >= 0);
-
-        cout << "Copying variable " << varnames[i] << endl;
-
-        for (int ts = 0; ts < nts; ts++) {
-            cout << "  Time step " << ts << endl;
-            int rc = vdc.CopyVar(dcwrf, ts, varnames[i], -1, -1);
-            if (rc < 0) {
-                MyBase::SetErrMsg("Failed to copy variable %s", varnames[i].c_str());
-                return (1);
-            }
-        }
-    }
+    vector<string> coordvars = dcwrf.GetCoordVarNames();
 
+    vector<string> varnames;
     if (opt.vars.size()) {
         varnames = opt.vars;
     } else {
@@ -121,24 +123,28 @@ int main(int argc, char **argv)
 
     varnames = remove_vector(varnames, opt.xvars);
 
-    int estatus = 0;
-    for (int i = 0; i < varnames.size(); i++) {
-        int nts = dcwrf.GetNumTimeSteps(varnames[i]);
-        nts = opt.numts != -1 && nts > opt.numts ? opt.numts : nts;
-        VAssert(nts >= 0);
+    // Each worker process reads through its own DCWRF
+    //
+    VDCConverter::DCFactory factory = [&wrffiles]() -> DC * {
+        DCWRF *dc = new DCWRF();
+        if (dc->Initialize(wrffiles, vector<string>()) < 0) {
+            delete dc;
+            return (NULL);
+        }
+        return (dc);
+    };
 
-        cout << "Copying variable " << varnames[i] << endl;
+    size_t       chunksize = 1024 * 1024 * 4;
+    VDCConverter converter(factory, master, opt.nworkers, opt.nthreads, chunksize);
+    converter.SetMaxMemory((size_t)opt.maxmem * 1024 * 1024);
+    converter.SetCheckpoint(opt.checkpoint.empty() ? master + ".ckpt" : opt.checkpoint, opt.restart);
+    converter.SetProgressFunc(VDCConverter::PrintProgress);
 
-        for (int ts = 0; ts < nts; ts++) {
-            cout << "  Time step " << ts << endl;
+    int estatus = 0;
+    rc = converter.Convert(dcwrf, coordvars, varnames, opt.numts);
+    if (rc < 0) estatus = 1;
 
-            int rc = vdc.CopyVar(dcwrf, ts, varnames[i], -1, -1);
-            if (rc < 0) {
-                MyBase::SetErrMsg("Failed to copy variable %s", varnames[i].c_str());
-                estatus = 1;
-            }
-        }
-    }
+    converter.PrintStats();
 
-    return estatus;
+    return (estatus);
 }
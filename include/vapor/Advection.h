@@ -7,17 +7,20 @@
 #define ADVECTION_H
 
 #include "vapor/Particle.h"
+#include "vapor/Trajectories.h"
 #include "vapor/Field.h"
 #include "vapor/common.h"
 #include <string>
 #include <vector>
+#include <functional>
 
 namespace flow {
 class FLOW_API Advection final {
 public:
     enum class ADVECTION_METHOD {
         EULER = 0,
-        RK4 = 1    // Runge-Kutta 4th order
+        RK4 = 1,    // Runge-Kutta 4th order
+        RK45 = 2    // Dormand-Prince 5(4), with step size control
     };
 
     // Constructor and destructor
@@ -31,10 +34,41 @@ public:
     int AdvectSteps(Field *velocityField, double deltaT, size_t maxSteps, ADVECTION_METHOD method = ADVECTION_METHOD::RK4);
     // Advect as many steps as necessary to reach a certain time: targetT.
     // Note: it only considers particles that have already passed startT.
+    // When targetT is later than the current frontier (see below), the state of
+    // every stream after this advection is recorded as a new frontier.
     int AdvectTillTime(Field *velocityField, double startT, double deltaT, double targetT, ADVECTION_METHOD method = ADVECTION_METHOD::RK4);
+    //
+    // Frontiers of AdvectTillTime(). They allow pathlines to be extended or cut back
+    // as the current time step changes without integrating them again from the seeds.
+    //   GetFrontierTime() returns the latest targetT reached by AdvectTillTime(), or
+    //   the lowest double value if no advection has happened since UseSeedParticles().
+    //   RewindToTime() truncates all streams back to the latest frontier at or before
+    //   time t, and drops the later frontiers. Continuing AdvectTillTime() from there
+    //   gives the same streams as if the later frontiers had never been advected.
+    double GetFrontierTime() const;
+    void   RewindToTime(double t);
+    //
+    // Both functions above distribute streams over a number of threads.
+    // The velocity field must support concurrent queries.
+    // Each stream is advected by one thread only, so the resulting streams
+    // are identical regardless of the number of threads.
+    // A value of 0 (the default) uses all available cores.
+    void   SetNumberOfThreads(size_t n);
+    size_t GetNumberOfThreads() const;
+    //
+    // Error tolerances of the RK45 method. A step is accepted when the estimated
+    // error of every coordinate is below absTol + relTol * |coordinate|; otherwise
+    // it is retried with a smaller step. The other methods ignore these values.
+    void SetTolerances(double absTol, double relTol);
+    // Set an absolute tolerance of tol times the largest extent of the box given by
+    // minExt and maxExt, and no relative tolerance. A tolerance relative to the
+    // coordinates themselves would be much looser for data far from the origin,
+    // such as georeferenced data.
+    void SetBoxTolerance(double tol, const std::vector<double> &minExt, const std::vector<double> &maxExt);
 
     // Retrieve field values of a particle based on its location, and put the result in
-    // the "value" field or the "properties" field of a particle
+    // the "value" field or the "properties" field of a particle.
+    // Advecting clears all properties, since the new particles would lack them.
     //   If "skipNonZero" is true, then this function only overwrites zeros.
     //   Otherwise, it will overwrite values anyway.
     int CalculateParticleValues(Field *scalarField, bool skipNonZero);
@@ -48,12 +82,15 @@ public:
     // If the the specified property name does not exist, then nothing is done.
     void RemoveParticleProperty(const std::string &);
 
-    // Set advection basics
+    // Set advection basics. This also clears all frontiers.
     void UseSeedParticles(const std::vector<Particle> &seeds);
 
     // Retrieve the resulting particles as "streams."
-    size_t                       GetNumberOfStreams() const;
-    const std::vector<Particle> &GetStreamAt(size_t i) const;
+    // GetTrajectories() gives access to all streams in place, while GetStreamAt()
+    // makes a copy of one stream.
+    size_t                GetNumberOfStreams() const;
+    const Trajectories &  GetTrajectories() const;
+    std::vector<Particle> GetStreamAt(size_t i) const;
 
     // Retrieve the maximum number of particles in any stream
     size_t GetMaxNumOfPart() const;
@@ -71,9 +108,8 @@ public:
     auto GetPropertyVarNames() const -> std::vector<std::string>;
 
 private:
-    std::vector<std::vector<Particle>> _streams;
-    std::string                        _valueVarName;
-    std::vector<std::string>           _propertyVarNames;
+    Trajectories _trajectories;
+    std::string  _valueVarName;
 
     const float      _lowerAngle, _upperAngle;          // Thresholds for step size adjustment
     float            _lowerAngleCos, _upperAngleCos;    // Cosine values of the threshold angles
@@ -84,12 +120,56 @@ private:
     // who's more knowledgeable about the field.
     bool      _isPeriodic[3];        // is it periodic in X, Y, Z dimensions ?
     glm::vec2 _periodicBounds[3];    // periodic boundaries in X, Y, Z dimensions
+    size_t    _nThreads = 0;         // number of advection threads; 0 means all cores
+    double    _absTol = 1e-6;        // RK45 error tolerances
+    double    _relTol = 1e-5;
+
+    // What RK45 carries from one step of a stream to the next: the velocity at the
+    // end of the last step, which is the first stage of the next one (FSAL), and the
+    // step size the error estimate asks for.
+    struct RK45State {
+        glm::vec3 location{0.0f, 0.0f, 0.0f};
+        double    time = 0.0;
+        glm::vec3 velocity{0.0f, 0.0f, 0.0f};
+        bool      valid = false;
+        double    nextDt = 0.0;
+    };
+
+    // State of each stream right after an AdvectTillTime() call.
+    // The last particle is kept by location, since wrapping it along a periodic
+    // dimension at the start of the next advection moves it.
+    struct Frontier {
+        double                 time;
+        std::vector<size_t>    sizes;
+        std::vector<int>       separatorCounts;
+        std::vector<glm::vec3> lastLocations;
+    };
+    std::vector<Frontier> _frontiers;
+    void                  _recordFrontier(double time);
+
+    // Advect a single stream, given as its last few particles "s", of which there
+    // are "base" more in the trajectories. New particles are appended to "s".
+    // They return true if at least one step was taken.
+    bool _advectStreamSteps(Field *, size_t streamIdx, size_t base, std::vector<Particle> &s, double deltaT, size_t maxSteps, ADVECTION_METHOD);
+    bool _advectStreamTillTime(Field *, size_t streamIdx, std::vector<Particle> &s, double startT, double deltaT, double targetT, ADVECTION_METHOD);
+
+    // Length of the longest stream, separators included
+    size_t _mostSamples() const;
+
+    // Apply "func" to every stream index using up to GetNumberOfThreads() threads.
+    // Returns true if any invocation of "func" returned true.
+    bool _parallelForStreams(const std::function<bool(size_t)> &func) const;
 
     // Advection methods here could assume all input is valid.
     int _advectEuler(Field *, const Particle &, double deltaT,    // Input
                      Particle &p1) const;                         // Output
     int _advectRK4(Field *, const Particle &, double deltaT,      // Input
                    Particle &p1) const;                           // Output
+    // Take one accepted RK45 step. It tries a step size of dt first and shrinks it
+    // until the error is within tolerance, but not below 1/20 of deltaT.
+    int _advectRK45(Field *, const Particle &, double dt, double deltaT,    // Input
+                    RK45State &,                                          // Input and Output
+                    Particle &p1) const;                                  // Output
 
     // Get an adjust factor for deltaT based on how curvy the past two steps are.
     //   A value in range (0.0, 1.0) means shrink deltaT.
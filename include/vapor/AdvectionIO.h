@@ -14,16 +14,21 @@ namespace flow {
 // Output a certain number of steps from an advection.
 // When `append == false`, a header will also be output.
 // Otherwise, only trajectories are output.
-FLOW_API auto OutputFlowlinesNumSteps(const Advection *adv, const char *filename, size_t numStep, const std::string &proj4string, bool append) -> int;
+// Streams are numbered from `firstID`, so that several advections can be appended to one file.
+FLOW_API auto OutputFlowlinesNumSteps(const Advection *adv, const char *filename, size_t numStep, const std::string &proj4string, bool append, size_t firstID = 0) -> int;
 
 // Output trajectory to a maximum time.
 // When `append == false`, a header will also be output.
 // Otherwise, only trajectories are output.
-FLOW_API auto OutputFlowlinesMaxTime(const Advection *adv, const char *filename, double maxTime, const std::string &proj4string, bool append) -> int;
+// Streams are numbered from `firstID`, so that several advections can be appended to one file.
+FLOW_API auto OutputFlowlinesMaxTime(const Advection *adv, const char *filename, double maxTime, const std::string &proj4string, bool append, size_t firstID = 0) -> int;
 
 // Input a list of seeds from lines of CSVs.
+// Each line gives the X, Y, Z location of a seed and, when `readTime == true`,
+// its time as a 4th value. Further values are ignored, and seeds are given
+// time 0.0 unless their time is read.
 // In case of any error occurs, it returns an empty list.
-FLOW_API auto InputSeedsCSV(const std::string &filename) -> std::vector<flow::Particle>;
+FLOW_API auto InputSeedsCSV(const std::string &filename, bool readTime = false) -> std::vector<flow::Particle>;
 
 };    // namespace flow
 #endif
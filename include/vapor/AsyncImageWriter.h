@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vapor/MyBase.h>
+#include <vapor/ImageWriter.h>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace VAPoR {
+
+//! \class AsyncImageWriter
+//! \brief Encode and write images on a pool of threads
+//!
+//! Used to capture an animation without stalling rendering while each
+//! frame is compressed and written. The caller acquires a frame buffer,
+//! fills it, and submits it together with a writer for the frame's file.
+//! The writers run on a pool of threads and their buffers are reused for
+//! later frames.
+//!
+//! At most \p maxFrames buffers, holding at most \p maxBytes, are in use
+//! at any time. AcquireBuffer() blocks when that limit is reached, so a
+//! renderer that outpaces the encoders is slowed down rather than allowed
+//! to grow the queue without bound.
+//!
+//! Since each writer is created by the caller, file names are assigned
+//! in the order frames are submitted, whatever order they finish in.
+//! Writer failures are collected from ImageWriter::GetWriteError() and
+//! reported with SetErrMsg() on the thread that calls Submit() or Wait().
+//
+class RENDER_API AsyncImageWriter : public Wasp::MyBase {
+public:
+    //! \param[in] nthreads Number of encoding threads. If zero the number
+    //! of hardware threads is used.
+    //! \param[in] maxFrames Maximum number of frame buffers in use. If
+    //! zero twice the number of threads is used. Never less than two.
+    //! \param[in] maxBytes Maximum total size of the frame buffers in use.
+    //! A single frame larger than this is still accepted, one at a time.
+    //
+    AsyncImageWriter(int nthreads = 0, int maxFrames = 0, size_t maxBytes = 256 * 1024 * 1024);
+
+    //! Waits for all submitted frames to be written
+    //
+    virtual ~AsyncImageWriter();
+
+    //! Return a buffer of at least \p size bytes
+    //!
+    //! Blocks until a buffer is available and \p size more bytes fit in
+    //! the limit. The buffer must be passed to Submit() or ReleaseBuffer().
+    //
+    unsigned char *AcquireBuffer(size_t size);
+
+    //! Return a buffer obtained from AcquireBuffer() that won't be
+    //! submitted
+    //
+    void ReleaseBuffer(unsigned char *buffer);
+
+    //! Queue a frame to be written
+    //!
+    //! Ownership of \p writer and \p buffer passes to this object. A
+    //! writer that is not thread safe, see ImageWriter::IsThreadSafe(), is
+    //! run before this method returns.
+    //!
+    //! \param[in] writer Writer, opened and configured, for the frame's file
+    //! \param[in] buffer Image data, from AcquireBuffer()
+    //!
+    //! \retval status A negative int is returned if this frame, or an
+    //! earlier one since the last failure was reported, could not be
+    //! written
+    //
+    int Submit(ImageWriter *writer, unsigned char *buffer, unsigned int width, unsigned int height);
+
+    //! Wait for all submitted frames to be written
+    //!
+    //! \retval status A negative int is returned if any frame since the
+    //! last failure was reported could not be written
+    //
+    int Wait();
+
+    int GetNumThreads() const { return ((int)_threads.size()); }
+
+private:
+    struct frame_t {
+        ImageWriter *  writer;
+        unsigned char *buffer;
+        unsigned int   width;
+        unsigned int   height;
+    };
+
+    std::vector<std::thread>          _threads;
+    std::mutex                        _mutex;
+    std::condition_variable           _frameQueued;
+    std::condition_variable           _frameWritten;
+    std::deque<frame_t>               _queue;
+    std::map<unsigned char *, size_t> _sizes;       // size of every buffer allocated
+    std::vector<unsigned char *>      _freeBuffers;
+    size_t                            _maxFrames;
+    size_t                            _maxBytes;
+    size_t                            _nInUse;        // buffers acquired and not released
+    size_t                            _bytesInUse;    // size of those buffers
+    size_t                            _nPending;      // frames submitted and not written
+    std::vector<std::string>          _errors;        // of frames that failed, not yet reported
+    bool                              _done;
+
+    void _worker();
+    void _release(unsigned char *buffer);
+    int  _reportFailures();
+};
+
+}    // namespace VAPoR
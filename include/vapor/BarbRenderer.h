@@ -56,7 +56,7 @@ private:
 
     double _maxValue;
 
-    void _getMagnitudeAtPoint(std::vector<VAPoR::Grid *> variables, float point[3]);
+    void _getMaxMagnitude(const std::vector<VAPoR::Grid *> &variables, const vector<float> values[3]);
 
     void _recalculateScales(std::vector<VAPoR::Grid *> &varData, int ts);
 
@@ -96,12 +96,8 @@ private:
     //		vector <Grid *> variableData
     //	);
 
-    float _getHeightOffset(Grid *heightVar, float xCoord, float yCoord, bool &missing) const;
-
     bool _makeCLUT(float clut[1024]) const;
 
-    void _getDirection(float direction[3], std::vector<Grid *> varData, float xCoord, float yCoord, float zCoord, bool &missing) const;
-
     vector<double> _getScales();
 
     float _calculateLength(float start[3], float end[3]) const;
@@ -110,8 +106,6 @@ private:
 
     void _getStrides(vector<float> &strides, vector<int> &rakeGrid, vector<float> &rakeExts) const;
 
-    bool _defineBarb(const std::vector<Grid *>, float start[3], float end[3], bool doColorMapping, const float clut[1024]);
-
     void _operateOnGrid(vector<Grid *> variableData, bool drawBarb = true);
 
     bool _getColorMapping(float val, const float clut[256 * 4]);
@@ -126,9 +120,8 @@ private:
 
     //! Protected method to draw one barb (a hexagonal tube with a cone barbhead)
     //! \param[in] const float startPoint[3] beginning position of barb
-    //! \param[in] const float endPoint[3] ending position of barb
-    // void drawBarb(const float startPoint[3], const float endPoint[3]);
-    void _drawBarb(const std::vector<Grid *> variableData, const float startPoint[3], bool doColorMapping, const float clut[1024]);
+    //! \param[in] const float direction[3] field vector at \p startPoint
+    void _drawBarb(const float startPoint[3], const float direction[3]);
 
 #ifdef DEBUG
     _printBackDiameter(const float startVertex[18]) const;
@@ -0,0 +1,146 @@
+#ifndef _BlkDiskCache_h_
+#define _BlkDiskCache_h_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <vapor/MyBase.h>
+
+namespace VAPoR {
+
+//
+//! \class BlkDiskCache
+//! \brief A bounded on-disk cache of decoded data regions
+//!
+//! Stores arrays of decoded (uncompressed) data in a directory on local
+//! storage, one file per entry, under a caller supplied key. Entries are
+//! memory mapped when read back. The total size of the entries in the
+//! directory is kept below a byte budget by removing the least recently
+//! used entries, as given by the modification time of their files.
+//!
+//! Several processes may share a cache directory. Entries are written
+//! to a temporary file and renamed into place, so a reader never sees a
+//! partial entry, and each entry records its key, so a reader never
+//! returns data stored under a different key. Each process rescans the
+//! directory after writing a tenth of the budget, so the budget may be
+//! exceeded by at most that amount per process. Eviction is serialized
+//! between processes with an advisory lock on a file in the directory.
+//! An entry removed by another process while it is being read remains
+//! readable until it is unmapped.
+//!
+//! Put() only copies the entry into a queue. The files are written, and
+//! the directory trimmed, by a background thread, so callers holding
+//! their own locks don't wait on the disk. Queued entries are returned
+//! by Get().
+//!
+//! All methods are thread safe. The cache is not supported on Windows,
+//! where Open() fails.
+//
+class VDF_API BlkDiskCache : public Wasp::MyBase {
+public:
+    //! Cache statistics
+    //!
+    //! \sa GetStats()
+    //
+    class Stats {
+    public:
+        Stats() : nhits(0), nmisses(0), nwrites(0), nevicted(0), bytes_read(0), bytes_written(0) {}
+
+        size_t nhits;            // Number of successful Get() calls
+        size_t nmisses;          // Number of Get() calls that found no valid entry
+        size_t nwrites;          // Number of entries stored by Put()
+        size_t nevicted;         // Number of entries removed to stay within the budget
+        size_t bytes_read;       // Bytes copied out of the cache
+        size_t bytes_written;    // Bytes stored in the cache
+    };
+
+    BlkDiskCache();
+    virtual ~BlkDiskCache();
+
+    //! Open a cache directory
+    //!
+    //! \param[in] dir Path to the cache directory. It is created if it
+    //! does not exist.
+    //! \param[in] maxBytes Maximum total size of the entries in \p dir
+    //!
+    //! \retval status A negative int is returned if the directory can't
+    //! be created or written
+    //
+    int Open(const std::string &dir, size_t maxBytes);
+
+    //! Stop using the cache directory. Queued entries are written
+    //! first. The entries are left in place.
+    //
+    void Close();
+
+    //! Wait until every entry queued by Put() has been written, or has
+    //! failed to be written
+    //
+    void Flush();
+
+    //! Return true if a cache directory is open
+    //
+    bool IsOpen() const;
+
+    //! Copy an entry into \p buf
+    //!
+    //! \param[in] key Key the entry was stored under
+    //! \param[out] buf Buffer of \p nbytes bytes
+    //! \param[in] nbytes Size of the entry
+    //!
+    //! \retval bool True if a valid entry of \p nbytes bytes was found
+    //! and copied into \p buf
+    //
+    bool Get(const std::string &key, void *buf, size_t nbytes);
+
+    //! Store an entry
+    //!
+    //! The entry is copied and queued for writing. Entries larger than
+    //! the budget are not stored, and entries are dropped while the
+    //! queue is full. Failure to store an entry, e.g. because the disk
+    //! is full, is not an error for the caller: the data simply have to
+    //! be decoded again.
+    //!
+    //! \retval status A negative int is returned if the entry was not
+    //! queued. No error message is set.
+    //
+    int Put(const std::string &key, const void *buf, size_t nbytes);
+
+    //! Return statistics accumulated since the last call to Open()
+    //
+    Stats GetStats() const;
+
+private:
+    class pending {
+    public:
+        std::string       key;
+        std::string       path;
+        std::vector<char> data;
+    };
+
+    mutable std::mutex      _mutex;
+    std::string             _dir;
+    size_t                  _maxBytes;
+    size_t                  _usedBytes;       // estimate, exact after each _evict()
+    size_t                  _writtenBytes;    // bytes written since the last _evict()
+    size_t                  _tmpCount;
+    Stats                   _stats;
+    std::deque<pending>     _queue;           // front is being written
+    size_t                  _queuedBytes;
+    bool                    _stop;
+    std::condition_variable _cvQueue;
+    std::condition_variable _cvIdle;
+    std::thread             _writer;
+
+    std::string _path(const std::string &key) const;
+    bool        _write(const pending &p, const std::string &tmpPath) const;
+    size_t      _evict(const std::string &dir, size_t maxBytes, size_t &nevicted) const;
+    void        _writerLoop();
+};
+
+};    // namespace VAPoR
+
+#endif
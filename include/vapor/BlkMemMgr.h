@@ -5,6 +5,9 @@
 #ifndef _BlkMemMgr_h_
 #define _BlkMemMgr_h_
 
+#include <map>
+#include <unordered_map>
+#include <mutex>
 #include <vapor/MyBase.h>
 
 namespace VAPoR {
@@ -19,12 +22,49 @@ namespace VAPoR {
 //! A block-based memory allocator. Allocates contiguous runs of
 //! memory blocks from a memory pool of user defined size.
 //!
+//! Requests are rounded up to a size class (exact for runs of up to
+//! eight blocks, then four classes per power of two) and served from
+//! page aligned arenas obtained directly from the operating system.
+//! Where supported, arenas are marked as eligible for transparent huge
+//! pages. Freed runs are kept on a per size class free list
+//! and reused by later requests of the same class. Cached runs of other
+//! classes are returned to the operating system when a request would
+//! otherwise exceed the pool size, so the pool cannot become fragmented
+//! the way a single contiguous first-fit pool does.
+//!
+//! All methods are thread safe.
+//!
 //! N.B. the memory pool is stored in a static class member and
 //! can only be freed by calling RequestMemSize() with a zero value
 //! after all instances of this class have been destroyed
 //
-class BlkMemMgr : public Wasp::MyBase {
+class VDF_API BlkMemMgr : public Wasp::MyBase {
 public:
+    //! Allocator statistics
+    //!
+    //! \sa GetStats()
+    //
+    class Stats {
+    public:
+        Stats()
+        : bytes_max(0), bytes_in_use(0), bytes_requested(0), bytes_cached(0), fragmentation(0.0), nallocs(0), nfrees(0), nfailed(0), nreleased(0), alloc_time_mean(0.0), alloc_time_max(0.0)
+        {
+        }
+
+        size_t bytes_max;          // Pool size
+        size_t bytes_in_use;       // Bytes in runs handed out by Alloc()
+        size_t bytes_requested;    // Bytes actually asked for by Alloc() callers
+        size_t bytes_cached;       // Bytes in freed runs held for reuse
+        double fragmentation;      // Fraction of the reserved bytes not holding requested data
+        size_t nallocs;            // Number of successful Alloc() calls
+        size_t nfrees;             // Number of FreeMem() calls
+        size_t nfailed;            // Number of Alloc() calls that exceeded the pool size.
+                                   // Each one forces the caller to evict cached data
+        size_t nreleased;          // Number of cached runs returned to the OS to make room
+        double alloc_time_mean;    // Mean Alloc() latency in seconds
+        double alloc_time_max;     // Maximum Alloc() latency in seconds
+    };
+
     //! Initialize a memory allocator
     //
     //! Initialize a block-based memory allocator
@@ -37,7 +77,8 @@ public:
     //! Return a pointer to the specified amount of memory from the memory pool
     //! \param[in] num_blks Size of memory region requested in blocks
     //! \param[in] fill If true, the allocated memory will be cleared to zero
-    //! \retval ptr A pointer to the requested memory pool
+    //! \retval ptr A pointer to the requested memory pool, or NULL if
+    //! the request can not be satisfied without exceeding the pool size
     //
     void *Alloc(size_t num_blks, bool fill = false);
 
@@ -61,35 +102,47 @@ public:
     //! \param[in] num_blks Size of memory pool in blocks. This is the
     //! maximum amount that will be available through subsequent
     //! \b Alloc() calls.
-    //! \param[in] page_aligned If true, start address of memory pool
-    //! will be page aligned
+    //! \param[in] page_aligned Ignored. Memory is always page aligned.
     //
     static int RequestMemSize(size_t blk_size, size_t num_blks, bool page_aligned = true);
 
     static size_t GetBlkSize() { return (_blk_size); }
 
+    //! Return allocator statistics
+    //!
+    //! Return a snapshot of the counters of the static memory pool.
+    //! Counters are reset when the pool is re-initialized.
+    //
+    static Stats GetStats();
+
 private:
     typedef struct {
-        size_t _nfree;    // number of contiguous free blocks
-        size_t _nused;    // number of contiguous used blocks
-        void * _blk;      // pointer to first free/used block
+        size_t _class;        // size class in blocks
+        size_t _requested;    // size requested in blocks
     } _mem_allocation_t;
 
-    static vector<vector<_mem_allocation_t>> _mem_regions;
-    static vector<size_t>                    _mem_region_sizes;    // size of mem in blocks
-    static vector<unsigned char *>           _blks;                // memory pool
+    static std::mutex _mutex;    // guards all static state
+
+    static std::unordered_map<void *, _mem_allocation_t> _used;    // runs handed out
+    static std::map<size_t, vector<void *>>             _free;    // freed runs by size class
 
     static size_t _mem_size_max_req;    // max requested size of mem in blocks
-    static bool   _page_aligned_req;    // requested page align memory
     static size_t _blk_size_req;        // requested size of block in bytes
 
     static size_t _mem_size_max;    // max size of mem in blocks
-    static bool   _page_aligned;    // page align memory
     static size_t _blk_size;        // size of block in bytes
+    static size_t _mem_size;        // blocks in used and cached runs
 
     static int _ref_count;    // # instances of object.
 
-    static int _Reinit(size_t n);
+    static Stats  _stats;
+    static double _alloc_time_total;
+
+    static size_t _SizeClass(size_t n);
+    static void * _MapRun(size_t nblks);
+    static void   _UnmapRun(void *ptr, size_t nblks);
+    static bool   _ReleaseCached(size_t n);
+    static void   _ReleaseAll();
 };
 };    // namespace VAPoR
 
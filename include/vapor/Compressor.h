@@ -22,8 +22,8 @@ namespace VAPoR {
 //! decomposition on an array with an arbitrary
 //! number of dimensions (up to 3 presently). Compression
 //! is performed by transforming
-//! data with a wavelet transform, sorting the resulting
-//! coefficients, and returning the n largest magnitude coefficients.
+//! data with a wavelet transform, selecting the n largest magnitude
+//! coefficients, and returning them.
 //
 class WASP_API Compressor : public MatWaveWavedec {
 public:
@@ -344,7 +344,7 @@ public:
 private:
     vector<size_t> _dims;        // dimensions of array
     int            _nlevels;     // Number of wavelet transformation levels
-    vector<void *> _indexvec;    // used to sort wavelet coefficients
+    Wasp::SmartBuf _selectBuf;    // coefficient magnitudes used to select coefficients
     size_t         _nx;
     size_t         _ny;
     size_t         _nz;
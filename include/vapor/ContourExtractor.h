@@ -0,0 +1,98 @@
+#ifndef CONTOUREXTRACTOR_H
+#define CONTOUREXTRACTOR_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <vapor/common.h>
+
+namespace VAPoR {
+
+class Grid;
+
+//! \class ContourExtractor
+//! \brief CPU isoline extraction, used by the ContourRenderer
+//!
+//! Extracts line segments of constant value from the cells of a grid.
+//! The class has no OpenGL dependencies.
+//!
+//! Cells are processed in parallel, in tiles of consecutive cells. Each
+//! cell edge is interpolated once for all of the contour values that
+//! cross it, found by a binary search of the sorted contour values, so
+//! the cost of a cell that no contour crosses doesn't grow with the
+//! number of contour values.
+//!
+//! Segments are cached per contour value under a caller supplied key
+//! that identifies the grid (e.g. time step, variable, refinement level,
+//! and level of detail). Extracting a new contour value for a cached key
+//! leaves the segments of the other values in place.
+//
+class VDF_API ContourExtractor {
+public:
+    //! A segment end point. Consecutive pairs of vertices form a segment.
+    //! The layout matches the vertex buffer of the ContourRenderer.
+    //
+    struct Vertex {
+        float x, y, z;
+        float v;    // contour value
+    };
+
+    //! \param[in] maxKeys Number of keys whose segments are cached
+    //! \param[in] nThreads Number of threads. A value less than one uses
+    //! the number of hardware threads
+    //
+    ContourExtractor(size_t maxKeys = 4, int nThreads = 0);
+
+    //! Return the values in \p contours that are not cached for \p key
+    //
+    std::vector<double> GetMissing(const std::string &key, const std::vector<double> &contours) const;
+
+    //! Extract segments and add them to the cache
+    //!
+    //! \param[in] key Cache key identifying \p grid and \p heightGrid
+    //! \param[in] grid Grid to contour. Cells with a missing value at
+    //! any node are skipped
+    //! \param[in] heightGrid If not NULL, the Z coordinate of the segments is
+    //! interpolated from this grid, which must have the same dimensions
+    //! as \p grid. Otherwise Z is \p defaultZ
+    //! \param[in] defaultZ Z coordinate used when \p heightGrid is NULL
+    //! \param[in] minu Minimum box coordinate. Only cells whose nodes all lie
+    //! within the axis-aligned box defined by \p minu and \p maxu are
+    //! contoured. Empty vectors select every cell. The box is part of what
+    //! \p key must identify
+    //! \param[in] maxu Maximum box coordinate
+    //! \param[in] contours Contour values to extract
+    //
+    void Extract(const std::string &key, const Grid *grid, const Grid *heightGrid, float defaultZ, const std::vector<double> &minu, const std::vector<double> &maxu,
+                 const std::vector<double> &contours);
+
+    //! Return the cached segments of \p contours for \p key
+    //!
+    //! The segments of each value are returned in the order the values
+    //! appear in \p contours. Values that are not cached are skipped.
+    //
+    void GetSegments(const std::string &key, const std::vector<double> &contours, std::vector<Vertex> &vertices) const;
+
+    //! Remove all cached segments
+    //
+    void Clear()
+    {
+        _cache.clear();
+        _lru.clear();
+    }
+
+private:
+    typedef std::map<double, std::vector<Vertex>> Segments;
+
+    size_t                            _maxKeys;
+    int                               _nThreads;
+    std::map<std::string, Segments>   _cache;
+    std::list<std::string>            _lru;    // most recently used key first
+
+    Segments &_getSegments(const std::string &key);
+};
+
+};    // namespace VAPoR
+
+#endif    // CONTOUREXTRACTOR_H
@@ -35,6 +35,7 @@
 #include <vapor/ContourParams.h>
 #include <vapor/ShaderProgram.h>
 #include <vapor/Texture.h>
+#include <vapor/ContourExtractor.h>
 
 namespace VAPoR {
 
@@ -63,7 +64,7 @@ private:
     Texture1D    _lutTexture;
     unsigned int _nVertices;
 
-    struct VertexData;
+    ContourExtractor _extractor;
     struct {
         string         varName;
         string         heightVarName;
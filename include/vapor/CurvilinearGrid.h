@@ -1,5 +1,6 @@
 #ifndef _CurvilinearGrid_
 #define _CurvilinearGrid_
+#include <mutex>
 #include <vapor/common.h>
 #include <vapor/Grid.h>
 #include <vapor/RegularGrid.h>
@@ -251,6 +252,10 @@ private:
     RegularGrid                                             _zrg;
     bool                                                    _terrainFollowing;
     std::shared_ptr<const QuadTreeRectangle<float, size_t>> _qtr;
+    mutable std::vector<float>                              _columnBounds;    // Z range of each column of cells, built on first use
+    mutable std::once_flag                                  _columnBoundsOnce;
+
+    const std::vector<float> &_getColumnBounds() const;
 
     void _curvilinearGrid(const RegularGrid &xrg, const RegularGrid &yrg, const RegularGrid &zrg, const std::vector<double> &zcoords, std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr);
 
@@ -258,6 +263,8 @@ private:
 
     bool _insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double lambda[4], double zwgt[2]) const;
 
+    bool _walkToFace(double x, double y, size_t &i, size_t &j) const;
+
     void _getIndicesHelper(const std::vector<double> &coords, std::vector<size_t> &indices) const;
 
     bool _insideGridHelperStretched(double z, size_t &k, double zwgt[2]) const;
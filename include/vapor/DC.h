@@ -1693,6 +1693,29 @@ public:
     virtual int ReadRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, float *region) { return (readRegionBlock(fd, min, max, region)); }
     virtual int ReadRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, int *region) { return (readRegionBlock(fd, min, max, region)); }
 
+    //! Return the range of a subregion from metadata, if available
+    //!
+    //! Some data collections store the minimum and maximum value of
+    //! each storage block. This method returns the range of the subregion
+    //! of the currently opened variable specified by \p min and \p max
+    //! using only that metadata, without reading the data. The range is
+    //! exact if \p min and \p max are aligned with the storage blocks
+    //! (See GetDimLensAtLevel()). Otherwise it bounds the data range.
+    //!
+    //! \param[in] fd A valid file descriptor returned by OpenVariableRead()
+    //! \param[in] min Minimum region extents in grid coordinates
+    //! \param[in] max Maximum region extents in grid coordinates
+    //! \param[out] range A two-element vector containing the minimum and
+    //! maximum value
+    //!
+    //! \retval status Returns 1 if the range was determined, 0 if
+    //! no range metadata are available for the variable, and a negative
+    //! value on failure
+    //!
+    //! \sa OpenVariableRead(), ReadRegion()
+    //
+    virtual int ReadRegionRange(int fd, const vector<size_t> &min, const vector<size_t> &max, vector<double> &range) { return (readRegionRange(fd, min, max, range)); }
+
     //! Read an entire variable in one call
     //!
     //! This method reads and entire variable (all time steps, all grid points)
@@ -2203,6 +2226,14 @@ protected:
 
     virtual int readRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, int *region) = 0;
 
+    //! \copydoc ReadRegionRange()
+    //
+    virtual int readRegionRange(int fd, const vector<size_t> &min, const vector<size_t> &max, vector<double> &range)
+    {
+        range.clear();
+        return (0);
+    }
+
     //! \copydoc VariableExists()
     //
     virtual bool variableExists(size_t ts, string varname, int reflevel = 0, int lod = 0) const = 0;
@@ -46,6 +46,9 @@ protected:
     //! \param[in] path A list of CF NetCDF files comprising the output of
     //! a single CF model run.
     //!
+    //! \param[in] options Supports "-index_dir <dir>", which enables the
+    //! persistent metadata index described in NetCDFCollection::SetIndexDir()
+    //!
     //! \retval status A negative int is returned on failure
     //!
     //! \sa EndDefine();
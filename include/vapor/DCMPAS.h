@@ -49,6 +49,9 @@ protected:
     //! \param[in] path A list of MPAS NetCDF files comprising the output of
     //! a single MPAS model run.
     //!
+    //! \param[in] options Supports "-index_dir <dir>", which enables the
+    //! persistent metadata index described in NetCDFCollection::SetIndexDir()
+    //!
     //! \retval status A negative int is returned on failure
     //!
     //! \sa EndDefine();
@@ -171,6 +174,8 @@ private:
     Wasp::SmartBuf                  _nEdgesOnCellBuf;
     Wasp::SmartBuf                  _lonCellSmartBuf;
     Wasp::SmartBuf                  _lonVertexSmartBuf;
+    long                            _nEdgesOnCellTS;    // time step in _nEdgesOnCellBuf, or -1
+    long                            _coordinatesTS;     // time step in lon smart bufs, or -1
 
     int _InitDerivedVars(NetCDFCollection *ncdfc);
     int _InitCoordvars(NetCDFCollection *ncdfc);
@@ -198,11 +203,11 @@ private:
     bool _isDataVar(string varname) const;
 
     int  _read_nEdgesOnCell(size_t ts);
-    void _addMissingFlag(int *data) const;
+    void _addMissingFlag(int *data, size_t j0, size_t j1) const;
     int  _readVarToSmartBuf(size_t ts, string varname, Wasp::SmartBuf &smartBuf);
     int  _readCoordinates(size_t ts);
 
-    void _splitOnBoundary(string varname, int *connData) const;
+    void _splitOnBoundary(string varname, int *connData, size_t j0, size_t j1) const;
 
     int _readRegionTransposed(MPASFileObject *w, const vector<size_t> &min, const vector<size_t> &max, float *region);
 
@@ -49,6 +49,9 @@ protected:
     //! \param[in] path A list of WRF NetCDF files comprising the output of
     //! a single WRF model run.
     //!
+    //! \param[in] options Supports "-index_dir <dir>", which enables the
+    //! persistent metadata index described in NetCDFCollection::SetIndexDir()
+    //!
     //! \retval status A negative int is returned on failure
     //!
     //! \sa EndDefine();
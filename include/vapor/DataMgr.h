@@ -1,8 +1,15 @@
 #include <vector>
 #include <iostream>
 #include <list>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include "vapor/VAssert.h"
 #include <vapor/BlkMemMgr.h>
+#include <vapor/BlkDiskCache.h>
+#include <vapor/MeshPartitionIndex.h>
 #include <vapor/DC.h>
 #include <vapor/MyBase.h>
 #include <vapor/RegularGrid.h>
@@ -575,6 +582,163 @@ public:
     //!
     void PurgeVariable(string varname);
 
+    //! Enable or disable speculative time step prefetching
+    //!
+    //! When enabled the DataMgr monitors the sequence of requests made
+    //! with GetVariable(). If successive requests for a variable differ
+    //! only in their time step (the variable name, refinement level,
+    //! level-of-detail, and region are unchanged) the next \p nsteps
+    //! time steps, continuing with the same stride, are read by a
+    //! background thread into the memory cache. A subsequent
+    //! GetVariable() for one of these time steps is then satisfied from
+    //! the cache.
+    //!
+    //! Pending prefetch requests for a variable are cancelled whenever
+    //! the variable is requested with a different region, refinement
+    //! level, or level-of-detail. Reads performed by the prefetch thread
+    //! are serialized with reads made by the caller, so enabling
+    //! prefetching does not make the DataMgr otherwise thread safe.
+    //!
+    //! The prefetch thread never evicts locked regions, nor regions
+    //! requested by the caller for the current or the previous time
+    //! step. A read ahead that would exceed the memory budget is
+    //! skipped. The outcome of each read ahead is available from
+    //! GetPrefetchStatus().
+    //!
+    //! \param[in] nsteps Number of time steps to read ahead. A value
+    //! of zero, the default, disables prefetching.
+    //! \param[in] memFraction The maximum fraction of the memory cache
+    //! (see DataMgr()) that may be occupied by prefetched regions that have
+    //! not yet been requested. Must be in the range (0.0, 1.0].
+    //!
+    //! \sa GetPrefetch()
+    //
+    void SetPrefetch(size_t nsteps, double memFraction = 0.25);
+
+    //! Return the number of time steps read ahead
+    //!
+    //! \sa SetPrefetch()
+    //
+    size_t GetPrefetch() const { return (_prefetchNSteps); }
+
+    //! Status of a time step queued for prefetching
+    //!
+    //! \sa GetPrefetchStatus()
+    //
+    enum PrefetchStatus {
+        PrefetchNone,       //!< Not queued, or the request was cancelled
+        PrefetchPending,    //!< Queued and not yet read
+        PrefetchDone,       //!< Read into the memory cache
+        PrefetchSkipped,    //!< Not read: the memory budget was exhausted
+        PrefetchFailed      //!< The read failed
+    };
+
+    //! Return the status of the most recent prefetch request for time
+    //! step \p ts of variable \p varname
+    //!
+    //! Errors encountered by the prefetch thread are not reported with
+    //! SetErrMsg(): they are only visible here.
+    //!
+    //! \sa SetPrefetch()
+    //
+    PrefetchStatus GetPrefetchStatus(size_t ts, string varname) const;
+
+    //! Enable a second level cache of decoded data on local disk
+    //!
+    //! When enabled, regions of compressed variables that are read and
+    //! decoded from the data collection are also written, decoded, to
+    //! \p dir. A later request for the same region (variable, time step,
+    //! refinement level, level-of-detail, and block extents) that misses
+    //! the memory cache is then satisfied by mapping the stored region
+    //! instead of decoding it again. Entries are keyed by the paths,
+    //! sizes, and modification times of the files passed to
+    //! Initialize(), so entries of modified data are never used.
+    //!
+    //! Horizontal coordinates projected from geographic coordinates
+    //! (see the -project_to_pcs option of Initialize()) are cached the
+    //! same way, keyed also by the map projection.
+    //!
+    //! The least recently used entries are removed to keep the size of
+    //! \p dir within \p maxMB. Several processes may share \p dir.
+    //! See BlkDiskCache.
+    //!
+    //! If this method is not called, the cache is enabled by
+    //! Initialize() when the environment variable VAPOR_DISK_CACHE_DIR
+    //! names a directory. Its size is then given in MEGABYTES by
+    //! VAPOR_DISK_CACHE_MB, or 10240 if unset.
+    //!
+    //! \param[in] dir Path to the cache directory. An empty string
+    //! disables the cache.
+    //! \param[in] maxMB Maximum size of the cache in MEGABYTES
+    //!
+    //! \retval status A negative int is returned if \p dir can't be used
+    //
+    int SetDiskCache(string dir, size_t maxMB);
+
+    //! Return statistics of the disk cache
+    //!
+    //! \sa SetDiskCache()
+    //
+    BlkDiskCache::Stats GetDiskCacheStats() const { return (_diskCache.GetStats()); }
+
+    //! Read only the region of interest of unstructured meshes
+    //!
+    //! When enabled, a variable sampled at the nodes of a 2D or layered
+    //! unstructured mesh that is requested with a box in user
+    //! coordinates (see GetVariable()) is returned on the part of the
+    //! mesh that covers the box, rather than on the whole mesh. Only
+    //! that part of the variable, its coordinates, and the mesh
+    //! connectivity are read, and the connectivity of the grid returned
+    //! refers to the nodes and faces of the part.
+    //!
+    //! The part is found with a MeshPartitionIndex of the mesh nodes.
+    //! The index is built the first time a mesh is requested, and is
+    //! saved next to the first file passed to Initialize(), if that
+    //! directory is writable, so later sessions need not read the
+    //! whole mesh again.
+    //!
+    //! If this method is not called, the feature is enabled by
+    //! Initialize() when the environment variable VAPOR_MESH_INDEX is
+    //! set.
+    //!
+    //! \param[in] enable Enable or disable region of interest reads
+    //! \param[in] partitionSize Number of nodes per partition of the
+    //! index
+    //!
+    //! \sa MeshPartitionIndex
+    //
+    void SetMeshIndex(bool enable, size_t partitionSize = 4096);
+
+    //! Return true if region of interest reads of unstructured meshes
+    //! are enabled
+    //!
+    //! \sa SetMeshIndex()
+    //
+    bool GetMeshIndex() const { return (_meshIndexEnabled); }
+
+    //! Save the search trees of curvilinear and unstructured grids
+    //!
+    //! Locating points in a curvilinear or unstructured grid relies on a
+    //! QuadTreeRectangle of its cells, which takes seconds to build for
+    //! a large mesh. When enabled, each tree is saved next to the first
+    //! file passed to Initialize(), if that directory is writable, and
+    //! later sessions memory map the saved tree instead of building it.
+    //!
+    //! If this method is not called, the feature is enabled by
+    //! Initialize() when the environment variable VAPOR_QTR_CACHE is set.
+    //!
+    //! \param[in] enable Enable or disable saving of search trees
+    //!
+    //! \sa QuadTreeRectangle::Write()
+    //
+    void SetQuadTreeCache(bool enable);
+
+    //! Return true if search trees are saved
+    //!
+    //! \sa SetQuadTreeCache()
+    //
+    bool GetQuadTreeCache() const { return (_qtrCacheEnabled); }
+
     class BlkExts {
     public:
         BlkExts();
@@ -667,6 +831,10 @@ private:
         std::vector<size_t> bmax;
         int                 lock_counter;
         void *              blks;
+        size_t              nbytes;
+        bool                prefetched;    // read ahead and not yet requested
+        size_t              epoch;         // foreground epoch of last access
+        string              subset;        // part of an unstructured mesh, if any
     } region_t;
 
     // a list of all allocated regions
@@ -682,6 +850,85 @@ private:
 
     std::map<string, BlkExts> _blkExtsCache;
 
+    // Serializes access to the cache and the DC between the caller and
+    // the prefetch thread
+    //
+    mutable std::recursive_mutex _mutex;
+
+    typedef struct {
+        size_t              ts;
+        string              varname;
+        int                 level;
+        int                 lod;
+        std::vector<size_t> min;    // empty if entire domain
+        std::vector<size_t> max;
+        size_t              ahead;    // distance, in strides, from last request
+    } prefetch_t;
+
+    BlkDiskCache _diskCache;
+    bool         _diskCacheSet;    // SetDiskCache() was called
+    string       _datasetID;       // identifies the files passed to Initialize()
+
+    // Part of an unstructured mesh that covers a region of interest
+    //
+    typedef struct {
+        string              key;      // names the partitions of the part
+        std::vector<size_t> nodes;    // sorted node indices
+        std::vector<size_t> faces;    // sorted face indices
+    } mesh_subset_t;
+
+    bool                                   _meshIndexEnabled;
+    bool                                   _meshIndexSet;    // SetMeshIndex() was called
+    size_t                                 _meshIndexPartitionSize;
+    string                                 _meshIndexPrefix;    // path prefix of saved indices
+    string                                 _meshIndexID;        // identifies the saved indices
+    std::map<string, MeshPartitionIndex *> _meshIndices;        // by coordinate names, level and lod
+    std::map<string, mesh_subset_t>        _meshSubsets;        // most recent part, by mesh name
+
+    bool _qtrCacheEnabled;
+    bool _qtrCacheSet;    // SetQuadTreeCache() was called
+
+    void _initQuadTreeCache();
+
+    void _clearMeshIndices();
+
+    const MeshPartitionIndex *_getMeshIndex(string varname, const std::vector<DC::CoordVar> &cvarsinfo, int level, int lod);
+
+    const mesh_subset_t *_getMeshSubset(string varname, const MeshPartitionIndex *index, const std::vector<double> &min, const std::vector<double> &max, int level, int lod);
+
+    int _getVariableSubset(size_t ts, string varname, int level, int lod, const std::vector<double> &min, const std::vector<double> &max, bool lock, Grid *&rg);
+
+    template<class T>
+    T *_get_subset_region(size_t ts, string varname, int level, int lod, int axis, const std::vector<size_t> &elements, const string &subset, std::vector<size_t> &dims, bool &cached);
+
+    template<class T> int _readElements(size_t ts, string varname, int level, int lod, int axis, const std::vector<size_t> &elements, T *region);
+
+    size_t                                             _prefetchNSteps;
+    double                                             _prefetchMemFraction;
+    size_t                                             _prefetchBytes;     // bytes prefetched but not yet requested
+    size_t                                             _prefetchEpoch;     // incremented when caller changes time step
+    size_t                                             _foregroundTS;
+    bool                                               _prefetchActive;    // true while prefetch thread is reading
+    bool                                               _prefetchStop;
+    std::map<string, prefetch_t>                       _prefetchLast;      // most recent request by variable
+    std::deque<prefetch_t>                             _prefetchQueue;
+    std::map<string, std::map<size_t, PrefetchStatus>> _prefetchStatus;    // by variable and time step
+    mutable std::mutex                                 _prefetchMutex;
+    std::condition_variable                            _prefetchCV;
+    std::thread                                        _prefetchThread;
+
+    void _foregroundRequest(size_t ts);
+    void _prefetchNotify(size_t ts, string varname, int level, int lod, const std::vector<size_t> &min, const std::vector<size_t> &max);
+    void _prefetchCancel(string varname);
+    void _prefetchStart();
+    void _prefetchShutdown();
+    void _prefetchWorker();
+    void _prefetchSetStatus(const prefetch_t &req, PrefetchStatus status);
+
+    // Maximum number of bytes of read-ahead not yet requested by the caller
+    //
+    size_t _prefetchBudget() const { return ((size_t)(_prefetchMemFraction * _mem_size * 1024 * 1024)); }
+
     // Get the immediate variable dependencies of a variable
     //
     std::vector<string> _get_var_dependencies_1(string varname) const;
@@ -735,6 +982,13 @@ private:
 
     int _find_bounding_grid(size_t ts, string varname, int level, int lod, std::vector<double> min, std::vector<double> max, std::vector<size_t> &min_ui, std::vector<size_t> &max_ui);
 
+    // Determine the range of a native variable over a block-aligned
+    // region from the data collection's per-block range metadata, which
+    // is recorded for every refinement level and lod. Returns false if
+    // the metadata can't be used.
+    //
+    bool _get_data_range_from_metadata(size_t ts, string varname, int level, int lod, const std::vector<size_t> &min_ui, const std::vector<size_t> &max_ui, std::vector<double> &range);
+
     void _setupCoordVecsHelper(string data_varname, const vector<size_t> &data_dimlens, const vector<size_t> &data_bmin, const vector<size_t> &data_bmax, string coord_varname, int order,
                                vector<size_t> &coord_dimlens, vector<size_t> &coord_bmin, vector<size_t> &coord_bmax, bool structured) const;
 
@@ -750,7 +1004,8 @@ private:
 
     int _parseOptions(vector<string> &options);
 
-    template<typename T> T *_get_region_from_cache(size_t ts, string varname, int level, int lod, const std::vector<size_t> &bmin, const std::vector<size_t> &bmax, bool lock);
+    template<typename T>
+    T *_get_region_from_cache(size_t ts, string varname, int level, int lod, const std::vector<size_t> &bmin, const std::vector<size_t> &bmax, bool lock, const string &subset = "");
 
     template<typename T>
     int _get_unblocked_region_from_fs(size_t ts, string varname, int level, int lod, const vector<size_t> &grid_dims, const vector<size_t> &grid_bs, const vector<size_t> &grid_min,
@@ -776,9 +1031,10 @@ private:
 
     std::vector<string> _get_native_variables() const;
 
-    void *_alloc_region(size_t ts, string varname, int level, int lod, std::vector<size_t> bmin, std::vector<size_t> bmax, std::vector<size_t> bs, int element_sz, bool lock, bool fill);
+    void *_alloc_region(size_t ts, string varname, int level, int lod, std::vector<size_t> bmin, std::vector<size_t> bmax, std::vector<size_t> bs, int element_sz, bool lock, bool fill,
+                        const string &subset = "");
 
-    void _free_region(size_t ts, string varname, int level, int lod, std::vector<size_t> bmin, std::vector<size_t> bmax, bool forceFlag = false);
+    void _free_region(size_t ts, string varname, int level, int lod, std::vector<size_t> bmin, std::vector<size_t> bmax, bool forceFlag = false, const string &subset = "");
 
     bool _free_lru();
     void _free_var(string varname);
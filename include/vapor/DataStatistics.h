@@ -0,0 +1,98 @@
+#ifndef _DataStatistics_h_
+#define _DataStatistics_h_
+
+#include <vector>
+#include <string>
+#include <vapor/MyBase.h>
+#include <vapor/Grid.h>
+
+namespace VAPoR {
+
+class DataMgr;
+
+//
+//! \class DataStatistics
+//! \brief Summary statistics of a variable over a region and time range
+//!
+//! Computes the minimum, maximum, mean, standard deviation, count, and
+//! median of the valid (not missing) samples of a variable that lie
+//! inside an axis-aligned box, merged over a range of time steps.
+//!
+//! Each time step is fetched from the DataMgr once, and all moments are
+//! accumulated in that pass. The grid is reduced in parallel, one block
+//! at a time. The median is found without sorting the samples: each
+//! time step contributes a fixed size histogram, the merged histograms
+//! bound the interval that must contain the median, and only the
+//! samples inside that interval are kept for an exact selection. A
+//! second fetch is only needed when more than one time step overlaps
+//! the interval.
+//!
+//! The class has no GUI dependencies and may be used by any application
+//! that has a DataMgr.
+//
+class VDF_API DataStatistics : public Wasp::MyBase {
+public:
+    //! Statistics of a set of samples
+    //!
+    //! All floating point members are NaN if \p count is zero, and
+    //! \p median is NaN if it was not requested.
+    //
+    class Stats {
+    public:
+        Stats();
+
+        long   count;     // Number of valid samples
+        double min;
+        double max;
+        double mean;
+        double stddev;    // Population standard deviation
+        double median;    // Element count/2 of the sorted samples
+    };
+
+    //! Constructor
+    //!
+    //! \param[in] nthreads Number of threads used to reduce each grid.
+    //! A value less than one uses the number of processors.
+    //
+    DataStatistics(int nthreads = 0);
+
+    //! Compute the statistics of a variable
+    //!
+    //! \param[in] dataMgr Data manager to fetch the variable from
+    //! \param[in] varname Name of the variable
+    //! \param[in] ts0 First time step
+    //! \param[in] ts1 Last time step, inclusive. Ignored if \p varname
+    //! is not time varying
+    //! \param[in] level Refinement level
+    //! \param[in] lod Level of detail
+    //! \param[in] minu Minimum corner of the region in user coordinates
+    //! \param[in] maxu Maximum corner of the region in user coordinates
+    //! \param[in] median If true, the median is computed as well
+    //! \param[out] stats The statistics
+    //!
+    //! Time steps that can not be read are skipped, and the statistics
+    //! are those of the remaining time steps. The median is NaN if a time
+    //! step that must be read a second time for it can not be.
+    //!
+    //! \retval status A negative int is returned if no time step could
+    //! be read
+    //
+    int Compute(DataMgr *dataMgr, std::string varname, size_t ts0, size_t ts1, int level, int lod, const std::vector<double> &minu, const std::vector<double> &maxu, bool median, Stats &stats);
+
+    //! Compute the statistics of a single grid
+    //!
+    //! \param[in] grid The grid
+    //! \param[in] minu Minimum corner of the region in user coordinates
+    //! \param[in] maxu Maximum corner of the region in user coordinates
+    //! \param[in] median If true, the median is computed as well
+    //! \param[out] stats The statistics
+    //
+    void Compute(const Grid *grid, const std::vector<double> &minu, const std::vector<double> &maxu, bool median, Stats &stats) const;
+
+private:
+    int _nthreads;
+};
+
+};    // namespace VAPoR
+
+#endif
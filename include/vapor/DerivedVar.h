@@ -1,5 +1,6 @@
 #include <iostream>
 #include <functional>
+#include <memory>
 #include <vapor/DC.h>
 #include <vapor/MyBase.h>
 #include <vapor/Proj4API.h>
@@ -273,19 +274,35 @@ public:
 
     virtual bool VariableExists(size_t ts, int reflevel, int lod) const;
 
+    //! Share projected coordinates with the variable for the other axis
+    //!
+    //! X and Y are always projected together. Once two variables share
+    //! their coordinates, a region projected for one of them is kept so
+    //! that reading the same region of the other doesn't project it
+    //! again. Regions are also reused when the geographic coordinates
+    //! read are unchanged, e.g. for another time step.
+    //!
+    //! \param[in] other Variable with the same inputs and projection,
+    //! for the other axis
+    //
+    void ShareCoordinates(DerivedCoordVar_PCSFromLatLon *other);
+
 private:
-    DC *                _dc;
-    string              _proj4String;
-    string              _lonName;
-    string              _latName;
-    string              _xCoordName;
-    string              _yCoordName;
-    bool                _make2DFlag;
-    bool                _uGridFlag;
-    bool                _lonFlag;
-    std::vector<size_t> _dimLens;
-    Proj4API            _proj4API;
-    DC::CoordVar        _coordVarInfo;
+    class PCSCache;
+
+    DC *                      _dc;
+    string                    _proj4String;
+    string                    _lonName;
+    string                    _latName;
+    string                    _xCoordName;
+    string                    _yCoordName;
+    bool                      _make2DFlag;
+    bool                      _uGridFlag;
+    bool                      _lonFlag;
+    std::vector<size_t>       _dimLens;
+    Proj4API                  _proj4API;
+    DC::CoordVar              _coordVarInfo;
+    std::shared_ptr<PCSCache> _cache;
 
     int _setupVar();
 
@@ -14,6 +14,8 @@ namespace VAPoR {
 //
 enum class FlowSeedMode : int { UNIFORM = 0, RANDOM = 1, RANDOM_BIAS = 2, LIST = 3 };
 enum class FlowDir : int { FORWARD = 0, BACKWARD = 1, BI_DIR = 2 };
+// Values match flow::Advection::ADVECTION_METHOD
+enum class FlowIntegrator : int { RK4 = 1, RK45 = 2 };
 
 class FlowParams;
 class PARAMS_API FakeRakeBox : public Box {
@@ -114,6 +116,19 @@ public:
     int  GetSeedInjInterval() const;
     void SetSeedInjInterval(int);
 
+    /*
+     * One of the FlowIntegrator values.
+     */
+    int  GetIntegrationMethod() const;
+    void SetIntegrationMethod(int);
+
+    /*
+     * Error tolerance of the adaptive (RK45) integration, relative to the
+     * size of the domain.
+     */
+    double GetIntegrationTolerance() const;
+    void   SetIntegrationTolerance(double);
+
     //! \copydoc RenderParams::GetRenderDim()
     //
     virtual size_t GetRenderDim() const override
@@ -165,6 +180,8 @@ public:
     static const std::string _rakeBiasStrength;
     static const std::string _pastNumOfTimeSteps;
     static const std::string _seedInjInterval;
+    static const std::string _integrationMethodTag;
+    static const std::string _integrationToleranceTag;
     static const std::string _xGridNumOfSeedsTag;
     static const std::string _yGridNumOfSeedsTag;
     static const std::string _zGridNumOfSeedsTag;
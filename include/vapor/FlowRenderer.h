@@ -74,6 +74,8 @@ private:
     int                _cache_pastNumOfTimeSteps = 0;
     float              _cache_rakeBiasStrength = 0.0f;
     double             _cache_deltaT = 0.05;
+    double             _cache_tolerance = 1e-5;
+    FlowIntegrator     _cache_integrator = FlowIntegrator::RK4;
     FlowSeedMode       _cache_seedGenMode = FlowSeedMode::UNIFORM;
     FlowDir            _cache_flowDir = FlowDir::FORWARD;
     FlowStatus         _velocityStatus = FlowStatus::SIMPLE_OUTOFDATE;
@@ -109,7 +111,7 @@ private:
     int       _renderAdvection(const flow::Advection *adv);
     int       _renderAdvectionHelper(bool renderDirection = false);
     void      _prepareColormap(FlowParams *);
-    void      _particleHelper1(std::vector<float> &vec, const flow::Particle &p, bool singleColor) const;
+    void      _particleHelper1(std::vector<float> &vec, const flow::Trajectories &traj, size_t idx, bool singleColor) const;
     int       _drawALineStrip(const float *buf, size_t numOfParts, bool singleColor) const;
     void      _restoreGLState() const;
     glm::vec3 _getScales();
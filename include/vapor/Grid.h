@@ -9,6 +9,7 @@
 #include <limits>
 #include "vapor/VAssert.h"
 #include <memory>
+#include <functional>
 #include <vapor/common.h>
 
 #ifdef WIN32
@@ -246,6 +247,26 @@ public:
         return (GetValue(coords));
     }
 
+    //! Get the reconstructed values of the sampled scalar function at
+    //! many points
+    //!
+    //! Returns the same values as calling GetValue() for each point in
+    //! turn. Derived classes that can locate cells and read node values
+    //! directly override this method, saving the per point overhead of
+    //! the virtual calls, coordinate clamping and value accesses made by
+    //! GetValue().
+    //!
+    //! \param[in] n Number of points
+    //! \param[in] x Array of \p n X coordinates
+    //! \param[in] y Array of \p n Y coordinates
+    //! \param[in] z Array of \p n Z coordinates. Ignored, and may be NULL,
+    //! if the geometry dimension is two.
+    //! \param[out] values Array of \p n reconstructed values
+    //!
+    //! \sa GetValue()
+    //
+    virtual void GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const;
+
     //! Return the extents of the user coordinate system
     //!
     //! This pure virtual method returns min and max extents of
@@ -524,6 +545,63 @@ public:
         GetRange(min3, max3, range);
     }
 
+    //! A run of values that are contiguous in memory
+    //!
+    //! \p data points to the \p n values with indices
+    //! (\p index[0] + i, \p index[1], \p index[2]), for 0 <= i < \p n.
+    //! Missing values are included.
+    //
+    class Span {
+    public:
+        const float *data;
+        size_t       n;
+        Size_tArr3   index;
+    };
+
+    typedef std::function<void(const Span &span)> SpanVisitor;
+
+    //! Visit the values of the grid in spans of contiguous memory
+    //!
+    //! The blocks of the grid are visited in storage order, and each
+    //! block one row of values at a time, so scans and reductions over
+    //! the grid cost one call per row instead of the virtual calls per
+    //! value paid by the ConstIterator.
+    //!
+    //! \param[in] min Minimum index of the region to visit
+    //! \param[in] max Maximum index of the region to visit, inclusive.
+    //! Indices beyond the grid dimensions are clamped.
+    //! \param[in] visitor Function called for each span
+    //! \param[in] part Only visit part \p part of \p nparts. Block \a b of
+    //! \a nb blocks belongs to part floor(\a b * \p nparts / \a nb). Distinct
+    //! parts may be visited concurrently.
+    //! \param[in] nparts Number of parts
+    //!
+    //! For dataless grids nothing is visited.
+    //
+    void ForEachBlock(const Size_tArr3 &min, const Size_tArr3 &max, const SpanVisitor &visitor, size_t part = 0, size_t nparts = 1) const;
+
+    //! Visit all values of the grid in spans of contiguous memory
+    //!
+    //! \sa ForEachBlock(const Size_tArr3 &, const Size_tArr3 &, const SpanVisitor &, size_t, size_t)
+    //
+    void ForEachBlock(const SpanVisitor &visitor, size_t part = 0, size_t nparts = 1) const;
+
+    //! Visit the values of nodes inside or on a box
+    //!
+    //! Only the nodes whose user coordinates lie inside or on the box
+    //! defined by \p minu and \p maxu are visited. Spans are split where
+    //! nodes leave the box. Only the first
+    //! min(minu.size(), maxu.size(), GetGeometryDim()) coordinates are
+    //! tested.
+    //!
+    //! The box is compared with the extents returned by GetUserExtents(),
+    //! which caches them on first use. Call GetUserExtents() once before
+    //! visiting parts of a new grid concurrently.
+    //!
+    //! \sa ForEachBlock(const Size_tArr3 &, const Size_tArr3 &, const SpanVisitor &, size_t, size_t)
+    //
+    void ForEachBlock(const std::vector<double> &minu, const std::vector<double> &maxu, const SpanVisitor &visitor, size_t part = 0, size_t nparts = 1) const;
+
     //! Return true if the specified point lies inside the grid
     //!
     //! This method can be used to determine if a point expressed in
@@ -553,6 +631,20 @@ public:
         return (InsideGrid(c3));
     }
 
+    //! Enable or disable the point locator
+    //!
+    //! Grids whose cells can't be found directly from a point's
+    //! coordinates (e.g. LayeredGrid, CurvilinearGrid) remember, for each
+    //! thread, the cell found by the last point query and start the next
+    //! search there. Queries along a path, such as those made by particle
+    //! advection, then mostly find their cell among its neighbors. The
+    //! locator is enabled by default. Disabling it only affects speed.
+    //!
+    //! \sa GetIndicesCell(), GetValue()
+    //
+    void SetPointLocator(bool enable) { _pointLocator = enable; }
+    bool GetPointLocator() const { return (_pointLocator); }
+
     //! Get the indices of the nodes that define a cell
     //!
     //! This method returns a vector of index vectors. Each index vector
@@ -1167,6 +1259,63 @@ protected:
 
     virtual float *GetValuePtrAtIndex(const std::vector<float *> &blks, const Size_tArr3 &indices) const;
 
+    //! Visit the spans of the nodes inside or on a box
+    //!
+    //! Called by ForEachBlock() when the grid is not entirely inside
+    //! the box. The default implementation tests the user coordinates
+    //! of every node of the grid.
+    //!
+    //! \param[in] ncoords Number of coordinates to test
+    //
+    virtual void ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const;
+
+    //! Visit the spans of the nodes inside or on a box, for a grid
+    //! whose coordinate along each of the first \p ncoords axes varies
+    //! monotonically with the index along that axis only. The nodes
+    //! inside the box then form a range of indices.
+    //
+    void ForEachBlockInSeparableBox(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const;
+
+    //! Call \p visitor with the sub-spans of \p span whose elements
+    //! satisfy \p inside(i), where \p i is the element offset in \p span
+    //
+    template<typename Pred> static void VisitInside(const Span &span, Pred inside, const SpanVisitor &visitor)
+    {
+        size_t i = 0;
+        while (i < span.n) {
+            while (i < span.n && !inside(i)) i++;
+            size_t j = i;
+            while (j < span.n && inside(j)) j++;
+            if (j > i) {
+                Span sub = {span.data + i, j - i, {{span.index[0] + i, span.index[1], span.index[2]}}};
+                visitor(sub);
+            }
+            i = j;
+        }
+    }
+
+    //! Read the values of the eight nodes of the cell whose first node is
+    //! (\p i, \p j, \p k) directly from the blocks, in the order (i,j,k),
+    //! (i+1,j,k), (i,j+1,k), (i+1,j+1,k), followed by the same four nodes
+    //! at k+1. Indices past the last node are clamped, as by AccessIJK().
+    //! The grid must have blocks.
+    //
+    void GetCellNodeValues(size_t i, size_t j, size_t k, float v[8]) const;
+
+    //! Trilinear interpolation of the node values \p v, ordered as by
+    //! GetCellNodeValues(), with weights \p iwgt, \p jwgt and \p kwgt of
+    //! the nodes at i+1, j+1 and k+1. Returns \p missingValue if any node
+    //! with a non-zero weight is missing.
+    //
+    static float TrilinearInterp(const float v[8], double iwgt, double jwgt, double kwgt, float missingValue);
+
+    //! Return the cell recorded by SetCellHint() for this grid by the
+    //! calling thread. Returns false if there is none. A hint may be stale
+    //! and must be validated by the caller.
+    //
+    bool GetCellHint(Size_tArr3 &cell) const;
+    void SetCellHint(const Size_tArr3 &cell) const;
+
     virtual void ClampIndex(const std::vector<size_t> &dims, const Size_tArr3 indices, Size_tArr3 &cIndices) const
     {
         cIndices = {0, 0, 0};
@@ -1210,6 +1359,7 @@ private:
     int                  _interpolationOrder = 0;    // Order of interpolation
     long                 _nodeIDOffset = 0;
     long                 _cellIDOffset = 0;
+    bool                 _pointLocator = true;
     mutable DblArr3      _minuCache = {{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()}};
     mutable DblArr3      _maxuCache = {{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()}};
 
@@ -40,13 +40,24 @@ public:
                                        const std::vector<size_t> &dims, const std::vector<float *> &blkvec, const std::vector<std::vector<size_t>> &bsvec,
                                        const std::vector<std::vector<size_t>> &bminvec, const std::vector<std::vector<size_t>> &bmaxvec);
 
+    // As above, plus connectivity. subset: names the subset of the mesh
+    // held by the blocks, or empty for the whole mesh. Grids of different
+    // subsets don't share cached search trees.
+    //
     UnstructuredGrid *MakeGridUnstructured(string gridType, size_t ts, int level, int lod, const DC::DataVar &var, const std::vector<DC::CoordVar> &cvarsinfo, const std::vector<size_t> &roi_dims,
                                            const std::vector<size_t> &dims, const std::vector<float *> &blkvec, const std::vector<std::vector<size_t>> &bsvec,
                                            const std::vector<std::vector<size_t>> &bminvec, const std::vector<std::vector<size_t>> &bmaxvec, const std::vector<int *> &conn_blkvec,
                                            const std::vector<std::vector<size_t>> &conn_bsvec, const std::vector<std::vector<size_t>> &conn_bminvec,
                                            const std::vector<std::vector<size_t>> &conn_bmaxvec, const std::vector<size_t> &vertexDims, const std::vector<size_t> &faceDims,
                                            const std::vector<size_t> &edgeDims, UnstructuredGrid::Location location, size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset,
-                                           long faceOffset);
+                                           long faceOffset, const string &subset = "");
+
+    // Save the quad trees of curvilinear and unstructured grids in files
+    // whose paths begin with prefix, and read them back instead of
+    // rebuilding them. id identifies the data set, and a tree saved
+    // with a different id is rebuilt. An empty prefix disables saving.
+    //
+    void SetQuadTreeFilePrefix(string prefix, string id);
 
 private:
     template<typename key_t, typename value_t> class lru_cache {
@@ -113,6 +124,8 @@ private:
     };
 
     lru_cache<string, std::shared_ptr<const QuadTreeRectangle<float, size_t>>> _qtrCache;
+    string                                                                     _qtrFilePrefix;
+    string                                                                     _qtrFileID;
 
     RegularGrid *_make_grid_regular(const std::vector<size_t> &dims, const std::vector<float *> &blkvec, const std::vector<size_t> &bs, const std::vector<size_t> &bmin, const std::vector<size_t> &bmax
 
@@ -131,13 +144,13 @@ private:
                                                   const std::vector<float *> &blkvec, const std::vector<size_t> &bs, const std::vector<size_t> &bmin, const std::vector<size_t> &bmax,
                                                   const std::vector<int *> &conn_blkvec, const std::vector<size_t> &conn_bs, const std::vector<size_t> &conn_bmin, const std::vector<size_t> &conn_bmax,
                                                   const std::vector<size_t> &vertexDims, const std::vector<size_t> &faceDims, const std::vector<size_t> &edgeDims, UnstructuredGrid::Location location,
-                                                  size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset);
+                                                  size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset, const string &subset);
 
     UnstructuredGridLayered *_make_grid_unstructured_layered(size_t ts, int level, int lod, const DC::DataVar &var, const vector<DC::CoordVar> &cvarsinfo, const vector<size_t> &dims,
                                                              const vector<float *> &blkvec, const vector<size_t> &bs, const vector<size_t> &bmin, const vector<size_t> &bmax,
                                                              const vector<int *> &conn_blkvec, const vector<size_t> &conn_bs, const vector<size_t> &conn_bmin, const vector<size_t> &conn_bmax,
                                                              const vector<size_t> &vertexDims, const vector<size_t> &faceDims, const vector<size_t> &edgeDims, UnstructuredGrid::Location location,
-                                                             size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset);
+                                                             size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset, const string &subset);
 
     void _makeGridHelper(const DC::DataVar &var, const std::vector<size_t> &roi_dims, const std::vector<size_t> &dims, Grid *g) const;
 
@@ -153,7 +166,14 @@ private:
 
     bool _isCurvilinear(const DC::Mesh &m, const std::vector<DC::CoordVar> &cvarsinfo, const std::vector<std::vector<string>> &cdimnames) const;
 
-    string _getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const vector<size_t> &bmin, const vector<size_t> &bmax) const;
+    string _getQuadTreeRectangleFile(const string &key) const;
+
+    std::shared_ptr<const QuadTreeRectangle<float, size_t>> _getQuadTreeRectangle(const string &key);
+
+    void _putQuadTreeRectangle(const string &key, std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr);
+
+    string _getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const vector<size_t> &bmin, const vector<size_t> &bmax,
+                                    const string &subset = "") const;
 };
 
 };    // namespace VAPoR
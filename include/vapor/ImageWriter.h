@@ -15,6 +15,19 @@ public:
     virtual int Write(const unsigned char *buffer, const unsigned int width, const unsigned int height) = 0;
     virtual ~ImageWriter(){};
 
+    //! Return true if Write() may be called on a thread other than the
+    //! one that created the writer, concurrently with other writers
+    //
+    virtual bool IsThreadSafe() const { return (true); }
+
+    //! Return the reason the last call to Write() failed
+    //!
+    //! Writers record their errors here rather than with SetErrMsg(),
+    //! whose message buffer is shared by every thread, so that writers
+    //! running concurrently can each report their own failure.
+    //
+    const std::string &GetWriteError() const { return (writeError); }
+
     static ImageWriter *CreateImageWriterForFile(const std::string &path);
     static void         RegisterFactory(ImageWriterFactory *factory);
 
@@ -22,9 +35,14 @@ protected:
     Format      format;
     std::string path;
     bool        opened;
+    std::string writeError;
 
     ImageWriter(const std::string &path);
 
+    //! Record the reason Write() failed, printf style
+    //
+    void SetWriteError(const char *format, ...);
+
 private:
     static std::vector<ImageWriterFactory *> factories;
 };
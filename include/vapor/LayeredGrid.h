@@ -1,5 +1,6 @@
 #ifndef _LayeredGrid_
 #define _LayeredGrid_
+#include <mutex>
 #include <vapor/common.h>
 #include "RegularGrid.h"
 #include "StretchedGrid.h"
@@ -60,6 +61,10 @@ public:
     //!
     float GetValue(const DblArr3 &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const override;
+
     //! \copydoc Grid::GetInterpolationOrder()
     //
     virtual int GetInterpolationOrder() const override { return _interpolationOrder; };
@@ -161,14 +166,26 @@ protected:
     //!
     virtual void GetUserExtentsHelper(DblArr3 &minu, DblArr3 &maxu) const override;
 
+    //! \copydoc Grid::ForEachBlockInBoxHelper()
+    //!
+    //! The horizontal extents of the box are found from the horizontal
+    //! coordinates alone. Only the vertical coordinates of nodes inside
+    //! the horizontal extents are tested.
+    //
+    virtual void ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const override;
+
 private:
-    StretchedGrid       _sg2d;    // horizontal coordinates maintained in stretched grid
-    RegularGrid         _zrg;     // vertical coords are the values of a regular grid
-    std::vector<double> _xcoords;
-    std::vector<double> _ycoords;
-    DblArr3             _minu = {{0.0, 0.0, 0.0}};
-    DblArr3             _maxu = {{0.0, 0.0, 0.0}};
-    int                 _interpolationOrder;
+    StretchedGrid              _sg2d;    // horizontal coordinates maintained in stretched grid
+    RegularGrid                _zrg;     // vertical coords are the values of a regular grid
+    std::vector<double>        _xcoords;
+    std::vector<double>        _ycoords;
+    DblArr3                    _minu = {{0.0, 0.0, 0.0}};
+    DblArr3                    _maxu = {{0.0, 0.0, 0.0}};
+    int                        _interpolationOrder;
+    mutable std::vector<float> _columnBounds;    // Z range of each column of cells, built on first use
+    mutable std::once_flag     _columnBoundsOnce;
+
+    const std::vector<float> &_getColumnBounds() const;
 
     virtual float GetValueNearestNeighbor(const DblArr3 &coords) const override;
 
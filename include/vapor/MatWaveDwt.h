@@ -194,7 +194,35 @@ public:
     int idwt3d(const long *cLLL, const long *cLLH, const long *cLHL, const long *cLHH, const long *cHLL, const long *cHLH, const long *cHHL, const long *cHHH, const size_t L[27], long *sigOut);
     int idwt3d(const int *cLLL, const int *cLLH, const int *cLHL, const int *cLHH, const int *cHLL, const int *cHLH, const int *cHHL, const int *cHHH, const size_t L[27], int *sigOut);
 
+    //! Set or get the lifting flag
+    //!
+    //! When set, transforms with the CDF 5/3 ("bior2.2") and CDF 9/7
+    //! ("bior4.4") wavelets and the "symw" boundary extension mode are
+    //! computed with a lifting scheme instead of by convolution. Float
+    //! data are then transformed in single precision. Columns of 2D and
+    //! 3D signals are transformed several at a time with vector
+    //! instructions, without transposing the signal. The coefficients
+    //! equal those of the convolution up to rounding. By default the
+    //! flag is set.
+    //!
+    //! \retval flag A reference to the lifting flag
+    //!
+    //! \sa LiftingKernels()
+    //
+    bool &LiftingOnOff() { return (_lifting); };
+
+    //! Return the instruction set used by the lifting scheme
+    //!
+    //! The instruction set is chosen at run time from those supported by
+    //! the processor.
+    //!
+    //! \retval name One of "avx2", "sse2", or "scalar"
+    //
+    static string LiftingKernels();
+
 private:
+    bool _lifting;
+
     // 1D buffers
     Wasp::SmartBuf _dwt1dSmartBuf;
 
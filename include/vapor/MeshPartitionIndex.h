@@ -0,0 +1,127 @@
+#ifndef _MeshPartitionIndex_h_
+#define _MeshPartitionIndex_h_
+
+#include <string>
+#include <vector>
+#include <vapor/MyBase.h>
+
+namespace VAPoR {
+
+//
+//! \class MeshPartitionIndex
+//! \brief A spatial index over the nodes of a 2D unstructured mesh
+//!
+//! The nodes of the mesh are sorted along a Hilbert curve through their
+//! horizontal coordinates and the sorted list is cut into partitions of
+//! a fixed number of nodes. Each partition records the bounding box of
+//! the faces that share its nodes, so a face that intersects a box
+//! always has all of its nodes in partitions returned by Query() for
+//! that box.
+//!
+//! The index depends only on the mesh, and may be saved with Write()
+//! and restored with Read() so that the mesh coordinates need not be
+//! read again.
+//
+class VDF_API MeshPartitionIndex : public Wasp::MyBase {
+public:
+    MeshPartitionIndex();
+
+    //! Build the index
+    //!
+    //! \param[in] nNodes Number of nodes in the mesh
+    //! \param[in] x X coordinates of the \p nNodes nodes
+    //! \param[in] y Y coordinates of the \p nNodes nodes
+    //! \param[in] nFaces Number of faces in the mesh
+    //! \param[in] vertexOnFace The \p maxVertexPerFace nodes of each
+    //! face, as passed to UnstructuredGrid
+    //! \param[in] maxVertexPerFace Maximum number of nodes of a face
+    //! \param[in] vertexOffset Offset added to the values of
+    //! \p vertexOnFace to give node indices
+    //! \param[in] partitionSize Number of nodes per partition
+    //!
+    //! \retval status A negative int is returned if the mesh is empty
+    //
+    int Build(size_t nNodes, const float *x, const float *y, size_t nFaces, const int *vertexOnFace, size_t maxVertexPerFace, long vertexOffset, size_t partitionSize = 4096);
+
+    //! Save the index to a file
+    //!
+    //! The file is written to a temporary file that is renamed into
+    //! place, so concurrent readers never see a partial index.
+    //!
+    //! \param[in] path Path of the index file
+    //! \param[in] key Caller defined value stored with the index, used
+    //! to detect a stale index file. See Read().
+    //!
+    //! \retval status A negative int is returned if the file can't be
+    //! written. No error message is set.
+    //
+    int Write(std::string path, const std::string &key) const;
+
+    //! Restore an index saved with Write()
+    //!
+    //! \param[in] path Path of the index file
+    //! \param[in] key Must match the value passed to Write()
+    //! \param[in] nNodes Number of nodes the index must have
+    //!
+    //! \retval status A negative int is returned if the file is
+    //! missing, unreadable, or doesn't match \p key or \p nNodes. No
+    //! error message is set, as the caller is expected to build the
+    //! index instead.
+    //
+    int Read(std::string path, const std::string &key, size_t nNodes);
+
+    //! Return the number of nodes indexed
+    //
+    size_t GetNumNodes() const { return (_order.size()); }
+
+    //! Return the number of partitions
+    //
+    size_t GetNumPartitions() const { return (_bounds.size() / 4); }
+
+    //! Return the bounding box of the mesh
+    //
+    void GetExtents(std::vector<double> &min, std::vector<double> &max) const;
+
+    //! Find the partitions that intersect a box
+    //!
+    //! \param[in] min Minimum X and Y of the box
+    //! \param[in] max Maximum X and Y of the box
+    //! \param[out] partitions Sorted indices of the partitions whose
+    //! bounding boxes intersect the box
+    //
+    void Query(const std::vector<double> &min, const std::vector<double> &max, std::vector<size_t> &partitions) const;
+
+    //! Return the nodes of a list of partitions
+    //!
+    //! \param[in] partitions Partition indices, as returned by Query()
+    //! \param[out] nodes Sorted indices of the nodes of \p partitions
+    //
+    void GetNodes(const std::vector<size_t> &partitions, std::vector<size_t> &nodes) const;
+
+    //! Map connectivity of a mesh onto a subset of its elements
+    //!
+    //! Rewrites each value of \p ids, which refers to an element of the
+    //! full mesh, as the position of that element in \p subset. Values
+    //! that refer to an element not in \p subset become the boundary
+    //! ID (-2). Missing (-1) and boundary values are preserved. The
+    //! results have an offset of zero.
+    //!
+    //! \param[in,out] ids Connectivity values
+    //! \param[in] n Number of values in \p ids
+    //! \param[in] offset Offset added to the values of \p ids to give
+    //! element indices
+    //! \param[in] subset Sorted indices of the elements kept
+    //
+    static void Remap(int *ids, size_t n, long offset, const std::vector<size_t> &subset);
+
+private:
+    size_t              _partitionSize;
+    std::vector<int>    _order;     // node indices, in Hilbert curve order
+    std::vector<float>  _bounds;    // xmin, ymin, xmax, ymax of each partition
+    std::vector<double> _min;
+    std::vector<double> _max;
+};
+
+};    // namespace VAPoR
+
+#endif
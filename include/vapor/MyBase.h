@@ -170,12 +170,24 @@ public:
     //! the stored error message. This method differs from SetErrMsg() only
     //! in that no associated error code is set - the message is considered
     //! diagnostic only, not an error.
+    //!
+    //! The message is only formatted if it has somewhere to go: a callback,
+    //! a file pointer, or a Trace enabled at the Trace::Debug level.
+    //! Otherwise the call returns at once, and GetDiagMsg() is unchanged.
     //! \param[in] format A 'C' style sprintf format string.
     //! \param[in] arg... Arguments to format
     //! \sa GetDiagMsg()
     //
     static void SetDiagMsg(const char *format, ...);
 
+    //! Return true if diagnostic messages are formatted
+    //!
+    //! Callers whose arguments to SetDiagMsg() are costly to compute
+    //! can check this first.
+    //! \sa SetDiagMsg()
+    //
+    static bool DiagMsgEnabled();
+
     //! Retrieve the current diagnostic message
     //!
     //! Retrieves the last error message set with \b SetDiagMsg(). It is the
@@ -244,6 +256,19 @@ public:
 
     static bool GetEnableErrMsg() { return Enabled; }
 
+    //!
+    //! Enable or disable error message reporting for the calling thread
+    //!
+    //! Like EnableErrMsg(), but only affects calls to SetErrMsg() made
+    //! by the calling thread, so a worker thread may silence its own
+    //! errors without racing with other threads that save and restore
+    //! the process wide setting.
+    //!
+    //! \param[in] enable Boolean flag to enable or disable error reporting
+    //! \retval prev The previous setting for the calling thread
+    //!
+    static bool EnableThreadErrMsg(bool enable);
+
     // N.B. the error codes/messages are stored in static class members!!!
     static char *     ErrMsg;
     static int        ErrCode;
@@ -125,6 +125,72 @@ public:
     //!
     virtual int Initialize(const std::vector<string> &files, const std::vector<string> &time_dimnames, const std::vector<string> &time_coordvar);
 
+    //! Enable a persistent metadata index
+    //!
+    //! When enabled, Initialize() saves the dimensions, attributes,
+    //! variable definitions, time coordinates, and text variables (See
+    //! SetTextVars()) of each file to an index file stored in \p dir,
+    //! and on subsequent calls restores them from the index instead of
+    //! opening the files. Index entries
+    //! are keyed by file path, size, and modification time, and an
+    //! entry is rebuilt automatically when any of these change. Files
+    //! whose metadata are restored from the index are not opened until
+    //! their data are read.
+    //!
+    //! \param[in] dir Directory for the index file. An empty string
+    //! disables the index, which is the default.
+    //!
+    //! \sa IndexDirFromOptions()
+    //
+    void SetIndexDir(string dir) { _indexDir = dir; }
+
+    //! Return the directory set with SetIndexDir()
+    //
+    string GetIndexDir() const { return (_indexDir); }
+
+    //! Gather the text of character variables with the file metadata
+    //!
+    //! The records of each character variable named in \p varnames, such
+    //! as WRF's "Times", are read by Initialize() together with the other
+    //! metadata of each file, and saved in the metadata index if one is
+    //! enabled. ReadText() then returns them without opening the files.
+    //! Must be called before Initialize().
+    //!
+    //! \param[in] varnames Names of 1D, possibly time varying, character
+    //! variables
+    //!
+    //! \sa SetIndexDir(), ReadText()
+    //
+    void SetTextVars(const std::vector<string> &varnames) { _textVars = varnames; }
+
+    //! Read the text of a character variable at a time step
+    //!
+    //! Text gathered by Initialize() for variables named with
+    //! SetTextVars() is returned from memory. Other variables are read
+    //! from their file. Trailing null characters are removed.
+    //!
+    //! \param[in] ts time step of variable
+    //! \param[in] varname Name of a 1D, possibly time varying, character
+    //! variable
+    //! \param[out] text The text of \p varname at time step \p ts
+    //!
+    //! \retval retval A negative int is returned on failure.
+    //!
+    //! \sa SetTextVars()
+    //
+    int ReadText(size_t ts, string varname, string &text);
+
+    //! Return the index directory requested in a list of options
+    //!
+    //! Returns the value following the "-index_dir" option in
+    //! \p options, if present. Otherwise returns the value of the
+    //! VAPOR_NETCDF_INDEX_DIR environment variable, which is empty
+    //! if the variable is not set.
+    //!
+    //! \sa SetIndexDir(), DC::Initialize()
+    //
+    static string IndexDirFromOptions(const std::vector<string> &options);
+
     //! Return a boolean indicating whether a variable exists in the
     //! data collection.
     //!
@@ -786,6 +852,18 @@ private:
     std::vector<string>              _failedVars;    // Varibles that could not be added
     std::map<string, DerivedVar *>   _derivedVarsMap;
     DerivedVar *                     _derivedVar;    // if current opened variable is derived this is it
+    string                           _indexDir;      // metadata index directory, if any
+
+    // Values of time coordinate variables, keyed by file and then by
+    // variable name
+    //
+    std::map<string, std::map<string, std::vector<double>>> _tcvValues;
+
+    // Records of the character variables named with SetTextVars(), keyed
+    // by file and then by variable name
+    //
+    std::vector<string>                                     _textVars;
+    std::map<string, std::map<string, std::vector<string>>> _textValues;
 
     //
     // file handle for an open variable
@@ -814,6 +892,8 @@ private:
 
     void ReInitialize();
 
+    int _OpenFiles(const std::vector<string> &files, const std::vector<string> &time_coordvars);
+
     int _InitializeTimesMap(const std::vector<string> &files, const std::vector<string> &time_dimnames, const std::vector<string> &time_coordvars, std::map<string, std::vector<double>> &timesMap,
                             std::vector<double> &times, int &file_org) const;
 
@@ -832,6 +912,8 @@ private:
 
     float *_Get1DVar(NetCDFSimple *netcdf, const NetCDFSimple::Variable &variable) const;
 
+    int _GetTextVar(NetCDFSimple *netcdf, const NetCDFSimple::Variable &variable, std::vector<string> &records) const;
+
     int _get_var_index(const vector<NetCDFSimple::Variable> variables, string varname) const;
 
     template<typename T> int _read_template(T *data, int fd);
@@ -119,6 +119,8 @@ public:
         }
 
     private:
+        friend class NetCDFSimple;
+
         string                                              _name;        // variable name
         std::vector<string>                                 _dimnames;    // order list of dimension names
         std::vector<std::pair<string, std::vector<double>>> _flt_atts;
@@ -138,6 +140,38 @@ public:
     //!
     int Initialize(string path);
 
+    //! Write the file's metadata to a stream
+    //!
+    //! Serialize the dimensions, attributes, and variable definitions
+    //! gathered by Initialize() in a compact, machine specific binary
+    //! form that may be restored with ReadMetadata().
+    //!
+    //! \param[out] o Output stream
+    //!
+    //! \retval status A negative int is returned on failure
+    //!
+    //! \sa ReadMetadata()
+    //!
+    int WriteMetadata(std::ostream &o) const;
+
+    //! Initialize the class instance from previously saved metadata
+    //!
+    //! This method is an alternative to Initialize() that restores the
+    //! metadata written by WriteMetadata() instead of reading it from
+    //! the netCDF file. The file named by \p path is not opened until
+    //! OpenRead() is called.
+    //!
+    //! \param[in] i Input stream positioned at the start of data
+    //! written by WriteMetadata()
+    //! \param[in] path Path to the netCDF file described by the metadata
+    //!
+    //! \retval status A negative int is returned if the metadata are
+    //! truncated or malformed
+    //!
+    //! \sa WriteMetadata()
+    //!
+    int ReadMetadata(std::istream &i, string path);
+
     //! Open the named variable for reading
     //!
     //! This method prepares a netCDF variable
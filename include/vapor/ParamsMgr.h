@@ -26,6 +26,7 @@
 #include <stack>
 #include <utility>
 #include <functional>
+#include <memory>
 
 #include <vapor/DataMgr.h>
 #include <vapor/ParamsBase.h>
@@ -531,6 +532,10 @@ public:
     }
 
 private:
+    // Undo and redo stacks of snapshots of the tree. Snapshots share the
+    // subtrees that did not change between them, so that saving a state
+    // costs in proportion to the change rather than to the tree.
+    //
     class PMgrStateSave : public ParamsBase::StateSave {
     public:
         PMgrStateSave(int stackSize = 100);
@@ -539,14 +544,11 @@ private:
         void Reinit(const XmlNode *rootNode)
         {
             _rootNode = rootNode;
+            _snapshotter.Clear();
             emitStateChange();
         }
 
-        void Rebase()
-        {
-            if (_state0) delete _state0;
-            _state0 = _rootNode ? new XmlNode(*_rootNode) : NULL;
-        }
+        void Rebase() { _state0 = _rootNode ? _snapshotter.Take(_rootNode, _state0) : XmlSnapshotter::Snapshot(); }
         void Save(const XmlNode *node, string description);
         void BeginGroup(string descripion);
         void EndGroup();
@@ -569,7 +571,10 @@ private:
 
         const XmlNode *GetTopUndo(string &description) const;
         const XmlNode *GetTopRedo(string &description) const;
-        const XmlNode *GetBase() const { return (_state0); }
+        const XmlNode *GetBase() const { return (materialize(_state0)); }
+
+        string GetTopUndoDesc() const { return (_undoStack.empty() ? string() : _undoStack.back().first); }
+        string GetTopRedoDesc() const { return (_redoStack.empty() ? string() : _redoStack.back().first); }
 
         bool Undo();
         bool Redo();
@@ -587,18 +592,26 @@ private:
         bool           _enabled;
         bool           _addToUndoEnabled = true;
         int            _stackSize;
-        const XmlNode *_rootNode;
-        const XmlNode *_state0;
+        const XmlNode *          _rootNode;
+        XmlSnapshotter           _snapshotter;
+        XmlSnapshotter::Snapshot _state0;
+
+        std::stack<string>                                       _groups;
+        std::deque<std::pair<string, XmlSnapshotter::Snapshot>> _undoStack;
+        std::deque<std::pair<string, XmlSnapshotter::Snapshot>> _redoStack;
 
-        std::stack<string>                       _groups;
-        std::deque<std::pair<string, XmlNode *>> _undoStack;
-        std::deque<std::pair<string, XmlNode *>> _redoStack;
+        // The tree last returned by materialize(), and its snapshot
+        //
+        mutable XmlSnapshotter::Snapshot _materialized;
+        mutable std::unique_ptr<XmlNode> _materializedTree;
 
         std::vector<bool *>                _stateChangeFlags;
         std::vector<std::function<void()>> _stateChangeCBs;
         std::vector<std::function<void()>> _intermediateStateChangeCBs;
 
-        void cleanStack(int maxN, std::deque<std::pair<string, XmlNode *>> &s);
+        void                     cleanStack(int maxN, std::deque<std::pair<string, XmlSnapshotter::Snapshot>> &s);
+        XmlSnapshotter::Snapshot takeSnapshot();
+        const XmlNode *          materialize(const XmlSnapshotter::Snapshot &snapshot) const;
         void emitStateChange();
         void emitIntermediateStateChange();
     };
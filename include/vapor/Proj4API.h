@@ -66,6 +66,25 @@ public:
     int Transform(float *x, float *y, size_t n, int offset = 1) const;
     int Transform(float *x, float *y, float *z, size_t n, int offset = 1) const;
 
+    //! Transform coordinates using several threads
+    //!
+    //! This method is identical to Transform() except that the
+    //! coordinates are split into contiguous chunks that are transformed
+    //! concurrently, each with its own proj4 context. Small arrays are
+    //! transformed by the calling thread.
+    //!
+    //! \param[in,out] x array of longitudes or PCS X values
+    //! \param[in,out] y array of latitudes or PCS Y values
+    //! \param[in] n num elements in x and y
+    //! \param[in] nthreads Number of threads. If less than one, the
+    //! number of hardware threads is used.
+    //!
+    //! \retval status Retruns a negative int on failure
+    //!
+    //! \sa Transform()
+    //
+    int TransformParallel(float *x, float *y, size_t n, int nthreads = 0) const;
+
     //! Return true of source projection definition is lat-long
     //!
     //! This method returns true iff the source projection definition
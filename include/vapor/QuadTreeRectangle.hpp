@@ -2,7 +2,25 @@
 
 #include <vector>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <cstdio>
+#include <cstring>
 #include <cstdint>
+#ifdef WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
 #include <vapor/VAssert.h>
 
 namespace VAPoR {
@@ -12,6 +30,9 @@ namespace VAPoR {
 //! \brief This class implements a 2D quad tree space partitioning tree
 //! that operates on rectangular regions.
 //!
+//! The nodes and their payloads are stored in flat arrays, so that a
+//! tree may be saved with Write() and memory mapped by Read(). \p S
+//! must be trivially copyable to save a tree.
 //
 template<typename T, typename S> class QuadTreeRectangle {
 public:
@@ -38,9 +59,12 @@ public:
         VAssert(left <= right);
         VAssert(top <= bottom);
         _nodes.reserve(reserve_size);
-        _nodes.push_back(new node_t(left, top, right, bottom));
+        _nodes.push_back(node_t(left, top, right, bottom));
         _rootidx = 0;
         _maxDepth = max_depth;
+        _mappedNodes = nullptr;
+        _mappedPayloads = nullptr;
+        _nMappedNodes = 0;
     }
 
     //! Construct a QuadTreeRectangle instance for a unit 2D region
@@ -51,40 +75,12 @@ public:
     QuadTreeRectangle(size_t max_depth = 12, size_t reserve_size = 1000)
     {
         _nodes.reserve(reserve_size);
-        _nodes.push_back(new node_t(0.0, 0.0, 1.0, 1.0));
+        _nodes.push_back(node_t(0.0, 0.0, 1.0, 1.0));
         _rootidx = 0;
         _maxDepth = max_depth;
-    }
-
-    QuadTreeRectangle(const QuadTreeRectangle &rhs)
-    {
-        _nodes.resize(rhs._nodes.size());
-        for (size_t i = 0; i < rhs._nodes.size(); i++) { _nodes[i] = new node_t(*(rhs._nodes[i])); }
-        _rootidx = rhs._rootidx;
-        _maxDepth = rhs._maxDepth;
-    }
-
-    QuadTreeRectangle &operator=(const QuadTreeRectangle &rhs)
-    {
-        if (*this == rhs) return *this;
-
-        for (size_t i = 0; i < _nodes.size(); i++) {
-            if (_nodes[i]) delete _nodes[i];
-        }
-
-        _nodes.resize(rhs._nodes.size());
-        for (size_t i = 0; i < rhs._nodes.size(); i++) { _nodes[i] = new node_t(*(rhs._nodes[i])); }
-        _rootidx = rhs._rootidx;
-        _maxDepth = rhs._maxDepth;
-        return *this;
-    }
-
-    ~QuadTreeRectangle()
-    {
-        for (size_t i = 0; i < _nodes.size(); i++) {
-            if (_nodes[i]) delete _nodes[i];
-        }
-        _nodes.clear();
+        _mappedNodes = nullptr;
+        _mappedPayloads = nullptr;
+        _nMappedNodes = 0;
     }
 
     //! Insert an element into the tree
@@ -106,10 +102,46 @@ public:
     //
     bool Insert(T left, T top, T right, T bottom, S payload)
     {
-        node_t *root = _nodes[_rootidx];
-        if (!root->intersects(rectangle_t(left, top, right, bottom))) return (false);
+        _unmap();
+
+        rectangle_t rec(left, top, right, bottom);
+        if (!_nodes[_rootidx].intersects(rec)) return (false);
 
-        return (root->insert(_nodes, rectangle_t(left, top, right, bottom), payload, _maxDepth));
+        return (_insert(_rootidx, rec, payload));
+    }
+
+    //! Insert many elements into the tree
+    //!
+    //! The resulting tree is the same as if Insert() were called for each
+    //! element in turn, but if the tree is empty it is built top down,
+    //! with the subtrees below the first few levels built concurrently.
+    //!
+    //! \param[in] rects The left, top, right, and bottom bounds of each
+    //! element, four values per element
+    //! \param[in] payloads The payload of each element
+    //! \param[in] nthreads Number of threads used. If zero the number of
+    //! hardware threads is used.
+    //!
+    //! \retval count The number of elements that overlap the tree, and
+    //! were inserted
+    //
+    size_t Insert(const std::vector<T> &rects, const std::vector<S> &payloads, int nthreads = 0)
+    {
+        VAssert(rects.size() == 4 * payloads.size());
+
+        _unmap();
+
+        size_t count = 0;
+        if (_nodes.size() > 1 || _nodes[_rootidx]._npayloads) {
+            for (size_t i = 0; i < payloads.size(); i++) {
+                if (Insert(rects[4 * i], rects[4 * i + 1], rects[4 * i + 2], rects[4 * i + 3], payloads[i])) count++;
+            }
+            return (count);
+        }
+
+        if (nthreads < 1) nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+        return (_bulkInsert(rects, payloads, nthreads));
     }
 
     //! Return a list of payloads that intersect a specified point
@@ -127,8 +159,7 @@ public:
     {
         payloads.clear();
 
-        const node_t *root = _nodes[_rootidx];
-        root->get_payload_contains(_nodes, x, y, payloads);
+        _getPayloadContains(_rootidx, x, y, payloads);
     }
 
     //! Return informational statistics about the current tree
@@ -148,22 +179,146 @@ public:
         payload_histo.clear();
         level_histo.clear();
 
-        for (size_t i = 0; i < _nodes.size(); i++) {
-            size_t b = _nodes[i]->get_payloads().size();
+        const node_t *nodes = _nodeData();
+        for (size_t i = 0; i < _numNodes(); i++) {
+            size_t b = nodes[i]._npayloads;
             if (b >= payload_histo.size()) { payload_histo.resize(b + 1, 0); }
             payload_histo[b] += 1;
 
-            b = _nodes[i]->get_level();
+            b = nodes[i]._level;
             if (b >= level_histo.size()) { level_histo.resize(b + 1, 0); }
             level_histo[b] += 1;
         }
     }
 
+    //! Save the tree to a file
+    //!
+    //! The file is written to a temporary file that is renamed into
+    //! place, so concurrent readers never see a partial tree. The file
+    //! is only meaningful on machines with the same byte order.
+    //!
+    //! \param[in] path Path of the file
+    //! \param[in] key Caller defined value stored with the tree, used
+    //! to detect a stale file. See Read().
+    //!
+    //! \retval status A negative int is returned if the file can't be
+    //! written
+    //
+    int Write(std::string path, const std::string &key) const
+    {
+        static_assert(std::is_trivially_copyable<S>::value, "payload type can't be saved");
+
+        // Payloads are written in node order, without the spare
+        // capacity left by Insert()
+        //
+        const node_t *      nodes = _nodeData();
+        const S *           payloads = _payloadData();
+        std::vector<node_t> out(nodes, nodes + _numNodes());
+        std::vector<S>      outPayloads;
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i]._payload0 = outPayloads.size();
+            out[i]._capacity = out[i]._npayloads;
+            outPayloads.insert(outPayloads.end(), payloads + nodes[i]._payload0, payloads + nodes[i]._payload0 + nodes[i]._npayloads);
+        }
+
+        header_t h;
+        _initHeader(h, key);
+        h.nnodes = out.size();
+        h.npayloads = outPayloads.size();
+        h.rootidx = _rootidx;
+        h.maxDepth = _maxDepth;
+
+        std::ostringstream tmp;
+#ifdef WIN32
+        tmp << path << "." << _getpid() << ".tmp";
+#else
+        tmp << path << "." << getpid() << ".tmp";
+#endif
+
+        {
+            std::ofstream f(tmp.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!f) return (-1);
+
+            f.write((const char *)&h, sizeof(h));
+            f.write(key.data(), key.size());
+            _pad(f, key.size());
+            f.write((const char *)out.data(), out.size() * sizeof(node_t));
+            f.write((const char *)outPayloads.data(), outPayloads.size() * sizeof(S));
+            f.close();
+            if (!f) {
+                (void)remove(tmp.str().c_str());
+                return (-1);
+            }
+        }
+
+#ifdef WIN32
+        (void)remove(path.c_str());
+#endif
+        if (rename(tmp.str().c_str(), path.c_str()) != 0) {
+            (void)remove(tmp.str().c_str());
+            return (-1);
+        }
+        return (0);
+    }
+
+    //! Restore a tree saved with Write()
+    //!
+    //! The file is memory mapped, and its pages are shared by all trees
+    //! read from it and by their copies. A tree that was read may still
+    //! be inserted into, at the cost of a copy of the mapped data.
+    //!
+    //! \param[in] path Path of the file
+    //! \param[in] key Must match the value passed to Write()
+    //!
+    //! \retval status A negative int is returned if the file is
+    //! missing, unreadable, or doesn't match \p key, in which case the
+    //! tree is unchanged
+    //
+    int Read(std::string path, const std::string &key)
+    {
+        static_assert(std::is_trivially_copyable<S>::value, "payload type can't be saved");
+
+        header_t expected;
+        _initHeader(expected, key);
+
+        std::shared_ptr<const char> mapping;
+        size_t                      size = 0;
+        if (_mapFile(path, mapping, size) < 0) return (-1);
+
+        const char *ptr = mapping.get();
+        if (size < sizeof(header_t)) return (-1);
+
+        header_t h;
+        memcpy(&h, ptr, sizeof(h));
+        if (h.magic != expected.magic || h.version != expected.version || h.sizeofT != expected.sizeofT || h.sizeofS != expected.sizeofS || h.sizeofNode != expected.sizeofNode) return (-1);
+        if (h.keylen != key.size() || h.nnodes < 1 || h.rootidx >= h.nnodes) return (-1);
+
+        size_t offset = sizeof(header_t) + _padded(key.size());
+        size_t payloadOffset = offset + h.nnodes * sizeof(node_t);
+        if (size < payloadOffset + h.npayloads * sizeof(S)) return (-1);
+        if (key.compare(0, key.size(), ptr + sizeof(header_t), key.size()) != 0) return (-1);
+
+        const node_t *nodes = (const node_t *)(ptr + offset);
+        for (size_t i = 0; i < h.nnodes; i++) {
+            if (nodes[i]._payload0 + nodes[i]._npayloads > h.npayloads) return (-1);
+            if (!nodes[i]._is_leaf && nodes[i]._child0 + 4 > h.nnodes) return (-1);
+        }
+
+        _nodes.clear();
+        _payloads.clear();
+        _mapping = mapping;
+        _mappedNodes = nodes;
+        _mappedPayloads = (const S *)(ptr + payloadOffset);
+        _nMappedNodes = h.nnodes;
+        _rootidx = h.rootidx;
+        _maxDepth = h.maxDepth;
+        return (0);
+    }
+
     friend std::ostream &operator<<(std::ostream &os, const QuadTreeRectangle &q)
     {
-        os << "Num nodes : " << q._nodes.size() << std::endl;
-        const node_t *root = q._nodes[q._rootidx];
-        root->print(q._nodes, os);
+        os << "Num nodes : " << q._numNodes() << std::endl;
+        q._print(q._rootidx, os);
         return (os);
     }
 
@@ -211,6 +366,20 @@ private:
             return *this;    // Can't happen since we mask n
         }
 
+        // return a mask of the quadrants, numbered as by quadrant(), that
+        // other intersects, given that it intersects us
+        //
+        uint32_t quadrants(rectangle_t const &other) const
+        {
+            T const center_x((_left + _right) / 2);
+            T const center_y((_top + _bottom) / 2);
+            bool    left = other._left <= center_x;
+            bool    right = other._right >= center_x;
+            bool    top = other._top <= center_y;
+            bool    bottom = other._bottom >= center_y;
+            return ((left && top) | (right && top) << 1 | (left && bottom) << 2 | (right && bottom) << 3);
+        }
+
         friend std::ostream &operator<<(std::ostream &os, const rectangle_t &rec)
         {
             os << "left-top, right-bottom : "
@@ -223,129 +392,380 @@ private:
         T _left, _top, _right, _bottom;
     };
 
+    // A node's payloads are _npayloads consecutive elements of the
+    // payload array, starting at _payload0. Its children, if any, are
+    // four consecutive nodes starting at _child0. Nodes are written to
+    // disk as is, so all members have fixed sizes.
+    //
     class node_t {
     public:
-        node_t(int level = 0) : _level(level), _is_leaf(true), _child0(0), _rectangle(0.0, 0.0, 1.0, 1.0) {}
-
-        node_t(T left, T top, T right, T bottom, int level = 0) : _level(level), _is_leaf(true), _child0(0), _rectangle(left, top, right, bottom) {}
+        node_t(const rectangle_t &rec, int level = 0) : _rectangle(rec), _level(level), _is_leaf(1), _child0(0), _payload0(0), _npayloads(0), _capacity(0) {}
 
-        node_t(const rectangle_t &rec, int level = 0) : _level(level), _is_leaf(true), _child0(0), _rectangle(rec) {}
-
-        rectangle_t &      bounds() { return (_rectangle); }
-        rectangle_t const &bounds() const { return (_rectangle); }
+        node_t(T left, T top, T right, T bottom, int level = 0) : node_t(rectangle_t(left, top, right, bottom), level) {}
 
         bool intersects(rectangle_t const &other) const { return (_rectangle.intersects(other)); }
-        bool contains(rectangle_t const &other) const { return (_rectangle.contains(other)); }
         bool contains(T x, T y) const { return (_rectangle.contains(x, y)); }
-        bool touches(rectangle_t const &other) const { return (_rectangle.touches(other)); }
 
-        void subdivide(std::vector<node_t *> &nodes)
-        {
-            if (!_is_leaf) return;
-
-            _is_leaf = false;
-            _child0 = nodes.size();
-            nodes.push_back(new node_t(_rectangle.quadrant(0), _level + 1));
-            nodes.push_back(new node_t(_rectangle.quadrant(1), _level + 1));
-            nodes.push_back(new node_t(_rectangle.quadrant(2), _level + 1));
-            nodes.push_back(new node_t(_rectangle.quadrant(3), _level + 1));
-        }
+        // if rec is larger than a quadrant (half the width and height of this
+        // node) there is no point in refining. I.e. stop descending the
+        // tree and store the payload here.
+        //
+        bool stores(rectangle_t const &rec, size_t maxDepth) const { return (_rectangle.width() < rec.width() || _rectangle.height() < rec.height() || _level >= maxDepth); }
+
+        rectangle_t _rectangle;
+        int32_t     _level;
+        int32_t     _is_leaf;
+        uint64_t    _child0;
+        uint64_t    _payload0;
+        uint64_t    _npayloads;
+        uint64_t    _capacity;    // payload slots reserved for the node
+    };
 
-        const node_t *quadrant(const std::vector<node_t *> &nodes, uint32_t n) const
-        {
-            switch (n & 0x03) {
-            case 0: return nodes[_child0 + 0];
-            case 1: return nodes[_child0 + 1];
-            case 2: return nodes[_child0 + 2];
-            case 3: return nodes[_child0 + 3];
+    class header_t {
+    public:
+        uint64_t magic;
+        uint64_t version;
+        uint64_t sizeofT;
+        uint64_t sizeofS;
+        uint64_t sizeofNode;
+        uint64_t keylen;
+        uint64_t nnodes;
+        uint64_t npayloads;
+        uint64_t rootidx;
+        uint64_t maxDepth;
+    };
+
+    // Elements waiting to be inserted below a node by _bulkInsert()
+    //
+    class task_t {
+    public:
+        size_t              node;
+        std::vector<size_t> items;
+    };
+
+    std::vector<node_t> _nodes;
+    std::vector<S>      _payloads;
+    size_t              _rootidx;
+    size_t              _maxDepth;
+
+    // Set when the tree was read from a file, in which case _nodes and
+    // _payloads are empty
+    //
+    std::shared_ptr<const char> _mapping;
+    const node_t *              _mappedNodes;
+    const S *                   _mappedPayloads;
+    size_t                      _nMappedNodes;
+
+    const node_t *_nodeData() const { return (_mapping ? _mappedNodes : _nodes.data()); }
+    const S *     _payloadData() const { return (_mapping ? _mappedPayloads : _payloads.data()); }
+    size_t        _numNodes() const { return (_mapping ? _nMappedNodes : _nodes.size()); }
+
+    static rectangle_t _rect(const std::vector<T> &rects, size_t i) { return (rectangle_t(rects[4 * i], rects[4 * i + 1], rects[4 * i + 2], rects[4 * i + 3])); }
+
+    // Copy a memory mapped tree into _nodes and _payloads so that it
+    // can be modified
+    //
+    void _unmap()
+    {
+        if (!_mapping) return;
+
+        _nodes.assign(_mappedNodes, _mappedNodes + _nMappedNodes);
+        size_t npayloads = 0;
+        for (size_t i = 0; i < _nodes.size(); i++) npayloads = std::max(npayloads, (size_t)(_nodes[i]._payload0 + _nodes[i]._npayloads));
+        _payloads.assign(_mappedPayloads, _mappedPayloads + npayloads);
+
+        _mapping = nullptr;
+        _mappedNodes = nullptr;
+        _mappedPayloads = nullptr;
+        _nMappedNodes = 0;
+    }
+
+    static void _subdivide(std::vector<node_t> &nodes, size_t idx)
+    {
+        if (!nodes[idx]._is_leaf) return;
+
+        rectangle_t rec = nodes[idx]._rectangle;
+        int         level = nodes[idx]._level + 1;
+
+        nodes[idx]._is_leaf = 0;
+        nodes[idx]._child0 = nodes.size();
+        for (uint32_t q = 0; q < 4; q++) nodes.push_back(node_t(rec.quadrant(q), level));
+    }
+
+    // Append a payload to a node. The node's payloads are moved to the
+    // end of the array, with twice the room, when they fill their slots.
+    //
+    void _addPayload(size_t idx, S payload)
+    {
+        node_t &node = _nodes[idx];
+        if (node._npayloads == node._capacity) {
+            size_t capacity = std::max((size_t)1, (size_t)(2 * node._capacity));
+            if (node._payload0 + node._capacity == _payloads.size()) {
+                _payloads.resize(node._payload0 + capacity);
+            } else {
+                size_t payload0 = _payloads.size();
+                _payloads.resize(payload0 + capacity);
+                std::copy(_payloads.begin() + node._payload0, _payloads.begin() + node._payload0 + node._npayloads, _payloads.begin() + payload0);
+                node._payload0 = payload0;
             }
-            return nodes[_child0 + 0];
-            VAssert(0);
+            node._capacity = capacity;
         }
-        node_t *quadrant(std::vector<node_t *> &nodes, uint32_t n) const
-        {
-            switch (n & 0x03) {
-            case 0: return nodes[_child0 + 0];
-            case 1: return nodes[_child0 + 1];
-            case 2: return nodes[_child0 + 2];
-            case 3: return nodes[_child0 + 3];
-            }
-            return nodes[_child0 + 0];
-            VAssert(0);
+        _payloads[node._payload0 + node._npayloads++] = payload;
+    }
+
+    bool _insert(size_t idx, const rectangle_t &rec, S payload)
+    {
+        if (!_nodes[idx].intersects(rec)) return (false);
+
+        if (_nodes[idx].stores(rec, _maxDepth)) {
+            _addPayload(idx, payload);
+            return (true);
         }
 
-        bool insert(std::vector<node_t *> &nodes, const rectangle_t &rec, S payload, size_t maxDepth)
-        {
-            if (!_rectangle.intersects(rec)) return (false);
-
-            // if rec is larger than a quadrant (half the width and height of this
-            // node) there is no point in refining. I.e. stop descending the
-            // tree and store the payload here.
-            //
-            if (_rectangle.width() < rec.width() || _rectangle.height() < rec.height() || _level >= maxDepth) {
-                _payloads.push_back(payload);
-                return (true);
+        // This is a no-op if node has already been subdivided
+        //
+        _subdivide(_nodes, idx);
+
+        // Recursively insert in each child node that intersects rec
+        //
+        size_t child0 = _nodes[idx]._child0;
+        for (int q = 0; q < 4; q++) {
+            if (_nodes[child0 + q].intersects(rec)) {
+                bool ok = _insert(child0 + q, rec, payload);
+                VAssert(ok);
             }
+        }
 
-            // This is a no-op if node has already been subdivided
-            //
-            subdivide(nodes);
+        return (true);
+    }
 
-            // Recursively insert in each child node that intersects rec
-            //
-            for (int q = 0; q < 4; q++) {
-                node_t *child = quadrant(nodes, q);
-                if (child->intersects(rec)) {
-                    bool ok = child->insert(nodes, rec, payload, maxDepth);
-                    VAssert(ok);
-                }
+    // Store the elements of items that stop at node idx, and distribute
+    // those that descend further among the lists of the four children,
+    // subdividing the node if there are any. Items are kept in their
+    // original order so that payloads are stored in the order Insert()
+    // would.
+    //
+    static void _split(std::vector<node_t> &nodes, std::vector<S> &payloads, size_t idx, const std::vector<size_t> &items, const std::vector<T> &rects, const std::vector<S> &inPayloads,
+                       size_t maxDepth, std::vector<size_t> *children)
+    {
+        const rectangle_t &bounds = nodes[idx]._rectangle;
+        for (int q = 0; q < 4; q++) children[q].clear();
+
+        size_t payload0 = payloads.size();
+        for (size_t i = 0; i < items.size(); i++) {
+            rectangle_t rec = _rect(rects, items[i]);
+            if (nodes[idx].stores(rec, maxDepth)) {
+                payloads.push_back(inPayloads[items[i]]);
+                continue;
             }
 
-            return (true);
+            uint32_t mask = bounds.quadrants(rec);
+            for (int q = 0; q < 4; q++) {
+                if (mask & (1 << q)) children[q].push_back(items[i]);
+            }
         }
+        nodes[idx]._payload0 = payload0;
+        nodes[idx]._npayloads = payloads.size() - payload0;
+        nodes[idx]._capacity = nodes[idx]._npayloads;
 
-        void get_payload_contains(const std::vector<node_t *> &nodes, T x, T y, std::vector<S> &payloads) const
-        {
-            if (!_rectangle.contains(x, y)) return;
+        if (children[0].size() || children[1].size() || children[2].size() || children[3].size()) _subdivide(nodes, idx);
+    }
 
-            if (_payloads.size()) { payloads.insert(payloads.end(), _payloads.begin(), _payloads.end()); }
-            if (_is_leaf) return;
+    // Build, depth first, the subtree rooted at node idx. scratch holds
+    // the lists of the four children of a node at each level, reused by
+    // every node at that level.
+    //
+    static void _build(std::vector<node_t> &nodes, std::vector<S> &payloads, size_t idx, const std::vector<size_t> &items, std::vector<std::vector<size_t>> &scratch, const std::vector<T> &rects,
+                       const std::vector<S> &inPayloads, size_t maxDepth)
+    {
+        std::vector<size_t> *children = &scratch[4 * (nodes[idx]._level + 1)];
 
-            for (int q = 0; q < 4; q++) {
-                const node_t *node = quadrant(nodes, q);
-                if (node->_rectangle.contains(x, y)) { node->get_payload_contains(nodes, x, y, payloads); }
-            }
+        _split(nodes, payloads, idx, items, rects, inPayloads, maxDepth, children);
+        if (nodes[idx]._is_leaf) return;
+
+        size_t child0 = nodes[idx]._child0;
+        for (int q = 0; q < 4; q++) {
+            if (children[q].size()) _build(nodes, payloads, child0 + q, children[q], scratch, rects, inPayloads, maxDepth);
         }
+    }
 
-        void print(const std::vector<node_t *> &nodes, std::ostream &os) const
-        {
-            for (int i = 0; i < _level; i++) os << " ";
-            os << _rectangle;
-
-            for (int i = 0; i < _level; i++) os << " ";
-            os << "payload : ";
-            for (int i = 0; i < _payloads.size(); i++) { os << _payloads[i] << " "; }
-            os << std::endl;
-            if (!_is_leaf) {
+    size_t _bulkInsert(const std::vector<T> &rects, const std::vector<S> &inPayloads, int nthreads)
+    {
+        std::vector<task_t> tasks(1);
+        tasks[0].node = _rootidx;
+        for (size_t i = 0; i < inPayloads.size(); i++) {
+            if (_nodes[_rootidx].intersects(_rect(rects, i))) tasks[0].items.push_back(i);
+        }
+        size_t count = tasks[0].items.size();
+        if (!count) return (0);
+
+        // Build the first levels breadth first until there are enough
+        // subtrees to keep the threads busy
+        //
+        while (nthreads > 1 && tasks.size() && tasks.size() < 4 * (size_t)nthreads) {
+            std::vector<task_t> next;
+            for (size_t t = 0; t < tasks.size(); t++) {
+                std::vector<size_t> children[4];
+                _split(_nodes, _payloads, tasks[t].node, tasks[t].items, rects, inPayloads, _maxDepth, children);
+                if (_nodes[tasks[t].node]._is_leaf) continue;
+
+                size_t child0 = _nodes[tasks[t].node]._child0;
                 for (int q = 0; q < 4; q++) {
-                    const node_t *child = quadrant(nodes, q);
-                    child->print(nodes, os);
+                    if (children[q].empty()) continue;
+
+                    task_t child;
+                    child.node = child0 + q;
+                    child.items.swap(children[q]);
+                    next.push_back(std::move(child));
                 }
             }
+            tasks = std::move(next);
         }
-        const std::vector<S> &get_payloads() const { return (_payloads); }
-        size_t                get_level() const { return (_level); }
 
-    private:
-        int            _level;
-        bool           _is_leaf;
-        size_t         _child0;
-        rectangle_t    _rectangle;
-        std::vector<S> _payloads;
-    };
+        // Build each subtree in its own arrays, where its root is node 0
+        //
+        std::vector<std::vector<node_t>> subNodes(tasks.size());
+        std::vector<std::vector<S>>      subPayloads(tasks.size());
+        std::atomic<size_t>              nextTask(0);
+
+        auto worker = [&]() {
+            std::vector<std::vector<size_t>> scratch(4 * (_maxDepth + 2));
+            for (size_t t = nextTask++; t < tasks.size(); t = nextTask++) {
+                const node_t &root = _nodes[tasks[t].node];
+                if (tasks.size() == 1) subNodes[t].reserve(_nodes.capacity());
+                subNodes[t].push_back(node_t(root._rectangle, root._level));
+                _build(subNodes[t], subPayloads[t], 0, tasks[t].items, scratch, rects, inPayloads, _maxDepth);
+                std::vector<size_t>().swap(tasks[t].items);
+            }
+        };
+
+        nthreads = std::min((size_t)nthreads, tasks.size());
+        std::vector<std::thread> threads;
+        for (int i = 1; i < nthreads; i++) threads.push_back(std::thread(worker));
+        worker();
+        for (auto &t : threads) t.join();
+
+        // A tree built on one thread replaces the empty tree
+        //
+        if (tasks.size() == 1 && tasks[0].node == _rootidx && _nodes.size() == 1) {
+            _nodes.swap(subNodes[0]);
+            _payloads.swap(subPayloads[0]);
+            _rootidx = 0;
+            return (count);
+        }
+
+        // Append the subtrees. The root of each replaces the node it was
+        // built for, and the other nodes follow the existing ones.
+        //
+        for (size_t t = 0; t < tasks.size(); t++) {
+            size_t nodeBase = _nodes.size() - 1;
+            size_t payloadBase = _payloads.size();
+            for (size_t i = 0; i < subNodes[t].size(); i++) {
+                node_t &node = subNodes[t][i];
+                if (!node._is_leaf) node._child0 += nodeBase;
+                node._payload0 += payloadBase;
+            }
+            _nodes[tasks[t].node] = subNodes[t][0];
+            _nodes.insert(_nodes.end(), subNodes[t].begin() + 1, subNodes[t].end());
+            _payloads.insert(_payloads.end(), subPayloads[t].begin(), subPayloads[t].end());
+            std::vector<node_t>().swap(subNodes[t]);
+            std::vector<S>().swap(subPayloads[t]);
+        }
+
+        return (count);
+    }
+
+    void _getPayloadContains(size_t idx, T x, T y, std::vector<S> &payloads) const
+    {
+        const node_t &node = _nodeData()[idx];
+        if (!node.contains(x, y)) return;
+
+        const S *p = _payloadData() + node._payload0;
+        if (node._npayloads) { payloads.insert(payloads.end(), p, p + node._npayloads); }
+        if (node._is_leaf) return;
+
+        for (int q = 0; q < 4; q++) {
+            if (_nodeData()[node._child0 + q].contains(x, y)) { _getPayloadContains(node._child0 + q, x, y, payloads); }
+        }
+    }
+
+    void _print(size_t idx, std::ostream &os) const
+    {
+        const node_t &node = _nodeData()[idx];
+        for (int i = 0; i < node._level; i++) os << " ";
+        os << node._rectangle;
+
+        for (int i = 0; i < node._level; i++) os << " ";
+        os << "payload : ";
+        for (size_t i = 0; i < node._npayloads; i++) { os << _payloadData()[node._payload0 + i] << " "; }
+        os << std::endl;
+        if (!node._is_leaf) {
+            for (int q = 0; q < 4; q++) _print(node._child0 + q, os);
+        }
+    }
+
+    static void _initHeader(header_t &h, const std::string &key)
+    {
+        memset(&h, 0, sizeof(h));
+        h.magic = 0x5641504f52515452ULL;    // "VAPORQTR"
+        h.version = 1;
+        h.sizeofT = sizeof(T);
+        h.sizeofS = sizeof(S);
+        h.sizeofNode = sizeof(node_t);
+        h.keylen = key.size();
+    }
+
+    // The key is padded so that the arrays that follow it are aligned
+    //
+    static size_t _padded(size_t n) { return ((n + 7) & ~(size_t)7); }
 
-    std::vector<node_t *> _nodes;
-    size_t                _rootidx;
-    size_t                _maxDepth;
+    static void _pad(std::ostream &os, size_t n)
+    {
+        const char zeros[8] = {0};
+        os.write(zeros, _padded(n) - n);
+    }
+
+    // Map a whole file read only. Where memory mapping isn't available
+    // the file is read into memory.
+    //
+    static int _mapFile(const std::string &path, std::shared_ptr<const char> &mapping, size_t &size)
+    {
+#ifdef WIN32
+        std::ifstream f(path.c_str(), std::ios::in | std::ios::binary);
+        if (!f) return (-1);
+        f.seekg(0, std::ios::end);
+        size = f.tellg();
+        f.seekg(0, std::ios::beg);
+        if (!size) return (-1);
+
+        // uint64_t elements keep the arrays in the file aligned
+        //
+        uint64_t *buf = new uint64_t[(size + 7) / 8];
+        f.read((char *)buf, size);
+        if (!f) {
+            delete[] buf;
+            return (-1);
+        }
+        mapping = std::shared_ptr<const char>((const char *)buf, [](const char *p) { delete[](const uint64_t *) p; });
+        return (0);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return (-1);
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size == 0) {
+            close(fd);
+            return (-1);
+        }
+        size = st.st_size;
+
+        void *ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) return (-1);
+
+        mapping = std::shared_ptr<const char>((const char *)ptr, [size](const char *p) { munmap((void *)p, size); });
+        return (0);
+#endif
+    }
 };
 };    // namespace VAPoR
@@ -0,0 +1,23 @@
+/*
+ * Place seeds in a rake, the box in which the flow renderer and flowtrace
+ * start their trajectories.
+ */
+
+#ifndef RAKE_SEEDS_H
+#define RAKE_SEEDS_H
+
+#include <vector>
+#include "vapor/Particle.h"
+
+namespace flow {
+// Place numOfSeeds[i] seeds along each axis of the rake, at the centers of the cells
+// of a regular grid. The rake holds (min, max) pairs of 2 or 3 axes; 2D rakes
+// are placed at defaultZ. All seeds start at the given time.
+FLOW_API auto RakeSeedsUniform(const std::vector<float> &rake, const std::vector<long> &numOfSeeds, double time, float defaultZ) -> std::vector<flow::Particle>;
+
+// Place numOfSeeds seeds at random in the rake, drawn from a generator
+// seeded with randSeed, so that the same seeds are placed every time.
+FLOW_API auto RakeSeedsRandom(const std::vector<float> &rake, long numOfSeeds, unsigned int randSeed, double time, float defaultZ) -> std::vector<flow::Particle>;
+};    // namespace flow
+
+#endif
@@ -73,6 +73,25 @@ public:
     //
     virtual bool InsideGrid(const DblArr3 &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //!
+    //! Cell indices, weights and trilinear interpolation are computed
+    //! several points at a time with vector instructions. The values are
+    //! identical to those of GetValue().
+    //!
+    //! \sa SamplingKernels()
+    //
+    virtual void GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const override;
+
+    //! Return the instruction set used by GetValues()
+    //!
+    //! The instruction set is chosen at run time from those supported by
+    //! the processor.
+    //!
+    //! \retval name One of "avx2", "sse2", or "scalar"
+    //
+    static std::string SamplingKernels();
+
     class ConstCoordItrRG : public Grid::ConstCoordItrAbstract {
     public:
         ConstCoordItrRG(const RegularGrid *rg, bool begin);
@@ -117,6 +136,10 @@ protected:
     //
     virtual void GetUserExtentsHelper(DblArr3 &minu, DblArr3 &maxu) const override;
 
+    //! \copydoc Grid::ForEachBlockInBoxHelper()
+    //
+    virtual void ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const override;
+
 private:
     void _SetExtents(const std::vector<double> &minu, const std::vector<double> &maxu);
 
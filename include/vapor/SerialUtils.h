@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vapor/common.h>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Wasp {
+
+//! Helpers for the small binary files, such as metadata indices and
+//! caches, that VAPOR writes for its own use. Integers are stored as 64
+//! bit values in native byte order: the files are only meant to be read
+//! back on the machine that wrote them.
+//
+namespace SerialUtils {
+
+COMMON_API void WriteU64(std::ostream &o, uint64_t v);
+COMMON_API bool ReadU64(std::istream &i, uint64_t &v);
+
+//! Strings are stored as their length followed by their bytes. ReadString()
+//! fails on lengths over 1 GB, which can only come from a corrupt file.
+//
+COMMON_API void WriteString(std::ostream &o, const std::string &s);
+COMMON_API bool ReadString(std::istream &i, std::string &s);
+
+COMMON_API void WriteStrings(std::ostream &o, const std::vector<std::string> &v);
+COMMON_API bool ReadStrings(std::istream &i, std::vector<std::string> &v);
+
+//! Write a file with \p write, then rename it into place, so that readers
+//! (including other processes) never see a partially written file. The
+//! file is first written under a name that is unique to the calling
+//! process and thread. If several writers race, the last one wins.
+//!
+//! \param[in] write Writes the contents. Returns false on failure.
+//! \retval status A negative int is returned if the file couldn't be
+//! written, in which case \p path is left unchanged.
+//
+COMMON_API int WriteFileAtomic(const std::string &path, const std::function<bool(std::ostream &)> &write);
+
+//! Initial value of a 64 bit FNV-1a hash
+//
+const uint64_t FNVOffset = 0xcbf29ce484222325ULL;
+
+//! Fold \p n bytes into the 64 bit FNV-1a hash \p h. Not a cryptographic
+//! hash: only used to name and validate cache entries.
+//
+COMMON_API uint64_t FNV1a(const void *data, size_t n, uint64_t h = FNVOffset);
+
+//! Hash a string's bytes. Pass a std::string, not a literal: with a
+//! seed, FNV1a("abc", h) would select the overload above.
+//
+inline uint64_t FNV1a(const std::string &s, uint64_t h = FNVOffset) { return (FNV1a(s.data(), s.size(), h)); }
+
+}    // namespace SerialUtils
+}    // namespace Wasp
@@ -91,6 +91,10 @@ public:
     //
     virtual bool InsideGrid(const DblArr3 &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const override;
+
     //! Returns reference to vector containing X user coordinates
     //!
     //! Returns reference to vector passed to constructor
@@ -150,6 +154,10 @@ protected:
 
     void GetUserExtentsHelper(DblArr3 &minu, DblArr3 &maxu) const override;
 
+    //! \copydoc Grid::ForEachBlockInBoxHelper()
+    //
+    virtual void ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const override;
+
 private:
     std::vector<double> _xcoords;
     std::vector<double> _ycoords;
@@ -109,6 +109,15 @@ public:
     VDF_API friend std::ostream &operator<<(std::ostream &o, const StructuredGrid &sg);
 
 protected:
+    //! Compute the Z range of each column of cells of a layered grid
+    //!
+    //! \param[in] zcoords Z coordinates of the nodes, a 3D grid whose
+    //! values increase or decrease monotonically along K
+    //! \param[out] bounds Minimum and maximum Z of each column of cells,
+    //! with I varying fastest
+    //
+    static void MakeColumnBounds(const Grid &zcoords, std::vector<float> &bounds);
+
 private:
     std::vector<size_t> _cellDims;
 };
@@ -0,0 +1,171 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vapor/common.h>
+
+//! Trace records above this level are compiled out. 0 disables tracing,
+//! 3 keeps everything, and the runtime level, see Trace::SetLevel(),
+//! filters what is compiled in.
+//
+#ifndef VAPOR_TRACE_LEVEL
+    #define VAPOR_TRACE_LEVEL 3
+#endif
+
+namespace Wasp {
+
+//! \class Trace
+//! \brief Low overhead tracing and metrics
+//!
+//! Records timed spans, messages and counters from any thread. Each thread
+//! records into its own ring buffer of events, so recording takes no global
+//! lock and the most recent events are kept when a buffer fills up.
+//! The buffer of a thread that has exited is reused by a new thread once
+//! its events have been written out. At most 16 exited threads keep
+//! unwritten events; past that, the oldest of them are dropped.
+//! Messages are only formatted if their level is enabled. Events can be
+//! written out in the Chrome trace event format, which chrome://tracing and
+//! Perfetto display as a timeline.
+//!
+//! Counters are process wide totals, such as cache hits or bytes read.
+//! They are updated even when tracing is off.
+//!
+//! Use the VTRACE_* macros rather than calling these methods directly, so
+//! that the records can be compiled out with VAPOR_TRACE_LEVEL.
+//!
+//! \code
+//!  Trace::SetLevel(Trace::Info);
+//!  {
+//!      VTRACE_SCOPE("DataMgr::GetVariable");
+//!      VTRACE_COUNT("DataMgr.cache_hits", 1);
+//!      VTRACE_MSG(Trace::Debug, "read %s", varname.c_str());
+//!  }
+//!  Trace::WriteChromeTrace("vapor_trace.json");
+//! \endcode
+//
+class COMMON_API Trace {
+public:
+    enum Level { Off = 0, Error = 1, Info = 2, Debug = 3 };
+
+    //! Set the most detailed level recorded. The default is the value of
+    //! the VAPOR_TRACE environment variable, or Off.
+    //
+    static void SetLevel(int level) { _level.store(level, std::memory_order_relaxed); }
+    static int  GetLevel() { return (_level.load(std::memory_order_relaxed)); }
+
+    //! Return true if records of level \p level are kept
+    //
+    static bool Enabled(int level) { return (level <= VAPOR_TRACE_LEVEL && level <= _level.load(std::memory_order_relaxed)); }
+
+    //! Set the number of events kept per thread. Only affects threads
+    //! that have not recorded anything yet. The default is 16384.
+    //
+    static void SetBufferSize(size_t n);
+
+    //! Record a formatted message. Messages longer than 95 characters are
+    //! truncated.
+    //!
+    //! \param[in] level Level of the message
+    //! \param[in] format A 'C' style sprintf format string.
+    //
+    static void Message(int level, const char *format, ...);
+
+    //! Record an already formatted message
+    //
+    static void MessageString(int level, const char *msg);
+
+    //! Record a span of time
+    //!
+    //! \param[in] name Name of the span. Must be a string literal, or
+    //! otherwise outlive the trace.
+    //! \param[in] start, end Times of the span, as returned by Now()
+    //
+    static void Span(const char *name, int64_t start, int64_t end);
+
+    //! Return the time in microseconds since the trace started
+    //
+    static int64_t Now();
+
+    //! Return the counter named \p name, creating it with a value of zero
+    //! if needed. The counter is never destroyed, so the returned reference
+    //! may be kept.
+    //
+    static std::atomic<int64_t> &GetCounter(const std::string &name);
+
+    //! Return the value of every counter
+    //
+    static std::map<std::string, int64_t> GetCounters();
+
+    //! Discard the recorded events, and reset the counters to zero
+    //
+    static void Clear();
+
+    //! Write the recorded events, and the current value of the counters,
+    //! in the Chrome trace event format (JSON)
+    //!
+    //! \retval status A negative int is returned if the file can't be
+    //! written
+    //
+    static int WriteChromeTrace(const std::string &path);
+
+    //! Records a span from its construction to its destruction, if
+    //! \p level was enabled at construction
+    //
+    class COMMON_API Scope {
+    public:
+        Scope(const char *name, int level = Info) : _name(Enabled(level) ? name : nullptr), _start(_name ? Now() : 0) {}
+        ~Scope()
+        {
+            if (_name) Span(_name, _start, Now());
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *  _name;
+        const int64_t _start;
+    };
+
+private:
+    static std::atomic<int> _level;
+};
+
+};    // namespace Wasp
+
+#define VTRACE_CONCAT_(a, b) a##b
+#define VTRACE_CONCAT(a, b)  VTRACE_CONCAT_(a, b)
+
+#if VAPOR_TRACE_LEVEL > 0
+
+    //! Record a span of level Info covering the rest of the enclosing scope
+    //
+    #define VTRACE_SCOPE(name) Wasp::Trace::Scope VTRACE_CONCAT(_vtraceScope, __LINE__)(name)
+
+    //! Record a message. The arguments are only evaluated if \p level is
+    //! enabled.
+    //
+    #define VTRACE_MSG(level, ...)                                                          \
+        do {                                                                                \
+            if (Wasp::Trace::Enabled(level)) Wasp::Trace::Message((level), __VA_ARGS__); \
+        } while (0)
+
+    //! Add \p n to the counter \p name, which must be a constant
+    //
+    #define VTRACE_COUNT(name, n)                                                                               \
+        do {                                                                                                    \
+            static std::atomic<int64_t> &VTRACE_CONCAT(_vtraceCounter, __LINE__) = Wasp::Trace::GetCounter(name); \
+            VTRACE_CONCAT(_vtraceCounter, __LINE__).fetch_add((n), std::memory_order_relaxed);                     \
+        } while (0)
+
+#else
+
+    #define VTRACE_SCOPE(name)
+    #define VTRACE_MSG(level, ...) \
+        do {                       \
+        } while (0)
+    #define VTRACE_COUNT(name, n) \
+        do {                      \
+        } while (0)
+
+#endif
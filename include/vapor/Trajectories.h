@@ -0,0 +1,89 @@
+/*
+ * Columnar storage of the trajectories ("streams") resulting from an advection.
+ *
+ * The samples of all streams live in contiguous arrays of locations, times and
+ * values, plus one array per property variable. Each stream occupies a range of
+ * these arrays, given by its offset and size. There may be unused space after a
+ * stream, so that it can grow without moving the others.
+ *
+ * Trajectories are filled by an Advection; everyone else only reads them.
+ */
+
+#ifndef TRAJECTORIES_H
+#define TRAJECTORIES_H
+
+#include "vapor/Particle.h"
+#include "vapor/common.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace flow {
+class FLOW_API Trajectories final {
+public:
+    size_t GetNumberOfStreams() const { return _sizes.size(); }
+
+    // The samples of stream i are at indices [offset, offset + size) of the arrays below.
+    size_t GetStreamOffset(size_t i) const { return _offsets[i]; }
+    size_t GetStreamSize(size_t i) const { return _sizes[i]; }
+
+    // Total number of samples in all streams
+    size_t GetNumberOfSamples() const;
+
+    const glm::vec3 *GetLocations() const { return _locations.data(); }
+    const double *   GetTimes() const { return _times.data(); }
+    const float *    GetValues() const { return _values.data(); }
+
+    // Same as Particle::IsSpecial(): a special sample is a separator, or the
+    // end of a stream that could not be advected any further.
+    bool IsSpecial(size_t idx) const { return (std::isnan(_times[idx]) && std::isnan(_values[idx])); }
+
+    // Property arrays, in the order of their names
+    const std::vector<std::string> &GetPropertyNames() const { return _propertyNames; }
+    const float *                   GetProperty(size_t i) const { return _properties.at(i).data(); }
+
+    // Copy one sample out as a Particle, with its properties attached.
+    Particle GetParticle(size_t idx) const;
+
+    // Bytes held by the arrays, including unused space
+    size_t GetMemoryUsage() const;
+
+private:
+    friend class Advection;
+
+    std::vector<size_t>             _offsets;
+    std::vector<size_t>             _sizes;
+    std::vector<size_t>             _capacities;
+    std::vector<glm::vec3>          _locations;
+    std::vector<double>             _times;
+    std::vector<float>              _values;
+    std::vector<std::string>        _propertyNames;
+    std::vector<std::vector<float>> _properties;
+
+    // Start over with one stream per seed.
+    void _reset(const std::vector<Particle> &seeds);
+
+    // Copy the last (up to) n samples of a stream into "tail", and return how many were copied.
+    size_t _loadTail(size_t stream, size_t n, std::vector<Particle> &tail) const;
+
+    // Replace the last n samples of a stream with "tail". If the stream no longer fits
+    // in its space, it is moved to the end of the arrays with room to grow.
+    void _storeTail(size_t stream, size_t n, const std::vector<Particle> &tail);
+
+    void _set(size_t idx, const Particle &p);
+    void _copySample(size_t from, size_t to);
+    void _truncate(size_t stream, size_t n) { _sizes[stream] = n; }
+
+    // Squeeze out unused space once there is more of it than of samples.
+    void _compact();
+
+    // Add a property array filled with nan, and return it.
+    std::vector<float> &_addProperty(const std::string &name);
+    void                _removeProperty(size_t i);
+    void                _clearProperties();
+
+    void _resizeArrays(size_t n);
+};
+};    // namespace flow
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef _VDCConverter_h_
+#define _VDCConverter_h_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <functional>
+#include <vapor/MyBase.h>
+
+namespace VAPoR {
+
+class DC;
+
+//
+//! \class VDCConverter
+//! \brief Copy variables from a DC into an existing VDC with a pool of
+//! worker processes
+//!
+//! The conversion is split into work items, one per variable and time
+//! step. Items whose data go to the same file are grouped and copied in
+//! order by a single worker, since a file may only have one writer.
+//! Groups are handed out to a pool of worker processes, so that one
+//! worker reads its source data while others compress and write theirs.
+//! Processes are used rather than threads because the NetCDF library is
+//! not thread safe; each worker opens its own DC, with a caller supplied
+//! factory, and its own VDC. Compression inside each worker remains
+//! multithreaded.
+//!
+//! Each item is copied with VDCNetCDF::CopyVar(), or CopyMask() for a
+//! mask variable. Coordinate variables are copied first, then the mask
+//! variables of any data variables that have one, then the data
+//! variables, since writing a data variable reads its mask. Variables
+//! that live in the master file are copied by the calling process,
+//! before the other groups of the same stage are handed out.
+//!
+//! A new group is only started if the estimated memory of the groups in
+//! progress stays within a budget. At least one group is always in
+//! progress.
+//!
+//! If a checkpoint file is given each completed item is appended to it,
+//! once the file it wrote has been flushed to disk, and a later
+//! conversion of the same items skips the items it lists. The
+//! checkpoint file is removed once all items have been copied.
+//!
+//! On Windows, or with a single worker, all items are copied by the
+//! calling process.
+//
+class VDF_API VDCConverter : public Wasp::MyBase {
+public:
+    //! Conversion statistics
+    //!
+    //! Times are summed over the workers. Time spent writing includes
+    //! compression, which WASP performs inside VDC::WriteSlice().
+    //!
+    //! \sa GetStats()
+    //
+    class Stats {
+    public:
+        Stats() : nitems(0), nskipped(0), nfailed(0), readBytes(0), readTime(0.0), writeBytes(0), writeTime(0.0), wallTime(0.0) {}
+
+        size_t nitems;        // Number of items copied
+        size_t nskipped;      // Number of items skipped because the checkpoint lists them
+        size_t nfailed;       // Number of items that could not be copied
+        size_t readBytes;     // Bytes returned by DC::ReadSlice()
+        double readTime;      // Seconds spent in DC::ReadSlice()
+        size_t writeBytes;    // Bytes passed to VDC::WriteSlice()
+        double writeTime;     // Seconds spent compressing, writing and closing
+        double wallTime;      // Elapsed seconds of Convert()
+    };
+
+    //! Returns a new, initialized DC, or NULL on failure. Called once by
+    //! each worker process.
+    //
+    typedef std::function<DC *()> DCFactory;
+
+    //! Called by the calling process after each item is copied, or failed
+    //! to copy, with the status of the item
+    //
+    typedef std::function<void(const std::string &varname, size_t ts, int status)> ProgressFunc;
+
+    //! Constructor
+    //!
+    //! \param[in] factory Creates the DC read by each worker process
+    //! \param[in] master Path to the VDC master file, which must already
+    //! define all of the variables to be copied
+    //! \param[in] nworkers Number of worker processes. A value less than
+    //! one uses the number of processors.
+    //! \param[in] nthreads Number of compression threads of each worker.
+    //! A value less than one divides the processors among the workers.
+    //! \param[in] chunksize NetCDF chunk size hint for new files
+    //
+    VDCConverter(DCFactory factory, std::string master, int nworkers = 0, int nthreads = 0, size_t chunksize = 0);
+
+    //! Bound the memory of the groups in progress
+    //!
+    //! \param[in] maxBytes Memory budget, estimated from the size of the
+    //! slab buffered by each worker. Zero means no bound.
+    //
+    void SetMaxMemory(size_t maxBytes) { _maxMem = maxBytes; }
+
+    //! Set the checkpoint file
+    //!
+    //! \param[in] path Path to the checkpoint file. An empty path disables
+    //! checkpointing.
+    //! \param[in] restart If true, items listed in an existing checkpoint
+    //! file are copied again
+    //
+    void SetCheckpoint(std::string path, bool restart = false)
+    {
+        _checkpoint = path;
+        _restart = restart;
+    }
+
+    void SetProgressFunc(ProgressFunc progress) { _progress = progress; }
+
+    //! Copy variables
+    //!
+    //! \param[in] dc The source DC, used by the calling process
+    //! \param[in] coordvars Names of the coordinate variables to copy
+    //! \param[in] datavars Names of the data variables to copy
+    //! \param[in] numts Maximum number of time steps to copy per
+    //! variable. A negative value copies all time steps.
+    //!
+    //! \retval status A negative int is returned if any item could not be
+    //! copied. The other items are still copied.
+    //
+    int Convert(DC &dc, const std::vector<std::string> &coordvars, const std::vector<std::string> &datavars, int numts = -1);
+
+    //! Return the statistics of the last call to Convert()
+    //
+    Stats GetStats() const { return (_stats); }
+
+    //! Print the statistics of the last call to Convert(), with the
+    //! throughput of each stage
+    //
+    void PrintStats(std::ostream &o = std::cout) const;
+
+    //! A ProgressFunc that prints each item on the standard output
+    //
+    static void PrintProgress(const std::string &varname, size_t ts, int status);
+
+private:
+    DCFactory    _factory;
+    std::string  _master;
+    int          _nworkers;
+    int          _nthreads;
+    size_t       _chunksize;
+    size_t       _maxMem;
+    std::string  _checkpoint;
+    bool         _restart;
+    ProgressFunc _progress;
+    Stats        _stats;
+};
+
+};    // namespace VAPoR
+
+#endif
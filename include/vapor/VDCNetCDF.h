@@ -152,8 +152,42 @@ public:
     int PutVar(size_t ts, string varname, int lod, const float *data) { return (_putVarTemplate(ts, varname, lod, data)); }
     int PutVar(size_t ts, string varname, int lod, const int *data) { return (_putVarTemplate(ts, varname, lod, data)); }
 
+    //! Statistics of copies, accumulated by CopyVar() and CopyMask()
+    //
+    class CopyStats {
+    public:
+        CopyStats() : readBytes(0), readTime(0.0), writeBytes(0), writeTime(0.0) {}
+
+        size_t readBytes;     // Bytes returned by DC::ReadSlice()
+        double readTime;      // Seconds spent in DC::ReadSlice()
+        size_t writeBytes;    // Bytes passed to WriteSlice()
+        double writeTime;     // Seconds spent compressing, writing and closing
+    };
+
     int CopyVar(DC &dc, string varname, int srclod, int dstlod);
-    int CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod);
+    int CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod) { return (CopyVar(dc, ts, varname, srclod, dstlod, NULL)); }
+
+    //! Copy a variable at a single time step, adding the statistics of
+    //! the copy to \p stats if it is not NULL
+    //
+    int CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod, CopyStats *stats);
+
+    //! Write a mask variable that flags the valid samples of a variable
+    //!
+    //! \param[in] dc Source of the variable \p srcvar
+    //! \param[in] ts Time step
+    //! \param[in] srcvar Name of the source variable
+    //! \param[in] maskvar Name of the mask variable written. Its
+    //! dimensions must match those of \p srcvar.
+    //! \param[in] mv Missing value of \p srcvar. The mask is zero where
+    //! \p srcvar equals \p mv, and one elsewhere
+    //! \param[in] lod Level of detail of \p maskvar
+    //! \param[out] stats If not NULL, the statistics of the copy are
+    //! added to \p stats
+    //!
+    //! \sa CopyVar()
+    //
+    int CopyMask(DC &dc, size_t ts, string srcvar, string maskvar, double mv, int lod = -1, CopyStats *stats = NULL);
 
     //! \copydoc VDC::CompressionInfo()
     //
@@ -185,6 +219,8 @@ protected:
     int readRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, float *region);
     int readRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, int *region);
 
+    int readRegionRange(int fd, const vector<size_t> &min, const vector<size_t> &max, vector<double> &range);
+
     virtual bool variableExists(size_t ts, string varname, int reflevel = 0, int lod = 0) const;
 
 private:
@@ -270,8 +306,11 @@ private:
 
     int _copyVar0d(DC &dc, size_t ts, const BaseVar &varInfo);
 
+    int _copyVar(DC &dc, size_t ts, string srcvar, string dstvar, int srclod, int dstlod, const double *mv, CopyStats &stats);
+
     template<class T>
-    int _copyVarHelper(DC &dc, int fdr, int fdw, vector<size_t> &buffer_dims, vector<size_t> &src_hslice_dims, vector<size_t> &dst_hslice_dims, size_t src_nslice, size_t dst_nslice, T *buffer);
+    int _copyVarHelper(DC &dc, int fdr, int fdw, vector<size_t> &buffer_dims, vector<size_t> &src_hslice_dims, vector<size_t> &dst_hslice_dims, size_t src_nslice, size_t dst_nslice, const double *mv,
+                       T *buffer, CopyStats &stats);
 
     template<class T> int _readRegionBlockTemplate(int fd, const vector<size_t> &min, const vector<size_t> &max, T *region);
 
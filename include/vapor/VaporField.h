@@ -111,6 +111,8 @@ public:
     // Let's implement a mechanism to cache information and interact with them less frequently.
     // Specifically, the following two functions are used to `lock` into (and `unlock` from)
     // the current set of params from FlowParams, so we don't need to interact with it anymore.
+    // FlowParams is not thread safe: LockParams() must be called, on the calling thread,
+    // before the field is queried from several threads.
     //
     virtual auto LockParams() -> int override;
     virtual auto UnlockParams() -> int override;
@@ -126,20 +128,23 @@ private:
     using cacheType = VAPoR::unique_ptr_cache<GridKey, GridWrapper>;
     mutable cacheType _recentGrids;              // so this variable can be
                                                  // modified by a const function.
+                                                 // Queries are lock-free.
     mutable std::mutex _grid_operation_mutex;    // Use `mutable` qualifier so this
                                                  // mutex can be used in const methods.
+                                                 // Only held when a grid is created.
 
     // The following variables are cache states from DataMgr and Params.
-    bool                               _params_locked = false;
-    uint64_t                           _c_currentTS = 0;                   // cached timestep
-    int32_t                            _c_refLev = -2, _c_compLev = -2;    // cached ref/comp levels
-    float                              _c_vel_mult = 0.0f;                 // cached velocity multiplier
-    std::vector<double>                _c_ext_min, _c_ext_max;             // cached extents
-    const VAPoR::Grid *                _c_scalar_grid = nullptr;           // cached scalar grid
-    std::array<const VAPoR::Grid *, 3> _c_velocity_grids = {{nullptr, nullptr, nullptr}};
+    bool                                              _params_locked = false;
+    uint64_t                                          _c_currentTS = 0;                   // cached timestep
+    int32_t                                           _c_refLev = -2, _c_compLev = -2;    // cached ref/comp levels
+    float                                             _c_vel_mult = 0.0f;                 // cached velocity multiplier
+    std::vector<double>                               _c_ext_min, _c_ext_max;             // cached extents
+    std::shared_ptr<const VAPoR::Grid>                _c_scalar_grid;         // cached scalar grid
+    std::array<std::shared_ptr<const VAPoR::Grid>, 3> _c_velocity_grids;    // cached velocity grids
     // Note on the cached scalar and velocity grids:
     // they act as a cache of _recentGrids, so kind of like a cache of cache.
     // This is due to the not-so-cheap cost of constructing keys and querying _recentGrids.
+    // They are only filled for steady fields.
 
     //
     // Member functions
@@ -155,7 +160,9 @@ private:
     // Note 1: If a variable name is empty, we then return a ConstantField.
     // Note 2: If a variable is essentially 2D, we then grow it to be 3D
     //         and return a GrownGrid.
-    const VAPoR::Grid *_getAGrid(size_t timestep, const std::string &varName) const;
+    // Note 3: The returned pointer keeps the grid alive, even if it is evicted
+    //         from _recentGrids by another thread meanwhile.
+    std::shared_ptr<const VAPoR::Grid> _getAGrid(size_t timestep, const std::string &varName) const;
 };
 };    // namespace flow
 
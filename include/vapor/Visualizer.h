@@ -28,6 +28,7 @@
 #include <vapor/Renderer.h>
 #include <vapor/AnnotationRenderer.h>
 #include <vapor/Framebuffer.h>
+#include <vapor/AsyncImageWriter.h>
 
 namespace VAPoR {
 
@@ -134,24 +135,11 @@ public:
     }
 
     //! Turn on or off the animation capture enablement.  If on, all paintEvents will result in capture
-    //! until it is turned off
-    int SetAnimationCaptureEnabled(bool onOff, string filename)
-    {
-        if (_imageCaptureEnabled) {
-            SetErrMsg("Image capture concurrent with Animation Capture\n");
-            return -1;
-        }
-        if (_animationCaptureEnabled == onOff) {
-            SetErrMsg("Animation capture in incorrect state\n");
-            return -1;
-        }
-        _animationCaptureEnabled = onOff;
-        if (onOff)
-            _captureImageFile = filename;
-        else
-            _captureImageFile = "";
-        return 0;
-    }
+    //! until it is turned off.
+    //! Frames are encoded and written on a pool of threads while later
+    //! frames render. Turning capture off waits for all frames to be
+    //! written, and fails if any could not be.
+    int SetAnimationCaptureEnabled(bool onOff, string filename);
 
     //! Draw a text banner at x, y coordinates
     //
@@ -216,6 +204,8 @@ private:
     bool   _animationCaptureEnabled;
     string _captureImageFile;
 
+    AsyncImageWriter *_captureWriter;    // encodes animation frames
+
     vector<Renderer *> _renderers;
     vector<Renderer *> _renderersToDestroy;
 
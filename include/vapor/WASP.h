@@ -188,6 +188,13 @@ public:
     //
     virtual int InqVarDims(string name, vector<string> &dimnames, vector<size_t> &dims) const;
 
+    //! \copydoc NetCDFCpp::InqVarnames()
+    //!
+    //! Variables defined implicitly by DefVar() to store block ranges
+    //! are not included.
+    //
+    virtual int InqVarnames(vector<string> &varnames) const;
+
     //! Returns compression paramaters associated with the named variable
     //!
     //! This method returns various compression parameters associated
@@ -528,6 +535,35 @@ public:
     virtual int GetVaraBlock(vector<size_t> start, vector<size_t> count, int16_t *data);
     virtual int GetVaraBlock(vector<size_t> start, vector<size_t> count, unsigned char *data);
 
+    //! Return the range of values in a hyperslab without reading it
+    //!
+    //! When a compressed variable is written the minimum and maximum
+    //! value of each block, as reconstructed at every refinement level
+    //! and level-of-detail, are stored in a companion variable (See
+    //! VarNameRange()). This method reads only those ranges for the
+    //! refinement level and level-of-detail passed to OpenVarRead(),
+    //! a single small hyperslab per call, and returns the
+    //! combined range of all blocks intersecting the region
+    //! specified by \p start and \p count. The result is exact for
+    //! block-aligned regions (including regions clipped by the variable
+    //! boundary) and conservative otherwise.
+    //!
+    //! Masked (missing) values are not excluded from the stored ranges.
+    //!
+    //! \param[in] start Same as GetVara()
+    //! \param[in] count Same as GetVara()
+    //! \param[out] range A two-element vector containing the minimum
+    //! and maximum value
+    //!
+    //! \retval status Returns 1 if the range was determined, 0 if
+    //! no ranges are stored for the currently opened variable (it is
+    //! not compressed, or was written by an earlier version), and a
+    //! negative value on failure
+    //!
+    //! \sa OpenVarRead(), GetVara()
+    //
+    virtual int GetVaraRange(vector<size_t> start, vector<size_t> count, vector<double> &range);
+
     //! Read an array of values from the currently opened variable
     //!
     //! The currently opened variable may or may not be a WASP
@@ -552,6 +588,33 @@ public:
     virtual int GetVar(int16_t *data);
     virtual int GetVar(unsigned char *data);
 
+    //! Return I/O statistics for the most recent read of a compressed
+    //! variable
+    //!
+    //! When more than one execution thread is available compressed
+    //! variables are read with a pipeline: a single I/O thread fetches
+    //! compressed blocks from disk, in file order, into a bounded queue
+    //! and the remaining threads reconstruct and unblock them. This
+    //! method reports on the most recent GetVara(), GetVaraBlock(), or
+    //! GetVar() call made on a compressed variable.
+    //!
+    //! \param[out] nblocks Number of blocks read
+    //! \param[out] nbytes Number of encoded bytes read from storage
+    //! \param[out] ioTime Wall clock time, in seconds, spent fetching
+    //! blocks from storage
+    //! \param[out] totalTime Wall clock time, in seconds, for the entire
+    //! read, including reconstruction
+    //!
+    //! \sa GetVara()
+    //
+    void GetReadStats(size_t &nblocks, size_t &nbytes, double &ioTime, double &totalTime) const
+    {
+        nblocks = _read_nblocks;
+        nbytes = _read_nbytes;
+        ioTime = _read_io_time;
+        totalTime = _read_time;
+    }
+
     //! Copy a variable from one WASP file to another WASP file
     //!
     //! Copy a variable from the WASP file associated with this
@@ -628,6 +691,10 @@ public:
     //! NetCDF attribute name specifying WASP version number
     static string AttNameVersion() { return ("WASP.Version"); }
 
+    //! NetCDF variable name storing the block ranges of compressed
+    //! variable \p name
+    static string VarNameRange(string name) { return (name + ".WASP.Range"); }
+
 private:
     Wasp::EasyThreads * _et;
     int                 _nthreads;
@@ -655,6 +722,11 @@ private:
     nc_type              _open_varxtype;       // external type of opened variable
     vector<Compressor *> _open_compressors;    // Compressor for opened variable
 
+    size_t _read_nblocks;    // blocks fetched by last compressed read
+    size_t _read_nbytes;     // bytes fetched by last compressed read
+    double _read_io_time;    // time spent fetching blocks
+    double _read_time;       // total time of last compressed read
+
     int _GetBlockAlignedDims(vector<string> dimnames, vector<size_t> bs, vector<string> &badimnames, vector<size_t> &badims) const;
 
     int _GetCompressedDims(vector<string> dimnames, string wname, vector<size_t> bs, vector<size_t> cratios, int xtype, vector<string> &cdimnames, vector<size_t> &cdims,
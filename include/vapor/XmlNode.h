@@ -10,6 +10,8 @@
 #include <vector>
 #include <string>
 #include <stack>
+#include <atomic>
+#include <memory>
 #include <vapor/MyBase.h>
 #ifdef WIN32
     #pragma warning(disable : 4251)
@@ -88,17 +90,29 @@ public:
     //!
     //! \retval tag A reference to the node's tag
     //
-    string &Tag() { return (_tag); }
+    string &Tag()
+    {
+        _touch();
+        return (_tag);
+    }
 
     string GetTag() const { return (_tag); }
 
-    void SetTag(string tag) { _tag = tag; }
+    void SetTag(string tag)
+    {
+        _tag = tag;
+        _touch();
+    }
 
     //! Set or get that node's attributes
     //!
     //! \retval attrs A reference to the node's attributes
     //
-    map<string, string> &Attrs() { return (_attrmap); }
+    map<string, string> &Attrs()
+    {
+        _touch();
+        return (_attrmap);
+    }
 
     // These methods set or get XML character data, possibly formatting
     // the data in the process. The paramter 'tag' identifies the XML
@@ -495,6 +509,17 @@ public:
     //!
     virtual XmlNode *GetRoot() const;
 
+    //! Return the version of the tree rooted at this node
+    //!
+    //! The version changes whenever this node, or any of its descendants,
+    //! is changed. Versions are unique across all nodes: two nodes
+    //! never have the same version, even if one is destroyed before the
+    //! other is created. Changes made through the references returned by
+    //! Tag() and Attrs() are assumed to happen when those methods are
+    //! called.
+    //
+    unsigned long GetVersion() const { return (_version); }
+
     static const std::vector<XmlNode *> &GetAllocatedNodes() { return (_allocatedNodes); }
 
     // Following is a substitute for exporting the "<<" operator in windows.
@@ -517,8 +542,17 @@ private:
     vector<XmlNode *> _children;    // node's children
     string            _tag;         // node's tag name
 
-    size_t   _asciiLimit;    // length limit beyond which element data are encoded
-    XmlNode *_parent;        // Node's parent
+    size_t        _asciiLimit;    // length limit beyond which element data are encoded
+    XmlNode *     _parent;        // Node's parent
+    unsigned long _version;       // Changes with this node or its descendants
+
+    static std::atomic<unsigned long> _versionCounter;
+
+    // Give this node and its ancestors a new version
+    //
+    void _touch();
+
+    friend class XmlSnapshotter;
 };
 // ostream& VAPoR::operator<< (ostream& os, const XmlNode& node);
 
@@ -551,6 +585,59 @@ private:
     friend void _CharDataHandler(void *userData, const char *s, int len);
 };
 
+//
+//! \class XmlSnapshotter
+//! \brief Immutable snapshots of an XmlNode tree that share unchanged
+//! subtrees
+//!
+//! Take() returns a read-only copy of a tree. Only the nodes that changed
+//! since the previous snapshot of the same tree, as told by
+//! XmlNode::GetVersion(), are copied; all others are shared with earlier
+//! snapshots. The cost of a snapshot is therefore proportional to the
+//! number of nodes changed, and the path from each of them to the root,
+//! rather than to the size of the tree. Snapshots remain valid after the
+//! tree, or the XmlSnapshotter, is destroyed.
+//
+class PARAMS_API XmlSnapshotter {
+public:
+    class Node;
+    typedef std::shared_ptr<const Node> Snapshot;
+
+    //! Take a snapshot of the tree rooted at \p root
+    //!
+    //! \param[in] root Root of the tree
+    //! \param[in] prev An earlier snapshot, usually of the same tree. Nodes
+    //! not seen by this XmlSnapshotter, for example those of a tree
+    //! reloaded from \p prev, are shared with the node at the same
+    //! position in \p prev if they are equal to it. Hence a tree equal to
+    //! \p prev gives a snapshot equal to \p prev.
+    //
+    Snapshot Take(const XmlNode *root, const Snapshot &prev = Snapshot());
+
+    //! Return a new XmlNode tree equal to the tree that \p snapshot was
+    //! taken of. The caller owns the tree.
+    //
+    static XmlNode *Materialize(const Snapshot &snapshot);
+
+    //! Return the number of nodes in \p snapshot
+    //
+    static size_t GetNumNodes(const Snapshot &snapshot);
+
+    //! Forget the nodes seen so far. Later snapshots share nodes only with
+    //! the \p prev snapshot passed to Take().
+    //
+    void Clear() { _cache.clear(); }
+
+private:
+    // The last snapshot of each node seen, with the version of the node
+    // it was taken at
+    //
+    std::map<const XmlNode *, std::pair<unsigned long, Snapshot>> _cache;
+
+    Snapshot _take(const XmlNode *node, const Snapshot &prev);
+    void     _prune(const XmlNode *node, std::map<const XmlNode *, std::pair<unsigned long, Snapshot>> &cache) const;
+};
+
 };    // namespace VAPoR
 
 #endif    //	_XmlNode_h_
@@ -18,36 +18,37 @@
 //         are not altered while in the cache, and are properly destroyed when evicted.
 //         The cache guarantees no more than that.
 //
-// Tip:    This cache should be initialized sufficiently big so that a returned
-//         pointer won't be evicted while that pointer is in use.
-//         In other words, users need to know how many new insersions are going to happen
-//         while a queried pointer is in use, and initialize the cache to be at least
-//         that big.
-//
-//         To use an example, a `unique_ptr_cache` is initialized to hold N objects.
-//         A queried pointer `ptr` is valid at the time of query, and will remain valid until
-//         another (N-1) unique individual objects being inserted/queried.
-//         At that point, the immediate next insertion of another unique object (the N-th)
-//         will evict `ptr`, and the object it points to is destroyed, and `prt` is no longer valid.
+// Tip:    A query returns a shared pointer, which keeps the structure alive for as
+//         long as the caller holds it, even if the structure is evicted meanwhile.
+//         Evicted structures are destroyed when the last such pointer goes away,
+//         which may be on the thread of a reader rather than in the cache.
 //
 // Revision: (8/13/2020) it uses std::array<> instead of std::list<> to achieve
 //                       the highest performance with small to medium cache sizes.
 // Revision: (8/13/2020) it uses mutexes to achieve thread safety.
 // Revision: (9/29/2020) it uses std::vector<> instead of std::array<> so that the cache size
 //                       can be set dynamically at construction time.
+// Revision: (5/10/2021) queries don't take the cache mutex, so that many threads can look up
+//                       cached structures concurrently. Elements live in a fixed number of
+//                       slots of shared pointers that are read and written atomically; the
+//                       `recently used` order is kept as a per-slot time stamp. Only
+//                       insertions take the mutex. A query hands out a shared pointer,
+//                       so an evicted element lives on until no reader holds it.
 //
 // Author   : Samuel Li
 // Date     : 9/26/2019
-// Revision : 8/13/2020, 9/29/2020
+// Revision : 8/13/2020, 9/29/2020, 5/10/2021
 //-----------------------------------------------------------------------------
 
 #ifndef UNIQUE_PTR_CACHE_H
 #define UNIQUE_PTR_CACHE_H
 
 #include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
 #include <utility>    // std::pair<>
-#include <memory>     // std::unique_ptr<>
+#include <memory>     // std::unique_ptr<>, std::shared_ptr<>
 #include <mutex>
+#include <atomic>
 #include <algorithm>
 #include <vector>
 
@@ -61,7 +62,10 @@ public:
     // Constructor
     // A user needs to specify if a query is counted as `recently used`
     // by passing a boolean to the constructor.
-    unique_ptr_cache(size_t capacity, bool query) : _capacity(capacity), _query_shuffle(query) { _element_vector.reserve(_capacity); }
+    unique_ptr_cache(size_t capacity, bool query) : _capacity(capacity), _query_shuffle(query), _slots(capacity), _stamps(capacity)
+    {
+        for (size_t i = 0; i < _capacity; i++) { _stamps[i].store(0); }
+    }
     // Note: because this cache is intended to be used to keep unique pointers,
     // we don't want to allow any type of copy constructors, so delete them.
     unique_ptr_cache(const unique_ptr_cache &) = delete;
@@ -69,62 +73,102 @@ public:
     unique_ptr_cache &operator=(const unique_ptr_cache &) = delete;
     unique_ptr_cache &operator=(const unique_ptr_cache &&) = delete;
 
+    ~unique_ptr_cache() { clear(); }
+
     auto capacity() const -> size_t { return _capacity; }
 
-    auto size() const -> size_t { return _element_vector.size(); }
+    auto size() const -> size_t { return _size.load(); }
 
-    void clear() { _element_vector.clear(); }
+    // Note: structures still held by readers are destroyed when the
+    // readers release them.
+    void clear()
+    {
+        const std::lock_guard<std::mutex> lock_gd(_element_vector_mutex);
+
+        for (size_t i = 0; i < _capacity; i++) {
+            std::atomic_store_explicit(&_slots[i], element_ptr(), std::memory_order_release);
+            _stamps[i].store(0);
+        }
+        _size.store(0);
+    }
 
-    auto empty() const -> bool { return _element_vector.empty(); }
+    auto empty() const -> bool { return (size() == 0); }
 
-    auto full() const -> bool { return (_element_vector.size() >= _capacity); }
+    auto full() const -> bool { return (size() >= _capacity); }
 
     //
     // Major action function.
-    // If the key exists, it returns the unique pointer associated with the key.
-    // If the key does not exist, it returns the unique_ptr version of a nullptr.
+    // If the key exists, it returns a shared pointer to the structure associated with the key.
+    // If the key does not exist, it returns a nullptr.
+    // This function does not take the cache mutex, and is safe to call concurrently with
+    // other queries and insertions.
     //
-    auto query(const Key &key) -> const std::unique_ptr<const BigObj> &
+    auto query(const Key &key) -> std::shared_ptr<const BigObj>
     {
-        // Only need to apply the mutex if `_query_shuffle` is enabled.
-        if (_query_shuffle) const std::lock_guard<std::mutex> lock_gd(_element_vector_mutex);
-
-        auto it = std::find_if(_element_vector.begin(), _element_vector.end(), [&key](element_type &e) { return e.first == key; });
-        if (it == _element_vector.end()) {    // This key does not exist
-            return _local_nullptr;
-        } else {    // This key does exist
-            if (_query_shuffle) {
-                std::rotate(_element_vector.begin(), it, it + 1);
-                return _element_vector.front().second;
-            } else
-                return it->second;
+        for (size_t i = 0; i < _capacity; i++) {
+            element_ptr e = std::atomic_load_explicit(&_slots[i], std::memory_order_acquire);
+            if (e != nullptr && e->first == key) {
+                if (_query_shuffle) _stamps[i].store(++_clock, std::memory_order_relaxed);
+
+                // Share ownership of the element, but point at the structure
+                return std::shared_ptr<const BigObj>(e, e->second.get());
+            }
         }
+
+        return nullptr;    // This key does not exist
     }
 
-    void insert(Key key, const BigObj *ptr)
+    //
+    // Put a structure in the cache, which takes ownership of it.
+    // It returns a shared pointer to the structure, like query() does.
+    //
+    auto insert(Key key, const BigObj *ptr) -> std::shared_ptr<const BigObj>
     {
         const std::lock_guard<std::mutex> lock_gd(_element_vector_mutex);
 
-        auto it = std::find_if(_element_vector.begin(), _element_vector.end(), [&key](element_type &e) { return e.first == key; });
+        std::unique_ptr<const BigObj> tmp(ptr);
+        element_ptr                   e = std::make_shared<const element_type>(std::move(key), std::move(tmp));
+
+        std::shared_ptr<const BigObj> ret(e, e->second.get());
+        if (_capacity == 0) return ret;
 
-        if (it == _element_vector.end()) {                                          // This key does not exist
-            if (_element_vector.size() >= _capacity) _element_vector.pop_back();    // Evict the last element
-            std::unique_ptr<const BigObj> tmp(ptr);
-            _element_vector.emplace(_element_vector.begin(), std::move(key), std::move(tmp));
-        } else {    // This key does exist.
-            it->second.reset(ptr);
-            std::rotate(_element_vector.begin(), it, it + 1);
+        // Replace the element with the same key if there is one.
+        // Otherwise take an empty slot, or evict the least recently used element.
+        size_t victim = _capacity;
+        for (size_t i = 0; i < _capacity && victim == _capacity; i++) {
+            element_ptr old = std::atomic_load_explicit(&_slots[i], std::memory_order_relaxed);
+            if (old != nullptr && old->first == e->first) victim = i;
         }
+        if (victim == _capacity) {
+            victim = 0;
+            for (size_t i = 0; i < _capacity; i++) {
+                if (std::atomic_load_explicit(&_slots[i], std::memory_order_relaxed) == nullptr) {
+                    victim = i;
+                    break;
+                }
+                if (_stamps[i].load(std::memory_order_relaxed) < _stamps[victim].load(std::memory_order_relaxed)) victim = i;
+            }
+        }
+
+        _stamps[victim].store(++_clock, std::memory_order_relaxed);
+        element_ptr old = std::atomic_exchange_explicit(&_slots[victim], e, std::memory_order_acq_rel);
+        if (old == nullptr) _size++;
+
+        // `old`, if any, is destroyed here unless a reader still holds it
+        return ret;
     }
 
 private:
     using element_type = std::pair<Key, std::unique_ptr<const BigObj>>;
-
-    const size_t                        _capacity;
-    const bool                          _query_shuffle;
-    std::vector<element_type>           _element_vector;
-    const std::unique_ptr<const BigObj> _local_nullptr = {nullptr};
-    std::mutex                          _element_vector_mutex;
+    using element_ptr = std::shared_ptr<const element_type>;
+
+    const size_t                       _capacity;
+    const bool                         _query_shuffle;
+    std::vector<element_ptr>           _slots;     // read and written with std::atomic_load/store()
+    std::vector<std::atomic<uint64_t>> _stamps;    // `recently used` time of each slot
+    std::atomic<uint64_t>              _clock = {0};
+    std::atomic<size_t>                _size = {0};
+    std::mutex                         _element_vector_mutex;
 };
 }    // namespace VAPoR
 
@@ -138,6 +138,48 @@ COMMON_API void Transpose(const float *a, float *b, size_t s1, size_t s2);
 //
 COMMON_API bool BinarySearchRange(const std::vector<double> &sorted, double x, size_t &i);
 
+// As above, but the 'n' sorted values are returned by 'sorted(k)', which
+// is only called for the O(log n) values the search visits. Finds the same
+// interval as the vector version.
+//
+template<typename Func> bool BinarySearchRange(size_t n, const Func &sorted, double x, size_t &i)
+{
+    i = 0;
+    if (n == 0) return (false);
+
+    double first = sorted(0);
+    if (n == 1) return (first == x);
+
+    double last = sorted(n - 1);
+    bool   ascending = first <= last;
+    if (ascending && x < first) return (false);
+    if (x < last && !ascending) return (false);
+
+    if (x == last) {
+        i = n - 2;
+        return (true);
+    }
+
+    // Find the end of the leading run of values that are <= x (ascending)
+    // or >= x (descending)
+    //
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        double v = sorted(mid);
+        if (ascending ? v <= x : v >= x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (ascending && lo == n) return (false);
+    if (!ascending && lo == 0) return (false);
+
+    i = lo > 0 ? lo - 1 : 0;
+    return (true);
+}
+
 //! Floating point comparison for near equality.
 //!
 //! Perform a floating point comparison to see if two values are nearly equal;
@@ -10,7 +10,10 @@
 #include <iostream>
 #include <sstream>
 
+#include <mutex>
+
 #include <vapor/MyBase.h>
+#include <vapor/Trace.h>
 #ifdef WIN32
     #pragma warning(disable : 4996)
     #include "windows.h"
@@ -65,6 +68,31 @@ void (*MyBase::DiagMsgCB)(const char *msg) = NULL;
 
 bool MyBase::Enabled = true;
 
+namespace {
+thread_local bool threadEnabled = true;
+};
+
+bool MyBase::EnableThreadErrMsg(bool enable)
+{
+    bool prev = threadEnabled;
+    threadEnabled = enable;
+    return (prev);
+}
+
+namespace {
+
+// The error and diagnostic message buffers are shared by all threads. The
+// mutex is recursive because the message callbacks may report messages
+// themselves.
+//
+std::recursive_mutex &msg_mutex()
+{
+    static std::recursive_mutex m;
+    return (m);
+}
+
+};    // namespace
+
 MyBase::MyBase() { SetClassName("MyBase"); }
 
 void MyBase::_SetErrMsg(char **msgbuf, int *msgbufsz, const char *format, va_list args)
@@ -121,7 +149,10 @@ void MyBase::SetErrMsg(const char *format, ...)
 {
     va_list args;    // initialize to make valgrind shutup
 
-    if (!Enabled) return;
+    if (!Enabled || !threadEnabled) return;
+
+    std::lock_guard<std::recursive_mutex> lock(msg_mutex());
+
     ErrCode = 1;
 
     va_start(args, format);
@@ -137,7 +168,10 @@ void MyBase::SetErrMsg(int errcode, const char *format, ...)
 {
     va_list args;    // initialize to make valgrind shutup
 
-    if (!Enabled) return;
+    if (!Enabled || !threadEnabled) return;
+
+    std::lock_guard<std::recursive_mutex> lock(msg_mutex());
+
     ErrCode = errcode;
 
     va_start(args, format);
@@ -149,14 +183,25 @@ void MyBase::SetErrMsg(int errcode, const char *format, ...)
     if (ErrMsgFilePtr) { (void)fprintf(ErrMsgFilePtr, "%s\n", ErrMsg); }
 }
 
+bool MyBase::DiagMsgEnabled() { return (DiagMsgCB || DiagMsgFilePtr || Trace::Enabled(Trace::Debug)); }
+
 void MyBase::SetDiagMsg(const char *format, ...)
 {
     va_list args;    // initialize to make valgrind shutup
 
+    // Don't format messages nobody reads: this is called on hot paths
+    //
+    if (!DiagMsgEnabled()) return;
+    bool traced = Trace::Enabled(Trace::Debug);
+
+    std::lock_guard<std::recursive_mutex> lock(msg_mutex());
+
     va_start(args, format);
     _SetErrMsg(&DiagMsg, &DiagMsgSize, format, args);
     va_end(args);
 
+    if (traced) Trace::MessageString(Trace::Debug, DiagMsg);
+
     if (DiagMsgCB) (*DiagMsgCB)(DiagMsg);
 
     if (DiagMsgFilePtr) { (void)fprintf(DiagMsgFilePtr, "%s\n", DiagMsg); }
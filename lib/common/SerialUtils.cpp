@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifdef WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+#include <vapor/SerialUtils.h>
+
+using namespace std;
+using namespace Wasp;
+
+void SerialUtils::WriteU64(ostream &o, uint64_t v) { o.write((const char *)&v, sizeof(v)); }
+
+bool SerialUtils::ReadU64(istream &i, uint64_t &v)
+{
+    i.read((char *)&v, sizeof(v));
+    return ((bool)i);
+}
+
+void SerialUtils::WriteString(ostream &o, const string &s)
+{
+    WriteU64(o, s.size());
+    o.write(s.data(), s.size());
+}
+
+bool SerialUtils::ReadString(istream &i, string &s)
+{
+    uint64_t n;
+    if (!ReadU64(i, n)) return (false);
+    if (n > (1ULL << 30)) return (false);    // Corrupt
+
+    s.resize(n);
+    if (n) i.read(&s[0], n);
+    return ((bool)i);
+}
+
+void SerialUtils::WriteStrings(ostream &o, const vector<string> &v)
+{
+    WriteU64(o, v.size());
+    for (size_t i = 0; i < v.size(); i++) WriteString(o, v[i]);
+}
+
+bool SerialUtils::ReadStrings(istream &i, vector<string> &v)
+{
+    uint64_t n;
+    if (!ReadU64(i, n)) return (false);
+
+    v.clear();
+    for (uint64_t j = 0; j < n; j++) {
+        string s;
+        if (!ReadString(i, s)) return (false);
+        v.push_back(s);
+    }
+    return (true);
+}
+
+int SerialUtils::WriteFileAtomic(const string &path, const function<bool(ostream &)> &write)
+{
+    // The process id keeps other processes away from our temporary file,
+    // and the thread id and counter keep other threads of this process away
+    //
+    static atomic<unsigned> counter(0);
+
+    ostringstream tmp;
+#ifdef WIN32
+    tmp << path << "." << _getpid();
+#else
+    tmp << path << "." << getpid();
+#endif
+    tmp << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << "." << counter++ << ".tmp";
+
+    {
+        ofstream out(tmp.str().c_str(), ios::out | ios::binary | ios::trunc);
+        if (!out) return (-1);
+
+        bool ok = write(out);
+        out.close();
+        if (!ok || !out) {
+            (void)remove(tmp.str().c_str());
+            return (-1);
+        }
+    }
+
+#ifdef WIN32
+    (void)remove(path.c_str());
+#endif
+    if (rename(tmp.str().c_str(), path.c_str()) != 0) {
+        (void)remove(tmp.str().c_str());
+        return (-1);
+    }
+    return (0);
+}
+
+uint64_t SerialUtils::FNV1a(const void *data, size_t n, uint64_t h)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return (h);
+}
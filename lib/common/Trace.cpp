@@ -0,0 +1,316 @@
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vapor/MyBase.h>
+#include <vapor/Trace.h>
+
+using namespace Wasp;
+
+namespace {
+
+// The initial level may be set with the VAPOR_TRACE environment variable
+//
+int initial_level()
+{
+    const char *s = getenv("VAPOR_TRACE");
+    return (s ? atoi(s) : Trace::Off);
+}
+
+const size_t msgSize = 96;
+
+struct event_t {
+    int64_t     start;
+    int64_t     dur;
+    const char *name;    // span name, or nullptr for a message
+    int         level;
+    char        msg[msgSize];
+};
+
+// At most this many buffers of threads that have exited are kept while
+// their events haven't been written out. Past it, new threads reuse the
+// oldest of them, dropping its events.
+//
+const size_t maxExited = 16;
+
+// The events of one thread. The mutex is only contended while the events
+// are written out.
+//
+struct thread_buffer_t {
+    std::mutex           mutex;
+    std::vector<event_t> events;
+    size_t               next = 0;    // where the next event goes
+    size_t               count = 0;   // number of events kept
+    int                  tid = 0;
+
+    // Guarded by the registry's mutex
+    //
+    bool live = true;        // its thread is still running
+    bool written = false;    // its events were written out after its thread exited
+};
+
+struct registry_t {
+    std::mutex                                                     mutex;
+    std::vector<std::unique_ptr<thread_buffer_t>>                  buffers;
+    size_t                                                         bufferSize = 16384;
+    int                                                            nextTid = 0;
+    std::map<std::string, std::unique_ptr<std::atomic<int64_t>>> counters;
+    const std::chrono::steady_clock::time_point                    start = std::chrono::steady_clock::now();
+};
+
+registry_t &registry()
+{
+    static registry_t r;
+    return (r);
+}
+
+// Hand the calling thread a buffer. Buffers are owned by the registry, so
+// that the events of threads that have exited can still be written out.
+// The buffer of an exited thread is reused once it has no events left to
+// write, or once too many exited threads are waiting.
+//
+thread_buffer_t *acquire_buffer()
+{
+    registry_t &                r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    thread_buffer_t *buffer = nullptr;
+    thread_buffer_t *oldest = nullptr;
+    size_t           nexited = 0;
+    for (auto &b : r.buffers) {
+        if (b->live) continue;
+        if (b->count == 0 || b->written) {
+            buffer = b.get();
+            break;
+        }
+        if (!oldest) oldest = b.get();
+        nexited++;
+    }
+    if (!buffer && nexited >= maxExited) buffer = oldest;
+
+    if (!buffer) {
+        r.buffers.emplace_back(new thread_buffer_t);
+        buffer = r.buffers.back().get();
+    }
+
+    // A reused buffer gives its memory back if the size has changed
+    //
+    std::lock_guard<std::mutex> tblock(buffer->mutex);
+    if (buffer->events.size() != r.bufferSize) std::vector<event_t>(r.bufferSize).swap(buffer->events);
+    buffer->next = 0;
+    buffer->count = 0;
+    buffer->tid = r.nextTid++;
+    buffer->live = true;
+    buffer->written = false;
+    return (buffer);
+}
+
+// Releases the buffer when its thread exits
+//
+struct buffer_owner_t {
+    thread_buffer_t *buffer = nullptr;
+
+    ~buffer_owner_t()
+    {
+        if (!buffer) return;
+        registry_t &                r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->live = false;
+    }
+};
+
+// The buffer of the calling thread, acquired on first use
+//
+thread_buffer_t &thread_buffer()
+{
+    static thread_local buffer_owner_t owner;
+    if (!owner.buffer) owner.buffer = acquire_buffer();
+    return (*owner.buffer);
+}
+
+event_t &new_event(thread_buffer_t &tb)
+{
+    event_t &e = tb.events[tb.next];
+    tb.next = (tb.next + 1) % tb.events.size();
+    if (tb.count < tb.events.size()) tb.count++;
+    return (e);
+}
+
+void write_json_string(std::ostream &o, const char *s)
+{
+    o << '"';
+    for (; *s; s++) {
+        char c = *s;
+        if (c == '"' || c == '\\') {
+            o << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            o << buf;
+        } else {
+            o << c;
+        }
+    }
+    o << '"';
+}
+
+};    // namespace
+
+std::atomic<int> Trace::_level(initial_level());
+
+void Trace::SetBufferSize(size_t n)
+{
+    registry_t &                r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.bufferSize = n > 0 ? n : 1;
+}
+
+void Trace::Message(int level, const char *format, ...)
+{
+    if (!Enabled(level)) return;
+
+    char    msg[msgSize];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(msg, sizeof(msg), format, args);
+    va_end(args);
+
+    MessageString(level, msg);
+}
+
+void Trace::MessageString(int level, const char *msg)
+{
+    if (!Enabled(level)) return;
+
+    int64_t          now = Now();
+    thread_buffer_t &tb = thread_buffer();
+
+    std::lock_guard<std::mutex> lock(tb.mutex);
+    event_t &                   e = new_event(tb);
+    e.start = now;
+    e.dur = 0;
+    e.name = nullptr;
+    e.level = level;
+    strncpy(e.msg, msg, msgSize - 1);
+    e.msg[msgSize - 1] = '\0';
+}
+
+void Trace::Span(const char *name, int64_t start, int64_t end)
+{
+    thread_buffer_t &tb = thread_buffer();
+
+    std::lock_guard<std::mutex> lock(tb.mutex);
+    event_t &                   e = new_event(tb);
+    e.start = start;
+    e.dur = end - start;
+    e.name = name;
+    e.level = Info;
+}
+
+int64_t Trace::Now() { return (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - registry().start).count()); }
+
+std::atomic<int64_t> &Trace::GetCounter(const std::string &name)
+{
+    registry_t &                r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    auto &counter = r.counters[name];
+    if (!counter) counter.reset(new std::atomic<int64_t>(0));
+    return (*counter);
+}
+
+std::map<std::string, int64_t> Trace::GetCounters()
+{
+    registry_t &                r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::map<std::string, int64_t> values;
+    for (const auto &c : r.counters) values[c.first] = c.second->load(std::memory_order_relaxed);
+    return (values);
+}
+
+void Trace::Clear()
+{
+    registry_t &                r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    for (auto &tb : r.buffers) {
+        std::lock_guard<std::mutex> tblock(tb->mutex);
+        tb->next = 0;
+        tb->count = 0;
+    }
+    for (auto &c : r.counters) c.second->store(0, std::memory_order_relaxed);
+}
+
+int Trace::WriteChromeTrace(const std::string &path)
+{
+    std::ofstream out(path.c_str());
+    if (!out) {
+        MyBase::SetErrMsg("Could not open file \"%s\" : %M", path.c_str());
+        return (-1);
+    }
+
+    // Copy the events out, oldest first, so that the threads aren't held
+    // up while they are written. The buffers of exited threads may then be
+    // reused.
+    //
+    struct thread_events_t {
+        int                  tid;
+        std::vector<event_t> events;
+    };
+    std::vector<thread_events_t> threads;
+    {
+        registry_t &                r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto &tb : r.buffers) {
+            std::lock_guard<std::mutex> tblock(tb->mutex);
+            if (!tb->count) continue;
+
+            threads.push_back(thread_events_t{tb->tid, std::vector<event_t>()});
+            size_t n = tb->events.size();
+            for (size_t i = 0; i < tb->count; i++) threads.back().events.push_back(tb->events[(tb->next + n - tb->count + i) % n]);
+            if (!tb->live) tb->written = true;
+        }
+    }
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto &t : threads) {
+        for (const auto &e : t.events) {
+            if (!first) out << ",\n";
+            first = false;
+
+            out << "{\"name\":";
+            write_json_string(out, e.name ? e.name : e.msg);
+            if (e.name) {
+                out << ",\"ph\":\"X\",\"dur\":" << e.dur;
+            } else {
+                out << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"level\":" << e.level << "}";
+            }
+            out << ",\"cat\":\"vapor\",\"ts\":" << e.start << ",\"pid\":1,\"tid\":" << t.tid << "}";
+        }
+    }
+
+    int64_t now = Now();
+    for (const auto &c : GetCounters()) {
+        if (!first) out << ",\n";
+        first = false;
+
+        out << "{\"name\":";
+        write_json_string(out, c.first.c_str());
+        out << ",\"ph\":\"C\",\"ts\":" << now << ",\"pid\":1,\"args\":{\"value\":" << c.second << "}}";
+    }
+    out << "\n]}\n";
+
+    out.close();
+    if (!out) {
+        MyBase::SetErrMsg("Error writing file \"%s\" : %M", path.c_str());
+        return (-1);
+    }
+    return (0);
+}
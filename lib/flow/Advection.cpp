@@ -2,6 +2,11 @@
 #include "vapor/Advection.h"
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <limits>
+#include <cmath>
 
 using namespace flow;
 
@@ -14,19 +19,90 @@ Advection::Advection() : _lowerAngle(3.0f), _upperAngle(15.0f)
     for (int i = 0; i < 3; i++) { _isPeriodic[i] = false; }
 }
 
+void Advection::SetNumberOfThreads(size_t n) { _nThreads = n; }
+
+void Advection::SetTolerances(double absTol, double relTol)
+{
+    _absTol = absTol;
+    _relTol = relTol;
+}
+
+void Advection::SetBoxTolerance(double tol, const std::vector<double> &minExt, const std::vector<double> &maxExt)
+{
+    double size = 0.0;
+    for (size_t i = 0; i < minExt.size() && i < maxExt.size(); i++) size = std::max(size, maxExt[i] - minExt[i]);
+    SetTolerances(tol * size, 0.0);
+}
+
+size_t Advection::GetNumberOfThreads() const
+{
+    if (_nThreads > 0) return _nThreads;
+
+    size_t n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+bool Advection::_parallelForStreams(const std::function<bool(size_t)> &func) const
+{
+    const size_t numStreams = _trajectories.GetNumberOfStreams();
+    const size_t numThreads = std::min(GetNumberOfThreads(), numStreams);
+    if (numThreads < 2) {
+        bool happened = false;
+        for (size_t i = 0; i < numStreams; i++) happened |= func(i);
+        return happened;
+    }
+
+    // Streams are handed out in small chunks on a first-come, first-served basis,
+    // because some streams terminate early and others run the full number of steps.
+    // Every stream is processed by exactly one thread, so the result of each stream
+    // does not depend on the number of threads.
+    const size_t        chunk = 16;
+    std::atomic<size_t> next(0);
+    std::atomic<bool>   happened(false);
+    auto                worker = [&]() {
+        bool any = false;
+        for (size_t begin = next.fetch_add(chunk); begin < numStreams; begin = next.fetch_add(chunk)) {
+            size_t end = std::min(begin + chunk, numStreams);
+            for (size_t i = begin; i < end; i++) any |= func(i);
+        }
+        if (any) happened = true;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t t = 1; t < numThreads; t++) threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads) t.join();
+
+    return happened;
+}
+
 void Advection::UseSeedParticles(const std::vector<Particle> &seeds)
 {
-    _streams.clear();
-    _streams.resize(seeds.size());
-    for (size_t i = 0; i < seeds.size(); i++) _streams[i].push_back(seeds[i]);
+    _trajectories._reset(seeds);
 
     _separatorCount.assign(seeds.size(), 0);
+
+    // The seeds themselves are the first frontier, which is never dropped.
+    _frontiers.clear();
+    _recordFrontier(std::numeric_limits<double>::lowest());
+}
+
+void Advection::_recordFrontier(double time)
+{
+    _frontiers.emplace_back();
+    auto &f = _frontiers.back();
+    f.time = time;
+    f.separatorCounts = _separatorCount;
+    f.sizes = _trajectories._sizes;
+    f.lastLocations.resize(f.sizes.size());
+    for (size_t i = 0; i < f.sizes.size(); i++) f.lastLocations[i] = _trajectories._locations[_trajectories._offsets[i] + f.sizes[i] - 1];
 }
 
 int Advection::CheckReady() const
 {
-    for (const auto &s : _streams) {
-        if (s.size() < 1) return NO_SEED_PARTICLE_YET;
+    for (size_t i = 0; i < _trajectories.GetNumberOfStreams(); i++) {
+        if (_trajectories.GetStreamSize(i) < 1) return NO_SEED_PARTICLE_YET;
     }
 
     return 0;
@@ -36,142 +112,170 @@ int Advection::AdvectSteps(Field *velocity, double deltaT, size_t maxSteps, ADVE
 {
     int ready = CheckReady();
     if (ready != 0) return ready;
-    bool happened = false;
 
     // Observation: user parameters are not gonna change while this function executes.
     // Action: lock these parameters.
     if (velocity->LockParams() != 0) return PARAMS_ERROR;
 
-    // The particle advection process can be parallelized per particle
-    // Each stream represents a trajectory for a single particle
-    // #pragma omp parallel for
-    for (size_t streamIdx = 0; streamIdx < _streams.size(); streamIdx++) {
-        auto & s = _streams[streamIdx];
-        size_t numberOfSteps = s.size() - _separatorCount[streamIdx];
-        while (numberOfSteps < maxSteps) {
-            auto &past0 = s.back();
-            if (past0.IsSpecial())    // If the last particle is marked "special,"
-                break;                // terminate stream immediately.
-
-            double dt = deltaT;
-            if (s.size() > 2)    // If there are at least 3 particles in the stream and
-            {                    // neither is a separator, we also adjust *dt*
-                const auto &past1 = s[s.size() - 2];
-                const auto &past2 = s[s.size() - 3];
-                if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
-                    // We enforce a factor of 20.0f as a limit of how much the step size
-                    // can be adjusted by _calcAdjustFactor().
-                    // I.e., the adjusted value can be at most 20X larger or 20X smaller.
-                    // The choice of 20.0f is just an empirical value that seems to work well.
-                    double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
-                    dt = past0.time - past1.time;    // step size used by last integration
-                    dt *= _calcAdjustFactor(past2, past1, past0);
-                    if (dt > 0)    // integrate forward
-                        dt = glm::clamp(dt, mindt, maxdt);
-                    else    // integrate backward
-                        dt = glm::clamp(dt, maxdt, mindt);
-                }
-            }
+    // New particles leave the existing properties incomplete
+    _trajectories._clearProperties();
+
+    // The particle advection process is parallelized per stream, since
+    // each stream represents a trajectory for a single particle.
+    // Each stream is advected in a private copy of its last few particles,
+    // which is then written back to the shared trajectories.
+    std::mutex mutex;
+    bool       happened = _parallelForStreams([&](size_t streamIdx) {
+        std::vector<Particle> s;
+        size_t                n, base;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            n = _trajectories._loadTail(streamIdx, 3, s);
+            base = _trajectories.GetStreamSize(streamIdx) - n;
+        }
+        bool h = _advectStreamSteps(velocity, streamIdx, base, s, deltaT, maxSteps, method);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        _trajectories._storeTail(streamIdx, n, s);
+        return h;
+    });
+    _trajectories._compact();
 
-            Particle p1;
-            int      rv = 0;
-            switch (method) {
-            case ADVECTION_METHOD::EULER: rv = _advectEuler(velocity, past0, dt, p1); break;
-            case ADVECTION_METHOD::RK4: rv = _advectRK4(velocity, past0, dt, p1); break;
+    velocity->UnlockParams();
+
+    if (happened)
+        return ADVECT_HAPPENED;
+    else
+        return NO_ADVECT_HAPPENED;
+}
+
+bool Advection::_advectStreamSteps(Field *velocity, size_t streamIdx, size_t base, std::vector<Particle> &s, double deltaT, size_t maxSteps, ADVECTION_METHOD method)
+{
+    bool      happened = false;
+    size_t    numberOfSteps = base + s.size() - _separatorCount[streamIdx];
+    RK45State rk45;
+    while (numberOfSteps < maxSteps) {
+        auto &past0 = s.back();
+        if (past0.IsSpecial())    // If the last particle is marked "special,"
+            break;                // terminate stream immediately.
+
+        double dt = deltaT;
+        if (method == ADVECTION_METHOD::RK45) {
+            // RK45 picks its own step size from the error of the last step
+            if (rk45.nextDt != 0.0) dt = rk45.nextDt;
+        } else if (s.size() > 2)    // If there are at least 3 particles in the stream and
+        {                           // neither is a separator, we also adjust *dt*
+            const auto &past1 = s[s.size() - 2];
+            const auto &past2 = s[s.size() - 3];
+            if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
+                // We enforce a factor of 20.0f as a limit of how much the step size
+                // can be adjusted by _calcAdjustFactor().
+                // I.e., the adjusted value can be at most 20X larger or 20X smaller.
+                // The choice of 20.0f is just an empirical value that seems to work well.
+                double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
+                dt = past0.time - past1.time;    // step size used by last integration
+                dt *= _calcAdjustFactor(past2, past1, past0);
+                if (dt > 0)    // integrate forward
+                    dt = glm::clamp(dt, mindt, maxdt);
+                else    // integrate backward
+                    dt = glm::clamp(dt, maxdt, mindt);
             }
+        }
 
-            if (rv == 0) {    // Advection successful!
-                // The new particle *may* be the same as the old particle in case
-                // there's a sink, meaning the velocity is zero.
-                // In that case, we mark p1 as "special" and terminate the current stream.
-                if (p1.location == past0.location) {
-                    p1.SetSpecial(true);
-                    s.emplace_back(p1);
-                    _separatorCount[streamIdx]++;
-                    break;
-                } else {
-                    happened = true;
-                    s.emplace_back(p1);
-                    numberOfSteps++;
-                }
-            } else if (rv == MISSING_VAL) {
-                // This is the annoying part: there are multiple possiblities.
-                // 1) past0 is really located at a missing value location;
-                // 2) past0 is inside the volume, but really close to the boundary,
-                //    causing RK4 method to fail;
-                // 3) past0 is not at a missing location, but out of the volume.
-                //
-                // Note that we need to detect and deal with each of these possibilities
-                //   here instead of using the periodic capabilities of a grid class,
-                //   because the advection code needs to have knowledge when a pathline
-                //   exits from one side and comes back from another sice, and record
-                //   this event by inserting a separator. The separator will later be used
-                //   by the rendering code to break a pathline into segments.
-
-                glm::vec3 vel;
-                bool      isMissing = (velocity->GetVelocity(past0.time, past0.location, vel) == MISSING_VAL);
-                bool      isInside = velocity->InsideVolumeVelocity(past0.time, past0.location);
-
-                if (isInside && isMissing) {    // Case 1)
-                    // We identified a particle at a bad location.
-                    // We mark it as special, and terminate the current stream.
+        Particle p1;
+        int      rv = 0;
+        switch (method) {
+        case ADVECTION_METHOD::EULER: rv = _advectEuler(velocity, past0, dt, p1); break;
+        case ADVECTION_METHOD::RK4: rv = _advectRK4(velocity, past0, dt, p1); break;
+        case ADVECTION_METHOD::RK45: rv = _advectRK45(velocity, past0, dt, deltaT, rk45, p1); break;
+        }
+
+        if (rv == 0) {    // Advection successful!
+            // The new particle *may* be the same as the old particle in case
+            // there's a sink, meaning the velocity is zero.
+            // In that case, we mark p1 as "special" and terminate the current stream.
+            if (p1.location == past0.location) {
+                p1.SetSpecial(true);
+                s.emplace_back(p1);
+                _separatorCount[streamIdx]++;
+                break;
+            } else {
+                happened = true;
+                s.emplace_back(p1);
+                numberOfSteps++;
+            }
+        } else if (rv == MISSING_VAL) {
+            // This is the annoying part: there are multiple possiblities.
+            // 1) past0 is really located at a missing value location;
+            // 2) past0 is inside the volume, but really close to the boundary,
+            //    causing RK4 method to fail;
+            // 3) past0 is not at a missing location, but out of the volume.
+            //
+            // Note that we need to detect and deal with each of these possibilities
+            //   here instead of using the periodic capabilities of a grid class,
+            //   because the advection code needs to have knowledge when a pathline
+            //   exits from one side and comes back from another sice, and record
+            //   this event by inserting a separator. The separator will later be used
+            //   by the rendering code to break a pathline into segments.
+
+            glm::vec3 vel;
+            bool      isMissing = (velocity->GetVelocity(past0.time, past0.location, vel) == MISSING_VAL);
+            bool      isInside = velocity->InsideVolumeVelocity(past0.time, past0.location);
+
+            if (isInside && isMissing) {    // Case 1)
+                // We identified a particle at a bad location.
+                // We mark it as special, and terminate the current stream.
+                past0.SetSpecial(true);
+                _separatorCount[streamIdx]++;
+                break;
+            } else if (isInside && (!isMissing)) {    // Case 2)
+                // Use Euler advection for this particle.
+                rv = _advectEuler(velocity, past0, dt, p1);
+                assert(rv == 0);
+                s.emplace_back(p1);
+                numberOfSteps++;
+            } else {    // Case 3)
+                // We identified a particle that's out of the volume.
+                // We treat it depending on field periodicity.
+                // In case of no periodicity, we mark this particle special and
+                //    terminate the current stream.
+                // In case of periodicity enabled, we apply it!
+                if ((!_isPeriodic[0]) && (!_isPeriodic[1]) && (!_isPeriodic[2])) {
                     past0.SetSpecial(true);
                     _separatorCount[streamIdx]++;
                     break;
-                } else if (isInside && (!isMissing)) {    // Case 2)
-                    // Use Euler advection for this particle.
-                    rv = _advectEuler(velocity, past0, dt, p1);
-                    assert(rv == 0);
-                    s.emplace_back(p1);
-                    numberOfSteps++;
-                } else {    // Case 3)
-                    // We identified a particle that's out of the volume.
-                    // We treat it depending on field periodicity.
-                    // In case of no periodicity, we mark this particle special and
-                    //    terminate the current stream.
-                    // In case of periodicity enabled, we apply it!
-                    if ((!_isPeriodic[0]) && (!_isPeriodic[1]) && (!_isPeriodic[2])) {
+                } else {
+                    auto loc = past0.location;
+                    for (int i = 0; i < 3; i++) {
+                        if (_isPeriodic[i]) loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
+                    }
+
+                    // Notice that loc isn't guaranteed to be inside the volume right now,
+                    // since periodic ain't enabled for all directions.
+                    // As a result, we need to test again
+                    if (velocity->InsideVolumeVelocity(past0.time, loc)) {
+                        past0.location = loc;
+                        Particle separator;
+                        separator.SetSpecial(true);
+                        auto it = s.end();
+                        --it;
+                        s.insert(it, std::move(separator));
+                        _separatorCount[streamIdx]++;
+                    } else {
                         past0.SetSpecial(true);
                         _separatorCount[streamIdx]++;
                         break;
-                    } else {
-                        auto loc = past0.location;
-                        for (int i = 0; i < 3; i++) {
-                            if (_isPeriodic[i]) loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
-                        }
-
-                        // Notice that loc isn't guaranteed to be inside the volume right now,
-                        // since periodic ain't enabled for all directions.
-                        // As a result, we need to test again
-                        if (velocity->InsideVolumeVelocity(past0.time, loc)) {
-                            past0.location = loc;
-                            Particle separator;
-                            separator.SetSpecial(true);
-                            auto it = s.end();
-                            --it;
-                            s.insert(it, std::move(separator));
-                            _separatorCount[streamIdx]++;
-                        } else {
-                            past0.SetSpecial(true);
-                            _separatorCount[streamIdx]++;
-                            break;
-                        }
                     }
                 }
+            }
 
-            }       // end (rv == MISSING_VAL) condition
-            else    // Advection wasn't successful for other reasons
-                break;
-
-        }    // end loop for particle
-    }        // end loop for streams
+        }       // end (rv == MISSING_VAL) condition
+        else    // Advection wasn't successful for other reasons
+            break;
 
-    velocity->UnlockParams();
+    }    // end loop for particle
 
-    if (happened)
-        return ADVECT_HAPPENED;
-    else
-        return NO_ADVECT_HAPPENED;
+    return happened;
 }
 
 int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, double targetT, ADVECTION_METHOD method)
@@ -179,136 +283,188 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
     int ready = CheckReady();
     if (ready != 0) return ready;
 
-    bool   happened = false;
-    size_t streamIdx = 0;
-    for (auto &s : _streams)    // Process one stream at a time
-    {
-        Particle p0 = s.back();    // Start from the last particle in this stream
-        if (p0.time < startT)      // Skip this stream if it didn't advance to startT
-            continue;
-
-        while (p0.time < targetT) {
-            // Check if the particle is inside of the volume.
-            // Wrap it along periodic dimensions if applicable.
-            if (!velocity->InsideVolumeVelocity(p0.time, p0.location)) {
-                bool locChanged = false;
-                auto itr = s.end();
-                --itr;    // pointing to the last element
-                auto loc = itr->location;
-                for (int i = 0; i < 3; i++) {
-                    if (_isPeriodic[i]) {
-                        loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
-                        locChanged = true;
-                    }
-                }
-                if (!locChanged)    // no dimension is periodic
-                    break;          // break the while loop
+    // Params are read here, once, rather than by every thread below
+    if (velocity->LockParams() != 0) return PARAMS_ERROR;
 
-                // See if the new location is inside of the volume
-                if (velocity->InsideVolumeVelocity(itr->time, loc)) {
-                    itr->location = loc;
-                    p0 = *itr;    // p0 is equal to the wrapped particle
+    // New particles leave the existing properties incomplete
+    _trajectories._clearProperties();
+
+    // Process streams in parallel; each stream is advected by one thread,
+    //   as in AdvectSteps().
+    std::mutex mutex;
+    bool       happened = _parallelForStreams([&](size_t streamIdx) {
+        std::vector<Particle> s;
+        size_t                n;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            n = _trajectories._loadTail(streamIdx, 3, s);
+        }
+        bool h = _advectStreamTillTime(velocity, streamIdx, s, startT, deltaT, targetT, method);
 
-                    Particle separator;
-                    separator.SetSpecial(true);
-                    s.insert(itr, std::move(separator));
-                    _separatorCount[streamIdx]++;
-                } else {
-                    break;    // break the while loop
-                }
+        std::lock_guard<std::mutex> lock(mutex);
+        _trajectories._storeTail(streamIdx, n, s);
+        return h;
+    });
+    _trajectories._compact();
 
-            }    // Finish of the if condition
+    velocity->UnlockParams();
 
-            double dt = deltaT;
-            if (s.size() > 2)    // If there are at least 3 particles in the stream,
-            {                    // we also adjust *dt*
-                double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
-                maxdt = glm::min(maxdt, targetT - p0.time);
-                const auto &past1 = s[s.size() - 2];
-                const auto &past2 = s[s.size() - 3];
-                if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
-                    dt = p0.time - past1.time;    // step size used by last integration
-                    dt *= _calcAdjustFactor(past2, past1, p0);
-                    dt = glm::clamp(dt, mindt, maxdt);
+    if (targetT > GetFrontierTime()) _recordFrontier(targetT);
+
+    if (happened)
+        return ADVECT_HAPPENED;
+    else
+        return 0;
+}
+
+bool Advection::_advectStreamTillTime(Field *velocity, size_t streamIdx, std::vector<Particle> &s, double startT, double deltaT, double targetT, ADVECTION_METHOD method)
+{
+    bool      happened = false;
+    RK45State rk45;
+    Particle  p0 = s.back();    // Start from the last particle in this stream
+    if (p0.time < startT)      // Skip this stream if it didn't advance to startT
+        return false;
+
+    while (p0.time < targetT) {
+        // Check if the particle is inside of the volume.
+        // Wrap it along periodic dimensions if applicable.
+        if (!velocity->InsideVolumeVelocity(p0.time, p0.location)) {
+            bool locChanged = false;
+            auto itr = s.end();
+            --itr;    // pointing to the last element
+            auto loc = itr->location;
+            for (int i = 0; i < 3; i++) {
+                if (_isPeriodic[i]) {
+                    loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
+                    locChanged = true;
                 }
             }
-
-            Particle p1;
-            int      rv = 0;
-            switch (method) {
-            case ADVECTION_METHOD::EULER: rv = _advectEuler(velocity, p0, dt, p1); break;
-            case ADVECTION_METHOD::RK4: rv = _advectRK4(velocity, p0, dt, p1); break;
+            if (!locChanged)    // no dimension is periodic
+                break;          // break the while loop
+
+            // See if the new location is inside of the volume
+            if (velocity->InsideVolumeVelocity(itr->time, loc)) {
+                itr->location = loc;
+                p0 = *itr;    // p0 is equal to the wrapped particle
+
+                Particle separator;
+                separator.SetSpecial(true);
+                s.insert(itr, std::move(separator));
+                _separatorCount[streamIdx]++;
+            } else {
+                break;    // break the while loop
             }
-            if (rv != 0)    // Advection wasn't successful for some reason...
-            {
-                break;
-            } else    // Advection successful, keep the new particle.
-            {
-                happened = true;
-                s.push_back(p1);
-                p0 = std::move(p1);
+
+        }    // Finish of the if condition
+
+        double dt = deltaT;
+        if (method == ADVECTION_METHOD::RK45) {
+            // RK45 picks its own step size from the error of the last step,
+            //   but doesn't step past targetT.
+            if (rk45.nextDt != 0.0) dt = rk45.nextDt;
+            dt = std::min(dt, targetT - p0.time);
+        } else if (s.size() > 2)    // If there are at least 3 particles in the stream,
+        {                           // we also adjust *dt*
+            double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
+            maxdt = glm::min(maxdt, targetT - p0.time);
+            const auto &past1 = s[s.size() - 2];
+            const auto &past2 = s[s.size() - 3];
+            if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
+                dt = p0.time - past1.time;    // step size used by last integration
+                dt *= _calcAdjustFactor(past2, past1, p0);
+                dt = glm::clamp(dt, mindt, maxdt);
             }
-        }    // Finish the while loop to advect one particle to a time
+        }
+
+        Particle p1;
+        int      rv = 0;
+        switch (method) {
+        case ADVECTION_METHOD::EULER: rv = _advectEuler(velocity, p0, dt, p1); break;
+        case ADVECTION_METHOD::RK4: rv = _advectRK4(velocity, p0, dt, p1); break;
+        case ADVECTION_METHOD::RK45: rv = _advectRK45(velocity, p0, dt, deltaT, rk45, p1); break;
+        }
+        if (rv != 0)    // Advection wasn't successful for some reason...
+        {
+            break;
+        } else    // Advection successful, keep the new particle.
+        {
+            happened = true;
+            s.push_back(p1);
+            p0 = std::move(p1);
+        }
+    }    // Finish the while loop to advect one particle to a time
 
-        streamIdx++;
+    return happened;
+}
 
-    }    // Finish the for loop to advect all particles to a time
+double Advection::GetFrontierTime() const
+{
+    if (_frontiers.empty()) return std::numeric_limits<double>::lowest();
 
-    if (happened)
-        return ADVECT_HAPPENED;
-    else
-        return 0;
+    return _frontiers.back().time;
+}
+
+void Advection::RewindToTime(double t)
+{
+    while (_frontiers.size() > 1 && _frontiers.back().time > t) _frontiers.pop_back();
+    if (_frontiers.empty()) return;
+
+    const auto &f = _frontiers.back();
+    for (size_t i = 0; i < _trajectories.GetNumberOfStreams(); i++) {
+        size_t n = f.sizes[i];
+        if (_trajectories.GetStreamSize(i) <= n) continue;
+
+        // If the last particle of the frontier was wrapped along a periodic dimension
+        //   by the next advection, a separator now sits in its place and the particle
+        //   itself follows. Put it back, at its location before the wrap.
+        size_t last = _trajectories.GetStreamOffset(i) + n - 1;
+        if (_trajectories.IsSpecial(last) && !_trajectories.IsSpecial(last + 1)) {
+            _trajectories._copySample(last + 1, last);
+            _trajectories._locations[last] = f.lastLocations[i];
+        }
+        _trajectories._truncate(i, n);
+        _separatorCount[i] = f.separatorCounts[i];
+    }
 }
 
 int Advection::CalculateParticleValues(Field *scalar, bool skipNonZero)
 {
+    auto &t = _trajectories;
+
+    // Sample one particle, unless it's a separator or already has a value
+    auto sample = [&](size_t idx) {
+        if (t.IsSpecial(idx)) return;
+        if (skipNonZero && t._values[idx] != 0.0f) return;
+
+        float value;
+        int   rv = scalar->GetScalar(t._times[idx], t._locations[idx], value);
+        if (rv == 0)                     // The end of a stream could be outside of the volume,
+            t._values[idx] = value;      // so let's only color it when the return value is 0.
+    };
+
     // For steady fields, we calculate values one stream at a time
     if (scalar->IsSteady) {
         if (scalar->LockParams() != 0) return PARAMS_ERROR;
 
         _valueVarName = scalar->ScalarName;
 
-        for (auto &s : _streams) {
-            for (auto &p : s) {
-                // Skip this particle if it's a separator
-                if (p.IsSpecial()) continue;
-
-                // Do not evaluate this particle if its value is non-zero
-                if (skipNonZero && p.value != 0.0f) continue;
-
-                float value;
-                int   rv = scalar->GetScalar(p.time, p.location, value);
-                if (rv == 0)            // The end of a stream could be outside of the volume,
-                    p.value = value;    // so let's only color it when the return value is 0.
-            }
+        for (size_t s = 0; s < t.GetNumberOfStreams(); s++) {
+            size_t offset = t.GetStreamOffset(s);
+            for (size_t i = 0; i < t.GetStreamSize(s); i++) sample(offset + i);
         }
 
         scalar->UnlockParams();
     }
     // For unsteady fields, we calculate values at one timestep at a time
     else {
-        size_t mostSteps = 0;
-        for (auto &s : _streams) {
-            if (s.size() > mostSteps) mostSteps = s.size();
-        }
-
         _valueVarName = scalar->ScalarName;
 
+        size_t mostSteps = _mostSamples();
         for (size_t i = 0; i < mostSteps; i++) {
-            for (auto &s : _streams) {
-                if (i < s.size()) {
-                    auto &p = s[i];
-                    if (p.IsSpecial()) continue;
-
-                    // Do not evaluate this particle if its value is non-zero
-                    if (skipNonZero && p.value != 0.0f) continue;
-
-                    float val;
-                    int   rv = scalar->GetScalar(p.time, p.location, val);
-                    if (rv == 0) p.value = val;
-                }
-            }    // end of a stream
-        }        // end of all steps
+            for (size_t s = 0; s < t.GetNumberOfStreams(); s++) {
+                if (i < t.GetStreamSize(s)) sample(t.GetStreamOffset(s) + i);
+            }
+        }
     }
 
     return 0;
@@ -316,52 +472,48 @@ int Advection::CalculateParticleValues(Field *scalar, bool skipNonZero)
 
 int Advection::CalculateParticleProperties(Field *scalar)
 {
+    auto &t = _trajectories;
+
     // Test if this scalar property is already calculated.
-    if (std::find(_propertyVarNames.cbegin(), _propertyVarNames.cend(), scalar->ScalarName) != _propertyVarNames.cend()) return 0;
+    const auto &names = t.GetPropertyNames();
+    if (std::find(names.cbegin(), names.cend(), scalar->ScalarName) != names.cend()) return 0;
 
     // Proceed if there is no current scalar property
-    _propertyVarNames.emplace_back(scalar->ScalarName);
+    auto &prop = t._addProperty(scalar->ScalarName);
 
     // Test if this scalar field is the same as the one used to calculate particle values,
     //   if so, copy over the values.
     if (scalar->ScalarName == _valueVarName) {
-        for (auto &s : _streams) {
-            for (auto &p : s) { p.AttachProperty(p.value); }
+        for (size_t s = 0; s < t.GetNumberOfStreams(); s++) {
+            size_t offset = t.GetStreamOffset(s);
+            std::copy(t._values.begin() + offset, t._values.begin() + offset + t.GetStreamSize(s), prop.begin() + offset);
         }
 
         return 0;
     }
 
     // In case this property field is a brand new variable, we do the actual sampling work.
+    // At the end of a flow line, a particle might be outside of the volume.
+    // It's left as a nan in that case.
+    auto sample = [&](size_t idx) {
+        if (t.IsSpecial(idx)) return;
+        scalar->GetScalar(t._times[idx], t._locations[idx], prop[idx]);
+    };
+
     if (scalar->IsSteady) {
         if (scalar->LockParams() != 0) return PARAMS_ERROR;
 
-        for (auto &s : _streams) {
-            for (auto &p : s) {
-                if (p.IsSpecial()) continue;
-
-                // At the end of a flow line, a particle might be outside of the volume.
-                // We attach something in that case as well.
-                float val = std::nanf("1");
-                scalar->GetScalar(p.time, p.location, val);
-                p.AttachProperty(val);
-            }
+        for (size_t s = 0; s < t.GetNumberOfStreams(); s++) {
+            size_t offset = t.GetStreamOffset(s);
+            for (size_t i = 0; i < t.GetStreamSize(s); i++) sample(offset + i);
         }
-    } else {
-        size_t mostSteps = 0;
-        for (const auto &s : _streams)
-            if (s.size() > mostSteps) mostSteps = s.size();
 
+        scalar->UnlockParams();
+    } else {
+        size_t mostSteps = _mostSamples();
         for (size_t i = 0; i < mostSteps; i++) {
-            for (auto &s : _streams) {
-                if (i < s.size()) {
-                    auto &p = s[i];
-                    if (p.IsSpecial()) continue;
-
-                    float value = std::nanf("1");
-                    scalar->GetScalar(p.time, p.location, value);
-                    p.AttachProperty(value);
-                }
+            for (size_t s = 0; s < t.GetNumberOfStreams(); s++) {
+                if (i < t.GetStreamSize(s)) sample(t.GetStreamOffset(s) + i);
             }
         }
     }
@@ -369,6 +521,13 @@ int Advection::CalculateParticleProperties(Field *scalar)
     return 0;
 }
 
+size_t Advection::_mostSamples() const
+{
+    size_t mostSteps = 0;
+    for (size_t s = 0; s < _trajectories.GetNumberOfStreams(); s++) mostSteps = std::max(mostSteps, _trajectories.GetStreamSize(s));
+    return mostSteps;
+}
+
 int Advection::_advectEuler(Field *velocity, const Particle &p0, double dt, Particle &p1) const
 {
     glm::vec3 v0;
@@ -400,6 +559,82 @@ int Advection::_advectRK4(Field *velocity, const Particle &p0, double dt, Partic
     return 0;
 }
 
+int Advection::_advectRK45(Field *velocity, const Particle &p0, double dt, double deltaT, RK45State &state, Particle &p1) const
+{
+    // Dormand-Prince 5(4) coefficients.
+    // The 5th order solution is kept, and its difference to the embedded
+    //   4th order solution estimates the error of the step.
+    const float a21 = 1.0f / 5.0f;
+    const float a31 = 3.0f / 40.0f, a32 = 9.0f / 40.0f;
+    const float a41 = 44.0f / 45.0f, a42 = -56.0f / 15.0f, a43 = 32.0f / 9.0f;
+    const float a51 = 19372.0f / 6561.0f, a52 = -25360.0f / 2187.0f, a53 = 64448.0f / 6561.0f, a54 = -212.0f / 729.0f;
+    const float a61 = 9017.0f / 3168.0f, a62 = -355.0f / 33.0f, a63 = 46732.0f / 5247.0f, a64 = 49.0f / 176.0f, a65 = -5103.0f / 18656.0f;
+    const float b1 = 35.0f / 384.0f, b3 = 500.0f / 1113.0f, b4 = 125.0f / 192.0f, b5 = -2187.0f / 6784.0f, b6 = 11.0f / 84.0f;
+    const float e1 = 71.0f / 57600.0f, e3 = -71.0f / 16695.0f, e4 = 71.0f / 1920.0f, e5 = -17253.0f / 339200.0f, e6 = 22.0f / 525.0f, e7 = -1.0f / 40.0f;
+
+    // The velocity at the end of the previous step is the first stage of this one,
+    //   unless the particle was moved in between, e.g., wrapped along a periodic dimension.
+    glm::vec3 k1;
+    if (state.valid && state.time == p0.time && state.location == p0.location)
+        k1 = state.velocity;
+    else {
+        int rv = velocity->GetVelocity(p0.time, p0.location, k1);
+        if (rv != 0) return rv;
+    }
+    state.valid = false;
+
+    // As with the other methods, the step size stays within 20X of deltaT.
+    const double minDt = std::abs(deltaT) / 20.0, maxDt = std::abs(deltaT) * 20.0;
+    const glm::vec3 &x0 = p0.location;
+    while (true) {
+        float     h = float(dt);
+        glm::vec3 k2, k3, k4, k5, k6, k7;
+        int       rv;
+        rv = velocity->GetVelocity(p0.time + dt / 5.0, x0 + h * (a21 * k1), k2);
+        if (rv != 0) return rv;
+        rv = velocity->GetVelocity(p0.time + dt * 3.0 / 10.0, x0 + h * (a31 * k1 + a32 * k2), k3);
+        if (rv != 0) return rv;
+        rv = velocity->GetVelocity(p0.time + dt * 4.0 / 5.0, x0 + h * (a41 * k1 + a42 * k2 + a43 * k3), k4);
+        if (rv != 0) return rv;
+        rv = velocity->GetVelocity(p0.time + dt * 8.0 / 9.0, x0 + h * (a51 * k1 + a52 * k2 + a53 * k3 + a54 * k4), k5);
+        if (rv != 0) return rv;
+        rv = velocity->GetVelocity(p0.time + dt, x0 + h * (a61 * k1 + a62 * k2 + a63 * k3 + a64 * k4 + a65 * k5), k6);
+        if (rv != 0) return rv;
+        glm::vec3 x1 = x0 + h * (b1 * k1 + b3 * k3 + b4 * k4 + b5 * k5 + b6 * k6);
+        rv = velocity->GetVelocity(p0.time + dt, x1, k7);
+        if (rv != 0) return rv;
+
+        // Error relative to the tolerance; the step is good if it's at most 1.0.
+        glm::vec3 err = h * (e1 * k1 + e3 * k3 + e4 * k4 + e5 * k5 + e6 * k6 + e7 * k7);
+        double    ratio = 0.0;
+        for (int i = 0; i < 3; i++) {
+            double scale = _absTol + _relTol * std::max(std::abs(double(x0[i])), std::abs(double(x1[i])));
+            ratio = std::max(ratio, std::abs(double(err[i])) / scale);
+        }
+
+        // The usual controller for a 5th order method, with a safety factor of 0.9
+        double factor = ratio > 0.0 ? 0.9 * std::pow(ratio, -0.2) : 5.0;
+        factor = std::min(std::max(factor, 0.2), 5.0);
+
+        if (ratio <= 1.0 || std::abs(dt) <= minDt) {
+            p1.location = x1;
+            p1.time = p0.time + dt;
+
+            state.location = x1;
+            state.time = p1.time;
+            state.velocity = k7;
+            state.valid = true;
+            state.nextDt = std::min(std::max(std::abs(dt * factor), minDt), maxDt);
+            if (dt < 0.0) state.nextDt *= -1.0;
+            return 0;
+        }
+
+        // Reject this step, and retry with a smaller one
+        dt *= factor;
+        if (std::abs(dt) < minDt) dt = dt < 0.0 ? -minDt : minDt;
+    }
+}
+
 float Advection::_calcAdjustFactor(const Particle &p2, const Particle &p1, const Particle &p0) const
 {
     glm::vec3 p2p1 = p1.location - p2.location;
@@ -419,53 +654,49 @@ float Advection::_calcAdjustFactor(const Particle &p2, const Particle &p1, const
         return 1.0f;
 }
 
-size_t Advection::GetNumberOfStreams() const { return _streams.size(); }
+size_t Advection::GetNumberOfStreams() const { return _trajectories.GetNumberOfStreams(); }
+
+const Trajectories &Advection::GetTrajectories() const { return _trajectories; }
 
-const std::vector<Particle> &Advection::GetStreamAt(size_t i) const
+std::vector<Particle> Advection::GetStreamAt(size_t i) const
 {
-    // Since this function is almost always used together with GetNumberOfStreams(),
-    // I'm offloading the range check to std::vector.
-    return _streams.at(i);
+    std::vector<Particle> stream;
+    size_t                offset = _trajectories.GetStreamOffset(i);
+    stream.reserve(_trajectories.GetStreamSize(i));
+    for (size_t j = 0; j < _trajectories.GetStreamSize(i); j++) stream.push_back(_trajectories.GetParticle(offset + j));
+    return stream;
 }
 
 size_t Advection::GetMaxNumOfPart() const
 {
     size_t max = 0;
-    size_t idx = 0;
-    for (const auto &s : _streams) {
-        size_t num = s.size() - _separatorCount[idx];
+    for (size_t i = 0; i < _trajectories.GetNumberOfStreams(); i++) {
+        size_t num = _trajectories.GetStreamSize(i) - _separatorCount[i];
         if (num > max) max = num;
-        idx++;
     }
     return max;
 }
 
-void Advection::ClearParticleProperties()
-{
-    _propertyVarNames.clear();
-    for (auto &stream : _streams)
-        for (auto &part : stream) part.ClearProperty();
-}
+void Advection::ClearParticleProperties() { _trajectories._clearProperties(); }
 
 void Advection::RemoveParticleProperty(const std::string &varToRemove)
 {
-    auto itr = std::find(_propertyVarNames.begin(), _propertyVarNames.end(), varToRemove);
+    const auto &names = _trajectories.GetPropertyNames();
+    auto        itr = std::find(names.begin(), names.end(), varToRemove);
 
     // Do nothing if `varToRemove` does not exist
-    if (itr == _propertyVarNames.end())
-        return;
-    else {
-        auto rmI = std::distance(_propertyVarNames.begin(), itr);
-        _propertyVarNames.erase(itr);
-        for (auto &stream : _streams)
-            for (auto &part : stream) part.RemoveProperty(rmI);
-    }
+    if (itr != names.end()) _trajectories._removeProperty(std::distance(names.begin(), itr));
 }
 
 void Advection::ResetParticleValues()
 {
-    for (auto &stream : _streams)
-        for (auto &part : stream) part.value = 0.0f;
+    // Separators keep their special state
+    for (size_t s = 0; s < _trajectories.GetNumberOfStreams(); s++) {
+        size_t offset = _trajectories.GetStreamOffset(s);
+        for (size_t i = 0; i < _trajectories.GetStreamSize(s); i++) {
+            if (!_trajectories.IsSpecial(offset + i)) _trajectories._values[offset + i] = 0.0f;
+        }
+    }
 }
 
 void Advection::SetXPeriodicity(bool isPeri, float min, float max)
@@ -517,4 +748,4 @@ float Advection::_applyPeriodic(float val, float min, float max) const
 
 auto Advection::GetValueVarName() const -> std::string { return _valueVarName; }
 
-auto Advection::GetPropertyVarNames() const -> std::vector<std::string> { return _propertyVarNames; }
+auto Advection::GetPropertyVarNames() const -> std::vector<std::string> { return _trajectories.GetPropertyNames(); }
@@ -2,13 +2,12 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <iterator>    // std::distance
 #include <cctype>
 #include "vapor/AdvectionIO.h"
 #include "vapor/UDUnitsClass.h"
 #include "vapor/Proj4API.h"
 
-auto flow::OutputFlowlinesNumSteps(const Advection *adv, const char *filename, size_t numSteps, const std::string &proj4string, bool append) -> int
+auto flow::OutputFlowlinesNumSteps(const Advection *adv, const char *filename, size_t numSteps, const std::string &proj4string, bool append, size_t firstID) -> int
 {
     // First we need the infrastructure for time conversion
     VAPoR::UDUnits udunits;
@@ -46,27 +45,28 @@ auto flow::OutputFlowlinesNumSteps(const Advection *adv, const char *filename, s
     int   year, month, day, hour, minute, second;
     float cX, cY;    // converted X, Y coordinates
 
-    // Write the trajectories
-    for (size_t s_idx = 0; s_idx < adv->GetNumberOfStreams(); s_idx++) {
-        const auto &stream = adv->GetStreamAt(s_idx);
+    // Write the trajectories, reading them in place
+    const auto &traj = adv->GetTrajectories();
+    const auto *locations = traj.GetLocations();
+    const auto *times = traj.GetTimes();
+    for (size_t s_idx = 0; s_idx < traj.GetNumberOfStreams(); s_idx++) {
+        size_t begin = traj.GetStreamOffset(s_idx);
+        size_t end = begin + traj.GetStreamSize(s_idx);
 
         size_t step = 0;
-        for (const auto &p : stream) {
-            if (!p.IsSpecial()) {
+        for (size_t i = begin; i < end; i++) {
+            if (!traj.IsSpecial(i)) {
                 // Let's convert the time!
-                udunits.DecodeTime(p.time, &year, &month, &day, &hour, &minute, &second);
+                udunits.DecodeTime(times[i], &year, &month, &day, &hour, &minute, &second);
 
                 // Let's also convert geo coordinates if needed.
-                cX = p.location.x;
-                cY = p.location.y;
+                cX = locations[i].x;
+                cY = locations[i].y;
                 if (needGeoConversion) { proj4API.Transform(&cX, &cY, 1); }
 
-                std::fprintf(f, "%lu, %f, %f, %f, %4.4d-%2.2d-%2.2d_%2.2d:%2.2d:%2.2d", s_idx, cX, cY, p.location.z, year, month, day, hour, minute, second);
+                std::fprintf(f, "%lu, %f, %f, %f, %4.4d-%2.2d-%2.2d_%2.2d:%2.2d:%2.2d", s_idx + firstID, cX, cY, locations[i].z, year, month, day, hour, minute, second);
 
-                auto props = p.GetPropertyList();
-                // A quick sanity check
-                assert(std::distance(props.cbegin(), props.cend()) == propertyNames.size());
-                for (const auto &val : props) std::fprintf(f, ", %f", val);
+                for (size_t k = 0; k < propertyNames.size(); k++) std::fprintf(f, ", %f", traj.GetProperty(k)[i]);
 
                 std::fprintf(f, "\n");    // end of one line
                 step++;
@@ -81,7 +81,7 @@ auto flow::OutputFlowlinesNumSteps(const Advection *adv, const char *filename, s
     return 0;
 }
 
-auto flow::OutputFlowlinesMaxTime(const Advection *adv, const char *filename, double maxTime, const std::string &proj4string, bool append) -> int
+auto flow::OutputFlowlinesMaxTime(const Advection *adv, const char *filename, double maxTime, const std::string &proj4string, bool append, size_t firstID) -> int
 {
     // First we need the infrastructure for time conversion
     VAPoR::UDUnits udunits;
@@ -119,28 +119,29 @@ auto flow::OutputFlowlinesMaxTime(const Advection *adv, const char *filename, do
     int   year, month, day, hour, minute, second;
     float cX, cY;    // converted X, Y coordinates
 
-    // Write the trajectories
-    for (size_t s_idx = 0; s_idx < adv->GetNumberOfStreams(); s_idx++) {
-        const auto &stream = adv->GetStreamAt(s_idx);
+    // Write the trajectories, reading them in place
+    const auto &traj = adv->GetTrajectories();
+    const auto *locations = traj.GetLocations();
+    const auto *times = traj.GetTimes();
+    for (size_t s_idx = 0; s_idx < traj.GetNumberOfStreams(); s_idx++) {
+        size_t begin = traj.GetStreamOffset(s_idx);
+        size_t end = begin + traj.GetStreamSize(s_idx);
 
-        for (const auto &p : stream) {
-            if (p.time > maxTime) break;
+        for (size_t i = begin; i < end; i++) {
+            if (times[i] > maxTime) break;
 
-            if (!p.IsSpecial()) {
+            if (!traj.IsSpecial(i)) {
                 // Let's convert the time!
-                udunits.DecodeTime(p.time, &year, &month, &day, &hour, &minute, &second);
+                udunits.DecodeTime(times[i], &year, &month, &day, &hour, &minute, &second);
 
                 // Let's also convert geo coordinates if needed.
-                cX = p.location.x;
-                cY = p.location.y;
+                cX = locations[i].x;
+                cY = locations[i].y;
                 if (needGeoConversion) { proj4API.Transform(&cX, &cY, 1); }
 
-                std::fprintf(f, "%lu, %f, %f, %f, %4.4d-%2.2d-%2.2d_%2.2d:%2.2d:%2.2d", s_idx, cX, cY, p.location.z, year, month, day, hour, minute, second);
+                std::fprintf(f, "%lu, %f, %f, %f, %4.4d-%2.2d-%2.2d_%2.2d:%2.2d:%2.2d", s_idx + firstID, cX, cY, locations[i].z, year, month, day, hour, minute, second);
 
-                auto props = p.GetPropertyList();
-                // A quick sanity check
-                assert(std::distance(props.cbegin(), props.cend()) == propertyNames.size());
-                for (const auto &val : props) std::fprintf(f, ", %f", val);
+                for (size_t k = 0; k < propertyNames.size(); k++) std::fprintf(f, ", %f", traj.GetProperty(k)[i]);
 
                 std::fprintf(f, "\n");    // end of one line
             }
@@ -152,8 +153,10 @@ auto flow::OutputFlowlinesMaxTime(const Advection *adv, const char *filename, do
     return 0;
 }
 
-auto flow::InputSeedsCSV(const std::string &filename) -> std::vector<flow::Particle>
+auto flow::InputSeedsCSV(const std::string &filename, bool readTime) -> std::vector<flow::Particle>
 {
+    const size_t nValues = readTime ? 4 : 3;
+
     std::ifstream ifs(filename);
     if (!ifs.is_open()) return {};
 
@@ -170,43 +173,45 @@ auto flow::InputSeedsCSV(const std::string &filename) -> std::vector<flow::Parti
         if (line.front() == '#') continue;
 
         // Now try to parse numbers separated by comma
-        std::stringstream  ss(line);
-        std::vector<float> valFloat;
-        valFloat.reserve(3);
+        std::stringstream   ss(line);
+        std::vector<double> vals;
+        vals.reserve(nValues);
         for (std::string tmp; std::getline(ss, tmp, ',');) {
             try {
-                valFloat.push_back(std::stof(tmp));
+                vals.push_back(std::stod(tmp));
             } catch (const std::invalid_argument &e) {
                 ifs.close();
                 return {};
             }
-            if (valFloat.size() >= 3)    // we parse at most 3 values, and discard the rest of this line.
+            if (vals.size() >= nValues)    // we parse at most nValues values, and discard the rest of this line.
                 break;
         }
 
-        if (valFloat.size() < 3) {    // less than 3 values provided in this line
+        if (vals.size() < nValues) {    // less than nValues values provided in this line
             ifs.close();
             return {};    // Not accepting any seed when encountering a bad line
         }
 
-        newSeeds.emplace_back(valFloat[0], valFloat[1], valFloat[2], 0.0);
+        newSeeds.emplace_back(vals[0], vals[1], vals[2], readTime ? vals[3] : 0.0);
     }
     ifs.close();
 
-    // Let's also remove duplicate seeds.
+    // Let's also remove duplicate seeds. Seeds at the same location but different times are kept.
     auto less = [](const flow::Particle &a, const flow::Particle &b) {
         if (a.location.x != b.location.x)
             return (a.location.x < b.location.x);
         else if (a.location.y != b.location.y)
             return (a.location.y < b.location.y);
-        else
+        else if (a.location.z != b.location.z)
             return (a.location.z < b.location.z);
+        else
+            return (a.time < b.time);
     };
     std::sort(newSeeds.begin(), newSeeds.end(), less);
 
     auto equal = [](const flow::Particle &a, const flow::Particle &b) {
         auto eq = glm::equal(a.location, b.location);
-        return glm::all(eq);
+        return glm::all(eq) && a.time == b.time;
     };
     auto itr = std::unique(newSeeds.begin(), newSeeds.end(), equal);
     newSeeds.erase(itr, newSeeds.end());
@@ -0,0 +1,68 @@
+#include <random>
+#include <cassert>
+#include "vapor/RakeSeeds.h"
+
+auto flow::RakeSeedsUniform(const std::vector<float> &rake, const std::vector<long> &numOfSeeds, double time, float defaultZ) -> std::vector<flow::Particle>
+{
+    size_t dim = rake.size() / 2;
+    assert(dim == 2 || dim == 3);
+    assert(numOfSeeds.size() >= dim);
+
+    long  n[3] = {1, 1, 1};
+    float start[3], step[3];
+    for (size_t i = 0; i < dim; i++) {
+        n[i] = numOfSeeds[i];
+        step[i] = (rake[i * 2 + 1] - rake[i * 2]) / float(n[i]);
+        start[i] = rake[i * 2];
+    }
+    if (dim == 2) {
+        start[2] = defaultZ;
+        step[2] = 0.0f;
+    }
+
+    std::vector<flow::Particle> seeds;
+    seeds.reserve(n[0] * n[1] * n[2]);
+    glm::vec3 loc;
+    for (long k = 0; k < n[2]; k++) {
+        for (long j = 0; j < n[1]; j++) {
+            for (long i = 0; i < n[0]; i++) {
+                loc.x = start[0] + (float(i) + 0.5f) * step[0];
+                loc.y = start[1] + (float(j) + 0.5f) * step[1];
+                loc.z = start[2] + (float(k) + 0.5f) * step[2];
+                seeds.emplace_back(loc, time);
+            }
+        }
+    }
+    return seeds;
+}
+
+auto flow::RakeSeedsRandom(const std::vector<float> &rake, long numOfSeeds, unsigned int randSeed, double time, float defaultZ) -> std::vector<flow::Particle>
+{
+    size_t dim = rake.size() / 2;
+    assert(dim == 2 || dim == 3);
+    for (size_t i = 0; i < dim; i++) assert(rake[i * 2 + 1] >= rake[i * 2]);
+
+    // Create uniform distributions along 2 or 3 dimensions. 2D rakes draw no Z values.
+    std::mt19937                          gen(randSeed);    // Standard mersenne_twister_engine
+    std::uniform_real_distribution<float> distX(rake[0], rake[1]);
+    std::uniform_real_distribution<float> distY(rake[2], rake[3]);
+
+    std::vector<flow::Particle> seeds(numOfSeeds);
+    if (dim == 3) {
+        std::uniform_real_distribution<float> distZ(rake[4], rake[5]);
+        for (long i = 0; i < numOfSeeds; i++) {
+            seeds[i].location.x = distX(gen);
+            seeds[i].location.y = distY(gen);
+            seeds[i].location.z = distZ(gen);
+            seeds[i].time = time;
+        }
+    } else {
+        for (long i = 0; i < numOfSeeds; i++) {
+            seeds[i].location.x = distX(gen);
+            seeds[i].location.y = distY(gen);
+            seeds[i].location.z = defaultZ;
+            seeds[i].time = time;
+        }
+    }
+    return seeds;
+}
@@ -0,0 +1,160 @@
+#include "vapor/Trajectories.h"
+#include <algorithm>
+
+using namespace flow;
+
+size_t Trajectories::GetNumberOfSamples() const
+{
+    size_t n = 0;
+    for (auto s : _sizes) n += s;
+    return n;
+}
+
+Particle Trajectories::GetParticle(size_t idx) const
+{
+    Particle p;
+    p.location = _locations[idx];
+    p.time = _times[idx];
+    p.value = _values[idx];
+    for (const auto &prop : _properties) p.AttachProperty(prop[idx]);
+    return p;
+}
+
+size_t Trajectories::GetMemoryUsage() const
+{
+    size_t n = _locations.capacity() * sizeof(glm::vec3) + _times.capacity() * sizeof(double) + _values.capacity() * sizeof(float);
+    for (const auto &prop : _properties) n += prop.capacity() * sizeof(float);
+    n += (_offsets.capacity() + _sizes.capacity() + _capacities.capacity()) * sizeof(size_t);
+    return n;
+}
+
+void Trajectories::_reset(const std::vector<Particle> &seeds)
+{
+    _offsets.resize(seeds.size());
+    _sizes.assign(seeds.size(), 1);
+    _capacities.assign(seeds.size(), 1);
+    _propertyNames.clear();
+    _properties.clear();
+
+    // Release the memory of the previous streams
+    std::vector<glm::vec3>().swap(_locations);
+    std::vector<double>().swap(_times);
+    std::vector<float>().swap(_values);
+    _resizeArrays(seeds.size());
+
+    for (size_t i = 0; i < seeds.size(); i++) {
+        _offsets[i] = i;
+        _set(i, seeds[i]);
+    }
+}
+
+void Trajectories::_resizeArrays(size_t n)
+{
+    _locations.resize(n);
+    _times.resize(n);
+    _values.resize(n);
+    for (auto &prop : _properties) prop.resize(n, std::nanf("1"));
+}
+
+size_t Trajectories::_loadTail(size_t stream, size_t n, std::vector<Particle> &tail) const
+{
+    n = std::min(n, _sizes[stream]);
+    size_t begin = _offsets[stream] + _sizes[stream] - n;
+
+    tail.clear();
+    tail.reserve(n);
+    for (size_t idx = begin; idx < begin + n; idx++) tail.emplace_back(_locations[idx], _times[idx], _values[idx]);
+    return n;
+}
+
+void Trajectories::_storeTail(size_t stream, size_t n, const std::vector<Particle> &tail)
+{
+    size_t keep = _sizes[stream] - n;
+    size_t size = keep + tail.size();
+
+    if (size > _capacities[stream]) {
+        // Move the stream to the end, and double its space.
+        // Streams grow by a few samples at a time, so moving only this one keeps
+        // the cost of growing proportional to its own length.
+        size_t capacity = std::max(size, 2 * _capacities[stream]);
+        size_t offset = _locations.size();
+        _resizeArrays(offset + capacity);
+
+        size_t from = _offsets[stream];
+        std::copy(_locations.begin() + from, _locations.begin() + from + keep, _locations.begin() + offset);
+        std::copy(_times.begin() + from, _times.begin() + from + keep, _times.begin() + offset);
+        std::copy(_values.begin() + from, _values.begin() + from + keep, _values.begin() + offset);
+        for (auto &prop : _properties) std::copy(prop.begin() + from, prop.begin() + from + keep, prop.begin() + offset);
+
+        _offsets[stream] = offset;
+        _capacities[stream] = capacity;
+    }
+
+    size_t idx = _offsets[stream] + keep;
+    for (const auto &p : tail) _set(idx++, p);
+    _sizes[stream] = size;
+}
+
+void Trajectories::_set(size_t idx, const Particle &p)
+{
+    _locations[idx] = p.location;
+    _times[idx] = p.time;
+    _values[idx] = p.value;
+}
+
+void Trajectories::_copySample(size_t from, size_t to)
+{
+    _locations[to] = _locations[from];
+    _times[to] = _times[from];
+    _values[to] = _values[from];
+    for (auto &prop : _properties) prop[to] = prop[from];
+}
+
+void Trajectories::_compact()
+{
+    size_t used = GetNumberOfSamples();
+    if (_locations.size() - used <= used) return;
+
+    // Lay the streams out back to back, in stream order, with no room to grow.
+    std::vector<glm::vec3>          locations(used);
+    std::vector<double>             times(used);
+    std::vector<float>              values(used);
+    std::vector<std::vector<float>> properties(_properties.size(), std::vector<float>(used));
+
+    size_t offset = 0;
+    for (size_t i = 0; i < _sizes.size(); i++) {
+        size_t from = _offsets[i], n = _sizes[i];
+        std::copy(_locations.begin() + from, _locations.begin() + from + n, locations.begin() + offset);
+        std::copy(_times.begin() + from, _times.begin() + from + n, times.begin() + offset);
+        std::copy(_values.begin() + from, _values.begin() + from + n, values.begin() + offset);
+        for (size_t j = 0; j < _properties.size(); j++) std::copy(_properties[j].begin() + from, _properties[j].begin() + from + n, properties[j].begin() + offset);
+
+        _offsets[i] = offset;
+        _capacities[i] = n;
+        offset += n;
+    }
+
+    _locations.swap(locations);
+    _times.swap(times);
+    _values.swap(values);
+    _properties.swap(properties);
+}
+
+std::vector<float> &Trajectories::_addProperty(const std::string &name)
+{
+    _propertyNames.push_back(name);
+    _properties.emplace_back(_locations.size(), std::nanf("1"));
+    return _properties.back();
+}
+
+void Trajectories::_removeProperty(size_t i)
+{
+    _propertyNames.erase(_propertyNames.begin() + i);
+    _properties.erase(_properties.begin() + i);
+}
+
+void Trajectories::_clearProperties()
+{
+    _propertyNames.clear();
+    _properties.clear();
+}
@@ -84,8 +84,11 @@ auto VaporField::LockParams() -> int
 
     _params->GetBox()->GetExtents(_c_ext_min, _c_ext_max);
 
-    for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = _getAGrid(_c_currentTS, this->VelocityNames[i]); }
-    _c_scalar_grid = _getAGrid(_c_currentTS, this->ScalarName);
+    // A steady field only ever looks at the current time step
+    if (IsSteady) {
+        for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = _getAGrid(_c_currentTS, this->VelocityNames[i]); }
+        _c_scalar_grid = _getAGrid(_c_currentTS, this->ScalarName);
+    }
 
     // Note that if the DefaultZ value is changed by the renderer after LockParams(),
     // cached grids here won't reflect the change.
@@ -105,8 +108,8 @@ auto VaporField::UnlockParams() -> int
     _c_ext_min.clear();
     _c_ext_max.clear();
 
-    for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = nullptr; }
-    _c_scalar_grid = nullptr;
+    for (int i = 0; i < 3; i++) { _c_velocity_grids[i].reset(); }
+    _c_scalar_grid.reset();
 
     _params_locked = false;
     return 0;
@@ -114,8 +117,9 @@ auto VaporField::UnlockParams() -> int
 
 bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
 {
-    const std::array<double, 3> coords{pos.x, pos.y, pos.z};
-    const VAPoR::Grid *         grid = nullptr;
+    const std::array<double, 3>        coords{pos.x, pos.y, pos.z};
+    const VAPoR::Grid *                grid = nullptr;
+    std::shared_ptr<const VAPoR::Grid> held;    // keeps grids that aren't locked alive
     VAssert(_isReady());
 
     // In case of steady field, we only check a specific time step
@@ -123,10 +127,11 @@ bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
         for (int i = 0; i < 3; i++) {
             const auto &v = VelocityNames[i];
             if (_params_locked) {
-                grid = _c_velocity_grids[i];
+                grid = _c_velocity_grids[i].get();
             } else {
                 auto currentTS = _params->GetCurrentTimestep();
-                grid = _getAGrid(currentTS, v);
+                held = _getAGrid(currentTS, v);
+                grid = held.get();
             }
 
             if (grid == nullptr) return false;
@@ -144,7 +149,8 @@ bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
 
         // Then test if pos is inside of time step "floor"
         for (auto &v : VelocityNames) {
-            grid = _getAGrid(floor, v);
+            held = _getAGrid(floor, v);
+            grid = held.get();
             if (grid == nullptr) return false;
             if (!grid->InsideGrid(coords)) return false;
         }
@@ -152,7 +158,8 @@ bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
         // If time is larger than _timestamps[floor], we also need to test _timestamps[floor+1]
         if (time > _timestamps[floor]) {
             for (auto &v : VelocityNames) {
-                grid = _getAGrid(floor + 1, v);
+                held = _getAGrid(floor + 1, v);
+                grid = held.get();
                 if (grid == nullptr) return false;
                 if (!grid->InsideGrid(coords)) return false;
             }
@@ -168,17 +175,19 @@ bool VaporField::InsideVolumeScalar(double time, const glm::vec3 &pos) const
     // a position is inside of the volume, so simply return true.
     if (ScalarName.empty()) return true;
 
-    const std::array<double, 3> coords{pos.x, pos.y, pos.z};
-    const VAPoR::Grid *         grid = nullptr;
+    const std::array<double, 3>        coords{pos.x, pos.y, pos.z};
+    const VAPoR::Grid *                grid = nullptr;
+    std::shared_ptr<const VAPoR::Grid> held;    // keeps grids that aren't locked alive
     VAssert(_isReady());
 
     // In case of steady field, we only check a specific time step
     if (IsSteady) {
         if (_params_locked) {
-            grid = _c_scalar_grid;
+            grid = _c_scalar_grid.get();
         } else {
             auto currentTS = _params->GetCurrentTimestep();
-            grid = _getAGrid(currentTS, ScalarName);
+            held = _getAGrid(currentTS, ScalarName);
+            grid = held.get();
         }
         if (grid == nullptr) return false;
         return grid->InsideGrid(coords);
@@ -193,13 +202,15 @@ bool VaporField::InsideVolumeScalar(double time, const glm::vec3 &pos) const
         if (rv != 0) return false;
 
         // Then test if pos is inside of time step "floor"
-        grid = _getAGrid(floor, ScalarName);
+        held = _getAGrid(floor, ScalarName);
+        grid = held.get();
         if (grid == nullptr) return false;
         if (!grid->InsideGrid(coords)) return false;
 
         // If time is larger than _timestamps[floor], we also need to test _timestamps[floor+1]
         if (time > _timestamps[floor]) {
-            grid = _getAGrid(floor + 1, ScalarName);
+            held = _getAGrid(floor + 1, ScalarName);
+            grid = held.get();
             if (grid == nullptr) return false;
             if (!grid->InsideGrid(coords)) return false;
         }
@@ -210,12 +221,14 @@ bool VaporField::InsideVolumeScalar(double time, const glm::vec3 &pos) const
 
 int VaporField::GetVelocityIntersection(size_t ts, glm::vec3 &minxyz, glm::vec3 &maxxyz) const
 {
-    const VAPoR::Grid *   grid = nullptr;
-    std::array<double, 3> min[3], max[3];
+    const VAPoR::Grid *                grid = nullptr;
+    std::shared_ptr<const VAPoR::Grid> held;
+    std::array<double, 3>              min[3], max[3];
 
     // For each velocity variables
     for (int i = 0; i < 3; i++) {
-        grid = _getAGrid(ts, VelocityNames[i]);
+        held = _getAGrid(ts, VelocityNames[i]);
+        grid = held.get();
         if (grid == nullptr) {
             Wasp::MyBase::SetErrMsg("Vector field not available at requested time step!");
             return GRID_ERROR;
@@ -238,8 +251,9 @@ int VaporField::GetVelocityIntersection(size_t ts, glm::vec3 &minxyz, glm::vec3
 
 int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &velocity) const
 {
-    const std::array<double, 3> coords{pos.x, pos.y, pos.z};
-    const VAPoR::Grid *         grid = nullptr;
+    const std::array<double, 3>        coords{pos.x, pos.y, pos.z};
+    const VAPoR::Grid *                grid = nullptr;
+    std::shared_ptr<const VAPoR::Grid> held;    // keeps grids that aren't locked alive
 
     // Retrieve the missing value and velocity multiplier
     glm::vec3 missingV(0.0f);    // stores missing values for 3 velocity variables
@@ -248,10 +262,11 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
     if (IsSteady) {
         for (int i = 0; i < 3; i++) {
             if (_params_locked) {
-                grid = _c_velocity_grids[i];
+                grid = _c_velocity_grids[i].get();
             } else {
                 auto currentTS = _params->GetCurrentTimestep();
-                grid = _getAGrid(currentTS, VelocityNames[i]);
+                held = _getAGrid(currentTS, VelocityNames[i]);
+                grid = held.get();
             }
             if (grid == nullptr) return GRID_ERROR;
             velocity[i] = grid->GetValue(coords);
@@ -266,7 +281,7 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
             return 0;
         }
     } else {
-        float mult = _params->GetVelocityMultiplier();
+        float mult = _params_locked ? _c_vel_mult : _params->GetVelocityMultiplier();
 
         // First check if the query time is within range
         if (time < _timestamps.front() || time > _timestamps.back()) return TIME_ERROR;
@@ -279,7 +294,8 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
         // Find the velocity values at floor time step
         glm::vec3 floorVelocity, ceilingVelocity;
         for (int i = 0; i < 3; i++) {
-            grid = _getAGrid(floorTS, VelocityNames[i]);
+            held = _getAGrid(floorTS, VelocityNames[i]);
+            grid = held.get();
             if (grid == nullptr) return GRID_ERROR;
             floorVelocity[i] = grid->GetValue(coords);
             missingV[i] = grid->GetMissingValue();
@@ -295,7 +311,8 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
             // We need to make sure there aren't duplicate time stamps
             VAssert(_timestamps[floorTS + 1] > _timestamps[floorTS]);
             for (int i = 0; i < 3; i++) {
-                grid = _getAGrid(floorTS + 1, VelocityNames[i]);
+                held = _getAGrid(floorTS + 1, VelocityNames[i]);
+                grid = held.get();
                 if (grid == nullptr) return GRID_ERROR;
                 ceilingVelocity[i] = grid->GetValue(coords);
                 missingV[i] = grid->GetMissingValue();
@@ -316,15 +333,17 @@ int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) cons
     // from it, so just return that fact.
     if (ScalarName.empty()) return NO_FIELD_YET;
 
-    const std::array<double, 3> coords{pos.x, pos.y, pos.z};
-    const VAPoR::Grid *         grid = nullptr;
+    const std::array<double, 3>        coords{pos.x, pos.y, pos.z};
+    const VAPoR::Grid *                grid = nullptr;
+    std::shared_ptr<const VAPoR::Grid> held;    // keeps grids that aren't locked alive
 
     if (IsSteady) {
         if (_params_locked) {
-            grid = _c_scalar_grid;
+            grid = _c_scalar_grid.get();
         } else {
             auto currentTS = _params->GetCurrentTimestep();
-            grid = _getAGrid(currentTS, ScalarName);
+            held = _getAGrid(currentTS, ScalarName);
+            grid = held.get();
         }
         if (grid == nullptr) return GRID_ERROR;
         scalar = grid->GetValue(coords);
@@ -341,7 +360,8 @@ int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) cons
         size_t floorTS = 0;
         int    rv = LocateTimestamp(time, floorTS);
         VAssert(rv == 0);
-        grid = _getAGrid(floorTS, ScalarName);
+        held = _getAGrid(floorTS, ScalarName);
+        grid = held.get();
         if (grid == nullptr) return GRID_ERROR;
         float floorScalar = grid->GetValue(coords);
         if (floorScalar == grid->GetMissingValue()) { return MISSING_VAL; }
@@ -350,7 +370,8 @@ int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) cons
             scalar = floorScalar;
             return 0;
         } else {
-            grid = _getAGrid(floorTS + 1, ScalarName);
+            held = _getAGrid(floorTS + 1, ScalarName);
+            grid = held.get();
             if (grid == nullptr) return GRID_ERROR;
 
             float ceilingScalar = grid->GetValue(coords);
@@ -435,7 +456,6 @@ int VaporField::CalcDeltaTFromCurrentTimeStep(double &delT) const
     // This function is called only one-time before advection starts,
     // so don't worry about parameter locking here.
     const auto currentTS = _params->GetCurrentTimestep();
-    const auto timestamp = _timestamps.at(currentTS);
 
     // Let's find the intersection of 3 velocity components.
     glm::vec3 minxyz(0.0f), maxxyz(0.0f);
@@ -449,36 +469,42 @@ int VaporField::CalcDeltaTFromCurrentTimeStep(double &delT) const
         return GRID_ERROR;
     }
 
-    // Let's sample some locations along each dimension.
-    const long      N = 10;    // Num of samples along each axis
-    const long      totalSamples = N * N * N;
-    const glm::vec3 numOfSteps(float(N + 1));
-    const glm::vec3 stepSizes = (maxxyz - minxyz) / numOfSteps;
-    glm::vec3       samples[totalSamples];
-    long            counter = 0;
+    // Let's sample some locations along each dimension. The query time is
+    //   exactly the current time step, so each velocity component can be
+    //   sampled on its own grid with a single GetValues() call.
+    const long          N = 10;    // Num of samples along each axis
+    const long          totalSamples = N * N * N;
+    const glm::vec3     numOfSteps(float(N + 1));
+    const glm::vec3     stepSizes = (maxxyz - minxyz) / numOfSteps;
+    std::vector<double> xs(totalSamples), ys(totalSamples), zs(totalSamples);
+    long                counter = 0;
     for (long z = 1; z <= N; z++)
         for (long y = 1; y <= N; y++)
             for (long x = 1; x <= N; x++) {
-                samples[counter].x = minxyz.x + stepSizes.x * float(x);
-                samples[counter].y = minxyz.y + stepSizes.y * float(y);
-                samples[counter].z = minxyz.z + stepSizes.z * float(z);
+                xs[counter] = minxyz.x + stepSizes.x * float(x);
+                ys[counter] = minxyz.y + stepSizes.y * float(y);
+                zs[counter] = minxyz.z + stepSizes.z * float(z);
                 counter++;
             }
 
-    float     maxmag = 0.0f;
-    glm::vec3 vel;
+    std::vector<float> vels[3];
+    float              missingV[3];
+    for (int i = 0; i < 3; i++) {
+        const auto grid = _getAGrid(currentTS, VelocityNames[i]);
+        if (grid == nullptr) return GRID_ERROR;
+        vels[i].resize(totalSamples);
+        grid->GetValues(totalSamples, xs.data(), ys.data(), zs.data(), vels[i].data());
+        missingV[i] = grid->GetMissingValue();
+    }
+
+    const float mult = _params->GetVelocityMultiplier();
+    float       maxmag = 0.0f;
     for (long i = 0; i < totalSamples; i++) {
-        int rv = this->GetVelocity(timestamp, samples[i], vel);
-        // Among possible return values, 0 is good, and MISSING_VAL isn't too bad,
-        // we just need to ignore those values.
-        if (rv == flow::MISSING_VAL)
-            continue;
-        else if (rv != 0)
-            return rv;
-        else {
-            auto mag = glm::length(vel);
-            if (mag > maxmag) maxmag = mag;
-        }
+        // Missing values aren't too bad, we just need to ignore them.
+        if (vels[0][i] == missingV[0] || vels[1][i] == missingV[1] || vels[2][i] == missingV[2]) continue;
+
+        auto mag = glm::length(glm::vec3(vels[0][i], vels[1][i], vels[2][i]) * mult);
+        if (mag > maxmag) maxmag = mag;
     }
 
     // If all sampled locations are missing values or zero values,
@@ -494,8 +520,8 @@ int VaporField::CalcDeltaTFromCurrentTimeStep(double &delT) const
     //   to travel the entire space.
     double desiredNum = 1000.0;    // pre-defined value for unstructured grids
 
-    const auto *grid = _getAGrid(currentTS, VelocityNames[0]);
-    const auto *structuredGrid = dynamic_cast<const VAPoR::StructuredGrid *>(grid);
+    const auto  grid = _getAGrid(currentTS, VelocityNames[0]);
+    const auto *structuredGrid = dynamic_cast<const VAPoR::StructuredGrid *>(grid.get());
     if (structuredGrid) {
         auto dims = structuredGrid->GetDimensions();
         assert(dims.size() == 3);
@@ -509,26 +535,30 @@ int VaporField::CalcDeltaTFromCurrentTimeStep(double &delT) const
     return 0;
 }
 
-const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &varName) const
+std::shared_ptr<const VAPoR::Grid> VaporField::_getAGrid(size_t timestep, const std::string &varName) const
 {
-    GridKey key;
+    // Once params are locked, they are not touched again: they may be
+    // queried from several threads.
+    GridKey             key;
+    std::vector<double> extMin, extMax;
+    int                 refLevel, compLevel;
     if (_params_locked) {
-        // Because in unsteady case, both currentTS and currentTS will be queried,
-        // so we do a sanity check here. The assertion will be gone in release mode.
-        assert(timestep == _c_currentTS);
-        key.Reset(_c_currentTS, _c_refLev, _c_compLev, varName, _c_ext_min, _c_ext_max, this->DefaultZ);
+        extMin = _c_ext_min;
+        extMax = _c_ext_max;
+        refLevel = _c_refLev;
+        compLevel = _c_compLev;
     } else {
-        std::vector<double> extMin, extMax;
         _params->GetBox()->GetExtents(extMin, extMax);
-        int refLevel = _params->GetRefinementLevel();
-        int compLevel = _params->GetCompressionLevel();
-        key.Reset(timestep, refLevel, compLevel, varName, extMin, extMax, this->DefaultZ);
+        refLevel = _params->GetRefinementLevel();
+        compLevel = _params->GetCompressionLevel();
     }
+    key.Reset(timestep, refLevel, compLevel, varName, extMin, extMax, this->DefaultZ);
 
     // First check if we have the requested grid in our cache.
-    // If it exists, return the grid directly.
-    const auto &grid_wrapper = _recentGrids.query(key);
-    if (grid_wrapper != nullptr) { return grid_wrapper->grid(); }
+    // If it exists, return the grid directly. This query does not lock,
+    // so advection threads can read already-cached grids concurrently.
+    auto grid_wrapper = _recentGrids.query(key);
+    if (grid_wrapper != nullptr) { return std::shared_ptr<const VAPoR::Grid>(grid_wrapper, grid_wrapper->grid()); }
 
     //
     // There's no such grid in our cache!
@@ -541,20 +571,16 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
     // Note that we use a lock here, so no two threads querying _datamgr simultaneously.
     const std::lock_guard<std::mutex> lock_gd(_grid_operation_mutex);
 
+    // Another thread might have created this grid while we were waiting for the lock.
+    grid_wrapper = _recentGrids.query(key);
+    if (grid_wrapper != nullptr) { return std::shared_ptr<const VAPoR::Grid>(grid_wrapper, grid_wrapper->grid()); }
+
     VAPoR::Grid *grid = nullptr;
     if (key.emptyVar()) {
         // In case of an empty variable name, we generate a constantGrid with zeros.
         grid = new VAPoR::ConstantGrid(0.0f, 3);
     } else {
-        if (_params_locked) {
-            grid = _datamgr->GetVariable(_c_currentTS, varName, _c_refLev, _c_compLev, _c_ext_min, _c_ext_max, true);
-        } else {
-            std::vector<double> extMin, extMax;
-            _params->GetBox()->GetExtents(extMin, extMax);
-            int refLevel = _params->GetRefinementLevel();
-            int compLevel = _params->GetCompressionLevel();
-            grid = _datamgr->GetVariable(timestep, varName, refLevel, compLevel, extMin, extMax, true);
-        }
+        grid = _datamgr->GetVariable(timestep, varName, refLevel, compLevel, extMin, extMax, true);
     }
 
     if (grid == nullptr) {
@@ -562,6 +588,11 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
         return nullptr;
     }
 
+    // Grid::GetUserExtents() lazily fills a cache the first time it is called.
+    // Fill it now, before other threads can see this grid.
+    VAPoR::DblArr3 minu, maxu;
+    grid->GetUserExtents(minu, maxu);
+
     // Now we have this grid, but also put it in a GridWrapper so
     // 1) it will be properly deleted, and
     // 2) it is stored in our cache, where its ownership is kept.
@@ -569,14 +600,14 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
     auto dim = _datamgr->GetVarTopologyDim(varName);
     if (dim == 3 || dim == 0)    // dim == 0 happens when varName is empty.
     {
-        _recentGrids.insert(key, new GridWrapper(grid, _datamgr));
-        return grid;
+        grid_wrapper = _recentGrids.insert(key, new GridWrapper(grid, _datamgr));
     } else if (dim == 2) {
         VAPoR::GrownGrid *ggrid = new VAPoR::GrownGrid(grid, _datamgr, DefaultZ);
-        _recentGrids.insert(key, new GridWrapper(ggrid, _datamgr));
-        return ggrid;
+        ggrid->GetUserExtents(minu, maxu);
+        grid_wrapper = _recentGrids.insert(key, new GridWrapper(ggrid, _datamgr));
     } else {
         Wasp::MyBase::SetErrMsg("Variable Dimension Wrong!");
         return nullptr;
     }
+    return std::shared_ptr<const VAPoR::Grid>(grid_wrapper, grid_wrapper->grid());
 }
@@ -41,6 +41,8 @@ const std::string FlowParams::_rakeBiasVariable = "RakeBiasVariable";
 const std::string FlowParams::_rakeBiasStrength = "RakeBiasStrength";
 const std::string FlowParams::_pastNumOfTimeSteps = "PastNumOfTimeSteps";
 const std::string FlowParams::_seedInjInterval = "SeedInjInterval";
+const std::string FlowParams::_integrationMethodTag = "IntegrationMethodTag";
+const std::string FlowParams::_integrationToleranceTag = "IntegrationToleranceTag";
 const std::string FlowParams::_xGridNumOfSeedsTag = "GridNumOfSeeds_X";
 const std::string FlowParams::_yGridNumOfSeedsTag = "GridNumOfSeeds_Y";
 const std::string FlowParams::_zGridNumOfSeedsTag = "GridNumOfSeeds_Z";
@@ -127,6 +129,8 @@ int FlowParams::Initialize()
     SetFlowDirection((int)FlowDir::FORWARD);
     SetSteadyNumOfSteps(100);
     SetVelocityMultiplier(1.0);
+    SetIntegrationMethod((int)FlowIntegrator::RK4);
+    SetIntegrationTolerance(1e-5);
     SetPeriodic(vector<bool>(3, false));
     SetGridNumOfSeeds({5, 5, 1});
     SetRandomNumOfSeeds(50);
@@ -332,3 +336,19 @@ int FlowParams::GetSeedInjInterval() const
 }
 
 void FlowParams::SetSeedInjInterval(int val) { SetValueLong(_seedInjInterval, "What's the interval of injecting seeds into an unsteady flow advection", val); }
+
+int FlowParams::GetIntegrationMethod() const { return GetValueLong(_integrationMethodTag, (int)FlowIntegrator::RK4); }
+
+void FlowParams::SetIntegrationMethod(int i)
+{
+    VAssert(i == (int)FlowIntegrator::RK4 || i == (int)FlowIntegrator::RK45);
+    SetValueLong(_integrationMethodTag, "numerical integration method", i);
+}
+
+double FlowParams::GetIntegrationTolerance() const { return GetValueDouble(_integrationToleranceTag, 1e-5); }
+
+void FlowParams::SetIntegrationTolerance(double tol)
+{
+    VAssert(tol > 0.0);
+    SetValueDouble(_integrationToleranceTag, "error tolerance of adaptive integration", tol);
+}
@@ -1121,26 +1121,15 @@ void ParamsMgr::UndoRedoClear()
     RebaseStateSave();
 }
 
-string ParamsMgr::GetTopUndoDesc() const
-{
-    string s;
-    _ssave.GetTopUndo(s);
-    return (s);
-}
+string ParamsMgr::GetTopUndoDesc() const { return (_ssave.GetTopUndoDesc()); }
 
-string ParamsMgr::GetTopRedoDesc() const
-{
-    string s;
-    _ssave.GetTopRedo(s);
-    return (s);
-}
+string ParamsMgr::GetTopRedoDesc() const { return (_ssave.GetTopRedoDesc()); }
 
 ParamsMgr::PMgrStateSave::PMgrStateSave(int stackSize) : StateSave()
 {
     _enabled = true;
     _stackSize = stackSize;
     _rootNode = NULL;
-    _state0 = NULL;
     _undoStack.clear();
     _redoStack.clear();
 }
@@ -1149,7 +1138,19 @@ ParamsMgr::PMgrStateSave::~PMgrStateSave()
 {
     cleanStack(0, _undoStack);
     cleanStack(0, _redoStack);
-    if (_state0) delete _state0;
+}
+
+// Snapshot the tree, sharing unchanged nodes with the top of the undo
+// stack. Returns NULL if the tree hasn't changed since the top was saved.
+//
+XmlSnapshotter::Snapshot ParamsMgr::PMgrStateSave::takeSnapshot()
+{
+    const XmlSnapshotter::Snapshot &top = _undoStack.size() ? _undoStack.back().second : _state0;
+
+    XmlSnapshotter::Snapshot snapshot = _snapshotter.Take(_rootNode, top);
+    if (_undoStack.size() && snapshot == top) return (XmlSnapshotter::Snapshot());
+
+    return (snapshot);
 }
 
 void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
@@ -1165,18 +1166,14 @@ void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
     vector<string> pathvec = node->GetPathVec();
     if ((!pathvec.size()) || (pathvec[0] != _rootTag)) { return; }
 
-    const XmlNode *topNode = NULL;
-    string         s;
-    topNode = GetTopUndo(s);
-    if (topNode && (*topNode == *_rootNode)) {
-        // Don't save tree if no changes
-        //
-        return;
-    }
-
     if (!_groups.empty()) { return; }
 
-    if (!_state0) { _state0 = new XmlNode(*_rootNode); }
+    // Don't save tree if no changes
+    //
+    XmlSnapshotter::Snapshot snapshot = takeSnapshot();
+    if (!snapshot) return;
+
+    if (!_state0) { _state0 = snapshot; }
 
     // Delete oldest elements if needed
     //
@@ -1184,7 +1181,7 @@ void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
 
     // It not inside a group push this element onto the stack
     //
-    if (GetUndoEnabled()) _undoStack.push_back(make_pair(description, new XmlNode(*_rootNode)));
+    if (GetUndoEnabled()) _undoStack.push_back(make_pair(description, snapshot));
 
 //#define DEBUG
 #ifdef DEBUG
@@ -1222,17 +1219,12 @@ void ParamsMgr::PMgrStateSave::EndGroup()
     //
     if (_groups.size()) return;
 
-    const XmlNode *topNode = NULL;
-    string         s;
-    topNode = GetTopUndo(s);
-
-    if (topNode && (*topNode == *_rootNode)) {
-        // Don't save tree if no changes
-        //
-        return;
-    }
+    // Don't save tree if no changes
+    //
+    XmlSnapshotter::Snapshot snapshot = takeSnapshot();
+    if (!snapshot) return;
 
-    if (!_state0) { _state0 = new XmlNode(*_rootNode); }
+    if (!_state0) { _state0 = snapshot; }
 
 #ifdef DEBUG
     cout << "ParamsMgr::PMgrStateSave::EndGroup() : saving "
@@ -1247,13 +1239,27 @@ void ParamsMgr::PMgrStateSave::EndGroup()
     //
     cleanStack(0, _redoStack);
 
-    _undoStack.push_back(make_pair(desc, new XmlNode(*_rootNode)));
+    _undoStack.push_back(make_pair(desc, snapshot));
 
     emitStateChange();
 }
 
 void ParamsMgr::PMgrStateSave::IntermediateChange() { emitIntermediateStateChange(); }
 
+// Trees are rebuilt from their snapshots on demand. Only the last one
+// is kept.
+//
+const XmlNode *ParamsMgr::PMgrStateSave::materialize(const XmlSnapshotter::Snapshot &snapshot) const
+{
+    if (!snapshot) return (NULL);
+
+    if (snapshot != _materialized) {
+        _materializedTree.reset(XmlSnapshotter::Materialize(snapshot));
+        _materialized = snapshot;
+    }
+    return (_materializedTree.get());
+}
+
 const XmlNode *ParamsMgr::PMgrStateSave::GetTopUndo(string &description) const
 {
     VAssert(_rootNode);
@@ -1261,10 +1267,10 @@ const XmlNode *ParamsMgr::PMgrStateSave::GetTopUndo(string &description) const
 
     if (!_undoStack.size()) return (NULL);
 
-    const pair<string, XmlNode *> &p1 = _undoStack.back();
+    const pair<string, XmlSnapshotter::Snapshot> &p1 = _undoStack.back();
 
     description = p1.first;
-    return (p1.second);
+    return (materialize(p1.second));
 }
 
 const XmlNode *ParamsMgr::PMgrStateSave::GetTopRedo(string &description) const
@@ -1274,10 +1280,10 @@ const XmlNode *ParamsMgr::PMgrStateSave::GetTopRedo(string &description) const
 
     if (!_redoStack.size()) return (NULL);
 
-    const pair<string, XmlNode *> &p1 = _redoStack.back();
+    const pair<string, XmlSnapshotter::Snapshot> &p1 = _redoStack.back();
 
     description = p1.first;
-    return (p1.second);
+    return (materialize(p1.second));
 }
 
 bool ParamsMgr::PMgrStateSave::Undo()
@@ -1286,7 +1292,7 @@ bool ParamsMgr::PMgrStateSave::Undo()
 
     if (!_undoStack.size()) return (false);
 
-    pair<string, XmlNode *> &p1 = _undoStack.back();
+    pair<string, XmlSnapshotter::Snapshot> p1 = _undoStack.back();
 
     // Delete oldest elements if needed
     //
@@ -1307,7 +1313,7 @@ bool ParamsMgr::PMgrStateSave::Redo()
 
     if (!_redoStack.size()) return (false);
 
-    pair<string, XmlNode *> &p1 = _redoStack.back();
+    pair<string, XmlSnapshotter::Snapshot> p1 = _redoStack.back();
 
     // Delete oldest elements if needed
     //
@@ -1331,17 +1337,12 @@ void ParamsMgr::PMgrStateSave::Clear()
     while (_groups.size()) _groups.pop();
 }
 
-void ParamsMgr::PMgrStateSave::cleanStack(int maxN, std::deque<std::pair<string, XmlNode *>> &s)
+void ParamsMgr::PMgrStateSave::cleanStack(int maxN, std::deque<std::pair<string, XmlSnapshotter::Snapshot>> &s)
 {
-    // Delete oldest elements if needed
+    // Delete oldest elements if needed. Nodes shared with other
+    // snapshots are freed with the last of them.
     //
-    while (s.size() > maxN) {
-        pair<string, XmlNode *> &p1 = s.front();
-
-        if (p1.second) { delete p1.second; }
-
-        s.pop_front();
-    }
+    while (s.size() > maxN) s.pop_front();
 }
 
 void ParamsMgr::PMgrStateSave::emitStateChange()
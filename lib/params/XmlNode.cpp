@@ -42,6 +42,7 @@ vector<long>           XmlNode::_emptyLongVec;
 vector<string>         XmlNode::_emptyStringVec;
 string                 XmlNode::_emptyString;
 std::vector<XmlNode *> XmlNode::_allocatedNodes;
+std::atomic<unsigned long> XmlNode::_versionCounter(0);
 };    // namespace VAPoR
 
 namespace {
@@ -105,6 +106,7 @@ XmlNode::XmlNode(const string &tag, const map<string, string> &attrs, size_t num
     _attrmap = attrs;
 
     if (numChildrenHint) _children.reserve(numChildrenHint);
+    _touch();
 
 #ifdef MEMCHECK
     _allocatedNodes.push_back(this);
@@ -127,6 +129,7 @@ XmlNode::XmlNode(const string &tag, size_t numChildrenHint)
     _tag = tag;
 
     if (numChildrenHint) _children.reserve(numChildrenHint);
+    _touch();
 
 #ifdef MEMCHECK
     _allocatedNodes.push_back(this);
@@ -143,6 +146,7 @@ XmlNode::XmlNode()
     _tag.clear();
     _asciiLimit = 1024;
     _parent = NULL;
+    _touch();
 
 #ifdef MEMCHECK
     _allocatedNodes.push_back(this);
@@ -155,6 +159,7 @@ XmlNode::XmlNode(const XmlNode &rhs)
 {
     _children.clear();
     for (int i = 0; i < rhs._children.size(); i++) { AddChild(rhs._children[i]); }
+    _touch();
 
 #ifdef MEMCHECK
     _allocatedNodes.push_back(this);
@@ -178,6 +183,7 @@ XmlNode &XmlNode::operator=(const XmlNode &rhs)
 
     _children.clear();
     for (int i = 0; i < rhs._children.size(); i++) { AddChild(rhs._children[i]); }
+    _touch();
 
     return (*this);
 }
@@ -206,7 +212,16 @@ bool XmlNode::operator==(const XmlNode &rhs) const
 
 XmlNode::~XmlNode()
 {
-    DeleteAll();
+    // Delete descendants without changing the versions of their
+    // ancestors, which are going away too
+    //
+    for (int i = 0; i < (int)_children.size(); i++) {
+        if (_children[i]) {
+            _children[i]->_parent = NULL;
+            delete _children[i];
+        }
+    }
+    _children.clear();
 
 #ifdef MEMCHECK
     std::vector<XmlNode *>::iterator itr;
@@ -223,6 +238,7 @@ void XmlNode::SetElementLong(const string &tag, const vector<long> &values)
 {
     VAssert(isValidXMLElement(tag));
     _longmap[tag] = values;
+    _touch();
 }
 
 void XmlNode::SetElementLong(const vector<string> &tags, const vector<long> &values)
@@ -240,6 +256,7 @@ void XmlNode::SetElementLong(const vector<string> &tags, const vector<long> &val
     string tag = tags[tags.size() - 1];
     VAssert(isValidXMLElement(tag));
     currNode->_longmap[tag] = values;
+    currNode->_touch();
 }
 
 void XmlNode::SetElementDouble(const vector<string> &tags, const vector<double> &values)
@@ -257,6 +274,7 @@ void XmlNode::SetElementDouble(const vector<string> &tags, const vector<double>
     string tag = tags[tags.size() - 1];
     VAssert(isValidXMLElement(tag));
     currNode->_doublemap[tag] = values;
+    currNode->_touch();
 }
 
 const vector<long> &XmlNode::GetElementLong(const string &tag) const
@@ -280,6 +298,7 @@ void XmlNode::SetElementDouble(const string &tag, const vector<double> &values)
 {
     VAssert(isValidXMLElement(tag));
     _doublemap[tag] = values;
+    _touch();
 }
 
 const vector<double> &XmlNode::GetElementDouble(const string &tag) const
@@ -305,6 +324,7 @@ void XmlNode::SetElementString(const string &tag, const string &str)
     VAssert(isValidXMLElement(tag));
 
     _stringmap[tag] = str;
+    _touch();
 }
 
 void XmlNode::SetElementStringVec(const string &tag, const vector<string> &strvec)
@@ -377,6 +397,7 @@ XmlNode *XmlNode::NewChild(const string &tag, const map<string, string> &attrs,
     mychild->_parent = this;
 
     _children.push_back(mychild);
+    _touch();
     return (mychild);
 }
 
@@ -388,11 +409,12 @@ XmlNode *XmlNode::AddChild(const XmlNode &child)
 
     // Delete duplicates
     //
-    if (HasChild(mychild->Tag())) { DeleteChild(mychild->Tag()); }
+    if (HasChild(mychild->_tag)) { DeleteChild(mychild->_tag); }
 
     mychild->_parent = this;
 
     _children.push_back(mychild);
+    _touch();
     return (mychild);
 }
 
@@ -405,6 +427,7 @@ int XmlNode::ReplaceChild(XmlNode *prevChildNode, XmlNode *newChildNode)
             delete node;
             _children[index] = new XmlNode(*newChildNode);
             newChildNode->_parent = this;
+            _touch();
 
             return index;
         }
@@ -535,7 +558,7 @@ void XmlNode::SetParent(XmlNode *parent)
 
     // Delete duplicates on new parent
     //
-    if (parent && parent->HasChild(Tag())) { parent->DeleteChild(Tag()); }
+    if (parent && parent->HasChild(_tag)) { parent->DeleteChild(_tag); }
 
     // Remove from current parent's list of children
     //
@@ -543,16 +566,20 @@ void XmlNode::SetParent(XmlNode *parent)
         vector<XmlNode *>::iterator itr = _parent->_children.begin();
         for (; itr != _parent->_children.end(); ++itr) {
             XmlNode *node = *itr;
-            if (node->Tag() == Tag()) {
+            if (node->_tag == _tag) {
                 _parent->_children.erase(itr);
                 break;
             }
         }
+        _parent->_touch();
     }
 
     // If new parent is not NULL
     //
-    if (parent) { parent->_children.push_back(this); }
+    if (parent) {
+        parent->_children.push_back(this);
+        parent->_touch();
+    }
 
     _parent = parent;
 }
@@ -570,6 +597,13 @@ void XmlNode::DeleteAll()
         }
     }
     _children.clear();
+    _touch();
+}
+
+void XmlNode::_touch()
+{
+    unsigned long version = ++_versionCounter;
+    for (XmlNode *node = this; node; node = node->_parent) node->_version = version;
 }
 
 vector<string> XmlNode::GetPathVec() const
@@ -904,3 +938,141 @@ bool XmlParser::_isDataElement(string tag, map<string, string> myattrs, type &dt
 
     return (false);
 }
+
+// A node of a snapshot. The data of a node is shared between snapshots
+// even when its children differ.
+//
+class XmlSnapshotter::Node {
+public:
+    class Data {
+    public:
+        string                      tag;
+        map<string, string>         attrmap;
+        map<string, vector<long>>   longmap;
+        map<string, vector<double>> doublemap;
+        map<string, string>         stringmap;
+        size_t                      asciiLimit;
+    };
+
+    std::shared_ptr<const Data> data;
+    vector<Snapshot>            children;
+    size_t                      numNodes;
+};
+
+namespace {
+
+bool equalData(const XmlSnapshotter::Node::Data &data, const string &tag, const map<string, string> &attrmap, const map<string, vector<long>> &longmap,
+               const map<string, vector<double>> &doublemap, const map<string, string> &stringmap)
+{
+    return (data.tag == tag && data.attrmap == attrmap && data.longmap == longmap && data.doublemap == doublemap && data.stringmap == stringmap);
+}
+
+};    // namespace
+
+XmlSnapshotter::Snapshot XmlSnapshotter::Take(const XmlNode *root, const Snapshot &prev)
+{
+    VAssert(root);
+
+    Snapshot snapshot = _take(root, prev);
+
+    // Drop the nodes that have left the tree once they outnumber those
+    // in it
+    //
+    if (_cache.size() > 2 * snapshot->numNodes + 1024) {
+        std::map<const XmlNode *, std::pair<unsigned long, Snapshot>> cache;
+        _prune(root, cache);
+        _cache.swap(cache);
+    }
+
+    return (snapshot);
+}
+
+XmlSnapshotter::Snapshot XmlSnapshotter::_take(const XmlNode *node, const Snapshot &prev)
+{
+    auto itr = _cache.find(node);
+    if (itr != _cache.end() && itr->second.first == node->_version) return (itr->second.second);
+
+    Snapshot cached = itr != _cache.end() ? itr->second.second : Snapshot();
+
+    vector<Snapshot> children;
+    children.reserve(node->_children.size());
+    for (size_t i = 0; i < node->_children.size(); i++) {
+        Snapshot childPrev;
+        if (prev && i < prev->children.size())
+            childPrev = prev->children[i];
+        else if (cached && i < cached->children.size())
+            childPrev = cached->children[i];
+
+        children.push_back(_take(node->_children[i], childPrev));
+    }
+
+    // Reuse the node of the earlier snapshot, or failing that its data,
+    // if nothing changed
+    //
+    std::shared_ptr<const Node::Data> data;
+    Snapshot                          snapshot;
+    for (const Snapshot &c : {prev, cached}) {
+        if (!c || !equalData(*c->data, node->_tag, node->_attrmap, node->_longmap, node->_doublemap, node->_stringmap)) continue;
+
+        if (c->children == children) {
+            snapshot = c;
+            break;
+        }
+        if (!data) data = c->data;
+    }
+
+    if (!snapshot) {
+        if (!data) {
+            Node::Data *d = new Node::Data();
+            d->tag = node->_tag;
+            d->attrmap = node->_attrmap;
+            d->longmap = node->_longmap;
+            d->doublemap = node->_doublemap;
+            d->stringmap = node->_stringmap;
+            d->asciiLimit = node->_asciiLimit;
+            data.reset(d);
+        }
+
+        Node *n = new Node();
+        n->data = data;
+        n->numNodes = 1;
+        for (const Snapshot &child : children) n->numNodes += child->numNodes;
+        n->children.swap(children);
+        snapshot.reset(n);
+    }
+
+    _cache[node] = std::make_pair(node->_version, snapshot);
+    return (snapshot);
+}
+
+void XmlSnapshotter::_prune(const XmlNode *node, std::map<const XmlNode *, std::pair<unsigned long, Snapshot>> &cache) const
+{
+    auto itr = _cache.find(node);
+    if (itr != _cache.end()) cache.insert(*itr);
+
+    for (const XmlNode *child : node->_children) _prune(child, cache);
+}
+
+XmlNode *XmlSnapshotter::Materialize(const Snapshot &snapshot)
+{
+    VAssert(snapshot);
+
+    const Node::Data &data = *snapshot->data;
+
+    XmlNode *node = new XmlNode(data.tag, data.attrmap, snapshot->children.size());
+    node->_longmap = data.longmap;
+    node->_doublemap = data.doublemap;
+    node->_stringmap = data.stringmap;
+    node->_asciiLimit = data.asciiLimit;
+
+    for (const Snapshot &c : snapshot->children) {
+        XmlNode *child = Materialize(c);
+        child->_parent = node;
+        node->_children.push_back(child);
+    }
+    node->_touch();
+
+    return (node);
+}
+
+size_t XmlSnapshotter::GetNumNodes(const Snapshot &snapshot) { return (snapshot ? snapshot->numNodes : 0); }
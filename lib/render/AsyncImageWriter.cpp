@@ -0,0 +1,182 @@
+#include <algorithm>
+#include "vapor/VAssert.h"
+#include <vapor/AsyncImageWriter.h>
+
+using namespace VAPoR;
+using namespace std;
+
+namespace {
+
+// Write a frame and free its writer. Returns the writer's error message,
+// or an empty string on success.
+//
+string write_frame(ImageWriter *writer, const unsigned char *buffer, unsigned int width, unsigned int height)
+{
+    string err;
+    if (writer->Write(buffer, width, height) < 0) {
+        err = writer->GetWriteError();
+        if (err.empty()) err = "unknown error";
+    }
+    delete writer;
+    return (err);
+}
+
+};    // namespace
+
+AsyncImageWriter::AsyncImageWriter(int nthreads, int maxFrames, size_t maxBytes)
+{
+    if (nthreads < 1) nthreads = std::max(1u, std::thread::hardware_concurrency());
+    if (maxFrames < 1) maxFrames = 2 * nthreads;
+
+    _maxFrames = std::max(2, maxFrames);
+    _maxBytes = maxBytes;
+    _nInUse = 0;
+    _bytesInUse = 0;
+    _nPending = 0;
+    _done = false;
+
+    for (int i = 0; i < nthreads; i++) _threads.push_back(std::thread(&AsyncImageWriter::_worker, this));
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    (void)Wait();
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _frameQueued.notify_all();
+    for (auto &t : _threads) t.join();
+
+    // Buffers acquired and never returned are freed too
+    //
+    for (auto &itr : _sizes) delete[] itr.first;
+}
+
+unsigned char *AsyncImageWriter::AcquireBuffer(size_t size)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _frameWritten.wait(lock, [this, size] { return (_nInUse < _maxFrames && (_nInUse == 0 || _bytesInUse + size <= _maxBytes)); });
+    _nInUse++;
+
+    for (auto itr = _freeBuffers.begin(); itr != _freeBuffers.end(); ++itr) {
+        if (_sizes[*itr] >= size) {
+            unsigned char *buffer = *itr;
+            _freeBuffers.erase(itr);
+            _bytesInUse += _sizes[buffer];
+            return (buffer);
+        }
+    }
+
+    // No free buffer is big enough, as after the window grows. Free ones
+    // are replaced so that no more than _maxFrames buffers, and no more
+    // than _maxBytes unless a single frame needs it, are ever allocated.
+    //
+    size_t allocated = size;
+    for (auto &itr : _sizes) allocated += itr.second;
+
+    while (_freeBuffers.size() && (allocated > _maxBytes || _sizes.size() >= _maxFrames)) {
+        allocated -= _sizes[_freeBuffers.back()];
+        _sizes.erase(_freeBuffers.back());
+        delete[] _freeBuffers.back();
+        _freeBuffers.pop_back();
+    }
+
+    unsigned char *buffer = new unsigned char[size];
+    _sizes[buffer] = size;
+    _bytesInUse += size;
+    return (buffer);
+}
+
+void AsyncImageWriter::ReleaseBuffer(unsigned char *buffer)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _release(buffer);
+    }
+    _frameWritten.notify_all();
+}
+
+int AsyncImageWriter::Submit(ImageWriter *writer, unsigned char *buffer, unsigned int width, unsigned int height)
+{
+    VAssert(writer && buffer);
+
+    if (!writer->IsThreadSafe()) {
+        string err = write_frame(writer, buffer, width, height);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!err.empty()) _errors.push_back(err);
+        _release(buffer);
+        lock.unlock();
+        _frameWritten.notify_all();
+
+        return (_reportFailures());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue.push_back({writer, buffer, width, height});
+        _nPending++;
+    }
+    _frameQueued.notify_one();
+
+    return (_reportFailures());
+}
+
+int AsyncImageWriter::Wait()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _frameWritten.wait(lock, [this] { return (_nPending == 0); });
+    }
+    return (_reportFailures());
+}
+
+void AsyncImageWriter::_worker()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _frameQueued.wait(lock, [this] { return (_done || !_queue.empty()); });
+        if (_queue.empty()) return;
+
+        frame_t frame = _queue.front();
+        _queue.pop_front();
+        lock.unlock();
+
+        string err = write_frame(frame.writer, frame.buffer, frame.width, frame.height);
+
+        lock.lock();
+        if (!err.empty()) _errors.push_back(err);
+        _release(frame.buffer);
+        _nPending--;
+        _frameWritten.notify_all();
+    }
+}
+
+// Called with _mutex held
+//
+void AsyncImageWriter::_release(unsigned char *buffer)
+{
+    VAssert(_sizes.count(buffer) && _nInUse > 0);
+
+    _freeBuffers.push_back(buffer);
+    _nInUse--;
+    _bytesInUse -= _sizes[buffer];
+}
+
+// Failures are collected by the workers and reported here, on the thread
+// that submits the frames, since SetErrMsg() isn't thread safe
+//
+int AsyncImageWriter::_reportFailures()
+{
+    vector<string> errors;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        errors.swap(_errors);
+    }
+    if (errors.empty()) return (0);
+
+    SetErrMsg("Failed to write %zu captured image(s) : %s", errors.size(), errors[0].c_str());
+    return (-1);
+}
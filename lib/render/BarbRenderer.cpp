@@ -27,6 +27,7 @@
 #define BARB_LENGTH_TO_HYPOTENUSE .0625
 
 #include <vapor/glutil.h>    // Must be included first!!!
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -389,18 +390,17 @@ void BarbRenderer::_printBackDiameter(const float startVertex[18]) const
 // Issue OpenGL calls to draw a cylinder with orthogonal ends from
 // one point to another.  Then put an barb head on the end
 //
-void BarbRenderer::_drawBarb(const std::vector<Grid *> variableData, const float startPoint_[3], bool doColorMapping, const float clut[1024])
+void BarbRenderer::_drawBarb(const float startPoint_[3], const float direction_[3])
 {
     float startPoint[3];
     memcpy(startPoint, startPoint_, sizeof(float) * 3);
+    float direction[3];
+    memcpy(direction, direction_, sizeof(float) * 3);
 
-    VAssert(variableData.size() == 5);
     MatrixManager *mm = _glManager->matrixManager;
 
     float endPoint[3];
-    bool  missing = _defineBarb(variableData, startPoint, endPoint, doColorMapping, clut);
-
-    if (missing) return;
+    _makeStartAndEndPoint(startPoint, endPoint, direction);
 
     mm->MatrixModeModelView();
     mm->PushMatrix();
@@ -594,31 +594,6 @@ void BarbRenderer::_makeRakeGrid(vector<int> &rakeGrid) const
     rakeGrid.push_back((int)longGrid[Z]);
 }
 
-float BarbRenderer::_getHeightOffset(Grid *heightVar, float xCoord, float yCoord, bool &missing) const
-{
-    VAssert(heightVar);
-    float missingVal = heightVar->GetMissingValue();
-    float offset = heightVar->GetValue(xCoord, yCoord, 0.f);
-    if (offset == missingVal) {
-        missing = true;
-        offset = 0.f;
-    }
-    return offset;
-}
-
-void BarbRenderer::_getDirection(float direction[3], vector<Grid *> variableData, float xCoord, float yCoord, float zCoord, bool &missing) const
-{
-    for (int dim = 0; dim < 3; dim++) {
-        direction[dim] = 0.f;
-        if (variableData[dim]) {
-            direction[dim] = variableData[dim]->GetValue(xCoord, yCoord, zCoord);
-
-            float missingVal = variableData[dim]->GetMissingValue();
-            if (direction[dim] == missingVal) { missing = true; }
-        }
-    }
-}
-
 bool BarbRenderer::_makeCLUT(float clut[1024]) const
 {
     BarbParams *bParams = dynamic_cast<BarbParams *>(GetActiveParams());
@@ -689,32 +664,10 @@ void BarbRenderer::_getStrides(vector<float> &strides, vector<int> &rakeGrid, ve
     strides.push_back(zStride);
 }
 
-bool BarbRenderer::_defineBarb(const std::vector<Grid *> variableData, float start[3], float end[3], bool doColorMapping, const float clut[1024])
-{
-    bool missing = false;
-
-    Grid *heightVar = variableData[3];
-    if (heightVar) { start[Z] += _getHeightOffset(heightVar, start[X], start[Y], missing); }
-
-    float direction[3] = {0.f, 0.f, 0.f};
-    _getDirection(direction, variableData, start[X], start[Y], start[Z], missing);
-
-    _makeStartAndEndPoint(start, end, direction);
-
-    if (doColorMapping) {
-        float val = variableData[4]->GetValue(start[X], start[Y], start[Z]);
-
-        if (val == variableData[4]->GetMissingValue())
-            missing = true;
-        else {
-            missing = _getColorMapping(val, clut);
-        }
-    }
-    return missing;
-}
-
 void BarbRenderer::_operateOnGrid(vector<Grid *> variableData, bool drawBarb)
 {
+    VAssert(variableData.size() == 5);
+
     vector<int> rakeGrid;
     _makeRakeGrid(rakeGrid);
 
@@ -725,39 +678,95 @@ void BarbRenderer::_operateOnGrid(vector<Grid *> variableData, bool drawBarb)
     _getStrides(strides, rakeGrid, rakeExts);
 
     float clut[1024];
-    bool  doColorMapping = _makeCLUT(clut);
+    bool  doColorMapping = drawBarb && _makeCLUT(clut);
+
+    // The rake is sampled one plane of constant X at a time, so that each
+    // grid can answer a whole plane of points with GetValues()
+    //
+    size_t         n = (size_t)std::max(rakeGrid[Y], 0) * (size_t)std::max(rakeGrid[Z], 0);
+    vector<double> x(n), y(n), z(n);
+    vector<float>  direction[3];
+    vector<float>  colorValues;
+    vector<bool>   missing(n);
 
-    float start[3];
     for (int i = 1; i <= rakeGrid[X]; i++) {
-        start[X] = strides[X] * i + rakeExts[X];    // + xStride/2.0;
+        size_t p = 0;
         for (int j = 1; j <= rakeGrid[Y]; j++) {
-            start[Y] = strides[Y] * j + rakeExts[Y];    // + yStride/2.0;
-            for (int k = 1; k <= rakeGrid[Z]; k++) {
-                start[Z] = strides[Z] * k + rakeExts[Z];    //+ zStride/2.0;
-
-                if (drawBarb) {
-                    _drawBarb(variableData, start, doColorMapping, clut);
-                } else {
-                    _getMagnitudeAtPoint(variableData, start);
+            for (int k = 1; k <= rakeGrid[Z]; k++, p++) {
+                x[p] = strides[X] * i + rakeExts[X];    // + xStride/2.0;
+                y[p] = strides[Y] * j + rakeExts[Y];    // + yStride/2.0;
+                z[p] = strides[Z] * k + rakeExts[Z];    //+ zStride/2.0;
+                missing[p] = false;
+            }
+        }
+
+        // Barbs sit on top of the height variable, if there is one
+        //
+        Grid *heightVar = variableData[3];
+        if (drawBarb && heightVar) {
+            vector<double> zero(n, 0.0);
+            vector<float>  offset(n);
+            heightVar->GetValues(n, x.data(), y.data(), zero.data(), offset.data());
+
+            float missingVal = heightVar->GetMissingValue();
+            for (p = 0; p < n; p++) {
+                if (offset[p] == missingVal)
+                    missing[p] = true;
+                else
+                    z[p] += offset[p];
+            }
+        }
+
+        for (int dim = 0; dim < 3; dim++) {
+            direction[dim].assign(n, 0.f);
+            if (!variableData[dim]) continue;
+
+            variableData[dim]->GetValues(n, x.data(), y.data(), z.data(), direction[dim].data());
+        }
+
+        if (doColorMapping) {
+            colorValues.resize(n);
+            variableData[4]->GetValues(n, x.data(), y.data(), z.data(), colorValues.data());
+        }
+
+        if (drawBarb) {
+            for (int dim = 0; dim < 3; dim++) {
+                if (!variableData[dim]) continue;
+
+                float missingVal = variableData[dim]->GetMissingValue();
+                for (p = 0; p < n; p++) {
+                    if (direction[dim][p] == missingVal) missing[p] = true;
                 }
             }
+
+            for (p = 0; p < n; p++) {
+                if (missing[p]) continue;
+                if (doColorMapping) {
+                    if (colorValues[p] == variableData[4]->GetMissingValue()) continue;
+                    _getColorMapping(colorValues[p], clut);
+                }
+
+                float start[3] = {(float)x[p], (float)y[p], (float)z[p]};
+                float dir[3] = {direction[X][p], direction[Y][p], direction[Z][p]};
+                _drawBarb(start, dir);
+            }
+        } else {
+            _getMaxMagnitude(variableData, direction);
         }
     }
     return;
 }
 
-void BarbRenderer::_getMagnitudeAtPoint(std::vector<VAPoR::Grid *> variables, float point[3])
+void BarbRenderer::_getMaxMagnitude(const std::vector<VAPoR::Grid *> &variables, const vector<float> values[3])
 {
-    VAPoR::Grid *grid;
-    double       maxValue = 0.f;
+    double maxValue = 0.f;
     for (int i = 0; i < 3; i++) {
-        grid = variables[i];
-        if (grid == NULL)
-            continue;
-        else {
-            double value = grid->GetValue(point[X], point[Y], point[Z]);
-            double missingValue = grid->GetMissingValue();
+        VAPoR::Grid *grid = variables[i];
+        if (grid == NULL) continue;
 
+        double missingValue = grid->GetMissingValue();
+        for (size_t p = 0; p < values[i].size(); p++) {
+            double value = values[i][p];
             if (value == missingValue) { continue; }
             value = abs(value);
 
@@ -40,13 +40,6 @@
 
 using namespace VAPoR;
 
-#pragma pack(push, 4)
-struct ContourRenderer::VertexData {
-    float x, y, z;
-    float v;
-};
-#pragma pack(pop)
-
 static RendererRegistrar<ContourRenderer> registrar(ContourRenderer::GetClassType(), ContourParams::GetClassType());
 
 ContourRenderer::ContourRenderer(const ParamsMgr *pm, string winName, string dataSetName, string instName, DataMgr *dataMgr)
@@ -100,72 +93,48 @@ int ContourRenderer::_buildCache()
     ContourParams *cParams = (ContourParams *)GetActiveParams();
     _saveCacheParams();
 
-    vector<VertexData>           vertices;
-    vector<pair<int, glm::vec4>> colors;
+    vector<ContourExtractor::Vertex> vertices;
 
     if (cParams->GetVariableName().empty()) { return 0; }
     vector<double> contours = cParams->GetContourValues(_cacheParams.varName);
 
-    Grid *grid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.varName, _cacheParams.level, _cacheParams.lod, _cacheParams.boxMin, _cacheParams.boxMax);
-    Grid *heightGrid = NULL;
-    if (!_cacheParams.heightVarName.empty()) {
-        heightGrid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.heightVarName, _cacheParams.level, _cacheParams.lod, _cacheParams.boxMin, _cacheParams.boxMax);
-    }
-
-    if (grid == NULL || (heightGrid == NULL && !_cacheParams.heightVarName.empty())) { return -1; }
-
-    double mv = grid->GetMissingValue();
-    float  Z0 = GetDefaultZ(_dataMgr, _cacheParams.ts);
-
-    Grid::ConstCellIterator it = grid->ConstCellBegin(_cacheParams.boxMin, _cacheParams.boxMax);
-
-    size_t             maxNodes = grid->GetMaxVertexPerCell();
-    vector<Size_tArr3> nodes(maxNodes);
-
-    vector<float>   values(maxNodes);
-    vector<DblArr3> coords(maxNodes);
-
-    Grid::ConstCellIterator end = grid->ConstCellEnd();
-    for (; it != end; ++it) {
-        const vector<size_t> &cell = *it;
-        grid->GetCellNodes(cell.data(), nodes);
-
-        bool hasMissing = false;
-        for (int i = 0; i < nodes.size(); i++) {
-            grid->GetUserCoordinates(nodes[i], coords[i]);
-            values[i] = grid->GetValueAtIndex(nodes[i]);
-            if (values[i] == mv) { hasMissing = true; }
+    // Segments are cached per grid, so only contour values that haven't
+    // been extracted for this grid before need the grid to be read
+    //
+    ostringstream oss;
+    oss << _cacheParams.ts << ":" << _cacheParams.varName << ":" << _cacheParams.level << ":" << _cacheParams.lod << ":" << _cacheParams.heightVarName;
+    for (auto v : _cacheParams.boxMin) oss << ":" << v;
+    for (auto v : _cacheParams.boxMax) oss << ":" << v;
+    string key = oss.str();
+
+    vector<double> missing = _extractor.GetMissing(key, contours);
+    if (!missing.empty()) {
+        Grid *grid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.varName, _cacheParams.level, _cacheParams.lod, _cacheParams.boxMin, _cacheParams.boxMax);
+        Grid *heightGrid = NULL;
+        if (!_cacheParams.heightVarName.empty()) {
+            heightGrid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.heightVarName, _cacheParams.level, _cacheParams.lod, _cacheParams.boxMin, _cacheParams.boxMax);
         }
-        if (hasMissing) continue;
-
-        for (int ci = 0; ci != contours.size(); ci++) {
-            for (int a = nodes.size() - 1, b = 0; b < nodes.size(); a++, b++) {
-                if (a == nodes.size()) a = 0;
-                float contour = contours[ci];
 
-                if ((values[a] <= contour && values[b] <= contour) || (values[a] > contour && values[b] > contour)) continue;
+        if (grid == NULL || (heightGrid == NULL && !_cacheParams.heightVarName.empty())) {
+            if (grid) delete grid;
+            if (heightGrid) delete heightGrid;
+            return -1;
+        }
 
-                float t = (contour - values[a]) / (values[b] - values[a]);
-                float v[3];
-                v[0] = coords[a][0] + t * (coords[b][0] - coords[a][0]);
-                v[1] = coords[a][1] + t * (coords[b][1] - coords[a][1]);
-                v[2] = Z0;
+        float Z0 = GetDefaultZ(_dataMgr, _cacheParams.ts);
 
-                if (heightGrid) {
-                    float aHeight = heightGrid->GetValueAtIndex(nodes[a]);
-                    float bHeight = heightGrid->GetValueAtIndex(nodes[b]);
-                    v[2] = aHeight + t * (bHeight - aHeight);
-                }
+        _extractor.Extract(key, grid, heightGrid, Z0, _cacheParams.boxMin, _cacheParams.boxMax, missing);
 
-                vertices.push_back({v[0], v[1], v[2], contour});
-            }
-        }
+        delete grid;
+        if (heightGrid) delete heightGrid;
     }
 
+    _extractor.GetSegments(key, contours, vertices);
+
     _nVertices = vertices.size();
     glBindVertexArray(_VAO);
     glBindBuffer(GL_ARRAY_BUFFER, _VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VertexData), vertices.data(), GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ContourExtractor::Vertex), vertices.data(), GL_DYNAMIC_DRAW);
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -209,9 +178,9 @@ int ContourRenderer::_initializeGL()
     glBindVertexArray(_VAO);
     glGenBuffers(1, &_VBO);
     glBindBuffer(GL_ARRAY_BUFFER, _VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), NULL);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ContourExtractor::Vertex), NULL);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void *)offsetof(struct VertexData, v));
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(ContourExtractor::Vertex), (void *)offsetof(ContourExtractor::Vertex, v));
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 
@@ -2,6 +2,7 @@
 #include "vapor/FlowRenderer.h"
 #include "vapor/Particle.h"
 #include "vapor/AdvectionIO.h"
+#include "vapor/RakeSeeds.h"
 #include <iostream>
 #include <sstream>
 #include <cstring>
@@ -225,8 +226,15 @@ int FlowRenderer::_paintGL(bool fast)
             MyBase::SetErrMsg("Update Advection Periodicity failed!");
             return flow::GRID_ERROR;
         }
+
+        // The error tolerance is relative to the size of the region of interest.
+        std::vector<double> minExt, maxExt;
+        params->GetBox()->GetExtents(minExt, maxExt);
+        _advection.SetBoxTolerance(_cache_tolerance, minExt, maxExt);
+
         if (_2ndAdvection)    // bi-directional advection
         {
+            _2ndAdvection->SetBoxTolerance(_cache_tolerance, minExt, maxExt);
             _2ndAdvection->UseSeedParticles(seeds);
             rv = _updateAdvectionPeriodicity(_2ndAdvection.get());
             if (rv != 0) {
@@ -257,6 +265,7 @@ int FlowRenderer::_paintGL(bool fast)
 
     if (!_advectionComplete) {
         auto deltaT = _cache_deltaT;
+        auto method = static_cast<flow::Advection::ADVECTION_METHOD>(_cache_integrator);
         rv = flow::ADVECT_HAPPENED;
 
         // Advection scheme 1: advect a maximum number of steps.
@@ -269,22 +278,29 @@ int FlowRenderer::_paintGL(bool fast)
 
             Progress::StartIndefinite("Performing flowline calculations");
             Progress::Update(0);
-            _advection.AdvectSteps(&_velocityField, deltaT, numOfSteps);
+            _advection.AdvectSteps(&_velocityField, deltaT, numOfSteps, method);
 
             // If the advection is bi-directional
             if (_2ndAdvection) {
                 assert(deltaT > 0.0);
                 auto deltaT2 = deltaT * -1.0;
 
-                _2ndAdvection->AdvectSteps(&_velocityField, deltaT2, numOfSteps);
+                _2ndAdvection->AdvectSteps(&_velocityField, deltaT2, numOfSteps, method);
             }
             Progress::Finish();
         }
 
         // Advection scheme 2: advect to a certain timestamp.
-        // This scheme is used for unsteady flow
+        // This scheme is used for unsteady flow.
+        // The streams are kept from one time step to the next: stepping backward
+        //   cuts them back, and stepping forward only advects the new time steps.
         else {
-            for (int i = 1; i <= _cache_currentTS; i++) { rv = _advection.AdvectTillTime(&_velocityField, _timestamps.at(i - 1), deltaT, _timestamps.at(i)); }
+            double targetT = _timestamps.at(_cache_currentTS);
+            if (_advection.GetFrontierTime() > targetT) _advection.RewindToTime(targetT);
+            for (size_t i = 1; i <= _cache_currentTS; i++) {
+                if (_timestamps.at(i) <= _advection.GetFrontierTime()) continue;
+                rv = _advection.AdvectTillTime(&_velocityField, _timestamps.at(i - 1), deltaT, _timestamps.at(i), method);
+            }
         }
 
         _advectionComplete = true;
@@ -355,15 +371,21 @@ int FlowRenderer::_renderAdvection(const flow::Advection *adv)
             if (int(_cache_currentTS) - _cache_pastNumOfTimeSteps > 0) startingTime = _timestamps[_cache_currentTS - _cache_pastNumOfTimeSteps];
         }
 
+        // Read the particles in place
+        const auto &traj = adv->GetTrajectories();
+        const auto *locations = traj.GetLocations();
+        const auto *times = traj.GetTimes();
+        const auto *values = traj.GetValues();
+
         for (int s = 0; s < nStreams; s++) {
-            const vector<flow::Particle> &stream = adv->GetStreamAt(s);
+            const size_t offset = traj.GetStreamOffset(s);
             sv.clear();
-            int sn = stream.size();
+            int sn = traj.GetStreamSize(s);
             if (_cache_isSteady) sn = std::min(sn, (int)maxSamples);
 
             for (int i = 0; i < sn + 1; i++) {
                 // "IsSpecial" means don't render this sample.
-                if (i == sn || stream[i].IsSpecial()) {
+                if (i == sn || traj.IsSpecial(offset + i)) {
                     int svn = sv.size();
 
                     if (svn < 2) {
@@ -384,13 +406,13 @@ int FlowRenderer::_renderAdvection(const flow::Advection *adv)
                     sizes.push_back(svn + 2);
                     sv.clear();
                 } else {
-                    const flow::Particle &p = stream[i];
+                    const size_t idx = offset + i;
 
                     if (_cache_isSteady) {
-                        sv.push_back({p.location, p.value});
+                        sv.push_back({locations[idx], values[idx]});
                     } else {
-                        if (p.time > _timestamps.at(_cache_currentTS)) continue;
-                        if (p.time >= startingTime) sv.push_back({p.location, p.value});
+                        if (times[idx] > _timestamps.at(_cache_currentTS)) continue;
+                        if (times[idx] >= startingTime) sv.push_back({locations[idx], values[idx]});
                     }
                 }
             }
@@ -586,17 +608,17 @@ glm::vec3 FlowRenderer::_getScales()
 
 int FlowRenderer::_renderFromAnAdvectionLegacy(const flow::Advection *adv, FlowParams *params, bool fast)
 {
-    size_t numOfStreams = adv->GetNumberOfStreams();
-    auto   numOfPart = params->GetSteadyNumOfSteps() + 1;
-    bool   singleColor = params->UseSingleColor();
+    const auto &traj = adv->GetTrajectories();
+    size_t      numOfStreams = adv->GetNumberOfStreams();
+    auto        numOfPart = params->GetSteadyNumOfSteps() + 1;
+    bool        singleColor = params->UseSingleColor();
 
     if (_cache_isSteady) {
         std::vector<float> vec;
         for (size_t s = 0; s < numOfStreams; s++) {
-            const auto &stream = adv->GetStreamAt(s);
-            for (size_t i = 0; i < stream.size() && i < numOfPart; i++) {
-                const auto &p = stream[i];
-                _particleHelper1(vec, p, singleColor);
+            const size_t offset = traj.GetStreamOffset(s);
+            for (size_t i = 0; i < traj.GetStreamSize(s) && i < numOfPart; i++) {
+                _particleHelper1(vec, traj, offset + i, singleColor);
             }    // Finish processing a stream
             if (!vec.empty()) {
                 _drawALineStrip(vec.data(), vec.size() / 4, singleColor);
@@ -611,17 +633,19 @@ int FlowRenderer::_renderFromAnAdvectionLegacy(const flow::Advection *adv, FlowP
 
         std::vector<float> vec;
         for (size_t s = 0; s < numOfStreams; s++) {
-            const auto &stream = adv->GetStreamAt(s);
-            for (const auto &p : stream) {
-                if (p.IsSpecial())    // If p is a separator, directly send it to the helper function
+            const size_t begin = traj.GetStreamOffset(s);
+            const size_t end = begin + traj.GetStreamSize(s);
+            for (size_t idx = begin; idx < end; idx++) {
+                if (traj.IsSpecial(idx))    // If p is a separator, directly send it to the helper function
                 {
-                    _particleHelper1(vec, p, singleColor);
+                    _particleHelper1(vec, traj, idx, singleColor);
                 } else    // Otherwise, examine its timestamp to decide how to handle
                 {         // Finish this stream once we go beyond the current TS
-                    if (p.time > _timestamps.at(_cache_currentTS)) break;
+                    double time = traj.GetTimes()[idx];
+                    if (time > _timestamps.at(_cache_currentTS)) break;
 
                     // Only start this stream if the current time stamp passes startingTime
-                    if (p.time >= startingTime) _particleHelper1(vec, p, singleColor);
+                    if (time >= startingTime) _particleHelper1(vec, traj, idx, singleColor);
                 }
             }    // Finish processing a stream
 
@@ -635,14 +659,15 @@ int FlowRenderer::_renderFromAnAdvectionLegacy(const flow::Advection *adv, FlowP
     return 0;
 }
 
-void FlowRenderer::_particleHelper1(std::vector<float> &vec, const flow::Particle &p, bool singleColor) const
+void FlowRenderer::_particleHelper1(std::vector<float> &vec, const flow::Trajectories &traj, size_t idx, bool singleColor) const
 {
-    if (!p.IsSpecial())    // p isn't a separator
+    if (!traj.IsSpecial(idx))    // p isn't a separator
     {
-        vec.push_back(p.location.x);
-        vec.push_back(p.location.y);
-        vec.push_back(p.location.z);
-        vec.push_back(p.value);
+        const auto &loc = traj.GetLocations()[idx];
+        vec.push_back(loc.x);
+        vec.push_back(loc.y);
+        vec.push_back(loc.z);
+        vec.push_back(traj.GetValues()[idx]);
     } else if (vec.size() > 0)    // p is a separator and vec is non-empty
     {
         _drawALineStrip(vec.data(), vec.size() / 4, singleColor);
@@ -749,6 +774,17 @@ int FlowRenderer::_updateFlowCacheAndStates(const FlowParams *params)
         _velocityStatus = FlowStatus::SIMPLE_OUTOFDATE;
     }
 
+    // Check the integration method and its error tolerance
+    // If either one is changed, then the entire stream is out of date
+    const auto integrator = static_cast<FlowIntegrator>(params->GetIntegrationMethod());
+    const auto tolerance = params->GetIntegrationTolerance();
+    if (_cache_integrator != integrator || (integrator == FlowIntegrator::RK45 && _cache_tolerance != tolerance)) {
+        _colorStatus = FlowStatus::SIMPLE_OUTOFDATE;
+        _velocityStatus = FlowStatus::SIMPLE_OUTOFDATE;
+    }
+    _cache_integrator = integrator;
+    _cache_tolerance = tolerance;
+
     // Check periodicity
     // If periodicity changes along any dimension, then the entire stream is out of date
     // Note: FlowParams return a vector of size either 2 or 3.
@@ -875,9 +911,14 @@ int FlowRenderer::_updateFlowCacheAndStates(const FlowParams *params)
         if (!_cache_isSteady)    // unsteady state isn't changed
         {
             // First consider if the advection needs to be updated.
+            // Moving forward extends the existing streams, and moving backward cuts
+            //   them back; neither one needs new seeds. Only the newly advected
+            //   particles need colors.
             if (_cache_currentTS < params->GetCurrentTimestep()) {
                 if (_colorStatus == FlowStatus::UPTODATE) { _colorStatus = FlowStatus::TIME_STEP_OOD; }
                 if (_velocityStatus == FlowStatus::UPTODATE) { _velocityStatus = FlowStatus::TIME_STEP_OOD; }
+            } else if (_cache_currentTS > params->GetCurrentTimestep()) {
+                if (_velocityStatus == FlowStatus::UPTODATE) { _velocityStatus = FlowStatus::TIME_STEP_OOD; }
             }
 
             // Second consider if the rendering needs to be updated.
@@ -920,33 +961,9 @@ int FlowRenderer::_genSeedsRakeUniform(std::vector<flow::Particle> &seeds) const
     VAssert(dim == 2 || dim == 3);
     VAssert(_cache_rake.size() == dim * 2);
 
-    // Populate the list of seeds
-    float start[3], step[3];
-    for (size_t i = 0; i < dim; i++) {
-        step[i] = (_cache_rake[i * 2 + 1] - _cache_rake[i * 2]) / float(_cache_gridNumOfSeeds[i]);
-        start[i] = _cache_rake[i * 2];
-    }
-    if (dim == 2) {
-        start[2] = Renderer::GetDefaultZ(_dataMgr, params->GetCurrentTimestep());
-        step[2] = 0.0f;
-    }
-    size_t seedsZ = 1;
-    if (dim == 3) { seedsZ = _cache_gridNumOfSeeds[2]; }
-
-    auto      timeVal = _timestamps.at(0);    // Default time value
-    glm::vec3 loc;
-    seeds.clear();
-    seeds.reserve(seedsZ * _cache_gridNumOfSeeds[1] * _cache_gridNumOfSeeds[0]);
-    for (long k = 0; k < seedsZ; k++) {
-        for (long j = 0; j < _cache_gridNumOfSeeds[1]; j++) {
-            for (long i = 0; i < _cache_gridNumOfSeeds[0]; i++) {
-                loc.x = start[0] + (float(i) + 0.5f) * step[0];
-                loc.y = start[1] + (float(j) + 0.5f) * step[1];
-                loc.z = start[2] + (float(k) + 0.5f) * step[2];
-                seeds.emplace_back(loc, timeVal);
-            }
-        }
-    }
+    // Populate the list of seeds. 2D rakes are placed at the default Z.
+    const float dfz = dim == 2 ? Renderer::GetDefaultZ(_dataMgr, params->GetCurrentTimestep()) : 0.0f;
+    seeds = flow::RakeSeedsUniform(_cache_rake, _cache_gridNumOfSeeds, _timestamps.at(0), dfz);
 
     // If in unsteady case and there are multiple seed injections,
     //   we insert more seeds.
@@ -995,32 +1012,10 @@ int FlowRenderer::_genSeedsRakeRandom(std::vector<flow::Particle> &seeds) const
     int dim = _cache_rake.size() / 2;
     for (int i = 0; i < dim; i++) VAssert(_cache_rake[i * 2 + 1] >= _cache_rake[i * 2]);
 
-    /* Create uniform distributions along 2 or 3 dimensions */
-    /* Use a fixed value for the generator seed.          */
-    unsigned int                          randSeed = 32;
-    std::mt19937                          gen(randSeed);    // Standard mersenne_twister_engine
-    std::uniform_real_distribution<float> distX(_cache_rake[0], _cache_rake[1]);
-    std::uniform_real_distribution<float> distY(_cache_rake[2], _cache_rake[3]);
-
-    auto timeVal = _timestamps.at(0);
-    seeds.resize(_cache_randNumOfSeeds);
-    if (dim == 3) {
-        std::uniform_real_distribution<float> distZ(_cache_rake[4], _cache_rake[5]);
-        for (long i = 0; i < _cache_randNumOfSeeds; i++) {
-            seeds[i].location.x = distX(gen);
-            seeds[i].location.y = distY(gen);
-            seeds[i].location.z = distZ(gen);
-            seeds[i].time = timeVal;
-        }
-    } else {
-        const float dfz = Renderer::GetDefaultZ(_dataMgr, params->GetCurrentTimestep());
-        for (long i = 0; i < _cache_randNumOfSeeds; i++) {
-            seeds[i].location.x = distX(gen);
-            seeds[i].location.y = distY(gen);
-            seeds[i].location.z = dfz;
-            seeds[i].time = timeVal;
-        }
-    }
+    /* Use a fixed value for the generator seed. */
+    unsigned int randSeed = 32;
+    const float  dfz = dim == 2 ? Renderer::GetDefaultZ(_dataMgr, params->GetCurrentTimestep()) : 0.0f;
+    seeds = flow::RakeSeedsRandom(_cache_rake, _cache_randNumOfSeeds, randSeed, _timestamps.at(0), dfz);
 
     // If in unsteady case and there are multiple seed injections, we insert more seeds.
     if (!_cache_isSteady && _cache_seedInjInterval > 0) {
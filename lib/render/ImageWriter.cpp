@@ -1,3 +1,5 @@
+#include <cstdarg>
+#include <cstdio>
 #include "vapor/ImageWriter.h"
 #include "vapor/FileUtils.h"
 #include "vapor/PNGWriter.h"
@@ -23,3 +25,13 @@ ImageWriter *ImageWriter::CreateImageWriterForFile(const std::string &path)
 }
 
 void ImageWriter::RegisterFactory(ImageWriterFactory *factory) { factories.push_back(factory); }
+
+void ImageWriter::SetWriteError(const char *format, ...)
+{
+    char    buf[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    writeError = buf;
+}
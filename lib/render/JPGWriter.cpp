@@ -24,9 +24,15 @@ JPGWriter::~JPGWriter()
 int JPGWriter::Write(const unsigned char *buffer, const unsigned int width, const unsigned int height)
 {
     if (!opened) {
-        MyBase::SetErrMsg("Unable to open JPG file for writing: \"%s\"", path.c_str());
+        SetWriteError("Unable to open JPG file for writing: \"%s\"", path.c_str());
         return -1;
     }
 
-    return write_JPEG_file(fp, width, height, const_cast<unsigned char *>(buffer), Quality);
+    // write_JPEG_file() returns a positive int on failure
+    //
+    if (write_JPEG_file(fp, width, height, const_cast<unsigned char *>(buffer), Quality) != 0) {
+        SetWriteError("Failed to write JPG file \"%s\"", path.c_str());
+        return -1;
+    }
+    return 0;
 }
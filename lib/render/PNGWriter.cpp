@@ -1,7 +1,7 @@
 #include "vapor/PNGWriter.h"
 #include "vapor/VAssert.h"
 
-#define USE_PYTHON_PNG 1
+#define USE_PYTHON_PNG 0
 
 #if USE_PYTHON_PNG
     #include "vapor/MyPython.h"
@@ -18,6 +18,11 @@ std::vector<std::string> PNGWriter::GetFileExtensions() { return {"png"}; }
 
 PNGWriter::PNGWriter(const string &path) : ImageWriter(path) {}
 
+// The embedded interpreter may only be used from the main thread. Each
+// libpng write has its own state.
+//
+bool PNGWriter::IsThreadSafe() const { return (!USE_PYTHON_PNG); }
+
 int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, const unsigned int height)
 {
 #if USE_PYTHON_PNG
@@ -28,7 +33,7 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     int rc = Wasp::MyPython::Instance()->Initialize();
     if (rc < 0) {
-        MyBase::SetErrMsg("Failed to initialize python : %s", MyPython::Instance()->PyErr().c_str());
+        SetWriteError("Failed to initialize python : %s", MyPython::Instance()->PyErr().c_str());
         return (-1);
     }
 
@@ -37,7 +42,7 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     if (pModule == NULL) {
         PyErr_Print();
-        MyBase::SetErrMsg("pModule (drawpng) NULL : %s", MyPython::Instance()->PyErr().c_str());
+        SetWriteError("pModule (drawpng) NULL : %s", MyPython::Instance()->PyErr().c_str());
         return -1;
     }
     pFunc = PyObject_GetAttrString(pModule, "drawpng");
@@ -70,12 +75,12 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
         pValue = PyObject_CallObject(pFunc, pArgs);
         if (pValue == NULL) {
             PyErr_Print();
-            MyBase::SetErrMsg("pFunc (drawpng) failed to execute : %s", MyPython::Instance()->PyErr().c_str());
+            SetWriteError("pFunc (drawpng) failed to execute : %s", MyPython::Instance()->PyErr().c_str());
             return -1;
         }
     } else {
         PyErr_Print();
-        MyBase::SetErrMsg("pFunc (drawpng) NULL : %s", MyPython::Instance()->PyErr().c_str());
+        SetWriteError("pFunc (drawpng) NULL : %s", MyPython::Instance()->PyErr().c_str());
         return -1;
     }
 
@@ -87,20 +92,31 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     return 0;
 #else
-    int         code = 0;
-    FILE *      fp = NULL;
-    png_structp png_ptr = NULL;
-    png_infop   info_ptr = NULL;
-    png_bytep   row = NULL;
+    VAssert(format == Format::RGB);
 
-    fp = fopen(file, "wb");
-    if (!fp) return -1;
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        SetWriteError("Unable to open PNG file for writing: \"%s\"", path.c_str());
+        return -1;
+    }
 
-    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (png_ptr == NULL) VAssert(0);
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop   info_ptr = png_ptr ? png_create_info_struct(png_ptr) : NULL;
+    if (!info_ptr) {
+        png_destroy_write_struct(&png_ptr, NULL);
+        fclose(fp);
+        SetWriteError("Failed to initialize libpng");
+        return -1;
+    }
 
-    info_ptr = png_create_info_struct(png_ptr);
-    if (info_ptr == NULL) VAssert(0);
+    // libpng reports errors by jumping back here
+    //
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        fclose(fp);
+        SetWriteError("Failed to write PNG file \"%s\"", path.c_str());
+        return -1;
+    }
 
     png_init_io(png_ptr, fp);
 
@@ -108,12 +124,17 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     png_write_info(png_ptr, info_ptr);
 
-    #error Functionality Not Finished
+    // The first row of the buffer is the top of the image
+    //
+    for (unsigned int y = 0; y < height; y++) png_write_row(png_ptr, const_cast<png_bytep>(buffer + (size_t)y * width * 3));
 
     png_write_end(png_ptr, NULL);
-    if (fp) fclose(fp);
-    if (info_ptr) png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-    if (png_ptr) png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+
+    if (fclose(fp) != 0) {
+        SetWriteError("Failed to write PNG file \"%s\"", path.c_str());
+        return -1;
+    }
 
     return 0;
 #endif
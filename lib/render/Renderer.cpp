@@ -27,6 +27,7 @@
 #include <vapor/glutil.h>    // Must be included first!!!
 #include <vapor/Renderer.h>
 #include <vapor/DataMgrUtils.h>
+#include <vapor/Trace.h>
 #include "vapor/GLManager.h"
 #include "vapor/FontManager.h"
 #include "vapor/LegacyGL.h"
@@ -115,6 +116,7 @@ double Renderer::GetDefaultZ(DataMgr *dataMgr, size_t ts) const
 
 int Renderer::paintGL(bool fast)
 {
+    VTRACE_SCOPE("Renderer::paintGL");
     const RenderParams *rParams = GetActiveParams();
     MatrixManager *     mm = _glManager->matrixManager;
 
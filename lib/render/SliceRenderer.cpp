@@ -24,6 +24,20 @@ using namespace VAPoR;
 
 static RendererRegistrar<SliceRenderer> registrar(SliceRenderer::GetClassType(), SliceParams::GetClassType());
 
+// Sample one row of the texture with a single batched query, storing each
+// value followed by a flag that is set if the value is missing
+//
+static void sampleRow(const Grid *grid, const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &z, std::vector<float> &values, float *dataValues)
+{
+    grid->GetValues(values.size(), x.data(), y.data(), z.data(), values.data());
+
+    float missingValue = grid->GetMissingValue();
+    for (size_t i = 0; i < values.size(); i++) {
+        dataValues[2 * i] = values[i];
+        dataValues[2 * i + 1] = values[i] == missingValue ? 1.f : 0.f;
+    }
+}
+
 SliceRenderer::SliceRenderer(const ParamsMgr *pm, string winName, string dataSetName, string instanceName, DataMgr *dataMgr)
 : Renderer(pm, winName, dataSetName, SliceParams::GetClassType(), SliceRenderer::GetClassType(), instanceName, dataMgr)
 {
@@ -233,29 +247,26 @@ std::vector<double> SliceRenderer::_calculateDeltas() const
 void SliceRenderer::_populateDataXY(float *dataValues, Grid *grid) const
 {
     std::vector<double> deltas = _calculateDeltas();
-    float               varValue, missingValue;
     std::vector<double> coords(3, 0.0);
     coords[X] = _cacheParams.domainMin[X] + deltas[X] / 2.f;
     coords[Y] = _cacheParams.domainMin[Y] + deltas[Y] / 2.f;
     coords[Z] = _cacheParams.boxMin[Z];
 
-    int index = 0;
+    size_t              n = _textureSideSize;
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<float>  values(n);
+
     for (int j = 0; j < _textureSideSize; j++) {
         coords[X] = _cacheParams.domainMin[X];
 
         for (int i = 0; i < _textureSideSize; i++) {
-            varValue = grid->GetValue(coords);
-            missingValue = grid->GetMissingValue();
-            if (varValue == missingValue)
-                dataValues[index + 1] = 1.f;
-            else
-                dataValues[index + 1] = 0.f;
-
-            dataValues[index] = varValue;
-
-            index += 2;
+            x[i] = coords[X];
+            y[i] = coords[Y];
+            z[i] = coords[Z];
             coords[X] += deltas[X];
         }
+        sampleRow(grid, x, y, z, values, dataValues + 2 * j * n);
+
         coords[Y] += deltas[Y];
     }
 }
@@ -263,29 +274,26 @@ void SliceRenderer::_populateDataXY(float *dataValues, Grid *grid) const
 void SliceRenderer::_populateDataXZ(float *dataValues, Grid *grid) const
 {
     std::vector<double> deltas = _calculateDeltas();
-    float               varValue, missingValue;
     std::vector<double> coords(3, 0.0);
     coords[X] = _cacheParams.domainMin[X];
     coords[Y] = _cacheParams.boxMin[Y];
     coords[Z] = _cacheParams.domainMin[Z];
 
-    int index = 0;
+    size_t              n = _textureSideSize;
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<float>  values(n);
+
     for (int j = 0; j < _textureSideSize; j++) {
         coords[X] = _cacheParams.domainMin[X];
 
         for (int i = 0; i < _textureSideSize; i++) {
-            varValue = grid->GetValue(coords);
-            missingValue = grid->GetMissingValue();
-            if (varValue == missingValue)
-                dataValues[index + 1] = 1.f;
-            else
-                dataValues[index + 1] = 0.f;
-
-            dataValues[index] = varValue;
-
-            index += 2;
+            x[i] = coords[X];
+            y[i] = coords[Y];
+            z[i] = coords[Z];
             coords[X] += deltas[X];
         }
+        sampleRow(grid, x, y, z, values, dataValues + 2 * j * n);
+
         coords[Z] += deltas[Z];
     }
 }
@@ -293,29 +301,26 @@ void SliceRenderer::_populateDataXZ(float *dataValues, Grid *grid) const
 void SliceRenderer::_populateDataYZ(float *dataValues, Grid *grid) const
 {
     std::vector<double> deltas = _calculateDeltas();
-    float               varValue, missingValue;
     std::vector<double> coords(3, 0.0);
     coords[X] = _cacheParams.boxMin[X];
     coords[Y] = _cacheParams.domainMin[Y];
     coords[Z] = _cacheParams.domainMin[Z];
 
-    int index = 0;
+    size_t              n = _textureSideSize;
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<float>  values(n);
+
     for (int j = 0; j < _textureSideSize; j++) {
         coords[Y] = _cacheParams.domainMin[Y];
 
         for (int i = 0; i < _textureSideSize; i++) {
-            varValue = grid->GetValue(coords);
-            missingValue = grid->GetMissingValue();
-            if (varValue == missingValue)
-                dataValues[index + 1] = 1.f;
-            else
-                dataValues[index + 1] = 0.f;
-
-            dataValues[index] = varValue;
-
-            index += 2;
+            x[i] = coords[X];
+            y[i] = coords[Y];
+            z[i] = coords[Z];
             coords[Y] += deltas[Y];
         }
+        sampleRow(grid, x, y, z, values, dataValues + 2 * j * n);
+
         coords[Z] += deltas[Z];
     }
 }
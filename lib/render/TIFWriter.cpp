@@ -19,7 +19,7 @@ int TIFWriter::ConfigureWithFormat(ImageWriter::Format f)
         TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
         return 0;
 
-    default: MyBase::SetErrMsg("Unsupported format"); return -1;
+    default: SetWriteError("Unsupported format"); return -1;
     }
 }
 
@@ -38,11 +38,11 @@ TIFWriter::~TIFWriter()
 int TIFWriter::Write(const unsigned char *buffer, const unsigned int width, const unsigned int height)
 {
     if (!opened) {
-        MyBase::SetErrMsg("Unable to open TIF file for writing: \"%s\"", path.c_str());
+        SetWriteError("Unable to open TIF file for writing: \"%s\"", path.c_str());
         return -1;
     }
 
-    ConfigureWithFormat(format);
+    if (ConfigureWithFormat(format) < 0) return -1;
 
     TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
     TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
@@ -51,7 +51,7 @@ int TIFWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     int writeSuccess = TIFFWriteRawStrip(tif, 0, const_cast<unsigned char *>(buffer), width * height * 3);
     if (writeSuccess < 0) {
-        SetErrMsg("TIFF write routine failed");
+        SetWriteError("TIFF write routine failed for \"%s\"", path.c_str());
         return -1;
     }
 
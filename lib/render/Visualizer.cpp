@@ -61,6 +61,7 @@ Visualizer::Visualizer(const ParamsMgr *pm, const DataStatus *dataStatus, string
     _insideGLContext = false;
     _imageCaptureEnabled = false;
     _animationCaptureEnabled = false;
+    _captureWriter = nullptr;
 
     _renderers.clear();
     _renderersToDestroy.clear();
@@ -79,6 +80,7 @@ Visualizer::~Visualizer()
 #endif
 
     if (_vizFeatures) delete _vizFeatures;
+    if (_captureWriter) delete _captureWriter;
 
     if (_screenQuadVAO) glDeleteVertexArrays(1, &_screenQuadVAO);
     if (_screenQuadVBO) glDeleteBuffers(1, &_screenQuadVBO);
@@ -491,6 +493,31 @@ RegionParams *Visualizer::getActiveRegionParams() const { return _paramsMgr->Get
 
 AnnotationParams *Visualizer::getActiveAnnotationParams() const { return _paramsMgr->GetAnnotationParams(_winName); }
 
+int Visualizer::SetAnimationCaptureEnabled(bool onOff, string filename)
+{
+    if (_imageCaptureEnabled) {
+        SetErrMsg("Image capture concurrent with Animation Capture\n");
+        return -1;
+    }
+    if (_animationCaptureEnabled == onOff) {
+        SetErrMsg("Animation capture in incorrect state\n");
+        return -1;
+    }
+    _animationCaptureEnabled = onOff;
+
+    int rc = 0;
+    if (onOff) {
+        _captureImageFile = filename;
+        _captureWriter = new AsyncImageWriter();
+    } else {
+        _captureImageFile = "";
+        rc = _captureWriter->Wait();
+        delete _captureWriter;
+        _captureWriter = nullptr;
+    }
+    return rc;
+}
+
 int Visualizer::_captureImage(std::string path)
 {
     // Turn off the single capture flag
@@ -505,11 +532,19 @@ int Visualizer::_captureImage(std::string path)
 
     bool geoTiffOutput = vpParams->GetProjectionType() == ViewpointParams::MapOrthographic && (FileUtils::Extension(path) == "tif" || FileUtils::Extension(path) == "tiff");
 
+    // Frames of an animation are written by _captureWriter, in buffers
+    // that it owns
+    //
+    AsyncImageWriter *async = _animationCaptureEnabled ? _captureWriter : nullptr;
+
     ImageWriter *  writer = nullptr;
     unsigned char *framebuffer = nullptr;
     int            writeReturn = -1;
 
-    framebuffer = new unsigned char[3 * width * height];
+    if (async)
+        framebuffer = async->AcquireBuffer(3 * width * height);
+    else
+        framebuffer = new unsigned char[3 * width * height];
     if (!_getPixelData(framebuffer))
         ;    // goto captureImageEnd;
 
@@ -575,13 +610,10 @@ int Visualizer::_captureImage(std::string path)
         cropMin[1] = height - cropMax[1];
         cropMax[1] = height - temp;
 
-        unsigned char *croppedFB = new unsigned char[3 * croppedWidth * croppedHeight];
-        for (int y = 0; y < croppedHeight; y++) memcpy(&croppedFB[3 * y * croppedWidth], &framebuffer[3 * ((y + cropMin[1]) * width + cropMin[0])], 3 * croppedWidth);
-
-        delete[] framebuffer;
-        framebuffer = croppedFB;
+        // Crop in place. Each row moves to a lower address.
+        //
+        for (int y = 0; y < croppedHeight; y++) memmove(&framebuffer[3 * y * croppedWidth], &framebuffer[3 * ((y + cropMin[1]) * width + cropMin[0])], 3 * croppedWidth);
 
-        framebuffer = croppedFB;
         s *= croppedHeight / (float)height;
 
         x = (newCameraMaxExtents[0] - newCameraMinExtents[0]) / 2 + newCameraMinExtents[0];
@@ -600,11 +632,23 @@ int Visualizer::_captureImage(std::string path)
         }
     }
 
-    writeReturn = writer->Write(framebuffer, width, height);
+    if (async) {
+        writeReturn = async->Submit(writer, framebuffer, width, height);
+        writer = nullptr;
+        framebuffer = nullptr;
+    } else {
+        writeReturn = writer->Write(framebuffer, width, height);
+        if (writeReturn < 0) SetErrMsg("%s", writer->GetWriteError().c_str());
+    }
 
 captureImageEnd:
     if (writer) delete writer;
-    if (framebuffer) delete[] framebuffer;
+    if (framebuffer) {
+        if (async)
+            async->ReleaseBuffer(framebuffer);
+        else
+            delete[] framebuffer;
+    }
 
     return writeReturn;
 }
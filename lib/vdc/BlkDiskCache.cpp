@@ -0,0 +1,422 @@
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#ifndef WIN32
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <dirent.h>
+    #include <sys/file.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include <vapor/FileUtils.h>
+#include <vapor/SerialUtils.h>
+#include <vapor/BlkDiskCache.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+using namespace std;
+
+namespace {
+
+const uint64_t magic = 0x56415042444b4331ULL;    // "VAPBDKC1"
+
+// Entries are evicted down to this fraction of the budget, so that
+// eviction isn't needed again after every Put()
+//
+const double lowWater = 0.9;
+
+// Temporary files older than this (in seconds) were left behind by a
+// process that died while writing them
+//
+const time_t staleTmp = 3600;
+
+// Most bytes held in the write queue. Entries are dropped while it is
+// full, i.e. while the disk can't keep up.
+//
+const size_t maxQueuedBytes = 256 * 1024 * 1024;
+
+class header {
+public:
+    uint64_t magic;
+    uint64_t keylen;
+    uint64_t nbytes;
+};
+
+#ifndef WIN32
+bool write_all(int fd, const void *buf, size_t n)
+{
+    const char *ptr = (const char *)buf;
+    while (n) {
+        ssize_t rc = write(fd, ptr, n);
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc <= 0) return (false);
+        ptr += rc;
+        n -= rc;
+    }
+    return (true);
+}
+
+bool has_suffix(const string &s, const string &suffix) { return (s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0); }
+#endif
+
+};    // namespace
+
+BlkDiskCache::BlkDiskCache()
+{
+    _maxBytes = 0;
+    _usedBytes = 0;
+    _writtenBytes = 0;
+    _tmpCount = 0;
+    _queuedBytes = 0;
+    _stop = false;
+}
+
+BlkDiskCache::~BlkDiskCache()
+{
+    Close();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cvQueue.notify_all();
+    if (_writer.joinable()) _writer.join();
+}
+
+int BlkDiskCache::Open(const string &dir, size_t maxBytes)
+{
+    SetDiagMsg("BlkDiskCache::Open(%s, %zu)", dir.c_str(), maxBytes);
+
+    Flush();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _dir.clear();
+
+#ifdef WIN32
+    SetErrMsg("Disk cache not supported on this platform");
+    return (-1);
+#else
+    if (dir.empty() || !maxBytes) {
+        SetErrMsg("Invalid disk cache directory or size");
+        return (-1);
+    }
+
+    (void)FileUtils::MakeDir(dir);
+    if (!FileUtils::IsDirectory(dir) || access(dir.c_str(), W_OK) < 0) {
+        SetErrMsg("Can't write disk cache directory %s : %M", dir.c_str());
+        return (-1);
+    }
+
+    _dir = dir;
+    _maxBytes = maxBytes;
+    _stats = Stats();
+
+    // Find the size of the entries left by earlier sessions, trimming
+    // them to the new budget if needed
+    //
+    _usedBytes = _evict(_dir, _maxBytes, _stats.nevicted);
+    _writtenBytes = 0;
+
+    if (!_writer.joinable()) _writer = std::thread(&BlkDiskCache::_writerLoop, this);
+
+    return (0);
+#endif
+}
+
+void BlkDiskCache::Close()
+{
+    Flush();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _dir.clear();
+}
+
+void BlkDiskCache::Flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cvIdle.wait(lock, [this] { return (_queue.empty()); });
+}
+
+bool BlkDiskCache::IsOpen() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (!_dir.empty());
+}
+
+BlkDiskCache::Stats BlkDiskCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_stats);
+}
+
+string BlkDiskCache::_path(const string &key) const
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)SerialUtils::FNV1a(key));
+    return (FileUtils::JoinPaths({_dir, string(buf) + ".blk"}));
+}
+
+bool BlkDiskCache::Get(const string &key, void *buf, size_t nbytes)
+{
+#ifdef WIN32
+    return (false);
+#else
+    string path;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_dir.empty()) return (false);
+
+        // Entries waiting to be written. The writer thread only reads
+        // them, and they stay queued until they are on disk.
+        //
+        for (const auto &p : _queue) {
+            if (p.key == key && p.data.size() == nbytes) {
+                memcpy(buf, p.data.data(), nbytes);
+                _stats.nhits++;
+                _stats.bytes_read += nbytes;
+                return (true);
+            }
+        }
+        path = _path(key);
+    }
+
+    bool   ok = false;
+    size_t size = sizeof(header) + key.size() + nbytes;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && (size_t)st.st_size == size) {
+            void *ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr != MAP_FAILED) {
+                const char *p = (const char *)ptr;
+                header      h;
+                memcpy(&h, p, sizeof(h));
+
+                // Different keys may hash to the same file name
+                //
+                if (h.magic == magic && h.keylen == key.size() && h.nbytes == nbytes && memcmp(p + sizeof(h), key.data(), key.size()) == 0) {
+    #ifdef MADV_SEQUENTIAL
+                    (void)madvise(ptr, size, MADV_SEQUENTIAL);
+    #endif
+                    memcpy(buf, p + sizeof(h) + key.size(), nbytes);
+                    ok = true;
+                }
+                munmap(ptr, size);
+            }
+        }
+
+        // Mark the entry as recently used
+        //
+        if (ok) (void)futimens(fd, NULL);
+        close(fd);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (ok) {
+        _stats.nhits++;
+        _stats.bytes_read += nbytes;
+    } else {
+        _stats.nmisses++;
+    }
+    return (ok);
+#endif
+}
+
+int BlkDiskCache::Put(const string &key, const void *buf, size_t nbytes)
+{
+#ifdef WIN32
+    return (-1);
+#else
+    pending p;
+    size_t  size = sizeof(header) + key.size() + nbytes;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_dir.empty() || size > _maxBytes) return (-1);
+
+        if (_queuedBytes + nbytes > maxQueuedBytes) {
+            SetDiagMsg("BlkDiskCache::Put() - write queue full, entry dropped");
+            return (-1);
+        }
+        _queuedBytes += nbytes;
+
+        p.path = _path(key);
+    }
+
+    // Copy outside of the lock. Readers can't find the entry until it
+    // is queued.
+    //
+    p.key = key;
+    p.data.assign((const char *)buf, (const char *)buf + nbytes);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(p));
+    }
+    _cvQueue.notify_one();
+
+    return (0);
+#endif
+}
+
+// Write an entry to a temporary file and rename it into place, so that
+// readers only ever see complete entries
+//
+bool BlkDiskCache::_write(const pending &p, const string &tmpPath) const
+{
+#ifdef WIN32
+    return (false);
+#else
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        SetDiagMsg("Can't create disk cache file %s : %M", tmpPath.c_str());
+        return (false);
+    }
+
+    header h;
+    h.magic = magic;
+    h.keylen = p.key.size();
+    h.nbytes = p.data.size();
+
+    bool ok = write_all(fd, &h, sizeof(h)) && write_all(fd, p.key.data(), p.key.size()) && write_all(fd, p.data.data(), p.data.size());
+    if (close(fd) < 0) ok = false;
+
+    if (!ok || rename(tmpPath.c_str(), p.path.c_str()) < 0) {
+        SetDiagMsg("Can't write disk cache file %s : %M", tmpPath.c_str());
+        unlink(tmpPath.c_str());
+        return (false);
+    }
+    return (true);
+#endif
+}
+
+void BlkDiskCache::_writerLoop()
+{
+#ifndef WIN32
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _cvQueue.wait(lock, [this] { return (_stop || !_queue.empty()); });
+        if (_queue.empty()) return;
+
+        // References to the front stay valid while Put() appends
+        //
+        const pending &p = _queue.front();
+        size_t         size = sizeof(header) + p.key.size() + p.data.size();
+
+        char suffix[64];
+        snprintf(suffix, sizeof(suffix), ".tmp.%ld.%lu", (long)getpid(), (unsigned long)_tmpCount++);
+        string tmpPath = p.path + suffix;
+        string dir = _dir;
+        size_t maxBytes = _maxBytes;
+
+        lock.unlock();
+        bool ok = _write(p, tmpPath);
+        lock.lock();
+
+        if (ok) {
+            _stats.nwrites++;
+            _stats.bytes_written += p.data.size();
+            _usedBytes += size;
+            _writtenBytes += size;
+        }
+
+        // Other processes may be writing to the directory too, so rescan
+        // it after writing a fraction of the budget even if this process
+        // alone hasn't exceeded it
+        //
+        if (ok && !dir.empty() && (_usedBytes > maxBytes || _writtenBytes > (1.0 - lowWater) * maxBytes)) {
+            _writtenBytes = 0;
+            lock.unlock();
+            size_t nevicted = 0;
+            size_t used = _evict(dir, maxBytes, nevicted);
+            lock.lock();
+            _usedBytes = used;
+            _stats.nevicted += nevicted;
+        }
+
+        _queuedBytes -= _queue.front().data.size();
+        _queue.pop_front();
+        if (_queue.empty()) _cvIdle.notify_all();
+    }
+#endif
+}
+
+// Remove the least recently used entries of dir until the entries fit
+// in the low water mark of maxBytes, and return their total size. Only
+// touches the file system, so _mutex need not be held.
+//
+size_t BlkDiskCache::_evict(const string &dir, size_t maxBytes, size_t &nevicted) const
+{
+#ifdef WIN32
+    return (0);
+#else
+    // Other processes sharing the directory may be evicting as well
+    //
+    string lockPath = FileUtils::JoinPaths({dir, ".lock"});
+    int    lockfd = open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockfd >= 0) (void)flock(lockfd, LOCK_EX);
+
+    class entry {
+    public:
+        string path;
+        size_t size;
+        double mtime;
+    };
+    vector<entry> entries;
+    size_t        total = 0;
+    time_t        now = time(NULL);
+
+    DIR *dirp = opendir(dir.c_str());
+    if (dirp) {
+        struct dirent *dp;
+        while ((dp = readdir(dirp))) {
+            string name = dp->d_name;
+            bool   isTmp = name.find(".tmp.") != string::npos;
+            if (!isTmp && !has_suffix(name, ".blk")) continue;
+
+            entry       e;
+            struct stat st;
+            e.path = FileUtils::JoinPaths({dir, name});
+            if (stat(e.path.c_str(), &st) < 0) continue;
+
+            if (isTmp) {
+                if (now - st.st_mtime > staleTmp) unlink(e.path.c_str());
+                continue;
+            }
+
+            e.size = st.st_size;
+    #ifdef Darwin
+            e.mtime = st.st_mtimespec.tv_sec + 1e-9 * st.st_mtimespec.tv_nsec;
+    #else
+            e.mtime = st.st_mtim.tv_sec + 1e-9 * st.st_mtim.tv_nsec;
+    #endif
+            entries.push_back(e);
+            total += e.size;
+        }
+        closedir(dirp);
+    }
+
+    if (total > maxBytes) {
+        std::sort(entries.begin(), entries.end(), [](const entry &a, const entry &b) { return (a.mtime < b.mtime); });
+
+        size_t target = (size_t)(lowWater * maxBytes);
+        for (size_t i = 0; i < entries.size() && total > target; i++) {
+            if (unlink(entries[i].path.c_str()) < 0) continue;
+            total -= entries[i].size;
+            nevicted++;
+        }
+    }
+
+    if (lockfd >= 0) {
+        (void)flock(lockfd, LOCK_UN);
+        close(lockfd);
+    }
+    return (total);
+#endif
+}
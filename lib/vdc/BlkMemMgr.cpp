@@ -2,10 +2,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <chrono>
+#include <iterator>
 #include <iostream>
 #include <new>
-#ifndef WIN32
+#ifdef WIN32
+    #include <windows.h>
+#else
     #include <unistd.h>
+    #include <sys/mman.h>
 #endif
 
 #include <vapor/BlkMemMgr.h>
@@ -16,101 +21,99 @@ using namespace VAPoR;
 //
 //	Static member initialization
 //
-bool   BlkMemMgr::_page_aligned_req = true;
 size_t BlkMemMgr::_mem_size_max_req = 32768;
 size_t BlkMemMgr::_blk_size_req = 32 * 32 * 32;
 
-bool   BlkMemMgr::_page_aligned = false;
 size_t BlkMemMgr::_mem_size_max = 0;
 size_t BlkMemMgr::_blk_size = 0;
+size_t BlkMemMgr::_mem_size = 0;
 
-vector<size_t>                               BlkMemMgr::_mem_region_sizes;
-vector<unsigned char *>                      BlkMemMgr::_blks;
-vector<vector<BlkMemMgr::_mem_allocation_t>> BlkMemMgr::_mem_regions;
-#ifdef VAPOR3_0_0_ALPHA
-#endif
+std::mutex                                                BlkMemMgr::_mutex;
+std::unordered_map<void *, BlkMemMgr::_mem_allocation_t> BlkMemMgr::_used;
+std::map<size_t, vector<void *>>                         BlkMemMgr::_free;
 
 int BlkMemMgr::_ref_count = 0;
 
-int BlkMemMgr::_Reinit(size_t n)
-{
-    long   page_size = 0;
-    size_t size = 0;
+BlkMemMgr::Stats BlkMemMgr::_stats;
+double           BlkMemMgr::_alloc_time_total = 0.0;
 
-    if (_mem_size_max_req == 0 || _blk_size_req == 0) return (false);
+// Round a request of n blocks up to its size class. Runs of up to
+// eight blocks are exact. Larger runs are rounded up to one of four
+// classes per power of two, which bounds the waste at 25%.
+//
+size_t BlkMemMgr::_SizeClass(size_t n)
+{
+    if (n <= 8) return (n);
 
-    _page_aligned = _page_aligned_req;
-    _mem_size_max = _mem_size_max_req;
-    _blk_size = _blk_size_req;
+    size_t p = 1;
+    while ((p << 1) <= n) p <<= 1;
 
-    //
-    // Calculate starting region size
-    //
-    size_t mem_size = n;
+    size_t step = p >> 2;
+    return (((n + step - 1) / step) * step);
+}
 
-    //
-    // How much total memory already allocated
-    //
-    size_t total_size = 0;
-    int    r;
-    for (r = 0; r < _mem_regions.size(); r++) total_size += _mem_region_sizes[r];
+void *BlkMemMgr::_MapRun(size_t nblks)
+{
+    size_t size = nblks * _blk_size;
 
-    //
-    // New region size is double preceding one
-    //
-    if (r > 0) mem_size = _mem_region_sizes[r - 1] << 1;
+#ifdef WIN32
+    void *ptr = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    return (ptr);
+#else
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return (NULL);
 
-    // Make sure region size will be large enough, and not too large
+    #ifdef MADV_HUGEPAGE
+    // Large runs are touched sequentially and live for a long time,
+    // which is where huge pages pay off. Failure is harmless.
     //
-    if (mem_size < n) mem_size = n;
-    if ((mem_size + total_size) > _mem_size_max) mem_size = _mem_size_max - total_size;
+    (void)madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
 
-    if (mem_size < n) return (false);
+    return (ptr);
+#endif
+}
 
-    if (_page_aligned) {
+void BlkMemMgr::_UnmapRun(void *ptr, size_t nblks)
+{
 #ifdef WIN32
-        page_size = 4096;
+    VirtualFree(ptr, 0, MEM_RELEASE);
 #else
-        page_size = sysconf(_SC_PAGESIZE);
-        if (page_size < 0) page_size = 0;
+    munmap(ptr, nblks * _blk_size);
 #endif
-    }
-
-    unsigned char *blks;
-    do {
-        size = (size_t)_blk_size * (size_t)mem_size;
-        size += (size_t)page_size;
-
-        blks = new (nothrow) unsigned char[size];
-        if (!blks) {
-            SetDiagMsg("BlkMemMgr::_Reinit() : failed to allocate %d blocks, retrying", mem_size);
-            mem_size = mem_size >> 1;
-        }
-    } while (blks == NULL && mem_size > 0 && _blk_size > 0);
+}
 
-    if (!blks && mem_size > 0 && _blk_size > 0) {
-        SetDiagMsg("Memory allocation of %lu bytes failed", size);
-        return (false);
-    } else {
-        SetDiagMsg("BlkMemMgr() : allocated %lu bytes", size);
+// Return cached runs to the OS, largest first, until a new run of n
+// blocks fits in the pool. Must be called with _mutex held.
+//
+bool BlkMemMgr::_ReleaseCached(size_t n)
+{
+    while (_mem_size + n > _mem_size_max && !_free.empty()) {
+        auto   itr = std::prev(_free.end());
+        size_t nblks = itr->first;
+        void * ptr = itr->second.back();
+        itr->second.pop_back();
+        if (itr->second.empty()) _free.erase(itr);
+
+        _UnmapRun(ptr, nblks);
+        _mem_size -= nblks;
+        _stats.bytes_cached -= nblks * _blk_size;
+        _stats.nreleased++;
     }
+    return (_mem_size + n <= _mem_size_max);
+}
 
-    unsigned char *blkptr = blks;
-
-    if (page_size) { blkptr += page_size - (((size_t)blks) % page_size); }
-
-    _mem_allocation_t         m;
-    vector<_mem_allocation_t> mem_region;
-    m._nfree = mem_size;
-    m._nused = 0;
-    m._blk = blkptr;
-    mem_region.push_back(m);
-
-    _mem_regions.push_back(mem_region);
-    _blks.push_back(blks);
-    _mem_region_sizes.push_back(mem_size);
-
-    return (true);
+// Must be called with _mutex held.
+//
+void BlkMemMgr::_ReleaseAll()
+{
+    for (auto &itr : _free) {
+        for (auto ptr : itr.second) _UnmapRun(ptr, itr.first);
+    }
+    for (auto &itr : _used) { _UnmapRun(itr.first, itr.second._class); }
+    _free.clear();
+    _used.clear();
+    _mem_size = 0;
 }
 
 int BlkMemMgr::RequestMemSize(size_t blk_size, size_t num_blks, bool page_aligned)
@@ -126,17 +129,34 @@ int BlkMemMgr::RequestMemSize(size_t blk_size, size_t num_blks, bool page_aligne
         return (-1);
     }
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     _blk_size_req = blk_size;
     _mem_size_max_req = num_blks;
-    _page_aligned_req = page_aligned;
 
     return (0);
 }
 
+BlkMemMgr::Stats BlkMemMgr::GetStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Stats stats = _stats;
+    stats.bytes_max = _mem_size_max * _blk_size;
+
+    size_t reserved = stats.bytes_in_use + stats.bytes_cached;
+    stats.fragmentation = reserved ? 1.0 - ((double)stats.bytes_requested / (double)reserved) : 0.0;
+    stats.alloc_time_mean = stats.nallocs ? _alloc_time_total / (double)stats.nallocs : 0.0;
+
+    return (stats);
+}
+
 BlkMemMgr::BlkMemMgr()
 {
     SetDiagMsg("BlkMemMgr::BlkMemMgr()");
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     //
     // If there are no other instances of this object, re-initialized
     // the static memory pool if needed
@@ -146,17 +166,14 @@ BlkMemMgr::BlkMemMgr()
         return;
     }
 
-    for (int i = 0; i < _blks.size(); i++) {
-        if (_blks[i]) delete[] _blks[i];
-    }
-    _mem_regions.clear();
-    _mem_region_sizes.clear();
-    _blks.clear();
+    _ReleaseAll();
 
-    _page_aligned = _page_aligned_req;
     _mem_size_max = _mem_size_max_req;
     _blk_size = _blk_size_req;
 
+    _stats = Stats();
+    _alloc_time_total = 0.0;
+
     _ref_count = 1;
 }
 
@@ -164,63 +181,78 @@ BlkMemMgr::~BlkMemMgr()
 {
     SetDiagMsg("BlkMemMgr::~BlkMemMgr()");
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     if (_ref_count > 0) _ref_count--;
 
     if (_ref_count != 0) return;
 
-    for (int i = 0; i < _blks.size(); i++) {
-        if (_blks[i]) delete[] _blks[i];
-    }
-    _blks.clear();
-    _mem_regions.clear();
-    _mem_region_sizes.clear();
+    _ReleaseAll();
 }
 
 void *BlkMemMgr::Alloc(size_t n, bool fill)
 {
     SetDiagMsg("BlkMemMgr::Alloc(%d)", n);
 
-    //
-    // Check each region, find the first run of blocks large enough
-    // to satisfy the request
-    //
+    auto t0 = std::chrono::steady_clock::now();
+
+    size_t nblks = _SizeClass(n);
+
     void *blk = NULL;
-    for (int r = 0; r < _mem_regions.size() && !blk; r++) {
-        vector<_mem_allocation_t> &mem_region = _mem_regions[r];
-        for (int i = 0; i < mem_region.size() && !blk; i++) {
-            if (n <= mem_region[i]._nfree) {    // Found a run of blocks
-                blk = mem_region[i]._blk;
-                mem_region[i]._nused = n;
-
-                //
-                // If run is strictly larger than request split it
-                //
-                if (n < mem_region[i]._nfree) {
-                    _mem_allocation_t m;
-                    m._nfree = mem_region[i]._nfree - n;
-                    m._nused = 0;
-                    m._blk = (unsigned char *)mem_region[i]._blk + (_blk_size * n);
-                    mem_region.insert(mem_region.begin() + i + 1, m);
-                }
-                mem_region[i]._nfree = 0;
+    bool  reused = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Don't let rounding turn a request that fits into one that doesn't
+        //
+        if (nblks > _mem_size_max) nblks = n;
+
+        // Reuse a cached run of the same size class if there is one.
+        // Otherwise map a new run, making room by releasing cached runs
+        // of other classes if needed.
+        //
+        auto itr = _free.find(nblks);
+        if (itr != _free.end()) {
+            blk = itr->second.back();
+            itr->second.pop_back();
+            if (itr->second.empty()) _free.erase(itr);
+            _stats.bytes_cached -= nblks * _blk_size;
+            reused = true;
+        } else if (_ReleaseCached(nblks)) {
+            blk = _MapRun(nblks);
+            if (blk) {
+                _mem_size += nblks;
+            } else {
+                SetDiagMsg("Memory allocation of %lu bytes failed", nblks * _blk_size);
             }
         }
-    }
 
-    if (!blk) {
-        // Couldn't find space in existing memory pool.
-        // Try to allocate more memory.
-        //
-        if (!BlkMemMgr::_Reinit(n)) return (NULL);
+        if (!blk) {
+            _stats.nfailed++;
+            return (NULL);
+        }
 
-        return (Alloc(n, fill));
-    }
+        _mem_allocation_t m;
+        m._class = nblks;
+        m._requested = n;
+        _used[blk] = m;
 
-    if (fill) {
-        unsigned char *ptr = (unsigned char *)blk;
-        for (size_t i = 0; i < n * _blk_size; i++) ptr[i] = 0;
+        _stats.bytes_in_use += nblks * _blk_size;
+        _stats.bytes_requested += n * _blk_size;
+        _stats.nallocs++;
     }
 
+    // Newly mapped runs are already zero, and are populated by the
+    // thread that first touches them
+    //
+    if (fill && reused) memset(blk, 0, n * _blk_size);
+
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _alloc_time_total += t;
+    if (t > _stats.alloc_time_max) _stats.alloc_time_max = t;
+
     return (blk);
 }
 
@@ -228,35 +260,22 @@ void BlkMemMgr::FreeMem(void *ptr)
 {
     SetDiagMsg("BlkMemMgr::FreeMem()");
 
-    bool found = false;
-    for (int r = 0; r < _mem_regions.size() && !found; r++) {
-        vector<_mem_allocation_t> &mem_region = _mem_regions[r];
-        for (int i = 0; i < mem_region.size() && !found; i++) {
-            if (ptr == mem_region[i]._blk) {
-                found = true;
-                mem_region[i]._nfree = mem_region[i]._nused;
-                mem_region[i]._nused = 0;
-            }
-        }
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto itr = _used.find(ptr);
+    if (itr == _used.end()) {
+        cerr << "Failed to free block " << ptr << endl;
+        return;
     }
-    if (!found) cerr << "Failed to free block " << ptr << endl;
 
-    //
-    // Collapse any two adjacent runs of they're both free
-    //
-    bool collapse;
-    do {
-        collapse = false;
-        for (int r = 0; r < _mem_regions.size(); r++) {
-            vector<_mem_allocation_t> &mem_region = _mem_regions[r];
-            for (int i = 0; i < mem_region.size() - 1; i++) {
-                if (mem_region[i]._nfree && mem_region[i + 1]._nfree) {
-                    mem_region[i]._nfree += mem_region[i + 1]._nfree;
-                    mem_region.erase(mem_region.begin() + i + 1);
-                    collapse = true;
-                    break;
-                }
-            }
-        }
-    } while (collapse);
+    size_t nblks = itr->second._class;
+    size_t n = itr->second._requested;
+    _used.erase(itr);
+
+    _free[nblks].push_back(ptr);
+
+    _stats.bytes_in_use -= nblks * _blk_size;
+    _stats.bytes_requested -= n * _blk_size;
+    _stats.bytes_cached += nblks * _blk_size;
+    _stats.nfrees++;
 }
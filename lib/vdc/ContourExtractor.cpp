@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vapor/Grid.h>
+#include <vapor/ContourExtractor.h>
+
+using namespace VAPoR;
+using namespace std;
+
+ContourExtractor::ContourExtractor(size_t maxKeys, int nThreads) : _maxKeys(maxKeys ? maxKeys : 1), _nThreads(nThreads)
+{
+    if (_nThreads < 1) _nThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+vector<double> ContourExtractor::GetMissing(const string &key, const vector<double> &contours) const
+{
+    auto itr = _cache.find(key);
+    if (itr == _cache.end()) return (contours);
+
+    vector<double> missing;
+    for (auto c : contours) {
+        if (itr->second.find(c) == itr->second.end()) missing.push_back(c);
+    }
+    return (missing);
+}
+
+ContourExtractor::Segments &ContourExtractor::_getSegments(const string &key)
+{
+    auto itr = std::find(_lru.begin(), _lru.end(), key);
+    if (itr != _lru.end()) _lru.erase(itr);
+    _lru.push_front(key);
+
+    while (_lru.size() > _maxKeys) {
+        _cache.erase(_lru.back());
+        _lru.pop_back();
+    }
+    return (_cache[key]);
+}
+
+void ContourExtractor::Extract(const string &key, const Grid *grid, const Grid *heightGrid, float defaultZ, const vector<double> &minu, const vector<double> &maxu,
+                               const vector<double> &contours)
+{
+    Segments &segments = _getSegments(key);
+
+    // Sorted, unique values still to be extracted
+    //
+    vector<double> todo;
+    for (auto c : contours) {
+        if (segments.find(c) == segments.end()) todo.push_back(c);
+    }
+    std::sort(todo.begin(), todo.end());
+    todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+    if (todo.empty()) return;
+
+    // Comparisons are done in single precision, like the vertex data
+    //
+    vector<float> values(todo.begin(), todo.end());
+    size_t        nValues = values.size();
+
+    vector<size_t> cdims = grid->GetCellDimensions();
+    size_t         nCells = 1;
+    for (auto d : cdims) nCells *= d;
+    if (cdims.empty() || !nCells) {
+        for (auto c : todo) segments[c];
+        return;
+    }
+
+    float  mv = grid->GetMissingValue();
+    size_t maxNodes = grid->GetMaxVertexPerCell();
+
+    // The grid returned for a box is usually block aligned, so it may
+    // extend past the box. Only the horizontal axes the grid has are
+    // tested.
+    //
+    size_t boxDim = std::min(std::min(minu.size(), maxu.size()), std::min(grid->GetGeometryDim(), (size_t)2));
+
+    // Consecutive ranges of cells are handed out to threads. Tiles are
+    // merged in order afterwards so the result doesn't depend on the
+    // number of threads.
+    //
+    size_t nTiles = std::min(nCells, (size_t)_nThreads * 8);
+    size_t tileSize = (nCells + nTiles - 1) / nTiles;
+    nTiles = (nCells + tileSize - 1) / tileSize;
+
+    vector<vector<vector<Vertex>>> tiles(nTiles, vector<vector<Vertex>>(nValues));
+    std::atomic<size_t>            nextTile(0);
+
+    auto worker = [&]() {
+        vector<Size_tArr3> nodes(maxNodes);
+        vector<float>      v(maxNodes);
+        vector<float>      h(maxNodes);
+        vector<DblArr3>    coords(maxNodes);
+
+        for (size_t tile = nextTile++; tile < nTiles; tile = nextTile++) {
+            vector<vector<Vertex>> &out = tiles[tile];
+            size_t                  end = std::min(nCells, (tile + 1) * tileSize);
+
+            for (size_t l = tile * tileSize; l < end; l++) {
+                Size_tArr3 cell = {0, 0, 0};
+                size_t     rem = l;
+                for (size_t i = 0; i < cdims.size() && i < 3; i++) {
+                    cell[i] = rem % cdims[i];
+                    rem /= cdims[i];
+                }
+
+                if (!grid->GetCellNodes(cell, nodes)) continue;
+                size_t n = nodes.size();
+                if (n < 2) continue;
+
+                bool  hasMissing = false;
+                float vmin = 0.0, vmax = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    v[i] = grid->GetValueAtIndex(nodes[i]);
+                    if (v[i] == mv) {
+                        hasMissing = true;
+                        break;
+                    }
+                    if (i == 0 || v[i] < vmin) vmin = v[i];
+                    if (i == 0 || v[i] > vmax) vmax = v[i];
+                }
+                if (hasMissing) continue;
+
+                // An edge crosses contour c if exactly one of its end
+                // points is greater than c, so the cell is crossed by
+                // the contours in [vmin, vmax)
+                //
+                size_t first = std::lower_bound(values.begin(), values.end(), vmin) - values.begin();
+                if (first == nValues || values[first] >= vmax) continue;
+
+                bool outside = false;
+                for (size_t i = 0; i < n && !outside; i++) {
+                    grid->GetUserCoordinates(nodes[i], coords[i]);
+                    for (size_t d = 0; d < boxDim; d++) {
+                        if (coords[i][d] < minu[d] || coords[i][d] > maxu[d]) outside = true;
+                    }
+                    if (heightGrid) h[i] = heightGrid->GetValueAtIndex(nodes[i]);
+                }
+                if (outside) continue;
+
+                for (size_t ci = first; ci < nValues && values[ci] < vmax; ci++) {
+                    float contour = values[ci];
+                    for (size_t a = n - 1, b = 0; b < n; a = b, b++) {
+                        if ((v[a] <= contour && v[b] <= contour) || (v[a] > contour && v[b] > contour)) continue;
+
+                        float  t = (contour - v[a]) / (v[b] - v[a]);
+                        Vertex vert;
+                        vert.x = coords[a][0] + t * (coords[b][0] - coords[a][0]);
+                        vert.y = coords[a][1] + t * (coords[b][1] - coords[a][1]);
+                        vert.z = heightGrid ? h[a] + t * (h[b] - h[a]) : defaultZ;
+                        vert.v = contour;
+                        out[ci].push_back(vert);
+                    }
+                }
+            }
+        }
+    };
+
+    int nThreads = (int)std::min((size_t)_nThreads, nTiles);
+
+    vector<std::thread> threads;
+    for (int i = 1; i < nThreads; i++) threads.push_back(std::thread(worker));
+    worker();
+    for (auto &t : threads) t.join();
+
+    for (size_t ci = 0; ci < nValues; ci++) {
+        vector<Vertex> &dst = segments[todo[ci]];
+        size_t          n = 0;
+        for (size_t tile = 0; tile < nTiles; tile++) n += tiles[tile][ci].size();
+        dst.reserve(n);
+        for (size_t tile = 0; tile < nTiles; tile++) dst.insert(dst.end(), tiles[tile][ci].begin(), tiles[tile][ci].end());
+    }
+}
+
+void ContourExtractor::GetSegments(const string &key, const vector<double> &contours, vector<Vertex> &vertices) const
+{
+    vertices.clear();
+
+    auto itr = _cache.find(key);
+    if (itr == _cache.end()) return;
+
+    for (auto c : contours) {
+        auto sitr = itr->second.find(c);
+        if (sitr == itr->second.end()) continue;
+        vertices.insert(vertices.end(), sitr->second.begin(), sitr->second.end());
+    }
+}
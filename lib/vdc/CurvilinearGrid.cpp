@@ -3,6 +3,7 @@
 #include "vapor/VAssert.h"
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 #include <limits>
 #include <vapor/utils.h>
 #include <vapor/CurvilinearGrid.h>
@@ -12,6 +13,15 @@
 using namespace std;
 using namespace VAPoR;
 
+namespace {
+
+// Maximum number of faces crossed by _walkToFace() before falling back to
+// the quad tree
+//
+const int maxWalk = 16;
+
+};    // namespace
+
 void CurvilinearGrid::_curvilinearGrid(const RegularGrid &xrg, const RegularGrid &yrg, const RegularGrid &zrg, const vector<double> &zcoords,
                                        std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr)
 {
@@ -28,6 +38,16 @@ void CurvilinearGrid::_curvilinearGrid(const RegularGrid &xrg, const RegularGrid
     if (!_qtr) { _qtr = _makeQuadTreeRectangle(); }
 }
 
+const vector<float> &CurvilinearGrid::_getColumnBounds() const
+{
+    // Built on the first point query. Most grids are never searched.
+    //
+    std::call_once(_columnBoundsOnce, [this]() {
+        if (_terrainFollowing) MakeColumnBounds(_zrg, _columnBounds);
+    });
+    return (_columnBounds);
+}
+
 CurvilinearGrid::CurvilinearGrid(const vector<size_t> &dims, const vector<size_t> &bs, const vector<float *> &blks, const RegularGrid &xrg, const RegularGrid &yrg, const vector<double> &zcoords,
                                  std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr)
 : StructuredGrid(dims, bs, blks)
@@ -557,26 +577,50 @@ bool CurvilinearGrid::_insideGridHelperTerrain(double x, double y, double z, con
         if (!inside) return (false);
     }
 
-    float z0, z1;
+    size_t nz = GetDimensions()[2];
 
-    // Find k index of cell containing z. Already know i and j indices
+    // Points above or below the column of cells are rejected without
+    // interpolating any levels
     //
-    size_t         nz = GetDimensions()[2];
-    vector<double> zcoords(nz);
-    for (int kk = 0; kk < nz; kk++) {
-        // Interpolate Z coordinate across triangle
-        //
+    size_t nx = GetDimensions()[0];
+    const vector<float> &bounds = _getColumnBounds();
+    if (!bounds.empty() && i < nx - 1 && j < GetDimensions()[1] - 1) {
+        size_t c = 2 * (j * (nx - 1) + i);
+        if (z < bounds[c] || z > bounds[c + 1]) return (false);
+    }
+
+    // Z coordinate of level kk, interpolated across the triangle
+    //
+    auto zcoord = [&](size_t kk) -> double {
         float zk = _zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2];
+        return (zk);
+    };
 
-        zcoords[kk] = zk;
+    // Find k index of cell containing z. Already know i and j indices.
+    // If the last query was in this or a neighbouring column try its layer
+    // first, then search the levels, interpolating only the ones the
+    // search visits
+    //
+    float      z0, z1;
+    bool       found = false;
+    Size_tArr3 hint;
+    if (GetCellHint(hint) && hint[2] + 1 < nz && hint[0] + 1 >= i && hint[0] <= i + 1 && hint[1] + 1 >= j && hint[1] <= j + 1) {
+        z0 = zcoord(hint[2]);
+        z1 = zcoord(hint[2] + 1);
+        if ((z0 <= z && z < z1) || (z0 >= z && z > z1)) {
+            k = hint[2];
+            found = true;
+        }
     }
 
-    if (!Wasp::BinarySearchRange(zcoords, z, k)) return (false);
+    if (!found) {
+        if (!Wasp::BinarySearchRange(nz, zcoord, z, k)) return (false);
 
-    VAssert(k < nz - 1);
+        VAssert(k < nz - 1);
 
-    z0 = zcoords[k];
-    z1 = zcoords[k + 1];
+        z0 = zcoord(k);
+        z1 = zcoord(k + 1);
+    }
 
     zwgt[0] = 1.0 - (z - z0) / (z1 - z0);
     zwgt[1] = 1.0 - zwgt[0];
@@ -584,6 +628,64 @@ bool CurvilinearGrid::_insideGridHelperTerrain(double x, double y, double z, con
     return (true);
 }
 
+// Walk from face (i, j) towards the point (x, y), crossing at each step the
+// edge the point lies furthest outside of. Returns true with the face
+// that has the point on the inner side of all of its edges, or false if
+// the walk leaves the grid or takes too many steps.
+//
+bool CurvilinearGrid::_walkToFace(double x, double y, size_t &i, size_t &j) const
+{
+    const vector<size_t> &dims = GetDimensions();
+    if (i + 1 >= dims[0] || j + 1 >= dims[1]) return (false);
+
+    for (int step = 0; step < maxWalk; step++) {
+        // Corners in index order around the face: (i,j), (i+1,j),
+        // (i+1,j+1), (i,j+1). The edge starting at corner e is crossed
+        // to reach the face at offset di[e], dj[e]
+        //
+        const int di[] = {0, 1, 0, -1};
+        const int dj[] = {-1, 0, 1, 0};
+        double    px[] = {_xrg.AccessIJK(i, j), _xrg.AccessIJK(i + 1, j), _xrg.AccessIJK(i + 1, j + 1), _xrg.AccessIJK(i, j + 1)};
+        double    py[] = {_yrg.AccessIJK(i, j), _yrg.AccessIJK(i + 1, j), _yrg.AccessIJK(i + 1, j + 1), _yrg.AccessIJK(i, j + 1)};
+
+        // The sign of the area gives the orientation of the corners in
+        // user coordinates
+        //
+        double area = 0.0;
+        for (int e = 0; e < 4; e++) area += px[e] * py[(e + 1) % 4] - px[(e + 1) % 4] * py[e];
+        if (area == 0.0) return (false);
+
+        int    worst = -1;
+        double worstDist = 0.0;
+        double maxLen = 0.0;
+        for (int e = 0; e < 4; e++) {
+            double ex = px[(e + 1) % 4] - px[e];
+            double ey = py[(e + 1) % 4] - py[e];
+            double len = std::sqrt(ex * ex + ey * ey);
+            if (len == 0.0) continue;
+            maxLen = std::max(maxLen, len);
+
+            double dist = (ex * (y - py[e]) - ey * (x - px[e])) / len;
+            if (area < 0.0) dist = -dist;
+            if (dist < worstDist) {
+                worst = e;
+                worstDist = dist;
+            }
+        }
+        if (worst < 0) return (true);
+
+        // Give up at once on points that are too far away to be reached
+        //
+        if (step == 0 && -worstDist > maxWalk * maxLen) return (false);
+
+        if ((di[worst] < 0 && i == 0) || (dj[worst] < 0 && j == 0)) return (false);
+        if ((di[worst] > 0 && i + 2 >= dims[0]) || (dj[worst] > 0 && j + 2 >= dims[1])) return (false);
+        i += di[worst];
+        j += dj[worst];
+    }
+    return (false);
+}
+
 bool CurvilinearGrid::_insideFace(const Size_tArr3 &face, double pt[2], double lambda[4], vector<Size_tArr3> &nodes) const
 {
     DblArr3 verts[4];    // space for 4 vertices with 3D user coordinates
@@ -632,15 +734,29 @@ bool CurvilinearGrid::_insideGrid(double x, double y, double z, size_t &i, size_
     const vector<size_t> &dims = StructuredGrid::GetDimensions();
     size_t                dims2d[] = {dims[0], dims[1]};
 
-    // Find the indices for the faces that might contain the point
-    //
-    vector<size_t> face_indices;
-    _qtr->GetPayloadContained(x, y, face_indices);
-
     bool               inside = false;
     double             pt[] = {x, y};
     Size_tArr3         face = {0, 0, 0};
     vector<Size_tArr3> nodes(8);
+
+    // Coherent queries usually find their face at, or a few faces from,
+    // the face found by the last query
+    //
+    Size_tArr3 hint;
+    if (GetCellHint(hint) && _walkToFace(x, y, hint[0], hint[1])) {
+        face = {hint[0], hint[1], 0};
+        if (_insideFace(face, pt, lambda, nodes)) {
+            i = face[0];
+            j = face[1];
+            inside = true;
+        }
+    }
+
+    // Otherwise find the indices for the faces that might contain the point
+    //
+    vector<size_t> face_indices;
+    if (!inside) _qtr->GetPayloadContained(x, y, face_indices);
+
     for (int ii = 0; ii < face_indices.size(); ii++) {
         Wasp::VectorizeCoords(face_indices[ii], dims2d, face.data(), 2);
         face[2] = 0;    // _insideFace expects 3D coordinates
@@ -657,14 +773,18 @@ bool CurvilinearGrid::_insideGrid(double x, double y, double z, size_t &i, size_
     if (GetGeometryDim() == 2) {
         zwgt[0] = 1.0;
         zwgt[1] = 0.0;
+        SetCellHint(face);
         return (true);
     }
 
     if (_terrainFollowing) {
-        return (_insideGridHelperTerrain(x, y, z, face[0], face[1], k, zwgt));
+        inside = _insideGridHelperTerrain(x, y, z, face[0], face[1], k, zwgt);
     } else {
-        return (_insideGridHelperStretched(z, k, zwgt));
+        inside = _insideGridHelperStretched(z, k, zwgt);
     }
+
+    if (inside) SetCellHint({face[0], face[1], k});
+    return (inside);
 }
 
 std::shared_ptr<QuadTreeRectangle<float, size_t>> CurvilinearGrid::_makeQuadTreeRectangle() const
@@ -676,8 +796,16 @@ std::shared_ptr<QuadTreeRectangle<float, size_t>> CurvilinearGrid::_makeQuadTree
     std::shared_ptr<QuadTreeRectangle<float, size_t>> qtr = std::make_shared<QuadTreeRectangle<float, size_t>>((float)_minu[0], (float)_minu[1], (float)_maxu[0], (float)_maxu[1], 12, reserve_size);
 
     // Loop over horizontal dimensions only - the grid, if 3D, is layered.
-    // There are dims2d[i]-1 cells (faces) along each dimension.
+    // There are dims2d[i]-1 cells (faces) along each dimension. The
+    // bounding rectangles of all the cells are found first, and then
+    // inserted into the tree at once.
     //
+    size_t         nfaces = (dims2d[0] - 1) * (dims2d[1] - 1);
+    vector<float>  rects;
+    vector<size_t> payloads;
+    rects.reserve(4 * nfaces);
+    payloads.reserve(nfaces);
+
     float coords[2];
     for (size_t j = 0; j < dims2d[1] - 1; j++) {
         for (size_t i = 0; i < dims2d[0] - 1; i++) {
@@ -701,9 +829,11 @@ std::shared_ptr<QuadTreeRectangle<float, size_t>> CurvilinearGrid::_makeQuadTree
             // face index is index of first node in the face
             //
             vector<size_t> face = {i, j};
-            qtr->Insert(left, top, right, bottom, Wasp::LinearizeCoords(face, dims2d));
+            rects.insert(rects.end(), {left, top, right, bottom});
+            payloads.push_back(Wasp::LinearizeCoords(face, dims2d));
         }
     }
+    qtr->Insert(rects, payloads);
 
 #ifdef DEBUG
     vector<size_t> payload_histo;
@@ -63,6 +63,7 @@ int DCCF::initialize(const vector<string> &paths, const std::vector<string> &opt
 
     // Initialize the NetCDFCFCollection class.
     //
+    ncdfc->SetIndexDir(NetCDFCollection::IndexDirFromOptions(options));
     int rc = ncdfc->Initialize(paths);
     if (rc < 0) {
         SetErrMsg("Failed to initialize netCDF data collection for reading");
@@ -228,6 +228,8 @@ DCMPAS::DCMPAS()
     _pointVars.clear();
     _edgeVars.clear();
     _hasVertical = false;
+    _nEdgesOnCellTS = -1;
+    _coordinatesTS = -1;
 }
 
 DCMPAS::~DCMPAS()
@@ -242,6 +244,9 @@ DCMPAS::~DCMPAS()
 
 int DCMPAS::initialize(const vector<string> &files, const std::vector<string> &options)
 {
+    _nEdgesOnCellTS = -1;
+    _coordinatesTS = -1;
+
     // Use UDUnits for unit conversion
     //
     int rc = _udunits.Initialize();
@@ -255,6 +260,7 @@ int DCMPAS::initialize(const vector<string> &files, const std::vector<string> &o
     // Initialize NetCDFCollection class
     //
     vector<string> time_dimnames(1, timeDimName);
+    ncdfc->SetIndexDir(NetCDFCollection::IndexDirFromOptions(options));
     rc = ncdfc->Initialize(files, time_dimnames, vector<string>());
     if (rc < 0) {
         SetErrMsg("Failed to initialize netCDF data collection for reading");
@@ -538,6 +544,12 @@ int DCMPAS::getDimLensAtLevel(string varname, int, std::vector<size_t> &dims_at_
 //
 int DCMPAS::_read_nEdgesOnCell(size_t ts)
 {
+    // Connectivity is read in pieces by region of interest reads, so
+    // don't read the same time step again
+    //
+    if (_nEdgesOnCellTS == (long)ts) return (0);
+    _nEdgesOnCellTS = -1;
+
     DC::Dimension dimension;
     bool          ok = GetDimension(nCellsDimName, dimension);
     if (!ok) {
@@ -553,7 +565,11 @@ int DCMPAS::_read_nEdgesOnCell(size_t ts)
     int rc = _ncdfc->Read(buf, fd);
     if (rc < 0) return (fd);
 
-    return (_ncdfc->Close(fd));
+    rc = _ncdfc->Close(fd);
+    if (rc < 0) return (rc);
+
+    _nEdgesOnCellTS = ts;
+    return (0);
 }
 
 // Read a floating point variable (data or coordinate) into a SmartBuf
@@ -583,12 +599,16 @@ int DCMPAS::_readVarToSmartBuf(size_t ts, string varname, Wasp::SmartBuf &smartB
 //
 int DCMPAS::_readCoordinates(size_t ts)
 {
+    if (_coordinatesTS == (long)ts) return (0);
+    _coordinatesTS = -1;
+
     int rc = _readVarToSmartBuf(ts, lonCellVarName, _lonCellSmartBuf);
     if (rc < 0) return (rc);
 
     rc = _readVarToSmartBuf(ts, lonVertexVarName, _lonVertexSmartBuf);
     if (rc < 0) return (rc);
 
+    _coordinatesTS = ts;
     return (0);
 }
 
@@ -596,9 +616,10 @@ int DCMPAS::_readCoordinates(size_t ts)
 // indicate the number of elements (edges or vertices) in
 // multi-dimensional arrays with varying dimension lengths. But DC uses
 // a padding flag: -1. So using nEdgesOnCell we pad the fixed size
-// DC connectivity array with -1.
+// DC connectivity array with -1. Only the cells j0 through j1, which
+// are in 'data', are padded.
 //
-void DCMPAS::_addMissingFlag(int *data) const
+void DCMPAS::_addMissingFlag(int *data, size_t j0, size_t j1) const
 {
     int *nEdgesOnCell = (int *)_nEdgesOnCellBuf.GetBuf();
 
@@ -607,6 +628,7 @@ void DCMPAS::_addMissingFlag(int *data) const
     VAssert(ok);
 
     size_t nCells = dimension.GetLength();
+    VAssert(j0 <= j1 && j1 < nCells);
 
     ok = GetDimension(maxEdgesDimName, dimension);
     VAssert(ok);
@@ -615,16 +637,17 @@ void DCMPAS::_addMissingFlag(int *data) const
 
     // Add padding
     //
-    for (size_t j = 0; j < nCells; j++) {
-        for (int i = nEdgesOnCell[j]; i < nMaxEdges; i++) { data[j * nMaxEdges + i] = -1; }
+    for (size_t j = j0; j <= j1; j++) {
+        for (int i = nEdgesOnCell[j]; i < nMaxEdges; i++) { data[(j - j0) * nMaxEdges + i] = -1; }
     }
 }
 
 // MPAS data on sphere is periodic. But we're projecting the geographic
 // data to Cartesian coordinates. We need split the cells that straddle
-// the split location, here chose to be 180 (-180) degrees
+// the split location, here chose to be 180 (-180) degrees. Only the
+// elements j0 through j1, which are in 'connData', are split.
 //
-void DCMPAS::_splitOnBoundary(string varname, int *connData) const
+void DCMPAS::_splitOnBoundary(string varname, int *connData, size_t j0, size_t j1) const
 {
     vector<size_t> connDims;
     bool           ok = GetVarDimLens(varname, true, connDims);
@@ -663,8 +686,10 @@ void DCMPAS::_splitOnBoundary(string varname, int *connData) const
     // are 0.0 .. 2*M_PI, as
     // per the MPAS Mesh Specification, Version 1.0 (Oct. 8, 2015) document.
     //
+    VAssert(j0 <= j1 && j1 < connDims[1]);
+
     int n = connDims[0];
-    for (size_t j = 0; j < connDims[1]; j++) {
+    for (size_t j = 0; j <= j1 - j0; j++) {
         // MPAS apparently uses a 0 to indicate cell boundaries. This is a undocumented feature
         // the we need to handle here
         //
@@ -880,9 +905,11 @@ template<class T> int DCMPAS::_readRegionTemplate(int fd, const vector<size_t> &
 
     // Special handling for some auxiliary variables
     //
-    if (varname == verticesOnCellVarName) { _addMissingFlag((int *)region); }
+    // Connectivity variables are read a range of whole rows at a time
+    //
+    if (varname == verticesOnCellVarName) { _addMissingFlag((int *)region, min[1], max[1]); }
 
-    if (is_connectivity_var(varname)) { _splitOnBoundary(varname, (int *)region); }
+    if (is_connectivity_var(varname)) { _splitOnBoundary(varname, (int *)region, min[1], max[1]); }
 
     return (0);
 }
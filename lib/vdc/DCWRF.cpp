@@ -88,6 +88,12 @@ int DCWRF::initialize(const vector<string> &files, const std::vector<string> &op
     vector<string> time_dimnames;
     vector<string> time_coordvars;
     time_dimnames.push_back("Time");
+    ncdfc->SetIndexDir(NetCDFCollection::IndexDirFromOptions(options));
+
+    // The time strings are needed by _InitTime(). Gather them with the
+    // metadata so that they're cached in the index
+    //
+    ncdfc->SetTextVars({"Times"});
     int rc = ncdfc->Initialize(files, time_dimnames, time_coordvars);
     if (rc < 0) {
         SetErrMsg("Failed to initialize netCDF data collection for reading");
@@ -6,14 +6,20 @@
 #include <cfloat>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <numeric>
 #include <type_traits>
+#include <sys/stat.h>
 #include <vapor/GeoUtil.h>
 #include <vapor/VDCNetCDF.h>
 #include <vapor/DCWRF.h>
 #include <vapor/DCCF.h>
 #include <vapor/DCMPAS.h>
 #include <vapor/DerivedVar.h>
+#include <vapor/FileUtils.h>
+#include <vapor/SerialUtils.h>
 #include <vapor/DataMgr.h>
+#include <vapor/Trace.h>
 #ifdef WIN32
     #include <float.h>
 #endif
@@ -489,6 +495,43 @@ template<typename T, enable_if_t<std::is_integral<T>::value, int> = 0> void _san
 
 template<typename T> bool contains(const vector<T> &v, T element) { return (find(v.begin(), v.end(), element) != v.end()); }
 
+// Identify a data set by its format and the path, size, and
+// modification time of its files
+//
+string dataset_id(string format, const vector<string> &files)
+{
+    uint64_t h = SerialUtils::FNVOffset;
+    auto     hash = [&h](const string &s) {
+        const unsigned char separator = 0xff;
+        h = SerialUtils::FNV1a(s, h);
+        h = SerialUtils::FNV1a(&separator, 1, h);
+    };
+
+    hash(format);
+    for (auto &f : files) {
+        struct STAT64_T st;
+        ostringstream oss;
+        oss << f;
+        if (STAT64(f.c_str(), &st) == 0) oss << ":" << st.st_size << ":" << st.st_mtime;
+        hash(oss.str());
+    }
+
+    ostringstream oss;
+    oss << std::hex << h;
+    return (oss.str());
+}
+
+// Name a set of mesh partitions
+//
+string partitions_key(const vector<size_t> &partitions)
+{
+    uint64_t h = SerialUtils::FNV1a(partitions.data(), partitions.size() * sizeof(size_t));
+
+    ostringstream oss;
+    oss << std::hex << h << ":" << partitions.size();
+    return (oss.str());
+}
+
 };    // namespace
 
 DataMgr::DataMgr(string format, size_t mem_size, int nthreads)
@@ -519,12 +562,33 @@ DataMgr::DataMgr(string format, size_t mem_size, int nthreads)
     _proj4String.clear();
     _proj4StringDefault.clear();
     _bs = {64, 64, 64};
+
+    _diskCacheSet = false;
+
+    _meshIndexEnabled = false;
+    _meshIndexSet = false;
+    _meshIndexPartitionSize = 4096;
+
+    _qtrCacheEnabled = false;
+    _qtrCacheSet = false;
+
+    _prefetchNSteps = 0;
+    _prefetchMemFraction = 0.25;
+    _prefetchBytes = 0;
+    _prefetchEpoch = 0;
+    _foregroundTS = 0;
+    _prefetchActive = false;
+    _prefetchStop = false;
 }
 
 DataMgr::~DataMgr()
 {
     SetDiagMsg("DataMgr::~DataMgr()");
 
+    // Stop the prefetch thread before tearing down anything it may use
+    //
+    _prefetchShutdown();
+
     if (_dc) delete _dc;
     _dc = NULL;
 
@@ -533,6 +597,8 @@ DataMgr::~DataMgr()
 
     _blk_mem_mgr = NULL;
 
+    _clearMeshIndices();
+
     vector<string> names = _dvm.GetDataVarNames();
     for (int i = 0; i < names.size(); i++) {
         if (_dvm.GetVar(names[i])) delete _dvm.GetVar(names[i]);
@@ -578,11 +644,21 @@ int DataMgr::_parseOptions(vector<string> &options)
 
 int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &options)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    {
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchQueue.clear();
+        _prefetchLast.clear();
+        _prefetchStatus.clear();
+    }
+
     vector<string> deviceOptions = options;
     int            rc = _parseOptions(deviceOptions);
     if (rc < 0) return (-1);
 
     Clear();
+    _clearMeshIndices();
     if (_dc) delete _dc;
 
     _dc = NULL;
@@ -610,6 +686,22 @@ int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &
         return (-1);
     }
 
+    _datasetID = dataset_id(_format, files);
+
+    if (!_diskCacheSet && getenv("VAPOR_DISK_CACHE_DIR")) {
+        const char *mb = getenv("VAPOR_DISK_CACHE_MB");
+        size_t      maxMB = mb ? strtoul(mb, NULL, 10) : 10240;
+        if (_diskCache.Open(getenv("VAPOR_DISK_CACHE_DIR"), maxMB * 1024 * 1024) < 0) {
+            SetDiagMsg("DataMgr::Initialize() - disk cache disabled");
+        }
+    }
+
+    // Mesh indices are saved next to the first file of the data set
+    //
+    _meshIndexPrefix = FileUtils::JoinPaths({FileUtils::Dirname(files[0]), "." + FileUtils::Basename(files[0])});
+    _meshIndexID = _datasetID;
+    if (!_meshIndexSet && getenv("VAPOR_MESH_INDEX")) _meshIndexEnabled = true;
+
     // Use UDUnits for unit conversion
     //
     rc = _udunits.Initialize();
@@ -624,6 +716,9 @@ int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &
         return (-1);
     }
 
+    if (!_qtrCacheSet && getenv("VAPOR_QTR_CACHE")) _qtrCacheEnabled = true;
+    _initQuadTreeCache();
+
     rc = _initVerticalCoordVars();
     if (rc < 0) {
         SetErrMsg("Failed to initialize horizontal coordinates");
@@ -691,6 +786,8 @@ vector<string> DataMgr::GetDataVarNames(int ndim) const
 {
     VAssert(_dc);
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     if (_dataVarNamesCache[ndim].size()) { return (_dataVarNamesCache[ndim]); }
 
     vector<string> vars = _dc->GetDataVarNames(ndim);
@@ -893,28 +990,40 @@ vector<size_t> DataMgr::GetCRatios(string varname) const
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, bool lock)
 {
+    VTRACE_SCOPE("DataMgr::GetVariable");
     SetDiagMsg("DataMgr::GetVariable(%d,%s,%d,%d,%d, %d)", ts, varname.c_str(), level, lod, lock);
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     int rc = _level_correction(varname, level);
     if (rc < 0) return (NULL);
 
     rc = _lod_correction(varname, lod);
     if (rc < 0) return (NULL);
 
+    _foregroundRequest(ts);
+
     Grid *rg = _getVariable(ts, varname, level, lod, lock, false);
     if (!rg) {
         SetErrMsg("Failed to read variable \"%s\" at time step (%d), and\n"
                   "refinement level (%d) and level-of-detail (%d)",
                   varname.c_str(), ts, level, lod);
+        return (NULL);
     }
+
+    _prefetchNotify(ts, varname, level, lod, vector<size_t>(), vector<size_t>());
+
     return (rg);
 }
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, vector<double> min, vector<double> max, bool lock)
 {
+    VTRACE_SCOPE("DataMgr::GetVariable");
     VAssert(min.size() == max.size());
 
-    SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
+    if (DiagMsgEnabled()) SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
 
     int rc = _level_correction(varname, level);
     if (rc < 0) return (NULL);
@@ -922,6 +1031,14 @@ Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, vector
     rc = _lod_correction(varname, lod);
     if (rc < 0) return (NULL);
 
+    // Read only the part of an unstructured mesh that covers the box,
+    // if the mesh is indexed
+    //
+    Grid *rg = NULL;
+    rc = _getVariableSubset(ts, varname, level, lod, min, max, lock, rg);
+    if (rc < 0) return (NULL);
+    if (rg) return (rg);
+
     //
     // Find the coordinates in voxels of the grid that contains
     // the axis aligned bounding box specified in user coordinates
@@ -1296,9 +1413,12 @@ Grid *DataMgr::_getVariable(size_t ts, string varname, int level, int lod, vecto
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, vector<size_t> min, vector<size_t> max, bool lock)
 {
+    VTRACE_SCOPE("DataMgr::GetVariable");
     VAssert(min.size() == max.size());
 
-    SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
+    if (DiagMsgEnabled()) SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
 
     int rc = _level_correction(varname, level);
     if (rc < 0) return (NULL);
@@ -1317,12 +1437,18 @@ Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, vector
         max.pop_back();
     }
 
+    _foregroundRequest(ts);
+
     Grid *rg = _getVariable(ts, varname, level, lod, min, max, lock, false);
     if (!rg) {
         SetErrMsg("Failed to read variable \"%s\" at time step (%d), and\n"
                   "refinement level (%d) and level-of-detail (%d)",
                   varname.c_str(), ts, level, lod);
+        return (NULL);
     }
+
+    _prefetchNotify(ts, varname, level, lod, min, max);
+
     return (rg);
 }
 
@@ -1330,6 +1456,8 @@ int DataMgr::GetVariableExtents(size_t ts, string varname, int level, int lod, v
 {
     SetDiagMsg("DataMgr::GetVariableExtents(%d, %s, %d, %d)", ts, varname.c_str(), level, lod);
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     min.clear();
     max.clear();
 
@@ -1374,6 +1502,8 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<
 {
     SetDiagMsg("DataMgr::GetDataRange(%d,%s)", ts, varname.c_str());
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     vector<double> min, max;
     int            rc = GetVariableExtents(ts, varname, level, lod, min, max);
     if (rc < 0) return (-1);
@@ -1383,8 +1513,11 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<
 
 int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<double> min, vector<double> max, vector<double> &range)
 {
+    VTRACE_SCOPE("DataMgr::GetDataRange");
     SetDiagMsg("DataMgr::GetDataRange(%d,%s)", ts, varname.c_str());
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     range = {0.0, 0.0};
 
     int rc = _level_correction(varname, level);
@@ -1415,6 +1548,15 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<
         return (0);
     }
 
+    // Avoid reading and decoding the data if the range can be
+    // determined from metadata
+    //
+    if (_get_data_range_from_metadata(ts, varname, level, lod, min_ui, max_ui, range)) {
+        _varInfoCacheDouble.Set(ts, varname, level, lod, key, range);
+        return (0);
+    }
+    range = {0.0, 0.0};
+
     const Grid *sg = DataMgr::GetVariable(ts, varname, level, lod, min_ui, max_ui, false);
     if (!sg) return (-1);
 
@@ -1429,6 +1571,43 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<
     return (0);
 }
 
+bool DataMgr::_get_data_range_from_metadata(size_t ts, string varname, int level, int lod, const vector<size_t> &min_ui, const vector<size_t> &max_ui, vector<double> &range)
+{
+    // Only native variables without missing values qualify. Missing
+    // values are excluded from Grid::GetRange(), but not from the
+    // stored block ranges.
+    //
+    if (_getDerivedVar(varname)) return (false);
+
+    DC::DataVar dvar;
+    if (!_dc->GetDataVarInfo(varname, dvar)) return (false);
+    if (dvar.GetHasMissing()) return (false);
+
+    // Block ranges are exact only if the region is block aligned. A
+    // region ending at the variable boundary counts as aligned.
+    //
+    vector<size_t> dims_at_level, bs_at_level;
+    int            rc = GetDimLensAtLevel(varname, level, dims_at_level, bs_at_level);
+    if (rc < 0) return (false);
+    if (dims_at_level.size() != min_ui.size() || bs_at_level.size() != min_ui.size()) return (false);
+
+    for (int i = 0; i < min_ui.size(); i++) {
+        if (min_ui[i] % bs_at_level[i]) return (false);
+        if ((max_ui[i] + 1) % bs_at_level[i] && max_ui[i] != dims_at_level[i] - 1) return (false);
+    }
+
+    int fd = _dc->OpenVariableRead(ts, varname, level, lod);
+    if (fd < 0) return (false);
+
+    rc = _dc->ReadRegionRange(fd, min_ui, max_ui, range);
+    (void)_dc->CloseVariable(fd);
+
+    if (rc != 1 || range.size() != 2) return (false);
+    if (!std::isfinite(range[0]) || !std::isfinite(range[1])) return (false);
+
+    return (true);
+}
+
 int DataMgr::GetDimLensAtLevel(string varname, int level, std::vector<size_t> &dims_at_level, std::vector<size_t> &bs_at_level) const
 {
     VAssert(_dc);
@@ -1525,21 +1704,23 @@ bool DataMgr::VariableExists(size_t ts, string varname, int level, int lod) cons
 {
     if (varname.empty()) return (false);
 
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     // disable error reporting
     //
-    bool enabled = EnableErrMsg(false);
+    bool enabled = EnableThreadErrMsg(false);
     int  rc = _level_correction(varname, level);
     if (rc < 0) {
-        EnableErrMsg(enabled);
+        EnableThreadErrMsg(enabled);
         return (false);
     }
 
     rc = _lod_correction(varname, lod);
     if (rc < 0) {
-        EnableErrMsg(enabled);
+        EnableThreadErrMsg(enabled);
         return (false);
     }
-    EnableErrMsg(enabled);
+    EnableThreadErrMsg(enabled);
 
     string         key = "VariableExists";
     vector<size_t> found;
@@ -1599,6 +1780,8 @@ bool DataMgr::IsVariableDerived(string name) const { return (_getDerivedVar(name
 
 int DataMgr::AddDerivedVar(DerivedDataVar *derivedVar)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     string varname = derivedVar->GetName();
 
     if (_dvm.HasVar(varname)) {
@@ -1622,6 +1805,8 @@ int DataMgr::AddDerivedVar(DerivedDataVar *derivedVar)
 
 void DataMgr::RemoveDerivedVar(string varname)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     if (!_dvm.HasVar(varname)) return;
 
     _dvm.RemoveVar(_dvm.GetVar(varname));
@@ -1641,6 +1826,8 @@ void DataMgr::RemoveDerivedVar(string varname)
 
 void DataMgr::Clear()
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     _PipeLines.clear();
 
     list<region_t>::iterator itr;
@@ -1650,11 +1837,17 @@ void DataMgr::Clear()
         if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
     }
     _regionsList.clear();
+    _prefetchBytes = 0;
+
+    _meshSubsets.clear();
 }
 
 void DataMgr::UnlockGrid(const Grid *rg)
 {
     SetDiagMsg("DataMgr::UnlockGrid()");
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     const vector<float *> &blks = rg->GetBlks();
     if (blks.size()) _unlock_blocks(blks[0]);
 
@@ -1704,21 +1897,34 @@ size_t DataMgr::GetVarTopologyDim(string varname) const
     return (mesh.GetTopologyDim());
 }
 
-template<typename T> T *DataMgr::_get_region_from_cache(size_t ts, string varname, int level, int lod, const vector<size_t> &bmin, const vector<size_t> &bmax, bool lock)
+template<typename T>
+T *DataMgr::_get_region_from_cache(size_t ts, string varname, int level, int lod, const vector<size_t> &bmin, const vector<size_t> &bmax, bool lock, const string &subset)
 {
     list<region_t>::iterator itr;
     for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
         region_t &region = *itr;
 
-        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax) {
+        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax && region.subset == subset) {
             // Increment the lock counter
             region.lock_counter += lock ? 1 : 0;
 
+            // A read-ahead region has been claimed by the caller and no
+            // longer counts against the prefetch budget
+            //
+            if (!_prefetchActive) {
+                if (region.prefetched) {
+                    region.prefetched = false;
+                    _prefetchBytes -= region.nbytes;
+                }
+                region.epoch = _prefetchEpoch;
+            }
+
             // Move region to front of list
             region_t tmp_region = region;
             _regionsList.erase(itr);
             _regionsList.push_back(tmp_region);
 
+            VTRACE_COUNT("DataMgr.cache_hits", 1);
             SetDiagMsg("DataMgr::_get_region_from_cache() - data in cache %xll\n", tmp_region.blks);
             return ((T *)tmp_region.blks);
         }
@@ -1849,6 +2055,28 @@ T *DataMgr::_get_region_from_fs(size_t ts, string varname, int level, int lod, c
     T *blks = (T *)_alloc_region(ts, varname, level, lod, grid_bmin, grid_bmax, grid_bs, sizeof(T), lock, false);
     if (!blks) return (NULL);
 
+    // Decoded regions of compressed variables, and projected horizontal
+    // coordinates, are worth keeping on disk
+    //
+    bool projected = dynamic_cast<DerivedCoordVar_PCSFromLatLon *>(_getDerivedCoordVar(varname)) != NULL;
+    bool keep = IsVariableDerived(varname) ? projected : _dc->IsCompressed(varname);
+
+    string diskKey;
+    size_t nbytes = VProduct(grid_bs) * VProduct(Dims(grid_bmin, grid_bmax)) * sizeof(T);
+    if (_diskCache.IsOpen() && keep) {
+        ostringstream oss;
+        oss << _datasetID << " " << varname << " " << ts << " " << level << " " << lod << " " << sizeof(T) << " " << vector_to_string(grid_bs) << " " << vector_to_string(grid_bmin) << " "
+            << vector_to_string(grid_bmax);
+        if (projected) oss << " " << _proj4String;
+        diskKey = oss.str();
+
+        if (_diskCache.Get(diskKey, blks, nbytes)) {
+            VTRACE_COUNT("DataMgr.disk_cache_hits", 1);
+            SetDiagMsg("DataMgr::GetGrid() - data read from disk cache\n");
+            return (blks);
+        }
+    }
+
     vector<size_t> file_dims, file_bs;
     int            rc = GetDimLensAtLevel(varname, level, file_dims, file_bs);
     VAssert(rc >= 0);
@@ -1874,6 +2102,11 @@ T *DataMgr::_get_region_from_fs(size_t ts, string varname, int level, int lod, c
         return (NULL);
     }
 
+    if (!diskKey.empty()) (void)_diskCache.Put(diskKey, blks, nbytes);
+
+    VTRACE_COUNT("DataMgr.blocks_read", VProduct(Dims(grid_bmin, grid_bmax)));
+    VTRACE_COUNT("DataMgr.bytes_read", nbytes);
+    if (!IsVariableDerived(varname) && _dc->IsCompressed(varname)) VTRACE_COUNT("DataMgr.bytes_decoded", nbytes);
     SetDiagMsg("DataMgr::GetGrid() - data read from fs\n");
     return (blks);
 }
@@ -1888,7 +2121,10 @@ T *DataMgr::_get_region(size_t ts, string varname, int level, int lod, int nlods
     // file system.
     //
     T *blks = _get_region_from_cache<T>(ts, varname, level, lod, bmin, bmax, lock);
-    if (!blks) { blks = (T *)_get_region_from_fs<T>(ts, varname, level, lod, dims, bs, bmin, bmax, lock); }
+    if (!blks) {
+        VTRACE_COUNT("DataMgr.cache_misses", 1);
+        blks = (T *)_get_region_from_fs<T>(ts, varname, level, lod, dims, bs, bmin, bmax, lock);
+    }
     if (!blks) {
         SetErrMsg("Failed to read region from variable/timestep/level/lod (%s, %d, %d, %d)", varname.c_str(), ts, level, lod);
         return (NULL);
@@ -1942,7 +2178,8 @@ int DataMgr::_get_regions(size_t ts, const vector<string> &varnames, int level,
     return (0);
 }
 
-void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, vector<size_t> bmin, vector<size_t> bmax, vector<size_t> bs, int element_sz, bool lock, bool fill)
+void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, vector<size_t> bmin, vector<size_t> bmax, vector<size_t> bs, int element_sz, bool lock, bool fill,
+                             const string &subset)
 {
     VAssert(bmin.size() == bmax.size());
     VAssert(bmin.size() == bs.size());
@@ -1960,13 +2197,20 @@ void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, vect
 
     // Free region already exists
     //
-    _free_region(ts, varname, level, lod, bmin, bmax, true);
+    _free_region(ts, varname, level, lod, bmin, bmax, true, subset);
 
     size_t size = element_sz;
     for (int i = 0; i < bmin.size(); i++) { size *= (bmax[i] - bmin[i] + 1) * bs[i]; }
 
     size_t nblocks = (size_t)ceil((double)size / (double)mem_block_size);
 
+    // Read-ahead may not grow past its share of the cache
+    //
+    if (_prefetchActive && _prefetchBytes + size > _prefetchBudget()) {
+        SetErrMsg("Prefetch memory budget exceeded");
+        return (NULL);
+    }
+
     void *blks;
     while (!(blks = (void *)_blk_mem_mgr->Alloc(nblocks, fill))) {
         if (!_free_lru()) {
@@ -1985,21 +2229,28 @@ void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, vect
     region.bmax = bmax;
     region.lock_counter = lock ? 1 : 0;
     region.blks = blks;
+    region.nbytes = size;
+    region.prefetched = _prefetchActive;
+    region.epoch = _prefetchActive ? 0 : _prefetchEpoch;
+    region.subset = subset;
+
+    if (region.prefetched) _prefetchBytes += size;
 
     _regionsList.push_back(region);
 
     return (region.blks);
 }
 
-void DataMgr::_free_region(size_t ts, string varname, int level, int lod, vector<size_t> bmin, vector<size_t> bmax, bool forceFlag)
+void DataMgr::_free_region(size_t ts, string varname, int level, int lod, vector<size_t> bmin, vector<size_t> bmax, bool forceFlag, const string &subset)
 {
     list<region_t>::iterator itr;
     for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
         const region_t &region = *itr;
 
-        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax) {
+        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax && region.subset == subset) {
             if (region.lock_counter == 0 || forceFlag) {
                 if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+                if (region.prefetched) _prefetchBytes -= region.nbytes;
 
                 _regionsList.erase(itr);
                 return;
@@ -2018,6 +2269,7 @@ void DataMgr::_free_var(string varname)
 
         if (region.varname.compare(varname) == 0) {
             if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+            if (region.prefetched) _prefetchBytes -= region.nbytes;
 
             _regionsList.erase(itr);
             itr = _regionsList.begin();
@@ -2039,7 +2291,16 @@ bool DataMgr::_free_lru()
         const region_t &region = *itr;
 
         if (region.lock_counter == 0) {
+            // The prefetch thread may not evict its own unclaimed read-ahead,
+            // nor anything the caller has touched in the current or the
+            // previous time step: an unlocked grid returned by GetVariable()
+            // may still be in use, and callers such as unsteady flow
+            // advection hold grids for consecutive time steps.
+            //
+            if (_prefetchActive && (region.prefetched || region.epoch + 1 >= _prefetchEpoch)) continue;
+
             if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+            if (region.prefetched) _prefetchBytes -= region.nbytes;
             _regionsList.erase(itr);
             return (true);
         }
@@ -2049,6 +2310,671 @@ bool DataMgr::_free_lru()
     return (false);
 }
 
+int DataMgr::SetDiskCache(string dir, size_t maxMB)
+{
+    SetDiagMsg("DataMgr::SetDiskCache(%s, %zu)", dir.c_str(), maxMB);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    _diskCacheSet = true;
+
+    if (dir.empty()) {
+        _diskCache.Close();
+        return (0);
+    }
+
+    return (_diskCache.Open(dir, maxMB * 1024 * 1024));
+}
+
+void DataMgr::SetMeshIndex(bool enable, size_t partitionSize)
+{
+    SetDiagMsg("DataMgr::SetMeshIndex(%d, %zu)", enable, partitionSize);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    _meshIndexSet = true;
+    _meshIndexEnabled = enable;
+
+    if (partitionSize && partitionSize != _meshIndexPartitionSize) {
+        _meshIndexPartitionSize = partitionSize;
+        _clearMeshIndices();
+    }
+}
+
+void DataMgr::SetQuadTreeCache(bool enable)
+{
+    SetDiagMsg("DataMgr::SetQuadTreeCache(%d)", enable);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    _qtrCacheSet = true;
+    _qtrCacheEnabled = enable;
+    _initQuadTreeCache();
+}
+
+// Search trees are saved next to the mesh indices. They depend on the map
+// projection as well as on the files.
+//
+void DataMgr::_initQuadTreeCache()
+{
+    if (_qtrCacheEnabled && !_meshIndexPrefix.empty()) {
+        _gridHelper.SetQuadTreeFilePrefix(_meshIndexPrefix, _datasetID + " " + _proj4String);
+    } else {
+        _gridHelper.SetQuadTreeFilePrefix("", "");
+    }
+}
+
+void DataMgr::_clearMeshIndices()
+{
+    std::map<string, MeshPartitionIndex *>::iterator itr;
+    for (itr = _meshIndices.begin(); itr != _meshIndices.end(); ++itr) { delete itr->second; }
+    _meshIndices.clear();
+    _meshSubsets.clear();
+}
+
+// Return the partition index of the mesh of varname, restoring it from
+// disk or building it if needed. Returns NULL if the index can't be made.
+//
+const MeshPartitionIndex *DataMgr::_getMeshIndex(string varname, const vector<DC::CoordVar> &cvarsinfo, int level, int lod)
+{
+    string xvar = cvarsinfo[0].GetName();
+    string yvar = cvarsinfo[1].GetName();
+
+    ostringstream oss;
+    oss << xvar << ":" << yvar << ":" << level << ":" << lod;
+    string name = oss.str();
+
+    std::map<string, MeshPartitionIndex *>::iterator itr = _meshIndices.find(name);
+    if (itr != _meshIndices.end()) return (itr->second);
+
+    DC::DataVar dvar;
+    bool        ok = GetDataVarInfo(varname, dvar);
+    VAssert(ok);
+
+    string face_node_var, dummy;
+    ok = _getVarConnVars(varname, face_node_var, dummy, dummy, dummy, dummy, dummy);
+    VAssert(ok);
+
+    vector<size_t>             vertexDims, faceDims, edgeDims;
+    UnstructuredGrid::Location location;
+    size_t                     maxVertexPerFace, maxFacePerVertex;
+    long                       vertexOffset, faceOffset;
+    _ugrid_setup(dvar, vertexDims, faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
+
+    size_t nNodes = vertexDims[0];
+    size_t nFaces = faceDims[0];
+
+    // The index must be rebuilt if the files, the mesh, the refinement
+    // level or lod of the coordinates, or their map projection change.
+    // Each level and lod is saved in its own file.
+    //
+    ostringstream key;
+    key << _meshIndexID << " " << face_node_var << " " << level << " " << lod << " " << _proj4String << " " << _meshIndexPartitionSize;
+    ostringstream path;
+    path << _meshIndexPrefix << "." << xvar << "." << yvar << "." << level << "." << lod << ".vpi";
+
+    MeshPartitionIndex *index = new MeshPartitionIndex();
+    if (index->Read(path.str(), key.str(), nNodes) < 0) {
+        SetDiagMsg("DataMgr::_getMeshIndex() - building index %s", path.str().c_str());
+
+        vector<size_t> nodes(nNodes);
+        std::iota(nodes.begin(), nodes.end(), 0);
+        vector<float> x(nNodes), y(nNodes);
+
+        vector<size_t> faces(nFaces);
+        std::iota(faces.begin(), faces.end(), 0);
+        vector<int> vertexOnFace(maxVertexPerFace * nFaces);
+
+        int rc = _readElements(0, xvar, level, lod, 0, nodes, x.data());
+        if (rc == 0) rc = _readElements(0, yvar, level, lod, 0, nodes, y.data());
+        if (rc == 0) rc = _readElements(0, face_node_var, level, lod, 1, faces, vertexOnFace.data());
+        if (rc == 0) rc = index->Build(nNodes, x.data(), y.data(), nFaces, vertexOnFace.data(), maxVertexPerFace, vertexOffset, _meshIndexPartitionSize);
+        if (rc < 0) {
+            delete index;
+            return (NULL);
+        }
+
+        // Not being able to save the index only costs time
+        //
+        if (index->Write(path.str(), key.str()) < 0) { SetDiagMsg("DataMgr::_getMeshIndex() - failed to save index %s", path.str().c_str()); }
+    }
+
+    _meshIndices[name] = index;
+    return (index);
+}
+
+// Find the part of the mesh of varname that covers the box min, max:
+// the faces that share a node of the partitions that intersect the box,
+// and all the nodes of those faces. Returns NULL if the part is empty or
+// too large to be worth reading on its own.
+//
+const DataMgr::mesh_subset_t *DataMgr::_getMeshSubset(string varname, const MeshPartitionIndex *index, const vector<double> &min, const vector<double> &max, int level, int lod)
+{
+    vector<size_t> partitions;
+    index->Query(min, max, partitions);
+    if (partitions.empty()) return (NULL);
+
+    vector<size_t> pnodes;
+    index->GetNodes(partitions, pnodes);
+
+    // Reading most of the mesh costs as much as reading all of it, and
+    // the whole mesh is shared by every box
+    //
+    if (pnodes.size() > index->GetNumNodes() / 2) return (NULL);
+
+    DC::DataVar dvar;
+    bool        ok = GetDataVarInfo(varname, dvar);
+    VAssert(ok);
+
+    // The partitions of an index are only meaningful at its own level
+    // and lod
+    //
+    ostringstream oss;
+    oss << level << ":" << lod << ":" << partitions_key(partitions);
+    string key = oss.str();
+
+    std::map<string, mesh_subset_t>::iterator itr = _meshSubsets.find(dvar.GetMeshName());
+    if (itr != _meshSubsets.end() && itr->second.key == key) return (&itr->second);
+
+    string face_node_var, node_face_var, dummy;
+    ok = _getVarConnVars(varname, face_node_var, node_face_var, dummy, dummy, dummy, dummy);
+    VAssert(ok);
+
+    vector<size_t>             vertexDims, faceDims, edgeDims;
+    UnstructuredGrid::Location location;
+    size_t                     maxVertexPerFace, maxFacePerVertex;
+    long                       vertexOffset, faceOffset;
+    _ugrid_setup(dvar, vertexDims, faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
+
+    // Faces that share a node of the partitions
+    //
+    vector<int> buf(maxFacePerVertex * pnodes.size());
+    int         rc = _readElements(0, node_face_var, level, lod, 1, pnodes, buf.data());
+    if (rc < 0) return (NULL);
+
+    vector<size_t> faces;
+    for (size_t i = 0; i < buf.size(); i++) {
+        if (buf[i] == -1 || buf[i] == -2 || buf[i] + faceOffset < 0) continue;
+        if (buf[i] + faceOffset >= (long)faceDims[0]) continue;
+        faces.push_back(buf[i] + faceOffset);
+    }
+    std::sort(faces.begin(), faces.end());
+    faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+    if (faces.empty()) return (NULL);
+
+    // All the nodes of those faces, so that every face is whole
+    //
+    buf.resize(maxVertexPerFace * faces.size());
+    rc = _readElements(0, face_node_var, level, lod, 1, faces, buf.data());
+    if (rc < 0) return (NULL);
+
+    vector<size_t> nodes = pnodes;
+    for (size_t f = 0; f < faces.size(); f++) {
+        const int *ptr = &buf[f * maxVertexPerFace];
+        for (size_t i = 0; i < maxVertexPerFace; i++) {
+            if (ptr[i] == -1 || ptr[i] == -2 || ptr[i] + vertexOffset < 0) break;
+            if (ptr[i] + vertexOffset >= (long)vertexDims[0]) break;
+            nodes.push_back(ptr[i] + vertexOffset);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    mesh_subset_t &subset = _meshSubsets[dvar.GetMeshName()];
+    subset.key = key;
+    subset.nodes.swap(nodes);
+    subset.faces.swap(faces);
+
+    SetDiagMsg("DataMgr::_getMeshSubset() - %zu of %zu nodes, %zu faces", subset.nodes.size(), index->GetNumNodes(), subset.faces.size());
+    return (&subset);
+}
+
+// Read a variable on the part of an unstructured mesh that covers the
+// box min, max. On success rg is NULL if the variable isn't sampled on
+// an indexed mesh, or the part isn't worth reading on its own, and the
+// caller should read the whole variable.
+//
+int DataMgr::_getVariableSubset(size_t ts, string varname, int level, int lod, const vector<double> &min, const vector<double> &max, bool lock, Grid *&rg)
+{
+    rg = NULL;
+
+    if (!_meshIndexEnabled || min.size() < 2 || max.size() < 2) return (0);
+
+    string gridType = _get_grid_type(varname);
+    if (gridType != UnstructuredGrid2D::GetClassType() && gridType != UnstructuredGridLayered::GetClassType()) return (0);
+
+    DC::DataVar dvar;
+    bool        ok = GetDataVarInfo(varname, dvar);
+    VAssert(ok);
+
+    if (dvar.GetSamplingLocation() != DC::Mesh::NODE) return (0);
+
+    vector<DC::CoordVar> cvarsinfo;
+    DC::CoordVar         dummy;
+    ok = _get_coord_vars(varname, cvarsinfo, dummy);
+    VAssert(ok);
+
+    // The index is built once, so the horizontal coordinates must not
+    // change with time
+    //
+    if (IsTimeVarying(cvarsinfo[0].GetName()) || IsTimeVarying(cvarsinfo[1].GetName())) return (0);
+
+    string face_node_var, node_face_var, face_edge_var, face_face_var, edge_node_var, edge_face_var;
+    ok = _getVarConnVars(varname, face_node_var, node_face_var, face_edge_var, face_face_var, edge_node_var, edge_face_var);
+    VAssert(ok);
+
+    if (face_node_var.empty() || node_face_var.empty()) return (0);
+    if (!face_edge_var.empty() || !edge_node_var.empty() || !edge_face_var.empty()) return (0);
+
+    const MeshPartitionIndex *index = _getMeshIndex(varname, cvarsinfo, level, lod);
+    if (!index) return (0);
+
+    const mesh_subset_t *subset = _getMeshSubset(varname, index, min, max, level, lod);
+    if (!subset) return (0);
+
+    _foregroundRequest(ts);
+
+    vector<size_t>             vertexDims, faceDims, edgeDims;
+    UnstructuredGrid::Location location;
+    size_t                     maxVertexPerFace, maxFacePerVertex;
+    long                       vertexOffset, faceOffset;
+    _ugrid_setup(dvar, vertexDims, faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
+
+    // Data and coordinates, indexed by node
+    //
+    vector<string> varnames;
+    for (int i = 0; i < cvarsinfo.size(); i++) varnames.push_back(cvarsinfo[i].GetName());
+    varnames.insert(varnames.begin(), varname);
+
+    vector<float *>        blkvec;
+    vector<vector<size_t>> bsvec, bminvec, bmaxvec;
+    vector<int *>          conn_blkvec;
+    vector<vector<size_t>> conn_bsvec, conn_bminvec, conn_bmaxvec;
+
+    bool cached;
+    int  rc = 0;
+    for (int i = 0; i < varnames.size() && rc == 0; i++) {
+        vector<size_t> dims;
+        float *        blks = _get_subset_region<float>(ts, varnames[i], level, lod, 0, subset->nodes, subset->key, dims, cached);
+        if (!blks) {
+            rc = -1;
+            break;
+        }
+        blkvec.push_back(blks);
+        bsvec.push_back(dims);
+        bminvec.push_back(vector<size_t>(dims.size(), 0));
+        bmaxvec.push_back(vector<size_t>(dims.size(), 0));
+    }
+
+    // Connectivity, indexed by face or node, and renumbered to refer to
+    // the nodes and faces of the part. References to the rest of the mesh
+    // become boundaries.
+    //
+    vector<string>                 conn_varnames = {face_node_var, node_face_var};
+    vector<const vector<size_t> *> rows = {&subset->faces, &subset->nodes};
+    vector<const vector<size_t> *> targets = {&subset->nodes, &subset->faces};
+    vector<long>                   offsets = {vertexOffset, faceOffset};
+    if (!face_face_var.empty()) {
+        conn_varnames.push_back(face_face_var);
+        rows.push_back(&subset->faces);
+        targets.push_back(&subset->faces);
+        offsets.push_back(faceOffset);
+    }
+
+    for (int i = 0; i < conn_varnames.size() && rc == 0; i++) {
+        vector<size_t> dims;
+        int *          blks = _get_subset_region<int>(ts, conn_varnames[i], level, lod, 1, *rows[i], subset->key, dims, cached);
+        if (!blks) {
+            rc = -1;
+            break;
+        }
+        if (!cached) MeshPartitionIndex::Remap(blks, VProduct(dims), offsets[i], *targets[i]);
+
+        conn_blkvec.push_back(blks);
+        conn_bsvec.push_back(dims);
+        conn_bminvec.push_back(vector<size_t>(dims.size(), 0));
+        conn_bmaxvec.push_back(vector<size_t>(dims.size(), 0));
+    }
+
+    if (rc < 0) {
+        for (int i = 0; i < blkvec.size(); i++) _unlock_blocks(blkvec[i]);
+        for (int i = 0; i < conn_blkvec.size(); i++) _unlock_blocks(conn_blkvec[i]);
+        return (-1);
+    }
+
+    vector<size_t> dims_at_level;
+    rc = GetDimLensAtLevel(varname, level, dims_at_level);
+    VAssert(rc >= 0);
+
+    vertexDims[0] = subset->nodes.size();
+    faceDims[0] = subset->faces.size();
+
+    rg = _gridHelper.MakeGridUnstructured(gridType, ts, level, lod, dvar, cvarsinfo, bsvec[0], dims_at_level, blkvec, bsvec, bminvec, bmaxvec, conn_blkvec, conn_bsvec, conn_bminvec, conn_bmaxvec,
+                                          vertexDims, faceDims, vector<size_t>(), location, maxVertexPerFace, maxFacePerVertex, 0, 0, subset->key);
+    VAssert(rg);
+
+    //
+    // Safe to remove locks now that were not explicitly requested
+    //
+    if (!lock) {
+        for (int i = 0; i < blkvec.size(); i++) _unlock_blocks(blkvec[i]);
+        for (int i = 0; i < conn_blkvec.size(); i++) _unlock_blocks(conn_blkvec[i]);
+    }
+
+    return (0);
+}
+
+// Get the elements of a variable along one axis from the cache, or read
+// them. The region returned is locked and has dimensions dims.
+// cached is true if the region was already in the cache.
+//
+template<class T>
+T *DataMgr::_get_subset_region(size_t ts, string varname, int level, int lod, int axis, const vector<size_t> &elements, const string &subset, vector<size_t> &dims, bool &cached)
+{
+    cached = false;
+
+    int rc = GetDimLensAtLevel(varname, level, dims);
+    if (rc < 0) return (NULL);
+    VAssert(axis < dims.size());
+    dims[axis] = elements.size();
+
+    DC::BaseVar var;
+    bool        ok = GetBaseVarInfo(varname, var);
+    if (!ok) return (NULL);
+
+    int nlods = var.GetCRatios().size();
+    if (lod < -nlods) lod = -nlods;
+
+    // If variable isn't time varying time step should always be 0
+    //
+    if (!DataMgr::IsTimeVarying(varname)) ts = 0;
+
+    vector<size_t> bmin(dims.size(), 0);
+    vector<size_t> bmax(dims.size(), 0);
+
+    T *blks = _get_region_from_cache<T>(ts, varname, level, lod, bmin, bmax, true, subset);
+    if (blks) {
+        cached = true;
+        return (blks);
+    }
+
+    blks = (T *)_alloc_region(ts, varname, level, lod, bmin, bmax, dims, sizeof(T), true, false, subset);
+    if (!blks) return (NULL);
+
+    rc = _readElements(ts, varname, level, lod, axis, elements, blks);
+    if (rc < 0) {
+        _free_region(ts, varname, level, lod, bmin, bmax, true, subset);
+        SetErrMsg("Failed to read region from variable/timestep/level/lod (%s, %d, %d, %d)", varname.c_str(), ts, level, lod);
+        return (NULL);
+    }
+
+    SetDiagMsg("DataMgr::_get_subset_region() - %d elements of %s read from fs\n", elements.size(), varname.c_str());
+    return (blks);
+}
+
+// Read the sorted list of elements, along axis, of a variable. The
+// elements are packed in the order given, so region has the dimensions
+// of the variable with dimension axis replaced by the number of
+// elements. Elements separated by short gaps are read together.
+//
+template<class T> int DataMgr::_readElements(size_t ts, string varname, int level, int lod, int axis, const vector<size_t> &elements, T *region)
+{
+    const size_t maxGap = 256;
+
+    vector<size_t> dims;
+    int            rc = GetDimLensAtLevel(varname, level, dims);
+    if (rc < 0) return (-1);
+    VAssert(axis < dims.size());
+
+    size_t inner = 1;
+    size_t outer = 1;
+    for (int i = 0; i < axis; i++) inner *= dims[i];
+    for (int i = axis + 1; i < dims.size(); i++) outer *= dims[i];
+
+    size_t n = elements.size();
+    if (!n) return (0);
+
+    int fd = _openVariableRead(ts, varname, level, lod);
+    if (fd < 0) return (-1);
+
+    vector<size_t> min(dims.size(), 0);
+    vector<size_t> max;
+    for (int i = 0; i < dims.size(); i++) max.push_back(dims[i] - 1);
+
+    vector<T> buf;
+    for (size_t i0 = 0; i0 < n;) {
+        size_t i1 = i0;
+        while (i1 + 1 < n && elements[i1 + 1] - elements[i1] <= maxGap) i1++;
+        VAssert(elements[i1] < dims[axis]);
+
+        min[axis] = elements[i0];
+        max[axis] = elements[i1];
+        size_t len = max[axis] - min[axis] + 1;
+
+        buf.resize(inner * len * outer);
+        rc = _readRegion(fd, min, max, buf.data());
+        if (rc < 0) {
+            (void)_closeVariable(fd);
+            return (-1);
+        }
+
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t i = i0; i <= i1; i++) {
+                const T *src = &buf[(o * len + elements[i] - min[axis]) * inner];
+                std::copy(src, src + inner, region + (o * n + i) * inner);
+            }
+        }
+        i0 = i1 + 1;
+    }
+
+    return (_closeVariable(fd));
+}
+
+void DataMgr::SetPrefetch(size_t nsteps, double memFraction)
+{
+    SetDiagMsg("DataMgr::SetPrefetch(%zu, %f)", nsteps, memFraction);
+
+    if (memFraction <= 0.0 || memFraction > 1.0) memFraction = 0.25;
+
+    if (!nsteps) {
+        _prefetchShutdown();
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchNSteps = 0;
+        _prefetchMemFraction = memFraction;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchNSteps = nsteps;
+        _prefetchMemFraction = memFraction;
+    }
+    _prefetchStart();
+}
+
+void DataMgr::_prefetchStart()
+{
+    if (_prefetchThread.joinable()) return;
+
+    _prefetchStop = false;
+    _prefetchThread = std::thread(&DataMgr::_prefetchWorker, this);
+}
+
+void DataMgr::_prefetchShutdown()
+{
+    if (!_prefetchThread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchStop = true;
+        _prefetchQueue.clear();
+        _prefetchLast.clear();
+        _prefetchStatus.clear();
+    }
+    _prefetchCV.notify_all();
+    _prefetchThread.join();
+}
+
+void DataMgr::_prefetchCancel(string varname)
+{
+    _prefetchQueue.erase(std::remove_if(_prefetchQueue.begin(), _prefetchQueue.end(), [&varname](const prefetch_t &p) { return (p.varname == varname); }), _prefetchQueue.end());
+
+    map<size_t, PrefetchStatus> &status = _prefetchStatus[varname];
+    for (auto itr = status.begin(); itr != status.end();) {
+        if (itr->second == PrefetchPending)
+            itr = status.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+// Called with _prefetchMutex held
+//
+void DataMgr::_prefetchSetStatus(const prefetch_t &req, PrefetchStatus status) { _prefetchStatus[req.varname][req.ts] = status; }
+
+DataMgr::PrefetchStatus DataMgr::GetPrefetchStatus(size_t ts, string varname) const
+{
+    std::lock_guard<std::mutex> lk(_prefetchMutex);
+
+    auto itr = _prefetchStatus.find(varname);
+    if (itr == _prefetchStatus.end()) return (PrefetchNone);
+
+    auto itr2 = itr->second.find(ts);
+    if (itr2 == itr->second.end()) return (PrefetchNone);
+
+    return (itr2->second);
+}
+
+// Called with _mutex held at the start of each GetVariable(). Regions
+// touched after the caller last changed time step are protected from
+// eviction by the prefetch thread
+//
+void DataMgr::_foregroundRequest(size_t ts)
+{
+    if (ts == _foregroundTS) return;
+
+    _foregroundTS = ts;
+    _prefetchEpoch++;
+}
+
+// Called with _mutex held after each successful GetVariable(). Compares
+// the request with the previous request for the same variable and, if
+// only the time step has changed, queues the next time steps along the
+// same stride.
+//
+void DataMgr::_prefetchNotify(size_t ts, string varname, int level, int lod, const vector<size_t> &min, const vector<size_t> &max)
+{
+    std::lock_guard<std::mutex> lk(_prefetchMutex);
+
+    if (!_prefetchNSteps) return;
+    if (!DataMgr::IsTimeVarying(varname)) return;
+
+    long nts = DataMgr::GetNumTimeSteps(varname);
+
+    prefetch_t req = {ts, varname, level, lod, min, max, 0};
+
+    map<string, prefetch_t>::iterator itr = _prefetchLast.find(varname);
+    bool                              sameView = itr != _prefetchLast.end() && itr->second.level == level && itr->second.lod == lod && itr->second.min == min && itr->second.max == max;
+    long                              stride = sameView ? (long)ts - (long)itr->second.ts : 0;
+
+    _prefetchLast[varname] = req;
+
+    // Region, refinement level or lod changed. Anything queued for this
+    // variable is no longer useful
+    //
+    if (!sameView) {
+        _prefetchCancel(varname);
+        return;
+    }
+
+    // Same time step requested again (e.g. a redraw). Leave queue alone
+    //
+    if (stride == 0) return;
+
+    _prefetchCancel(varname);
+    for (size_t i = 1; i <= _prefetchNSteps; i++) {
+        long next = (long)ts + (long)i * stride;
+        if (next < 0 || next >= nts) break;
+
+        req.ts = next;
+        req.ahead = i;
+        _prefetchQueue.push_back(req);
+        _prefetchSetStatus(req, PrefetchPending);
+    }
+    _prefetchCV.notify_one();
+}
+
+void DataMgr::_prefetchWorker()
+{
+    for (;;) {
+        prefetch_t req;
+        {
+            std::unique_lock<std::mutex> lk(_prefetchMutex);
+            _prefetchCV.wait(lk, [this] { return (_prefetchStop || !_prefetchQueue.empty()); });
+            if (_prefetchStop) return;
+
+            // Service the nearest time step of any variable first
+            //
+            std::deque<prefetch_t>::iterator itr = std::min_element(_prefetchQueue.begin(), _prefetchQueue.end(), [](const prefetch_t &a, const prefetch_t &b) { return (a.ahead < b.ahead); });
+            req = *itr;
+            _prefetchQueue.erase(itr);
+        }
+
+        std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+        // The request may have been cancelled, or the budget exhausted,
+        // while we were waiting for the lock
+        //
+        {
+            std::lock_guard<std::mutex> lk(_prefetchMutex);
+            if (_prefetchStop) return;
+
+            map<string, prefetch_t>::const_iterator itr = _prefetchLast.find(req.varname);
+            if (itr == _prefetchLast.end()) continue;
+            const prefetch_t &last = itr->second;
+            if (last.level != req.level || last.lod != req.lod || last.min != req.min || last.max != req.max) continue;
+        }
+
+        PrefetchStatus status = PrefetchDone;
+        if (_prefetchBytes >= _prefetchBudget()) {
+            status = PrefetchSkipped;
+        } else if (!VariableExists(req.ts, req.varname, req.level, req.lod)) {
+            status = PrefetchFailed;
+        } else {
+            // Failure to read ahead (e.g. no evictable memory) is not an
+            // error the caller needs to hear about. It is recorded in the
+            // request's status instead.
+            //
+            bool enabled = EnableThreadErrMsg(false);
+            _prefetchActive = true;
+
+            Grid *rg;
+            if (req.min.size()) {
+                rg = _getVariable(req.ts, req.varname, req.level, req.lod, req.min, req.max, false, false);
+            } else {
+                rg = _getVariable(req.ts, req.varname, req.level, req.lod, false, false);
+            }
+
+            _prefetchActive = false;
+            EnableThreadErrMsg(enabled);
+
+            // Only the cached blocks are of interest
+            //
+            if (rg)
+                delete rg;
+            else
+                status = PrefetchFailed;
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(_prefetchMutex);
+            _prefetchSetStatus(req, status);
+        }
+
+        SetDiagMsg("DataMgr::_prefetchWorker() - %s at ts %zu, status %d, %zu bytes pending", req.varname.c_str(), req.ts, status, _prefetchBytes);
+    }
+}
+
 //
 // return complete list of native variables
 //
@@ -3183,6 +4109,7 @@ int DataMgr::_initHorizontalCoordVars()
 
         // no duplicates
         //
+        DerivedCoordVar_PCSFromLatLon *xVar = NULL;
         if (!_getDerivedCoordVar(derivedCoordvars[0])) {
             DerivedCoordVar_PCSFromLatLon *derivedVar = new DerivedCoordVar_PCSFromLatLon(derivedCoordvars[0], _dc, coordvars, _proj4String, m.GetMeshType() != DC::Mesh::STRUCTURED, true);
 
@@ -3193,6 +4120,7 @@ int DataMgr::_initHorizontalCoordVars()
             }
 
             _dvm.AddCoordVar(derivedVar);
+            xVar = derivedVar;
         }
 
         if (!_getDerivedCoordVar(derivedCoordvars[1])) {
@@ -3205,6 +4133,11 @@ int DataMgr::_initHorizontalCoordVars()
             }
 
             _dvm.AddCoordVar(derivedVar);
+
+            // X and Y are projected together, so reading one of them
+            // leaves the other ready
+            //
+            if (xVar) xVar->ShareCoordinates(derivedVar);
         }
     }
 
@@ -0,0 +1,473 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vapor/EasyThreads.h>
+#include <vapor/VAssert.h>
+#include <vapor/DataMgr.h>
+#include <vapor/DataStatistics.h>
+
+using namespace VAPoR;
+using namespace Wasp;
+using namespace std;
+
+namespace {
+
+// Number of histogram bins per time step used to bracket the median
+//
+const size_t nBins = 4096;
+
+// Streaming min, max, mean, and sum of squared deviations. Partial
+// results from different threads and time steps are merged with Chan's
+// pairwise update, which avoids the cancellation of a sum of squares.
+//
+class moments {
+public:
+    moments() : _count(0), _min(std::numeric_limits<double>::infinity()), _max(-std::numeric_limits<double>::infinity()), _mean(0.0), _m2(0.0) {}
+
+    void add(double v)
+    {
+        _count++;
+        double d = v - _mean;
+        _mean += d / (double)_count;
+        _m2 += d * (v - _mean);
+        if (v < _min) _min = v;
+        if (v > _max) _max = v;
+    }
+
+    void merge(const moments &rhs)
+    {
+        if (!rhs._count) return;
+        if (!_count) {
+            *this = rhs;
+            return;
+        }
+
+        size_t n = _count + rhs._count;
+        double d = rhs._mean - _mean;
+        _mean += d * (double)rhs._count / (double)n;
+        _m2 += rhs._m2 + d * d * (double)_count * (double)rhs._count / (double)n;
+        _count = n;
+        if (rhs._min < _min) _min = rhs._min;
+        if (rhs._max > _max) _max = rhs._max;
+    }
+
+    size_t _count;
+    double _min;
+    double _max;
+    double _mean;
+    double _m2;
+};
+
+// Fixed size histogram over [_lo, _hi] of one time step. Because each
+// sample's bin is computed in floating point, the two queries below are
+// padded by one bin so that they are true bounds on the samples
+//
+class histogram {
+public:
+    histogram() : _lo(0.0), _hi(0.0), _w(0.0) {}
+
+    void init(double lo, double hi)
+    {
+        _lo = lo;
+        _hi = hi;
+        _w = (hi - lo) / (double)nBins;
+        _counts.assign(nBins, 0);
+    }
+
+    size_t bin(double v) const
+    {
+        if (_w <= 0.0) return (0);
+        double k = (v - _lo) / _w;
+        if (k < 0.0) return (0);
+        if (k >= (double)nBins) return (nBins - 1);
+        return ((size_t)k);
+    }
+
+    void finish()
+    {
+        _cum.assign(nBins + 1, 0);
+        for (size_t k = 0; k < nBins; k++) _cum[k + 1] = _cum[k] + _counts[k];
+        _counts.clear();
+    }
+
+    size_t total() const { return (_cum.empty() ? 0 : _cum[nBins]); }
+
+    // An upper bound on the number of samples less than a
+    //
+    size_t possiblyBelow(double a) const
+    {
+        if (a <= _lo) return (0);
+        if (a > _hi || _w <= 0.0) return (total());
+        double k = std::ceil((a - _lo) / _w) + 1.0;
+        if (k >= (double)nBins) return (total());
+        return (_cum[(size_t)k]);
+    }
+
+    // A lower bound on the number of samples less than or equal to b
+    //
+    size_t surelyAtMost(double b) const
+    {
+        if (b < _lo) return (0);
+        if (b >= _hi || _w <= 0.0) return (total());
+        double k = std::floor((b - _lo) / _w) - 1.0;
+        if (k <= 0.0) return (0);
+        return (_cum[(size_t)k]);
+    }
+
+    double              _lo;
+    double              _hi;
+    double              _w;
+    std::vector<size_t> _counts;
+    std::vector<size_t> _cum;
+};
+
+// The reduction of one time step
+//
+class part {
+public:
+    moments   _m;
+    histogram _h;
+};
+
+// A fixed set of threads that run one task after another. The
+// statistics make several sweeps over each grid, and over every time
+// step, so the threads are started once per Compute() call rather than
+// once per sweep. The calling thread is member 0.
+//
+class gang {
+public:
+    gang(int n) : _n(std::max(n, 1)), _task(NULL), _generation(0), _busy(0), _stop(false)
+    {
+        for (int id = 1; id < _n; id++) _threads.push_back(std::thread(&gang::loop, this, id));
+    }
+
+    ~gang()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv_task.notify_all();
+        for (auto &t : _threads) t.join();
+    }
+
+    int size() const { return (_n); }
+
+    // Run task(id) on every member and wait for all of them to return
+    //
+    void run(const std::function<void(int)> &task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _task = &task;
+            _busy = _n - 1;
+            _generation++;
+        }
+        _cv_task.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv_done.wait(lock, [this] { return (_busy == 0); });
+        _task = NULL;
+    }
+
+private:
+    void loop(int id)
+    {
+        size_t generation = 0;
+        for (;;) {
+            const std::function<void(int)> *task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv_task.wait(lock, [&] { return (_stop || _generation != generation); });
+                if (_stop) return;
+                generation = _generation;
+                task = _task;
+            }
+
+            (*task)(id);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (--_busy == 0) _cv_done.notify_one();
+        }
+    }
+
+    int                             _n;
+    const std::function<void(int)> *_task;
+    size_t                          _generation;
+    int                             _busy;
+    bool                            _stop;
+    std::mutex                      _mutex;
+    std::condition_variable         _cv_task;
+    std::condition_variable         _cv_done;
+    std::vector<std::thread>        _threads;
+};
+
+// Call f(thread, value) for every valid sample of the grid that lies
+// inside the box. The grid's blocks are handed out to the members of
+// the gang one at a time.
+//
+void for_each_sample(const Grid *g, const vector<double> &minu, const vector<double> &maxu, gang &threads, const std::function<void(int, float)> &f)
+{
+    vector<size_t> bdims = g->GetDimensionInBlks();
+    size_t         nblks = 1;
+    for (auto d : bdims) nblks *= d;
+    if (g->GetBlks().empty() || !nblks) return;
+
+    float mv = g->GetMissingValue();
+
+    // Fill the grid's cache of its extents before the threads test the
+    // box against them
+    //
+    DblArr3 gmin, gmax;
+    g->GetUserExtents(gmin, gmax);
+
+    std::atomic<size_t> next(0);
+
+    threads.run([&](int id) {
+        auto visitor = [&](const Grid::Span &span) {
+            for (size_t i = 0; i < span.n; i++) {
+                if (span.data[i] != mv) f(id, span.data[i]);
+            }
+        };
+
+        for (size_t b = next++; b < nblks; b = next++) g->ForEachBlock(minu, maxu, visitor, b, nblks);
+    });
+}
+
+// Accumulate the moments of a grid and, if histo is true, its histogram
+//
+void reduce(const Grid *g, const vector<double> &minu, const vector<double> &maxu, gang &threads, bool histo, part &p)
+{
+    int             nthreads = threads.size();
+    vector<moments> m(nthreads);
+    for_each_sample(g, minu, maxu, threads, [&m](int id, float v) { m[id].add(v); });
+    for (int i = 0; i < nthreads; i++) p._m.merge(m[i]);
+
+    if (!histo || !p._m._count) return;
+
+    // Second sweep over the grid in memory, now that its range is known
+    //
+    p._h.init(p._m._min, p._m._max);
+    vector<vector<size_t>> counts(nthreads, vector<size_t>(nBins, 0));
+    const histogram &      h = p._h;
+    for_each_sample(g, minu, maxu, threads, [&counts, &h](int id, float v) { counts[id][h.bin(v)]++; });
+
+    for (int i = 0; i < nthreads; i++) {
+        for (size_t k = 0; k < nBins; k++) p._h._counts[k] += counts[i][k];
+    }
+    p._h.finish();
+}
+
+// Find an interval [a, b] that contains element r of the sorted samples
+// of all parts
+//
+void median_interval(const vector<part> &parts, size_t r, double &a, double &b)
+{
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -lo;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (!parts[i]._m._count) continue;
+        lo = std::min(lo, parts[i]._m._min);
+        hi = std::max(hi, parts[i]._m._max);
+    }
+
+    auto possiblyBelow = [&parts](double x) {
+        size_t n = 0;
+        for (size_t i = 0; i < parts.size(); i++) n += parts[i]._h.possiblyBelow(x);
+        return (n);
+    };
+    auto surelyAtMost = [&parts](double x) {
+        size_t n = 0;
+        for (size_t i = 0; i < parts.size(); i++) n += parts[i]._h.surelyAtMost(x);
+        return (n);
+    };
+
+    // Largest a with fewer than r+1 samples possibly below it, and
+    // smallest b with at least r+1 samples surely at or below it
+    //
+    double l = lo, h = hi;
+    for (int i = 0; i < 64 && l < h; i++) {
+        double mid = l + (h - l) / 2.0;
+        if (mid <= l || mid >= h) break;
+        if (possiblyBelow(mid) <= r)
+            l = mid;
+        else
+            h = mid;
+    }
+    a = l;
+
+    l = lo, h = hi;
+    for (int i = 0; i < 64 && l < h; i++) {
+        double mid = l + (h - l) / 2.0;
+        if (mid <= l || mid >= h) break;
+        if (surelyAtMost(mid) >= r + 1)
+            h = mid;
+        else
+            l = mid;
+    }
+    b = h;
+
+    if (b < a) std::swap(a, b);
+}
+
+// Count the samples less than a and collect those inside [a, b]
+//
+void collect(const Grid *g, const vector<double> &minu, const vector<double> &maxu, gang &threads, double a, double b, size_t &below, vector<float> &values)
+{
+    int                   nthreads = threads.size();
+    vector<size_t>        nbelow(nthreads, 0);
+    vector<vector<float>> vals(nthreads);
+    for_each_sample(g, minu, maxu, threads, [&](int id, float v) {
+        if (v < a)
+            nbelow[id]++;
+        else if (v <= b)
+            vals[id].push_back(v);
+    });
+
+    for (int i = 0; i < nthreads; i++) {
+        below += nbelow[i];
+        values.insert(values.end(), vals[i].begin(), vals[i].end());
+    }
+}
+
+void finish(const moments &m, DataStatistics::Stats &stats)
+{
+    stats.count = m._count;
+    if (!m._count) return;
+
+    stats.min = m._min;
+    stats.max = m._max;
+    stats.mean = m._mean;
+    stats.stddev = std::sqrt(m._m2 / (double)m._count);
+}
+
+double select(vector<float> &values, size_t k)
+{
+    VAssert(k < values.size());
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return (values[k]);
+}
+
+};    // namespace
+
+DataStatistics::Stats::Stats()
+{
+    count = 0;
+    min = max = mean = stddev = median = std::numeric_limits<double>::quiet_NaN();
+}
+
+DataStatistics::DataStatistics(int nthreads)
+{
+    _nthreads = nthreads > 0 ? nthreads : EasyThreads::NProc();
+    if (_nthreads < 1) _nthreads = 1;
+}
+
+void DataStatistics::Compute(const Grid *grid, const vector<double> &minu, const vector<double> &maxu, bool median, Stats &stats) const
+{
+    stats = Stats();
+
+    gang threads(_nthreads);
+
+    vector<part> parts(1);
+    reduce(grid, minu, maxu, threads, median, parts[0]);
+    finish(parts[0]._m, stats);
+
+    if (!median || !stats.count) return;
+
+    size_t r = parts[0]._m._count / 2;
+    double a, b;
+    median_interval(parts, r, a, b);
+
+    size_t        below = 0;
+    vector<float> values;
+    collect(grid, minu, maxu, threads, a, b, below, values);
+
+    stats.median = select(values, r - below);
+}
+
+int DataStatistics::Compute(DataMgr *dataMgr, string varname, size_t ts0, size_t ts1, int level, int lod, const vector<double> &minu, const vector<double> &maxu, bool median, Stats &stats)
+{
+    stats = Stats();
+
+    if (!dataMgr->IsTimeVarying(varname)) ts1 = ts0;
+    if (ts1 < ts0) ts1 = ts0;
+
+    // With a single time step the median can be refined while the
+    // grid is still in hand
+    //
+    if (ts0 == ts1) {
+        Grid *g = dataMgr->GetVariable(ts0, varname, level, lod, minu, maxu);
+        if (!g) {
+            SetErrMsg("Failed to read variable %s at time step %d", varname.c_str(), (int)ts0);
+            return (-1);
+        }
+        Compute(g, minu, maxu, median, stats);
+        delete g;
+        return (0);
+    }
+
+    // One pass over the time steps. Every moment is accumulated from a
+    // single fetch of each time step.
+    //
+    gang threads(_nthreads);
+
+    // Time steps that can't be read are skipped, and leave their part
+    // empty
+    //
+    vector<part> parts(ts1 - ts0 + 1);
+    size_t       nread = 0;
+    for (size_t ts = ts0; ts <= ts1; ts++) {
+        Grid *g = dataMgr->GetVariable(ts, varname, level, lod, minu, maxu);
+        if (!g) continue;
+        reduce(g, minu, maxu, threads, median, parts[ts - ts0]);
+        delete g;
+        nread++;
+    }
+    if (!nread) {
+        SetErrMsg("Failed to read variable %s at any time step from %d to %d", varname.c_str(), (int)ts0, (int)ts1);
+        return (-1);
+    }
+
+    moments m;
+    for (size_t i = 0; i < parts.size(); i++) m.merge(parts[i]._m);
+    finish(m, stats);
+
+    if (!median || !stats.count) return (0);
+
+    size_t r = m._count / 2;
+    double a, b;
+    median_interval(parts, r, a, b);
+
+    // Only time steps whose range overlaps [a, b] need to be fetched
+    // again. Those entirely below a just contribute their count.
+    //
+    size_t        below = 0;
+    vector<float> values;
+    for (size_t ts = ts0; ts <= ts1; ts++) {
+        const moments &pm = parts[ts - ts0]._m;
+        if (!pm._count || pm._min > b) continue;
+        if (pm._max < a) {
+            below += pm._count;
+            continue;
+        }
+
+        // The other statistics stand if a time step read once can't be
+        // read again
+        //
+        Grid *g = dataMgr->GetVariable(ts, varname, level, lod, minu, maxu);
+        if (!g) return (0);
+        collect(g, minu, maxu, threads, a, b, below, values);
+        delete g;
+    }
+
+    stats.median = select(values, r - below);
+
+    return (0);
+}
@@ -2,10 +2,14 @@
 #include <sstream>
 #include <algorithm>
 #include <set>
+#include <list>
+#include <mutex>
+#include <cstdint>
 #include <vapor/UDUnitsClass.h>
 #include <vapor/NetCDFCollection.h>
 #include <vapor/utils.h>
 #include <vapor/WASP.h>
+#include <vapor/SerialUtils.h>
 #include <vapor/DerivedVar.h>
 
 using namespace VAPoR;
@@ -485,6 +489,62 @@ int DerivedVar::_getVarBlock(DC *dc, size_t ts, string varname, int level, int l
 //
 //////////////////////////////////////////////////////////////////////////////
 
+// Recently projected regions of a pair of X and Y variables. Regions are
+// identified by their extents and a hash of the geographic coordinates
+// they were projected from.
+//
+class DerivedCoordVar_PCSFromLatLon::PCSCache {
+public:
+    // Copy X or Y of a cached region to region
+    //
+    bool Get(const vector<size_t> &min, const vector<size_t> &max, uint64_t hash, bool lonFlag, float *region)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (auto itr = _entries.begin(); itr != _entries.end(); ++itr) {
+            if (itr->min != min || itr->max != max || itr->hash != hash) continue;
+
+            const vector<float> &v = lonFlag ? itr->x : itr->y;
+            std::copy(v.begin(), v.end(), region);
+            _entries.splice(_entries.begin(), _entries, itr);
+            return (true);
+        }
+        return (false);
+    }
+
+    // Add a region, taking the contents of x and y
+    //
+    void Put(const vector<size_t> &min, const vector<size_t> &max, uint64_t hash, vector<float> &x, vector<float> &y)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _entries.push_front(entry_t());
+        entry_t &e = _entries.front();
+        e.min = min;
+        e.max = max;
+        e.hash = hash;
+        e.x.swap(x);
+        e.y.swap(y);
+
+        while (_entries.size() > _maxEntries) _entries.pop_back();
+    }
+
+private:
+    struct entry_t {
+        vector<size_t> min;
+        vector<size_t> max;
+        uint64_t       hash;
+        vector<float>  x;
+        vector<float>  y;
+    };
+
+    // The X and Y of the region being read, and a few recent regions
+    //
+    static const size_t _maxEntries = 4;
+    std::mutex          _mutex;
+    std::list<entry_t>  _entries;    // most recently used first
+};
+
 DerivedCoordVar_PCSFromLatLon::DerivedCoordVar_PCSFromLatLon(string derivedVarName, DC *dc, vector<string> inNames, string proj4String, bool uGridFlag, bool lonFlag) : DerivedCoordVar(derivedVarName)
 {
     VAssert(inNames.size() == 2);
@@ -497,6 +557,15 @@ DerivedCoordVar_PCSFromLatLon::DerivedCoordVar_PCSFromLatLon(string derivedVarNa
     _uGridFlag = uGridFlag;
     _lonFlag = lonFlag;
     _dimLens.clear();
+    _cache = std::make_shared<PCSCache>();
+}
+
+void DerivedCoordVar_PCSFromLatLon::ShareCoordinates(DerivedCoordVar_PCSFromLatLon *other)
+{
+    VAssert(other);
+    VAssert(other->_proj4String == _proj4String);
+
+    other->_cache = _cache;
 }
 
 int DerivedCoordVar_PCSFromLatLon::Initialize()
@@ -602,54 +671,44 @@ int DerivedCoordVar_PCSFromLatLon::_readRegionHelper1D(DC::FileTable::FileObject
     string varname = f->GetVarname();
     int    lod = f->GetLOD();
 
-    // Need temporary buffer space for the X or Y coordinate
-    // NOT being returned (we still need to calculate it)
-    //
-    size_t nElements = numElements(min, max);
-    float *buf = new float[nElements];
-
     vector<size_t> roidims;
     for (int i = 0; i < min.size(); i++) { roidims.push_back(max[i] - min[i] + 1); }
 
-    // Assign temporary buffer 'buf' as appropriate
+    // Both X and Y are computed, and kept for the other variable
     //
-    float *lonBufPtr;
-    float *latBufPtr;
-    if (_lonFlag) {
-        lonBufPtr = region;
-        latBufPtr = buf;
-    } else {
-        lonBufPtr = buf;
-        latBufPtr = region;
-    }
+    size_t        nElements = numElements(min, max);
+    vector<float> lonBuf(nElements);
+    vector<float> latBuf(nElements);
 
     // Reading 1D data so no blocking
     //
     vector<size_t> lonMin = {min[0]};
     vector<size_t> lonMax = {max[0]};
-    int            rc = _getVar(_dc, ts, _lonName, -1, lod, lonMin, lonMax, lonBufPtr);
-    if (rc < 0) {
-        delete[] buf;
-        return (rc);
-    }
+    int            rc = _getVar(_dc, ts, _lonName, -1, lod, lonMin, lonMax, lonBuf.data());
+    if (rc < 0) return (rc);
 
     vector<size_t> latMin = {min[1]};
     vector<size_t> latMax = {max[1]};
-    rc = _getVar(_dc, ts, _latName, -1, lod, latMin, latMax, latBufPtr);
-    if (rc < 0) {
-        delete[] buf;
-        return (rc);
-    }
+    rc = _getVar(_dc, ts, _latName, -1, lod, latMin, latMax, latBuf.data());
+    if (rc < 0) return (rc);
+
+    uint64_t hash = SerialUtils::FNV1a(lonBuf.data(), roidims[0] * sizeof(float));
+    hash = SerialUtils::FNV1a(latBuf.data(), roidims[1] * sizeof(float), hash);
+    if (_cache->Get(min, max, hash, _lonFlag, region)) return (0);
 
     // Combine the 2 1D arrays into a 2D array
     //
-    make2D(lonBufPtr, latBufPtr, roidims);
+    make2D(lonBuf.data(), latBuf.data(), roidims);
 
-    rc = _proj4API.Transform(lonBufPtr, latBufPtr, vproduct(roidims));
+    rc = _proj4API.TransformParallel(lonBuf.data(), latBuf.data(), nElements);
+    if (rc < 0) return (rc);
 
-    delete[] buf;
+    const vector<float> &v = _lonFlag ? lonBuf : latBuf;
+    std::copy(v.begin(), v.end(), region);
 
-    return (rc);
+    _cache->Put(min, max, hash, lonBuf, latBuf);
+
+    return (0);
 }
 
 int DerivedCoordVar_PCSFromLatLon::_readRegionHelper2D(DC::FileTable::FileObject *f, const vector<size_t> &min, const vector<size_t> &max, float *region)
@@ -658,41 +717,34 @@ int DerivedCoordVar_PCSFromLatLon::_readRegionHelper2D(DC::FileTable::FileObject
     string varname = f->GetVarname();
     int    lod = f->GetLOD();
 
-    // Need temporary buffer space for the X or Y coordinate
-    // NOT being returned (we still need to calculate it)
+    // Both X and Y are computed, and kept for the other variable
     //
-    size_t nElements = numElements(min, max);
-    float *buf = new float[nElements];
+    size_t        nElements = numElements(min, max);
+    vector<float> lonBuf(nElements);
+    vector<float> latBuf(nElements);
 
-    // Assign temporary buffer 'buf' as appropriate
-    //
-    float *lonBufPtr;
-    float *latBufPtr;
-    if (_lonFlag) {
-        lonBufPtr = region;
-        latBufPtr = buf;
-    } else {
-        lonBufPtr = buf;
-        latBufPtr = region;
-    }
+    int rc = _getVar(_dc, ts, _lonName, -1, lod, min, max, lonBuf.data());
+    if (rc < 0) return (rc);
 
-    int rc = _getVar(_dc, ts, _lonName, -1, lod, min, max, lonBufPtr);
-    if (rc < 0) {
-        delete[] buf;
-        return (rc);
-    }
+    rc = _getVar(_dc, ts, _latName, -1, lod, min, max, latBuf.data());
+    if (rc < 0) return (rc);
 
-    rc = _getVar(_dc, ts, _latName, -1, lod, min, max, latBufPtr);
-    if (rc < 0) {
-        delete[] buf;
-        return (rc);
-    }
+    // Geographic coordinates that are stored for every time step
+    // usually don't change
+    //
+    uint64_t hash = SerialUtils::FNV1a(lonBuf.data(), nElements * sizeof(float));
+    hash = SerialUtils::FNV1a(latBuf.data(), nElements * sizeof(float), hash);
+    if (_cache->Get(min, max, hash, _lonFlag, region)) return (0);
 
-    rc = _proj4API.Transform(lonBufPtr, latBufPtr, nElements);
+    rc = _proj4API.TransformParallel(lonBuf.data(), latBuf.data(), nElements);
+    if (rc < 0) return (rc);
 
-    delete[] buf;
+    const vector<float> &v = _lonFlag ? lonBuf : latBuf;
+    std::copy(v.begin(), v.end(), region);
 
-    return (rc);
+    _cache->Put(min, max, hash, lonBuf, latBuf);
+
+    return (0);
 }
 
 int DerivedCoordVar_PCSFromLatLon::ReadRegion(int fd, const vector<size_t> &min, const vector<size_t> &max, float *region)
@@ -1058,32 +1110,22 @@ int DerivedCoordVar_WRFTime::Initialize()
         return (-1);
     }
 
-    // Read all of the formatted time strings up front - it's a 1D array
+    // Get all of the formatted time strings up front - it's a 1D array
     // so we can simply store the results in memory - and convert from
-    // a formatted time string to seconds since the EPOCH
+    // a formatted time string to seconds since the EPOCH. The strings
+    // are gathered with the file metadata (See
+    // NetCDFCollection::SetTextVars()), so the files needn't be opened.
     //
     vector<string> timeStrings;
-    char *         buf = new char[dims[0] + 1];
-    buf[dims[0]] = '\0';
     for (size_t ts = 0; ts < numTS; ts++) {
-        int fd = _ncdfc->OpenRead(ts, _wrfTimeVar);
-        if (fd < 0) {
-            SetErrMsg("Can't read time variable");
-            return (-1);
-        }
-
-        int rc = _ncdfc->Read(buf, fd);
+        string timeString;
+        int    rc = _ncdfc->ReadText(ts, _wrfTimeVar, timeString);
         if (rc < 0) {
             SetErrMsg("Can't read time variable");
-            _ncdfc->Close(fd);
-            delete[] buf;
             return (-1);
         }
-        _ncdfc->Close(fd);
-
-        timeStrings.push_back(buf);
+        timeStrings.push_back(timeString);
     }
-    delete[] buf;
 
     // Encode time stamp string as double precision float
     //
@@ -114,27 +114,91 @@ void Grid::SetValueIJK(size_t i, size_t j, size_t k, float v)
     return (SetValue(indices, v));
 }
 
+namespace {
+
+// Cells found by the last point query of each thread, for a few grids at
+// a time. Slots are selected by the grid's address, so a thread querying
+// several grids in turn (e.g. the components of a vector field) usually
+// keeps a hint for each.
+//
+class cellHint {
+public:
+    const Grid *grid;
+    Size_tArr3  cell;
+};
+
+const size_t nCellHints = 8;
+
+thread_local cellHint cellHints[nCellHints];
+
+cellHint &cell_hint_slot(const Grid *g)
+{
+    size_t h = (size_t)g;
+    return (cellHints[((h >> 4) ^ (h >> 10)) % nCellHints]);
+}
+
+};    // namespace
+
+bool Grid::GetCellHint(Size_tArr3 &cell) const
+{
+    if (!_pointLocator) return (false);
+
+    const cellHint &hint = cell_hint_slot(this);
+    if (hint.grid != this) return (false);
+
+    cell = hint.cell;
+    return (true);
+}
+
+void Grid::SetCellHint(const Size_tArr3 &cell) const
+{
+    if (!_pointLocator) return;
+
+    cellHint &hint = cell_hint_slot(this);
+    hint.grid = this;
+    hint.cell = cell;
+}
+
+namespace {
+
+// Update the range with the valid values of a span
+//
+void spanRange(const Grid::Span &span, float mv, bool &first, float range[2])
+{
+    size_t i = 0;
+    if (first) {
+        while (i < span.n && span.data[i] == mv) i++;
+        if (i == span.n) return;
+        range[0] = range[1] = span.data[i];
+        first = false;
+    }
+
+    float lo = range[0];
+    float hi = range[1];
+    for (; i < span.n; i++) {
+        float v = span.data[i];
+        if (v == mv) continue;
+        if (v < lo)
+            lo = v;
+        else if (v > hi)
+            hi = v;
+    }
+    range[0] = lo;
+    range[1] = hi;
+}
+
+};    // namespace
+
 void Grid::GetRange(float range[2]) const
 {
-    float               missingValue = GetMissingValue();
-    Grid::ConstIterator itr = this->cbegin();
-    Grid::ConstIterator enditr = this->cend();
+    float mv = GetMissingValue();
 
     // Edge case: all values are missing values.
     //
-    range[0] = range[1] = missingValue;
-    while (*itr == missingValue && itr != enditr) { ++itr; }
-    if (itr == enditr) return;
-
-    range[0] = *itr;
-    range[1] = range[0];
-    while (itr != enditr) {
-        if (*itr < range[0] && *itr != missingValue)
-            range[0] = *itr;
-        else if (*itr > range[1] && *itr != missingValue)
-            range[1] = *itr;
-        ++itr;
-    }
+    range[0] = range[1] = mv;
+
+    bool first = true;
+    ForEachBlock([&](const Span &span) { spanRange(span, mv, first, range); });
 }
 
 void Grid::GetRange(const Size_tArr3 &min, const Size_tArr3 &max, float range[2]) const
@@ -145,47 +209,146 @@ void Grid::GetRange(const Size_tArr3 &min, const Size_tArr3 &max, float range[2]
     Size_tArr3 cMax;
     ClampIndex(max, cMax);
 
-    const vector<size_t> &dims = GetDimensions();
-
     float mv = GetMissingValue();
 
     range[0] = range[1] = mv;
 
-    size_t jmin = 0;
-    size_t jmax = 0;
-    if (dims.size() > 1) {
-        jmin = cMin[1];
-        jmax = cMax[1];
-    }
+    bool first = true;
+    ForEachBlock(cMin, cMax, [&](const Span &span) { spanRange(span, mv, first, range); });
+}
+
+void Grid::ForEachBlock(const Size_tArr3 &min, const Size_tArr3 &max, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    if (!_blks.size() || !_dims.size() || part >= nparts) return;
+
+    Size_tArr3 dims = {1, 1, 1};
+    CopyToArr3(_dims, dims);
 
-    size_t kmin = 0;
-    size_t kmax = 0;
-    if (dims.size() > 2) {
-        kmin = cMin[2];
-        kmax = cMax[2];
+    Size_tArr3 cMin, cMax;
+    for (int i = 0; i < 3; i++) {
+        cMin[i] = min[i];
+        cMax[i] = std::min(max[i], dims[i] - 1);
+        if (cMin[i] > cMax[i]) return;
     }
 
-    bool first = true;
-    for (size_t k = kmin; k <= kmax; k++) {
-        for (size_t j = jmin; j <= jmax; j++) {
-            for (size_t i = cMin[0]; i <= cMax[0]; i++) {
-                float v = AccessIJK(i, j, k);
-                if (first && v != mv) {
-                    range[0] = range[1] = v;
-                    first = false;
+    size_t nblks = _bdims[0] * _bdims[1] * _bdims[2];
+    size_t b0 = part * nblks / nparts;
+    size_t b1 = (part + 1) * nblks / nparts;
+
+    Span span;
+    for (size_t zb = cMin[2] / _bs[2]; zb <= cMax[2] / _bs[2]; zb++) {
+        for (size_t yb = cMin[1] / _bs[1]; yb <= cMax[1] / _bs[1]; yb++) {
+            for (size_t xb = cMin[0] / _bs[0]; xb <= cMax[0] / _bs[0]; xb++) {
+                size_t b = zb * _bdims[0] * _bdims[1] + yb * _bdims[0] + xb;
+                if (b < b0 || b >= b1) continue;
+
+                // Part of the block inside the region
+                //
+                Size_tArr3 origin = {xb * _bs[0], yb * _bs[1], zb * _bs[2]};
+                Size_tArr3 lo, hi;
+                for (int i = 0; i < 3; i++) {
+                    lo[i] = std::max(cMin[i], origin[i]);
+                    hi[i] = std::min(cMax[i], origin[i] + _bs[i] - 1);
                 }
 
-                if (!first) {
-                    if (v < range[0] && v != mv)
-                        range[0] = v;
-                    else if (v > range[1] && v != mv)
-                        range[1] = v;
+                const float *blk = _blks[b];
+                span.n = hi[0] - lo[0] + 1;
+                for (size_t z = lo[2]; z <= hi[2]; z++) {
+                    for (size_t y = lo[1]; y <= hi[1]; y++) {
+                        span.data = blk + (z - origin[2]) * _bs[0] * _bs[1] + (y - origin[1]) * _bs[0] + (lo[0] - origin[0]);
+                        span.index = {lo[0], y, z};
+                        visitor(span);
+                    }
                 }
             }
         }
     }
 }
 
+void Grid::ForEachBlock(const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    Size_tArr3 min = {0, 0, 0};
+    Size_tArr3 max = {0, 0, 0};
+    for (int i = 0; i < _dims.size(); i++) max[i] = _dims[i] - 1;
+
+    ForEachBlock(min, max, visitor, part, nparts);
+}
+
+void Grid::ForEachBlock(const vector<double> &minu, const vector<double> &maxu, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    size_t ncoords = std::min(std::min(minu.size(), maxu.size()), GetGeometryDim());
+    ncoords = std::min(ncoords, (size_t)3);
+
+    DblArr3 bMin = {0.0, 0.0, 0.0};
+    DblArr3 bMax = {0.0, 0.0, 0.0};
+    CopyToArr3(minu.data(), ncoords, bMin);
+    CopyToArr3(maxu.data(), ncoords, bMax);
+
+    // Nothing to test if the whole grid is inside the box
+    //
+    DblArr3 gMin, gMax;
+    GetUserExtents(gMin, gMax);
+    bool inside = true;
+    for (size_t i = 0; i < ncoords; i++) {
+        if (gMin[i] < bMin[i] || gMax[i] > bMax[i]) inside = false;
+    }
+    if (inside) {
+        ForEachBlock(visitor, part, nparts);
+        return;
+    }
+
+    ForEachBlockInBoxHelper(bMin, bMax, ncoords, visitor, part, nparts);
+}
+
+void Grid::ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    ForEachBlock(
+        [&](const Span &span) {
+            VisitInside(
+                span,
+                [&](size_t i) {
+                    Size_tArr3 index = {span.index[0] + i, span.index[1], span.index[2]};
+                    DblArr3    coords = {0.0, 0.0, 0.0};
+                    GetUserCoordinates(index, coords);
+                    for (size_t j = 0; j < ncoords; j++) {
+                        if (coords[j] < minu[j] || coords[j] > maxu[j]) return (false);
+                    }
+                    return (true);
+                },
+                visitor);
+        },
+        part, nparts);
+}
+
+void Grid::ForEachBlockInSeparableBox(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    Size_tArr3 dims = {1, 1, 1};
+    CopyToArr3(_dims, dims);
+
+    Size_tArr3 min = {0, 0, 0};
+    Size_tArr3 max = {dims[0] - 1, dims[1] - 1, dims[2] - 1};
+
+    // Range of indices along each axis whose coordinate is inside the box
+    //
+    for (size_t axis = 0; axis < ncoords; axis++) {
+        bool found = false;
+        for (size_t i = 0; i < dims[axis]; i++) {
+            Size_tArr3 index = {0, 0, 0};
+            DblArr3    coords = {0.0, 0.0, 0.0};
+            index[axis] = i;
+            GetUserCoordinates(index, coords);
+            if (coords[axis] < minu[axis] || coords[axis] > maxu[axis]) continue;
+
+            if (!found) min[axis] = i;
+            max[axis] = i;
+            found = true;
+        }
+        if (!found) return;
+    }
+
+    ForEachBlock(min, max, visitor, part, nparts);
+}
+
 float Grid::GetValue(const DblArr3 &coords) const
 {
     if (!_blks.size()) return (GetMissingValue());
@@ -208,6 +371,61 @@ float Grid::GetValue(const DblArr3 &coords) const
     }
 }
 
+void Grid::GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const
+{
+    for (size_t p = 0; p < n; p++) {
+        DblArr3 coords = {x[p], y[p], z && GetGeometryDim() == 3 ? z[p] : 0.0};
+        values[p] = GetValue(coords);
+    }
+}
+
+void Grid::GetCellNodeValues(size_t i, size_t j, size_t k, float v[8]) const
+{
+    VAssert(_blks.size());
+
+    // Block and offset within the block of the index, and of the next
+    // index, along each axis
+    //
+    const size_t index[] = {i, j, k};
+    size_t       blk[3][2], off[3][2];
+    for (int a = 0; a < 3; a++) {
+        size_t last = a < _dims.size() ? _dims[a] - 1 : 0;
+        for (int d = 0; d < 2; d++) {
+            size_t idx = std::min(index[a] + d, last);
+            blk[a][d] = idx / _bs[a];
+            off[a][d] = idx % _bs[a];
+        }
+    }
+
+    for (int dk = 0; dk < 2; dk++) {
+        for (int dj = 0; dj < 2; dj++) {
+            for (int di = 0; di < 2; di++) {
+                const float *b = _blks[(blk[2][dk] * _bdims[1] + blk[1][dj]) * _bdims[0] + blk[0][di]];
+                v[4 * dk + 2 * dj + di] = b[(off[2][dk] * _bs[1] + off[1][dj]) * _bs[0] + off[0][di]];
+            }
+        }
+    }
+}
+
+float Grid::TrilinearInterp(const float v[8], double iwgt, double jwgt, double kwgt, float missingValue)
+{
+    double p[8];
+    for (int n = 0; n < 8; n++) {
+        bool used = (!(n & 1) || iwgt != 0.0) && (!(n & 2) || jwgt != 0.0) && (!(n & 4) || kwgt != 0.0);
+        if (!used) {
+            p[n] = 0.0;
+            continue;
+        }
+        if (v[n] == missingValue) return (missingValue);
+        p[n] = v[n];
+    }
+
+    double c0 = p[0] + iwgt * (p[1] - p[0]) + jwgt * ((p[2] + iwgt * (p[3] - p[2])) - (p[0] + iwgt * (p[1] - p[0])));
+    double c1 = p[4] + iwgt * (p[5] - p[4]) + jwgt * ((p[6] + iwgt * (p[7] - p[6])) - (p[4] + iwgt * (p[5] - p[4])));
+
+    return (c0 + kwgt * (c1 - c0));
+}
+
 void Grid::_getUserCoordinatesHelper(const vector<double> &coords, double &x, double &y, double &z) const
 {
     if (GetDimensions().size() >= 1) { x = coords[0]; }
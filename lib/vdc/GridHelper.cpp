@@ -1,8 +1,10 @@
 #include <iostream>
 #include <sstream>
+#include <cstdio>
 #include <vector>
 #include <map>
 #include <vapor/QuadTreeRectangle.hpp>
+#include <vapor/SerialUtils.h>
 #include <vapor/GridHelper.h>
 using namespace Wasp;
 using namespace VAPoR;
@@ -97,7 +99,8 @@ bool isCurvilinear(const DC::Mesh &m, const vector<DC::CoordVar> &cvarsinfo, con
 using namespace VAPoR;
 using namespace Wasp;
 
-string GridHelper::_getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const vector<size_t> &bmin, const vector<size_t> &bmax) const
+string GridHelper::_getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const vector<size_t> &bmin, const vector<size_t> &bmax,
+                                           const string &subset) const
 {
     VAssert(cvarsinfo.size() >= 2);
 
@@ -119,9 +122,12 @@ string GridHelper::_getQuadTreeRectangleKey(size_t ts, int level, int lod, const
     oss << ":";
     oss << level;
     oss << ":";
+    oss << lod;
+    oss << ":";
     oss << vector_to_string(bmin);
     oss << ":";
     oss << vector_to_string(bmax);
+    if (!subset.empty()) oss << ":" << subset;
 
     return (oss.str());
 }
@@ -300,12 +306,13 @@ CurvilinearGrid *GridHelper::_make_grid_curvilinear(size_t ts, int level, int lo
     string qtr_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax);
 
     // Try to get a shared pointer to the QuadTreeRectangle from the
-    // cache. If one does not exist the Grid class will make one. We use
-    // a shared pointer so that we can cache it for use by other Grid
-    // classes. This a peformance optimization, necessary be creating
-    // a QuadTreeRectangle is expensive.
+    // cache, or from a file saved by SetQuadTreeFilePrefix(). If one
+    // does not exist the Grid class will make one. We use a shared
+    // pointer so that we can cache it for use by other Grid classes.
+    // This a peformance optimization, necessary be creating a
+    // QuadTreeRectangle is expensive.
     //
-    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _qtrCache.get(qtr_key);
+    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _getQuadTreeRectangle(qtr_key);
 
     CurvilinearGrid *g;
     if (dims.size() == 3 && cvarsinfo[2].GetDimNames().size() == 3) {
@@ -340,7 +347,7 @@ CurvilinearGrid *GridHelper::_make_grid_curvilinear(size_t ts, int level, int lo
     //
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
-        (void)_qtrCache.put(qtr_key, qtr);
+        _putQuadTreeRectangle(qtr_key, qtr);
     }
 
     return (g);
@@ -350,7 +357,7 @@ UnstructuredGrid2D *GridHelper::_make_grid_unstructured2d(size_t ts, int level,
                                                           const vector<float *> &blkvec, const vector<size_t> &bs, const vector<size_t> &bmin, const vector<size_t> &bmax,
                                                           const vector<int *> &conn_blkvec, const vector<size_t> &conn_bs, const vector<size_t> &conn_bmin, const vector<size_t> &conn_bmax,
                                                           const vector<size_t> &vertexDims, const vector<size_t> &faceDims, const vector<size_t> &edgeDims, UnstructuredGrid::Location location,
-                                                          size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset)
+                                                          size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset, const string &subset)
 {
     VAssert(dims.size() == 1);
     VAssert(dims.size() == bs.size());
@@ -409,15 +416,16 @@ UnstructuredGrid2D *GridHelper::_make_grid_unstructured2d(size_t ts, int level,
 
     UnstructuredGridCoordless zug;
 
-    string qtr_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax);
+    string qtr_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax, subset);
 
     // Try to get a shared pointer to the QuadTreeRectangle from the
-    // cache. If one does not exist the Grid class will make one. We use
-    // a shared pointer so that we can cache it for use by other Grid
-    // classes. This a peformance optimization, necessary be creating
-    // a QuadTreeRectangle is expensive.
+    // cache, or from a file saved by SetQuadTreeFilePrefix(). If one
+    // does not exist the Grid class will make one. We use a shared
+    // pointer so that we can cache it for use by other Grid classes.
+    // This a peformance optimization, necessary be creating a
+    // QuadTreeRectangle is expensive.
     //
-    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _qtrCache.get(qtr_key);
+    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _getQuadTreeRectangle(qtr_key);
 
     UnstructuredGrid2D *g = new UnstructuredGrid2D(vertexDims, faceDims, edgeDims, bs, blkptrs, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, vertexOffset,
                                                    faceOffset, xug, yug, zug, qtr);
@@ -428,7 +436,7 @@ UnstructuredGrid2D *GridHelper::_make_grid_unstructured2d(size_t ts, int level,
     //
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
-        (void)_qtrCache.put(qtr_key, qtr);
+        _putQuadTreeRectangle(qtr_key, qtr);
     }
 
     return (g);
@@ -438,7 +446,8 @@ UnstructuredGridLayered *GridHelper::_make_grid_unstructured_layered(size_t ts,
                                                                      const vector<float *> &blkvec, const vector<size_t> &bs, const vector<size_t> &bmin, const vector<size_t> &bmax,
                                                                      const vector<int *> &conn_blkvec, const vector<size_t> &conn_bs, const vector<size_t> &conn_bmin, const vector<size_t> &conn_bmax,
                                                                      const vector<size_t> &vertexDims, const vector<size_t> &faceDims, const vector<size_t> &edgeDims,
-                                                                     UnstructuredGrid::Location location, size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset)
+                                                                     UnstructuredGrid::Location location, size_t maxVertexPerFace, size_t maxFacePerVertex, long vertexOffset, long faceOffset,
+                                                                     const string &subset)
 {
     VAssert(dims.size() == 2);
     VAssert(dims.size() == bs.size());
@@ -516,15 +525,16 @@ UnstructuredGridLayered *GridHelper::_make_grid_unstructured_layered(size_t ts,
 
     UnstructuredGridCoordless zug(vertexDims, faceDims, edgeDims, bs, zcblkptrs, 3, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
 
-    string qtr_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax);
+    string qtr_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax, subset);
 
     // Try to get a shared pointer to the QuadTreeRectangle from the
-    // cache. If one does not exist the Grid class will make one. We use
-    // a shared pointer so that we can cache it for use by other Grid
-    // classes. This a peformance optimization, necessary be creating
-    // a QuadTreeRectangle is expensive.
+    // cache, or from a file saved by SetQuadTreeFilePrefix(). If one
+    // does not exist the Grid class will make one. We use a shared
+    // pointer so that we can cache it for use by other Grid classes.
+    // This a peformance optimization, necessary be creating a
+    // QuadTreeRectangle is expensive.
     //
-    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _qtrCache.get(qtr_key);
+    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _getQuadTreeRectangle(qtr_key);
 
     UnstructuredGridLayered *g = new UnstructuredGridLayered(vertexDims, faceDims, edgeDims, bs, blkptrs, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex,
                                                              vertexOffset, faceOffset, xug, yug, zug, qtr);
@@ -535,7 +545,7 @@ UnstructuredGridLayered *GridHelper::_make_grid_unstructured_layered(size_t ts,
     //
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
-        (void)_qtrCache.put(qtr_key, qtr);
+        _putQuadTreeRectangle(qtr_key, qtr);
     }
 
     return (g);
@@ -605,16 +615,16 @@ UnstructuredGrid *GridHelper::MakeGridUnstructured(string gridType, size_t ts, i
                                                    const vector<vector<size_t>> &bmaxvec, const vector<int *> &conn_blkvec, const vector<vector<size_t>> &conn_bsvec,
                                                    const vector<vector<size_t>> &conn_bminvec, const vector<vector<size_t>> &conn_bmaxvec, const vector<size_t> &vertexDims,
                                                    const vector<size_t> &faceDims, const vector<size_t> &edgeDims, UnstructuredGrid::Location location, size_t maxVertexPerFace,
-                                                   size_t maxFacePerVertex, long vertexOffset, long faceOffset)
+                                                   size_t maxFacePerVertex, long vertexOffset, long faceOffset, const string &subset)
 {
     UnstructuredGrid *rg = NULL;
 
     if (gridType == UnstructuredGrid2D::GetClassType()) {
         rg = _make_grid_unstructured2d(ts, level, lod, var, cvarsinfo, roi_dims, blkvec, bsvec[0], bminvec[0], bmaxvec[0], conn_blkvec, conn_bsvec[0], conn_bminvec[0], conn_bmaxvec[0], vertexDims,
-                                       faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
+                                       faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset, subset);
     } else if (gridType == UnstructuredGridLayered::GetClassType()) {
         rg = _make_grid_unstructured_layered(ts, level, lod, var, cvarsinfo, roi_dims, blkvec, bsvec[0], bminvec[0], bmaxvec[0], conn_blkvec, conn_bsvec[0], conn_bminvec[0], conn_bmaxvec[0],
-                                             vertexDims, faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
+                                             vertexDims, faceDims, edgeDims, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset, subset);
     } else {
         return (NULL);
     }
@@ -629,6 +639,43 @@ GridHelper::~GridHelper()
     while ((_qtrCache.remove_lru()) != NULL) {}
 }
 
+void GridHelper::SetQuadTreeFilePrefix(string prefix, string id)
+{
+    _qtrFilePrefix = prefix;
+    _qtrFileID = id;
+}
+
+string GridHelper::_getQuadTreeRectangleFile(const string &key) const
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)SerialUtils::FNV1a(key));
+    return (_qtrFilePrefix + "." + buf + ".qtr");
+}
+
+std::shared_ptr<const QuadTreeRectangle<float, size_t>> GridHelper::_getQuadTreeRectangle(const string &key)
+{
+    std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr = _qtrCache.get(key);
+    if (qtr || _qtrFilePrefix.empty()) return (qtr);
+
+    std::shared_ptr<QuadTreeRectangle<float, size_t>> saved = std::make_shared<QuadTreeRectangle<float, size_t>>();
+    if (saved->Read(_getQuadTreeRectangleFile(key), _qtrFileID + " " + key) < 0) return (nullptr);
+
+    qtr = saved;
+    (void)_qtrCache.put(key, qtr);
+    return (qtr);
+}
+
+void GridHelper::_putQuadTreeRectangle(const string &key, std::shared_ptr<const QuadTreeRectangle<float, size_t>> qtr)
+{
+    (void)_qtrCache.put(key, qtr);
+    if (!qtr || _qtrFilePrefix.empty()) return;
+
+    // Not being able to save the tree only costs time
+    //
+    string path = _getQuadTreeRectangleFile(key);
+    if (qtr->Write(path, _qtrFileID + " " + key) < 0) { SetDiagMsg("GridHelper::_putQuadTreeRectangle() - failed to save %s", path.c_str()); }
+}
+
 string GridHelper::GetGridType(const DC::Mesh &m, const vector<DC::CoordVar> &cvarsinfo, const vector<vector<string>> &cdimnames) const
 {
     if (isUnstructured2D(m, cvarsinfo, cdimnames)) { return (UnstructuredGrid2D::GetClassType()); }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <cfloat>
 #include <vapor/vizutil.h>
 #include "vapor/utils.h"
@@ -37,6 +38,14 @@ LayeredGrid::LayeredGrid(const vector<size_t> &dims, const vector<size_t> &bs, c
     _maxu[2] = (double)range[1];
 }
 
+const vector<float> &LayeredGrid::_getColumnBounds() const
+{
+    // Built on the first point query. Most grids are never searched.
+    //
+    std::call_once(_columnBoundsOnce, [this]() { MakeColumnBounds(_zrg, _columnBounds); });
+    return (_columnBounds);
+}
+
 vector<size_t> LayeredGrid::GetCoordDimensions(size_t dim) const
 {
     if (dim == 0) {
@@ -56,6 +65,44 @@ void LayeredGrid::GetUserExtentsHelper(DblArr3 &minu, DblArr3 &maxu) const
     maxu = _maxu;
 }
 
+void LayeredGrid::ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    if (ncoords < 3) {
+        ForEachBlockInSeparableBox(minu, maxu, ncoords, visitor, part, nparts);
+        return;
+    }
+
+    // Vertical coordinates are read straight from the blocks of _zrg
+    // when it is laid out like this grid
+    //
+    const vector<float *> &blks = GetBlks();
+    const vector<float *> &zblks = _zrg.GetBlks();
+    const vector<size_t> & bs = GetBlockSize();
+    const vector<size_t>   bdims = GetDimensionInBlks();
+    bool                   sameLayout = zblks.size() == blks.size() && _zrg.GetDimensions() == GetDimensions() && _zrg.GetBlockSize() == bs;
+
+    auto zVisitor = [&](const Span &span) {
+        if (sameLayout) {
+            size_t       b = (span.index[2] / bs[2]) * bdims[0] * bdims[1] + (span.index[1] / bs[1]) * bdims[0] + span.index[0] / bs[0];
+            const float *z = zblks[b] + (span.data - blks[b]);
+
+            VisitInside(
+                span, [&](size_t i) { return (z[i] >= minu[2] && z[i] <= maxu[2]); }, visitor);
+        } else {
+            VisitInside(
+                span,
+                [&](size_t i) {
+                    Size_tArr3 index = {span.index[0] + i, span.index[1], span.index[2]};
+                    double     z = _zrg.GetValueAtIndex(index);
+                    return (z >= minu[2] && z <= maxu[2]);
+                },
+                visitor);
+        }
+    };
+
+    ForEachBlockInSeparableBox(minu, maxu, 2, zVisitor, part, nparts);
+}
+
 void LayeredGrid::GetBoundingBox(const Size_tArr3 &min, const Size_tArr3 &max, DblArr3 &minu, DblArr3 &maxu) const
 {
     Size_tArr3 cMin;
@@ -139,30 +186,55 @@ bool LayeredGrid::_insideGrid(const DblArr3 &coords, Size_tArr3 &indices, double
         if (!inside) return (false);
     }
 
-    float z0, z1;
+    const vector<size_t> &dims = GetDimensions();
+    size_t                nz = dims[2];
+    double                z = coords[2];
 
-    // Find k index of cell containing z. Already know i and j indices
+    // Points above or below the column of cells are rejected without
+    // interpolating any levels
     //
-    vector<double> zcoords;
+    const vector<float> &bounds = _getColumnBounds();
+    if (!bounds.empty() && indices[0] < dims[0] - 1 && indices[1] < dims[1] - 1) {
+        size_t c = 2 * (indices[1] * (dims[0] - 1) + indices[0]);
+        if (z < bounds[c] || z > bounds[c + 1]) return (false);
+    }
 
-    size_t nz = GetDimensions()[2];
-    zcoords.reserve(nz);
-    for (int kk = 0; kk < nz; kk++) {
-        // Interpolate Z coordinate across triangle
-        //
+    // Z coordinate of level kk, interpolated across the triangle
+    //
+    auto zcoord = [&](size_t kk) -> double {
         float zk = _zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2];
+        return (zk);
+    };
 
-        zcoords.push_back(zk);
+    // Find k index of cell containing z. Already know i and j indices.
+    // If the last query was in this or a neighbouring column try its layer
+    // first, then search the levels, interpolating only the ones the
+    // search visits
+    //
+    float      z0, z1;
+    Size_tArr3 hint;
+    found = false;
+    if (GetCellHint(hint) && hint[2] + 1 < nz && hint[0] + 1 >= indices[0] && hint[0] <= indices[0] + 1 && hint[1] + 1 >= indices[1] && hint[1] <= indices[1] + 1) {
+        z0 = zcoord(hint[2]);
+        z1 = zcoord(hint[2] + 1);
+        if ((z0 <= z && z < z1) || (z0 >= z && z > z1)) {
+            indices[2] = hint[2];
+            found = true;
+        }
     }
 
-    if (!Wasp::BinarySearchRange(zcoords, coords[2], indices[2])) return (false);
+    if (!found) {
+        if (!Wasp::BinarySearchRange(nz, zcoord, z, indices[2])) return (false);
 
-    VAssert(indices[2] < nz - 1);
+        VAssert(indices[2] < nz - 1);
 
-    z0 = zcoords[indices[2]];
-    z1 = zcoords[indices[2] + 1];
+        z0 = zcoord(indices[2]);
+        z1 = zcoord(indices[2] + 1);
+    }
+
+    SetCellHint(indices);
 
-    wgts[2] = 1.0 - (coords[2] - z0) / (z1 - z0);
+    wgts[2] = 1.0 - (z - z0) / (z1 - z0);
 
     return (true);
 }
@@ -279,6 +351,46 @@ float LayeredGrid::GetValue(const DblArr3 &coords) const
     return _getValueQuadratic(cCoords.data());
 }
 
+void LayeredGrid::GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const
+{
+    int interp_order = _interpolationOrder;
+    if (interp_order == 2 && GetDimensions()[2] < 3) interp_order = 1;
+
+    if (interp_order == 2 || !GetBlks().size()) {
+        Grid::GetValues(n, x, y, z, values);
+        return;
+    }
+
+    float               missingValue = GetMissingValue();
+    const vector<bool> &periodic = GetPeriodic();
+    bool                clamp = std::any_of(periodic.begin(), periodic.end(), [](bool v) { return (v); });
+
+    for (size_t p = 0; p < n; p++) {
+        DblArr3 coords = {x[p], y[p], z[p]};
+        if (clamp) {
+            DblArr3 cCoords;
+            ClampCoord(coords, cCoords);
+            coords = cCoords;
+        }
+
+        Size_tArr3 indices;
+        double     wgts[3];
+        if (!_insideGrid(coords, indices, wgts)) {
+            values[p] = missingValue;
+            continue;
+        }
+
+        float v[8];
+        GetCellNodeValues(indices[0], indices[1], indices[2], v);
+
+        if (interp_order == 0) {
+            values[p] = v[(wgts[0] < 0.5) + 2 * (wgts[1] < 0.5) + 4 * (wgts[2] < 0.5)];
+        } else {
+            values[p] = TrilinearInterp(v, 1.0 - wgts[0], 1.0 - wgts[1], 1.0 - wgts[2], missingValue);
+        }
+    }
+}
+
 void LayeredGrid::SetInterpolationOrder(int order)
 {
     if (order < 0 || order > 3) order = 2;
@@ -0,0 +1,248 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+#include <cstdint>
+#include "vapor/VAssert.h"
+#include <vapor/SerialUtils.h>
+#include <vapor/MeshPartitionIndex.h>
+
+using namespace VAPoR;
+using namespace Wasp;
+using namespace std;
+
+namespace {
+
+const uint64_t indexMagic = 0x5641504f524d5049ULL;    // "VAPORMPI"
+const uint64_t indexVersion = 1;
+
+// Distance along a Hilbert curve filling an n x n grid, n a power of two,
+// of the cell (x, y)
+//
+uint64_t hilbert_distance(uint32_t n, uint32_t x, uint32_t y)
+{
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return (d);
+}
+
+// As in UnstructuredGrid, a missing or boundary ID ends the list of
+// nodes of a face
+//
+bool valid_id(int v, long offset) { return (v != -1 && v != -2 && v + offset >= 0); }
+
+};    // namespace
+
+MeshPartitionIndex::MeshPartitionIndex()
+{
+    _partitionSize = 0;
+    _min = {0.0, 0.0};
+    _max = {0.0, 0.0};
+}
+
+int MeshPartitionIndex::Build(size_t nNodes, const float *x, const float *y, size_t nFaces, const int *vertexOnFace, size_t maxVertexPerFace, long vertexOffset, size_t partitionSize)
+{
+    _order.clear();
+    _bounds.clear();
+
+    if (!nNodes || !partitionSize) {
+        SetErrMsg("Invalid mesh");
+        return (-1);
+    }
+    _partitionSize = partitionSize;
+
+    float xmin = x[0], xmax = x[0], ymin = y[0], ymax = y[0];
+    for (size_t i = 1; i < nNodes; i++) {
+        xmin = std::min(xmin, x[i]);
+        xmax = std::max(xmax, x[i]);
+        ymin = std::min(ymin, y[i]);
+        ymax = std::max(ymax, y[i]);
+    }
+    _min = {xmin, ymin};
+    _max = {xmax, ymax};
+
+    // Sort the nodes by their distance along a Hilbert curve through a
+    // 2^16 x 2^16 grid covering the mesh
+    //
+    const uint32_t n = 1 << 16;
+    double         xscale = xmax > xmin ? (n - 1) / ((double)xmax - xmin) : 0.0;
+    double         yscale = ymax > ymin ? (n - 1) / ((double)ymax - ymin) : 0.0;
+
+    vector<pair<uint64_t, int>> keys(nNodes);
+    for (size_t i = 0; i < nNodes; i++) {
+        uint32_t xi = (uint32_t)((x[i] - xmin) * xscale);
+        uint32_t yi = (uint32_t)((y[i] - ymin) * yscale);
+        keys[i] = make_pair(hilbert_distance(n, xi, yi), (int)i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    size_t         nparts = (nNodes + partitionSize - 1) / partitionSize;
+    vector<size_t> partitionOf(nNodes);
+    _order.resize(nNodes);
+    for (size_t i = 0; i < nNodes; i++) {
+        _order[i] = keys[i].second;
+        partitionOf[keys[i].second] = i / partitionSize;
+    }
+
+    const float big = std::numeric_limits<float>::max();
+    _bounds.resize(4 * nparts);
+    for (size_t p = 0; p < nparts; p++) {
+        _bounds[4 * p + 0] = big;
+        _bounds[4 * p + 1] = big;
+        _bounds[4 * p + 2] = -big;
+        _bounds[4 * p + 3] = -big;
+    }
+
+    for (size_t i = 0; i < nNodes; i++) {
+        float *b = &_bounds[4 * partitionOf[i]];
+        b[0] = std::min(b[0], x[i]);
+        b[1] = std::min(b[1], y[i]);
+        b[2] = std::max(b[2], x[i]);
+        b[3] = std::max(b[3], y[i]);
+    }
+
+    // Grow the box of each partition to cover the faces that share its
+    // nodes
+    //
+    for (size_t f = 0; f < nFaces; f++) {
+        const int *ptr = vertexOnFace + f * maxVertexPerFace;
+
+        float fb[4] = {big, big, -big, -big};
+        for (size_t i = 0; i < maxVertexPerFace; i++) {
+            if (!valid_id(ptr[i], vertexOffset) || ptr[i] + vertexOffset >= (long)nNodes) break;
+
+            size_t node = ptr[i] + vertexOffset;
+            fb[0] = std::min(fb[0], x[node]);
+            fb[1] = std::min(fb[1], y[node]);
+            fb[2] = std::max(fb[2], x[node]);
+            fb[3] = std::max(fb[3], y[node]);
+        }
+
+        for (size_t i = 0; i < maxVertexPerFace; i++) {
+            if (!valid_id(ptr[i], vertexOffset) || ptr[i] + vertexOffset >= (long)nNodes) break;
+
+            float *b = &_bounds[4 * partitionOf[ptr[i] + vertexOffset]];
+            b[0] = std::min(b[0], fb[0]);
+            b[1] = std::min(b[1], fb[1]);
+            b[2] = std::max(b[2], fb[2]);
+            b[3] = std::max(b[3], fb[3]);
+        }
+    }
+
+    return (0);
+}
+
+int MeshPartitionIndex::Write(string path, const string &key) const
+{
+    return (SerialUtils::WriteFileAtomic(path, [this, &key](ostream &out) {
+        SerialUtils::WriteU64(out, indexMagic);
+        SerialUtils::WriteU64(out, indexVersion);
+        SerialUtils::WriteString(out, key);
+        SerialUtils::WriteU64(out, _partitionSize);
+        SerialUtils::WriteU64(out, _order.size());
+        out.write((const char *)_min.data(), 2 * sizeof(double));
+        out.write((const char *)_max.data(), 2 * sizeof(double));
+        out.write((const char *)_bounds.data(), _bounds.size() * sizeof(float));
+        out.write((const char *)_order.data(), _order.size() * sizeof(int));
+        return ((bool)out);
+    }));
+}
+
+int MeshPartitionIndex::Read(string path, const string &key, size_t nNodes)
+{
+    ifstream in(path.c_str(), ios::in | ios::binary);
+    if (!in) return (-1);
+
+    uint64_t magic, version, partitionSize, n;
+    string   mykey;
+    bool     ok = SerialUtils::ReadU64(in, magic) && magic == indexMagic;
+    ok = ok && SerialUtils::ReadU64(in, version) && version == indexVersion;
+    ok = ok && SerialUtils::ReadString(in, mykey) && mykey == key;
+    ok = ok && SerialUtils::ReadU64(in, partitionSize) && partitionSize > 0;
+    ok = ok && SerialUtils::ReadU64(in, n) && n == nNodes && n > 0;
+    if (!ok) return (-1);
+
+    size_t         nparts = (n + partitionSize - 1) / partitionSize;
+    vector<double> min(2), max(2);
+    vector<float>  bounds(4 * nparts);
+    vector<int>    order(n);
+    in.read((char *)min.data(), 2 * sizeof(double));
+    in.read((char *)max.data(), 2 * sizeof(double));
+    in.read((char *)bounds.data(), bounds.size() * sizeof(float));
+    in.read((char *)order.data(), order.size() * sizeof(int));
+    if (!in) return (-1);
+
+    for (size_t i = 0; i < n; i++) {
+        if (order[i] < 0 || order[i] >= (long)n) return (-1);
+    }
+
+    _partitionSize = partitionSize;
+    _min = min;
+    _max = max;
+    _bounds = bounds;
+    _order = order;
+    return (0);
+}
+
+void MeshPartitionIndex::GetExtents(vector<double> &min, vector<double> &max) const
+{
+    min = _min;
+    max = _max;
+}
+
+void MeshPartitionIndex::Query(const vector<double> &min, const vector<double> &max, vector<size_t> &partitions) const
+{
+    VAssert(min.size() >= 2 && max.size() >= 2);
+
+    partitions.clear();
+    for (size_t p = 0; p < GetNumPartitions(); p++) {
+        const float *b = &_bounds[4 * p];
+        if (b[0] > max[0] || b[2] < min[0]) continue;
+        if (b[1] > max[1] || b[3] < min[1]) continue;
+        partitions.push_back(p);
+    }
+}
+
+void MeshPartitionIndex::GetNodes(const vector<size_t> &partitions, vector<size_t> &nodes) const
+{
+    nodes.clear();
+    for (size_t i = 0; i < partitions.size(); i++) {
+        size_t start = partitions[i] * _partitionSize;
+        size_t end = std::min(start + _partitionSize, _order.size());
+        for (size_t j = start; j < end; j++) nodes.push_back(_order[j]);
+    }
+    std::sort(nodes.begin(), nodes.end());
+}
+
+void MeshPartitionIndex::Remap(int *ids, size_t n, long offset, const vector<size_t> &subset)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (ids[i] == -2) continue;
+        if (ids[i] == -1 || ids[i] + offset < 0) {
+            ids[i] = -1;
+            continue;
+        }
+
+        size_t                           id = ids[i] + offset;
+        vector<size_t>::const_iterator itr = std::lower_bound(subset.begin(), subset.end(), id);
+        if (itr != subset.end() && *itr == id) {
+            ids[i] = (int)(itr - subset.begin());
+        } else {
+            ids[i] = -2;
+        }
+    }
+}
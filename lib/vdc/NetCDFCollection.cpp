@@ -1,8 +1,17 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include "vapor/VAssert.h"
 #include <netcdf.h>
+#include <vapor/CFuncs.h>
+#include <vapor/FileUtils.h>
+#include <vapor/SerialUtils.h>
 #include <vapor/NetCDFCollection.h>
 
 using namespace VAPoR;
@@ -43,6 +52,163 @@ bool readOK(vector<size_t> dims, size_t start[], size_t count[])
     return (true);
 }
 
+// On-disk metadata index. The index holds one entry per netCDF file,
+// keyed by path and validated against the file's size and modification
+// time. Entries are per file, rather than a single record for the
+// merged collection, so that appending or rewriting a few files in a
+// long run only invalidates the entries for those files.
+//
+const uint64_t indexMagic = 0x5641504f52494458ULL;    // "VAPORIDX"
+const uint64_t indexVersion = 2;
+
+class index_entry {
+public:
+    index_entry() : _size(0), _mtime(0) {}
+    uint64_t                    _size;
+    int64_t                     _mtime;
+    string                      _metadata;     // NetCDFSimple::WriteMetadata() output
+    map<string, vector<double>> _tcvValues;    // time coordinate variable values
+    map<string, vector<string>> _textValues;   // records of character variables
+};
+
+bool file_stat(const string &path, uint64_t &size, int64_t &mtime)
+{
+    struct stat sb;
+    if (stat(path.c_str(), &sb) != 0) return (false);
+    size = sb.st_size;
+    mtime = sb.st_mtime;
+    return (true);
+}
+
+// The index for a collection lives in the index directory under a name
+// derived from the directory containing the first file (FNV-1a hash),
+// so collections in different directories don't contend for one index.
+//
+string index_path(const string &dir, const vector<string> &files)
+{
+    string key = files.empty() ? string() : FileUtils::Dirname(files[0]);
+
+    uint64_t h = SerialUtils::FNV1a(key);
+
+    ostringstream oss;
+    oss << "ncindex_" << std::hex << h << ".idx";
+    return (FileUtils::JoinPaths({dir, oss.str()}));
+}
+
+// Read an index. A missing, truncated, or otherwise unreadable index
+// is treated as empty.
+//
+void read_index(const string &path, map<string, index_entry> &index)
+{
+    index.clear();
+
+    ifstream in(path.c_str(), ios::in | ios::binary);
+    if (!in) return;
+
+    uint64_t magic, version, n;
+    if (!SerialUtils::ReadU64(in, magic) || magic != indexMagic) return;
+    if (!SerialUtils::ReadU64(in, version) || version != indexVersion) return;
+    if (!SerialUtils::ReadU64(in, n)) return;
+
+    map<string, index_entry> entries;
+    for (uint64_t i = 0; i < n; i++) {
+        string      file;
+        index_entry e;
+        uint64_t    mtime, ntcv;
+        if (!SerialUtils::ReadString(in, file) || !SerialUtils::ReadU64(in, e._size) || !SerialUtils::ReadU64(in, mtime)) return;
+        if (!SerialUtils::ReadString(in, e._metadata) || !SerialUtils::ReadU64(in, ntcv)) return;
+        e._mtime = (int64_t)mtime;
+
+        for (uint64_t j = 0; j < ntcv; j++) {
+            string   name;
+            uint64_t len;
+            if (!SerialUtils::ReadString(in, name) || !SerialUtils::ReadU64(in, len)) return;
+            if (len > (1ULL << 27)) return;    // Corrupt
+
+            vector<double> &values = e._tcvValues[name];
+            values.resize(len);
+            if (len) in.read((char *)values.data(), len * sizeof(double));
+            if (!in) return;
+        }
+
+        uint64_t ntext;
+        if (!SerialUtils::ReadU64(in, ntext)) return;
+        for (uint64_t j = 0; j < ntext; j++) {
+            string   name;
+            uint64_t len;
+            if (!SerialUtils::ReadString(in, name) || !SerialUtils::ReadU64(in, len)) return;
+            if (len > (1ULL << 27)) return;    // Corrupt
+
+            vector<string> &records = e._textValues[name];
+            records.resize(len);
+            for (uint64_t k = 0; k < len; k++) {
+                if (!SerialUtils::ReadString(in, records[k])) return;
+            }
+        }
+        entries[file] = e;
+    }
+    index = entries;
+}
+
+// Write an index. The index is written to a temporary file that is
+// renamed into place, so concurrent readers and writers (including
+// other processes) never see a partially written index. Entries written
+// by others since we read the index are kept, unless we replace them.
+//
+int write_index(const string &path, const map<string, index_entry> &index)
+{
+    map<string, index_entry> merged;
+    read_index(path, merged);
+    for (auto itr = index.begin(); itr != index.end(); ++itr) merged[itr->first] = itr->second;
+
+    // Drop entries for files that no longer exist so the index
+    // doesn't grow without bound
+    //
+    map<string, index_entry>::iterator itr = merged.begin();
+    while (itr != merged.end()) {
+        uint64_t size;
+        int64_t  mtime;
+        if (file_stat(itr->first, size, mtime)) {
+            ++itr;
+        } else {
+            merged.erase(itr++);
+        }
+    }
+
+    return (SerialUtils::WriteFileAtomic(path, [&merged](ostream &out) {
+        SerialUtils::WriteU64(out, indexMagic);
+        SerialUtils::WriteU64(out, indexVersion);
+        SerialUtils::WriteU64(out, merged.size());
+
+        map<string, index_entry>::const_iterator itr;
+        for (itr = merged.begin(); itr != merged.end(); ++itr) {
+            const index_entry &e = itr->second;
+            SerialUtils::WriteString(out, itr->first);
+            SerialUtils::WriteU64(out, e._size);
+            SerialUtils::WriteU64(out, (uint64_t)e._mtime);
+            SerialUtils::WriteString(out, e._metadata);
+            SerialUtils::WriteU64(out, e._tcvValues.size());
+
+            map<string, vector<double>>::const_iterator itr1;
+            for (itr1 = e._tcvValues.begin(); itr1 != e._tcvValues.end(); ++itr1) {
+                SerialUtils::WriteString(out, itr1->first);
+                SerialUtils::WriteU64(out, itr1->second.size());
+                out.write((const char *)itr1->second.data(), itr1->second.size() * sizeof(double));
+            }
+
+            SerialUtils::WriteU64(out, e._textValues.size());
+
+            map<string, vector<string>>::const_iterator itr2;
+            for (itr2 = e._textValues.begin(); itr2 != e._textValues.end(); ++itr2) {
+                SerialUtils::WriteString(out, itr2->first);
+                SerialUtils::WriteU64(out, itr2->second.size());
+                for (const auto &record : itr2->second) SerialUtils::WriteString(out, record);
+            }
+        }
+        return ((bool)out);
+    }));
+}
+
 };    // namespace
 
 NetCDFCollection::NetCDFCollection()
@@ -57,6 +223,10 @@ NetCDFCollection::NetCDFCollection()
     _ovr_table.clear();
     _ncdfmap.clear();
     _failedVars.clear();
+    _indexDir.clear();
+    _tcvValues.clear();
+    _textVars.clear();
+    _textValues.clear();
 }
 
 NetCDFCollection::~NetCDFCollection() { ReInitialize(); }
@@ -82,6 +252,16 @@ void NetCDFCollection::ReInitialize()
     _ovr_table.clear();
     _ncdfmap.clear();
     _failedVars.clear();
+    _tcvValues.clear();
+    _textValues.clear();
+}
+
+string NetCDFCollection::IndexDirFromOptions(const vector<string> &options)
+{
+    for (int i = 0; i < options.size(); i++) {
+        if (options[i] == "-index_dir" && i + 1 < options.size()) return (options[i + 1]);
+    }
+    return (GetEnvironmentalVariable("VAPOR_NETCDF_INDEX_DIR"));
 }
 
 int NetCDFCollection::Initialize(const vector<string> &files, const vector<string> &time_dimnames, const vector<string> &time_coordvars)
@@ -90,12 +270,17 @@ int NetCDFCollection::Initialize(const vector<string> &files, const vector<strin
 
     ReInitialize();
 
+    // Gather the metadata for every file, from the index if enabled
+    //
+    int rc = _OpenFiles(files, time_coordvars);
+    if (rc < 0) return (-1);
+
     //
     // Build a hash table to map a variable's time dimension
     // to its time coordinates
     //
     int file_org;    // case 1, 2, 3 (3a or 3b)
-    int rc = NetCDFCollection::_InitializeTimesMap(files, l_time_dimnames, time_coordvars, _timesMap, _times, file_org);
+    rc = NetCDFCollection::_InitializeTimesMap(files, l_time_dimnames, time_coordvars, _timesMap, _times, file_org);
     if (rc < 0) return (-1);
 
     //
@@ -110,14 +295,7 @@ int NetCDFCollection::Initialize(const vector<string> &files, const vector<strin
     }
 
     for (int i = 0; i < files.size(); i++) {
-        NetCDFSimple *netcdf = new NetCDFSimple();
-        _ncdfmap[files[i]] = netcdf;
-
-        rc = netcdf->Initialize(files[i]);
-        if (rc < 0) {
-            SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
-            return (-1);
-        }
+        NetCDFSimple *netcdf = _ncdfmap[files[i]];
 
         //
         // Get dimension names and lengths
@@ -553,6 +731,44 @@ int NetCDFCollection::GetFile(size_t ts, string varname, string &file, size_t &l
     return (tvvars.GetFile(var_ts, file));
 }
 
+int NetCDFCollection::ReadText(size_t ts, string varname, string &text)
+{
+    text.clear();
+
+    string file;
+    size_t local_ts;
+    int    rc = GetFile(ts, varname, file, local_ts);
+    if (rc < 0) return (-1);
+
+    // Gathered by _OpenFiles()?
+    //
+    map<string, map<string, vector<string>>>::const_iterator itr = _textValues.find(file);
+    if (itr != _textValues.end()) {
+        map<string, vector<string>>::const_iterator itr1 = itr->second.find(varname);
+        if (itr1 != itr->second.end() && local_ts < itr1->second.size()) {
+            text = itr1->second[local_ts];
+            return (0);
+        }
+    }
+
+    vector<size_t> dims = GetSpatialDims(varname);
+    if (dims.size() != 1) {
+        SetErrMsg("Invalid character variable : %s", varname.c_str());
+        return (-1);
+    }
+
+    int fd = OpenRead(ts, varname);
+    if (fd < 0) return (-1);
+
+    vector<char> buf(dims[0] + 1, '\0');
+    rc = Read(buf.data(), fd);
+    Close(fd);
+    if (rc < 0) return (-1);
+
+    text = buf.data();
+    return (0);
+}
+
 bool NetCDFCollection::_GetVariableInfo(string varname, NetCDFSimple::Variable &varinfo) const
 {
     if (NetCDFCollection::IsDerivedVar(varname)) {
@@ -842,6 +1058,136 @@ int NetCDFCollection::ReadNative(int *data, int fd)
     return (NetCDFCollection::ReadNative(start, count, data, fd));
 }
 
+int NetCDFCollection::_OpenFiles(const vector<string> &files, const vector<string> &time_coordvars)
+{
+    map<string, index_entry> index;
+    string                   indexPath;
+    if (!_indexDir.empty()) {
+        indexPath = index_path(_indexDir, files);
+        read_index(indexPath, index);
+    }
+
+    double t0 = Wasp::GetTime();
+    int    nhits = 0;
+    bool   dirty = false;
+
+    for (int i = 0; i < files.size(); i++) {
+        if (_ncdfmap.find(files[i]) != _ncdfmap.end()) continue;
+
+        NetCDFSimple *netcdf = new NetCDFSimple();
+        _ncdfmap[files[i]] = netcdf;
+
+        uint64_t size = 0;
+        int64_t  mtime = 0;
+        bool     indexable = !indexPath.empty() && file_stat(files[i], size, mtime);
+
+        map<string, index_entry>::iterator itr = index.end();
+        if (indexable) itr = index.find(files[i]);
+
+        // Use the index entry if the file hasn't changed since it was
+        // made. Otherwise read the metadata from the file and replace
+        // the entry.
+        //
+        bool hit = false;
+        if (itr != index.end() && itr->second._size == size && itr->second._mtime == mtime) {
+            istringstream iss(itr->second._metadata);
+            bool          enable = EnableErrMsg(false);
+            hit = netcdf->ReadMetadata(iss, files[i]) >= 0;
+            (void)EnableErrMsg(enable);
+            if (!hit) SetErrCode(0);
+        }
+
+        if (hit) {
+            nhits++;
+        } else {
+            int rc = netcdf->Initialize(files[i]);
+            if (rc < 0) {
+                SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
+                return (-1);
+            }
+
+            if (indexable) {
+                index_entry   e;
+                ostringstream oss;
+                (void)netcdf->WriteMetadata(oss);
+                e._size = size;
+                e._mtime = mtime;
+                e._metadata = oss.str();
+                index[files[i]] = e;
+                itr = index.find(files[i]);
+                dirty = true;
+            }
+        }
+
+        //
+        // Get the values of any time coordinate variables in this file
+        //
+        const vector<NetCDFSimple::Variable> &variables = netcdf->GetVariables();
+        for (int j = 0; j < time_coordvars.size(); j++) {
+            int vindex = _get_var_index(variables, time_coordvars[j]);
+            if (vindex < 0) continue;    // TCV doesn't exist
+
+            if (hit && itr->second._tcvValues.find(time_coordvars[j]) != itr->second._tcvValues.end()) {
+                _tcvValues[files[i]][time_coordvars[j]] = itr->second._tcvValues[time_coordvars[j]];
+                continue;
+            }
+
+            float *buf = _Get1DVar(netcdf, variables[vindex]);
+            if (!buf) {
+                SetErrMsg("Failed to read time coordinate variable \"%s\"", time_coordvars[j].c_str());
+                return (-1);
+            }
+
+            size_t         timedimlen = netcdf->DimLen(variables[vindex].GetDimNames()[0]);
+            vector<double> times(buf, buf + timedimlen);
+            delete[] buf;
+
+            _tcvValues[files[i]][time_coordvars[j]] = times;
+            if (indexable) {
+                itr->second._tcvValues[time_coordvars[j]] = times;
+                dirty = true;
+            }
+        }
+
+        //
+        // Likewise for the records of any character variables requested
+        // with SetTextVars()
+        //
+        for (int j = 0; j < _textVars.size(); j++) {
+            int vindex = _get_var_index(variables, _textVars[j]);
+            if (vindex < 0) continue;
+
+            if (hit && itr->second._textValues.find(_textVars[j]) != itr->second._textValues.end()) {
+                _textValues[files[i]][_textVars[j]] = itr->second._textValues[_textVars[j]];
+                continue;
+            }
+
+            vector<string> records;
+            int            rc = _GetTextVar(netcdf, variables[vindex], records);
+            if (rc < 0) {
+                SetErrMsg("Failed to read character variable \"%s\"", _textVars[j].c_str());
+                return (-1);
+            }
+
+            _textValues[files[i]][_textVars[j]] = records;
+            if (indexable) {
+                itr->second._textValues[_textVars[j]] = records;
+                dirty = true;
+            }
+        }
+    }
+
+    if (dirty) {
+        // Failing to update the index only costs time on the next open
+        //
+        if (write_index(indexPath, index) < 0) { SetDiagMsg("NetCDFCollection : failed to write metadata index %s", indexPath.c_str()); }
+    }
+
+    SetDiagMsg("NetCDFCollection : gathered metadata for %d files (%d from index) in %f seconds", (int)files.size(), nhits, Wasp::GetTime() - t0);
+
+    return (0);
+}
+
 int NetCDFCollection::_InitializeTimesMap(const vector<string> &files, const vector<string> &time_dimnames, const vector<string> &time_coordvars, map<string, vector<double>> &timesMap,
                                           vector<double> &times, int &file_org) const
 {
@@ -908,13 +1254,7 @@ int NetCDFCollection::_InitializeTimesMapCase1(const vector<string> &files, map<
     //
 
     for (int i = 0; i < files.size(); i++) {
-        NetCDFSimple *netcdf = new NetCDFSimple();
-
-        int rc = netcdf->Initialize(files[i]);
-        if (rc < 0) {
-            SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
-            return (-1);
-        }
+        const NetCDFSimple *netcdf = _ncdfmap.find(files[i])->second;
 
         const vector<NetCDFSimple::Variable> &variables = netcdf->GetVariables();
 
@@ -937,7 +1277,6 @@ int NetCDFCollection::_InitializeTimesMapCase1(const vector<string> &files, map<
 
             currentTime[varname] += 1.0;
         }
-        delete netcdf;
     }
     return (0);
 }
@@ -957,13 +1296,7 @@ int NetCDFCollection::_InitializeTimesMapCase2(const vector<string> &files, cons
     //
 
     for (int i = 0; i < files.size(); i++) {
-        NetCDFSimple *netcdf = new NetCDFSimple();
-
-        int rc = netcdf->Initialize(files[i]);
-        if (rc < 0) {
-            SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
-            return (-1);
-        }
+        const NetCDFSimple *netcdf = _ncdfmap.find(files[i])->second;
 
         const vector<NetCDFSimple::Variable> &variables = netcdf->GetVariables();
 
@@ -998,7 +1331,6 @@ int NetCDFCollection::_InitializeTimesMapCase2(const vector<string> &files, cons
 
             timesMap[key] = times;
         }
-        delete netcdf;
     }
     return (0);
 }
@@ -1017,10 +1349,7 @@ int NetCDFCollection::_InitializeTimesMapCase3(const vector<string> &files, cons
     for (int i = 0; i < time_coordvars.size(); i++) { tcvcount[time_coordvars[i]] = 0; }
 
     for (int i = 0; i < files.size(); i++) {
-        NetCDFSimple *netcdf = new NetCDFSimple();
-
-        int rc = netcdf->Initialize(files[i]);
-        if (rc < 0) return (-1);
+        const NetCDFSimple *netcdf = _ncdfmap.find(files[i])->second;
 
         const vector<NetCDFSimple::Variable> &variables = netcdf->GetVariables();
 
@@ -1037,19 +1366,12 @@ int NetCDFCollection::_InitializeTimesMapCase3(const vector<string> &files, cons
 
             tcvcount[time_coordvars[j]] += 1;
 
-            // Read TCV
-            float *buf = _Get1DVar(netcdf, variables[index]);
-            if (!buf) {
-                SetErrMsg("Failed to read time coordinate variable \"%s\"", time_coordvars[j].c_str());
-                return (-1);
-            }
+            // TCV values were read, or restored from the index, by
+            // _OpenFiles()
+            //
+            const vector<double> &times = _tcvValues.find(files[i])->second.find(time_coordvars[j])->second;
 
             string timedim = variables[index].GetDimNames()[0];
-            size_t timedimlen = netcdf->DimLen(timedim);
-
-            vector<double> times;
-            for (int t = 0; t < timedimlen; t++) { times.push_back(buf[t]); }
-            delete[] buf;
 
             //
             // The hash key for timesMap is the file plus the
@@ -1070,7 +1392,6 @@ int NetCDFCollection::_InitializeTimesMapCase3(const vector<string> &files, cons
             }
         }
 
-        delete netcdf;
     }
 
     //
@@ -1145,11 +1466,48 @@ float *NetCDFCollection::_Get1DVar(NetCDFSimple *netcdf, const NetCDFSimple::Var
     size_t count[] = {dimlen};
     float *buf = new float[dimlen];
     int    rc = netcdf->Read(start, count, buf, fd);
-    if (rc < 0) { return (NULL); }
     netcdf->Close(fd);
+    if (rc < 0) {
+        delete[] buf;
+        return (NULL);
+    }
     return (buf);
 }
 
+// Read every record of a 1D, possibly time varying, character variable
+//
+int NetCDFCollection::_GetTextVar(NetCDFSimple *netcdf, const NetCDFSimple::Variable &variable, vector<string> &records) const
+{
+    records.clear();
+
+    vector<string> dimnames = variable.GetDimNames();
+    if (dimnames.size() < 1 || dimnames.size() > 2) {
+        SetErrMsg("Character variable \"%s\" is invalid", variable.GetName().c_str());
+        return (-1);
+    }
+
+    size_t nrecords = dimnames.size() == 2 ? netcdf->DimLen(dimnames[0]) : 1;
+    size_t len = netcdf->DimLen(dimnames[dimnames.size() - 1]);
+
+    int fd = netcdf->OpenRead(variable);
+    if (fd < 0) return (-1);
+
+    size_t start[] = {0, 0};
+    size_t count[] = {nrecords, len};
+    if (dimnames.size() == 1) count[0] = len;
+
+    vector<char> buf(nrecords * len);
+    int          rc = netcdf->Read(start, count, buf.data(), fd);
+    netcdf->Close(fd);
+    if (rc < 0) return (-1);
+
+    for (size_t i = 0; i < nrecords; i++) {
+        const char *record = buf.data() + i * len;
+        records.push_back(string(record, std::find(record, record + len, '\0')));
+    }
+    return (0);
+}
+
 int NetCDFCollection::_get_var_index(const vector<NetCDFSimple::Variable> variables, string varname) const
 {
     for (int i = 0; i < variables.size(); i++) {
@@ -1,12 +1,91 @@
 #include <iostream>
+#include <cstdint>
 #include "vapor/VAssert.h"
 #include <netcdf.h>
+#include <vapor/SerialUtils.h>
 #include <vapor/NetCDFSimple.h>
 
 using namespace VAPoR;
 using namespace Wasp;
 using namespace std;
 
+namespace {
+
+// Metadata serialization, see SerialUtils. The format is only meant to be
+// read back on the machine that wrote it.
+//
+const uint64_t metadataMagic = 0x4e43534d44310001ULL;    // "NCSMD1" + version
+
+void write_atts(ostream &o, const vector<pair<string, vector<double>>> &flt_atts, const vector<pair<string, vector<long>>> &int_atts, const vector<pair<string, string>> &str_atts)
+{
+    SerialUtils::WriteU64(o, flt_atts.size());
+    for (size_t i = 0; i < flt_atts.size(); i++) {
+        SerialUtils::WriteString(o, flt_atts[i].first);
+        SerialUtils::WriteU64(o, flt_atts[i].second.size());
+        o.write((const char *)flt_atts[i].second.data(), flt_atts[i].second.size() * sizeof(double));
+    }
+
+    SerialUtils::WriteU64(o, int_atts.size());
+    for (size_t i = 0; i < int_atts.size(); i++) {
+        SerialUtils::WriteString(o, int_atts[i].first);
+        SerialUtils::WriteU64(o, int_atts[i].second.size());
+        for (size_t j = 0; j < int_atts[i].second.size(); j++) SerialUtils::WriteU64(o, (uint64_t)(int64_t)int_atts[i].second[j]);
+    }
+
+    SerialUtils::WriteU64(o, str_atts.size());
+    for (size_t i = 0; i < str_atts.size(); i++) {
+        SerialUtils::WriteString(o, str_atts[i].first);
+        SerialUtils::WriteString(o, str_atts[i].second);
+    }
+}
+
+bool read_atts(istream &i, vector<pair<string, vector<double>>> &flt_atts, vector<pair<string, vector<long>>> &int_atts, vector<pair<string, string>> &str_atts)
+{
+    flt_atts.clear();
+    int_atts.clear();
+    str_atts.clear();
+
+    uint64_t n;
+    if (!SerialUtils::ReadU64(i, n)) return (false);
+    for (uint64_t j = 0; j < n; j++) {
+        string   name;
+        uint64_t len;
+        if (!SerialUtils::ReadString(i, name) || !SerialUtils::ReadU64(i, len)) return (false);
+        if (len > (1ULL << 27)) return (false);    // Corrupt
+
+        vector<double> values(len);
+        if (len) i.read((char *)values.data(), len * sizeof(double));
+        if (!i) return (false);
+        flt_atts.push_back(make_pair(name, values));
+    }
+
+    if (!SerialUtils::ReadU64(i, n)) return (false);
+    for (uint64_t j = 0; j < n; j++) {
+        string   name;
+        uint64_t len;
+        if (!SerialUtils::ReadString(i, name) || !SerialUtils::ReadU64(i, len)) return (false);
+        if (len > (1ULL << 27)) return (false);    // Corrupt
+
+        vector<long> values;
+        for (uint64_t k = 0; k < len; k++) {
+            uint64_t v;
+            if (!SerialUtils::ReadU64(i, v)) return (false);
+            values.push_back((long)(int64_t)v);
+        }
+        int_atts.push_back(make_pair(name, values));
+    }
+
+    if (!SerialUtils::ReadU64(i, n)) return (false);
+    for (uint64_t j = 0; j < n; j++) {
+        string name, value;
+        if (!SerialUtils::ReadString(i, name) || !SerialUtils::ReadString(i, value)) return (false);
+        str_atts.push_back(make_pair(name, value));
+    }
+    return (true);
+}
+
+};    // namespace
+
 NetCDFSimple::NetCDFSimple()
 {
     _ncid = -1;
@@ -138,6 +217,85 @@ int NetCDFSimple::Initialize(string path)
     return (0);
 }
 
+int NetCDFSimple::WriteMetadata(std::ostream &o) const
+{
+    SerialUtils::WriteU64(o, metadataMagic);
+
+    SerialUtils::WriteStrings(o, _dimnames);
+    SerialUtils::WriteU64(o, _dims.size());
+    for (size_t i = 0; i < _dims.size(); i++) SerialUtils::WriteU64(o, _dims[i]);
+    SerialUtils::WriteStrings(o, _unlimited_dimnames);
+
+    write_atts(o, _flt_atts, _int_atts, _str_atts);
+
+    SerialUtils::WriteU64(o, _variables.size());
+    for (size_t i = 0; i < _variables.size(); i++) {
+        const Variable &var = _variables[i];
+
+        SerialUtils::WriteString(o, var._name);
+        SerialUtils::WriteStrings(o, var._dimnames);
+        SerialUtils::WriteU64(o, (uint64_t)(int64_t)var._type);
+        write_atts(o, var._flt_atts, var._int_atts, var._str_atts);
+    }
+
+    if (!o) {
+        SetErrMsg("Failed to write metadata for %s", _path.c_str());
+        return (-1);
+    }
+    return (0);
+}
+
+int NetCDFSimple::ReadMetadata(std::istream &i, string path)
+{
+    _dimnames.clear();
+    _dims.clear();
+    _unlimited_dimnames.clear();
+    _flt_atts.clear();
+    _int_atts.clear();
+    _str_atts.clear();
+    _variables.clear();
+    _path = path;
+
+    uint64_t magic, n;
+    bool     ok = SerialUtils::ReadU64(i, magic) && magic == metadataMagic;
+
+    ok = ok && SerialUtils::ReadStrings(i, _dimnames);
+    ok = ok && SerialUtils::ReadU64(i, n) && n == _dimnames.size();
+    for (uint64_t j = 0; ok && j < n; j++) {
+        uint64_t len;
+        ok = SerialUtils::ReadU64(i, len);
+        _dims.push_back(len);
+    }
+    ok = ok && SerialUtils::ReadStrings(i, _unlimited_dimnames);
+
+    ok = ok && read_atts(i, _flt_atts, _int_atts, _str_atts);
+
+    ok = ok && SerialUtils::ReadU64(i, n);
+    for (uint64_t j = 0; ok && j < n; j++) {
+        Variable var;
+        uint64_t type;
+
+        ok = SerialUtils::ReadString(i, var._name) && SerialUtils::ReadStrings(i, var._dimnames) && SerialUtils::ReadU64(i, type);
+        ok = ok && read_atts(i, var._flt_atts, var._int_atts, var._str_atts);
+        var._type = (int)(int64_t)type;
+
+        if (ok) _variables.push_back(var);
+    }
+
+    if (!ok) {
+        _dimnames.clear();
+        _dims.clear();
+        _unlimited_dimnames.clear();
+        _flt_atts.clear();
+        _int_atts.clear();
+        _str_atts.clear();
+        _variables.clear();
+        SetErrMsg("Invalid metadata for %s", path.c_str());
+        return (-1);
+    }
+    return (0);
+}
+
 int NetCDFSimple::OpenRead(const NetCDFSimple::Variable &variable)
 {
     //
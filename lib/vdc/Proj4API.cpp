@@ -1,6 +1,9 @@
 #define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H 1
 
 #include <iostream>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include <proj_api.h>
 #include <vapor/ResourcePath.h>
 #include <vapor/Proj4API.h>
@@ -8,6 +11,105 @@
 using namespace VAPoR;
 using namespace Wasp;
 
+namespace {
+
+// Transform geographic coordinates in degrees, rather than radians.
+// Returns the pj_transform() status.
+//
+int transform_degrees(projPJ pjSrc, projPJ pjDst, double *x, double *y, double *z, size_t n, int offset)
+{
+    //
+    // Convert from degrees to radians if source is in
+    // geographic coordinates
+    //
+    if (pj_is_latlong(pjSrc)) {
+        if (x) {
+            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+        if (y) {
+            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+        if (z) {
+            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+    }
+
+    int rc = pj_transform(pjSrc, pjDst, n, offset, x, y, NULL);
+    if (rc != 0) return (rc);
+
+    //
+    // Convert from radians degrees if destination is in
+    // geographic coordinates
+    //
+    if (pj_is_latlong(pjDst)) {
+        if (x) {
+            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+        if (y) {
+            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+        if (z) {
+            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+    }
+    return (0);
+}
+
+// Single precision version of the above. proj4 only works in double
+// precision.
+//
+int transform_degrees(projPJ pjSrc, projPJ pjDst, float *x, float *y, float *z, size_t n, int offset)
+{
+    std::vector<double> xd, yd, zd;
+
+    if (x) {
+        xd.resize(n);
+        for (size_t i = 0; i < n; i++) xd[i] = x[i * offset];
+    }
+    if (y) {
+        yd.resize(n);
+        for (size_t i = 0; i < n; i++) yd[i] = y[i * offset];
+    }
+    if (z) {
+        zd.resize(n);
+        for (size_t i = 0; i < n; i++) zd[i] = z[i * offset];
+    }
+
+    int rc = transform_degrees(pjSrc, pjDst, x ? xd.data() : NULL, y ? yd.data() : NULL, z ? zd.data() : NULL, n, 1);
+
+    if (x) {
+        for (size_t i = 0; i < n; i++) x[i * offset] = xd[i];
+    }
+    if (y) {
+        for (size_t i = 0; i < n; i++) y[i * offset] = yd[i];
+    }
+    if (z) {
+        for (size_t i = 0; i < n; i++) z[i * offset] = zd[i];
+    }
+    return (rc);
+}
+
+// Definition string of a projection
+//
+string get_def(projPJ pj)
+{
+    char * def = pj_get_def(pj, 0);
+    string s = def ? def : "";
+    if (def) pj_dalloc(def);
+    return (s);
+}
+
+// Message for a proj4 error number. pj_strerrno() returns NULL for
+// numbers it doesn't know, including 0 when a failure left no error set.
+//
+string err_str(int err)
+{
+    const char *msg = pj_strerrno(err);
+    return (msg ? msg : "unknown proj4 error");
+}
+
+};    // namespace
+
 Proj4API::Proj4API()
 {
     _pjSrc = NULL;
@@ -116,14 +218,14 @@ string Proj4API::GetSrcStr() const
 {
     if (!_pjSrc) return ("");
 
-    return ((string)pj_get_def(_pjSrc, 0));
+    return (get_def(_pjSrc));
 }
 
 string Proj4API::GetDstStr() const
 {
     if (!_pjDst) return ("");
 
-    return ((string)pj_get_def(_pjDst, 0));
+    return (get_def(_pjDst));
 }
 
 int Proj4API::Transform(double *x, double *y, size_t n, int offset) const { return (Proj4API::Transform(x, y, NULL, n, offset)); }
@@ -134,43 +236,11 @@ int Proj4API::_Transform(void *pjSrc, void *pjDst, double *x, double *y, double
     //
     if (pjSrc == NULL || pjDst == NULL) return (0);
 
-    //
-    // Convert from degrees to radians if source is in
-    // geographic coordinates
-    //
-    if (pj_is_latlong(pjSrc)) {
-        if (x) {
-            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= DEG_TO_RAD; }
-        }
-        if (y) {
-            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= DEG_TO_RAD; }
-        }
-        if (z) {
-            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= DEG_TO_RAD; }
-        }
-    }
-
-    int rc = pj_transform(pjSrc, pjDst, n, offset, x, y, NULL);
+    int rc = transform_degrees(pjSrc, pjDst, x, y, z, n, offset);
     if (rc != 0) {
         SetErrMsg("pj_transform() : %s", ProjErr().c_str());
         return (-1);
     }
-
-    //
-    // Convert from radians degrees if destination is in
-    // geographic coordinates
-    //
-    if (pj_is_latlong(pjDst)) {
-        if (x) {
-            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= RAD_TO_DEG; }
-        }
-        if (y) {
-            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= RAD_TO_DEG; }
-        }
-        if (z) {
-            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= RAD_TO_DEG; }
-        }
-    }
     return (0);
 }
 
@@ -180,42 +250,77 @@ int Proj4API::Transform(float *x, float *y, size_t n, int offset) const { return
 
 int Proj4API::_Transform(void *pjSrc, void *pjDst, float *x, float *y, float *z, size_t n, int offset) const
 {
-    double *xd = NULL;
-    double *yd = NULL;
-    double *zd = NULL;
+    // no-op
+    //
+    if (pjSrc == NULL || pjDst == NULL) return (0);
 
-    if (x) {
-        xd = new double[n];
-        for (size_t i = 0; i < n; i++) xd[i] = x[i * offset];
-    }
-    if (y) {
-        yd = new double[n];
-        for (size_t i = 0; i < n; i++) yd[i] = y[i * offset];
-    }
-    if (z) {
-        zd = new double[n];
-        for (size_t i = 0; i < n; i++) zd[i] = z[i * offset];
+    int rc = transform_degrees(pjSrc, pjDst, x, y, z, n, offset);
+    if (rc != 0) {
+        SetErrMsg("pj_transform() : %s", ProjErr().c_str());
+        return (-1);
     }
+    return (0);
+}
 
-    int rc = _Transform(pjSrc, pjDst, xd, yd, zd, n, 1);
+int Proj4API::Transform(float *x, float *y, float *z, size_t n, int offset) const { return (Proj4API::_Transform(_pjSrc, _pjDst, x, y, z, n, offset)); }
 
-    if (xd) {
-        for (size_t i = 0; i < n; i++) x[i * offset] = xd[i];
-        delete[] xd;
-    }
-    if (yd) {
-        for (size_t i = 0; i < n; i++) y[i * offset] = yd[i];
-        delete[] yd;
-    }
-    if (zd) {
-        for (size_t i = 0; i < n; i++) z[i * offset] = zd[i];
-        delete[] zd;
+int Proj4API::TransformParallel(float *x, float *y, size_t n, int nthreads) const
+{
+    // no-op
+    //
+    if (_pjSrc == NULL || _pjDst == NULL) return (0);
+
+    if (nthreads < 1) nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Each thread initializes its own projections, which isn't worth
+    // doing for a few points
+    //
+    const size_t minChunk = 16384;
+    size_t       nchunks = std::min((size_t)nthreads, n / minChunk);
+    if (nchunks < 2) return (Transform(x, y, n));
+
+    string srcdef = GetSrcStr();
+    string dstdef = GetDstStr();
+    size_t chunk = (n + nchunks - 1) / nchunks;
+
+    // proj4 keeps its error state in a context, so every thread gets its
+    // own. Errors are reported once the threads are done.
+    //
+    vector<int>    status(nchunks, 0);
+    vector<string> errs(nchunks);
+    auto           worker = [&](size_t id) {
+        size_t  start = id * chunk;
+        size_t  count = std::min(chunk, n - start);
+        projCtx ctx = pj_ctx_alloc();
+        projPJ  pjSrc = pj_init_plus_ctx(ctx, srcdef.c_str());
+        projPJ  pjDst = pj_init_plus_ctx(ctx, dstdef.c_str());
+
+        if (pjSrc && pjDst) {
+            status[id] = transform_degrees(pjSrc, pjDst, x + start, y + start, NULL, count, 1);
+        } else {
+            status[id] = -1;
+        }
+        if (status[id] != 0) errs[id] = err_str(pj_ctx_get_errno(ctx));
+
+        if (pjSrc) pj_free(pjSrc);
+        if (pjDst) pj_free(pjDst);
+        pj_ctx_free(ctx);
+    };
+
+    vector<std::thread> threads;
+    for (size_t id = 1; id < nchunks; id++) threads.push_back(std::thread(worker, id));
+    worker(0);
+    for (auto &t : threads) t.join();
+
+    for (size_t id = 0; id < nchunks; id++) {
+        if (status[id] != 0) {
+            SetErrMsg("pj_transform() : %s", errs[id].c_str());
+            return (-1);
+        }
     }
-    return (rc);
+    return (0);
 }
 
-int Proj4API::Transform(float *x, float *y, float *z, size_t n, int offset) const { return (Proj4API::_Transform(_pjSrc, _pjDst, x, y, z, n, offset)); }
-
 int Proj4API::Transform(string srcdef, string dstdef, double *x, double *y, double *z, size_t n, int offset) const
 {
     void *pjSrc = NULL;
@@ -242,7 +347,7 @@ int Proj4API::Transform(string srcdef, string dstdef, float *x, float *y, float
     return (0);
 }
 
-string Proj4API::ProjErr() const { return (pj_strerrno(*pj_get_errno_ref())); }
+string Proj4API::ProjErr() const { return (err_str(*pj_get_errno_ref())); }
 
 void Proj4API::Clamp(double *x, double *y, size_t n, int offset) const
 {
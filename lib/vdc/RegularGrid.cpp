@@ -2,6 +2,7 @@
 #include <vector>
 #include "vapor/VAssert.h"
 #include <cmath>
+#include <algorithm>
 #include <time.h>
 #ifdef Darwin
     #include <mach/mach_time.h>
@@ -12,12 +13,237 @@
     #include <limits>
 #endif
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define SAMPLING_X86
+    #include <immintrin.h>
+#endif
+
 #include <vapor/utils.h>
 #include "vapor/RegularGrid.h"
 
 using namespace std;
 using namespace VAPoR;
 
+namespace {
+
+// Number of points GetValues() processes at a time
+//
+const size_t samplingChunk = 256;
+
+// Cell index and weight kernels, along one axis:
+//
+//   idx[i] = floor((c[i] - min) / delta)
+//   wgt[i] = ((c[i] - min) - idx[i] * delta) / delta
+//
+// and outside[i] is set if c[i] is not within [min, max]. The arithmetic
+// is that of RegularGrid::GetValueLinear(). Multiply and add are kept
+// separate (no fused multiply-add) so that every kernel rounds the same
+// way. idx and wgt are only meaningful for points inside.
+//
+void cell_weights_scalar(const double *c, size_t n, double min, double max, double delta, double *idx, double *wgt, unsigned char *outside)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (!(c[i] >= min && c[i] <= max)) outside[i] = 1;
+        idx[i] = floor((c[i] - min) / delta);
+        wgt[i] = ((c[i] - min) - (idx[i] * delta)) / delta;
+    }
+}
+
+// Trilinear interpolation kernels: the same arithmetic as
+// Grid::TrilinearInterp(), for n points whose eight node values are in
+// v[0..7], ordered as by Grid::GetCellNodeValues()
+//
+void trilinear_scalar(const float *const v[8], const double *const wgt[3], size_t n, float mv, float *values)
+{
+    for (size_t i = 0; i < n; i++) {
+        double w[] = {wgt[0][i], wgt[1][i], wgt[2][i]};
+        double p[8];
+        bool   missing = false;
+        for (int k = 0; k < 8; k++) {
+            bool used = (!(k & 1) || w[0] != 0.0) && (!(k & 2) || w[1] != 0.0) && (!(k & 4) || w[2] != 0.0);
+            p[k] = used ? v[k][i] : 0.0;
+            if (used && v[k][i] == mv) missing = true;
+        }
+
+        double c0 = p[0] + w[0] * (p[1] - p[0]) + w[1] * ((p[2] + w[0] * (p[3] - p[2])) - (p[0] + w[0] * (p[1] - p[0])));
+        double c1 = p[4] + w[0] * (p[5] - p[4]) + w[1] * ((p[6] + w[0] * (p[7] - p[6])) - (p[4] + w[0] * (p[5] - p[4])));
+        values[i] = missing ? mv : (float)(c0 + w[2] * (c1 - c0));
+    }
+}
+
+#ifdef SAMPLING_X86
+
+// The points inside the grid are at non-negative offsets from min, where
+// truncation and floor agree. SSE2 has no floor instruction.
+//
+void cell_weights_sse2(const double *c, size_t n, double min, double max, double delta, double *idx, double *wgt, unsigned char *outside)
+{
+    __m128d vmin = _mm_set1_pd(min);
+    __m128d vmax = _mm_set1_pd(max);
+    __m128d vdelta = _mm_set1_pd(delta);
+    size_t  i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d vc = _mm_loadu_pd(c + i);
+        int     inside = _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(vc, vmin), _mm_cmple_pd(vc, vmax)));
+        if (!(inside & 1)) outside[i] = 1;
+        if (!(inside & 2)) outside[i + 1] = 1;
+
+        __m128d off = _mm_sub_pd(vc, vmin);
+        __m128d vidx = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_div_pd(off, vdelta)));
+        _mm_storeu_pd(idx + i, vidx);
+        _mm_storeu_pd(wgt + i, _mm_div_pd(_mm_sub_pd(off, _mm_mul_pd(vidx, vdelta)), vdelta));
+    }
+    cell_weights_scalar(c + i, n - i, min, max, delta, idx + i, wgt + i, outside + i);
+}
+
+void trilinear_sse2(const float *const v[8], const double *const wgt[3], size_t n, float mv, float *values)
+{
+    __m128d vmv = _mm_set1_pd(mv);
+    __m128d zero = _mm_setzero_pd();
+    size_t  i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d w[3], used[3];
+        for (int a = 0; a < 3; a++) {
+            w[a] = _mm_loadu_pd(wgt[a] + i);
+            used[a] = _mm_cmpneq_pd(w[a], zero);
+        }
+
+        // Nodes with a zero weight are neither tested nor used
+        //
+        __m128d p[8];
+        __m128d missing = zero;
+        for (int k = 0; k < 8; k++) {
+            __m128d u = _mm_castsi128_pd(_mm_set1_epi32(-1));
+            if (k & 1) u = _mm_and_pd(u, used[0]);
+            if (k & 2) u = _mm_and_pd(u, used[1]);
+            if (k & 4) u = _mm_and_pd(u, used[2]);
+
+            p[k] = _mm_cvtps_pd(_mm_setr_ps(v[k][i], v[k][i + 1], 0.0f, 0.0f));
+            missing = _mm_or_pd(missing, _mm_and_pd(u, _mm_cmpeq_pd(p[k], vmv)));
+            p[k] = _mm_and_pd(u, p[k]);
+        }
+
+        __m128d a0 = _mm_add_pd(p[0], _mm_mul_pd(w[0], _mm_sub_pd(p[1], p[0])));
+        __m128d a1 = _mm_add_pd(p[2], _mm_mul_pd(w[0], _mm_sub_pd(p[3], p[2])));
+        __m128d c0 = _mm_add_pd(a0, _mm_mul_pd(w[1], _mm_sub_pd(a1, a0)));
+        __m128d b0 = _mm_add_pd(p[4], _mm_mul_pd(w[0], _mm_sub_pd(p[5], p[4])));
+        __m128d b1 = _mm_add_pd(p[6], _mm_mul_pd(w[0], _mm_sub_pd(p[7], p[6])));
+        __m128d c1 = _mm_add_pd(b0, _mm_mul_pd(w[1], _mm_sub_pd(b1, b0)));
+        __m128d r = _mm_add_pd(c0, _mm_mul_pd(w[2], _mm_sub_pd(c1, c0)));
+        r = _mm_or_pd(_mm_and_pd(missing, vmv), _mm_andnot_pd(missing, r));
+
+        _mm_storel_pi((__m64 *)(values + i), _mm_cvtpd_ps(r));
+    }
+    const float *const  vt[8] = {v[0] + i, v[1] + i, v[2] + i, v[3] + i, v[4] + i, v[5] + i, v[6] + i, v[7] + i};
+    const double *const wt[3] = {wgt[0] + i, wgt[1] + i, wgt[2] + i};
+    trilinear_scalar(vt, wt, n - i, mv, values + i);
+}
+
+__attribute__((target("avx2"))) void cell_weights_avx2(const double *c, size_t n, double min, double max, double delta, double *idx, double *wgt, unsigned char *outside)
+{
+    __m256d vmin = _mm256_set1_pd(min);
+    __m256d vmax = _mm256_set1_pd(max);
+    __m256d vdelta = _mm256_set1_pd(delta);
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d vc = _mm256_loadu_pd(c + i);
+        int     inside = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(vc, vmin, _CMP_GE_OQ), _mm256_cmp_pd(vc, vmax, _CMP_LE_OQ)));
+        for (int l = 0; l < 4; l++) {
+            if (!(inside & (1 << l))) outside[i + l] = 1;
+        }
+
+        __m256d off = _mm256_sub_pd(vc, vmin);
+        __m256d vidx = _mm256_floor_pd(_mm256_div_pd(off, vdelta));
+        _mm256_storeu_pd(idx + i, vidx);
+        _mm256_storeu_pd(wgt + i, _mm256_div_pd(_mm256_sub_pd(off, _mm256_mul_pd(vidx, vdelta)), vdelta));
+    }
+    cell_weights_scalar(c + i, n - i, min, max, delta, idx + i, wgt + i, outside + i);
+}
+
+__attribute__((target("avx2"))) void trilinear_avx2(const float *const v[8], const double *const wgt[3], size_t n, float mv, float *values)
+{
+    __m256d vmv = _mm256_set1_pd(mv);
+    __m256d zero = _mm256_setzero_pd();
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d w[3], used[3];
+        for (int a = 0; a < 3; a++) {
+            w[a] = _mm256_loadu_pd(wgt[a] + i);
+            used[a] = _mm256_cmp_pd(w[a], zero, _CMP_NEQ_UQ);
+        }
+
+        // Nodes with a zero weight are neither tested nor used
+        //
+        __m256d p[8];
+        __m256d missing = zero;
+        for (int k = 0; k < 8; k++) {
+            __m256d u = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            if (k & 1) u = _mm256_and_pd(u, used[0]);
+            if (k & 2) u = _mm256_and_pd(u, used[1]);
+            if (k & 4) u = _mm256_and_pd(u, used[2]);
+
+            p[k] = _mm256_cvtps_pd(_mm_loadu_ps(v[k] + i));
+            missing = _mm256_or_pd(missing, _mm256_and_pd(u, _mm256_cmp_pd(p[k], vmv, _CMP_EQ_OQ)));
+            p[k] = _mm256_and_pd(u, p[k]);
+        }
+
+        __m256d a0 = _mm256_add_pd(p[0], _mm256_mul_pd(w[0], _mm256_sub_pd(p[1], p[0])));
+        __m256d a1 = _mm256_add_pd(p[2], _mm256_mul_pd(w[0], _mm256_sub_pd(p[3], p[2])));
+        __m256d c0 = _mm256_add_pd(a0, _mm256_mul_pd(w[1], _mm256_sub_pd(a1, a0)));
+        __m256d b0 = _mm256_add_pd(p[4], _mm256_mul_pd(w[0], _mm256_sub_pd(p[5], p[4])));
+        __m256d b1 = _mm256_add_pd(p[6], _mm256_mul_pd(w[0], _mm256_sub_pd(p[7], p[6])));
+        __m256d c1 = _mm256_add_pd(b0, _mm256_mul_pd(w[1], _mm256_sub_pd(b1, b0)));
+        __m256d r = _mm256_add_pd(c0, _mm256_mul_pd(w[2], _mm256_sub_pd(c1, c0)));
+        r = _mm256_blendv_pd(r, vmv, missing);
+
+        _mm_storeu_ps(values + i, _mm256_cvtpd_ps(r));
+    }
+    const float *const  vt[8] = {v[0] + i, v[1] + i, v[2] + i, v[3] + i, v[4] + i, v[5] + i, v[6] + i, v[7] + i};
+    const double *const wt[3] = {wgt[0] + i, wgt[1] + i, wgt[2] + i};
+    trilinear_scalar(vt, wt, n - i, mv, values + i);
+}
+
+#endif
+
+// Kernels selected once for the instruction sets the processor supports
+//
+class sampling_kernels {
+public:
+    sampling_kernels()
+    {
+        name = "scalar";
+        weights = cell_weights_scalar;
+        trilinear = trilinear_scalar;
+
+#ifdef SAMPLING_X86
+        // SSE2 is part of x86-64
+        //
+        name = "sse2";
+        weights = cell_weights_sse2;
+        trilinear = trilinear_sse2;
+
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            name = "avx2";
+            weights = cell_weights_avx2;
+            trilinear = trilinear_avx2;
+        }
+#endif
+    }
+
+    string name;
+    void (*weights)(const double *, size_t, double, double, double, double *, double *, unsigned char *);
+    void (*trilinear)(const float *const[8], const double *const[3], size_t, float, float *);
+};
+
+const sampling_kernels &get_sampling_kernels()
+{
+    static sampling_kernels kernels;
+    return (kernels);
+}
+
+};    // namespace
+
 void RegularGrid::_SetExtents(const vector<double> &minu, const vector<double> &maxu)
 {
     VAssert(minu.size() == maxu.size());
@@ -200,6 +426,13 @@ void RegularGrid::GetUserExtentsHelper(DblArr3 &minu, DblArr3 &maxu) const
     maxu = _maxu;
 }
 
+void RegularGrid::ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    // Coordinates along each axis only depend on the index along that axis
+    //
+    ForEachBlockInSeparableBox(minu, maxu, ncoords, visitor, part, nparts);
+}
+
 void RegularGrid::GetBoundingBox(const Size_tArr3 &min, const Size_tArr3 &max, DblArr3 &minu, DblArr3 &maxu) const
 {
     Size_tArr3 cMin;
@@ -230,6 +463,86 @@ void RegularGrid::GetUserCoordinates(const Size_tArr3 &indices, DblArr3 &coords)
     }
 }
 
+void RegularGrid::GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const
+{
+    float missingValue = GetMissingValue();
+    if (!GetBlks().size()) {
+        std::fill(values, values + n, missingValue);
+        return;
+    }
+
+    const vector<bool> &periodic = GetPeriodic();
+    bool                clamp = std::any_of(periodic.begin(), periodic.end(), [](bool v) { return (v); });
+    size_t              ndim = GetGeometryDim();
+    bool                linear = GetInterpolationOrder() != 0;
+
+    const sampling_kernels &kernels = get_sampling_kernels();
+
+    // Points are processed a chunk at a time: cell indices and weights,
+    // then a scalar gather of the node values, then the interpolation.
+    // Indices, weights and node values are kept one array per axis or
+    // node, so the kernels operate on consecutive points.
+    //
+    vector<double>        buf(9 * samplingChunk);
+    vector<float>         nodeBuf(8 * samplingChunk);
+    vector<unsigned char> outside(samplingChunk);
+    double *              cc[] = {&buf[0], &buf[samplingChunk], &buf[2 * samplingChunk]};
+    double *              idx[] = {&buf[3 * samplingChunk], &buf[4 * samplingChunk], &buf[5 * samplingChunk]};
+    double *              wgt[] = {&buf[6 * samplingChunk], &buf[7 * samplingChunk], &buf[8 * samplingChunk]};
+    float *               v[8];
+    for (int k = 0; k < 8; k++) v[k] = &nodeBuf[k * samplingChunk];
+
+    for (size_t p0 = 0; p0 < n; p0 += samplingChunk) {
+        size_t        m = std::min(samplingChunk, n - p0);
+        const double *coords[] = {x + p0, y + p0, z + p0};
+
+        if (clamp) {
+            for (size_t q = 0; q < m; q++) {
+                DblArr3 c = {x[p0 + q], y[p0 + q], ndim == 3 ? z[p0 + q] : 0.0};
+                DblArr3 cCoords;
+                ClampCoord(c, cCoords);
+                for (int a = 0; a < 3; a++) cc[a][q] = cCoords[a];
+            }
+            for (int a = 0; a < 3; a++) coords[a] = cc[a];
+        }
+
+        // Same index and weight arithmetic as GetValueLinear()
+        //
+        std::fill(outside.begin(), outside.begin() + m, 0);
+        for (int a = 0; a < 3; a++) {
+            if (a < ndim && _delta[a] != 0.0) {
+                kernels.weights(coords[a], m, _minu[a], _maxu[a], _delta[a], idx[a], wgt[a], outside.data());
+                continue;
+            }
+            if (a < ndim) {
+                for (size_t q = 0; q < m; q++) {
+                    if (!(coords[a][q] >= _minu[a] && coords[a][q] <= _maxu[a])) outside[q] = 1;
+                }
+            }
+            std::fill(idx[a], idx[a] + m, 0.0);
+            std::fill(wgt[a], wgt[a] + m, 0.0);
+        }
+
+        for (size_t q = 0; q < m; q++) {
+            float nodes[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            if (!outside[q]) GetCellNodeValues((size_t)idx[0][q], (size_t)idx[1][q], (size_t)idx[2][q], nodes);
+            for (int k = 0; k < 8; k++) v[k][q] = nodes[k];
+        }
+
+        if (linear) {
+            kernels.trilinear(v, wgt, m, missingValue, values + p0);
+        } else {
+            for (size_t q = 0; q < m; q++) values[p0 + q] = v[(wgt[0][q] > 0.5) + 2 * (wgt[1][q] > 0.5) + 4 * (wgt[2][q] > 0.5)][q];
+        }
+
+        for (size_t q = 0; q < m; q++) {
+            if (outside[q]) values[p0 + q] = missingValue;
+        }
+    }
+}
+
+string RegularGrid::SamplingKernels() { return (get_sampling_kernels().name); }
+
 bool RegularGrid::GetIndicesCell(const DblArr3 &coords, Size_tArr3 &indices) const
 {
     DblArr3 cCoords;
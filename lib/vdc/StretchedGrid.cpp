@@ -3,6 +3,7 @@
 #include "vapor/VAssert.h"
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 #include <vapor/utils.h>
 #include <vapor/StretchedGrid.h>
 #include <vapor/KDTreeRG.h>
@@ -307,6 +308,85 @@ float StretchedGrid::GetValueLinear(const DblArr3 &coords) const
     return (v0 * zwgt[0] + v1 * zwgt[1]);
 }
 
+namespace {
+
+// Find the interval of 'sorted' containing 'x', as Wasp::BinarySearchRange()
+// does, but first try the interval 'i' found for the previous point
+//
+bool searchRange(const vector<double> &sorted, double x, size_t &i)
+{
+    if (i + 1 < sorted.size()) {
+        double x0 = sorted[i];
+        double x1 = sorted[i + 1];
+        if ((x0 <= x && x < x1) || (x0 >= x && x > x1)) return (true);
+    }
+    return (Wasp::BinarySearchRange(sorted, x, i));
+}
+
+};    // namespace
+
+void StretchedGrid::GetValues(size_t n, const double *x, const double *y, const double *z, float *values) const
+{
+    float missingValue = GetMissingValue();
+    if (!GetBlks().size()) {
+        std::fill(values, values + n, missingValue);
+        return;
+    }
+
+    const vector<bool> &periodic = GetPeriodic();
+    bool                clamp = std::any_of(periodic.begin(), periodic.end(), [](bool v) { return (v); });
+    bool                is3D = GetGeometryDim() == 3;
+    bool                linear = GetInterpolationOrder() != 0;
+
+    size_t i = 0, j = 0, k = 0;
+    for (size_t p = 0; p < n; p++) {
+        DblArr3 coords = {x[p], y[p], is3D ? z[p] : 0.0};
+        if (clamp) {
+            DblArr3 cCoords;
+            ClampCoord(coords, cCoords);
+            coords = cCoords;
+        }
+
+        // Same weights as _insideGrid(). Nearby points usually fall in the
+        // intervals of the previous point.
+        //
+        bool inside = searchRange(_xcoords, coords[0], i) && searchRange(_ycoords, coords[1], j);
+        if (inside && is3D) inside = searchRange(_zcoords, coords[2], k);
+        if (!inside) {
+            values[p] = missingValue;
+            continue;
+        }
+
+        double xwgt[2], ywgt[2], zwgt[2] = {1.0, 0.0};
+        xwgt[0] = 1.0 - (coords[0] - _xcoords[i]) / (_xcoords[i + 1] - _xcoords[i]);
+        xwgt[1] = 1.0 - xwgt[0];
+        ywgt[0] = 1.0 - (coords[1] - _ycoords[j]) / (_ycoords[j + 1] - _ycoords[j]);
+        ywgt[1] = 1.0 - ywgt[0];
+        if (is3D) {
+            zwgt[0] = 1.0 - (coords[2] - _zcoords[k]) / (_zcoords[k + 1] - _zcoords[k]);
+            zwgt[1] = 1.0 - zwgt[0];
+        }
+
+        float v[8];
+        GetCellNodeValues(i, j, is3D ? k : 0, v);
+
+        if (!linear) {
+            values[p] = v[(xwgt[1] > xwgt[0]) + 2 * (ywgt[1] > ywgt[0]) + 4 * (zwgt[1] > zwgt[0])];
+            continue;
+        }
+
+        // Same arithmetic as GetValueLinear()
+        //
+        float v0 = ((v[0] * xwgt[0] + v[1] * xwgt[1]) * ywgt[0]) + ((v[2] * xwgt[0] + v[3] * xwgt[1]) * ywgt[1]);
+        if (!is3D) {
+            values[p] = v0;
+            continue;
+        }
+        float v1 = ((v[4] * xwgt[0] + v[5] * xwgt[1]) * ywgt[0]) + ((v[6] * xwgt[0] + v[7] * xwgt[1]) * ywgt[1]);
+        values[p] = v0 * zwgt[0] + v1 * zwgt[1];
+    }
+}
+
 void StretchedGrid::GetUserExtentsHelper(DblArr3 &minext, DblArr3 &maxext) const
 {
     vector<size_t> dims = StructuredGrid::GetDimensions();
@@ -325,6 +405,13 @@ void StretchedGrid::GetUserExtentsHelper(DblArr3 &minext, DblArr3 &maxext) const
     }
 }
 
+void StretchedGrid::ForEachBlockInBoxHelper(const DblArr3 &minu, const DblArr3 &maxu, size_t ncoords, const SpanVisitor &visitor, size_t part, size_t nparts) const
+{
+    // Coordinates along each axis only depend on the index along that axis
+    //
+    ForEachBlockInSeparableBox(minu, maxu, ncoords, visitor, part, nparts);
+}
+
 // Search for a point inside the grid. If the point is inside return true,
 // and provide the weights/coordinates for the point within
 // the XYZ cell containing the point
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include "vapor/VAssert.h"
 #include <cmath>
 #include <time.h>
@@ -290,3 +291,35 @@ std::ostream &operator<<(std::ostream &o, const StructuredGrid &sg)
     return o;
 }
 };    // namespace VAPoR
+
+// Since Z is monotonic along each column of nodes, the Z range of a
+// column of cells is given by the corners of its bottom and top cells
+//
+void StructuredGrid::MakeColumnBounds(const Grid &zcoords, std::vector<float> &bounds)
+{
+    bounds.clear();
+
+    const vector<size_t> &dims = zcoords.GetDimensions();
+    if (dims.size() != 3 || dims[0] < 2 || dims[1] < 2) return;
+
+    size_t nz = dims[2];
+    bounds.resize(2 * (dims[0] - 1) * (dims[1] - 1));
+
+    size_t c = 0;
+    for (size_t j = 0; j < dims[1] - 1; j++) {
+        for (size_t i = 0; i < dims[0] - 1; i++) {
+            float lo = std::numeric_limits<float>::max();
+            float hi = std::numeric_limits<float>::lowest();
+            for (size_t jj = j; jj <= j + 1; jj++) {
+                for (size_t ii = i; ii <= i + 1; ii++) {
+                    float z0 = zcoords.AccessIJK(ii, jj, 0);
+                    float z1 = zcoords.AccessIJK(ii, jj, nz - 1);
+                    lo = std::min(lo, std::min(z0, z1));
+                    hi = std::max(hi, std::max(z0, z1));
+                }
+            }
+            bounds[c++] = lo;
+            bounds[c++] = hi;
+        }
+    }
+}
@@ -415,6 +415,14 @@ std::shared_ptr<QuadTreeRectangle<float, size_t>> UnstructuredGrid2D::_makeQuadT
 
     std::shared_ptr<QuadTreeRectangle<float, size_t>> qtr = std::make_shared<QuadTreeRectangle<float, size_t>>((float)minu[0], (float)minu[1], (float)maxu[0], (float)maxu[1], 12, reserve_size);
 
+    // Find the bounding rectangles of all the cells, and then insert
+    // them into the tree at once
+    //
+    vector<float>  rects;
+    vector<size_t> payloads;
+    rects.reserve(4 * dims[0]);
+    payloads.reserve(dims[0]);
+
     DblArr3                 coords;
     Grid::ConstCellIterator it = ConstCellBegin();
     Grid::ConstCellIterator end = ConstCellEnd();
@@ -436,8 +444,10 @@ std::shared_ptr<QuadTreeRectangle<float, size_t>> UnstructuredGrid2D::_makeQuadT
             if (coords[1] < top) top = coords[1];
             if (coords[1] > bottom) bottom = coords[1];
         }
-        qtr->Insert(left, top, right, bottom, cell[0]);
+        rects.insert(rects.end(), {left, top, right, bottom});
+        payloads.push_back(cell[0]);
     }
+    qtr->Insert(rects, payloads);
 
     return (qtr);
 }
@@ -0,0 +1,765 @@
+#include <cstdio>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <map>
+#include <set>
+#include <sstream>
+#include <algorithm>
+#ifndef WIN32
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/wait.h>
+#endif
+
+#include <vapor/CFuncs.h>
+#include <vapor/utils.h>
+#include <vapor/EasyThreads.h>
+#include <vapor/VAssert.h>
+#include <vapor/SerialUtils.h>
+#include <vapor/DC.h>
+#include <vapor/VDCNetCDF.h>
+#include <vapor/VDCConverter.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+using namespace std;
+
+namespace {
+
+// Each stage only starts once all items of the previous stage are done
+//
+enum { coordStage = 0, maskStage, dataStage, nStages };
+
+// The slab buffer of an item, its read buffer and the compression buffers
+// of WASP are roughly the same size
+//
+const size_t memFactor = 3;
+
+// One variable at one time step
+//
+class item {
+public:
+    int    stage;
+    string varname;    // Destination variable
+    string srcvar;     // Source variable. A mask is made from its data variable
+    string maskvar;    // Mask variable read when writing a data variable
+    size_t ts;
+    double mv;         // Missing value of srcvar, for masks
+    string key;        // Identifies the item in the checkpoint file
+    string path;       // File written
+};
+
+// Items written to the same file, in time step order
+//
+class group {
+public:
+    group() : stage(0), inMaster(false), mem(0) {}
+
+    int            stage;
+    bool           inMaster;
+    size_t         mem;
+    vector<size_t> items;
+};
+
+typedef VDCNetCDF::CopyStats itemStats;
+
+int copy_item(DC &dc, VDCNetCDF &vdc, const item &it, itemStats &st)
+{
+    if (it.stage == maskStage) {
+        // The mask may be shared with a data variable converted earlier
+        //
+        if (vdc.VariableExists(it.ts, it.varname, 0, -1)) return (0);
+
+        return (vdc.CopyMask(dc, it.ts, it.srcvar, it.varname, it.mv, -1, &st));
+    }
+    return (vdc.CopyVar(dc, it.ts, it.varname, -1, -1, &st));
+}
+
+// Flush a file written by an item to disk. An item is only recorded in
+// the checkpoint file once its data would survive a crash.
+//
+int sync_file(const string &path)
+{
+#ifndef WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0 || fsync(fd) < 0) {
+        MyBase::SetErrMsg("fsync(%s) : %M", path.c_str());
+        if (fd >= 0) ::close(fd);
+        return (-1);
+    }
+    ::close(fd);
+#endif
+    return (0);
+}
+
+// Append only record of the completed items
+//
+class journal {
+public:
+    journal() : _fp(NULL) {}
+    ~journal() { close(); }
+
+    // Open the file at path. Keys of completed items are returned in done
+    // if the file was written for the same signature
+    //
+    int open(string path, uint64_t signature, bool restart, set<string> &done)
+    {
+        done.clear();
+        _path = path;
+
+        char header[64];
+        snprintf(header, sizeof(header), "# VDCConverter %016llx\n", (unsigned long long)signature);
+
+        bool  resume = false;
+        FILE *fp = restart ? NULL : fopen(path.c_str(), "r");
+        if (fp) {
+            char   buf[4096];
+            string line;
+            if (fgets(buf, sizeof(buf), fp) && header == string(buf)) {
+                resume = true;
+                while (fgets(buf, sizeof(buf), fp)) {
+                    line += buf;
+                    if (line.empty() || line.back() != '\n') continue;
+
+                    line.pop_back();
+                    done.insert(line);
+                    line.clear();
+                }
+            } else {
+                MyBase::SetDiagMsg("Checkpoint file %s is for a different conversion", path.c_str());
+            }
+            fclose(fp);
+        }
+
+        _fp = fopen(path.c_str(), resume ? "a" : "w");
+        if (!_fp) {
+            MyBase::SetErrMsg("fopen(%s) : %M", path.c_str());
+            return (-1);
+        }
+        if (!resume) add(string(header, strlen(header) - 1));
+
+        return (0);
+    }
+
+    void add(const string &key)
+    {
+        if (!_fp) return;
+
+        fprintf(_fp, "%s\n", key.c_str());
+        fflush(_fp);
+#ifndef WIN32
+        (void)fsync(fileno(_fp));
+#endif
+    }
+
+    void close()
+    {
+        if (_fp) fclose(_fp);
+        _fp = NULL;
+    }
+
+    void remove()
+    {
+        close();
+        if (!_path.empty()) (void)::remove(_path.c_str());
+    }
+
+private:
+    FILE * _fp;
+    string _path;
+};
+
+#ifndef WIN32
+bool write_all(int fd, const string &s)
+{
+    const char *ptr = s.data();
+    size_t      n = s.size();
+    while (n) {
+        ssize_t rc = write(fd, ptr, n);
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc <= 0) return (false);
+        ptr += rc;
+        n -= rc;
+    }
+    return (true);
+}
+
+// Read from fd until buf holds a complete line, which is removed from
+// buf and returned in line
+//
+bool read_line(int fd, string &buf, string &line)
+{
+    size_t pos;
+    while ((pos = buf.find('\n')) == string::npos) {
+        char    tmp[4096];
+        ssize_t rc = read(fd, tmp, sizeof(tmp));
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc <= 0) return (false);
+        buf.append(tmp, rc);
+    }
+    line = buf.substr(0, pos);
+    buf.erase(0, pos + 1);
+    return (true);
+}
+
+// A worker process. Commands are lines of item indices, one line per
+// group. A line is returned for each item with its status and statistics,
+// followed by an empty line at the end of the group.
+//
+class worker {
+public:
+    worker() : pid(-1), cmd(-1), res(-1), busy(false), mem(0) {}
+
+    pid_t       pid;
+    int         cmd;        // Write end of the command pipe
+    int         res;        // Read end of the result pipe
+    string      buf;        // Partial result lines
+    bool        busy;
+    size_t      mem;
+    set<size_t> pending;    // Items sent but not yet reported
+};
+#endif
+
+class runner {
+public:
+    runner(const VDCConverter::DCFactory &factory, const VDCConverter::ProgressFunc &progress, string master, int nthreads, size_t chunksize, size_t maxMem, VDCConverter::Stats &stats)
+    : _factory(factory), _progress(progress), _master(master), _nthreads(nthreads), _chunksize(chunksize), _maxMem(maxMem), _stats(stats)
+    {
+    }
+
+    int plan(DC &dc, const vector<string> &coordvars, const vector<string> &datavars, int numts);
+
+    int run(DC &dc, int nworkers, string checkpoint, bool restart);
+
+private:
+    const VDCConverter::DCFactory &   _factory;
+    const VDCConverter::ProgressFunc &_progress;
+    string                            _master;
+    int                               _nthreads;
+    size_t                            _chunksize;
+    size_t                            _maxMem;
+    VDCConverter::Stats &             _stats;
+    vector<item>                      _items;
+    vector<group>                     _groups;
+    set<string>                       _done;
+    set<string>                       _failedMasks;
+    journal                           _journal;
+
+    void   _addItems(VDCNetCDF &vdc, DC &dc, int stage, string varname, string srcvar, size_t nts, map<string, size_t> &groupIndex);
+    bool   _select(const group &g, vector<size_t> &items);
+    void   _finish(size_t i, int rc, const itemStats &st);
+    int    _runLocal(DC &dc, const vector<size_t> &items, bool inMaster);
+    size_t _numTimeSteps(DC &dc, string varname, int numts) const;
+#ifndef WIN32
+    int  _spawn(vector<worker> &workers);
+    void _workerMain(int cmd, int res);
+    void _drop(worker &w);
+#endif
+};
+
+size_t runner::_numTimeSteps(DC &dc, string varname, int numts) const
+{
+    int nts = dc.GetNumTimeSteps(varname);
+    nts = numts >= 0 && nts > numts ? numts : nts;
+    return (nts < 0 ? 0 : nts);
+}
+
+void runner::_addItems(VDCNetCDF &vdc, DC &dc, int stage, string varname, string srcvar, size_t nts, map<string, size_t> &groupIndex)
+{
+    item it;
+    it.stage = stage;
+    it.varname = varname;
+    it.srcvar = srcvar;
+    it.mv = 0.0;
+
+    if (stage == maskStage) {
+        DC::DataVar varInfo;
+        (void)dc.GetDataVarInfo(srcvar, varInfo);
+        it.mv = varInfo.GetMissingValue();
+    } else if (stage == dataStage) {
+        DC::DataVar varInfo;
+        (void)vdc.GetDataVarInfo(varname, varInfo);
+        it.maskvar = varInfo.GetMaskvar();
+    }
+
+    // A copy buffers the least common multiple of the source and
+    // destination hyper-slices, which their product bounds
+    //
+    vector<size_t> src, dst;
+    size_t         nsrc, ndst;
+    if (dc.GetHyperSliceInfo(srcvar, -1, src, nsrc) < 0 || vdc.GetHyperSliceInfo(varname, -1, dst, ndst) < 0) {
+        MyBase::SetErrMsg("Failed to copy variable %s", varname.c_str());
+        _stats.nfailed += nts;
+        return;
+    }
+    size_t mem = memFactor * VProduct(src) * (dst.empty() ? 1 : dst.back()) * sizeof(float);
+
+    for (size_t ts = 0; ts < nts; ts++) {
+        string path;
+        size_t file_ts, max_ts;
+        if (vdc.GetPath(varname, ts, path, file_ts, max_ts) < 0) {
+            MyBase::SetErrMsg("Failed to copy variable %s", varname.c_str());
+            _stats.nfailed++;
+            continue;
+        }
+
+        it.ts = ts;
+        it.path = path;
+        ostringstream oss;
+        oss << stage << " " << ts << " " << varname;
+        it.key = oss.str();
+
+        string gkey = std::to_string(stage) + " " + path;
+        auto   gitr = groupIndex.find(gkey);
+        if (gitr == groupIndex.end()) {
+            gitr = groupIndex.insert(make_pair(gkey, _groups.size())).first;
+            _groups.push_back(group());
+            _groups.back().stage = stage;
+            _groups.back().inMaster = path == _master;
+        }
+        group &g = _groups[gitr->second];
+        g.mem = std::max(g.mem, mem);
+        g.items.push_back(_items.size());
+
+        _items.push_back(it);
+    }
+}
+
+int runner::plan(DC &dc, const vector<string> &coordvars, const vector<string> &datavars, int numts)
+{
+    VDCNetCDF vdc(_nthreads);
+    int       rc = vdc.Initialize(_master, vector<string>(), VDC::R, {}, _chunksize);
+    if (rc < 0) return (-1);
+
+    map<string, size_t> groupIndex;
+
+    for (size_t i = 0; i < coordvars.size(); i++) { _addItems(vdc, dc, coordStage, coordvars[i], coordvars[i], _numTimeSteps(dc, coordvars[i], numts), groupIndex); }
+
+    // A mask variable may be shared by several data variables. It is made
+    // from the first of them.
+    //
+    set<string> masks;
+    for (size_t i = 0; i < datavars.size(); i++) {
+        DC::DataVar varInfo;
+        if (!vdc.IsDataVar(datavars[i]) || !vdc.GetDataVarInfo(datavars[i], varInfo)) continue;
+
+        string maskvar = varInfo.GetMaskvar();
+        if (maskvar.empty() || masks.count(maskvar)) continue;
+
+        vector<size_t> dims;
+        size_t         nslice;
+        if (dc.GetHyperSliceInfo(datavars[i], -1, dims, nslice) < 0 || dims.size() < 2) continue;
+
+        masks.insert(maskvar);
+        _addItems(vdc, dc, maskStage, maskvar, datavars[i], _numTimeSteps(dc, datavars[i], numts), groupIndex);
+    }
+
+    for (size_t i = 0; i < datavars.size(); i++) { _addItems(vdc, dc, dataStage, datavars[i], datavars[i], _numTimeSteps(dc, datavars[i], numts), groupIndex); }
+
+    return (0);
+}
+
+// Return the items of a group still to be copied, failing the data items
+// whose mask could not be made
+//
+bool runner::_select(const group &g, vector<size_t> &items)
+{
+    items.clear();
+    for (size_t j = 0; j < g.items.size(); j++) {
+        const item &it = _items[g.items[j]];
+        if (_done.count(it.key)) continue;
+
+        if (!it.maskvar.empty()) {
+            ostringstream oss;
+            oss << it.ts << " " << it.maskvar;
+            if (_failedMasks.count(oss.str())) {
+                MyBase::SetErrMsg("Failed to copy variable %s", it.varname.c_str());
+                _finish(g.items[j], -1, itemStats());
+                continue;
+            }
+        }
+        items.push_back(g.items[j]);
+    }
+    return (!items.empty());
+}
+
+void runner::_finish(size_t i, int rc, const itemStats &st)
+{
+    const item &it = _items[i];
+
+    // Failed items aren't retried before the next run
+    //
+    _done.insert(it.key);
+
+    _stats.readBytes += st.readBytes;
+    _stats.readTime += st.readTime;
+    _stats.writeBytes += st.writeBytes;
+    _stats.writeTime += st.writeTime;
+
+    if (rc < 0) {
+        _stats.nfailed++;
+        if (it.stage == maskStage) {
+            ostringstream oss;
+            oss << it.ts << " " << it.varname;
+            _failedMasks.insert(oss.str());
+        }
+    } else {
+        _stats.nitems++;
+        _journal.add(it.key);
+    }
+
+    if (_progress) _progress(it.varname, it.ts, rc);
+}
+
+int runner::_runLocal(DC &dc, const vector<size_t> &items, bool inMaster)
+{
+    vector<int>       status(items.size(), -1);
+    vector<itemStats> st(items.size());
+    {
+        // Only the master file is written in append mode. It is updated
+        // when vdc is destroyed.
+        //
+        VDCNetCDF vdc(_nthreads);
+        int       rc = vdc.Initialize(_master, vector<string>(), inMaster ? VDC::A : VDC::R, {}, _chunksize);
+
+        for (size_t j = 0; j < items.size() && rc >= 0; j++) { status[j] = copy_item(dc, vdc, _items[items[j]], st[j]); }
+    }
+
+    for (size_t j = 0; j < items.size(); j++) {
+        const item &it = _items[items[j]];
+        if (status[j] >= 0) status[j] = sync_file(it.path);
+        if (status[j] < 0) MyBase::SetErrMsg("Failed to copy variable %s", it.varname.c_str());
+        _finish(items[j], status[j], st[j]);
+    }
+    return (0);
+}
+
+#ifndef WIN32
+void runner::_workerMain(int cmd, int res)
+{
+    DC *dc = _factory();
+    if (!dc) return;
+
+    string buf, line;
+    while (read_line(cmd, buf, line)) {
+        vector<size_t> items;
+        istringstream  iss(line);
+        size_t         i;
+        while (iss >> i) items.push_back(i);
+        if (items.empty()) continue;
+
+        VDCNetCDF vdc(_nthreads);
+        int       rc = vdc.Initialize(_master, vector<string>(), VDC::R, {}, _chunksize);
+
+        for (size_t j = 0; j < items.size(); j++) {
+            itemStats st;
+            int       status = -1;
+            if (rc >= 0) status = copy_item(*dc, vdc, _items[items[j]], st);
+            if (status >= 0) status = sync_file(_items[items[j]].path);
+            if (status < 0) MyBase::SetErrMsg("Failed to copy variable %s", _items[items[j]].varname.c_str());
+
+            ostringstream oss;
+            oss.precision(17);
+            oss << items[j] << " " << status << " " << st.readBytes << " " << st.readTime << " " << st.writeBytes << " " << st.writeTime << "\n";
+            if (!write_all(res, oss.str())) return;
+        }
+        if (!write_all(res, "\n")) return;
+    }
+}
+
+int runner::_spawn(vector<worker> &workers)
+{
+    int cmdp[2], resp[2];
+    if (pipe(cmdp) < 0) {
+        MyBase::SetErrMsg("pipe() : %M");
+        return (-1);
+    }
+    if (pipe(resp) < 0) {
+        MyBase::SetErrMsg("pipe() : %M");
+        ::close(cmdp[0]);
+        ::close(cmdp[1]);
+        return (-1);
+    }
+
+    // Output buffered by the parent would otherwise be written again by
+    // the child
+    //
+    cout.flush();
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        MyBase::SetErrMsg("fork() : %M");
+        ::close(cmdp[0]);
+        ::close(cmdp[1]);
+        ::close(resp[0]);
+        ::close(resp[1]);
+        return (-1);
+    }
+
+    if (pid == 0) {
+        // A worker must see end of file on its command pipe when the
+        // parent goes away, so it may not hold the pipes of the others
+        //
+        for (size_t i = 0; i < workers.size(); i++) {
+            ::close(workers[i].cmd);
+            ::close(workers[i].res);
+        }
+        ::close(cmdp[1]);
+        ::close(resp[0]);
+
+        _workerMain(cmdp[0], resp[1]);
+
+        // Skip the destructors and exit handlers of the parent's objects
+        //
+        _exit(0);
+    }
+
+    ::close(cmdp[0]);
+    ::close(resp[1]);
+
+    worker w;
+    w.pid = pid;
+    w.cmd = cmdp[1];
+    w.res = resp[0];
+    workers.push_back(w);
+    return (0);
+}
+
+// Give up on a worker that exited. Items it did not report failed.
+//
+void runner::_drop(worker &w)
+{
+    for (auto i : w.pending) {
+        MyBase::SetErrMsg("Worker process %d exited while copying variable %s", (int)w.pid, _items[i].varname.c_str());
+        _finish(i, -1, itemStats());
+    }
+    w.pending.clear();
+
+    ::close(w.cmd);
+    ::close(w.res);
+    (void)waitpid(w.pid, NULL, 0);
+    w.pid = -1;
+    w.busy = false;
+}
+#endif
+
+int runner::run(DC &dc, int nworkers, string checkpoint, bool restart)
+{
+    if (!checkpoint.empty()) {
+        uint64_t h = SerialUtils::FNV1a(_master);
+        for (size_t i = 0; i < _items.size(); i++) h = SerialUtils::FNV1a(_items[i].key + "\n", h);
+
+        if (_journal.open(checkpoint, h, restart, _done) < 0) return (-1);
+    }
+
+    for (size_t i = 0; i < _items.size(); i++) {
+        if (_done.count(_items[i].key)) _stats.nskipped++;
+    }
+
+#ifdef WIN32
+    nworkers = 1;
+#else
+    vector<worker> workers;
+    void (*sigpipe)(int) = SIG_DFL;
+    if (nworkers > 1) {
+        sigpipe = signal(SIGPIPE, SIG_IGN);
+        for (int i = 0; i < nworkers; i++) {
+            if (_spawn(workers) < 0) break;
+        }
+    }
+#endif
+
+    vector<size_t> items;
+    for (int stage = 0; stage < nStages; stage++) {
+        // The master file is written by this process, and closed before
+        // the workers read it
+        //
+        vector<size_t> queue;
+        for (size_t i = 0; i < _groups.size(); i++) {
+            if (_groups[i].stage != stage) continue;
+
+            if (_groups[i].inMaster || nworkers <= 1) {
+                if (_select(_groups[i], items)) (void)_runLocal(dc, items, _groups[i].inMaster);
+            } else {
+                queue.push_back(i);
+            }
+        }
+
+#ifndef WIN32
+        size_t next = 0;
+        size_t inflight = 0;
+        while (true) {
+            for (size_t w = 0; w < workers.size(); w++) {
+                if (workers[w].pid < 0 || workers[w].busy) continue;
+
+                // Skip the groups that are already done, e.g. when
+                // resuming, without using up the idle worker
+                //
+                while (next < queue.size() && !_select(_groups[queue[next]], items)) next++;
+                if (next >= queue.size()) break;
+
+                const group &g = _groups[queue[next]];
+                if (inflight && _maxMem && inflight + g.mem > _maxMem) break;
+                next++;
+
+                ostringstream oss;
+                for (size_t j = 0; j < items.size(); j++) oss << items[j] << (j + 1 < items.size() ? " " : "\n");
+
+                workers[w].pending.insert(items.begin(), items.end());
+                workers[w].busy = true;
+                workers[w].mem = g.mem;
+                inflight += g.mem;
+                if (!write_all(workers[w].cmd, oss.str())) {
+                    inflight -= g.mem;
+                    _drop(workers[w]);
+                }
+            }
+
+            vector<pollfd> fds;
+            vector<size_t> busy;
+            for (size_t w = 0; w < workers.size(); w++) {
+                if (workers[w].pid < 0 || !workers[w].busy) continue;
+                pollfd p = {workers[w].res, POLLIN, 0};
+                fds.push_back(p);
+                busy.push_back(w);
+            }
+
+            if (fds.empty()) {
+                // All workers are gone
+                //
+                for (; next < queue.size(); next++) {
+                    if (_select(_groups[queue[next]], items)) (void)_runLocal(dc, items, false);
+                }
+                break;
+            }
+
+            int rc = poll(fds.data(), fds.size(), -1);
+            if (rc < 0 && errno == EINTR) continue;
+            if (rc < 0) {
+                MyBase::SetErrMsg("poll() : %M");
+                for (size_t k = 0; k < busy.size(); k++) {
+                    inflight -= workers[busy[k]].mem;
+                    _drop(workers[busy[k]]);
+                }
+                continue;
+            }
+
+            for (size_t k = 0; k < fds.size(); k++) {
+                if (!fds[k].revents) continue;
+                worker &w = workers[busy[k]];
+
+                char    tmp[4096];
+                ssize_t n = read(w.res, tmp, sizeof(tmp));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    inflight -= w.mem;
+                    _drop(w);
+                    continue;
+                }
+                w.buf.append(tmp, n);
+
+                size_t pos;
+                while ((pos = w.buf.find('\n')) != string::npos) {
+                    string line = w.buf.substr(0, pos);
+                    w.buf.erase(0, pos + 1);
+
+                    if (line.empty()) {
+                        w.busy = false;
+                        inflight -= w.mem;
+                        continue;
+                    }
+
+                    istringstream iss(line);
+                    size_t        i;
+                    int           status;
+                    itemStats     st;
+                    if (!(iss >> i >> status >> st.readBytes >> st.readTime >> st.writeBytes >> st.writeTime) || !w.pending.count(i)) continue;
+
+                    w.pending.erase(i);
+                    _finish(i, status, st);
+                }
+            }
+        }
+#endif
+    }
+
+#ifndef WIN32
+    for (size_t w = 0; w < workers.size(); w++) {
+        if (workers[w].pid < 0) continue;
+        ::close(workers[w].cmd);
+        ::close(workers[w].res);
+        (void)waitpid(workers[w].pid, NULL, 0);
+    }
+    if (nworkers > 1) signal(SIGPIPE, sigpipe);
+#endif
+
+    if (_stats.nfailed) return (-1);
+
+    _journal.remove();
+    return (0);
+}
+
+};    // namespace
+
+VDCConverter::VDCConverter(DCFactory factory, string master, int nworkers, int nthreads, size_t chunksize)
+{
+    int nproc = EasyThreads::NProc();
+    if (nproc < 1) nproc = 1;
+
+    _factory = factory;
+    _master = master;
+    _nworkers = nworkers > 0 ? nworkers : nproc;
+    _nthreads = nthreads > 0 ? nthreads : std::max(1, nproc / _nworkers);
+    _chunksize = chunksize;
+    _maxMem = 0;
+    _restart = false;
+}
+
+int VDCConverter::Convert(DC &dc, const vector<string> &coordvars, const vector<string> &datavars, int numts)
+{
+    SetDiagMsg("VDCConverter::Convert(%s)", _master.c_str());
+
+    _stats = Stats();
+    double t0 = GetTime();
+
+    runner r(_factory, _progress, _master, _nthreads, _chunksize, _maxMem, _stats);
+
+    int rc = r.plan(dc, coordvars, datavars, numts);
+    if (rc == 0) rc = r.run(dc, _nworkers, _checkpoint, _restart);
+
+    _stats.wallTime = GetTime() - t0;
+
+    if (_stats.nfailed) return (-1);
+    return (rc);
+}
+
+void VDCConverter::PrintStats(std::ostream &o) const
+{
+    const double mb = 1024.0 * 1024.0;
+
+    o << "Copied " << _stats.nitems << " variable time steps";
+    if (_stats.nskipped) o << ", skipped " << _stats.nskipped << " found in checkpoint";
+    if (_stats.nfailed) o << ", " << _stats.nfailed << " failed";
+    o << ", in " << _stats.wallTime << " seconds" << endl;
+
+    o << "  read : " << _stats.readBytes / mb << " MBs in " << _stats.readTime << " seconds";
+    if (_stats.readTime > 0.0) o << " (" << _stats.readBytes / mb / _stats.readTime << " MBs/sec per worker)";
+    o << endl;
+
+    o << "  compress and write : " << _stats.writeBytes / mb << " MBs in " << _stats.writeTime << " seconds";
+    if (_stats.writeTime > 0.0) o << " (" << _stats.writeBytes / mb / _stats.writeTime << " MBs/sec per worker)";
+    o << endl;
+
+    if (_stats.wallTime > 0.0) o << "  overall : " << _stats.readBytes / mb / _stats.wallTime << " MBs/sec" << endl;
+}
+
+void VDCConverter::PrintProgress(const string &varname, size_t ts, int status)
+{
+    cout << "Copying variable " << varname << " time step " << ts;
+    if (status < 0) cout << " failed";
+    cout << endl;
+}
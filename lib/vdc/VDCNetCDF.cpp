@@ -785,6 +785,34 @@ int VDCNetCDF::readRegionBlock(int fd, const vector<size_t> &min, const vector<s
 
 int VDCNetCDF::readRegionBlock(int fd, const vector<size_t> &min, const vector<size_t> &max, int *region) { return (_readRegionBlockTemplate(fd, min, max, region)); }
 
+int VDCNetCDF::readRegionRange(int fd, const vector<size_t> &min, const vector<size_t> &max, vector<double> &range)
+{
+    range.clear();
+
+    VDCFileObject *o = (VDCFileObject *)_fileTable.GetEntry(fd);
+    if (!o) {
+        SetErrMsg("Invalid file descriptor : %d", fd);
+        return (-1);
+    }
+
+    // The per-block ranges stored by WASP don't account for masked
+    // (missing) values, so they can't be used if there is a mask
+    //
+    if (o->GetWaspMask()) return (0);
+
+    WASP * wasp = o->GetWaspData();
+    string varname = o->GetVarname();
+    size_t file_ts = o->GetFileTS();
+
+    bool time_varying = VDC::IsTimeVarying(varname);
+
+    vector<size_t> start;
+    vector<size_t> count;
+    vdc_2_ncdfcoords(file_ts, file_ts, time_varying, min, max, start, count);
+
+    return (wasp->GetVaraRange(start, count, range));
+}
+
 template<class T> int VDCNetCDF::_putVarTemplate(string varname, int lod, const T *data)
 {
     vector<size_t> dims_at_level;
@@ -881,49 +909,91 @@ int VDCNetCDF::_copyVar0d(DC &dc, size_t ts, const BaseVar &varInfo)
     return (0);
 }
 
+// Read source slices into the buffer until it is full, then write it out
+// as destination slices. If mv is not NULL the buffer is replaced in
+// place with one byte flags marking the values that differ from *mv.
+//
 template<class T>
-int VDCNetCDF::_copyVarHelper(DC &dc, int fdr, int fdw, vector<size_t> &buffer_dims, vector<size_t> &src_hslice_dims, vector<size_t> &dst_hslice_dims, size_t src_nslice, size_t dst_nslice, T *buffer)
+int VDCNetCDF::_copyVarHelper(DC &dc, int fdr, int fdw, vector<size_t> &buffer_dims, vector<size_t> &src_hslice_dims, vector<size_t> &dst_hslice_dims, size_t src_nslice, size_t dst_nslice, const double *mv,
+                              T *buffer, CopyStats &stats)
 {
     VAssert(buffer_dims.size() == src_hslice_dims.size());
     VAssert(buffer_dims.size() == dst_hslice_dims.size());
 
     size_t dim = buffer_dims.size() - 1;
+    size_t src_size = vproduct(src_hslice_dims);
+    size_t dst_size = vproduct(dst_hslice_dims);
 
     size_t src_slice_count = 0;
     size_t dst_slice_count = 0;
     while (src_slice_count < src_nslice) {
-        T * bufptr = buffer;
-        int n = buffer_dims[dim] / src_hslice_dims[dim];
+        T *    bufptr = buffer;
+        int    n = buffer_dims[dim] / src_hslice_dims[dim];
+        size_t nread = 0;
 
+        double t0 = Wasp::GetTime();
         for (int i = 0; i < n && src_slice_count < src_nslice; i++) {
             int rc = dc.ReadSlice(fdr, bufptr);
             if (rc < 0) return (-1);
-            bufptr += vproduct(src_hslice_dims);
+            bufptr += src_size;
 
             src_slice_count++;
+            nread++;
         }
+        stats.readTime += Wasp::GetTime() - t0;
+        stats.readBytes += nread * src_size * sizeof(T);
 
-        bufptr = buffer;
+        t0 = Wasp::GetTime();
         n = buffer_dims[dim] / dst_hslice_dims[dim];
 
-        for (int i = 0; i < n && dst_slice_count < dst_nslice; i++) {
-            int rc = WriteSlice(fdw, bufptr);
-            if (rc < 0) return (-1);
+        if (mv) {
+            unsigned char *cptr = (unsigned char *)buffer;
+            for (size_t j = 0; j < nread * src_size; j++) cptr[j] = buffer[j] == *mv ? 0 : 1;
 
-            bufptr += vproduct(dst_hslice_dims);
+            for (int i = 0; i < n && dst_slice_count < dst_nslice; i++) {
+                int rc = WriteSlice(fdw, cptr);
+                if (rc < 0) return (-1);
+
+                cptr += dst_size;
+                stats.writeBytes += dst_size;
+
+                dst_slice_count++;
+            }
+        } else {
+            bufptr = buffer;
+            for (int i = 0; i < n && dst_slice_count < dst_nslice; i++) {
+                int rc = WriteSlice(fdw, bufptr);
+                if (rc < 0) return (-1);
 
-            dst_slice_count++;
+                bufptr += dst_size;
+                stats.writeBytes += dst_size * sizeof(T);
+
+                dst_slice_count++;
+            }
         }
+        stats.writeTime += Wasp::GetTime() - t0;
     }
     return (0);
 }
 
-int VDCNetCDF::CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod)
+int VDCNetCDF::CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod, CopyStats *stats)
+{
+    CopyStats mystats;
+    return (_copyVar(dc, ts, varname, varname, srclod, dstlod, NULL, stats ? *stats : mystats));
+}
+
+int VDCNetCDF::CopyMask(DC &dc, size_t ts, string srcvar, string maskvar, double mv, int lod, CopyStats *stats)
+{
+    CopyStats mystats;
+    return (_copyVar(dc, ts, srcvar, maskvar, -1, lod, &mv, stats ? *stats : mystats));
+}
+
+int VDCNetCDF::_copyVar(DC &dc, size_t ts, string srcvar, string dstvar, int srclod, int dstlod, const double *mv, CopyStats &stats)
 {
     BaseVar varInfo;
-    bool    status = dc.GetBaseVarInfo(varname, varInfo);
+    bool    status = dc.GetBaseVarInfo(srcvar, varInfo);
     if (!status) {
-        SetErrMsg("Invalid source variable name : %s", varname.c_str());
+        SetErrMsg("Invalid source variable name : %s", srcvar.c_str());
         return (-1);
     }
 
@@ -932,12 +1002,12 @@ int VDCNetCDF::CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod
     //
     vector<size_t> src_hslice_dims;
     size_t         src_nslice;
-    int            rc = dc.GetHyperSliceInfo(varname, -1, src_hslice_dims, src_nslice);
+    int            rc = dc.GetHyperSliceInfo(srcvar, -1, src_hslice_dims, src_nslice);
     if (rc < 0) return (rc);
 
     vector<size_t> dst_hslice_dims;
     size_t         dst_nslice;
-    rc = GetHyperSliceInfo(varname, -1, dst_hslice_dims, dst_nslice);
+    rc = GetHyperSliceInfo(dstvar, -1, dst_hslice_dims, dst_nslice);
     if (rc < 0) return (rc);
 
     if (src_hslice_dims.size() != dst_hslice_dims.size()) {
@@ -945,7 +1015,16 @@ int VDCNetCDF::CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod
         return (-1);
     }
 
-    if (src_hslice_dims.size() == 0) { return (_copyVar0d(dc, ts, varInfo)); }
+    if (src_hslice_dims.size() == 0) {
+        if (mv) {
+            SetErrMsg("Can't make a mask of a scalar variable");
+            return (-1);
+        }
+        double t0 = Wasp::GetTime();
+        rc = _copyVar0d(dc, ts, varInfo);
+        stats.writeTime += Wasp::GetTime() - t0;
+        return (rc);
+    }
 
     // n-1 fastest varying dimensions must be the same for both hyper-slices.
     // Slowest dimension may be different.
@@ -974,28 +1053,37 @@ int VDCNetCDF::CopyVar(DC &dc, size_t ts, string varname, int srclod, int dstlod
     buffer_dims.pop_back();    // Remove slowest varying dimension
     buffer_dims.push_back(slice_dim);
 
-    int fdr = dc.OpenVariableRead(ts, varname, srclod);
+    int fdr = dc.OpenVariableRead(ts, srcvar, srclod);
     if (fdr < 0) return (fdr);
 
-    int fdw = OpenVariableWrite(ts, varname, dstlod);
-    if (fdw < 0) return (fdw);
+    int fdw = OpenVariableWrite(ts, dstvar, dstlod);
+    if (fdw < 0) {
+        dc.CloseVariable(fdr);
+        return (fdw);
+    }
 
-    if (varInfo.GetXType() == FLOAT || varInfo.GetXType() == DOUBLE) {
+    // Masks are made from floating point data
+    //
+    if (mv || varInfo.GetXType() == FLOAT || varInfo.GetXType() == DOUBLE) {
         size_t bufsize = vproduct(buffer_dims);
         float *buffer = new float[bufsize];
 
-        rc = _copyVarHelper(dc, fdr, fdw, buffer_dims, src_hslice_dims, dst_hslice_dims, src_nslice, dst_nslice, buffer);
+        rc = _copyVarHelper(dc, fdr, fdw, buffer_dims, src_hslice_dims, dst_hslice_dims, src_nslice, dst_nslice, mv, buffer, stats);
         delete[] buffer;
     } else {
         size_t bufsize = vproduct(buffer_dims);
         int *  buffer = new int[bufsize];
 
-        rc = _copyVarHelper(dc, fdr, fdw, buffer_dims, src_hslice_dims, dst_hslice_dims, src_nslice, dst_nslice, buffer);
+        rc = _copyVarHelper(dc, fdr, fdw, buffer_dims, src_hslice_dims, dst_hslice_dims, src_nslice, dst_nslice, mv, buffer, stats);
         delete[] buffer;
     }
 
+    // Closing the file flushes the last blocks
+    //
+    double t0 = Wasp::GetTime();
     dc.CloseVariable(fdr);
-    closeVariable(fdw);
+    if (closeVariable(fdw) < 0) rc = -1;
+    stats.writeTime += Wasp::GetTime() - t0;
 
     return (rc);
 }
@@ -5,9 +5,11 @@
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <functional>
 #include <vapor/Compressor.h>
 
 using namespace VAPoR;
+using namespace Wasp;
 using namespace std;
 
 void Compressor::_Compressor(vector<size_t> dims)
@@ -16,7 +18,6 @@ void Compressor::_Compressor(vector<size_t> dims)
 
     _dims.clear();
     _nlevels = 0;
-    _indexvec.clear();
     _nx = 1;
     _ny = 1;
     _nz = 1;
@@ -80,7 +81,6 @@ void Compressor::_Compressor(vector<size_t> dims)
         _LLen = _nlevels + 2;
         computeL(_nx, _nlevels, _L);
     }
-    _indexvec.reserve(_CLen);
 }
 
 Compressor::Compressor(vector<size_t> dims, const string &wavename, const string &mode) : MatWaveWavedec(wavename, mode)
@@ -109,22 +109,98 @@ Compressor::~Compressor()
     if (_L) delete[] _L;
 }
 
+namespace {
+
+// Magnitude of a wavelet coefficient
+//
+inline float  magnitude(float x) { return (fabsf(x)); }
+inline double magnitude(double x) { return (fabs(x)); }
+inline int    magnitude(int x) { return (abs(x)); }
+inline long   magnitude(long x) { return (labs(x)); }
+
 //
-// Comparision functions for the C++ Std Lib sort function
+// Select the largest magnitude coefficients of C[numkeep..clen-1] for
+// each of a sequence of bands. Coefficients are ranked by decreasing
+// magnitude, with ties broken by increasing index. Band j receives the
+// next lens[j] coefficients in rank order, which are copied to dst_arr
+// in increasing index order and recorded in sigmaps[j].
 //
-inline bool my_compare_f(const void *x1, const void *x2) { return (fabsf(*(float *)x1) > fabsf(*(float *)x2)); }
+// Rather than sorting the coefficients, the magnitude at each band
+// boundary is found with nth_element(), each search restricted to the
+// coefficients below the previous boundary. A single pass over the
+// coefficients in index order then assigns each one to its band. The
+// cost is linear in the number of coefficients for a fixed number of
+// bands.
+//
+template<class T> int select_template(const T *C, size_t clen, size_t numkeep, const vector<size_t> &lens, T *dst_arr, const vector<SignificanceMap *> &sigmaps, SmartBuf &sbuf)
+{
+    size_t n = clen - numkeep;
+    size_t nbands = lens.size();
+
+    T *mags = (T *)sbuf.Alloc(sizeof(T) * n);
+    for (size_t i = 0; i < n; i++) mags[i] = magnitude(C[numkeep + i]);
 
-inline bool my_compare_d(const void *x1, const void *x2) { return (fabs(*(double *)x1) > fabs(*(double *)x2)); }
+    // For each band boundary, the magnitude of the first coefficient
+    // outside of it (thresh), and the number of coefficients of that
+    // magnitude that are inside of it (nequal)
+    //
+    vector<size_t> bounds(nbands);
+    vector<T>      thresh(nbands, 0);
+    vector<size_t> nequal(nbands, 0);
+    vector<bool>   all(nbands, false);
+
+    size_t b = 0;
+    for (size_t j = 0; j < nbands; j++) {
+        size_t prev = b;
+        b += lens[j];
+        bounds[j] = b;
+        if (b >= n) {
+            all[j] = true;
+            continue;
+        }
 
-inline bool my_compare_i(const void *x1, const void *x2) { return (abs(*(int *)x1) > abs(*(int *)x2)); }
+        std::nth_element(mags + prev, mags + b, mags + n, std::greater<T>());
+        thresh[j] = mags[b];
 
-inline bool my_compare_l(const void *x1, const void *x2) { return (labs(*(long *)x1) > labs(*(long *)x2)); }
+        size_t ngreater = 0;
+        for (size_t i = 0; i < b; i++) {
+            if (mags[i] > thresh[j]) ngreater++;
+        }
+        nequal[j] = b - ngreater;
+    }
 
-namespace {
+    vector<T *>    dst(nbands);
+    vector<size_t> nset(nbands, 0);
+    for (size_t j = 0; j < nbands; j++) dst[j] = j ? dst[j - 1] + lens[j - 1] : dst_arr;
+
+    vector<size_t> eqseen(nbands, 0);
+    for (size_t idx = numkeep; idx < clen; idx++) {
+        T      m = magnitude(C[idx]);
+        size_t band = nbands;
+        for (size_t j = nbands; j-- > 0;) {
+            bool inside;
+            if (all[j] || m > thresh[j]) {
+                inside = true;
+            } else if (m == thresh[j]) {
+                inside = eqseen[j]++ < nequal[j];
+            } else {
+                inside = false;
+            }
+            if (inside) band = j;
+        }
+        if (band == nbands) continue;
+
+        dst[band][nset[band]++] = C[idx];
+        int rc = sigmaps[band]->Set(idx);
+        if (rc < 0) return (-1);
+    }
+
+    return (0);
+}
 
 template<class T>
 int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_arr_len, T *C, size_t clen, size_t *L, SignificanceMap *sigmap, const vector<size_t> &dims, size_t nlevels,
-                      vector<void *> indexvec, bool my_compare(const void *, const void *))
+                      SmartBuf &sbuf)
 {
     if (!C) {
         Compressor::SetErrMsg("Invalid state");
@@ -166,9 +242,8 @@ int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_
 
     sigmap->Clear();
 
-    // Data has been transformed. Now we need to sort it and find
-    // the threshold value. Note: we don't actually move the data. We
-    // sort an index array that references the data array.
+    // Data has been transformed. Now we need to find the largest
+    // magnitude coefficients. Note: we don't actually move the data.
 
     for (size_t i = 0; i < dst_arr_len; i++) dst_arr[i] = 0.0;
 
@@ -185,43 +260,32 @@ int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_
         dst_arr_len -= numkeep;
     }
 
-    indexvec.clear();
-    for (size_t i = numkeep; i < clen; i++) indexvec.push_back(&C[i]);
-    sort(indexvec.begin(), indexvec.end(), my_compare);
-
     // Copy coefficients that are larger than the threshold to
     // the destination array. Record their location in the significance
     // map.
     //
-
-    sort(indexvec.begin(), indexvec.begin() + dst_arr_len);
-    for (size_t idx = numkeep, i = 0; idx < clen && i < dst_arr_len; idx++) {
-        const T *cptr = (T *)indexvec[i];
-        dst_arr[i++] = *cptr;
-        sigmap->Set(cptr - C);
-    }
-    return (0);
+    return (select_template(C, clen, numkeep, vector<size_t>(1, dst_arr_len), dst_arr, vector<SignificanceMap *>(1, sigmap), sbuf));
 }
 };    // namespace
 
 int Compressor::Compress(const float *src_arr, float *dst_arr, size_t dst_arr_len, SignificanceMap *sigmap)
 {
-    return compress_template(this, src_arr, dst_arr, dst_arr_len, (float *)_C, _CLen, _L, sigmap, _dims, _nlevels, _indexvec, my_compare_f);
+    return compress_template(this, src_arr, dst_arr, dst_arr_len, (float *)_C, _CLen, _L, sigmap, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Compress(const double *src_arr, double *dst_arr, size_t dst_arr_len, SignificanceMap *sigmap)
 {
-    return compress_template(this, src_arr, dst_arr, dst_arr_len, (double *)_C, _CLen, _L, sigmap, _dims, _nlevels, _indexvec, my_compare_d);
+    return compress_template(this, src_arr, dst_arr, dst_arr_len, (double *)_C, _CLen, _L, sigmap, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Compress(const int *src_arr, int *dst_arr, size_t dst_arr_len, SignificanceMap *sigmap)
 {
-    return compress_template(this, src_arr, dst_arr, dst_arr_len, (int *)_C, _CLen, _L, sigmap, _dims, _nlevels, _indexvec, my_compare_i);
+    return compress_template(this, src_arr, dst_arr, dst_arr_len, (int *)_C, _CLen, _L, sigmap, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Compress(const long *src_arr, long *dst_arr, size_t dst_arr_len, SignificanceMap *sigmap)
 {
-    return compress_template(this, src_arr, dst_arr, dst_arr_len, (long *)_C, _CLen, _L, sigmap, _dims, _nlevels, _indexvec, my_compare_l);
+    return compress_template(this, src_arr, dst_arr, dst_arr_len, (long *)_C, _CLen, _L, sigmap, _dims, _nlevels, _selectBuf);
 }
 
 namespace {
@@ -306,7 +370,7 @@ int Compressor::Decompress(const long *src_arr, long *dst_arr, SignificanceMap *
 namespace {
 template<class T>
 int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vector<size_t> &dst_arr_lens, T *C, size_t clen, size_t *L, vector<SignificanceMap> &sigmaps, const vector<size_t> &dims,
-                       size_t nlevels, vector<void *> indexvec, bool my_compare(const void *, const void *))
+                       size_t nlevels, SmartBuf &sbuf)
 {
     if (!C) {
         Compressor::SetErrMsg("Invalid state");
@@ -361,9 +425,8 @@ int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vect
         sigmaps[i].Clear();
     }
 
-    // Data has been transformed. Now we need to sort it and find
-    // the threshold value. Note: we don't actually move the data. We
-    // sort an index array that references the data array.
+    // Data has been transformed. Now we need to find the largest
+    // magnitude coefficients. Note: we don't actually move the data.
 
     for (size_t i = 0; i < tlen; i++) dst_arr[i] = 0.0;
 
@@ -381,26 +444,12 @@ int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vect
     }
 
     //
-    // sort the **indecies** of the coefficients based on the
-    // coefficient's magnitude
+    // Partition the coefficients into the bands by magnitude
     //
-    indexvec.clear();
-    for (size_t i = numkeep; i < clen; i++) indexvec.push_back(&C[i]);
-    sort(indexvec.begin(), indexvec.end(), my_compare);
-
-    vector<void *>::iterator itr = indexvec.begin();
-    for (int j = 0, idx = 0; j < my_dst_arr_lens.size(); j++) {
-        sort(itr, itr + my_dst_arr_lens[j]);    // sort coefficient's indecies
-        itr += my_dst_arr_lens[j];
-        for (int i = 0; i < my_dst_arr_lens[j]; i++, idx++) {
-            const T *cptr = (T *)indexvec[idx];
-            dst_arr[i] = *cptr;
-            sigmaps[j].Set(cptr - C);
-        }
-        dst_arr += my_dst_arr_lens[j];
-    }
+    vector<SignificanceMap *> sigmapptrs;
+    for (int j = 0; j < sigmaps.size(); j++) sigmapptrs.push_back(&sigmaps[j]);
 
-    return (0);
+    return (select_template(C, clen, numkeep, my_dst_arr_lens, dst_arr, sigmapptrs, sbuf));
 }
 
 template<class T>
@@ -474,22 +523,22 @@ int reconstruct_template(Compressor *cmp, const T *src_arr, T *dst_arr, T *C, si
 
 int Compressor::Decompose(const float *src_arr, float *dst_arr, const vector<size_t> &dst_arr_lens, vector<SignificanceMap> &sigmaps)
 {
-    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (float *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _indexvec, my_compare_f);
+    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (float *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Decompose(const double *src_arr, double *dst_arr, const vector<size_t> &dst_arr_lens, vector<SignificanceMap> &sigmaps)
 {
-    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (double *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _indexvec, my_compare_d);
+    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (double *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Decompose(const int *src_arr, int *dst_arr, const vector<size_t> &dst_arr_lens, vector<SignificanceMap> &sigmaps)
 {
-    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (int *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _indexvec, my_compare_i);
+    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (int *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Decompose(const long *src_arr, long *dst_arr, const vector<size_t> &dst_arr_lens, vector<SignificanceMap> &sigmaps)
 {
-    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (long *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _indexvec, my_compare_l);
+    return decompose_template(this, src_arr, dst_arr, dst_arr_lens, (long *)_C, _CLen, _L, sigmaps, _dims, _nlevels, _selectBuf);
 }
 
 int Compressor::Reconstruct(const float *src_arr, float *dst_arr, vector<SignificanceMap> &sigmaps, int l)
@@ -10,6 +10,10 @@
     #include <float.h>
     #define isfinite _finite
 #endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define LIFTING_X86
+    #include <immintrin.h>
+#endif
 
 using namespace VAPoR;
 using namespace Wasp;
@@ -381,11 +385,474 @@ template<class T, class U> void transpose(const T *a, U *b, size_t p1, size_t p2
 
 template<class T, class U> void transpose(const T *a, U *b, size_t s1, size_t s2) { transpose(a, b, 0, 0, s1, s2, s1, s2); }
 
+/*-------------------------------------------
+ * Lifting scheme
+ *-----------------------------------------*/
+
+//
+// The CDF 5/3 ("bior2.2") and 9/7 ("bior4.4") wavelets with whole sample
+// symmetric extension ("symw") are factored into alternating predict and
+// update steps:
+//
+//	d[i] += c[k] * (s[i] + s[i+1])		predict (odd samples)
+//	s[i] += c[k+1] * (d[i-1] + d[i])	update (even samples)
+//
+// followed by a scaling of the even (approximation) and odd (detail)
+// samples that matches the normalization of the filters in WaveFiltBior.
+// Symmetric extension of the signal carries over to the even and odd
+// samples, so the boundaries need no extended copy of the signal. The
+// result equals the convolution in forward_xform() up to rounding.
+//
+// All steps are applied to w lanes at a time, where sample i of lane j
+// is stored at index i * w + j. Along X a single row is transformed
+// (w == 1) after splitting it into even and odd samples. Along Y and Z
+// the lanes are the rows or planes of a subband, so that columns are
+// transformed without transposing the data.
+//
+class lifting_scheme {
+public:
+    const char *wname;
+    int         nsteps;
+    double      c[4];
+    double      ke;    // approximation scale
+    double      ko;    // detail scale
+};
+
+const lifting_scheme lifting_schemes[] = {
+    {"bior2.2", 2, {-0.5, 0.25, 0.0, 0.0}, 1.41421356237309504880, -0.70710678118654752440},
+    {"bior4.4", 4, {-1.58613434205992355842, -0.05298011857296141462, 0.88291107553093294184, 0.44350685204397115215}, 1.14960439886024115979, -0.86986445162478127129},
+};
+
+const lifting_scheme *find_lifting_scheme(MatWaveDwt *dwt, MatWaveBase::dwtmode_t mode)
+{
+    if (!dwt->LiftingOnOff() || mode != MatWaveBase::SYMW) return (NULL);
+
+    string wname = dwt->wavelet_name();
+    for (size_t i = 0; i < sizeof(lifting_schemes) / sizeof(lifting_schemes[0]); i++) {
+        if (wname == lifting_schemes[i].wname) return (&lifting_schemes[i]);
+    }
+    return (NULL);
+}
+
+// Lifting kernels: y[i] += c * (a[i] + b[i]), and y[i] *= c. Multiply
+// and add are kept separate (no fused multiply-add) so that every
+// kernel rounds the same way.
+//
+template<class W> void lift_step_scalar(W *y, const W *a, const W *b, W c, size_t n)
+{
+    for (size_t i = 0; i < n; i++) y[i] += c * (a[i] + b[i]);
+}
+
+template<class W> void lift_scale_scalar(W *y, W c, size_t n)
+{
+    for (size_t i = 0; i < n; i++) y[i] *= c;
+}
+
+#ifdef LIFTING_X86
+
+void lift_step_sse2(double *y, const double *a, const double *b, double c, size_t n)
+{
+    __m128d vc = _mm_set1_pd(c);
+    size_t  i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(vc, v)));
+    }
+    lift_step_scalar(y + i, a + i, b + i, c, n - i);
+}
+
+void lift_step_sse2(float *y, const float *a, const float *b, float c, size_t n)
+{
+    __m128 vc = _mm_set1_ps(c);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vc, v)));
+    }
+    lift_step_scalar(y + i, a + i, b + i, c, n - i);
+}
+
+void lift_scale_sse2(double *y, double c, size_t n)
+{
+    __m128d vc = _mm_set1_pd(c);
+    size_t  i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(y + i, _mm_mul_pd(vc, _mm_loadu_pd(y + i)));
+    lift_scale_scalar(y + i, c, n - i);
+}
+
+void lift_scale_sse2(float *y, float c, size_t n)
+{
+    __m128 vc = _mm_set1_ps(c);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_ps(y + i, _mm_mul_ps(vc, _mm_loadu_ps(y + i)));
+    lift_scale_scalar(y + i, c, n - i);
+}
+
+__attribute__((target("avx2"))) void lift_step_avx2(double *y, const double *a, const double *b, double c, size_t n)
+{
+    __m256d vc = _mm256_set1_pd(c);
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(vc, v)));
+    }
+    lift_step_scalar(y + i, a + i, b + i, c, n - i);
+}
+
+__attribute__((target("avx2"))) void lift_step_avx2(float *y, const float *a, const float *b, float c, size_t n)
+{
+    __m256 vc = _mm256_set1_ps(c);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(vc, v)));
+    }
+    lift_step_scalar(y + i, a + i, b + i, c, n - i);
+}
+
+__attribute__((target("avx2"))) void lift_scale_avx2(double *y, double c, size_t n)
+{
+    __m256d vc = _mm256_set1_pd(c);
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(y + i, _mm256_mul_pd(vc, _mm256_loadu_pd(y + i)));
+    lift_scale_scalar(y + i, c, n - i);
+}
+
+__attribute__((target("avx2"))) void lift_scale_avx2(float *y, float c, size_t n)
+{
+    __m256 vc = _mm256_set1_ps(c);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(y + i, _mm256_mul_ps(vc, _mm256_loadu_ps(y + i)));
+    lift_scale_scalar(y + i, c, n - i);
+}
+
+#endif
+
+// Kernels selected once for the instruction sets the processor supports
+//
+class lifting_kernels {
+public:
+    lifting_kernels()
+    {
+        name = "scalar";
+        stepd = lift_step_scalar<double>;
+        stepf = lift_step_scalar<float>;
+        scaled = lift_scale_scalar<double>;
+        scalef = lift_scale_scalar<float>;
+
+#ifdef LIFTING_X86
+        // SSE2 is part of x86-64
+        //
+        name = "sse2";
+        stepd = lift_step_sse2;
+        stepf = lift_step_sse2;
+        scaled = lift_scale_sse2;
+        scalef = lift_scale_sse2;
+
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            name = "avx2";
+            stepd = lift_step_avx2;
+            stepf = lift_step_avx2;
+            scaled = lift_scale_avx2;
+            scalef = lift_scale_avx2;
+        }
+#endif
+    }
+
+    string name;
+    void (*stepd)(double *, const double *, const double *, double, size_t);
+    void (*stepf)(float *, const float *, const float *, float, size_t);
+    void (*scaled)(double *, double, size_t);
+    void (*scalef)(float *, float, size_t);
+};
+
+const lifting_kernels &get_lifting_kernels()
+{
+    static lifting_kernels kernels;
+    return (kernels);
+}
+
+void lift_step(double *y, const double *a, const double *b, double c, size_t n) { get_lifting_kernels().stepd(y, a, b, c, n); }
+void lift_step(float *y, const float *a, const float *b, float c, size_t n) { get_lifting_kernels().stepf(y, a, b, c, n); }
+void lift_scale(double *y, double c, size_t n) { get_lifting_kernels().scaled(y, c, n); }
+void lift_scale(float *y, float c, size_t n) { get_lifting_kernels().scalef(y, c, n); }
+
+// Lifting is done in single precision for float data, and in double
+// precision otherwise
+//
+template<class T> class lifting_type {
+public:
+    typedef double type;
+};
+template<> class lifting_type<float> {
+public:
+    typedef float type;
+};
+
+// d[i] += c * (s[i] + s[i+1]) for the ns even and nd odd samples of w
+// lanes. If the signal length is even the last odd sample is
+// reflected about itself, so s[ns] == s[ns-1].
+//
+template<class W> void lift_predict(W *s, W *d, size_t ns, size_t nd, size_t w, W c)
+{
+    size_t m = ns > nd ? nd : nd - 1;
+    if (m) lift_step(d, s, s + w, c, m * w);
+    if (m < nd) lift_step(d + m * w, s + m * w, s + m * w, c, w);
+}
+
+// s[i] += c * (d[i-1] + d[i]), with d[-1] == d[0], and, if the signal
+// length is odd, d[nd] == d[nd-1]
+//
+template<class W> void lift_update(W *s, W *d, size_t ns, size_t nd, size_t w, W c)
+{
+    lift_step(s, d, d, c, w);
+    if (nd > 1) lift_step(s + w, d, d + w, c, (nd - 1) * w);
+    if (ns > nd) lift_step(s + nd * w, d + (nd - 1) * w, d + (nd - 1) * w, c, w);
+}
+
+template<class W> void lift_forward(const lifting_scheme &ls, W *s, W *d, size_t ns, size_t nd, size_t w)
+{
+    for (int k = 0; k < ls.nsteps; k += 2) {
+        lift_predict(s, d, ns, nd, w, (W)ls.c[k]);
+        lift_update(s, d, ns, nd, w, (W)ls.c[k + 1]);
+    }
+    lift_scale(s, (W)ls.ke, ns * w);
+    lift_scale(d, (W)ls.ko, nd * w);
+}
+
+template<class W> void lift_inverse(const lifting_scheme &ls, W *s, W *d, size_t ns, size_t nd, size_t w)
+{
+    lift_scale(s, (W)(1.0 / ls.ke), ns * w);
+    lift_scale(d, (W)(1.0 / ls.ko), nd * w);
+    for (int k = ls.nsteps - 2; k >= 0; k -= 2) {
+        lift_update(s, d, ns, nd, w, (W)-ls.c[k + 1]);
+        lift_predict(s, d, ns, nd, w, (W)-ls.c[k]);
+    }
+}
+
+// Position of sample i after splitting a signal of length n into its
+// even samples followed by its odd samples
+//
+inline size_t lift_split_index(size_t i, size_t n) { return (i % 2 ? ((n + 1) >> 1) + (i >> 1) : i >> 1); }
+
+template<class T, class W> int lift_split(const T *sigIn, size_t n, W *s, W *d, bool invalid_float_abort)
+{
+    size_t ns = (n + 1) >> 1;
+    size_t nd = n >> 1;
+    for (size_t i = 0; i < nd; i++) {
+        s[i] = sigIn[2 * i];
+        d[i] = sigIn[2 * i + 1];
+    }
+    if (ns > nd) s[nd] = sigIn[n - 1];
+
+    if (valid_float(s, ns, invalid_float_abort) < 0) return (-1);
+    return (valid_float(d, nd, invalid_float_abort));
+}
+
+template<class W, class U> void lift_merge(const W *s, const W *d, size_t n, U *sigOut)
+{
+    size_t ns = (n + 1) >> 1;
+    size_t nd = n >> 1;
+    for (size_t i = 0; i < nd; i++) {
+        sigOut[2 * i] = (U)s[i];
+        sigOut[2 * i + 1] = (U)d[i];
+    }
+    if (ns > nd) sigOut[n - 1] = (U)s[nd];
+}
+
+template<class T, class U> void lift_copy(const T *a, U *b, size_t n)
+{
+    for (size_t i = 0; i < n; i++) b[i] = (U)a[i];
+}
+
+int lift_check_len(MatWaveDwt *dwt, size_t n)
+{
+    if (dwt->wmaxlev(n) < 1) {
+        MatWaveDwt::SetErrMsg("Can't transform signal of length : %d", n);
+        return (-1);
+    }
+    return (0);
+}
+
+template<class T, class U> int lift_dwt(MatWaveDwt *dwt, const lifting_scheme &ls, const T *sigIn, size_t n, U *cA, U *cD, SmartBuf &sbuf)
+{
+    typedef typename lifting_type<T>::type W;
+
+    size_t ns = (n + 1) >> 1;
+    size_t nd = n >> 1;
+
+    W *s = (W *)sbuf.Alloc(sizeof(W) * n);
+    W *d = s + ns;
+
+    if (lift_split(sigIn, n, s, d, dwt->InvalidFloatAbortOnOff()) < 0) return (-1);
+    lift_forward(ls, s, d, ns, nd, 1);
+
+    lift_copy(s, cA, ns);
+    lift_copy(d, cD, nd);
+    return (0);
+}
+
+template<class T, class U> int lift_idwt(MatWaveDwt *dwt, const lifting_scheme &ls, const T *cA, const T *cD, size_t n, U *sigOut, SmartBuf &sbuf)
+{
+    typedef typename lifting_type<T>::type W;
+
+    size_t ns = (n + 1) >> 1;
+    size_t nd = n >> 1;
+
+    W *s = (W *)sbuf.Alloc(sizeof(W) * n);
+    W *d = s + ns;
+
+    lift_copy(cA, s, ns);
+    lift_copy(cD, d, nd);
+    if (valid_float(s, n, dwt->InvalidFloatAbortOnOff()) < 0) return (-1);
+
+    lift_inverse(ls, s, d, ns, nd, 1);
+    lift_merge(s, d, n, sigOut);
+    return (0);
+}
+
+// 2D transform. The rows are transformed one at a time, and stored
+// with the even rows first. The columns of the approximation and
+// detail halves are then transformed as lanes. W is the type of the
+// work buffer
+//
+template<class W, class T, class U>
+int lift_dwt2d(MatWaveDwt *dwt, const lifting_scheme &ls, const T *sigIn, size_t nx, size_t ny, U *cA, U *cDh, U *cDv, U *cDd, SmartBuf &sbuf)
+{
+    if (lift_check_len(dwt, nx) < 0 || lift_check_len(dwt, ny) < 0) return (-1);
+
+    size_t nxs = (nx + 1) >> 1, nxd = nx >> 1;
+    size_t nys = (ny + 1) >> 1, nyd = ny >> 1;
+
+    W *buf = (W *)sbuf.Alloc(sizeof(W) * nx * ny);
+    W *a = buf;               // X approximation, nxs lanes
+    W *d = buf + nxs * ny;    // X detail, nxd lanes
+
+    for (size_t y = 0; y < ny; y++) {
+        size_t r = lift_split_index(y, ny);
+        W *    s = a + r * nxs;
+        W *    dd = d + r * nxd;
+
+        if (lift_split(&sigIn[nx * y], nx, s, dd, dwt->InvalidFloatAbortOnOff()) < 0) return (-1);
+        lift_forward(ls, s, dd, nxs, nxd, 1);
+    }
+
+    lift_forward(ls, a, a + nys * nxs, nys, nyd, nxs);
+    lift_forward(ls, d, d + nys * nxd, nys, nyd, nxd);
+
+    lift_copy(a, cA, nys * nxs);
+    lift_copy(a + nys * nxs, cDh, nyd * nxs);
+    lift_copy(d, cDv, nys * nxd);
+    lift_copy(d + nys * nxd, cDd, nyd * nxd);
+    return (0);
+}
+
+template<class W, class T, class U>
+int lift_idwt2d(MatWaveDwt *dwt, const lifting_scheme &ls, const T *cA, const T *cDh, const T *cDv, const T *cDd, size_t nx, size_t ny, U *sigOut, SmartBuf &sbuf)
+{
+    size_t nxs = (nx + 1) >> 1, nxd = nx >> 1;
+    size_t nys = (ny + 1) >> 1, nyd = ny >> 1;
+
+    W *buf = (W *)sbuf.Alloc(sizeof(W) * nx * ny);
+    W *a = buf;
+    W *d = buf + nxs * ny;
+
+    lift_copy(cA, a, nys * nxs);
+    lift_copy(cDh, a + nys * nxs, nyd * nxs);
+    lift_copy(cDv, d, nys * nxd);
+    lift_copy(cDd, d + nys * nxd, nyd * nxd);
+    if (valid_float(buf, nx * ny, dwt->InvalidFloatAbortOnOff()) < 0) return (-1);
+
+    lift_inverse(ls, a, a + nys * nxs, nys, nyd, nxs);
+    lift_inverse(ls, d, d + nys * nxd, nys, nyd, nxd);
+
+    for (size_t y = 0; y < ny; y++) {
+        size_t r = lift_split_index(y, ny);
+        W *    s = a + r * nxs;
+        W *    dd = d + r * nxd;
+
+        lift_inverse(ls, s, dd, nxs, nxd, 1);
+        lift_merge(s, dd, nx, &sigOut[nx * y]);
+    }
+    return (0);
+}
+
+// 3D transform. Each XY plane is transformed and its four subbands
+// stored with the even planes first. The planes of each subband volume
+// are then transformed along Z as lanes. The subband volumes are laid
+// out in the order of the coefficient vector C.
+//
+template<class T> int lift_dwt3d(MatWaveDwt *dwt, const lifting_scheme &ls, const T *sigIn, size_t nx, size_t ny, size_t nz, T *C, SmartBuf &sbuf3d, SmartBuf &sbuf2d)
+{
+    typedef typename lifting_type<T>::type W;
+
+    if (lift_check_len(dwt, nz) < 0) return (-1);
+
+    size_t nxs = (nx + 1) >> 1, nxd = nx >> 1;
+    size_t nys = (ny + 1) >> 1, nyd = ny >> 1;
+    size_t nzs = (nz + 1) >> 1, nzd = nz >> 1;
+
+    W *buf = (W *)sbuf3d.Alloc(sizeof(W) * nx * ny * nz);
+
+    W *    vol[4];
+    size_t  lanes[4] = {nxs * nys, nxs * nyd, nxd * nys, nxd * nyd};
+    vol[0] = buf;
+    for (int i = 1; i < 4; i++) vol[i] = vol[i - 1] + lanes[i - 1] * nz;
+
+    for (size_t z = 0; z < nz; z++) {
+        size_t r = lift_split_index(z, nz);
+
+        int rc = lift_dwt2d<W>(dwt, ls, &sigIn[nx * ny * z], nx, ny, vol[0] + r * lanes[0], vol[1] + r * lanes[1], vol[2] + r * lanes[2], vol[3] + r * lanes[3], sbuf2d);
+        if (rc < 0) return (-1);
+    }
+
+    for (int i = 0; i < 4; i++) lift_forward(ls, vol[i], vol[i] + nzs * lanes[i], nzs, nzd, lanes[i]);
+
+    lift_copy(buf, C, nx * ny * nz);
+    return (0);
+}
+
+template<class T, class U>
+int lift_idwt3d(MatWaveDwt *dwt, const lifting_scheme &ls, const T *c[8], size_t nx, size_t ny, size_t nz, U *sigOut, SmartBuf &sbuf3d, SmartBuf &sbuf2d)
+{
+    typedef typename lifting_type<T>::type W;
+
+    size_t nxs = (nx + 1) >> 1, nxd = nx >> 1;
+    size_t nys = (ny + 1) >> 1, nyd = ny >> 1;
+    size_t nzs = (nz + 1) >> 1, nzd = nz >> 1;
+
+    W *buf = (W *)sbuf3d.Alloc(sizeof(W) * nx * ny * nz);
+
+    W *    vol[4];
+    size_t lanes[4] = {nxs * nys, nxs * nyd, nxd * nys, nxd * nyd};
+    vol[0] = buf;
+    for (int i = 1; i < 4; i++) vol[i] = vol[i - 1] + lanes[i - 1] * nz;
+
+    for (int i = 0; i < 4; i++) {
+        lift_copy(c[2 * i], vol[i], lanes[i] * nzs);
+        lift_copy(c[2 * i + 1], vol[i] + lanes[i] * nzs, lanes[i] * nzd);
+    }
+    if (valid_float(buf, nx * ny * nz, dwt->InvalidFloatAbortOnOff()) < 0) return (-1);
+
+    for (int i = 0; i < 4; i++) lift_inverse(ls, vol[i], vol[i] + nzs * lanes[i], nzs, nzd, lanes[i]);
+
+    for (size_t z = 0; z < nz; z++) {
+        size_t r = lift_split_index(z, nz);
+
+        int rc = lift_idwt2d<W>(dwt, ls, vol[0] + r * lanes[0], vol[1] + r * lanes[1], vol[2] + r * lanes[2], vol[3] + r * lanes[3], nx, ny, &sigOut[nx * ny * z], sbuf2d);
+        if (rc < 0) return (-1);
+    }
+    return (0);
+}
+
 };    // namespace
 
-MatWaveDwt::MatWaveDwt(const string &wname, const string &mode) : MatWaveBase(wname, mode) {}
+MatWaveDwt::MatWaveDwt(const string &wname, const string &mode) : MatWaveBase(wname, mode) { _lifting = true; }
 
-MatWaveDwt::MatWaveDwt(const string &wname) : MatWaveBase(wname) {}
+MatWaveDwt::MatWaveDwt(const string &wname) : MatWaveBase(wname) { _lifting = true; }
+
+string MatWaveDwt::LiftingKernels() { return (get_lifting_kernels().name); }
 
 MatWaveDwt::~MatWaveDwt() {}
 
@@ -410,6 +877,11 @@ int dwt_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInLen, const WaveFil
     L[1] = dwt->detaillength(sigInLen);
     L[2] = sigInLen;
 
+    if (!std::numeric_limits<V>::is_integer) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) return (lift_dwt(dwt, *ls, sigIn, sigInLen, cA, cD, sbuf));
+    }
+
     int filterLen = wf->GetLength();
 
     //
@@ -566,6 +1038,11 @@ int idwt_template(MatWaveDwt *dwt, const T *cA, const T *cD, const size_t L[3],
         return (-1);
     }
 
+    if (!std::numeric_limits<V>::is_integer && L[2] > 1) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) return (lift_idwt(dwt, *ls, cA, cD, L[2], sigOut, sbuf));
+    }
+
     int filterLen = wf->GetLength();
 
     bool                   do_sym_conv = false;
@@ -803,6 +1280,11 @@ int dwt2d_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInX, size_t sigInY
     L[8] = sigInX;
     L[9] = sigInY;
 
+    if (!std::numeric_limits<V>::is_integer) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) return (lift_dwt2d<typename lifting_type<T>::type>(dwt, *ls, sigIn, sigInX, sigInY, cA, cDh, cDv, cDd, sbuf2d));
+    }
+
     // First: transform rows
     //
     size_t passXLen = (L[0] + L[4]) * sigInY;
@@ -956,6 +1438,11 @@ int idwt2d_template(MatWaveDwt *dwt, const T *cA, const T *cDh, const T *cDv, co
         return (-1);
     }
 
+    if (!std::numeric_limits<V>::is_integer && L[8] > 1 && L[9] > 1) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) return (lift_idwt2d<typename lifting_type<T>::type>(dwt, *ls, cA, cDh, cDv, cDd, L[8], L[9], sigOut, sbuf2d));
+    }
+
     size_t passYLen = max(L[0], L[4]) * (L[1] + L[3]);
     size_t transposeLen = max(L[0], L[4]) * L[9];
     size_t passXLen = (L[0] + L[4]) * L[9];
@@ -1240,6 +1727,11 @@ int dwt3d_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInX, size_t sigInY
     T *cHHL = cHLH + L[15] * L[16] * L[17];
     T *cHHH = cHHL + L[18] * L[19] * L[20];
 
+    if (!std::numeric_limits<V>::is_integer) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) return (lift_dwt3d(dwt, *ls, sigIn, sigInX, sigInY, sigInZ, C, sbuf3d1, sbuf2d));
+    }
+
     // First: transform XY planes
     //
     size_t passXYLen = (L[0] + L[12]) * (L[1] + L[7]) * sigInZ;
@@ -1369,6 +1861,14 @@ int idwt3d_template(MatWaveDwt *dwt, const T *cLLL, const T *cLLH, const T *cLHL
         return (-1);
     }
 
+    if (!std::numeric_limits<V>::is_integer && L[24] > 1 && L[25] > 1 && L[26] > 1) {
+        const lifting_scheme *ls = find_lifting_scheme(dwt, mode);
+        if (ls) {
+            const T *c[8] = {cLLL, cLLH, cLHL, cLHH, cHLL, cHLH, cHHL, cHHH};
+            return (lift_idwt3d(dwt, *ls, c, L[24], L[25], L[26], sigOut, sbuf3d1, sbuf2d));
+        }
+    }
+
     size_t passXYLen = (L[0] + L[12]) * (L[1] + L[7]) * L[26];
 
     V *buf3d1 = (V *)sbuf3d1.Alloc(sizeof(dummy) * passXYLen);
@@ -2,8 +2,12 @@
 #include <sstream>
 #include <sstream>
 #include <iterator>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include <sys/stat.h>
 #include "vapor/utils.h"
+#include "vapor/CFuncs.h"
 #include "vapor/MatWaveBase.h"
 #include "vapor/Compressor.h"
 #include "vapor/WASP.h"
@@ -216,20 +220,125 @@ public:
     unsigned char *      _maps;           // private (not shared)
     int                  _level;
     bool                 _unblock_flag;    // unblock the data after reconstruction?
+    void *               _pipeline;        // global (shared by all threads)
+    double               _io_time;         // private: time spent fetching blocks
     static int           _status;          // error indicator
 
+    // Variable dims and block size at each refinement level (compressed
+    // writes only)
+    //
+    vector<vector<size_t>> _dims_at_level;
+    vector<vector<size_t>> _bs_at_level;
+
     thread_state(int id, EasyThreads *et, int nthreads, string &varname, const vector<NetCDFCpp *> &ncdfcptrs, const vector<size_t> &start, const vector<size_t> &count, const vector<size_t> &bs,
                  const vector<size_t> &udims, const vector<size_t> &ncoeffs, const vector<size_t> &encoded_dims, const vector<Compressor *> &compressors, void *data, int data_type,
                  unsigned char *mask, void *block, void *coeffs, int block_type, int xtype, unsigned char *maps, int level, bool unblock_flag)
     : _id(id), _et(et), _nthreads(nthreads), _varname(varname), _ncdfcptrs(ncdfcptrs), _start(start), _count(count), _bs(bs), _udims(udims), _ncoeffs(ncoeffs), _encoded_dims(encoded_dims),
       _compressors(compressors), _data(data), _data_type(data_type), _mask(mask), _block(block), _coeffs(coeffs), _block_type(block_type), _xtype(xtype), _maps(maps), _level(level),
-      _unblock_flag(unblock_flag)
+      _unblock_flag(unblock_flag), _pipeline(NULL), _io_time(0.0)
     {
         _status = 0;
     }
 };
 int thread_state::_status = 0;
 
+// Bounded queue of compressed blocks for pipelined reads. A single I/O
+// thread fills free slots with the coefficients, significance maps and
+// data range of successive blocks, in file order. The remaining threads
+// take filled slots, reconstruct the blocks, and return the slots to
+// the free list.
+//
+template<class U> class read_pipeline {
+public:
+    read_pipeline(int nslots, U *coeffs, size_t coeffs_size, unsigned char *maps, size_t maps_size)
+    : _coeffs(coeffs), _coeffs_size(coeffs_size), _maps(maps), _maps_size(maps_size), _ranges(nslots * 2), _done(false)
+    {
+        for (int i = 0; i < nslots; i++) _free.push_back(i);
+    }
+
+    U *            coeffs(int slot) { return (_coeffs + slot * _coeffs_size); }
+    unsigned char *maps(int slot) { return (_maps + slot * _maps_size); }
+    U *            range(int slot) { return (&_ranges[slot * 2]); }
+
+    // Wait for a free slot. Returns -1 if the read has been aborted
+    //
+    int acquire()
+    {
+        std::unique_lock<std::mutex> lk(_mutex);
+        _cv_free.wait(lk, [this] { return (_done || !_free.empty()); });
+        if (_done) return (-1);
+
+        int slot = _free.front();
+        _free.pop_front();
+        return (slot);
+    }
+
+    // Hand a filled slot, containing block 'index', to the workers
+    //
+    void push(int slot, size_t index)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _full.push_back(std::make_pair(slot, index));
+        _cv_full.notify_one();
+    }
+
+    // Wait for a filled slot. Returns false once the I/O thread has
+    // finished and the queue is drained, or the read has been aborted
+    //
+    bool pop(int &slot, size_t &index)
+    {
+        std::unique_lock<std::mutex> lk(_mutex);
+        _cv_full.wait(lk, [this] { return (_done || !_full.empty()); });
+        if (_full.empty()) return (false);
+
+        slot = _full.front().first;
+        index = _full.front().second;
+        _full.pop_front();
+        return (true);
+    }
+
+    void release(int slot)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _free.push_back(slot);
+        _cv_free.notify_one();
+    }
+
+    // Called by the I/O thread when there is nothing more to read
+    //
+    void finish()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _done = true;
+        _cv_full.notify_all();
+        _cv_free.notify_all();
+    }
+
+    // Called by any thread on error. Pending blocks are discarded
+    //
+    void abort()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _done = true;
+        _full.clear();
+        _cv_full.notify_all();
+        _cv_free.notify_all();
+    }
+
+private:
+    U *                                   _coeffs;
+    size_t                                _coeffs_size;
+    unsigned char *                       _maps;
+    size_t                                _maps_size;    // in bytes
+    vector<U>                             _ranges;
+    bool                                  _done;
+    std::deque<int>                       _free;
+    std::deque<std::pair<int, size_t>>    _full;
+    std::mutex                            _mutex;
+    std::condition_variable               _cv_free;
+    std::condition_variable               _cv_full;
+};
+
 // Convert voxel coordinates, 'vcoords', to block coordinates, 'bcoords',
 // assuming a block size of 'bs'. 'residual' is any offset within
 // the block if 'vcoords' is not block-aligned.
@@ -864,6 +973,125 @@ int StoreBlockCompressed(string varname, vector<NetCDFCpp *> ncdfcptrs, vector<s
     return (0);
 }
 
+// Compute the range of the part of a block that lies inside the
+// variable. Boundary blocks are padded by Block(), and the padding
+// must not contribute to the range.
+//
+// block : data block
+// bs : dimensions of 'block'
+// count : number of valid elements along each dimension of 'block'
+// min, max : range of the valid elements
+//
+template<class T, class U> void BlockRange(const U *block, vector<size_t> bs, vector<size_t> count, T &min, T &max)
+{
+    int rank = bs.size();
+
+    size_t nbx = rank >= 1 ? bs[rank - 1] : 1;
+    size_t nby = rank >= 2 ? bs[rank - 2] : 1;
+
+    size_t nx = rank >= 1 ? count[rank - 1] : 1;
+    size_t ny = rank >= 2 ? count[rank - 2] : 1;
+    size_t nz = rank >= 3 ? count[rank - 3] : 1;
+
+    min = max = (T)block[0];
+    for (size_t z = 0; z < nz; z++) {
+        for (size_t y = 0; y < ny; y++) {
+            for (size_t x = 0; x < nx; x++) {
+                T v = (T)block[z * nbx * nby + y * nbx + x];
+                if (v < min) min = v;
+                if (v > max) max = v;
+            }
+        }
+    }
+}
+
+// Reconstruct a transformed block at every level-of-detail and every
+// refinement level, and compute the range of each reconstruction. Lossy
+// reconstructions generally don't span the range of the original data,
+// so the range of each is recorded separately.
+//
+// s : thread state of a compressed write
+// bcoords : coordinates of block in blocks
+// coeffs : transformed coefficients returned by DecomposeBlock()
+// datarange : min and max of the original block
+// maps : encoded significance maps returned by DecomposeBlock()
+// block : storage for a reconstructed block
+// ranges : min and max at each refinement level, coarsest first, for
+// each level-of-detail in turn
+//
+template<class T, class U>
+int ReconstructBlockRanges(thread_state &s, vector<size_t> bcoords, const U *coeffs, const U *datarange, const unsigned char *maps, U *block, vector<double> &ranges, T dummy)
+{
+    ranges.clear();
+
+    // Coefficients and data range are rounded to the external storage
+    // type when written. Round them here too, so that the
+    // reconstructions match those of a later read.
+    //
+    vector<U> xcoeffs(coeffs, coeffs + vsum(s._ncoeffs));
+    U         xdatarange[2] = {datarange[0], datarange[1]};
+    if (s._xtype == NC_FLOAT) {
+        for (size_t i = 0; i < xcoeffs.size(); i++) xcoeffs[i] = (U)(float)xcoeffs[i];
+        for (int i = 0; i < 2; i++) xdatarange[i] = (U)(float)xdatarange[i];
+    } else if (s._xtype == NC_INT) {
+        for (size_t i = 0; i < xcoeffs.size(); i++) xcoeffs[i] = (U)(int)xcoeffs[i];
+        for (int i = 0; i < 2; i++) xdatarange[i] = (U)(int)xdatarange[i];
+    } else if (s._xtype == NC_SHORT) {
+        for (size_t i = 0; i < xcoeffs.size(); i++) xcoeffs[i] = (U)(int16_t)xcoeffs[i];
+        for (int i = 0; i < 2; i++) xdatarange[i] = (U)(int16_t)xdatarange[i];
+    }
+
+    for (int lod = 0; lod < s._ncoeffs.size(); lod++) {
+        vector<size_t> ncoeffs(s._ncoeffs.begin(), s._ncoeffs.begin() + lod + 1);
+        vector<size_t> encoded_dims(s._encoded_dims.begin(), s._encoded_dims.begin() + lod + 1);
+
+        for (int level = 0; level < s._dims_at_level.size(); level++) {
+            int rc = ReconstructBlock(s._compressors[s._id], xcoeffs.data(), xdatarange, maps, s._xtype, ncoeffs, encoded_dims, block, vproduct(s._bs), level);
+            if (rc < 0) return (-1);
+
+            const vector<size_t> &dims = s._dims_at_level[level];
+            const vector<size_t> &bs = s._bs_at_level[level];
+
+            vector<size_t> count;
+            for (int i = 0; i < bs.size(); i++) { count.push_back(min(bs[i], dims[i] - bcoords[i] * bs[i])); }
+
+            T lo, hi;
+            BlockRange(block, bs, count, lo, hi);
+            ranges.push_back((double)lo);
+            ranges.push_back((double)hi);
+        }
+    }
+    return (0);
+}
+
+// Write the ranges computed by ReconstructBlockRanges() for a single
+// block to disk. The ranges for each level-of-detail are stored in the
+// range variable of the file holding that level-of-detail.
+//
+// varname : name of variable
+// ncdfcptrs : NetCDFCpp file points, one for each compression level
+// bcoords : coordinates of block in blocks
+// nlods : number of levels-of-detail in 'ranges'
+// ranges : block ranges
+//
+int StoreBlockRanges(string varname, vector<NetCDFCpp *> ncdfcptrs, vector<size_t> bcoords, size_t nlods, const vector<double> &ranges)
+{
+    size_t n = ranges.size() / nlods;
+
+    vector<size_t> start = bcoords;
+    start.push_back(0);
+
+    vector<size_t> count(start.size(), 1);
+    count[count.size() - 1] = n;
+
+    VAssert(ncdfcptrs.size() >= nlods);
+    for (int i = 0; i < nlods; i++) {
+        int rc = ncdfcptrs[i]->NetCDFCpp::PutVara(WASP::VarNameRange(varname), start, count, &ranges[i * n]);
+        if (rc < 0) return (rc);
+    }
+    return (0);
+}
+
 // Read a single block (no compression) from disk
 //
 // varname : name of variable
@@ -1088,12 +1316,25 @@ template<class T, class U> void *RunWriteThreadCompressedTemplate(thread_state &
         to_block_coords(start, s._bs, bcoords, residual);
         VAssert(residual == 0);
 
+        // Record the range of the block at every level-of-detail and
+        // refinement level. The original block is no longer needed and
+        // its storage is reused. Must precede StoreBlockCompressed(),
+        // which may byte swap the significance maps in place.
+        //
+        vector<double> ranges;
+        rc = ReconstructBlockRanges(s, bcoords, (const U *)s._coeffs, datarange, s._maps, (U *)s._block, ranges, dummy1);
+        if (rc < 0) {
+            s._status = -1;
+            break;
+        }
+
         // Write the transformed block to disk. Need a mutex because
         // NetCDF library is not thread safe
         //
         //
         s._et->MutexLock();
         rc = StoreBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+        if (rc >= 0) rc = StoreBlockRanges(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs.size(), ranges);
         if (rc < 0) { s._status = -1; }
         s._et->MutexUnlock();
         if (s._status < 0) break;
@@ -1212,7 +1453,9 @@ template<class T> void *RunReadThreadTemplate(thread_state &s, T dummy)
         // NetCDF API is not thread safe
         //
         s._et->MutexLock();
-        int rc = FetchBlock(s._varname, s._ncdfcptrs[0], bcoords, s._encoded_dims[0], blockptr);
+        double t0 = GetTime();
+        int    rc = FetchBlock(s._varname, s._ncdfcptrs[0], bcoords, s._encoded_dims[0], blockptr);
+        s._io_time += GetTime() - t0;
         if (rc < 0) s._status = -1;
         s._et->MutexUnlock();
         if (s._status < 0) break;
@@ -1291,7 +1534,9 @@ template<class T, class U> void *RunReadThreadCompressedTemplate(thread_state &s
         //
         U datarange[2];
         s._et->MutexLock();
-        int rc = FetchBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+        double t0 = GetTime();
+        int    rc = FetchBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+        s._io_time += GetTime() - t0;
         if (rc < 0) s._status = -1;
         s._et->MutexUnlock();
         if (s._status < 0) break;
@@ -1391,6 +1636,156 @@ void *RunReadThreadCompressed(void *arg)
     }
 }
 
+// Thread execution helper function for pipelined reads of compressed
+// data. Thread 0 is the I/O stage: it is the only thread that touches
+// NetCDF, so no mutex is needed around the fetch. All other threads
+// reconstruct and unblock.
+//
+template<class T, class U> void *RunReadThreadPipelinedTemplate(thread_state &s, T dummy1, U dummy2)
+{
+    read_pipeline<U> &pipe = *(read_pipeline<U> *)s._pipeline;
+    bool              unblock_flag = s._unblock_flag;    // Need to unblock data?
+    T *               data = (T *)s._data;
+
+    // Align start and count coordinates to block boundaries
+    //
+    vector<size_t> aligned_start;
+    vector<size_t> aligned_count;
+    block_align(s._start, s._count, s._bs, aligned_start, aligned_count);
+
+    vectorinc vec(aligned_start, aligned_count, s._udims, s._bs);
+
+    size_t n = vec.num();
+
+    if (s._id == 0) {
+        for (size_t i = 0; i < n; i++) {
+            int slot = pipe.acquire();
+            if (slot < 0) break;    // aborted
+
+            size_t         offset;
+            vector<size_t> start;
+            vec.ith(i, start, offset);
+
+            vector<size_t> bcoords;
+            size_t         residual;
+            to_block_coords(start, s._bs, bcoords, residual);
+            VAssert(residual == 0);
+
+            double t0 = GetTime();
+            int    rc = FetchBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, pipe.coeffs(slot), pipe.range(slot), pipe.maps(slot), s._xtype);
+            s._io_time += GetTime() - t0;
+            if (rc < 0) {
+                s._status = -1;
+                pipe.abort();
+                return (NULL);
+            }
+
+            pipe.push(slot, i);
+        }
+        pipe.finish();
+        return (NULL);
+    }
+
+    U *blockptr = (U *)s._block;
+
+    int    slot;
+    size_t i;
+    while (pipe.pop(slot, i)) {
+        size_t         offset;
+        vector<size_t> start;
+        vec.ith(i, start, offset);
+
+        // Transform from wavelet to physical space. The slot can be
+        // handed back to the I/O thread as soon as the coefficients
+        // have been consumed
+        //
+        int rc = ReconstructBlock(s._compressors[s._id], pipe.coeffs(slot), pipe.range(slot), pipe.maps(slot), s._xtype, s._ncoeffs, s._encoded_dims, blockptr, vproduct(s._bs), s._level);
+        pipe.release(slot);
+        if (rc < 0) {
+            s._status = -1;
+            pipe.abort();
+            break;
+        }
+
+        if (unblock_flag) {
+            // Transform coordinates from global to the region-of-interest
+            //
+            vector<size_t> roi_start = vector_sub(start, aligned_start);
+            vector<size_t> roi_origin = vector_sub(s._start, aligned_start);
+
+            UnBlock(blockptr, s._bs, data, s._count, roi_origin, roi_start);
+        } else {
+            // Don't unblock. Just copy.
+            //
+            size_t offset = vproduct(s._bs) * i;
+            for (size_t j = 0; j < vproduct(s._bs); j++) { data[offset + j] = (T)blockptr[j]; }
+        }
+    }
+    return (NULL);
+}
+
+void *RunReadThreadPipelined(void *arg)
+{
+    thread_state &s = *(thread_state *)arg;
+
+    VAssert(s._block_type == NC_INT64 || s._block_type == NC_DOUBLE);
+
+    switch (s._data_type) {
+    case NC_FLOAT: {
+        float dummy1 = 0.0;
+        if (s._block_type == NC_INT64) {
+            long dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        } else {
+            double dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        }
+    }
+    case NC_DOUBLE: {
+        double dummy1 = 0.0;
+        if (s._block_type == NC_INT64) {
+            long dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        } else {
+            double dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        }
+    }
+    case NC_INT: {
+        int dummy1 = 0;
+        if (s._block_type == NC_INT64) {
+            long dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        } else {
+            double dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        }
+    }
+    case NC_SHORT: {
+        int16_t dummy1 = 0;
+        if (s._block_type == NC_INT64) {
+            long dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        } else {
+            double dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        }
+    }
+    case NC_BYTE:
+    case NC_UBYTE: {
+        int8_t dummy1 = 0;
+        if (s._block_type == NC_INT64) {
+            long dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        } else {
+            double dummy2 = 0;
+            return (RunReadThreadPipelinedTemplate(s, dummy1, dummy2));
+        }
+    }
+    default: VAssert(0); return (NULL);
+    }
+}
+
 };    // namespace
 
 WASP::WASP(int nthreads)
@@ -1414,6 +1809,11 @@ WASP::WASP(int nthreads)
     _open_write = false;
     _open_varname.clear();
 
+    _read_nblocks = 0;
+    _read_nbytes = 0;
+    _read_io_time = 0.0;
+    _read_time = 0.0;
+
     _et = NULL;
 
     // Set up execution threads for parallel execution
@@ -1725,6 +2125,33 @@ int WASP::DefVar(string name, int xtype, vector<string> dimnames, string wname,
         if (rc < 0) return (rc);
     }
 
+    // Compressed variables have a companion variable in each file storing
+    // the min and max of every block, as reconstructed at each refinement
+    // level for the level-of-detail held by that file
+    //
+    if (!wname.empty()) {
+        Compressor cmp(compressor_bs(bs), wname);
+
+        ostringstream oss;
+        oss << "WASP.Range" << 2 * (cmp.GetNumLevels() + 1);
+        string rdimname = oss.str();
+
+        size_t len;
+        rc = _InqDimlen(rdimname, len);
+        if (len == 0) {
+            rc = WASP::DefDim(rdimname, 2 * (cmp.GetNumLevels() + 1));
+            if (rc < 0) return (rc);
+        }
+
+        vector<string> newdimnames = cdimnames;
+        newdimnames.push_back(rdimname);
+
+        for (int i = 0; i < encoded_dim_names.size(); i++) {
+            rc = _ncdfcptrs[i]->NetCDFCpp::DefVar(VarNameRange(name), NC_DOUBLE, newdimnames);
+            if (rc < 0) return (rc);
+        }
+    }
+
     // Attributes needed to encode or decode the variable later
     //
 
@@ -1791,6 +2218,22 @@ int WASP::InqVarDims(string name, vector<string> &dimnames, vector<size_t> &dims
     return (NC_NOERR);
 }
 
+int WASP::InqVarnames(vector<string> &varnames) const
+{
+    vector<string> allnames;
+    int            rc = NetCDFCpp::InqVarnames(allnames);
+    if (rc < 0) return (rc);
+
+    varnames.clear();
+    for (int i = 0; i < allnames.size(); i++) {
+        bool is_range = false;
+        for (int j = 0; j < allnames.size() && !is_range; j++) { is_range = allnames[i] == VarNameRange(allnames[j]); }
+
+        if (!is_range) varnames.push_back(allnames[i]);
+    }
+    return (NC_NOERR);
+}
+
 int WASP::InqVarCompressionParams(string name, string &wname, vector<size_t> &bs, vector<size_t> &cratios) const
 {
     wname.clear();
@@ -2326,6 +2769,21 @@ template<class T, class U> int WASP::_PutVara(vector<size_t> start, vector<size_
                                                   maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), 0, true));
     }
 
+    // Block ranges are recorded at every refinement level
+    //
+    if (!_open_wname.empty()) {
+        int nlevels = _open_compressors[0]->GetNumLevels();
+
+        vector<vector<size_t>> dims_at_level(nlevels + 1);
+        vector<vector<size_t>> bs_at_level(nlevels + 1);
+        for (int l = 0; l <= nlevels; l++) { _dims_at_level(_open_udims, _open_bs, l, _open_wname, dims_at_level[l], bs_at_level[l]); }
+
+        for (int i = 0; i < argvec.size(); i++) {
+            ((thread_state *)argvec[i])->_dims_at_level = dims_at_level;
+            ((thread_state *)argvec[i])->_bs_at_level = bs_at_level;
+        }
+    }
+
     if (_nthreads == 1) {
         if (_open_wname.empty()) {
             RunWriteThread(argvec[0]);
@@ -2502,8 +2960,19 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
         return (-1);
     }
 
+    double t0 = GetTime();
+
     size_t block_size = vproduct(bs_at_level);
 
+    // Compressed, multi-threaded reads are pipelined: one thread fetches
+    // blocks from disk into a bounded queue of 'nslots' buffers, the
+    // others reconstruct them. Two slots per worker keep the workers
+    // busy while the I/O thread is blocked on the next read.
+    //
+    bool pipelined = !_open_wname.empty() && _nthreads > 1;
+    int  nslots = pipelined ? 2 * (_nthreads - 1) : _nthreads;
+    int  nbufs = max(nslots, _nthreads);
+
     // Need temporary space for storing reconstructed data
     //
     U *block = NULL;
@@ -2522,11 +2991,11 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
         }
 
         coeffs_size = vsum(ncoeffs);
-        coeffs = (U *)_coeffbuf.Alloc(coeffs_size * _nthreads * sizeof(U));
+        coeffs = (U *)_coeffbuf.Alloc(coeffs_size * nbufs * sizeof(U));
 
         maps_size = vsum(encoded_dims) - vsum(ncoeffs);
         maps_size -= BLK_HDR_SZ;
-        maps = (unsigned char *)_sigbuf.Alloc(maps_size * _nthreads * NetCDFCpp::SizeOf(_open_varxtype));
+        maps = (unsigned char *)_sigbuf.Alloc(maps_size * nbufs * NetCDFCpp::SizeOf(_open_varxtype));
     }
 
     // Ugh. Can't preserve type in thread_state, which has to be passed
@@ -2535,6 +3004,8 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
     int data_type = _NetCDFType(*data);
     int block_type = _NetCDFType(*block);
 
+    read_pipeline<U> pipe(nslots, coeffs, coeffs_size, maps, maps_size * NetCDFCpp::SizeOf(_open_varxtype));
+
     //
     // Set up thread state for parallel (threaded) execution
     //
@@ -2545,6 +3016,7 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
         argvec.push_back((void *)new thread_state(i, _et, _nthreads, _open_varname, _ncdfcptrs, start, count, bs_at_level, dims_at_level, ncoeffs, encoded_dims, _open_compressors, data, data_type,
                                                   NULL, blkptr, coeffs + i * coeffs_size, block_type, _open_varxtype, maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), _open_level,
                                                   unblock_flag));
+        ((thread_state *)argvec[i])->_pipeline = &pipe;
     }
 
     if (_nthreads == 1) {
@@ -2557,17 +3029,38 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
         int rc;
         if (_open_wname.empty()) {
             rc = _et->ParRun(RunReadThread, argvec);
+        } else if (pipelined) {
+            rc = _et->ParRun(RunReadThreadPipelined, argvec);
         } else {
             rc = _et->ParRun(RunReadThreadCompressed, argvec);
         }
         if (rc < 0) {
+            for (int i = 0; i < argvec.size(); i++) delete (thread_state *)argvec[i];
             SetErrMsg("Error spawning threads");
             return (-1);
         }
     }
 
+    // Gather throughput statistics. Bytes are those of the blocks as
+    // stored on disk
+    //
+    vector<size_t> aligned_start;
+    vector<size_t> aligned_count;
+    block_align(start, count, bs_at_level, aligned_start, aligned_count);
+
+    _read_nblocks = vproduct(aligned_count) / block_size;
+    _read_nbytes = _read_nblocks * NetCDFCpp::SizeOf(_open_varxtype) * (_open_wname.empty() ? block_size : vsum(encoded_dims));
+    _read_io_time = 0.0;
+    for (int i = 0; i < argvec.size(); i++) _read_io_time += ((thread_state *)argvec[i])->_io_time;
+    _read_time = GetTime() - t0;
+
     for (int i = 0; i < argvec.size(); i++) delete (thread_state *)argvec[i];
 
+    if (_read_time > 0.0) {
+        SetDiagMsg("WASP::_GetVara(%s) : %zu blocks, %.2f MB, %.3f s (%.3f s I/O), %.2f MB/s", _open_varname.c_str(), _read_nblocks, (double)_read_nbytes / (1024.0 * 1024.0), _read_time, _read_io_time,
+                   (double)_read_nbytes / (1024.0 * 1024.0) / _read_time);
+    }
+
     return (thread_state::_status);
 }
 
@@ -2685,6 +3178,78 @@ int WASP::GetVara(vector<size_t> start, vector<size_t> count, unsigned char *dat
 
 int WASP::GetVaraBlock(vector<size_t> start, vector<size_t> count, unsigned char *data) { return (WASP::_GetVara(start, count, false, data)); }
 
+int WASP::GetVaraRange(vector<size_t> start, vector<size_t> count, vector<double> &range)
+{
+    range.clear();
+
+    if (!_waspFile) {
+        SetErrMsg("Not a WASP file");
+        return (-1);
+    }
+
+    if (!_open || _open_write) {
+        SetErrMsg("Invalid state");
+        return (-1);
+    }
+
+    // Only compressed blocks carry a header with the data range
+    //
+    if (!_open_waspvar || _open_wname.empty()) return (0);
+
+    vector<size_t> dims_at_level;
+    vector<size_t> bs_at_level;
+    _dims_at_level(_open_udims, _open_bs, _open_level, _open_wname, dims_at_level, bs_at_level);
+
+    if (!_validate_get_vara_compressed(start, count, bs_at_level, dims_at_level, _open_cratios, true)) {
+        SetErrMsg("Invalid parameter");
+        return (-1);
+    }
+
+    // Files written before block ranges were recorded lack the range
+    // variable. Disable error reporting while checking for it.
+    //
+    if (_open_lod >= _ncdfcptrs.size()) return (0);
+
+    string     rvarname = VarNameRange(_open_varname);
+    NetCDFCpp *ncdfcptr = _ncdfcptrs[_open_lod];
+
+    bool enabled = MyBase::EnableErrMsg(false);
+    int  varid;
+    int  rc = ncdfcptr->NetCDFCpp::InqVarid(rvarname, varid);
+    (void)MyBase::EnableErrMsg(enabled);
+    if (rc < 0) return (0);
+
+    vector<size_t> aligned_start;
+    vector<size_t> aligned_count;
+    block_align(start, count, bs_at_level, aligned_start, aligned_count);
+
+    // The ranges of all blocks in the region at the opened refinement
+    // level form a single hyperslab: one element per block along each
+    // dimension, followed by the min and max for the level
+    //
+    vector<size_t> hstart, hcount;
+    for (int i = 0; i < aligned_start.size(); i++) {
+        hstart.push_back(aligned_start[i] / bs_at_level[i]);
+        hcount.push_back(aligned_count[i] / bs_at_level[i]);
+    }
+    hstart.push_back(2 * _open_level);
+    hcount.push_back(2);
+
+    vector<double> ranges(vproduct(hcount));
+    rc = ncdfcptr->NetCDFCpp::GetVara(rvarname, hstart, hcount, ranges.data());
+    if (rc < 0) return (rc);
+
+    double min = ranges[0];
+    double max = ranges[1];
+    for (size_t i = 0; i < ranges.size(); i += 2) {
+        if (ranges[i] < min) min = ranges[i];
+        if (ranges[i + 1] > max) max = ranges[i + 1];
+    }
+    range = {min, max};
+
+    return (1);
+}
+
 int WASP::GetVar(unsigned char *data)
 {
     if (!_open_waspvar) { return (NetCDFCpp::GetVar(_open_varname, data)); }
@@ -0,0 +1,417 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/Advection.h>
+
+using namespace Wasp;
+
+// Count the bytes allocated with operator new, to measure the memory
+// held by the trajectories
+//
+namespace {
+size_t       liveBytes = 0;
+const size_t header = 16;
+}    // namespace
+
+void *operator new(size_t n)
+{
+    char *p = (char *)malloc(n + header);
+    if (!p) throw std::bad_alloc();
+    *(size_t *)p = n;
+    liveBytes += n;
+    return (p + header);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p) return;
+    char *h = (char *)p - header;
+    liveBytes -= *(size_t *)h;
+    free(h);
+}
+
+struct {
+    int                     nseeds;
+    double                  time;
+    int                     nstreams;
+    int                     nsteps;
+    int                     nprops;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nseeds", 1, "100", "Number of seeds for the accuracy test"},
+                                         {"time", 1, "10.0", "Integration time for the accuracy test"},
+                                         {"nstreams", 1, "20000", "Number of streams for the storage test"},
+                                         {"nsteps", 1, "200", "Number of steps per stream for the storage test"},
+                                         {"nprops", 1, "3", "Number of properties for the storage test"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nseeds", Wasp::CvtToInt, &opt.nseeds, sizeof(opt.nseeds)},
+                                        {"time", Wasp::CvtToDouble, &opt.time, sizeof(opt.time)},
+                                        {"nstreams", Wasp::CvtToInt, &opt.nstreams, sizeof(opt.nstreams)},
+                                        {"nsteps", Wasp::CvtToInt, &opt.nsteps, sizeof(opt.nsteps)},
+                                        {"nprops", Wasp::CvtToInt, &opt.nprops, sizeof(opt.nprops)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// A field of circular motion about the Z axis, with an analytic solution.
+// The angular speed of a particle depends on its radius and on time, so the
+// flow is faster near the axis and speeds up and slows down over time. The
+// field counts its velocity queries.
+//
+class VortexField : public flow::Field {
+public:
+    mutable std::atomic<long> NumQueries;
+
+    VortexField() : NumQueries(0) { IsSteady = false; }
+
+    bool InsideVolumeVelocity(double time, const glm::vec3 &pos) const override
+    {
+        return (std::abs(pos.x) <= 2.0f && std::abs(pos.y) <= 2.0f && std::abs(pos.z) <= 2.0f);
+    }
+    bool InsideVolumeScalar(double time, const glm::vec3 &pos) const override { return (InsideVolumeVelocity(time, pos)); }
+    int  GetNumberOfTimesteps() const override { return (1); }
+    int  GetScalar(double time, const glm::vec3 &pos, float &scalar) const override
+    {
+        scalar = pos.x * (float)ScalarName.size() + pos.y;
+        return (0);
+    }
+    int GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &vel) const override
+    {
+        NumQueries++;
+        if (!InsideVolumeVelocity(time, pos)) return (flow::MISSING_VAL);
+
+        double r2 = (double)pos.x * pos.x + (double)pos.y * pos.y;
+        double w = omega(r2) * speed(time);
+        vel = glm::vec3(-w * pos.y, w * pos.x, 0.0f);
+        return (0);
+    }
+    auto LockParams() -> int override { return (0); }
+    auto UnlockParams() -> int override { return (0); }
+
+    // Exact location at time t of a particle released at p at time 0
+    glm::vec3 Exact(const glm::vec3 &p, double t) const
+    {
+        double r2 = (double)p.x * p.x + (double)p.y * p.y;
+        double a = omega(r2) * (t + 0.5 * (1.0 - cos(t)));    // integral of speed() from 0 to t
+        return (glm::vec3(p.x * cos(a) - p.y * sin(a), p.x * sin(a) + p.y * cos(a), p.z));
+    }
+
+private:
+    static double omega(double r2) { return (0.5 / (r2 + 0.05)); }
+    static double speed(double t) { return (1.0 + 0.5 * sin(t)); }
+};
+
+vector<flow::Particle> make_seeds(int n)
+{
+    vector<flow::Particle> seeds;
+    srand(1);
+    for (int i = 0; i < n; i++) {
+        double r = 0.1 + 1.4 * rand() / (double)RAND_MAX;
+        double a = 2.0 * M_PI * rand() / (double)RAND_MAX;
+        seeds.emplace_back(r * cos(a), r * sin(a), 0.0, 0.0);
+    }
+    return (seeds);
+}
+
+// Advect the seeds to the end time, and return the largest distance of any
+// particle from its exact location, and the number of velocity queries per
+// particle
+//
+void run(flow::Advection::ADVECTION_METHOD method, double deltaT, double tol, double &maxErr, double &queries)
+{
+    VortexField            field;
+    vector<flow::Particle> seeds = make_seeds(opt.nseeds);
+
+    flow::Advection advection;
+    advection.SetNumberOfThreads(1);
+    advection.SetTolerances(tol * 4.0, tol);
+    advection.UseSeedParticles(seeds);
+    advection.AdvectTillTime(&field, 0.0, deltaT, opt.time, method);
+
+    const flow::Trajectories &traj = advection.GetTrajectories();
+    maxErr = 0.0;
+    for (size_t i = 0; i < traj.GetNumberOfStreams(); i++) {
+        size_t    last = traj.GetStreamOffset(i) + traj.GetStreamSize(i) - 1;
+        double    time = traj.GetTimes()[last];
+        glm::vec3 exact = field.Exact(seeds[i].location, time);
+        glm::vec3 d = traj.GetLocations()[last] - exact;
+        double    err = sqrt((double)d.x * d.x + (double)d.y * d.y + (double)d.z * d.z);
+        if (time < opt.time) err = HUGE_VAL;    // the particle left the domain
+        maxErr = std::max(maxErr, err);
+    }
+    queries = (double)field.NumQueries / seeds.size();
+}
+
+// Compare the columnar trajectories of an Advection with the same samples
+// kept as vectors of Particles, each with a list of properties. Both must
+// hold the same values.
+//
+bool storage()
+{
+    VortexField field;
+    field.IsSteady = true;
+
+    size_t          bytes0 = liveBytes;
+    double          t0 = Wasp::GetTime();
+    flow::Advection advection;
+    advection.SetNumberOfThreads(1);
+    advection.UseSeedParticles(make_seeds(opt.nstreams));
+    advection.AdvectSteps(&field, 0.01, opt.nsteps, flow::Advection::ADVECTION_METHOD::RK4);
+    double advectTime = Wasp::GetTime() - t0;
+
+    t0 = Wasp::GetTime();
+    for (int k = 0; k < opt.nprops; k++) {
+        field.ScalarName = "prop" + std::to_string(k);
+        advection.CalculateParticleProperties(&field);
+    }
+    double columnsTime = Wasp::GetTime() - t0;
+    size_t columnsBytes = liveBytes - bytes0;
+
+    // The same samples as vectors of Particles
+    //
+    const flow::Trajectories &traj = advection.GetTrajectories();
+    bytes0 = liveBytes;
+    t0 = Wasp::GetTime();
+    vector<vector<flow::Particle>> streams(traj.GetNumberOfStreams());
+    for (size_t s = 0; s < streams.size(); s++) {
+        for (size_t i = 0; i < traj.GetStreamSize(s); i++) {
+            const flow::Particle &p = traj.GetParticle(traj.GetStreamOffset(s) + i);
+            streams[s].emplace_back(p.location, p.time, p.value);
+        }
+    }
+    for (int k = 0; k < opt.nprops; k++) {
+        field.ScalarName = "prop" + std::to_string(k);
+        for (auto &stream : streams) {
+            for (auto &p : stream) {
+                float v = std::nanf("1");
+                if (!p.IsSpecial()) field.GetScalar(p.time, p.location, v);
+                p.AttachProperty(v);
+            }
+        }
+    }
+    double particlesTime = Wasp::GetTime() - t0;
+    size_t particlesBytes = liveBytes - bytes0;
+
+    // Read every property of every sample, as when writing the flow lines out
+    //
+    t0 = Wasp::GetTime();
+    double columnsSum = 0.0;
+    for (size_t s = 0; s < traj.GetNumberOfStreams(); s++) {
+        size_t begin = traj.GetStreamOffset(s), end = begin + traj.GetStreamSize(s);
+        for (size_t i = begin; i < end; i++) {
+            if (traj.IsSpecial(i)) continue;
+            for (int k = 0; k < opt.nprops; k++) columnsSum += traj.GetProperty(k)[i];
+        }
+    }
+    double columnsRead = Wasp::GetTime() - t0;
+
+    t0 = Wasp::GetTime();
+    double particlesSum = 0.0;
+    for (const auto &stream : streams) {
+        for (const auto &p : stream) {
+            if (p.IsSpecial()) continue;
+            for (float v : p.GetPropertyList()) particlesSum += v;
+        }
+    }
+    double particlesRead = Wasp::GetTime() - t0;
+
+    size_t n = traj.GetNumberOfSamples();
+    printf("\n%lu samples in %lu streams, advected in %.3f sec\n", n, traj.GetNumberOfStreams(), advectTime);
+    printf("%-10s %12s %14s %14s\n", "Storage", "bytes/sample", "fill (Msamp/s)", "read (Msamp/s)");
+    printf("%-10s %12.1f %14.2f %14.2f\n", "columns", (double)columnsBytes / n, n / columnsTime / 1e6, n / columnsRead / 1e6);
+    printf("%-10s %12.1f %14.2f %14.2f\n", "particles", (double)particlesBytes / n, n / particlesTime / 1e6, n / particlesRead / 1e6);
+
+    if (columnsSum != particlesSum) {
+        cout << "Property values differ " << columnsSum << " " << particlesSum << endl;
+        return (false);
+    }
+    return (true);
+}
+
+// A time varying drift through the unit cube, which particles leave
+// through its sides unless they are periodic. The velocity is defined
+// outside of the cube too, so that a step can end outside of it and the
+// particle be wrapped at the start of the next time step.
+//
+class DriftField : public flow::Field {
+public:
+    DriftField() { IsSteady = false; }
+
+    bool InsideVolumeVelocity(double time, const glm::vec3 &pos) const override
+    {
+        return (pos.x >= 0.0f && pos.x <= 1.0f && pos.y >= 0.0f && pos.y <= 1.0f && pos.z >= 0.0f && pos.z <= 1.0f);
+    }
+    bool InsideVolumeScalar(double time, const glm::vec3 &pos) const override { return (InsideVolumeVelocity(time, pos)); }
+    int  GetNumberOfTimesteps() const override { return (10); }
+    int  GetScalar(double time, const glm::vec3 &pos, float &scalar) const override
+    {
+        scalar = pos.x;
+        return (0);
+    }
+    int GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &vel) const override
+    {
+        vel = glm::vec3(0.3 + 0.1 * sin(time), 0.2 * cos(3.0 * pos.x + time), 0.05);
+        return (0);
+    }
+    auto LockParams() -> int override { return (0); }
+    auto UnlockParams() -> int override { return (0); }
+};
+
+// Advect to time step ts the way FlowRenderer does, one time step at a
+// time, skipping the ones already advected
+//
+void advect_to(flow::Advection &advection, flow::Field *field, int ts, flow::Advection::ADVECTION_METHOD method)
+{
+    for (int i = 1; i <= ts; i++) {
+        if (i <= advection.GetFrontierTime()) continue;
+        advection.AdvectTillTime(field, i - 1, 0.05, i, method);
+    }
+}
+
+bool same_streams(const flow::Advection &a, const flow::Advection &b)
+{
+    const flow::Trajectories &ta = a.GetTrajectories();
+    const flow::Trajectories &tb = b.GetTrajectories();
+    if (ta.GetNumberOfStreams() != tb.GetNumberOfStreams()) return (false);
+
+    for (size_t s = 0; s < ta.GetNumberOfStreams(); s++) {
+        if (ta.GetStreamSize(s) != tb.GetStreamSize(s)) return (false);
+
+        size_t ia = ta.GetStreamOffset(s);
+        size_t ib = tb.GetStreamOffset(s);
+        for (size_t i = 0; i < ta.GetStreamSize(s); i++, ia++, ib++) {
+            if (ta.IsSpecial(ia) != tb.IsSpecial(ib)) return (false);
+            if (ta.IsSpecial(ia)) continue;    // separators have no time
+            if (ta.GetTimes()[ia] != tb.GetTimes()[ib]) return (false);
+            if (ta.GetLocations()[ia] != tb.GetLocations()[ib]) return (false);
+        }
+    }
+    return (true);
+}
+
+// Step back and forth through the time steps, rewinding and extending
+// the same streams as FlowRenderer does, and compare them with streams
+// advected from the seeds at every step. They must be identical.
+//
+bool rewind()
+{
+    DriftField             field;
+    vector<flow::Particle> seeds;
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) seeds.emplace_back(0.05 * i, 0.05 * j, 0.5, (i % 3) * 1.0);
+    }
+
+    const flow::Advection::ADVECTION_METHOD methods[] = {flow::Advection::ADVECTION_METHOD::RK4, flow::Advection::ADVECTION_METHOD::RK45};
+    const int                               path[] = {3, 7, 5, 9, 2, 0, 6, 8, 1, 9};
+
+    bool ok = true;
+    for (auto method : methods) {
+        for (int periodic = 0; periodic < 2; periodic++) {
+            auto setup = [&](flow::Advection &advection) {
+                advection.UseSeedParticles(seeds);
+                advection.SetXPeriodicity(periodic, 0.0f, 1.0f);
+                advection.SetYPeriodicity(periodic, 0.0f, 1.0f);
+            };
+
+            flow::Advection incremental;
+            setup(incremental);
+            for (int ts : path) {
+                if (incremental.GetFrontierTime() > ts) incremental.RewindToTime(ts);
+                advect_to(incremental, &field, ts, method);
+
+                flow::Advection fresh;
+                setup(fresh);
+                advect_to(fresh, &field, ts, method);
+
+                if (!same_streams(incremental, fresh)) {
+                    printf("Rewound streams differ at time step %d (%s, %s)\n", ts, method == flow::Advection::ADVECTION_METHOD::RK4 ? "RK4" : "RK45",
+                           periodic ? "periodic" : "not periodic");
+                    ok = false;
+                }
+            }
+        }
+    }
+    return (ok);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+
+    printf("%-6s %10s %12s %12s\n", "Method", "Parameter", "Queries", "Max error");
+
+    // RK4 over a range of nominal step sizes
+    //
+    vector<double> rk4Err, rk4Queries;
+    for (double deltaT = 0.2; deltaT > 0.001; deltaT /= 2.0) {
+        double err, queries;
+        run(flow::Advection::ADVECTION_METHOD::RK4, deltaT, 0.0, err, queries);
+        printf("%-6s %10.4f %12.0f %12.3e\n", "RK4", deltaT, queries, err);
+        rk4Err.push_back(err);
+        rk4Queries.push_back(queries);
+    }
+
+    // RK45 over a range of tolerances. The error must shrink with the
+    // tolerance, and no RK4 run may reach the same accuracy for fewer queries.
+    //
+    double lastErr = HUGE_VAL;
+    for (double tol = 1e-3; tol > 1e-7; tol /= 10.0) {
+        double err, queries;
+        run(flow::Advection::ADVECTION_METHOD::RK45, 0.2, tol, err, queries);
+        printf("%-6s %10.0e %12.0f %12.3e\n", "RK45", tol, queries, err);
+
+        if (err == HUGE_VAL) continue;
+        if (err > lastErr) {
+            cout << "Error grew as the tolerance shrank" << endl;
+            ok = false;
+        }
+        lastErr = err;
+
+        for (size_t i = 0; i < rk4Err.size(); i++) {
+            if (rk4Err[i] <= err && rk4Queries[i] < queries) {
+                cout << "RK4 is cheaper at a tolerance of " << tol << endl;
+                ok = false;
+            }
+        }
+    }
+
+    ok = storage() && ok;
+    ok = rewind() && ok;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
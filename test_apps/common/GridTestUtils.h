@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <vapor/VAssert.h>
+
+// Helpers shared by the grid test programs
+//
+namespace GridTestUtils {
+
+// Allocate the blocks for a grid with dimensions \p dims and block size
+// \p bs. Grids don't own their blocks, so the memory is held here until
+// the program exits.
+//
+inline std::vector<float *> alloc_blocks(const std::vector<size_t> &bs, const std::vector<size_t> &dims)
+{
+    static std::vector<std::unique_ptr<float[]>> heap;
+
+    size_t block_size = 1;
+    size_t nblocks = 1;
+
+    for (int i = 0; i < bs.size(); i++) {
+        block_size *= bs[i];
+
+        VAssert(dims[i] > 0);
+        size_t nb = ((dims[i] - 1) / bs[i]) + 1;
+
+        nblocks *= nb;
+    }
+
+    float *buf = new float[nblocks * block_size];
+    heap.emplace_back(buf);
+
+    std::vector<float *> blks;
+    for (int i = 0; i < nblocks; i++) { blks.push_back(buf + i * block_size); }
+
+    return (blks);
+}
+
+}    // namespace GridTestUtils
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/Compressor.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    std::vector<size_t>     dims;
+    std::vector<string>     wnames;
+    string                  iwname;
+    std::vector<int>        cratios;
+    int                     nlevels;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dims", 1, "64:64:64",
+                                          "Colon delimited 3-element vector "
+                                          "specifying signal dimensions"},
+                                         {"wnames", 1, "bior1.1:bior4.4", "Colon delimited list of wavelets"},
+                                         {"iwname", 1, "intbior2.2", "Wavelet for integer data"},
+                                         {"cratios", 1, "500:100:10:1", "Colon delimited list of compression ratios"},
+                                         {"nlevels", 1, "16",
+                                          "Number of distinct data values. Few values give many "
+                                          "coefficients of equal magnitude"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"wnames", Wasp::CvtToStrVec, &opt.wnames, sizeof(opt.wnames)},
+                                        {"iwname", Wasp::CvtToCPPStr, &opt.iwname, sizeof(opt.iwname)},
+                                        {"cratios", Wasp::CvtToIntVec, &opt.cratios, sizeof(opt.cratios)},
+                                        {"nlevels", Wasp::CvtToInt, &opt.nlevels, sizeof(opt.nlevels)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Coefficient selection as Compress() and Decompose() did it before
+// select_template(): sort pointers to the coefficients by decreasing
+// magnitude, hand out consecutive ranges to the bands, and sort each
+// range by address. std::sort() left the order of equal magnitudes
+// unspecified, std::stable_sort() fixes it to increasing index, which
+// is the order the new selection documents.
+//
+template<class T> void reference(const vector<T> &C, size_t numkeep, const vector<size_t> &lens, vector<T> &dst, vector<vector<size_t>> &sigs)
+{
+    vector<const T *> indexvec;
+    for (size_t i = numkeep; i < C.size(); i++) indexvec.push_back(&C[i]);
+    std::stable_sort(indexvec.begin(), indexvec.end(), [](const T *a, const T *b) { return (std::abs((double)*a) > std::abs((double)*b)); });
+
+    dst.clear();
+    sigs.assign(lens.size(), vector<size_t>());
+    for (size_t i = 0; i < numkeep; i++) {
+        dst.push_back(C[i]);
+        sigs[0].push_back(i);
+    }
+
+    size_t first = 0;
+    for (size_t j = 0; j < lens.size(); j++) {
+        size_t len = j == 0 ? lens[j] - numkeep : lens[j];
+        size_t last = std::min(first + len, indexvec.size());
+        std::sort(indexvec.begin() + first, indexvec.begin() + last);
+        for (size_t i = first; i < last; i++) {
+            dst.push_back(*indexvec[i]);
+            sigs[j].push_back(indexvec[i] - C.data());
+        }
+        first = last;
+    }
+}
+
+vector<size_t> entries(SignificanceMap &sigmap)
+{
+    vector<size_t> idx(sigmap.GetNumSignificant());
+    sigmap.GetNextEntryRestart();
+    for (size_t i = 0; i < idx.size(); i++) sigmap.GetNextEntry(&idx[i]);
+    return (idx);
+}
+
+// Compress and decompose a field with Compressor, and with the
+// reference selection applied to the same wavelet coefficients. The
+// coefficients and significance maps must be identical.
+//
+template<class T> bool test(string tname, string wname, bool keepapp)
+{
+    Compressor cmp(opt.dims, wname);
+    cmp.KeepAppOnOff() = keepapp;
+
+    size_t n = opt.dims[0] * opt.dims[1] * opt.dims[2];
+    size_t clen = cmp.GetNumWaveCoeffs();
+
+    // A blocky field with few distinct values
+    //
+    vector<T> src(n);
+    for (size_t k = 0, l = 0; k < opt.dims[2]; k++) {
+        for (size_t j = 0; j < opt.dims[1]; j++) {
+            for (size_t i = 0; i < opt.dims[0]; i++, l++) {
+                double v = sin(i * 0.05) * cos(j * 0.07) + 0.5 * sin(k * 0.11);
+                src[l] = (T)floor((v + 1.5) / 3.0 * opt.nlevels);
+            }
+        }
+    }
+
+    // With every coefficient kept, Compress() returns all of them in
+    // index order
+    //
+    vector<T>       C(clen);
+    SignificanceMap sigmap;
+    if (cmp.Compress(src.data(), C.data(), clen, &sigmap) < 0) return (false);
+
+    size_t numkeep = keepapp ? cmp.GetMinCompression() : 0;
+
+    vector<size_t> lens;
+    size_t         tlen = 0;
+    for (auto cr : opt.cratios) {
+        size_t len = std::max(n / cr, numkeep);
+        if (len > clen) len = clen;
+        len -= std::min(len, tlen);
+        if (!len) continue;
+        lens.push_back(len);
+        tlen += len;
+    }
+
+    // Number of coefficients of the same magnitude as another one
+    //
+    vector<double> mags;
+    for (size_t i = numkeep; i < clen; i++) mags.push_back(std::abs((double)C[i]));
+    std::sort(mags.begin(), mags.end());
+    size_t nties = 0;
+    for (size_t i = 1; i < mags.size(); i++) nties += mags[i] == mags[i - 1];
+
+    bool ok = true;
+
+    // Compress() at each compression ratio
+    //
+    for (auto cr : opt.cratios) {
+        size_t len = std::min(std::max(n / cr, numkeep), clen);
+
+        vector<T> dst(len);
+        if (cmp.Compress(src.data(), dst.data(), len, &sigmap) < 0) return (false);
+
+        vector<T>              ref;
+        vector<vector<size_t>> refsigs;
+        reference(C, numkeep, vector<size_t>(1, len), ref, refsigs);
+
+        if (dst != ref || entries(sigmap) != refsigs[0]) {
+            printf("%s %s keepapp=%d : Compress() differs at cratio %d\n", wname.c_str(), tname.c_str(), (int)keepapp, cr);
+            ok = false;
+        }
+    }
+
+    // Decompose() into all of the bands at once
+    //
+    vector<T>               dst(tlen);
+    vector<SignificanceMap> sigmaps(lens.size());
+    if (cmp.Decompose(src.data(), dst.data(), lens, sigmaps) < 0) return (false);
+
+    vector<T>              ref;
+    vector<vector<size_t>> refsigs;
+    reference(C, numkeep, lens, ref, refsigs);
+
+    bool same = dst == ref;
+    for (size_t j = 0; j < lens.size(); j++) same = same && entries(sigmaps[j]) == refsigs[j];
+    if (!same) {
+        printf("%s %s keepapp=%d : Decompose() differs\n", wname.c_str(), tname.c_str(), (int)keepapp);
+        ok = false;
+    }
+
+    printf("%-10s %-6s keepapp=%d coefficients %lu, equal magnitudes %lu\n", wname.c_str(), tname.c_str(), (int)keepapp, clen, nties);
+
+    return (ok);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.dims.size() == 3);
+    VAssert(opt.nlevels > 0);
+
+    bool ok = true;
+    for (int keepapp = 0; keepapp < 2; keepapp++) {
+        for (auto wname : opt.wnames) ok = test<float>("float", wname, keepapp) && ok;
+        ok = test<int>("int", opt.iwname, keepapp) && ok;
+    }
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
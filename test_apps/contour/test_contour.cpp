@@ -0,0 +1,239 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/RegularGrid.h>
+#include <vapor/ContourExtractor.h>
+#include <vapor/FileUtils.h>
+
+#include "GridTestUtils.h"
+
+using namespace Wasp;
+using namespace VAPoR;
+using GridTestUtils::alloc_blocks;
+
+struct {
+    std::vector<size_t>     bs;
+    std::vector<size_t>     dims;
+    int                     ncontours;
+    int                     nthreads;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"bs", 1, "64:64",
+                                          "Colon delimited 2-element vector "
+                                          "specifying block size"},
+                                         {"dims", 1, "2048:2048",
+                                          "Colon delimited 2-element vector "
+                                          "specifying grid dimensions"},
+                                         {"ncontours", 1, "32", "Number of contour values"},
+                                         {"nthreads", 1, "0",
+                                          "Number of threads. Zero uses the number "
+                                          "of hardware threads"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"bs", Wasp::CvtToSize_tVec, &opt.bs, sizeof(opt.bs)},
+                                        {"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"ncontours", Wasp::CvtToInt, &opt.ncontours, sizeof(opt.ncontours)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Segments of a single contour value, computed one cell at a time the
+// way the ContourRenderer used to. Cells with a node outside of the box
+// defined by minu and maxu are skipped.
+//
+void reference(const Grid *g, const vector<double> &minu, const vector<double> &maxu, float contour, vector<ContourExtractor::Vertex> &verts)
+{
+    verts.clear();
+
+    vector<size_t> cdims = g->GetCellDimensions();
+    float          mv = g->GetMissingValue();
+
+    vector<Size_tArr3> nodes(g->GetMaxVertexPerCell());
+    for (size_t j = 0; j < cdims[1]; j++) {
+        for (size_t i = 0; i < cdims[0]; i++) {
+            Size_tArr3 cell = {i, j, 0};
+            g->GetCellNodes(cell, nodes);
+
+            size_t        n = nodes.size();
+            vector<float> v(n);
+            bool          hasMissing = false;
+            for (size_t k = 0; k < n; k++) {
+                v[k] = g->GetValueAtIndex(nodes[k]);
+                if (v[k] == mv) hasMissing = true;
+            }
+            if (hasMissing) continue;
+
+            bool inside = true;
+            for (size_t k = 0; k < n; k++) {
+                DblArr3 c;
+                g->GetUserCoordinates(nodes[k], c);
+                for (size_t d = 0; d < minu.size(); d++) {
+                    if (c[d] < minu[d] || c[d] > maxu[d]) inside = false;
+                }
+            }
+            if (!inside) continue;
+
+            for (size_t a = n - 1, b = 0; b < n; a = b, b++) {
+                if ((v[a] <= contour && v[b] <= contour) || (v[a] > contour && v[b] > contour)) continue;
+
+                DblArr3 ca, cb;
+                g->GetUserCoordinates(nodes[a], ca);
+                g->GetUserCoordinates(nodes[b], cb);
+
+                float                     t = (contour - v[a]) / (v[b] - v[a]);
+                ContourExtractor::Vertex vert;
+                vert.x = ca[0] + t * (cb[0] - ca[0]);
+                vert.y = ca[1] + t * (cb[1] - ca[1]);
+                vert.z = 0.0;
+                vert.v = contour;
+                verts.push_back(vert);
+            }
+        }
+    }
+}
+
+bool same(const vector<ContourExtractor::Vertex> &a, const vector<ContourExtractor::Vertex> &b)
+{
+    if (a.size() != b.size()) return (false);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].z != b[i].z || a[i].v != b[i].v) return (false);
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.bs.size() == 2 && opt.dims.size() == 2);
+    VAssert(opt.ncontours > 0);
+
+    vector<float *> blks = alloc_blocks(opt.bs, opt.dims);
+    RegularGrid     rg(opt.dims, opt.bs, blks, vector<double>(2, 0.0), vector<double>(2, 1.0));
+
+    // A field with many closed isolines, and a hole of missing values
+    //
+    float mv = rg.GetMissingValue();
+    for (size_t j = 0; j < opt.dims[1]; j++) {
+        for (size_t i = 0; i < opt.dims[0]; i++) {
+            double x = (double)i / opt.dims[0];
+            double y = (double)j / opt.dims[1];
+            float  v = sin(12.0 * x) * cos(9.0 * y) + x * y;
+            if (fabs(x - 0.5) < 0.05 && fabs(y - 0.5) < 0.05) v = mv;
+            rg.SetValueIJK(i, j, 0, v);
+        }
+    }
+
+    float range[2];
+    rg.GetRange(range);
+
+    vector<double> contours;
+    for (int i = 0; i < opt.ncontours; i++) { contours.push_back(range[0] + (range[1] - range[0]) * (i + 0.5) / opt.ncontours); }
+
+    double t0 = Wasp::GetTime();
+
+    vector<vector<ContourExtractor::Vertex>> ref(contours.size());
+    for (size_t i = 0; i < contours.size(); i++) reference(&rg, vector<double>(), vector<double>(), contours[i], ref[i]);
+
+    double t1 = Wasp::GetTime();
+    cout << "Reference time : " << t1 - t0 << endl;
+
+    bool fail = false;
+
+    // All but the last value, then the last value on its own, which
+    // must leave the segments of the others in place
+    //
+    ContourExtractor ce(4, opt.nthreads);
+    vector<double>   first(contours.begin(), contours.end() - 1);
+
+    t0 = Wasp::GetTime();
+    ce.Extract("a", &rg, NULL, 0.0, vector<double>(), vector<double>(), first);
+    t1 = Wasp::GetTime();
+    cout << "Extraction time : " << t1 - t0 << endl;
+
+    vector<double> missing = ce.GetMissing("a", contours);
+    if (missing.size() != 1 || missing[0] != contours.back()) {
+        cout << "FAIL : missing contour values" << endl;
+        fail = true;
+    }
+
+    t0 = Wasp::GetTime();
+    ce.Extract("a", &rg, NULL, 0.0, vector<double>(), vector<double>(), contours);
+    t1 = Wasp::GetTime();
+    cout << "Extraction time (one added value) : " << t1 - t0 << endl;
+
+    size_t nverts = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        vector<ContourExtractor::Vertex> verts;
+        ce.GetSegments("a", vector<double>(1, contours[i]), verts);
+        if (!same(verts, ref[i])) {
+            cout << "FAIL : segments of contour " << contours[i] << " differ" << endl;
+            fail = true;
+        }
+        nverts += verts.size();
+    }
+    cout << "Segments : " << nverts / 2 << endl;
+
+    if (!ce.GetMissing("a", contours).empty()) {
+        cout << "FAIL : contour values not cached" << endl;
+        fail = true;
+    }
+
+    // Segments must stay within a box smaller than the grid
+    //
+    vector<double> minu = {0.3, 0.2};
+    vector<double> maxu = {0.7, 0.6};
+    ce.Extract("b", &rg, NULL, 0.0, minu, maxu, contours);
+
+    size_t nboxverts = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        vector<ContourExtractor::Vertex> verts, boxRef;
+        reference(&rg, minu, maxu, contours[i], boxRef);
+        ce.GetSegments("b", vector<double>(1, contours[i]), verts);
+        if (!same(verts, boxRef)) {
+            cout << "FAIL : segments of contour " << contours[i] << " in box differ" << endl;
+            fail = true;
+        }
+        for (const auto &v : verts) {
+            if (v.x < minu[0] || v.x > maxu[0] || v.y < minu[1] || v.y > maxu[1]) {
+                cout << "FAIL : segment of contour " << contours[i] << " outside of box" << endl;
+                fail = true;
+                break;
+            }
+        }
+        nboxverts += verts.size();
+    }
+    cout << "Segments in box : " << nboxverts / 2 << endl;
+    if (!nboxverts || nboxverts >= nverts) {
+        cout << "FAIL : box did not limit the segments" << endl;
+        fail = true;
+    }
+
+    if (!fail) cout << "Extraction matches reference" << endl;
+
+    return (fail ? 1 : 0);
+}
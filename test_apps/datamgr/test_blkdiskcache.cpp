@@ -0,0 +1,222 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/BlkDiskCache.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    string                  dir;
+    int                     nentries;
+    int                     entrykb;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dir", 1, "test_blkdiskcache.d", "Cache directory. Its contents are removed"},
+                                         {"nentries", 1, "20", "Number of entries written"},
+                                         {"entrykb", 1, "100", "Size of each entry in KBs"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dir", Wasp::CvtToCPPStr, &opt.dir, sizeof(opt.dir)},
+                                        {"nentries", Wasp::CvtToInt, &opt.nentries, sizeof(opt.nentries)},
+                                        {"entrykb", Wasp::CvtToInt, &opt.entrykb, sizeof(opt.entrykb)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Files in the cache directory with the given suffix
+//
+vector<string> list(string suffix)
+{
+    vector<string> files;
+    DIR *          dirp = opendir(opt.dir.c_str());
+    if (!dirp) return (files);
+
+    struct dirent *dp;
+    while ((dp = readdir(dirp))) {
+        string name = dp->d_name;
+        if (name.find(suffix) != string::npos) files.push_back(FileUtils::JoinPaths({opt.dir, name}));
+    }
+    closedir(dirp);
+    return (files);
+}
+
+size_t file_size(const string &path)
+{
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0 ? st.st_size : 0);
+}
+
+size_t total_size()
+{
+    size_t total = 0;
+    for (const auto &f : list(".blk")) total += file_size(f);
+    return (total);
+}
+
+void clear()
+{
+    for (const auto &f : list(".")) {
+        if (!FileUtils::IsDirectory(f)) remove(f.c_str());
+    }
+}
+
+string key(int i) { return ("entry " + std::to_string(i)); }
+
+vector<float> data(int i)
+{
+    vector<float> v(opt.entrykb * 1024 / sizeof(float));
+    for (size_t j = 0; j < v.size(); j++) v[j] = i * 1000.0f + j;
+    return (v);
+}
+
+bool get(BlkDiskCache &cache, int i)
+{
+    vector<float> expected = data(i);
+    vector<float> buf(expected.size());
+    return (cache.Get(key(i), buf.data(), buf.size() * sizeof(float)) && buf == expected);
+}
+
+bool put(BlkDiskCache &cache, int i)
+{
+    vector<float> v = data(i);
+    return (cache.Put(key(i), v.data(), v.size() * sizeof(float)) == 0);
+}
+
+#define CHECK(cond, msg)                     \
+    if (!(cond)) {                           \
+        cout << "Failed : " << msg << endl;  \
+        ok = false;                          \
+    }
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    (void)FileUtils::MakeDir(opt.dir);
+    clear();
+
+    bool   ok = true;
+    size_t entryBytes = opt.entrykb * 1024;
+
+    // Room for a quarter of the entries
+    //
+    size_t maxBytes = entryBytes * opt.nentries / 4;
+
+    {
+        BlkDiskCache cache;
+        if (cache.Open(opt.dir, maxBytes) < 0) return (1);
+
+        // An entry can be read back as soon as it is queued
+        //
+        CHECK(put(cache, 0) && get(cache, 0), "entry not returned right after Put()");
+
+        for (int i = 1; i < opt.nentries; i++) {
+            CHECK(put(cache, i), "Put() of entry " << i);
+            cache.Flush();
+        }
+
+        // The budget is kept, the oldest entries were evicted, and the
+        // newest survive
+        //
+        CHECK(total_size() <= maxBytes, "cache holds " << total_size() << " bytes, budget is " << maxBytes);
+        CHECK(cache.GetStats().nevicted > 0, "nothing evicted");
+        CHECK(!get(cache, 1), "oldest entry not evicted");
+        CHECK(get(cache, opt.nentries - 1), "newest entry lost");
+        CHECK(list(".tmp.").empty(), "temporary files left behind");
+
+        // An entry larger than the budget is refused
+        //
+        vector<char> big(maxBytes + 1);
+        CHECK(cache.Put("big", big.data(), big.size()) < 0, "entry larger than the budget stored");
+
+        // Asking for the wrong size is a miss
+        //
+        vector<char> buf(entryBytes / 2);
+        CHECK(!cache.Get(key(opt.nentries - 1), buf.data(), buf.size()), "entry returned with the wrong size");
+    }
+
+    // A truncated entry, e.g. from a full disk or a crash, is a miss,
+    // and is replaced by the next Put()
+    //
+    {
+        BlkDiskCache cache;
+        if (cache.Open(opt.dir, maxBytes) < 0) return (1);
+
+        int n = opt.nentries - 1;
+        CHECK(get(cache, n), "entry lost by reopening");
+
+        vector<string> files = list(".blk");
+        for (const auto &f : files) { CHECK(truncate(f.c_str(), file_size(f) / 2) == 0, "truncate " << f); }
+        CHECK(!get(cache, n), "truncated entry returned");
+
+        CHECK(put(cache, n), "Put() over a truncated entry");
+        cache.Flush();
+        CHECK(get(cache, n), "entry not replaced");
+    }
+
+    // Temporary files of a process that died while writing are removed
+    // when the cache is opened, unless they may still be in use
+    //
+    {
+        string stale = FileUtils::JoinPaths({opt.dir, "0000000000000000.blk.tmp.1.0"});
+        string fresh = FileUtils::JoinPaths({opt.dir, "0000000000000001.blk.tmp.1.0"});
+        fclose(fopen(stale.c_str(), "w"));
+        fclose(fopen(fresh.c_str(), "w"));
+
+        struct utimbuf times;
+        times.actime = times.modtime = time(NULL) - 2 * 3600;
+        (void)utime(stale.c_str(), &times);
+
+        BlkDiskCache cache;
+        if (cache.Open(opt.dir, maxBytes) < 0) return (1);
+
+        CHECK(!FileUtils::Exists(stale), "stale temporary file not removed");
+        CHECK(FileUtils::Exists(fresh), "recent temporary file removed");
+        remove(fresh.c_str());
+    }
+
+    // Reopening with a smaller budget trims the directory
+    //
+    {
+        BlkDiskCache cache;
+        if (cache.Open(opt.dir, entryBytes * 2) < 0) return (1);
+        CHECK(total_size() <= entryBytes * 2, "directory not trimmed to a smaller budget");
+    }
+
+    clear();
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
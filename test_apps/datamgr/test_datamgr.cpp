@@ -23,7 +23,10 @@ struct {
     int                     level;
     int                     lod;
     int                     nthreads;
+    int                     prefetch;
+    int                     diskcachemb;
     string                  varname;
+    string                  diskcache;
     string                  savefilebase;
     string                  ftype;
     std::vector<double>     minu;
@@ -47,6 +50,9 @@ OptionParser::OptDescRec_T set_opts[] = {{"nts", 1, "1", "Number of timesteps to
                                          {"nthreads", 1, "0",
                                           "Specify number of execution threads "
                                           "0 => use number of cores"},
+                                         {"prefetch", 1, "0", "Number of time steps to prefetch. 0 => disable prefetching"},
+                                         {"diskcache", 1, "", "Directory for the disk cache of decoded data. Empty => disable"},
+                                         {"diskcachemb", 1, "10240", "Disk cache size in MBs"},
                                          {"varname", 1, "", "Name of variable"},
                                          {"savefilebase", 1, "", "Base path name to output file"},
                                          {"ftype", 1, "vdc", "data set type (vdc|wrf|cf|mpas)"},
@@ -73,6 +79,9 @@ OptionParser::Option_T get_options[] = {{"nts", Wasp::CvtToInt, &opt.nts, sizeof
                                         {"level", Wasp::CvtToInt, &opt.level, sizeof(opt.level)},
                                         {"lod", Wasp::CvtToInt, &opt.lod, sizeof(opt.lod)},
                                         {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"prefetch", Wasp::CvtToInt, &opt.prefetch, sizeof(opt.prefetch)},
+                                        {"diskcache", Wasp::CvtToCPPStr, &opt.diskcache, sizeof(opt.diskcache)},
+                                        {"diskcachemb", Wasp::CvtToInt, &opt.diskcachemb, sizeof(opt.diskcachemb)},
                                         {"varname", Wasp::CvtToCPPStr, &opt.varname, sizeof(opt.varname)},
                                         {"savefilebase", Wasp::CvtToCPPStr, &opt.savefilebase, sizeof(opt.savefilebase)},
                                         {"ftype", Wasp::CvtToCPPStr, &opt.ftype, sizeof(opt.ftype)},
@@ -356,9 +365,13 @@ int main(int argc, char **argv)
     if (!opt.nogeoxform) { options.push_back("-project_to_pcs"); }
     if (!opt.novertxform) { options.push_back("-vertical_xform"); }
     DataMgr datamgr(opt.ftype, opt.memsize, opt.nthreads);
-    int     rc = datamgr.Initialize(files, options);
+    if (!opt.diskcache.empty() && datamgr.SetDiskCache(opt.diskcache, opt.diskcachemb) < 0) exit(1);
+
+    int rc = datamgr.Initialize(files, options);
     if (rc < 0) exit(1);
 
+    datamgr.SetPrefetch(opt.prefetch);
+
     print_info(datamgr, opt.verbose);
 
     string vname = opt.varname;
@@ -370,6 +383,7 @@ int main(int argc, char **argv)
 
     int nts = datamgr.GetNumTimeSteps(vname);
 
+    double t0 = GetTime();
     for (int l = 0; l < opt.loop; l++) {
         cout << "Processing loop " << l << endl;
 
@@ -380,7 +394,22 @@ int main(int argc, char **argv)
         }
     }
 
-    if (!opt.quiet) { fprintf(stdout, "total process time : %f\n", timer); }
+    timer = GetTime() - t0;
+
+    if (!opt.quiet) {
+        fprintf(stdout, "total process time : %f\n", timer);
+
+        BlkMemMgr::Stats stats = BlkMemMgr::GetStats();
+        fprintf(stdout, "cache bytes in use : %zu of %zu (%zu cached for reuse)\n", stats.bytes_in_use, stats.bytes_max, stats.bytes_cached);
+        fprintf(stdout, "cache fragmentation : %f\n", stats.fragmentation);
+        fprintf(stdout, "cache allocations : %zu, failed (evictions forced) : %zu, runs released : %zu\n", stats.nallocs, stats.nfailed, stats.nreleased);
+        fprintf(stdout, "cache allocation latency : mean %g s, max %g s\n", stats.alloc_time_mean, stats.alloc_time_max);
+
+        if (!opt.diskcache.empty()) {
+            BlkDiskCache::Stats dstats = datamgr.GetDiskCacheStats();
+            fprintf(stdout, "disk cache hits : %zu, misses : %zu, writes : %zu, evicted : %zu\n", dstats.nhits, dstats.nmisses, dstats.nwrites, dstats.nevicted);
+        }
+    }
 
     exit(0);
 }
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/DataMgr.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    int                     nts;
+    int                     stride;
+    int                     prefetch;
+    int                     memsize;
+    int                     level;
+    int                     lod;
+    string                  varname;
+    string                  ftype;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nts", 1, "4", "Number of time steps to process"},
+                                         {"stride", 1, "1", "Time step stride"},
+                                         {"prefetch", 1, "2", "Number of time steps to prefetch"},
+                                         {"memsize", 1, "2000", "Cache size in MBs"},
+                                         {"level", 1, "0", "Multiresution refinement level. Zero implies coarsest resolution"},
+                                         {"lod", 1, "0", "Level of detail. Zero implies coarsest resolution"},
+                                         {"varname", 1, "", "Name of a time varying variable"},
+                                         {"ftype", 1, "vdc", "data set type (vdc|wrf|cf|mpas)"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nts", Wasp::CvtToInt, &opt.nts, sizeof(opt.nts)},
+                                        {"stride", Wasp::CvtToInt, &opt.stride, sizeof(opt.stride)},
+                                        {"prefetch", Wasp::CvtToInt, &opt.prefetch, sizeof(opt.prefetch)},
+                                        {"memsize", Wasp::CvtToInt, &opt.memsize, sizeof(opt.memsize)},
+                                        {"level", Wasp::CvtToInt, &opt.level, sizeof(opt.level)},
+                                        {"lod", Wasp::CvtToInt, &opt.lod, sizeof(opt.lod)},
+                                        {"varname", Wasp::CvtToCPPStr, &opt.varname, sizeof(opt.varname)},
+                                        {"ftype", Wasp::CvtToCPPStr, &opt.ftype, sizeof(opt.ftype)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Wait for the prefetch thread to finish with a time step
+//
+DataMgr::PrefetchStatus wait_for(const DataMgr &datamgr, size_t ts, string varname)
+{
+    DataMgr::PrefetchStatus status;
+    while ((status = datamgr.GetPrefetchStatus(ts, varname)) == DataMgr::PrefetchPending) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    return (status);
+}
+
+// Return the number of values that differ
+//
+size_t compare(const Grid *g1, const Grid *g2)
+{
+    if (g1->GetDimensions() != g2->GetDimensions()) return (1);
+
+    size_t              ndiff = 0;
+    Grid::ConstIterator itr1 = g1->cbegin();
+    Grid::ConstIterator itr2 = g2->cbegin();
+    Grid::ConstIterator enditr = g1->cend();
+    for (; itr1 != enditr; ++itr1, ++itr2) {
+        if (*itr1 != *itr2) ndiff++;
+    }
+    return (ndiff);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help || argc < 2 || opt.varname.empty() || opt.stride < 1) {
+        cerr << "Usage: " << ProgName << " [options] -varname name files " << endl;
+        op.PrintOptionHelp(stderr);
+        return (opt.help ? 0 : 1);
+    }
+
+    vector<string> files;
+    for (int i = 1; i < argc; i++) { files.push_back(argv[i]); }
+
+    // The same data read cold, and read with prefetching enabled
+    //
+    DataMgr cold(opt.ftype, opt.memsize);
+    DataMgr warm(opt.ftype, opt.memsize);
+    if (cold.Initialize(files, vector<string>()) < 0) return (1);
+    if (warm.Initialize(files, vector<string>()) < 0) return (1);
+
+    warm.SetPrefetch(opt.prefetch);
+    MyBase::SetErrCode(0);
+
+    int nts = warm.GetNumTimeSteps(opt.varname);
+
+    bool   ok = true;
+    size_t nprefetched = 0;
+    for (int i = 0; i < opt.nts && i * opt.stride < nts; i++) {
+        size_t ts = i * opt.stride;
+
+        // Time steps after the second were queued by the previous requests
+        //
+        DataMgr::PrefetchStatus status = wait_for(warm, ts, opt.varname);
+        if (i >= 2 && status != DataMgr::PrefetchDone) {
+            cout << "Time step " << ts << " was not prefetched, status " << status << endl;
+            ok = false;
+        }
+        if (status == DataMgr::PrefetchDone) nprefetched++;
+
+        Grid *g1 = cold.GetVariable(ts, opt.varname, opt.level, opt.lod);
+        Grid *g2 = warm.GetVariable(ts, opt.varname, opt.level, opt.lod);
+        if (!g1 || !g2) return (1);
+
+        size_t ndiff = compare(g1, g2);
+        if (ndiff) {
+            cout << "Time step " << ts << " : " << ndiff << " values differ from a cold read" << endl;
+            ok = false;
+        }
+        delete g1;
+        delete g2;
+    }
+
+    // Nothing the prefetch thread did may be reported as an error
+    //
+    if (MyBase::GetErrCode()) {
+        cout << "Error reported : " << MyBase::GetErrMsg() << endl;
+        ok = false;
+    }
+
+    cout << nprefetched << " time steps served from prefetched data" << endl;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/DataMgr.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    int                     nts;
+    int                     memsize;
+    double                  tol;
+    std::vector<string>     varnames;
+    string                  ftype;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nts", 1, "1", "Number of time steps to process"},
+                                         {"memsize", 1, "2000", "Cache size in MBs"},
+                                         {"tol", 1, "1e-5", "Tolerance, relative to the magnitude of the range, for round-off in decoded data"},
+                                         {"varnames", 1, "", "Colon delimited list of variables. Default: all data variables"},
+                                         {"ftype", 1, "vdc", "data set type (vdc|wrf|cf|mpas)"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nts", Wasp::CvtToInt, &opt.nts, sizeof(opt.nts)},
+                                        {"memsize", Wasp::CvtToInt, &opt.memsize, sizeof(opt.memsize)},
+                                        {"tol", Wasp::CvtToDouble, &opt.tol, sizeof(opt.tol)},
+                                        {"varnames", Wasp::CvtToStrVec, &opt.varnames, sizeof(opt.varnames)},
+                                        {"ftype", Wasp::CvtToCPPStr, &opt.ftype, sizeof(opt.ftype)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Compare the range returned by GetDataRange(), which may come from
+// metadata, with the range of the data returned by GetVariable()
+//
+bool test_range(DataMgr &datamgr, size_t ts, string varname, int level, int lod)
+{
+    vector<double> range;
+    if (datamgr.GetDataRange(ts, varname, level, lod, range) < 0) return (false);
+
+    Grid *g = datamgr.GetVariable(ts, varname, level, lod);
+    if (!g) return (false);
+
+    float grange[2];
+    g->GetRange(grange);
+    delete g;
+
+    double tol = opt.tol * std::max(std::fabs(grange[0]), std::fabs(grange[1]));
+    if (std::fabs(range[0] - grange[0]) > tol || std::fabs(range[1] - grange[1]) > tol) {
+        printf("%s ts %zu level %d lod %d : range (%g, %g), data (%g, %g)\n", varname.c_str(), ts, level, lod, range[0], range[1], grange[0], grange[1]);
+        return (false);
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help || argc < 2) {
+        cerr << "Usage: " << ProgName << " [options] files " << endl;
+        op.PrintOptionHelp(stderr);
+        return (opt.help ? 0 : 1);
+    }
+
+    vector<string> files;
+    for (int i = 1; i < argc; i++) { files.push_back(argv[i]); }
+
+    DataMgr datamgr(opt.ftype, opt.memsize);
+    if (datamgr.Initialize(files, vector<string>()) < 0) return (1);
+
+    vector<string> varnames = opt.varnames;
+    if (varnames.empty()) varnames = datamgr.GetDataVarNames();
+
+    bool   ok = true;
+    size_t ntests = 0;
+    for (const auto &varname : varnames) {
+        int nlevels = datamgr.GetNumRefLevels(varname);
+        int nlods = datamgr.GetCRatios(varname).size();
+        int nts = datamgr.GetNumTimeSteps(varname);
+
+        // Every refinement level and lod, including the native,
+        // uncompressed data that may be answered from metadata
+        //
+        for (int ts = 0; ts < opt.nts && ts < nts; ts++) {
+            for (int level = 0; level < nlevels; level++) {
+                for (int lod = 0; lod < nlods; lod++) {
+                    if (!test_range(datamgr, ts, varname, level, lod)) ok = false;
+                    ntests++;
+                }
+            }
+        }
+    }
+
+    cout << ntests << " ranges compared" << endl;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -0,0 +1,207 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/RegularGrid.h>
+#include <vapor/DataStatistics.h>
+#include <vapor/FileUtils.h>
+
+#include "GridTestUtils.h"
+
+using namespace Wasp;
+using namespace VAPoR;
+using GridTestUtils::alloc_blocks;
+
+struct {
+    std::vector<size_t>     bs;
+    std::vector<size_t>     dims;
+    int                     nthreads;
+    double                  tol;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"bs", 1, "16:16:16",
+                                          "Colon delimited 3-element vector "
+                                          "specifying block size"},
+                                         {"dims", 1, "70:50:33",
+                                          "Colon delimited 3-element vector "
+                                          "specifying grid dimensions"},
+                                         {"nthreads", 1, "4", "Number of threads of the parallel computation"},
+                                         {"tol", 1, "1e-9", "Relative tolerance for the mean and standard deviation"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"bs", Wasp::CvtToSize_tVec, &opt.bs, sizeof(opt.bs)},
+                                        {"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"tol", Wasp::CvtToDouble, &opt.tol, sizeof(opt.tol)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Fill a grid with values of f(i, j, k). If missing is true every 97th
+// node is missing.
+//
+template<class F> Grid *make_grid(const vector<size_t> &dims, F f, bool missing = true)
+{
+    Grid *g = new RegularGrid(dims, opt.bs, alloc_blocks(opt.bs, dims), vector<double>(3, 0.0), vector<double>(3, 1.0));
+    g->SetMissingValue(-1e30);
+    g->SetHasMissingValues(true);
+
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                float v = f(i, j, k);
+                if (missing && (i + j * dims[0] + k * dims[0] * dims[1]) % 97 == 13) v = g->GetMissingValue();
+                g->SetValueIJK(i, j, k, v);
+            }
+        }
+    }
+    return (g);
+}
+
+// Statistics computed by copying and sorting the samples in the box
+//
+DataStatistics::Stats reference(const Grid *g, const vector<double> &minu, const vector<double> &maxu)
+{
+    vector<float>         values;
+    float                 mv = g->GetMissingValue();
+    const vector<size_t> &dims = g->GetDimensions();
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                double x, y, z;
+                g->GetUserCoordinates(i, j, k, x, y, z);
+                if (x < minu[0] || x > maxu[0] || y < minu[1] || y > maxu[1] || z < minu[2] || z > maxu[2]) continue;
+
+                float v = g->GetValueAtIndex(Size_tArr3{i, j, k});
+                if (v != mv) values.push_back(v);
+            }
+        }
+    }
+
+    DataStatistics::Stats stats;
+    stats.count = values.size();
+    if (values.empty()) return (stats);
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (auto v : values) sum += v;
+    double mean = sum / values.size();
+    double ss = 0.0;
+    for (auto v : values) ss += (v - mean) * (v - mean);
+
+    stats.min = values.front();
+    stats.max = values.back();
+    stats.mean = mean;
+    stats.stddev = std::sqrt(ss / values.size());
+    stats.median = values[values.size() / 2];
+    return (stats);
+}
+
+bool close(double a, double b, double scale) { return (std::fabs(a - b) <= opt.tol * std::max(scale, 1.0)); }
+
+// The order statistics must match exactly. The moments are summed in
+// a different order and may differ by round-off.
+//
+bool compare(string name, const DataStatistics::Stats &s, const DataStatistics::Stats &ref)
+{
+    if (!ref.count) return (s.count == 0);
+
+    double scale = std::max(std::fabs(ref.min), std::fabs(ref.max));
+    bool   ok = s.count == ref.count && s.min == ref.min && s.max == ref.max && s.median == ref.median && close(s.mean, ref.mean, scale) && close(s.stddev, ref.stddev, scale);
+    if (!ok) {
+        printf("%s : count %ld min %g max %g mean %.17g stddev %.17g median %.9g\n", name.c_str(), s.count, s.min, s.max, s.mean, s.stddev, s.median);
+        printf("%*s   count %ld min %g max %g mean %.17g stddev %.17g median %.9g\n", (int)name.size(), "expected", ref.count, ref.min, ref.max, ref.mean, ref.stddev, ref.median);
+    }
+    return (ok);
+}
+
+// Compare the serial and parallel computations with each other and
+// with a sort of the samples, over the whole grid and over a box that
+// cuts through blocks
+//
+bool test(string name, Grid *g)
+{
+    DataStatistics serial(1);
+    DataStatistics parallel(opt.nthreads);
+
+    vector<vector<double>> boxes = {{0.0, 0.0, 0.0, 1.0, 1.0, 1.0}, {0.13, 0.31, 0.07, 0.77, 0.52, 0.91}};
+
+    bool ok = true;
+    for (const auto &box : boxes) {
+        vector<double> minu(box.begin(), box.begin() + 3);
+        vector<double> maxu(box.begin() + 3, box.end());
+
+        DataStatistics::Stats ref = reference(g, minu, maxu);
+        DataStatistics::Stats s1, sn;
+        serial.Compute(g, minu, maxu, true, s1);
+        parallel.Compute(g, minu, maxu, true, sn);
+
+        ok = compare(name + " serial", s1, ref) && ok;
+        ok = compare(name + " parallel", sn, ref) && ok;
+    }
+    delete g;
+    return (ok);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.bs.size() == 3 && opt.dims.size() == 3);
+
+    vector<size_t> dims = opt.dims;
+    vector<size_t> even = {dims[0], dims[1], 4};
+
+    bool ok = true;
+
+    // Distinct values
+    //
+    ok = test("smooth", make_grid(dims, [](size_t i, size_t j, size_t k) { return (float)(sin(i * 0.1) * cos(j * 0.07) + k * 0.01); })) && ok;
+
+    // A small number of values, so the median falls in a long run of
+    // duplicates that straddles histogram bins and blocks
+    //
+    ok = test("duplicates", make_grid(dims, [](size_t i, size_t j, size_t k) { return (float)((i * 7 + j * 3 + k) % 5); })) && ok;
+
+    // An even number of samples
+    //
+    ok = test("even", make_grid(
+                          even, [](size_t i, size_t j, size_t k) { return (float)(i * j) - (float)k * 1000.0f; }, false))
+      && ok;
+
+    // One value everywhere, and one outlier that stretches the histogram
+    //
+    ok = test("constant", make_grid(dims, [](size_t i, size_t j, size_t k) { return 3.5f; })) && ok;
+    ok = test("outlier", make_grid(dims, [](size_t i, size_t j, size_t k) { return (i == 1 && j == 1 && k == 1) ? 1e20f : (float)(j % 3); })) && ok;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
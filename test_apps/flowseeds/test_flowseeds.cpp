@@ -0,0 +1,213 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/RakeSeeds.h>
+#include <vapor/AdvectionIO.h>
+
+using namespace Wasp;
+
+struct {
+    int                     nrandom;
+    string                  file;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nrandom", 1, "1000", "Number of seeds placed at random"},
+                                         {"file", 1, "test_flowseeds.csv", "Seeds file written and read"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nrandom", Wasp::CvtToInt, &opt.nrandom, sizeof(opt.nrandom)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+bool inside(const flow::Particle &p, const vector<float> &rake, float defaultZ)
+{
+    if (p.location.x < rake[0] || p.location.x > rake[1] || p.location.y < rake[2] || p.location.y > rake[3]) return (false);
+    if (rake.size() == 4) return (p.location.z == defaultZ);
+    return (p.location.z >= rake[4] && p.location.z <= rake[5]);
+}
+
+// Seeds are placed at the centers of the cells of a grid over the rake
+//
+bool uniform_seeds()
+{
+    bool ok = true;
+
+    vector<float>          rake = {0.0, 4.0, -1.0, 1.0, 10.0, 13.0};
+    vector<flow::Particle> seeds = flow::RakeSeedsUniform(rake, {4, 2, 3}, 5.0, 0.0);
+    if (seeds.size() != 24) {
+        cout << "Uniform rake has " << seeds.size() << " seeds" << endl;
+        return (false);
+    }
+    for (size_t k = 0, n = 0; k < 3; k++) {
+        for (size_t j = 0; j < 2; j++) {
+            for (size_t i = 0; i < 4; i++, n++) {
+                const flow::Particle &p = seeds[n];
+                if (p.location.x != 0.5f + i || p.location.y != -0.5f + j || p.location.z != 10.5f + k || p.time != 5.0) {
+                    printf("Uniform seed %zu at (%g, %g, %g), time %g\n", n, p.location.x, p.location.y, p.location.z, p.time);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    // 2D rakes are placed at the default Z, and ignore a 3rd count
+    //
+    rake.resize(4);
+    seeds = flow::RakeSeedsUniform(rake, {2, 2, 7}, 0.0, 3.5);
+    if (seeds.size() != 4) {
+        cout << "2D uniform rake has " << seeds.size() << " seeds" << endl;
+        return (false);
+    }
+    for (const auto &p : seeds) {
+        if (!inside(p, rake, 3.5)) {
+            cout << "2D uniform seed outside of the rake" << endl;
+            ok = false;
+        }
+    }
+    return (ok);
+}
+
+// Random seeds lie in the rake, and are the same for the same generator seed
+//
+bool random_seeds()
+{
+    bool ok = true;
+
+    for (size_t dim = 2; dim <= 3; dim++) {
+        vector<float> rake = {-2.0, 2.0, 100.0, 101.0, 0.0, 1e-3};
+        rake.resize(dim * 2);
+
+        vector<flow::Particle> a = flow::RakeSeedsRandom(rake, opt.nrandom, 32, 1.0, -4.0);
+        vector<flow::Particle> b = flow::RakeSeedsRandom(rake, opt.nrandom, 32, 1.0, -4.0);
+        vector<flow::Particle> c = flow::RakeSeedsRandom(rake, opt.nrandom, 33, 1.0, -4.0);
+        if (a.size() != opt.nrandom || b.size() != a.size() || c.size() != a.size()) {
+            cout << "Random rake has " << a.size() << " seeds" << endl;
+            return (false);
+        }
+
+        size_t nsame = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!inside(a[i], rake, -4.0) || a[i].time != 1.0) {
+                printf("%zuD random seed %zu at (%g, %g, %g), time %g\n", dim, i, a[i].location.x, a[i].location.y, a[i].location.z, a[i].time);
+                ok = false;
+            }
+            if (a[i].location != b[i].location) {
+                cout << "Random seeds differ for the same generator seed" << endl;
+                return (false);
+            }
+            if (a[i].location == c[i].location) nsame++;
+        }
+        if (nsame == a.size()) {
+            cout << "Random seeds are the same for different generator seeds" << endl;
+            ok = false;
+        }
+    }
+    return (ok);
+}
+
+vector<flow::Particle> read_seeds(const string &contents, bool readTime)
+{
+    {
+        std::ofstream out(opt.file.c_str());
+        out << contents;
+    }
+    vector<flow::Particle> seeds = flow::InputSeedsCSV(opt.file, readTime);
+    (void)remove(opt.file.c_str());
+    return (seeds);
+}
+
+// Seed times are only read when asked for, and then every line must give one
+//
+bool csv_seeds()
+{
+    bool ok = true;
+
+    const string withTimes = "# x, y, z, time\n"
+                             "1.0, 2.0, 3.0, 10.0\n"
+                             "\n"
+                             "1.0, 2.0, 3.0, 20.0, 99.0\n"
+                             "1.0, 2.0, 3.0, 10.0\n"
+                             "4.0, 5.0, 6.0, 15.5\n";
+
+    vector<flow::Particle> seeds = read_seeds(withTimes, false);
+    if (seeds.size() != 2) {
+        cout << "Read " << seeds.size() << " seeds without times, expected 2" << endl;
+        ok = false;
+    }
+    for (const auto &p : seeds) {
+        if (p.time != 0.0) {
+            cout << "Seed time read when not asked for" << endl;
+            ok = false;
+        }
+    }
+
+    // The same location at two times is two seeds
+    //
+    seeds = read_seeds(withTimes, true);
+    if (seeds.size() != 3) {
+        cout << "Read " << seeds.size() << " seeds with times, expected 3" << endl;
+        return (false);
+    }
+    const double times[] = {10.0, 20.0, 15.5};
+    const float  xs[] = {1.0, 1.0, 4.0};
+    for (size_t i = 0; i < seeds.size(); i++) {
+        if (seeds[i].time != times[i] || seeds[i].location.x != xs[i]) {
+            printf("Seed %zu at x %g, time %g\n", i, seeds[i].location.x, seeds[i].time);
+            ok = false;
+        }
+    }
+
+    // A line without a time is rejected when times are read
+    //
+    if (!read_seeds("1.0, 2.0, 3.0, 10.0\n4.0, 5.0, 6.0\n", true).empty()) {
+        cout << "Seeds without a time accepted" << endl;
+        ok = false;
+    }
+    if (read_seeds("1.0, 2.0, 3.0, 10.0\n4.0, 5.0, 6.0\n", false).size() != 2) {
+        cout << "Seeds without a time rejected" << endl;
+        ok = false;
+    }
+    return (ok);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+    ok = uniform_seeds() && ok;
+    ok = random_seeds() && ok;
+    ok = csv_seeds() && ok;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -311,6 +311,82 @@ void test_iterator(const StructuredGrid *sg)
     cout << endl;
 }
 
+void test_span(const StructuredGrid *sg)
+{
+    cout << "Span Visitor Test ----->" << endl;
+
+    double              t0 = Wasp::GetTime();
+    Grid::ConstIterator itr;
+    Grid::ConstIterator enditr = sg->cend();
+    double              accum1 = 0.0;
+    size_t              count1 = 0;
+    for (itr = sg->cbegin(); itr != enditr; ++itr) {
+        accum1 += *itr;
+        count1++;
+    }
+    double t1 = Wasp::GetTime();
+    cout << "Iteration time (ConstIterator) : " << t1 - t0 << endl;
+
+    double accum2 = 0.0;
+    size_t count2 = 0;
+    sg->ForEachBlock([&](const Grid::Span &span) {
+        for (size_t i = 0; i < span.n; i++) accum2 += span.data[i];
+        count2 += span.n;
+    });
+    double t2 = Wasp::GetTime();
+    cout << "Iteration time (ForEachBlock) : " << t2 - t1 << endl;
+
+    if (accum1 == accum2 && count1 == count2) {
+        cout << "ConstIterator ForEachBlock match" << endl;
+    } else {
+        cout << "FAIL : ConstIterator ForEachBlock mismatch : " << accum1 << " " << count1 << " " << accum2 << " " << count2 << endl;
+    }
+
+    // Region of interest, checked against a test of each node's coordinates
+    //
+    size_t ncoords = std::min(sg->GetGeometryDim(), opt.roimin.size());
+    double accum3 = 0.0;
+    size_t count3 = 0;
+    t0 = Wasp::GetTime();
+    Grid::ConstNodeIterator nitr = sg->ConstNodeBegin();
+    Grid::ConstNodeIterator nenditr = sg->ConstNodeEnd();
+    for (; nitr != nenditr; ++nitr) {
+        vector<double> coords;
+        sg->GetUserCoordinates(*nitr, coords);
+        bool inside = true;
+        for (size_t i = 0; i < ncoords; i++) {
+            if (coords[i] < opt.roimin[i] || coords[i] > opt.roimax[i]) inside = false;
+        }
+        if (!inside) continue;
+        accum3 += sg->GetValueAtIndex(*nitr);
+        count3++;
+    }
+    t1 = Wasp::GetTime();
+    cout << "ROI iteration time (ConstNodeIterator) : " << t1 - t0 << endl;
+
+    double accum4 = 0.0;
+    size_t count4 = 0;
+    sg->ForEachBlock(opt.roimin, opt.roimax, [&](const Grid::Span &span) {
+        for (size_t i = 0; i < span.n; i++) accum4 += span.data[i];
+        count4 += span.n;
+    });
+    t2 = Wasp::GetTime();
+    cout << "ROI iteration time (ForEachBlock) : " << t2 - t1 << endl;
+
+    if (count3 == count4 && std::abs(accum3 - accum4) <= 1e-9 * std::abs(accum3)) {
+        cout << "ROI ConstNodeIterator ForEachBlock match" << endl;
+    } else {
+        cout << "FAIL : ROI ConstNodeIterator ForEachBlock mismatch : " << accum3 << " " << count3 << " " << accum4 << " " << count4 << endl;
+    }
+
+    float range[2];
+    t0 = Wasp::GetTime();
+    sg->GetRange(range);
+    cout << "GetRange time : " << Wasp::GetTime() - t0 << endl;
+    cout << "Range : " << range[0] << " " << range[1] << endl;
+    cout << endl;
+}
+
 void test_operator_pg_iterator(const StructuredGrid *sg)
 {
     cout << "Operator += Test ----->" << endl;
@@ -646,6 +722,8 @@ int main(int argc, char **argv)
 
     test_iterator(sg);
 
+    test_span(sg);
+
     test_operator_pg_iterator(sg);
 
     test_node_iterator(sg);
@@ -0,0 +1,274 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/RegularGrid.h>
+#include <vapor/LayeredGrid.h>
+#include <vapor/CurvilinearGrid.h>
+#include <vapor/FileUtils.h>
+
+#include "GridTestUtils.h"
+
+using namespace Wasp;
+using namespace VAPoR;
+using GridTestUtils::alloc_blocks;
+
+struct {
+    std::vector<size_t>     bs;
+    std::vector<size_t>     dims;
+    int                     npaths;
+    int                     nsteps;
+    double                  step;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"bs", 1, "64:64:64",
+                                          "Colon delimited 3-element vector "
+                                          "specifying block size"},
+                                         {"dims", 1, "256:256:48",
+                                          "Colon delimited 3-element vector "
+                                          "specifying grid dimensions"},
+                                         {"npaths", 1, "500", "Number of paths queried"},
+                                         {"nsteps", 1, "1000", "Number of queries along each path"},
+                                         {"step", 1, "0.25", "Length of a path step, in horizontal cells"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"bs", Wasp::CvtToSize_tVec, &opt.bs, sizeof(opt.bs)},
+                                        {"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"npaths", Wasp::CvtToInt, &opt.npaths, sizeof(opt.npaths)},
+                                        {"nsteps", Wasp::CvtToInt, &opt.nsteps, sizeof(opt.nsteps)},
+                                        {"step", Wasp::CvtToDouble, &opt.step, sizeof(opt.step)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Model top, and horizontal extent of the domain, in meters
+//
+const double zTop = 20000.0;
+const double width = 1.0e6;
+
+// Terrain height of a range of hills
+//
+double terrain(double x, double y)
+{
+    double u = x / width;
+    double v = y / width;
+    return (1500.0 * exp(-20.0 * ((u - 0.4) * (u - 0.4) + (v - 0.6) * (v - 0.6))) + 300.0 * (1.0 + sin(9.0 * u) * cos(7.0 * v)));
+}
+
+// Terrain following levels, closer together near the ground like the eta
+// levels of WRF
+//
+double level(double h, size_t k, size_t nz)
+{
+    double eta = pow((double)k / (nz - 1), 1.5);
+    return (h + eta * (zTop - h));
+}
+
+float field(double x, double y, double z) { return (sin(x / 50000.0) * cos(y / 70000.0) + z / zTop); }
+
+// Horizontal node coordinates of a curvilinear grid: a rotated, slightly
+// warped map projection
+//
+void horizontal(size_t i, size_t j, const vector<size_t> &dims, double &x, double &y)
+{
+    double u = width * i / (dims[0] - 1);
+    double v = width * j / (dims[1] - 1);
+    double a = 0.3;
+    x = u * cos(a) - v * sin(a) + 5000.0 * sin(v / 90000.0);
+    y = u * sin(a) + v * cos(a) + 5000.0 * sin(u / 110000.0);
+}
+
+LayeredGrid *make_layered(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    vector<double> xcoords, ycoords;
+    for (size_t i = 0; i < dims[0]; i++) xcoords.push_back(width * i / (dims[0] - 1));
+    for (size_t j = 0; j < dims[1]; j++) ycoords.push_back(width * j / (dims[1] - 1));
+
+    RegularGrid zrg(dims, bs, alloc_blocks(bs, dims), vector<double>(3, 0.0), vector<double>(3, 1.0));
+    for (size_t j = 0; j < dims[1]; j++) {
+        for (size_t i = 0; i < dims[0]; i++) {
+            double h = terrain(xcoords[i], ycoords[j]);
+            for (size_t k = 0; k < dims[2]; k++) zrg.SetValueIJK(i, j, k, level(h, k, dims[2]));
+        }
+    }
+
+    LayeredGrid *lg = new LayeredGrid(dims, bs, alloc_blocks(bs, dims), xcoords, ycoords, zrg);
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) lg->SetValueIJK(i, j, k, field(xcoords[i], ycoords[j], zrg.AccessIJK(i, j, k)));
+        }
+    }
+    return (lg);
+}
+
+CurvilinearGrid *make_curvilinear(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    vector<size_t> dims2d = {dims[0], dims[1]};
+    vector<size_t> bs2d = {bs[0], bs[1]};
+    RegularGrid    xrg(dims2d, bs2d, alloc_blocks(bs2d, dims2d), vector<double>(2, 0.0), vector<double>(2, 1.0));
+    RegularGrid    yrg(dims2d, bs2d, alloc_blocks(bs2d, dims2d), vector<double>(2, 0.0), vector<double>(2, 1.0));
+    RegularGrid    zrg(dims, bs, alloc_blocks(bs, dims), vector<double>(3, 0.0), vector<double>(3, 1.0));
+
+    for (size_t j = 0; j < dims[1]; j++) {
+        for (size_t i = 0; i < dims[0]; i++) {
+            double x, y;
+            horizontal(i, j, dims, x, y);
+            xrg.SetValueIJK(i, j, 0, x);
+            yrg.SetValueIJK(i, j, 0, y);
+
+            double h = terrain(x, y);
+            for (size_t k = 0; k < dims[2]; k++) zrg.SetValueIJK(i, j, k, level(h, k, dims[2]));
+        }
+    }
+
+    CurvilinearGrid *cg = new CurvilinearGrid(dims, bs, alloc_blocks(bs, dims), xrg, yrg, zrg, NULL);
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) cg->SetValueIJK(i, j, k, field(xrg.AccessIJK(i, j, 0), yrg.AccessIJK(i, j, 0), zrg.AccessIJK(i, j, k)));
+        }
+    }
+    return (cg);
+}
+
+// Paths through the grid, like those of particles advected by a smooth
+// velocity field: circles of a few cells radius that rise and sink. Points
+// of a path are consecutive. Each path starts at a random interior node.
+//
+void make_paths(const Grid *g, vector<DblArr3> &points)
+{
+    const vector<size_t> &dims = g->GetDimensions();
+
+    points.clear();
+    srand(1);
+    for (int p = 0; p < opt.npaths; p++) {
+        Size_tArr3 index;
+        for (int i = 0; i < 3; i++) index[i] = dims[i] / 4 + rand() % (dims[i] / 2);
+
+        DblArr3 pt, pt1;
+        g->GetUserCoordinates(index, pt);
+        g->GetUserCoordinates({index[0] + 1, index[1], index[2] + 1}, pt1);
+
+        double dx = opt.step * std::sqrt((pt1[0] - pt[0]) * (pt1[0] - pt[0]) + (pt1[1] - pt[1]) * (pt1[1] - pt[1]));
+        double dz = opt.step * (pt1[2] - pt[2]);
+        double heading = 6.2832 * rand() / (double)RAND_MAX;
+        double radius = 8.0 / opt.step;
+        for (int s = 0; s < opt.nsteps; s++) {
+            points.push_back(pt);
+            heading += 1.0 / radius;
+            pt[0] += dx * cos(heading);
+            pt[1] += dx * sin(heading);
+            pt[2] += dz * sin(s / radius);
+        }
+    }
+}
+
+void make_random(const Grid *g, size_t n, vector<DblArr3> &points)
+{
+    DblArr3 minu, maxu;
+    g->GetUserExtents(minu, maxu);
+
+    points.clear();
+    srand(2);
+    for (size_t p = 0; p < n; p++) {
+        DblArr3 pt;
+        for (int i = 0; i < 3; i++) pt[i] = minu[i] + (maxu[i] - minu[i]) * rand() / (double)RAND_MAX;
+        points.push_back(pt);
+    }
+}
+
+double query(const Grid *g, const vector<DblArr3> &points, vector<float> &values)
+{
+    values.resize(points.size());
+
+    double t0 = Wasp::GetTime();
+    for (size_t i = 0; i < points.size(); i++) values[i] = g->GetValue(points[i]);
+    return (Wasp::GetTime() - t0);
+}
+
+// Query the points without and with the point locator. Only points on a
+// face shared by two cells may be found in a different cell, so values
+// must agree to within rounding.
+//
+bool benchmark(string name, Grid *g, const vector<DblArr3> &points)
+{
+    vector<float> ref, values;
+
+    g->SetPointLocator(false);
+    double t0 = query(g, points, ref);
+
+    g->SetPointLocator(true);
+    double t1 = query(g, points, values);
+
+    size_t nfound = 0;
+    size_t nbad = 0;
+    float  mv = g->GetMissingValue();
+    for (size_t i = 0; i < points.size(); i++) {
+        if (ref[i] != mv) nfound++;
+        if (ref[i] == values[i]) continue;
+        if (ref[i] == mv || values[i] == mv || fabs(ref[i] - values[i]) > 1e-5 * (1.0 + fabs(ref[i]))) nbad++;
+    }
+
+    double n = points.size();
+    printf("%-28s %9.3f %9.3f %7.2fx %8lu %8lu\n", name.c_str(), n / t0 / 1e6, n / t1 / 1e6, t0 / t1, nfound, nbad);
+    return (nbad == 0);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.bs.size() == 3 && opt.dims.size() == 3);
+    VAssert(opt.dims[0] > 1 && opt.dims[1] > 1 && opt.dims[2] > 1);
+
+    LayeredGrid *    lg = make_layered(opt.dims, opt.bs);
+    CurvilinearGrid *cg = make_curvilinear(opt.dims, opt.bs);
+
+    printf("%-28s %9s %9s %8s %8s %8s\n", "Query rates (M/sec)", "tree", "locator", "speedup", "found", "differ");
+
+    bool ok = true;
+
+    vector<DblArr3> points;
+    make_paths(lg, points);
+    ok = benchmark("Layered, paths", lg, points) && ok;
+    make_random(lg, points.size() / 10, points);
+    ok = benchmark("Layered, random", lg, points) && ok;
+
+    make_paths(cg, points);
+    ok = benchmark("Curvilinear terrain, paths", cg, points) && ok;
+    make_random(cg, points.size() / 10, points);
+    ok = benchmark("Curvilinear terrain, random", cg, points) && ok;
+
+    delete lg;
+    delete cg;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
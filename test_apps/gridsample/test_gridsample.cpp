@@ -0,0 +1,230 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/RegularGrid.h>
+#include <vapor/StretchedGrid.h>
+#include <vapor/LayeredGrid.h>
+#include <vapor/CurvilinearGrid.h>
+#include <vapor/FileUtils.h>
+
+#include "GridTestUtils.h"
+
+using namespace Wasp;
+using namespace VAPoR;
+using GridTestUtils::alloc_blocks;
+
+struct {
+    std::vector<size_t>     bs;
+    std::vector<size_t>     dims;
+    int                     npoints;
+    int                     order;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"bs", 1, "64:64:64",
+                                          "Colon delimited 3-element vector "
+                                          "specifying block size"},
+                                         {"dims", 1, "256:256:64",
+                                          "Colon delimited 3-element vector "
+                                          "specifying grid dimensions"},
+                                         {"npoints", 1, "1000000", "Number of points sampled"},
+                                         {"order", 1, "1", "Interpolation order"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"bs", Wasp::CvtToSize_tVec, &opt.bs, sizeof(opt.bs)},
+                                        {"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"npoints", Wasp::CvtToInt, &opt.npoints, sizeof(opt.npoints)},
+                                        {"order", Wasp::CvtToInt, &opt.order, sizeof(opt.order)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Fill a grid with a smooth function of its node coordinates, with a few
+// missing values so that their handling is compared too
+//
+void fill(Grid *g)
+{
+    g->SetMissingValue(-1e30);
+    g->SetHasMissingValues(true);
+
+    const vector<size_t> &dims = g->GetDimensions();
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                double x, y, z;
+                g->GetUserCoordinates(i, j, k, x, y, z);
+                float v = sin(x * 6.0) * cos(y * 4.0) + z;
+                if ((i * 7 + j * 13 + k * 17) % 1009 == 0) v = g->GetMissingValue();
+                g->SetValueIJK(i, j, k, v);
+            }
+        }
+    }
+    g->SetInterpolationOrder(opt.order);
+}
+
+vector<double> stretched(size_t n)
+{
+    vector<double> coords;
+    for (size_t i = 0; i < n; i++) coords.push_back(pow((double)i / (n - 1), 1.3));
+    return (coords);
+}
+
+Grid *make_regular(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    Grid *g = new RegularGrid(dims, bs, alloc_blocks(bs, dims), vector<double>(3, 0.0), vector<double>(3, 1.0));
+    fill(g);
+    return (g);
+}
+
+Grid *make_stretched(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    Grid *g = new StretchedGrid(dims, bs, alloc_blocks(bs, dims), stretched(dims[0]), stretched(dims[1]), stretched(dims[2]));
+    fill(g);
+    return (g);
+}
+
+Grid *make_layered(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    vector<double> xcoords = stretched(dims[0]);
+    vector<double> ycoords = stretched(dims[1]);
+
+    RegularGrid zrg(dims, bs, alloc_blocks(bs, dims), vector<double>(3, 0.0), vector<double>(3, 1.0));
+    for (size_t j = 0; j < dims[1]; j++) {
+        for (size_t i = 0; i < dims[0]; i++) {
+            double h = 0.1 * sin(xcoords[i] * 5.0) * sin(ycoords[j] * 3.0);
+            for (size_t k = 0; k < dims[2]; k++) zrg.SetValueIJK(i, j, k, h + (1.0 - h) * k / (dims[2] - 1));
+        }
+    }
+
+    Grid *g = new LayeredGrid(dims, bs, alloc_blocks(bs, dims), xcoords, ycoords, zrg);
+    fill(g);
+    return (g);
+}
+
+// A curvilinear grid has no specialized GetValues() and exercises the
+// generic implementation
+//
+Grid *make_curvilinear(const vector<size_t> &dims, const vector<size_t> &bs)
+{
+    vector<size_t> dims2d = {dims[0], dims[1]};
+    vector<size_t> bs2d = {bs[0], bs[1]};
+    RegularGrid    xrg(dims2d, bs2d, alloc_blocks(bs2d, dims2d), vector<double>(2, 0.0), vector<double>(2, 1.0));
+    RegularGrid    yrg(dims2d, bs2d, alloc_blocks(bs2d, dims2d), vector<double>(2, 0.0), vector<double>(2, 1.0));
+    for (size_t j = 0; j < dims[1]; j++) {
+        for (size_t i = 0; i < dims[0]; i++) {
+            double u = (double)i / (dims[0] - 1);
+            double v = (double)j / (dims[1] - 1);
+            xrg.SetValueIJK(i, j, 0, u + 0.02 * sin(v * 6.0));
+            yrg.SetValueIJK(i, j, 0, v + 0.02 * sin(u * 6.0));
+        }
+    }
+
+    Grid *g = new CurvilinearGrid(dims, bs, alloc_blocks(bs, dims), xrg, yrg, stretched(dims[2]), NULL);
+    fill(g);
+    return (g);
+}
+
+// Sample points as a renderer does: a slice through the middle of the
+// domain, in scan line order, followed by random points
+//
+void make_points(const Grid *g, size_t n, vector<double> &x, vector<double> &y, vector<double> &z)
+{
+    DblArr3 minu, maxu;
+    g->GetUserExtents(minu, maxu);
+
+    x.clear();
+    y.clear();
+    z.clear();
+
+    size_t side = sqrt(n / 2);
+    for (size_t j = 0; j < side; j++) {
+        for (size_t i = 0; i < side; i++) {
+            x.push_back(minu[0] + (maxu[0] - minu[0]) * i / (side - 1));
+            y.push_back(minu[1] + (maxu[1] - minu[1]) * j / (side - 1));
+            z.push_back(0.5 * (minu[2] + maxu[2]));
+        }
+    }
+
+    srand(1);
+    while (x.size() < n) {
+        x.push_back(minu[0] + (maxu[0] - minu[0]) * rand() / (double)RAND_MAX);
+        y.push_back(minu[1] + (maxu[1] - minu[1]) * rand() / (double)RAND_MAX);
+        z.push_back(minu[2] + (maxu[2] - minu[2]) * rand() / (double)RAND_MAX);
+    }
+}
+
+// Sample the points one at a time with GetValue() and all at once with
+// GetValues(). The values must be identical.
+//
+bool benchmark(string name, Grid *g)
+{
+    vector<double> x, y, z;
+    make_points(g, opt.npoints, x, y, z);
+    size_t n = x.size();
+
+    vector<float> ref(n), values(n);
+
+    double t0 = Wasp::GetTime();
+    for (size_t p = 0; p < n; p++) ref[p] = g->GetValue(x[p], y[p], z[p]);
+    double t1 = Wasp::GetTime();
+    g->GetValues(n, x.data(), y.data(), z.data(), values.data());
+    double t2 = Wasp::GetTime();
+
+    size_t nbad = 0;
+    for (size_t p = 0; p < n; p++) {
+        if (ref[p] != values[p]) nbad++;
+    }
+
+    printf("%-14s %10.3f %10.3f %7.2fx %8lu\n", name.c_str(), n / (t1 - t0) / 1e6, n / (t2 - t1) / 1e6, (t1 - t0) / (t2 - t1), nbad);
+
+    delete g;
+    return (nbad == 0);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.bs.size() == 3 && opt.dims.size() == 3);
+    VAssert(opt.dims[0] > 1 && opt.dims[1] > 1 && opt.dims[2] > 1);
+
+    printf("RegularGrid kernels : %s\n", RegularGrid::SamplingKernels().c_str());
+    printf("%-14s %10s %10s %8s %8s\n", "Rates (M/sec)", "GetValue", "GetValues", "speedup", "differ");
+
+    bool ok = true;
+    ok = benchmark("Regular", make_regular(opt.dims, opt.bs)) && ok;
+    ok = benchmark("Stretched", make_stretched(opt.dims, opt.bs)) && ok;
+    ok = benchmark("Layered", make_layered(opt.dims, opt.bs)) && ok;
+    ok = benchmark("Curvilinear", make_curvilinear(opt.dims, opt.bs)) && ok;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
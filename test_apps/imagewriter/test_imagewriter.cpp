@@ -0,0 +1,230 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <png.h>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/ImageWriter.h>
+#include <vapor/AsyncImageWriter.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    std::vector<size_t>     dims;
+    int                     nframes;
+    int                     nthreads;
+    int                     maxframes;
+    string                  dir;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dims", 1, "1920:1080",
+                                          "Colon delimited 2-element vector "
+                                          "specifying image dimensions"},
+                                         {"nframes", 1, "32", "Number of frames written in each format"},
+                                         {"nthreads", 1, "0", "Number of encoding threads. Zero for one per core"},
+                                         {"maxframes", 1, "0", "Maximum number of frames in flight. Zero for the default"},
+                                         {"dir", 1, ".", "Directory the images are written to"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"nframes", Wasp::CvtToInt, &opt.nframes, sizeof(opt.nframes)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"maxframes", Wasp::CvtToInt, &opt.maxframes, sizeof(opt.maxframes)},
+                                        {"dir", Wasp::CvtToCPPStr, &opt.dir, sizeof(opt.dir)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Stand in for a rendered frame: a pattern that moves from frame to frame
+//
+void render(unsigned char *buf, size_t w, size_t h, int frame)
+{
+    for (size_t j = 0; j < h; j++) {
+        for (size_t i = 0; i < w; i++) {
+            unsigned char *p = &buf[3 * (j * w + i)];
+            p[0] = (unsigned char)(127.5 * (1.0 + sin((i + 4 * frame) * 0.02)));
+            p[1] = (unsigned char)(127.5 * (1.0 + cos((j + 2 * frame) * 0.03)));
+            p[2] = (unsigned char)((i * j + frame) & 0xff);
+        }
+    }
+}
+
+string frame_path(string name, int frame, string ext)
+{
+    ostringstream oss;
+    oss << opt.dir << "/" << name << "_" << frame << "." << ext;
+    return (oss.str());
+}
+
+bool read_file(string path, string &contents)
+{
+    ifstream in(path.c_str(), ios::in | ios::binary);
+    if (!in) return (false);
+    ostringstream oss;
+    oss << in.rdbuf();
+    contents = oss.str();
+    return (true);
+}
+
+// Write the frames one at a time, as animation capture did, and then
+// through an AsyncImageWriter. The files must be identical.
+//
+bool benchmark(string ext)
+{
+    size_t w = opt.dims[0];
+    size_t h = opt.dims[1];
+
+    double         t0 = Wasp::GetTime();
+    unsigned char *buf = new unsigned char[3 * w * h];
+    for (int f = 0; f < opt.nframes; f++) {
+        render(buf, w, h, f);
+        ImageWriter *writer = ImageWriter::CreateImageWriterForFile(frame_path("serial", f, ext));
+        if (!writer || writer->Write(buf, w, h) < 0) return (false);
+        delete writer;
+    }
+    delete[] buf;
+    double t1 = Wasp::GetTime();
+
+    int nthreads;
+    {
+        AsyncImageWriter async(opt.nthreads, opt.maxframes);
+        nthreads = async.GetNumThreads();
+        for (int f = 0; f < opt.nframes; f++) {
+            unsigned char *buf = async.AcquireBuffer(3 * w * h);
+            render(buf, w, h, f);
+            ImageWriter *writer = ImageWriter::CreateImageWriterForFile(frame_path("async", f, ext));
+            if (!writer) return (false);
+            if (async.Submit(writer, buf, w, h) < 0) return (false);
+        }
+        if (async.Wait() < 0) return (false);
+    }
+    double t2 = Wasp::GetTime();
+
+    size_t ndiffer = 0;
+    for (int f = 0; f < opt.nframes; f++) {
+        string serial, async;
+        if (!read_file(frame_path("serial", f, ext), serial) || !read_file(frame_path("async", f, ext), async) || serial != async) ndiffer++;
+        (void)remove(frame_path("serial", f, ext).c_str());
+        (void)remove(frame_path("async", f, ext).c_str());
+    }
+
+    printf("%-10s %10.2f %10.2f %7.2fx %8d %8lu\n", ext.c_str(), opt.nframes / (t1 - t0), opt.nframes / (t2 - t1), (t1 - t0) / (t2 - t1), nthreads, ndiffer);
+
+    return (ndiffer == 0);
+}
+
+// A PNG frame must decode to the pixels it was written from
+//
+bool test_png_pixels()
+{
+    size_t w = 333;
+    size_t h = 47;
+
+    vector<unsigned char> buf(3 * w * h);
+    render(buf.data(), w, h, 5);
+
+    string       path = frame_path("pixels", 0, "png");
+    ImageWriter *writer = ImageWriter::CreateImageWriterForFile(path);
+    if (!writer || writer->Write(buf.data(), w, h) < 0) return (false);
+    delete writer;
+
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+
+    vector<unsigned char> pixels;
+    bool                  ok = png_image_begin_read_from_file(&image, path.c_str()) != 0;
+    if (ok) {
+        image.format = PNG_FORMAT_RGB;
+        pixels.resize(PNG_IMAGE_SIZE(image));
+        ok = png_image_finish_read(&image, NULL, pixels.data(), 0, NULL) != 0;
+    }
+    (void)remove(path.c_str());
+
+    if (!ok || image.width != w || image.height != h || pixels != buf) {
+        printf("png        pixels differ\n");
+        return (false);
+    }
+    return (true);
+}
+
+// Frames that can't be written must be reported, with the writer's own
+// message, by Submit() or Wait(). The byte limit only lets two frames be
+// in flight at a time.
+//
+bool test_failures(string ext)
+{
+    size_t w = 64;
+    size_t h = 48;
+
+    AsyncImageWriter async(opt.nthreads, opt.maxframes, 2 * 3 * w * h);
+
+    bool failed = false;
+    for (int f = 0; f < opt.nframes; f++) {
+        unsigned char *buf = async.AcquireBuffer(3 * w * h);
+        render(buf, w, h, f);
+        ImageWriter *writer = ImageWriter::CreateImageWriterForFile(frame_path("no_such_dir/failed", f, ext));
+        if (!writer) return (false);
+        if (async.Submit(writer, buf, w, h) < 0) failed = true;
+    }
+    if (async.Wait() < 0) failed = true;
+
+    if (!failed || !strstr(MyBase::GetErrMsg(), "no_such_dir")) {
+        printf("%-10s failures not reported\n", ext.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.dims.size() == 2);
+
+    printf("%-10s %10s %10s %8s %8s %8s\n", "Frames/sec", "serial", "async", "speedup", "threads", "differ");
+
+    bool ok = true;
+    ok = benchmark("jpg") && ok;
+    ok = benchmark("tif") && ok;
+    ok = benchmark("png") && ok;
+    ok = test_png_pixels() && ok;
+    ok = test_failures("jpg") && ok;
+    ok = test_failures("tif") && ok;
+    ok = test_failures("png") && ok;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/MeshPartitionIndex.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    int                     side;
+    int                     partsize;
+    int                     nboxes;
+    double                  boxsize;
+    std::string             file;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"side", 1, "500", "Number of nodes along each side of the mesh"},
+                                         {"partsize", 1, "4096", "Number of nodes per partition"},
+                                         {"nboxes", 1, "100", "Number of boxes queried"},
+                                         {"boxsize", 1, "0.1", "Width of the boxes, as a fraction of the mesh"},
+                                         {"file", 1, "test_meshpartition.vpi", "Path of the saved index"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"side", Wasp::CvtToInt, &opt.side, sizeof(opt.side)},
+                                        {"partsize", Wasp::CvtToInt, &opt.partsize, sizeof(opt.partsize)},
+                                        {"nboxes", Wasp::CvtToInt, &opt.nboxes, sizeof(opt.nboxes)},
+                                        {"boxsize", Wasp::CvtToDouble, &opt.boxsize, sizeof(opt.boxsize)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// A jittered grid of nodes on the unit square, split into triangles, with
+// the node lists in the one-based, -1 padded form of MPAS files
+//
+void make_mesh(int side, vector<float> &x, vector<float> &y, vector<int> &vertexOnFace)
+{
+    srand(1);
+    for (int j = 0; j < side; j++) {
+        for (int i = 0; i < side; i++) {
+            x.push_back((i + 0.4 * rand() / (double)RAND_MAX) / side);
+            y.push_back((j + 0.4 * rand() / (double)RAND_MAX) / side);
+        }
+    }
+
+    for (int j = 0; j < side - 1; j++) {
+        for (int i = 0; i < side - 1; i++) {
+            int n = j * side + i + 1;
+            int tri[2][4] = {{n, n + 1, n + side, -1}, {n + 1, n + side + 1, n + side, -1}};
+            for (int t = 0; t < 2; t++) vertexOnFace.insert(vertexOnFace.end(), tri[t], tri[t] + 4);
+        }
+    }
+}
+
+// Every face that intersects the box must have all of its nodes in the
+// partitions returned for the box
+//
+bool check_box(const MeshPartitionIndex &index, const vector<float> &x, const vector<float> &y, const vector<int> &vertexOnFace, const vector<double> &min, const vector<double> &max,
+               size_t &nread)
+{
+    vector<size_t> partitions, nodes;
+    index.Query(min, max, partitions);
+    index.GetNodes(partitions, nodes);
+    nread += nodes.size();
+
+    for (size_t f = 0; f < vertexOnFace.size() / 4; f++) {
+        const int *ptr = &vertexOnFace[f * 4];
+        double     fmin[2] = {1e30, 1e30}, fmax[2] = {-1e30, -1e30};
+        for (int i = 0; i < 3; i++) {
+            fmin[0] = std::min(fmin[0], (double)x[ptr[i] - 1]);
+            fmin[1] = std::min(fmin[1], (double)y[ptr[i] - 1]);
+            fmax[0] = std::max(fmax[0], (double)x[ptr[i] - 1]);
+            fmax[1] = std::max(fmax[1], (double)y[ptr[i] - 1]);
+        }
+        if (fmin[0] > max[0] || fmax[0] < min[0] || fmin[1] > max[1] || fmax[1] < min[1]) continue;
+
+        for (int i = 0; i < 3; i++) {
+            if (!std::binary_search(nodes.begin(), nodes.end(), (size_t)(ptr[i] - 1))) {
+                cout << "Face " << f << " is missing node " << ptr[i] - 1 << endl;
+                return (false);
+            }
+        }
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.side > 1 && opt.partsize > 0);
+
+    bool          ok = true;
+    vector<float> x, y;
+    vector<int>   vertexOnFace;
+    make_mesh(opt.side, x, y, vertexOnFace);
+    size_t nNodes = x.size();
+    size_t nFaces = vertexOnFace.size() / 4;
+
+    double             t0 = Wasp::GetTime();
+    MeshPartitionIndex index;
+    int                rc = index.Build(nNodes, x.data(), y.data(), nFaces, vertexOnFace.data(), 4, -1, opt.partsize);
+    double             buildTime = Wasp::GetTime() - t0;
+    VAssert(rc == 0);
+
+    // A saved index must come back identical, and only for its own key
+    // and mesh size
+    //
+    MeshPartitionIndex restored;
+    t0 = Wasp::GetTime();
+    if (index.Write(opt.file, "key") < 0 || restored.Read(opt.file, "key", nNodes) < 0) {
+        cout << "Failed to save and restore " << opt.file << endl;
+        ok = false;
+    }
+    double readTime = Wasp::GetTime() - t0;
+
+    if (restored.Read(opt.file, "other key", nNodes) == 0 || restored.Read(opt.file, "key", nNodes + 1) == 0) {
+        cout << "Stale index was accepted" << endl;
+        ok = false;
+    }
+    (void)remove(opt.file.c_str());
+
+    srand(2);
+    size_t nread = 0;
+    t0 = Wasp::GetTime();
+    for (int b = 0; b < opt.nboxes && ok; b++) {
+        vector<double> min(2), max(2);
+        for (int i = 0; i < 2; i++) {
+            min[i] = (1.0 - opt.boxsize) * rand() / (double)RAND_MAX;
+            max[i] = min[i] + opt.boxsize;
+        }
+        ok = check_box(index, x, y, vertexOnFace, min, max, nread) && ok;
+        ok = check_box(restored, x, y, vertexOnFace, min, max, nread) && ok;
+    }
+    double queryTime = Wasp::GetTime() - t0;
+
+    // Connectivity outside of a subset becomes a boundary, and missing
+    // values are kept
+    //
+    vector<size_t> subset = {2, 5, 9};
+    vector<int>    ids = {3, 6, 10, 4, 0, -1, -2};
+    vector<int>    expect = {0, 1, 2, -2, -1, -1, -2};
+    MeshPartitionIndex::Remap(ids.data(), ids.size(), -1, subset);
+    if (ids != expect) {
+        cout << "Remap failed" << endl;
+        ok = false;
+    }
+
+    printf("%lu nodes, %lu partitions\n", nNodes, index.GetNumPartitions());
+    printf("Build %.3f sec, save and restore %.3f sec, %d queries %.3f sec\n", buildTime, readTime, 2 * opt.nboxes, queryTime);
+    printf("Nodes read per box: %.2f%% of mesh for a box of %.2f%% of its area\n", 100.0 * nread / (2.0 * opt.nboxes * nNodes), 100.0 * opt.boxsize * opt.boxsize);
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}
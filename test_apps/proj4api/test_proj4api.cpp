@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/MyBase.h>
+#include <vapor/Proj4API.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    int                     n;
+    int                     nthreads;
+    string                  proj4string;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"n", 1, "200000", "Number of points transformed"},
+                                         {"nthreads", 1, "4", "Number of threads used by TransformParallel()"},
+                                         {"proj4string", 1, "+proj=lcc +lat_1=30 +lat_2=60 +lat_0=40 +lon_0=-100 +ellps=WGS84", "Projection of the points"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"n", Wasp::CvtToInt, &opt.n, sizeof(opt.n)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"proj4string", Wasp::CvtToCPPStr, &opt.proj4string, sizeof(opt.proj4string)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Longitudes and latitudes of a grid of n points over North America
+//
+void make_points(size_t n, vector<float> &x, vector<float> &y)
+{
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = -140.0 + 80.0 * (i % 997) / 996.0;
+        y[i] = 15.0 + 60.0 * (i / 997) / (double)(n / 997 + 1);
+    }
+}
+
+// Transform the same points serially and in parallel. The results must
+// be identical: each point is transformed by the same code either way.
+//
+bool test_transform(const Proj4API &proj4, vector<float> x, vector<float> y, string label)
+{
+    vector<float> px = x;
+    vector<float> py = y;
+
+    int rc = proj4.Transform(x.data(), y.data(), x.size());
+    int prc = proj4.TransformParallel(px.data(), py.data(), px.size(), opt.nthreads);
+    if (rc < 0 || prc < 0) {
+        cout << label << " : transform failed" << endl;
+        return (false);
+    }
+
+    size_t ndiff = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i] != px[i] || y[i] != py[i]) ndiff++;
+    }
+    if (ndiff) {
+        cout << label << " : " << ndiff << " of " << x.size() << " points differ" << endl;
+        return (false);
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+
+    Proj4API forward;
+    if (forward.Initialize("", opt.proj4string) < 0) return (1);
+
+    vector<float> x, y;
+    make_points(opt.n, x, y);
+
+    // Enough points to be split between the threads, and too few to be
+    // worth splitting
+    //
+    if (!test_transform(forward, x, y, "forward")) ok = false;
+    {
+        vector<float> sx(x.begin(), x.begin() + 100);
+        vector<float> sy(y.begin(), y.begin() + 100);
+        if (!test_transform(forward, sx, sy, "forward, few points")) ok = false;
+    }
+
+    // Back to geographic coordinates
+    //
+    Proj4API inverse;
+    if (inverse.Initialize(opt.proj4string, "") < 0) return (1);
+
+    vector<float> px = x;
+    vector<float> py = y;
+    if (forward.Transform(px.data(), py.data(), px.size()) < 0) return (1);
+    if (!test_transform(inverse, px, py, "inverse")) ok = false;
+
+    // A point that can't be projected fails both methods, with an error
+    // message
+    //
+    vector<float> bx = x;
+    vector<float> by = y;
+    by[by.size() - 1] = 100.0;
+    if (forward.TransformParallel(bx.data(), by.data(), bx.size(), opt.nthreads) == 0) {
+        cout << "TransformParallel() accepted a latitude of 100 degrees" << endl;
+        ok = false;
+    } else if (string(MyBase::GetErrMsg()).find("pj_transform") == string::npos) {
+        cout << "TransformParallel() failed without an error message" << endl;
+        ok = false;
+    }
+    bx = x;
+    by = y;
+    by[by.size() - 1] = 100.0;
+    if (forward.Transform(bx.data(), by.data(), bx.size()) == 0) {
+        cout << "Transform() accepted a latitude of 100 degrees" << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -1,4 +1,8 @@
 #include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include "vapor/VAssert.h"
 
 #include <vapor/FileUtils.h>
@@ -13,12 +17,22 @@ using namespace VAPoR;
 
 struct {
     int                     n;
+    int                     nthreads;
+    string                  file;
     OptionParser::Boolean_T help;
 } opt;
 
-OptionParser::OptDescRec_T set_opts[] = {{"n", 1, "1000", "Quad mesh X & Y dimensions"}, {"help", 0, "", "Print this message and exit"}, {NULL}};
+OptionParser::OptDescRec_T set_opts[] = {{"n", 1, "1000", "Quad mesh X & Y dimensions"},
+                                         {"nthreads", 1, "0", "Number of threads used to build a tree at once. Zero for one per core"},
+                                         {"file", 1, "test_quadtreerectangle.qtr", "File a tree is saved to"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
 
-OptionParser::Option_T get_options[] = {{"n", Wasp::CvtToInt, &opt.n, sizeof(opt.n)}, {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)}, {NULL}};
+OptionParser::Option_T get_options[] = {{"n", Wasp::CvtToInt, &opt.n, sizeof(opt.n)},
+                                        {"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
 
 const char *ProgName;
 
@@ -96,6 +110,112 @@ void test_mesh()
     print_histo(qtr);
 }
 
+// The cells of a curvilinear mesh: a unit square mesh whose nodes are
+// displaced, so that cells have different sizes and overlapping bounds
+//
+void make_cells(size_t n, vector<float> &rects, vector<size_t> &payloads)
+{
+    rects.clear();
+    payloads.clear();
+
+    float delta = 1.0 / (float)(n - 1);
+    auto  node = [&](size_t i, size_t j, float &x, float &y) {
+        x = i * delta + 0.3 * delta * sin(j * 0.05) * (i > 0 && i < n - 1);
+        y = j * delta + 0.3 * delta * cos(i * 0.07) * (j > 0 && j < n - 1);
+    };
+
+    for (size_t j = 0; j < n - 1; j++) {
+        for (size_t i = 0; i < n - 1; i++) {
+            float left = 1.0, right = 0.0, top = 1.0, bottom = 0.0;
+            for (size_t jj = 0; jj < 2; jj++) {
+                for (size_t ii = 0; ii < 2; ii++) {
+                    float x, y;
+                    node(i + ii, j + jj, x, y);
+                    left = std::min(left, x);
+                    right = std::max(right, x);
+                    top = std::min(top, y);
+                    bottom = std::max(bottom, y);
+                }
+            }
+            rects.insert(rects.end(), {left, top, right, bottom});
+            payloads.push_back(j * (n - 1) + i);
+        }
+    }
+}
+
+double query(const QuadTreeRectangle<float, size_t> &qtr, const vector<float> &x, const vector<float> &y, vector<vector<size_t>> &results)
+{
+    results.resize(x.size());
+    double t0 = Wasp::GetTime();
+    for (size_t i = 0; i < x.size(); i++) qtr.GetPayloadContained(x[i], y[i], results[i]);
+    return (Wasp::GetTime() - t0);
+}
+
+// Build the tree of a mesh one cell at a time and all at once, save it
+// and read it back. All three trees must give the same answers.
+//
+bool benchmark()
+{
+    size_t n = opt.n;
+    VAssert(n >= 2);
+
+    vector<float>  rects;
+    vector<size_t> payloads;
+    make_cells(n, rects, payloads);
+
+    double                           t0 = Wasp::GetTime();
+    QuadTreeRectangle<float, size_t> incremental(0.0, 0.0, 1.0, 1.0, 12, n * n);
+    for (size_t i = 0; i < payloads.size(); i++) incremental.Insert(rects[4 * i], rects[4 * i + 1], rects[4 * i + 2], rects[4 * i + 3], payloads[i]);
+    double t1 = Wasp::GetTime();
+
+    QuadTreeRectangle<float, size_t> bulk(0.0, 0.0, 1.0, 1.0, 12, n * n);
+    bulk.Insert(rects, payloads, opt.nthreads);
+    double t2 = Wasp::GetTime();
+
+    if (bulk.Write(opt.file, "test") < 0) {
+        cout << "Failed to write " << opt.file << endl;
+        return (false);
+    }
+    double t3 = Wasp::GetTime();
+
+    QuadTreeRectangle<float, size_t> saved;
+    if (saved.Read(opt.file, "test") < 0) {
+        cout << "Failed to read " << opt.file << endl;
+        return (false);
+    }
+    double t4 = Wasp::GetTime();
+
+    bool ok = true;
+    if (saved.Read(opt.file, "stale") == 0) {
+        cout << "Read a tree saved with a different key" << endl;
+        ok = false;
+    }
+    (void)remove(opt.file.c_str());
+
+    srand(1);
+    vector<float> x, y;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        x.push_back(rand() / (float)RAND_MAX);
+        y.push_back(rand() / (float)RAND_MAX);
+    }
+
+    vector<vector<size_t>> ref, results;
+    double                 qIncremental = query(incremental, x, y, ref);
+    double                 qBulk = query(bulk, x, y, results);
+    size_t                 ndiffer = 0;
+    for (size_t i = 0; i < ref.size(); i++) ndiffer += ref[i] != results[i];
+    double qSaved = query(saved, x, y, results);
+    for (size_t i = 0; i < ref.size(); i++) ndiffer += ref[i] != results[i];
+
+    printf("%-12s %10s %14s\n", "Tree", "build (s)", "query (usec)");
+    printf("%-12s %10.3f %14.3f\n", "incremental", t1 - t0, qIncremental / x.size() * 1e6);
+    printf("%-12s %10.3f %14.3f\n", "bulk", t2 - t1, qBulk / x.size() * 1e6);
+    printf("%-12s %10.3f %14.3f\n", "saved", t4 - t3, qSaved / x.size() * 1e6);
+    printf("Write time %.3f s, %lu differing queries\n", t3 - t2, ndiffer);
+
+    return (ok && ndiffer == 0);
+}
+
 int main(int argc, char **argv)
 {
     OptionParser op;
@@ -145,5 +265,11 @@ int main(int argc, char **argv)
 
     test_mesh();
 
+    if (!benchmark()) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
     return 0;
 }
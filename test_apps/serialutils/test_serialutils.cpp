@@ -0,0 +1,205 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/MyBase.h>
+#include <vapor/SerialUtils.h>
+
+using namespace Wasp;
+
+struct {
+    int                     nthreads;
+    int                     nwrites;
+    string                  file;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "4", "Number of threads writing the same file"},
+                                         {"nwrites", 1, "200", "Number of times each thread writes the file"},
+                                         {"file", 1, "test_serialutils.bin", "File written"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"nwrites", Wasp::CvtToInt, &opt.nwrites, sizeof(opt.nwrites)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// A record that is only valid if it was written completely: a count of
+// strings, the strings, and a checksum of them
+//
+bool write_record(std::ostream &o, int writer, int n)
+{
+    vector<string> v;
+    for (int i = 0; i < n; i++) v.push_back(string(100 + i, 'a' + writer % 26));
+
+    uint64_t h = SerialUtils::FNVOffset;
+    for (const auto &s : v) h = SerialUtils::FNV1a(s, h);
+
+    SerialUtils::WriteStrings(o, v);
+    SerialUtils::WriteU64(o, h);
+    return ((bool)o);
+}
+
+bool read_record(std::istream &i)
+{
+    vector<string> v;
+    uint64_t       h;
+    if (!SerialUtils::ReadStrings(i, v) || !SerialUtils::ReadU64(i, h)) return (false);
+
+    uint64_t myh = SerialUtils::FNVOffset;
+    for (const auto &s : v) myh = SerialUtils::FNV1a(s, myh);
+    return (h == myh);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+
+    // Round trip through a stream
+    //
+    {
+        std::stringstream ss;
+        vector<string>    strs = {"", "one", string(1000, 'x'), string("with\0nul", 8)};
+        SerialUtils::WriteU64(ss, 0);
+        SerialUtils::WriteU64(ss, 0xfedcba9876543210ULL);
+        SerialUtils::WriteString(ss, "hello");
+        SerialUtils::WriteStrings(ss, strs);
+
+        uint64_t       a, b;
+        string         s;
+        vector<string> v;
+        if (!SerialUtils::ReadU64(ss, a) || !SerialUtils::ReadU64(ss, b) || !SerialUtils::ReadString(ss, s) || !SerialUtils::ReadStrings(ss, v)) {
+            cout << "Round trip read failed" << endl;
+            ok = false;
+        } else if (a != 0 || b != 0xfedcba9876543210ULL || s != "hello" || v != strs) {
+            cout << "Round trip values differ" << endl;
+            ok = false;
+        }
+
+        // Nothing left to read
+        //
+        if (SerialUtils::ReadU64(ss, a)) {
+            cout << "Read past the end" << endl;
+            ok = false;
+        }
+    }
+
+    // Truncated and corrupt input is rejected
+    //
+    {
+        std::stringstream ss;
+        SerialUtils::WriteString(ss, "truncated string");
+        string            data = ss.str();
+        std::stringstream truncated(data.substr(0, data.size() - 1));
+        string            s;
+        if (SerialUtils::ReadString(truncated, s)) {
+            cout << "Truncated string accepted" << endl;
+            ok = false;
+        }
+
+        std::stringstream corrupt;
+        SerialUtils::WriteU64(corrupt, 1ULL << 40);
+        if (SerialUtils::ReadString(corrupt, s)) {
+            cout << "Corrupt string length accepted" << endl;
+            ok = false;
+        }
+    }
+
+    // FNV-1a reference values
+    //
+    if (SerialUtils::FNV1a(string("")) != 0xcbf29ce484222325ULL || SerialUtils::FNV1a(string("a")) != 0xaf63dc4c8601ec8cULL || SerialUtils::FNV1a(string("foobar")) != 0x85944171f73967e8ULL) {
+        cout << "Wrong FNV-1a hash" << endl;
+        ok = false;
+    }
+    if (SerialUtils::FNV1a(string("bar"), SerialUtils::FNV1a(string("foo"))) != SerialUtils::FNV1a(string("foobar"))) {
+        cout << "FNV-1a hash doesn't chain" << endl;
+        ok = false;
+    }
+
+    // Several threads replace the file while another reads it. The
+    // reader must only ever see complete records.
+    //
+    (void)remove(opt.file.c_str());
+    if (SerialUtils::WriteFileAtomic(opt.file, [](std::ostream &o) { return (write_record(o, 0, 10)); }) < 0) {
+        cout << "Could not write " << opt.file << endl;
+        return (1);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<int>  nfailed(0);
+    std::atomic<int>  nread(0);
+    std::thread       reader([&] {
+        while (!done) {
+            std::ifstream in(opt.file.c_str(), std::ios::in | std::ios::binary);
+            if (!in || !read_record(in)) nfailed++;
+            nread++;
+        }
+    });
+
+    vector<std::thread> writers;
+    for (int t = 0; t < opt.nthreads; t++) {
+        writers.emplace_back([t] {
+            for (int i = 0; i < opt.nwrites; i++) {
+                if (SerialUtils::WriteFileAtomic(opt.file, [t, i](std::ostream &o) { return (write_record(o, t, 10 + i % 50)); }) < 0) return;
+            }
+        });
+    }
+    for (auto &w : writers) w.join();
+    done = true;
+    reader.join();
+
+    if (nfailed) {
+        cout << nfailed << " of " << nread << " reads saw an incomplete file" << endl;
+        ok = false;
+    }
+
+    // A failed write leaves the file alone
+    //
+    if (SerialUtils::WriteFileAtomic(opt.file, [](std::ostream &o) { return (false); }) == 0) {
+        cout << "Failed write reported success" << endl;
+        ok = false;
+    }
+    {
+        std::ifstream in(opt.file.c_str(), std::ios::in | std::ios::binary);
+        if (!in || !read_record(in)) {
+            cout << "Failed write damaged the file" << endl;
+            ok = false;
+        }
+    }
+    (void)remove(opt.file.c_str());
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
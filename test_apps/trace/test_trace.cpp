@@ -0,0 +1,205 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/MyBase.h>
+#include <vapor/Trace.h>
+
+using namespace Wasp;
+
+struct {
+    int                     nthreads;
+    int                     nevents;
+    string                  output;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "4", "Number of threads recording events"},
+                                         {"nevents", 1, "20000", "Number of events recorded by each thread"},
+                                         {"output", 1, "test_trace.json", "Chrome trace file written"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"nevents", Wasp::CvtToInt, &opt.nevents, sizeof(opt.nevents)},
+                                        {"output", Wasp::CvtToCPPStr, &opt.output, sizeof(opt.output)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+int evaluated = 0;
+
+const char *touch()
+{
+    evaluated++;
+    return ("touched");
+}
+
+// Each thread records nested spans, messages and counters
+//
+void record(int n)
+{
+    for (int i = 0; i < n; i++) {
+        VTRACE_SCOPE("outer");
+        {
+            VTRACE_SCOPE("inner");
+            VTRACE_COUNT("test.count", 1);
+            VTRACE_COUNT("test.bytes", 16);
+        }
+        VTRACE_MSG(Trace::Debug, "event %d", i);
+    }
+}
+
+size_t count(const string &s, const string &sub)
+{
+    size_t n = 0;
+    for (size_t pos = s.find(sub); pos != string::npos; pos = s.find(sub, pos + 1)) n++;
+    return (n);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+
+    // Nothing is recorded, or evaluated, while tracing is off. Counters
+    // are kept regardless.
+    //
+    Trace::SetLevel(Trace::Off);
+    Trace::Clear();
+    VTRACE_MSG(Trace::Error, "%s", touch());
+    record(10);
+    if (evaluated != 0) {
+        cout << "Arguments of a disabled message were evaluated" << endl;
+        ok = false;
+    }
+    if (Trace::GetCounters()["test.count"] != 10) {
+        cout << "Counter not updated while tracing is off" << endl;
+        ok = false;
+    }
+
+    // The cost of a diagnostic message nobody reads
+    //
+    double t0 = Wasp::GetTime();
+    for (int i = 0; i < opt.nevents; i++) MyBase::SetDiagMsg("DataMgr::GetVariable(%d,%s,%d,%d,%d)", i, "var", 0, 0, 0);
+    double diagOff = Wasp::GetTime() - t0;
+
+    // Record from several threads. The buffers only keep the most recent
+    // events, so give them room for all of them.
+    //
+    Trace::SetLevel(Trace::Debug);
+    Trace::SetBufferSize(3 * opt.nevents);
+    Trace::Clear();
+
+    t0 = Wasp::GetTime();
+    vector<std::thread> threads;
+    for (int i = 0; i < opt.nthreads; i++) threads.emplace_back(record, opt.nevents);
+    for (auto &t : threads) t.join();
+    double recordTime = Wasp::GetTime() - t0;
+
+    int64_t expected = (int64_t)opt.nthreads * opt.nevents;
+    auto    counters = Trace::GetCounters();
+    if (counters["test.count"] != expected || counters["test.bytes"] != 16 * expected) {
+        cout << "Counters " << counters["test.count"] << " " << counters["test.bytes"] << ", expected " << expected << endl;
+        ok = false;
+    }
+
+    // Diagnostic messages go to the trace at the Debug level
+    //
+    MyBase::SetDiagMsg("diagnostic %d", 42);
+
+    if (Trace::WriteChromeTrace(opt.output) < 0) return (1);
+
+    std::ifstream     in(opt.output.c_str());
+    std::stringstream ss;
+    ss << in.rdbuf();
+    string json = ss.str();
+
+    size_t spans = count(json, "\"ph\":\"X\"");
+    size_t messages = count(json, "\"ph\":\"i\"");
+    if (spans != 2 * expected || messages != expected + 1 || count(json, "\"name\":\"diagnostic 42\"") != 1) {
+        cout << "Trace has " << spans << " spans and " << messages << " messages" << endl;
+        ok = false;
+    }
+    if (json.compare(0, 15, "{\"traceEvents\":") != 0 || json.find("\"name\":\"test.count\",\"ph\":\"C\"") == string::npos) {
+        cout << "Malformed trace" << endl;
+        ok = false;
+    }
+
+    // Full buffers keep the most recent events
+    //
+    Trace::SetBufferSize(10);
+    Trace::Clear();
+    std::thread small([] {
+        for (int i = 0; i < 100; i++) VTRACE_MSG(Trace::Info, "wrap %d", i);
+    });
+    small.join();
+    if (Trace::WriteChromeTrace(opt.output) < 0) return (1);
+    {
+        std::ifstream     in(opt.output.c_str());
+        std::stringstream ss;
+        ss << in.rdbuf();
+        string json = ss.str();
+        if (count(json, "\"name\":\"wrap ") != 10 || json.find("\"wrap 99\"") == string::npos || json.find("\"wrap 89\"") != string::npos) {
+            cout << "Ring buffer did not keep the last events" << endl;
+            ok = false;
+        }
+    }
+
+    // Threads that exit hand their buffers on, so that starting threads
+    // doesn't grow memory. Only the most recent exited threads keep their
+    // unwritten events.
+    //
+    Trace::Clear();
+    for (int i = 0; i < 100; i++) {
+        std::thread t([i] { VTRACE_MSG(Trace::Info, "exited %d", i); });
+        t.join();
+    }
+    if (Trace::WriteChromeTrace(opt.output) < 0) return (1);
+    {
+        std::ifstream     in(opt.output.c_str());
+        std::stringstream ss;
+        ss << in.rdbuf();
+        string json = ss.str();
+        size_t n = count(json, "\"name\":\"exited ");
+        if (n == 0 || n > 16 || json.find("\"exited 99\"") == string::npos || json.find("\"exited 0\"") != string::npos) {
+            cout << "Trace kept the events of " << n << " exited threads" << endl;
+            ok = false;
+        }
+    }
+    Trace::SetLevel(Trace::Off);
+
+    printf("Unread diagnostic message : %.1f ns\n", diagOff / opt.nevents * 1e9);
+    printf("Recorded event            : %.1f ns\n", recordTime / (3.0 * expected) * 1e9);
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
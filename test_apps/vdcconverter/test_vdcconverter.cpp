@@ -0,0 +1,216 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/VDCNetCDF.h>
+#include <vapor/VDCConverter.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    string                  dir;
+    std::vector<size_t>     dims;
+    int                     nts;
+    int                     nworkers;
+    int                     crashafter;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dir", 1, "test_vdcconverter.d", "Directory for the source and destination VDCs"},
+                                         {"dims", 1, "24:20:16", "Colon delimited 3-element vector specifying grid dimensions"},
+                                         {"nts", 1, "6", "Number of time steps"},
+                                         {"nworkers", 1, "2", "Number of worker processes"},
+                                         {"crashafter", 1, "7", "Number of items copied before the first conversion is killed"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dir", Wasp::CvtToCPPStr, &opt.dir, sizeof(opt.dir)},
+                                        {"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"nts", Wasp::CvtToInt, &opt.nts, sizeof(opt.nts)},
+                                        {"nworkers", Wasp::CvtToInt, &opt.nworkers, sizeof(opt.nworkers)},
+                                        {"crashafter", Wasp::CvtToInt, &opt.crashafter, sizeof(opt.crashafter)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+const vector<string> coordvars = {"x", "y", "z", "t"};
+const vector<string> datavars = {"u", "v"};
+
+float value(string varname, size_t ts, size_t i) { return ((varname == "u" ? 1.0f : -1.0f) * (ts * 1000.0f + i % 997)); }
+
+// Define a VDC with two time varying 3D variables. Each time step of a
+// variable is stored in its own file, so the conversion has many
+// groups to hand out. If write is true the data are written too.
+//
+int make_vdc(string master, bool write)
+{
+    VDCNetCDF vdc(1, 0, 1);
+    if (vdc.Initialize(master, vector<string>(), VDC::W, {8, 8, 8}, 0) < 0) return (-1);
+
+    vector<string> dimnames = {"x", "y", "z", "t"};
+    for (int i = 0; i < 3; i++) {
+        if (vdc.DefineDimension(dimnames[i], opt.dims[i], i) < 0) return (-1);
+    }
+    if (vdc.DefineDimension("t", opt.nts, 3) < 0) return (-1);
+
+    for (const auto &v : datavars) {
+        if (vdc.DefineDataVar(v, dimnames, dimnames, "", DC::XType::FLOAT, false) < 0) return (-1);
+    }
+    if (vdc.EndDefine() < 0) return (-1);
+
+    if (!write) return (0);
+
+    for (int i = 0; i < 3; i++) {
+        vector<float> coords(opt.dims[i]);
+        for (size_t j = 0; j < coords.size(); j++) coords[j] = j * (i + 1.0f);
+        if (vdc.PutVar(dimnames[i], -1, coords.data()) < 0) return (-1);
+    }
+
+    size_t        n = opt.dims[0] * opt.dims[1] * opt.dims[2];
+    vector<float> buf(n);
+    for (int ts = 0; ts < opt.nts; ts++) {
+        float t = ts * 0.5f;
+        if (vdc.PutVar(ts, "t", -1, &t) < 0) return (-1);
+
+        for (const auto &v : datavars) {
+            for (size_t i = 0; i < n; i++) buf[i] = value(v, ts, i);
+            if (vdc.PutVar(ts, v, -1, buf.data()) < 0) return (-1);
+        }
+    }
+    return (0);
+}
+
+VDCConverter::DCFactory factory(string src)
+{
+    return ([src]() -> DC * {
+        VDCNetCDF *dc = new VDCNetCDF(1);
+        if (dc->Initialize(src, vector<string>(), VDC::R) < 0) {
+            delete dc;
+            return (NULL);
+        }
+        return (dc);
+    });
+}
+
+// Return the number of values of the destination that differ from the
+// source
+//
+size_t compare(DC &src, DC &dst)
+{
+    size_t ndiff = 0;
+    for (const auto &v : datavars) {
+        for (int ts = 0; ts < opt.nts; ts++) {
+            size_t        n = opt.dims[0] * opt.dims[1] * opt.dims[2];
+            vector<float> a(n), b(n);
+            if (src.GetVar(ts, v, -1, -1, a.data()) < 0 || dst.GetVar(ts, v, -1, -1, b.data()) < 0) return (n);
+            for (size_t i = 0; i < n; i++) {
+                if (a[i] != b[i]) ndiff++;
+            }
+        }
+    }
+    return (ndiff);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help || opt.dims.size() != 3) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (opt.help ? 0 : 1);
+    }
+
+    (void)FileUtils::MakeDir(opt.dir);
+    string src = FileUtils::JoinPaths({opt.dir, "src.nc"});
+    string dst = FileUtils::JoinPaths({opt.dir, "dst.nc"});
+    string checkpoint = FileUtils::JoinPaths({opt.dir, "dst.ckpt"});
+    (void)remove(checkpoint.c_str());
+
+    if (make_vdc(src, true) < 0 || make_vdc(dst, false) < 0) return (1);
+
+    bool ok = true;
+
+    // Kill the first conversion, as a crash would, part way through
+    //
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        VDCNetCDF dc(1);
+        if (dc.Initialize(src, vector<string>(), VDC::R) < 0) _exit(1);
+
+        int          ncopied = 0;
+        VDCConverter converter(factory(src), dst, opt.nworkers, 1);
+        converter.SetCheckpoint(checkpoint);
+        converter.SetProgressFunc([&ncopied](const string &varname, size_t ts, int status) {
+            if (status >= 0 && ++ncopied == opt.crashafter) _exit(3);
+        });
+        converter.Convert(dc, coordvars, datavars);
+        _exit(0);
+    }
+
+    int wstatus;
+    if (pid < 0 || waitpid(pid, &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 3) {
+        cout << "First conversion did not stop after " << opt.crashafter << " items" << endl;
+        ok = false;
+    }
+    if (!FileUtils::Exists(checkpoint)) {
+        cout << "No checkpoint file written" << endl;
+        ok = false;
+    }
+
+    // The second conversion copies only what the first didn't finish
+    //
+    VDCNetCDF dc(1);
+    if (dc.Initialize(src, vector<string>(), VDC::R) < 0) return (1);
+
+    VDCConverter converter(factory(src), dst, opt.nworkers, 1);
+    converter.SetCheckpoint(checkpoint);
+    int rc = converter.Convert(dc, coordvars, datavars);
+    converter.PrintStats();
+
+    VDCConverter::Stats stats = converter.GetStats();
+    if (rc < 0 || stats.nfailed) {
+        cout << "Resumed conversion failed" << endl;
+        ok = false;
+    }
+    if (stats.nskipped != opt.crashafter) {
+        cout << "Skipped " << stats.nskipped << " items, expected " << opt.crashafter << endl;
+        ok = false;
+    }
+    if (FileUtils::Exists(checkpoint)) {
+        cout << "Checkpoint file not removed" << endl;
+        ok = false;
+    }
+
+    VDCNetCDF out(1);
+    if (out.Initialize(dst, vector<string>(), VDC::R) < 0) return (1);
+    size_t ndiff = compare(dc, out);
+    if (ndiff) {
+        cout << ndiff << " values differ from the source" << endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/WASP.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    int                     nthreads;
+    vector<int>             dims;
+    vector<int>             bs;
+    string                  wname;
+    string                  file;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "4", "Number of threads of the pipelined read. Must be more than one"},
+                                         {"dims", 1, "150:100:70", "Colon delimited dimensions of the variable, fastest varying first"},
+                                         {"bs", 1, "64:64:64", "Colon delimited block dimensions"},
+                                         {"wname", 1, "bior4.4", "Wavelet name"},
+                                         {"file", 1, "test_wasp.nc", "File written and read"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)},
+                                        {"dims", Wasp::CvtToIntVec, &opt.dims, sizeof(opt.dims)},
+                                        {"bs", Wasp::CvtToIntVec, &opt.bs, sizeof(opt.bs)},
+                                        {"wname", Wasp::CvtToCPPStr, &opt.wname, sizeof(opt.wname)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+const vector<size_t> cratios = {500, 100, 10, 1};
+
+// Write a smooth field with some high frequency content, so that every
+// compression level has significant coefficients. Each compression level
+// is stored in its own file, as in a VDC.
+//
+int write_var(const vector<size_t> &dims)
+{
+    WASP   wasp(1);
+    size_t chsz = 0;
+    if (wasp.Create(opt.file, NC_64BIT_OFFSET | NC_WRITE, 0, chsz, cratios.size()) < 0) return (-1);
+
+    vector<string> dimnames = {"z", "y", "x"};    // NetCDF order
+    for (int i = 0; i < 3; i++) {
+        if (wasp.DefDim(dimnames[i], dims[2 - i]) < 0) return (-1);
+    }
+
+    vector<size_t> bs = {(size_t)opt.bs[2], (size_t)opt.bs[1], (size_t)opt.bs[0]};
+    if (wasp.DefVar("var", NC_FLOAT, dimnames, opt.wname, bs, cratios) < 0) return (-1);
+    if (wasp.EndDef() < 0) return (-1);
+
+    vector<float> data(dims[0] * dims[1] * dims[2]);
+    for (size_t k = 0, n = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++, n++) data[n] = std::sin(i * 0.05) * std::cos(j * 0.07) + 0.1 * std::sin(k * 0.9 + i * 1.3);
+        }
+    }
+
+    if (wasp.OpenVarWrite("var", -1) < 0) return (-1);
+    if (wasp.PutVar(data.data()) < 0) return (-1);
+    if (wasp.CloseVar() < 0) return (-1);
+    return (wasp.Close());
+}
+
+// Read a region of the variable at the given level and lod
+//
+int read_var(int nthreads, int level, int lod, const vector<size_t> &start, const vector<size_t> &count, vector<float> &data, size_t &nblocks)
+{
+    WASP wasp(nthreads);
+    if (wasp.Open(opt.file, NC_NOWRITE) < 0) return (-1);
+    if (wasp.OpenVarRead("var", level, lod) < 0) return (-1);
+
+    data.assign(count[0] * count[1] * count[2], 0.0);
+    if (wasp.GetVara(start, count, data.data()) < 0) return (-1);
+
+    size_t nbytes;
+    double ioTime, totalTime;
+    wasp.GetReadStats(nblocks, nbytes, ioTime, totalTime);
+
+    if (wasp.CloseVar() < 0) return (-1);
+    return (wasp.Close());
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    if (opt.nthreads < 2 || opt.dims.size() != 3 || opt.bs.size() != 3) {
+        cerr << "Need 2 or more threads, and 3 dimensions" << endl;
+        return (1);
+    }
+
+    vector<size_t> dims = {(size_t)opt.dims[0], (size_t)opt.dims[1], (size_t)opt.dims[2]};
+    if (write_var(dims) < 0) return (1);
+
+    bool ok = true;
+
+    // The whole variable, and a region that doesn't line up with the
+    // blocks, at every level and lod. A read with one thread uses the
+    // serial decode, with more threads the pipelined one.
+    //
+    vector<vector<size_t>> starts = {{0, 0, 0}, {dims[2] / 5, dims[1] / 3, dims[0] / 7}};
+    vector<vector<size_t>> counts = {{dims[2], dims[1], dims[0]}, {dims[2] / 2, dims[1] / 2, dims[0] / 2}};
+
+    WASP wasp(1);
+    if (wasp.Open(opt.file, NC_NOWRITE) < 0) return (1);
+    int                    nlevels = wasp.InqVarNumRefLevels("var");
+    vector<vector<size_t>> levelDims(nlevels);
+    for (int level = 0; level < nlevels; level++) {
+        vector<size_t> bs;
+        if (wasp.InqVarDimlens("var", level, levelDims[level], bs) < 0) return (1);
+    }
+    wasp.Close();
+
+    size_t ncompared = 0;
+    for (int level = 0; level < nlevels; level++) {
+        for (int lod = 0; lod < (int)cratios.size(); lod++) {
+            for (size_t r = 0; r < starts.size(); r++) {
+                // Regions are given at the native resolution; coarser
+                // levels read the whole variable
+                //
+                vector<size_t> start = starts[r], count = counts[r];
+                if (level != nlevels - 1) {
+                    start.assign(3, 0);
+                    count = levelDims[level];
+                }
+
+                vector<float> serial, pipelined;
+                size_t        sblocks, pblocks;
+                if (read_var(1, level, lod, start, count, serial, sblocks) < 0 || read_var(opt.nthreads, level, lod, start, count, pipelined, pblocks) < 0) {
+                    cout << "Read failed at level " << level << " lod " << lod << endl;
+                    ok = false;
+                    continue;
+                }
+
+                if (pblocks == 0 || pblocks != sblocks) {
+                    printf("Level %d lod %d : %zu blocks read serially, %zu pipelined\n", level, lod, sblocks, pblocks);
+                    ok = false;
+                }
+
+                // Bit for bit
+                //
+                if (std::memcmp(serial.data(), pipelined.data(), serial.size() * sizeof(float)) != 0) {
+                    printf("Level %d lod %d region %zu : pipelined read differs from the serial one\n", level, lod, r);
+                    ok = false;
+                }
+                ncompared++;
+            }
+        }
+    }
+    for (const auto &path : WASP::GetPaths(opt.file, cratios.size())) (void)remove(path.c_str());
+
+    cout << ncompared << " reads compared" << endl;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/FileUtils.h>
+#include <vapor/WASP.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    vector<int>             dims;
+    vector<int>             bs;
+    string                  wname;
+    string                  file;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dims", 1, "150:100:70", "Colon delimited dimensions of the variable, fastest varying first"},
+                                         {"bs", 1, "64:64:64", "Colon delimited block dimensions"},
+                                         {"wname", 1, "bior4.4", "Wavelet name"},
+                                         {"file", 1, "test_wasp_range.nc", "File written and read"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dims", Wasp::CvtToIntVec, &opt.dims, sizeof(opt.dims)},
+                                        {"bs", Wasp::CvtToIntVec, &opt.bs, sizeof(opt.bs)},
+                                        {"wname", Wasp::CvtToCPPStr, &opt.wname, sizeof(opt.wname)},
+                                        {"file", Wasp::CvtToCPPStr, &opt.file, sizeof(opt.file)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+const vector<size_t> cratios = {500, 100, 10, 1};
+
+// Write a field whose range differs from block to block, and whose lossy
+// reconstructions don't reach the extremes of the original data
+//
+int write_var(const vector<size_t> &dims)
+{
+    WASP   wasp(1);
+    size_t chsz = 0;
+    if (wasp.Create(opt.file, NC_64BIT_OFFSET | NC_WRITE, 0, chsz, cratios.size()) < 0) return (-1);
+
+    vector<string> dimnames = {"z", "y", "x"};    // NetCDF order
+    for (int i = 0; i < 3; i++) {
+        if (wasp.DefDim(dimnames[i], dims[2 - i]) < 0) return (-1);
+    }
+
+    vector<size_t> bs = {(size_t)opt.bs[2], (size_t)opt.bs[1], (size_t)opt.bs[0]};
+    if (wasp.DefVar("var", NC_FLOAT, dimnames, opt.wname, bs, cratios) < 0) return (-1);
+    if (wasp.EndDef() < 0) return (-1);
+
+    vector<float> data(dims[0] * dims[1] * dims[2]);
+    for (size_t k = 0, n = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++, n++) data[n] = i * 0.01 + std::cos(j * 0.07) + 0.5 * std::sin(k * 0.9 + i * 1.3);
+        }
+    }
+
+    if (wasp.OpenVarWrite("var", -1) < 0) return (-1);
+    if (wasp.PutVar(data.data()) < 0) return (-1);
+    if (wasp.CloseVar() < 0) return (-1);
+    return (wasp.Close());
+}
+
+// Compare the range returned by GetVaraRange() with the range of the
+// data returned by GetVara() for the same region, level and lod
+//
+bool test_range(WASP &wasp, int level, int lod, const vector<size_t> &start, const vector<size_t> &count)
+{
+    if (wasp.OpenVarRead("var", level, lod) < 0) return (false);
+
+    vector<double> range;
+    int            rc = wasp.GetVaraRange(start, count, range);
+
+    vector<float> data(count[0] * count[1] * count[2]);
+    if (rc != 1 || wasp.GetVara(start, count, data.data()) < 0) {
+        printf("Level %d lod %d : no range\n", level, lod);
+        wasp.CloseVar();
+        return (false);
+    }
+    wasp.CloseVar();
+
+    float min = data[0];
+    float max = data[0];
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i] < min) min = data[i];
+        if (data[i] > max) max = data[i];
+    }
+
+    // Both come from the same reconstruction, so they must match exactly
+    //
+    if (range[0] != min || range[1] != max) {
+        printf("Level %d lod %d start %zu %zu %zu : range (%g, %g), data (%g, %g)\n", level, lod, start[0], start[1], start[2], range[0], range[1], min, max);
+        return (false);
+    }
+    return (true);
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    if (opt.dims.size() != 3 || opt.bs.size() != 3) {
+        cerr << "Need 3 dimensions" << endl;
+        return (1);
+    }
+
+    vector<size_t> dims = {(size_t)opt.dims[0], (size_t)opt.dims[1], (size_t)opt.dims[2]};
+    if (write_var(dims) < 0) return (1);
+
+    WASP wasp(1);
+    if (wasp.Open(opt.file, NC_NOWRITE) < 0) return (1);
+
+    // The block range variable is internal to WASP
+    //
+    vector<string> varnames;
+    if (wasp.InqVarnames(varnames) < 0) return (1);
+    bool ok = varnames.size() == 1 && varnames[0] == "var";
+    if (!ok) cout << "Block range variable is listed" << endl;
+
+    size_t ntests = 0;
+    int    nlevels = wasp.InqVarNumRefLevels("var");
+    for (int level = 0; level < nlevels; level++) {
+        vector<size_t> dims_at_level, bs_at_level;
+        if (wasp.InqVarDimlens("var", level, dims_at_level, bs_at_level) < 0) return (1);
+
+        for (int lod = 0; lod < (int)cratios.size(); lod++) {
+            // The whole variable, the first block, and the last block,
+            // which is clipped by the variable boundary
+            //
+            vector<size_t> last_start, last_count;
+            for (int i = 0; i < 3; i++) {
+                last_start.push_back((dims_at_level[i] - 1) / bs_at_level[i] * bs_at_level[i]);
+                last_count.push_back(dims_at_level[i] - last_start[i]);
+            }
+            vector<size_t> first_count = {min(bs_at_level[0], dims_at_level[0]), min(bs_at_level[1], dims_at_level[1]), min(bs_at_level[2], dims_at_level[2])};
+
+            if (!test_range(wasp, level, lod, {0, 0, 0}, dims_at_level)) ok = false;
+            if (!test_range(wasp, level, lod, {0, 0, 0}, first_count)) ok = false;
+            if (!test_range(wasp, level, lod, last_start, last_count)) ok = false;
+            ntests += 3;
+        }
+    }
+    wasp.Close();
+
+    for (const auto &path : WASP::GetPaths(opt.file, cratios.size())) (void)remove(path.c_str());
+
+    cout << ntests << " ranges compared" << endl;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+    cout << "PASSED" << endl;
+    return (0);
+}
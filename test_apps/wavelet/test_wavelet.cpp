@@ -0,0 +1,179 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/MatWaveDwt.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+struct {
+    std::vector<size_t>     dims;
+    std::vector<string>     wnames;
+    int                     nloops;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"dims", 1, "129:128:127",
+                                          "Colon delimited 3-element vector "
+                                          "specifying signal dimensions"},
+                                         {"wnames", 1, "bior2.2:bior4.4", "Colon delimited list of wavelets"},
+                                         {"nloops", 1, "4", "Number of times each 3D transform is timed"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"dims", Wasp::CvtToSize_tVec, &opt.dims, sizeof(opt.dims)},
+                                        {"wnames", Wasp::CvtToStrVec, &opt.wnames, sizeof(opt.wnames)},
+                                        {"nloops", Wasp::CvtToInt, &opt.nloops, sizeof(opt.nloops)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// Largest difference relative to the largest magnitude of a
+//
+template<class T> double rel_error(const vector<T> &a, const vector<T> &b)
+{
+    double maxa = 0.0, maxd = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        maxa = std::max(maxa, fabs((double)a[i]));
+        maxd = std::max(maxd, fabs((double)a[i] - (double)b[i]));
+    }
+    return (maxa > 0.0 ? maxd / maxa : maxd);
+}
+
+bool check(const string &what, double err, double tol)
+{
+    bool ok = err <= tol;
+    cout << (ok ? "" : "FAIL : ") << what << " error " << err << endl;
+    return (ok);
+}
+
+// Forward transform with the convolution (reference) and the lifting
+// scheme, then the inverse of the lifting coefficients with both
+//
+template<class T> bool test(MatWaveDwt &dwt, int ndim, double tol)
+{
+    const vector<size_t> &d = opt.dims;
+    size_t                nx = d[0], ny = ndim > 1 ? d[1] : 1, nz = ndim > 2 ? d[2] : 1;
+
+    vector<T> sig(nx * ny * nz);
+    for (size_t k = 0; k < nz; k++) {
+        for (size_t j = 0; j < ny; j++) {
+            for (size_t i = 0; i < nx; i++) {
+                double x = (double)i / nx, y = (double)j / ny, z = (double)k / nz;
+                sig[(k * ny + j) * nx + i] = sin(13.0 * x) * cos(7.0 * y + 3.0 * z) + 0.1 * ((i * 7919 + j * 104729 + k * 1299709) % 97) / 97.0;
+            }
+        }
+    }
+
+    size_t    clen = ndim == 1 ? dwt.coefflength(nx) : ndim == 2 ? dwt.coefflength2(nx, ny) : dwt.coefflength3(nx, ny, nz);
+    vector<T> cref(clen), clift(clen);
+    vector<T> rref(sig.size()), rlift(sig.size());
+    size_t    L[27];
+    int       rc = 0;
+
+    for (int lift = 0; lift < 2; lift++) {
+        dwt.LiftingOnOff() = lift;
+        T *c = lift ? clift.data() : cref.data();
+
+        if (ndim == 1)
+            rc |= dwt.dwt(sig.data(), nx, c, L);
+        else if (ndim == 2)
+            rc |= dwt.dwt2d(sig.data(), nx, ny, c, L);
+        else
+            rc |= dwt.dwt3d(sig.data(), nx, ny, nz, c, L);
+    }
+    for (int lift = 0; lift < 2; lift++) {
+        dwt.LiftingOnOff() = lift;
+        T *r = lift ? rlift.data() : rref.data();
+
+        if (ndim == 1)
+            rc |= dwt.idwt(clift.data(), L, r);
+        else if (ndim == 2)
+            rc |= dwt.idwt2d(clift.data(), L, r);
+        else
+            rc |= dwt.idwt3d(clift.data(), L, r);
+    }
+    dwt.LiftingOnOff() = true;
+    if (rc < 0) {
+        cout << "FAIL : transform failed" << endl;
+        return (false);
+    }
+
+    string what = dwt.wavelet_name() + " " + std::to_string(ndim) + "D " + (sizeof(T) == 4 ? "float" : "double");
+    bool   ok = check(what + " forward", rel_error(cref, clift), tol);
+    ok = check(what + " inverse", rel_error(rref, rlift), tol) && ok;
+    ok = check(what + " reconstruction", rel_error(sig, rlift), tol) && ok;
+    return (ok);
+}
+
+template<class T> void timing(MatWaveDwt &dwt)
+{
+    const vector<size_t> &d = opt.dims;
+    vector<T>             sig(d[0] * d[1] * d[2], (T)1.0);
+    vector<T>             c(dwt.coefflength3(d[0], d[1], d[2]));
+    size_t                L[27];
+
+    for (int lift = 0; lift < 2; lift++) {
+        dwt.LiftingOnOff() = lift;
+        double t0 = Wasp::GetTime();
+        for (int i = 0; i < opt.nloops; i++) dwt.dwt3d(sig.data(), d[0], d[1], d[2], c.data(), L);
+        double t1 = Wasp::GetTime();
+        for (int i = 0; i < opt.nloops; i++) dwt.idwt3d(c.data(), L, sig.data());
+        double t2 = Wasp::GetTime();
+
+        cout << dwt.wavelet_name() << " 3D " << (sizeof(T) == 4 ? "float" : "double") << (lift ? " lifting" : " convolution") << " : forward " << (t1 - t0) / opt.nloops << ", inverse "
+             << (t2 - t1) / opt.nloops << endl;
+    }
+    dwt.LiftingOnOff() = true;
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    VAssert(opt.dims.size() == 3);
+
+    cout << "Lifting kernels : " << MatWaveDwt::LiftingKernels() << endl;
+
+    bool ok = true;
+    for (size_t i = 0; i < opt.wnames.size(); i++) {
+        MatWaveDwt dwt(opt.wnames[i], "symw");
+        if (MatWaveDwt::GetErrCode()) return (1);
+
+        // The filter coefficients of some wavelets are only tabulated to
+        // 15 digits, so the convolution itself is only that accurate
+        //
+        for (int ndim = 1; ndim <= 3; ndim++) {
+            ok = test<double>(dwt, ndim, 1e-10) && ok;
+            ok = test<float>(dwt, ndim, 1e-5) && ok;
+        }
+        timing<float>(dwt);
+        timing<double>(dwt);
+    }
+
+    if (ok) cout << "Lifting matches convolution" << endl;
+
+    return (ok ? 0 : 1);
+}
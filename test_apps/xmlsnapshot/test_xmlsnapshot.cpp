@@ -0,0 +1,204 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "vapor/VAssert.h"
+
+#include <vapor/CFuncs.h>
+#include <vapor/OptionParser.h>
+#include <vapor/XmlNode.h>
+#include <vapor/FileUtils.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+// Count the bytes allocated with operator new, to measure the memory
+// held by each history entry
+//
+namespace {
+size_t liveBytes = 0;
+const size_t header = 16;
+}    // namespace
+
+void *operator new(size_t n)
+{
+    char *p = (char *)malloc(n + header);
+    if (!p) throw std::bad_alloc();
+    *(size_t *)p = n;
+    liveBytes += n;
+    return (p + header);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p) return;
+    char *h = (char *)p - header;
+    liveBytes -= *(size_t *)h;
+    free(h);
+}
+
+struct {
+    int                     nrenderers;
+    int                     tfsize;
+    int                     nsaves;
+    int                     stacksize;
+    OptionParser::Boolean_T help;
+} opt;
+
+OptionParser::OptDescRec_T set_opts[] = {{"nrenderers", 1, "50", "Number of renderers in the session"},
+                                         {"tfsize", 1, "1024", "Number of values in each transfer function"},
+                                         {"nsaves", 1, "500", "Number of changes saved"},
+                                         {"stacksize", 1, "100", "Maximum number of history entries"},
+                                         {"help", 0, "", "Print this message and exit"},
+                                         {NULL}};
+
+OptionParser::Option_T get_options[] = {{"nrenderers", Wasp::CvtToInt, &opt.nrenderers, sizeof(opt.nrenderers)},
+                                        {"tfsize", Wasp::CvtToInt, &opt.tfsize, sizeof(opt.tfsize)},
+                                        {"nsaves", Wasp::CvtToInt, &opt.nsaves, sizeof(opt.nsaves)},
+                                        {"stacksize", Wasp::CvtToInt, &opt.stacksize, sizeof(opt.stacksize)},
+                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
+
+const char *ProgName;
+
+// A tree shaped like a session: renderers, each with a few settings and a
+// transfer function
+//
+XmlNode *make_session()
+{
+    XmlNode *root = new XmlNode("ParamsMgr");
+    XmlNode *renderers = root->NewChild("Renderers");
+    for (int r = 0; r < opt.nrenderers; r++) {
+        XmlNode *ren = renderers->NewChild("Renderer" + std::to_string(r));
+        ren->SetElementString("VariableName", "U");
+        ren->SetElementDouble("Opacity", vector<double>(1, 1.0));
+        ren->SetElementLong("RefinementLevel", vector<long>(1, 0));
+
+        XmlNode *tf = ren->NewChild("TransferFunction");
+        vector<double> values(opt.tfsize);
+        for (int i = 0; i < opt.tfsize; i++) values[i] = (double)i / opt.tfsize;
+        tf->SetElementDouble("ControlPoints", values);
+    }
+    return (root);
+}
+
+// Drag a slider: change the opacity of one renderer
+//
+void change(XmlNode *root, int step)
+{
+    XmlNode *ren = root->GetChild("Renderers")->GetChild(step % opt.nrenderers);
+    ren->SetElementDouble("Opacity", vector<double>(1, 1.0 / (step + 2)));
+}
+
+int main(int argc, char **argv)
+{
+    OptionParser op;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ProgName = FileUtils::LegacyBasename(argv[0]);
+
+    if (op.AppendOptions(set_opts) < 0) { return (1); }
+
+    if (op.ParseOptions(&argc, argv, get_options) < 0) { return (1); }
+
+    if (opt.help) {
+        cerr << "Usage: " << ProgName << " [options] " << endl;
+        op.PrintOptionHelp(stderr);
+        return (0);
+    }
+
+    bool ok = true;
+
+    // History of deep copies, as kept before snapshots
+    //
+    XmlNode *root = make_session();
+    size_t   bytes0 = liveBytes;
+    double   t0 = Wasp::GetTime();
+
+    std::deque<XmlNode *> copies;
+    for (int s = 0; s < opt.nsaves; s++) {
+        change(root, s);
+        if (copies.size() && *copies.back() == *root) continue;
+        if (copies.size() == opt.stacksize) {
+            delete copies.front();
+            copies.pop_front();
+        }
+        copies.push_back(new XmlNode(*root));
+    }
+    double copyTime = Wasp::GetTime() - t0;
+    size_t copyBytes = liveBytes - bytes0;
+    delete root;
+
+    // History of snapshots
+    //
+    root = make_session();
+    bytes0 = liveBytes;
+    t0 = Wasp::GetTime();
+
+    XmlSnapshotter                       snapshotter;
+    std::deque<XmlSnapshotter::Snapshot> snapshots;
+    for (int s = 0; s < opt.nsaves; s++) {
+        change(root, s);
+        XmlSnapshotter::Snapshot snapshot = snapshotter.Take(root, snapshots.size() ? snapshots.back() : XmlSnapshotter::Snapshot());
+        if (snapshots.size() && snapshot == snapshots.back()) continue;
+        if (snapshots.size() == opt.stacksize) snapshots.pop_front();
+        snapshots.push_back(snapshot);
+    }
+    double snapTime = Wasp::GetTime() - t0;
+    size_t snapBytes = liveBytes - bytes0;
+
+    // The same number of changes must have been saved, and every snapshot
+    // must rebuild its deep copy
+    //
+    if (snapshots.size() != copies.size()) {
+        cout << "History sizes differ " << snapshots.size() << " " << copies.size() << endl;
+        ok = false;
+    }
+    for (size_t i = 0; i < snapshots.size() && i < copies.size(); i++) {
+        XmlNode *tree = XmlSnapshotter::Materialize(snapshots[i]);
+        if (!(*tree == *copies[i])) {
+            cout << "Snapshot " << i << " differs from its copy" << endl;
+            ok = false;
+        }
+        delete tree;
+    }
+
+    // An unchanged tree is not a new state, even when it was reloaded
+    // from a snapshot, as after an undo
+    //
+    if (snapshots.size() > 1) {
+        if (snapshotter.Take(root, snapshots.back()) != snapshots.back()) {
+            cout << "Unchanged tree gave a new snapshot" << endl;
+            ok = false;
+        }
+
+        XmlSnapshotter::Snapshot undone = snapshots[snapshots.size() - 2];
+        XmlNode *                reloaded = XmlSnapshotter::Materialize(undone);
+        if (snapshotter.Take(reloaded, undone) != undone) {
+            cout << "Reloaded tree gave a new snapshot" << endl;
+            ok = false;
+        }
+        delete reloaded;
+    }
+
+    size_t n = copies.size();
+    printf("Tree of %lu nodes, %lu history entries\n", XmlSnapshotter::GetNumNodes(snapshots.back()), n);
+    printf("%-10s %12s %12s\n", "History", "bytes/entry", "usec/save");
+    printf("%-10s %12.0f %12.2f\n", "copies", (double)copyBytes / n, copyTime / opt.nsaves * 1e6);
+    printf("%-10s %12.0f %12.2f\n", "snapshots", (double)snapBytes / n, snapTime / opt.nsaves * 1e6);
+
+    for (XmlNode *copy : copies) delete copy;
+    delete root;
+
+    if (!ok) {
+        cout << "FAILED" << endl;
+        return (1);
+    }
+
+    cout << "PASSED" << endl;
+    return (0);
+}